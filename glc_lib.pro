@@ -13,4 +13,6 @@ contains(QT_CONFIG, opengles2) {
 }
 
 SUBDIRS += src/lib \
-        src/examples
+        src/examples \
+        src/benchmarks \
+        src/tests
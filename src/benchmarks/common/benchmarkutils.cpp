@@ -0,0 +1,91 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+#include <algorithm>
+
+#include <QJsonDocument>
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+
+#include "benchmarkutils.h"
+
+double benchmarkutils::elapsedMilliseconds(const QElapsedTimer& timer)
+{
+    return static_cast<double>(timer.nsecsElapsed()) / 1000000.0;
+}
+
+QJsonObject benchmarkutils::timeStatistics(QList<double> durations)
+{
+    QJsonObject subject;
+    const int count= durations.size();
+    if (count > 0)
+    {
+        std::sort(durations.begin(), durations.end());
+        double total= 0.0;
+        for (double duration : durations)
+        {
+            total+= duration;
+        }
+        subject.insert("count", count);
+        subject.insert("total", total);
+        subject.insert("mean", total / count);
+        subject.insert("min", durations.first());
+        subject.insert("median", durations.at(count / 2));
+        subject.insert("p95", durations.at(qMin(count - 1, (count * 95) / 100)));
+        subject.insert("max", durations.last());
+    }
+
+    return subject;
+}
+
+QCommandLineOption benchmarkutils::outputOption()
+{
+    return QCommandLineOption(QStringList() << "o" << "output", "Write the JSON report to the given file instead of the standard output.", "file");
+}
+
+bool benchmarkutils::writeFile(const QString& fileName, const QByteArray& data)
+{
+    QFile file(fileName);
+    const bool subject= file.open(QIODevice::WriteOnly) && (file.write(data) == data.size());
+    if (!subject)
+    {
+        QTextStream(stderr) << "Unable to write " << fileName << Qt::endl;
+    }
+    return subject;
+}
+
+bool benchmarkutils::writeReport(const QJsonObject& report, const QString& fileName)
+{
+    const QByteArray data(QJsonDocument(report).toJson());
+    bool subject= true;
+    if (fileName.isEmpty())
+    {
+        QTextStream(stdout) << data;
+    }
+    else
+    {
+        subject= writeFile(fileName, data);
+    }
+
+    return subject;
+}
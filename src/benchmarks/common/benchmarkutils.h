@@ -0,0 +1,50 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+#ifndef BENCHMARKUTILS_H_
+#define BENCHMARKUTILS_H_
+
+#include <QElapsedTimer>
+#include <QCommandLineOption>
+#include <QJsonObject>
+#include <QList>
+
+//! Timing and reporting shared by the benchmarks
+namespace benchmarkutils
+{
+    //! Return the time elapsed since the start of the given timer in milliseconds
+    double elapsedMilliseconds(const QElapsedTimer& timer);
+
+    //! Return the count, total, mean, min, median, 95th percentile and max of the given durations in milliseconds
+    QJsonObject timeStatistics(QList<double> durations);
+
+    //! Return the option of the file of the JSON report
+    QCommandLineOption outputOption();
+
+    //! Write the given data to the given file, print an error and return false on failure
+    bool writeFile(const QString& fileName, const QByteArray& data);
+
+    //! Write the given report to the given file, or to the standard output if the file name is empty
+    bool writeReport(const QJsonObject& report, const QString& fileName);
+}
+
+#endif /* BENCHMARKUTILS_H_ */
@@ -0,0 +1,6 @@
+# Timing and reporting shared by the benchmarks
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+HEADERS += $$PWD/benchmarkutils.h
+SOURCES += $$PWD/benchmarkutils.cpp
@@ -0,0 +1,291 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+#include <cmath>
+
+#include <QElapsedTimer>
+
+#include <GLC_CsgHelper>
+#include <GLC_State>
+
+#include "benchmarkutils.h"
+#include "csgbenchmark.h"
+
+namespace
+{
+    enum Operation
+    {
+        Union,
+        Difference,
+        Intersection
+    };
+}
+
+using benchmarkutils::elapsedMilliseconds;
+using benchmarkutils::timeStatistics;
+
+CsgBenchmarkParameters::CsgBenchmarkParameters()
+    : m_PlateTriangles(100000)
+    , m_CutterSubdivisions(4)
+    , m_RunCount(3)
+    , m_Compare(false)
+{
+
+}
+
+QJsonObject CsgBenchmarkParameters::toJson() const
+{
+    QJsonObject subject;
+    subject.insert("plateTriangles", m_PlateTriangles);
+    subject.insert("cutterSubdivisions", m_CutterSubdivisions);
+    subject.insert("runs", m_RunCount);
+    subject.insert("compare", m_Compare);
+
+    return subject;
+}
+
+CsgBenchmark::CsgBenchmark(const CsgBenchmarkParameters& parameters)
+    : m_Parameters(parameters)
+    , m_pMaterial(new GLC_Material(Qt::lightGray))
+    , m_pPlate(nullptr)
+    , m_pCutter(nullptr)
+    , m_Result()
+    , m_ConcaveCheckPassed(true)
+{
+    // The plate has about 4 * side * side triangles on its large faces
+    const int side= qMax(1, static_cast<int>(std::sqrt(m_Parameters.m_PlateTriangles / 4.0)));
+    const int plateSubdivisions[3]= {side, side, 1};
+    m_pPlate= createBoxMesh(GLC_Point3d(-1.0, -1.0, -0.05), GLC_Point3d(1.0, 1.0, 0.05), plateSubdivisions);
+
+    const int cutterSide= qMax(1, m_Parameters.m_CutterSubdivisions);
+    const int cutterSubdivisions[3]= {cutterSide, cutterSide, cutterSide};
+    m_pCutter= createBoxMesh(GLC_Point3d(0.1, 0.13, -0.2), GLC_Point3d(0.16, 0.19, 0.2), cutterSubdivisions);
+}
+
+CsgBenchmark::~CsgBenchmark()
+{
+    delete m_pPlate;
+    delete m_pCutter;
+}
+
+void CsgBenchmark::run()
+{
+    QJsonObject operations;
+    operations.insert("union", measure(Union));
+    operations.insert("difference", measure(Difference));
+    operations.insert("intersection", measure(Intersection));
+
+    QJsonObject meshes;
+    meshes.insert("plateTriangles", static_cast<double>(m_pPlate->faceCount(0)));
+    meshes.insert("cutterTriangles", static_cast<double>(m_pCutter->faceCount(0)));
+
+    m_Result= QJsonObject();
+    m_Result.insert("parameters", m_Parameters.toJson());
+    m_Result.insert("meshes", meshes);
+    m_Result.insert("operations", operations);
+    m_Result.insert("concaveCheck", checkConcaveOperands());
+}
+
+QJsonObject CsgBenchmark::measure(int operation)
+{
+    QJsonObject subject;
+    const bool previousCulling= GLC_State::isCsgOverlapCullingActivated();
+    const int modeCount= m_Parameters.m_Compare ? 2 : 1;
+    for (int mode= 0; mode < modeCount; ++mode)
+    {
+        GLC_State::setCsgOverlapCullingUsage(0 == mode);
+        QList<double> durations;
+        unsigned int resultTriangles= 0;
+        for (int i= 0; i < m_Parameters.m_RunCount; ++i)
+        {
+            QElapsedTimer timer;
+            timer.start();
+            GLC_Mesh* pResult= evaluate(operation, m_pPlate, m_pCutter);
+            durations.append(elapsedMilliseconds(timer));
+            resultTriangles= pResult->faceCount(0);
+            delete pResult;
+        }
+
+        QJsonObject measures(timeStatistics(durations));
+        measures.insert("resultTriangles", static_cast<double>(resultTriangles));
+        subject.insert((0 == mode) ? "overlapCulling" : "csgjs", measures);
+    }
+    GLC_State::setCsgOverlapCullingUsage(previousCulling);
+
+    return subject;
+}
+
+QJsonObject CsgBenchmark::checkConcaveOperands()
+{
+    const bool previousCulling= GLC_State::isCsgOverlapCullingActivated();
+    GLC_State::setCsgOverlapCullingUsage(false);
+
+    // A box with a pocket open on its upper face and a cutter crossing the floor and a wall of the pocket
+    const int subdivisions[3]= {2, 2, 2};
+    GLC_Mesh* pBlock= createBoxMesh(GLC_Point3d(-1.0, -1.0, -0.5), GLC_Point3d(1.0, 1.0, 0.5), subdivisions);
+    GLC_Mesh* pPocket= createBoxMesh(GLC_Point3d(-0.4, -0.4, 0.0), GLC_Point3d(0.4, 0.4, 1.0), subdivisions);
+    GLC_Mesh* pConcave= evaluate(Difference, pBlock, pPocket);
+    GLC_Mesh* pCutter= createBoxMesh(GLC_Point3d(-0.2, -0.2, -0.2), GLC_Point3d(0.9, 0.2, 0.8), subdivisions);
+    delete pBlock;
+    delete pPocket;
+
+    QJsonObject subject;
+    const char* names[3]= {"union", "difference", "intersection"};
+    for (int operation= Union; operation <= Intersection; ++operation)
+    {
+        double volumes[2];
+        for (int mode= 0; mode < 2; ++mode)
+        {
+            GLC_State::setCsgOverlapCullingUsage(0 == mode);
+            GLC_Mesh* pResult= evaluate(operation, pConcave, pCutter);
+            volumes[mode]= meshVolume(pResult);
+            delete pResult;
+        }
+        const bool match= qAbs(volumes[0] - volumes[1]) <= (qMax(qAbs(volumes[1]), 1.0) * 1.0e-4);
+        m_ConcaveCheckPassed= m_ConcaveCheckPassed && match;
+
+        QJsonObject volumeObject;
+        volumeObject.insert("overlapCulling", volumes[0]);
+        volumeObject.insert("csgjs", volumes[1]);
+        volumeObject.insert("match", match);
+        subject.insert(names[operation], volumeObject);
+    }
+    GLC_State::setCsgOverlapCullingUsage(previousCulling);
+
+    delete pConcave;
+    delete pCutter;
+
+    return subject;
+}
+
+GLC_Mesh* CsgBenchmark::createBoxMesh(const GLC_Point3d& lower, const GLC_Point3d& upper, const int* pSubdivisions) const
+{
+    GLfloatVector positions;
+    GLfloatVector normals;
+    IndexList indexes;
+    const double lowerValues[3]= {lower.x(), lower.y(), lower.z()};
+    const double upperValues[3]= {upper.x(), upper.y(), upper.z()};
+
+    // Each face is a grid on the two other axes, (axis1 ^ axis2) is the face normal axis
+    for (int normalAxis= 0; normalAxis < 3; ++normalAxis)
+    {
+        const int axis1= (normalAxis + 1) % 3;
+        const int axis2= (normalAxis + 2) % 3;
+        const int count1= pSubdivisions[axis1];
+        const int count2= pSubdivisions[axis2];
+        for (int side= 0; side < 2; ++side)
+        {
+            const double sign= (0 == side) ? -1.0 : 1.0;
+            const GLuint first= static_cast<GLuint>(positions.size() / 3);
+            for (int i= 0; i <= count1; ++i)
+            {
+                for (int j= 0; j <= count2; ++j)
+                {
+                    double position[3];
+                    position[normalAxis]= (0 == side) ? lowerValues[normalAxis] : upperValues[normalAxis];
+                    position[axis1]= lowerValues[axis1] + (upperValues[axis1] - lowerValues[axis1]) * i / count1;
+                    position[axis2]= lowerValues[axis2] + (upperValues[axis2] - lowerValues[axis2]) * j / count2;
+                    double normal[3]= {0.0, 0.0, 0.0};
+                    normal[normalAxis]= sign;
+                    for (int axis= 0; axis < 3; ++axis)
+                    {
+                        positions << static_cast<GLfloat>(position[axis]);
+                        normals << static_cast<GLfloat>(normal[axis]);
+                    }
+                }
+            }
+            for (int i= 0; i < count1; ++i)
+            {
+                for (int j= 0; j < count2; ++j)
+                {
+                    const GLuint a= first + i * (count2 + 1) + j;
+                    const GLuint b= first + (i + 1) * (count2 + 1) + j;
+                    const GLuint c= first + (i + 1) * (count2 + 1) + j + 1;
+                    const GLuint d= first + i * (count2 + 1) + j + 1;
+                    if (0 == side)
+                    {
+                        indexes << a << c << b << a << d << c;
+                    }
+                    else
+                    {
+                        indexes << a << b << c << a << c << d;
+                    }
+                }
+            }
+        }
+    }
+
+    GLC_Mesh* pSubject= new GLC_Mesh();
+    pSubject->addVertice(positions);
+    pSubject->addNormals(normals);
+    pSubject->addTriangles(m_pMaterial, indexes);
+    pSubject->finish();
+
+    return pSubject;
+}
+
+GLC_Mesh* CsgBenchmark::evaluate(int operation, const GLC_Mesh* pMesh1, const GLC_Mesh* pMesh2)
+{
+    const GLC_Matrix4x4 matrix;
+    GLC_Mesh* pSubject= nullptr;
+    if (Union == operation)
+    {
+        pSubject= GLC_CsgHelper::add(pMesh1, matrix, pMesh2, matrix);
+    }
+    else if (Difference == operation)
+    {
+        pSubject= GLC_CsgHelper::soustract(pMesh1, matrix, pMesh2, matrix);
+    }
+    else
+    {
+        pSubject= GLC_CsgHelper::intersection(pMesh1, matrix, pMesh2, matrix);
+    }
+
+    return pSubject;
+}
+
+double CsgBenchmark::meshVolume(const GLC_Mesh* pMesh)
+{
+    // Sum of the signed volumes of the tetrahedrons of the origin and the triangles
+    const GLfloatVector positions(pMesh->positionVector());
+    double subject= 0.0;
+    const QList<GLC_Material*> materials(pMesh->materialSet().values());
+    for (GLC_Material* pMaterial : materials)
+    {
+        if (!pMesh->lodContainsMaterial(0, pMaterial->id())) continue;
+
+        const IndexList index(pMesh->getEquivalentTrianglesStripsFansIndex(0, pMaterial->id()));
+        const int indexCount= index.size() - (index.size() % 3);
+        for (int i= 0; i < indexCount; i+= 3)
+        {
+            GLC_Vector3d points[3];
+            for (int k= 0; k < 3; ++k)
+            {
+                const int offset= index.at(i + k) * 3;
+                points[k].setVect(positions.at(offset), positions.at(offset + 1), positions.at(offset + 2));
+            }
+            subject+= (points[0] * (points[1] ^ points[2])) / 6.0;
+        }
+    }
+
+    return subject;
+}
@@ -0,0 +1,104 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+#ifndef CSGBENCHMARK_H_
+#define CSGBENCHMARK_H_
+
+#include <QJsonObject>
+#include <QList>
+
+#include <GLC_Mesh>
+#include <GLC_Material>
+
+//! Parameters of a CSG benchmark run
+struct CsgBenchmarkParameters
+{
+    CsgBenchmarkParameters();
+
+    //! Return the parameters in JSON
+    QJsonObject toJson() const;
+
+    //! Approximate number of triangles of the plate
+    int m_PlateTriangles;
+
+    //! Number of subdivisions of each side of the cutter
+    int m_CutterSubdivisions;
+
+    //! Number of measured runs of each operation
+    int m_RunCount;
+
+    //! True to also measure the operations without overlap culling
+    bool m_Compare;
+};
+
+//! Benchmark of GLC_CsgHelper operations on a large plate and a small cutter
+/*! The plate is a box with finely subdivided faces and the cutter a small box
+ *  which goes through the plate, like a drilling. Union, difference and intersection
+ *  are measured in milliseconds with the overlap culling of GLC_State and, if
+ *  compared, without it.
+ *
+ *  The volumes of the operations on a concave operand, a box with a pocket, and a cutter
+ *  crossing the pocket are also compared with and without overlap culling.*/
+class CsgBenchmark
+{
+public:
+    explicit CsgBenchmark(const CsgBenchmarkParameters& parameters);
+    ~CsgBenchmark();
+
+public:
+    //! Run the benchmark
+    void run();
+
+    //! Return the result of the last run
+    QJsonObject result() const
+    {return m_Result;}
+
+    //! Return true if the overlap culling gave the volumes of csgjs on concave operands in the last run
+    bool concaveCheckPassed() const
+    {return m_ConcaveCheckPassed;}
+
+private:
+    //! Return the measures of the given operation
+    QJsonObject measure(int operation);
+
+    //! Return the volumes of the operations on concave operands with and without overlap culling
+    QJsonObject checkConcaveOperands();
+
+    //! Return a new box mesh with the given number of subdivisions on each axis
+    GLC_Mesh* createBoxMesh(const GLC_Point3d& lower, const GLC_Point3d& upper, const int* pSubdivisions) const;
+
+    //! Return the result of the given operation on the given meshes
+    static GLC_Mesh* evaluate(int operation, const GLC_Mesh* pMesh1, const GLC_Mesh* pMesh2);
+
+    //! Return the volume enclosed by the triangles of the given mesh
+    static double meshVolume(const GLC_Mesh* pMesh);
+
+private:
+    CsgBenchmarkParameters m_Parameters;
+    GLC_Material* m_pMaterial;
+    GLC_Mesh* m_pPlate;
+    GLC_Mesh* m_pCutter;
+    QJsonObject m_Result;
+    bool m_ConcaveCheckPassed;
+};
+
+#endif /* CSGBENCHMARK_H_ */
@@ -0,0 +1,24 @@
+TARGET = csgbenchmark
+TEMPLATE = app
+QT += core gui opengl
+
+CONFIG += warn_on console
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./Build
+MOC_DIR = ./Build
+UI_DIR = ./Build
+RCC_DIR = ./Build
+
+include(../../../glc_lib.pri)
+include(../common/common.pri)
+
+
+# Input
+HEADERS += csgbenchmark.h
+SOURCES += csgbenchmark.cpp main.cpp
+
+include(../../../install.pri)
+
+target.path = $${GLC_LIB_DIR}/benchmarks
+INSTALLS += target
@@ -0,0 +1,70 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+// Benchmark of the CSG operations on a large plate and a small cutter :
+//   ./csgbenchmark --triangles 1000000
+// --compare also measures the operations with csgjs only, it is slow on large plates.
+// The exit code is 2 if the overlap culling and csgjs give different volumes on concave operands.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+
+#include "benchmarkutils.h"
+#include "csgbenchmark.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("csgbenchmark");
+
+    CsgBenchmarkParameters parameters;
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark of the GLC_lib CSG operations");
+    parser.addHelpOption();
+    const QCommandLineOption trianglesOption("triangles", "Approximate number of triangles of the plate.", "count", QString::number(parameters.m_PlateTriangles));
+    const QCommandLineOption cutterOption("cutter", "Number of subdivisions of each side of the cutter.", "count", QString::number(parameters.m_CutterSubdivisions));
+    const QCommandLineOption runsOption("runs", "Number of measured runs of each operation.", "count", QString::number(parameters.m_RunCount));
+    const QCommandLineOption compareOption("compare", "Also measure the operations without overlap culling.");
+    const QCommandLineOption outputOption(benchmarkutils::outputOption());
+    parser.addOptions(QList<QCommandLineOption>() << trianglesOption << cutterOption << runsOption << compareOption << outputOption);
+    parser.process(app);
+
+    parameters.m_PlateTriangles= qMax(1, parser.value(trianglesOption).toInt());
+    parameters.m_CutterSubdivisions= qMax(1, parser.value(cutterOption).toInt());
+    parameters.m_RunCount= qMax(1, parser.value(runsOption).toInt());
+    parameters.m_Compare= parser.isSet(compareOption);
+
+    CsgBenchmark benchmark(parameters);
+    benchmark.run();
+
+    if (!benchmarkutils::writeReport(benchmark.result(), parser.value(outputOption))) return 1;
+
+    if (!benchmark.concaveCheckPassed())
+    {
+        QTextStream(stderr) << "Overlap culling and csgjs differ on concave operands" << Qt::endl;
+        return 2;
+    }
+
+    return 0;
+}
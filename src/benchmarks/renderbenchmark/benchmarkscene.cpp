@@ -0,0 +1,215 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+#include <QtMath>
+#include <cmath>
+#include <QColor>
+
+#include <GLC_StructOccurrence>
+#include <GLC_StructInstance>
+#include <GLC_StructReference>
+#include <GLC_3DRep>
+#include <GLC_Matrix4x4>
+#include <GLC_ResidencyManager>
+
+#include "benchmarkscene.h"
+
+BenchmarkParameters::BenchmarkParameters()
+    : m_InstanceCount(1000)
+    , m_TrianglesPerMesh(1000)
+    , m_MeshCount(32)
+    , m_MaterialCount(8)
+    , m_HierarchyDepth(3)
+    , m_TransparentRatio(0.0)
+    , m_FrameCount(100)
+    , m_Width(1280)
+    , m_Height(720)
+    , m_UseOctree(true)
+    , m_UseLod(false)
+    , m_UseOrderedRendering(false)
+{
+
+}
+
+QJsonObject BenchmarkParameters::toJson() const
+{
+    QJsonObject subject;
+    subject.insert("instances", m_InstanceCount);
+    subject.insert("trianglesPerMesh", m_TrianglesPerMesh);
+    subject.insert("meshes", m_MeshCount);
+    subject.insert("materials", m_MaterialCount);
+    subject.insert("hierarchyDepth", m_HierarchyDepth);
+    subject.insert("transparentRatio", m_TransparentRatio);
+    subject.insert("frames", m_FrameCount);
+    subject.insert("width", m_Width);
+    subject.insert("height", m_Height);
+    subject.insert("octree", m_UseOctree);
+    subject.insert("lod", m_UseLod);
+    subject.insert("orderedRendering", m_UseOrderedRendering);
+
+    return subject;
+}
+
+BenchmarkScene::BenchmarkScene(const BenchmarkParameters& parameters)
+    : m_Parameters(parameters)
+    , m_World()
+    , m_References()
+    , m_Materials()
+    , m_BranchCount(2)
+    , m_GridSize(1)
+    , m_GeometryMemorySize(0)
+    , m_InstancedTriangleCount(0)
+{
+    m_Parameters.m_InstanceCount= qMax(1, m_Parameters.m_InstanceCount);
+    m_Parameters.m_MeshCount= qBound(1, m_Parameters.m_MeshCount, m_Parameters.m_InstanceCount);
+    m_Parameters.m_MaterialCount= qMax(1, m_Parameters.m_MaterialCount);
+    m_Parameters.m_HierarchyDepth= qMax(1, m_Parameters.m_HierarchyDepth);
+
+    // Enough children per occurrence to reach the instance count at the given depth
+    const double branchCount= std::pow(static_cast<double>(m_Parameters.m_InstanceCount), 1.0 / m_Parameters.m_HierarchyDepth);
+    m_BranchCount= qMax(2, static_cast<int>(std::ceil(branchCount)));
+    m_GridSize= qMax(1, static_cast<int>(std::ceil(std::cbrt(static_cast<double>(m_Parameters.m_InstanceCount)))));
+
+    for (int i= 0; i < m_Parameters.m_MeshCount; ++i)
+    {
+        GLC_3DRep* pRep= new GLC_3DRep(createMesh(i));
+        pRep->setName(QString("Mesh%1").arg(i));
+        m_GeometryMemorySize+= GLC_ResidencyManager::memorySize(*pRep);
+        m_References.append(new GLC_StructReference(pRep));
+    }
+
+    int leafIndex= 0;
+    createChildren(m_World.rootOccurrence(), 1, &leafIndex);
+    m_World.rootOccurrence()->updateChildrenAbsoluteMatrix();
+}
+
+void BenchmarkScene::createChildren(GLC_StructOccurrence* pParent, int level, int* pLeafIndex)
+{
+    int i= 0;
+    while ((i < m_BranchCount) && (*pLeafIndex < m_Parameters.m_InstanceCount))
+    {
+        if (level >= m_Parameters.m_HierarchyDepth)
+        {
+            pParent->addChild(createLeafInstance(*pLeafIndex));
+            ++(*pLeafIndex);
+        }
+        else
+        {
+            GLC_StructReference* pAssembly= new GLC_StructReference(QString("Assembly%1_%2").arg(level).arg(*pLeafIndex));
+            GLC_StructOccurrence* pOcc= pParent->addChild(new GLC_StructInstance(pAssembly));
+            createChildren(pOcc, level + 1, pLeafIndex);
+        }
+        ++i;
+    }
+}
+
+GLC_StructInstance* BenchmarkScene::createLeafInstance(int leafIndex)
+{
+    GLC_StructReference* pRef= m_References.at(leafIndex % m_References.size());
+    GLC_StructInstance* pInstance= new GLC_StructInstance(pRef);
+    pInstance->setName(QString("Instance%1").arg(leafIndex));
+
+    // Regular grid with a spacing of 1.5 mesh diameter
+    const double spacing= 1.5;
+    const int x= leafIndex % m_GridSize;
+    const int y= (leafIndex / m_GridSize) % m_GridSize;
+    const int z= leafIndex / (m_GridSize * m_GridSize);
+    pInstance->move(GLC_Matrix4x4(x * spacing, y * spacing, z * spacing));
+
+    m_InstancedTriangleCount+= dynamic_cast<GLC_3DRep*>(pRef->representationHandle())->faceCount();
+
+    return pInstance;
+}
+
+GLC_Mesh* BenchmarkScene::createMesh(int meshIndex)
+{
+    // UV sphere of 2 * side * side triangles, side is even for the half resolution LOD
+    int side= qMax(4, static_cast<int>(std::ceil(std::sqrt(m_Parameters.m_TrianglesPerMesh / 2.0))));
+    side+= side % 2;
+    const double radius= 0.5;
+
+    GLfloatVector positions;
+    GLfloatVector normals;
+    positions.reserve((side + 1) * (side + 1) * 3);
+    normals.reserve((side + 1) * (side + 1) * 3);
+    for (int row= 0; row <= side; ++row)
+    {
+        const double theta= M_PI * static_cast<double>(row) / side;
+        for (int col= 0; col <= side; ++col)
+        {
+            const double phi= 2.0 * M_PI * static_cast<double>(col) / side;
+            const double nx= std::sin(theta) * std::cos(phi);
+            const double ny= std::sin(theta) * std::sin(phi);
+            const double nz= std::cos(theta);
+            positions << static_cast<GLfloat>(radius * nx) << static_cast<GLfloat>(radius * ny) << static_cast<GLfloat>(radius * nz);
+            normals << static_cast<GLfloat>(nx) << static_cast<GLfloat>(ny) << static_cast<GLfloat>(nz);
+        }
+    }
+
+    GLC_Mesh* pMesh= new GLC_Mesh();
+    pMesh->setName(QString("Mesh%1").arg(meshIndex));
+    pMesh->addVertice(positions);
+    pMesh->addNormals(normals);
+
+    GLC_Material* pMaterial= material(meshIndex % m_Parameters.m_MaterialCount);
+    const int lodCount= m_Parameters.m_UseLod ? 2 : 1;
+    for (int lod= 0; lod < lodCount; ++lod)
+    {
+        const int step= 1 << lod;
+        IndexList indexes;
+        for (int row= 0; row < side; row+= step)
+        {
+            for (int col= 0; col < side; col+= step)
+            {
+                const GLuint a= row * (side + 1) + col;
+                const GLuint b= (row + step) * (side + 1) + col;
+                const GLuint c= (row + step) * (side + 1) + col + step;
+                const GLuint d= row * (side + 1) + col + step;
+                indexes << a << b << c << a << c << d;
+            }
+        }
+        pMesh->addTriangles(pMaterial, indexes, lod, static_cast<double>(lod));
+    }
+    pMesh->finish();
+
+    return pMesh;
+}
+
+GLC_Material* BenchmarkScene::material(int materialIndex)
+{
+    GLC_Material* pSubject= m_Materials.value(materialIndex, nullptr);
+    if (nullptr == pSubject)
+    {
+        const int hue= (materialIndex * 360) / m_Parameters.m_MaterialCount;
+        pSubject= new GLC_Material(QColor::fromHsv(hue, 200, 220));
+        pSubject->setName(QString("Material%1").arg(materialIndex));
+
+        const int transparentCount= qRound(m_Parameters.m_TransparentRatio * m_Parameters.m_MaterialCount);
+        if (materialIndex < transparentCount)
+        {
+            pSubject->setOpacity(0.5);
+        }
+        m_Materials.insert(materialIndex, pSubject);
+    }
+
+    return pSubject;
+}
@@ -0,0 +1,115 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+#ifndef BENCHMARKSCENE_H_
+#define BENCHMARKSCENE_H_
+
+#include <QHash>
+#include <QJsonObject>
+
+#include <GLC_World>
+#include <GLC_Material>
+#include <GLC_Mesh>
+
+//! Parameters of a benchmark run
+struct BenchmarkParameters
+{
+    BenchmarkParameters();
+
+    //! Return the parameters in JSON
+    QJsonObject toJson() const;
+
+    //! Number of leaf instances
+    int m_InstanceCount;
+    //! Number of triangles of each mesh (Level of detail 0)
+    int m_TrianglesPerMesh;
+    //! Number of distinct meshes shared by instances
+    int m_MeshCount;
+    //! Number of distinct materials
+    int m_MaterialCount;
+    //! Depth of the product structure (1 : leaves are children of the root)
+    int m_HierarchyDepth;
+    //! Ratio of transparent materials
+    double m_TransparentRatio;
+    //! Number of measured frames
+    int m_FrameCount;
+    //! Frame buffer size
+    int m_Width;
+    int m_Height;
+    //! Use an octree to cull instances
+    bool m_UseOctree;
+    //! Use dynamic level of detail
+    bool m_UseLod;
+    //! Use ordered rendering
+    bool m_UseOrderedRendering;
+};
+
+//! Procedural scene of the benchmark
+/*! Meshes are UV spheres with a half resolution level of detail.
+ *  Leaf instances are laid on a regular grid, assemblies have an identity matrix.*/
+class BenchmarkScene
+{
+public:
+    explicit BenchmarkScene(const BenchmarkParameters& parameters);
+
+public:
+    //! Return the world of this scene
+    GLC_World world() const
+    {return m_World;}
+
+    //! Return the estimated memory size of the meshes in bytes
+    qint64 geometryMemorySize() const
+    {return m_GeometryMemorySize;}
+
+    //! Return the number of triangles of all instances at level of detail 0
+    qint64 instancedTriangleCount() const
+    {return m_InstancedTriangleCount;}
+
+    //! Return the number of occurrences of the product structure
+    int occurrenceCount() const
+    {return m_World.numberOfOccurrence();}
+
+private:
+    //! Create the product structure under the given occurrence
+    void createChildren(GLC_StructOccurrence* pParent, int level, int* pLeafIndex);
+
+    //! Return the leaf instance of the given index
+    GLC_StructInstance* createLeafInstance(int leafIndex);
+
+    //! Return the mesh of the given index
+    GLC_Mesh* createMesh(int meshIndex);
+
+    //! Return the material of the given index
+    GLC_Material* material(int materialIndex);
+
+private:
+    BenchmarkParameters m_Parameters;
+    GLC_World m_World;
+    QList<GLC_StructReference*> m_References;
+    QHash<int, GLC_Material*> m_Materials;
+    int m_BranchCount;
+    int m_GridSize;
+    qint64 m_GeometryMemorySize;
+    qint64 m_InstancedTriangleCount;
+};
+
+#endif /* BENCHMARKSCENE_H_ */
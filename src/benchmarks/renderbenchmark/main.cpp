@@ -0,0 +1,93 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+// Headless benchmark of the rendering pipeline.
+// Without display, run it with the offscreen platform and a software OpenGL :
+//   QT_QPA_PLATFORM=offscreen LIBGL_ALWAYS_SOFTWARE=1 ./renderbenchmark --instances 5000
+
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+
+#include <GLC_RenderProfiler>
+
+#include "benchmarkutils.h"
+#include "renderbenchmark.h"
+
+int main(int argc, char *argv[])
+{
+    QGuiApplication app(argc, argv);
+    QGuiApplication::setApplicationName("renderbenchmark");
+
+    BenchmarkParameters parameters;
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless benchmark of the GLC_lib rendering pipeline");
+    parser.addHelpOption();
+    const QCommandLineOption instancesOption("instances", "Number of leaf instances.", "count", QString::number(parameters.m_InstanceCount));
+    const QCommandLineOption trianglesOption("triangles", "Number of triangles per mesh.", "count", QString::number(parameters.m_TrianglesPerMesh));
+    const QCommandLineOption meshesOption("meshes", "Number of distinct meshes.", "count", QString::number(parameters.m_MeshCount));
+    const QCommandLineOption materialsOption("materials", "Number of distinct materials.", "count", QString::number(parameters.m_MaterialCount));
+    const QCommandLineOption depthOption("depth", "Depth of the product structure.", "depth", QString::number(parameters.m_HierarchyDepth));
+    const QCommandLineOption transparentOption("transparent", "Ratio of transparent materials.", "ratio", QString::number(parameters.m_TransparentRatio));
+    const QCommandLineOption framesOption("frames", "Number of measured frames.", "count", QString::number(parameters.m_FrameCount));
+    const QCommandLineOption widthOption("width", "Frame buffer width.", "pixels", QString::number(parameters.m_Width));
+    const QCommandLineOption heightOption("height", "Frame buffer height.", "pixels", QString::number(parameters.m_Height));
+    const QCommandLineOption noOctreeOption("no-octree", "Disable octree culling.");
+    const QCommandLineOption lodOption("lod", "Enable dynamic level of detail.");
+    const QCommandLineOption orderedOption("ordered", "Enable ordered rendering.");
+    const QCommandLineOption outputOption(benchmarkutils::outputOption());
+    const QCommandLineOption traceOption("trace", "Write the rendering frames in the Chrome trace format to the given file.", "file");
+    parser.addOptions(QList<QCommandLineOption>() << instancesOption << trianglesOption << meshesOption << materialsOption
+                      << depthOption << transparentOption << framesOption << widthOption << heightOption
+                      << noOctreeOption << lodOption << orderedOption << outputOption << traceOption);
+    parser.process(app);
+
+    parameters.m_InstanceCount= parser.value(instancesOption).toInt();
+    parameters.m_TrianglesPerMesh= parser.value(trianglesOption).toInt();
+    parameters.m_MeshCount= parser.value(meshesOption).toInt();
+    parameters.m_MaterialCount= parser.value(materialsOption).toInt();
+    parameters.m_HierarchyDepth= parser.value(depthOption).toInt();
+    parameters.m_TransparentRatio= qBound(0.0, parser.value(transparentOption).toDouble(), 1.0);
+    parameters.m_FrameCount= parser.value(framesOption).toInt();
+    parameters.m_Width= qMax(1, parser.value(widthOption).toInt());
+    parameters.m_Height= qMax(1, parser.value(heightOption).toInt());
+    parameters.m_UseOctree= !parser.isSet(noOctreeOption);
+    parameters.m_UseLod= parser.isSet(lodOption);
+    parameters.m_UseOrderedRendering= parser.isSet(orderedOption);
+
+    RenderBenchmark benchmark(parameters);
+    if (!benchmark.run())
+    {
+        QTextStream(stderr) << benchmark.errorString() << Qt::endl;
+        return 1;
+    }
+
+    bool success= benchmarkutils::writeReport(benchmark.result(), parser.value(outputOption));
+
+    if (parser.isSet(traceOption))
+    {
+        success= benchmarkutils::writeFile(parser.value(traceOption), GLC_RenderProfiler::toChromeTrace()) && success;
+    }
+
+    return success ? 0 : 1;
+}
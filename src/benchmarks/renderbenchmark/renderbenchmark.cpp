@@ -0,0 +1,320 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+#include <QElapsedTimer>
+#include <QOpenGLFunctions>
+#include <QJsonArray>
+#include <QFile>
+#include <QtMath>
+
+#include <algorithm>
+
+#include <GLC_State>
+#include <GLC_Viewport>
+#include <GLC_Camera>
+#include <GLC_3DViewCollection>
+#include <GLC_3DViewInstance>
+#include <GLC_RenderProfiler>
+
+#include "benchmarkutils.h"
+#include "renderbenchmark.h"
+
+using benchmarkutils::elapsedMilliseconds;
+using benchmarkutils::timeStatistics;
+
+RenderBenchmark::RenderBenchmark(const BenchmarkParameters& parameters)
+    : m_Parameters(parameters)
+    , m_Context()
+    , m_Surface()
+    , m_pFrameBuffer(nullptr)
+    , m_pViewHandler(nullptr)
+    , m_pScene(nullptr)
+    , m_Result()
+    , m_ErrorString()
+{
+    m_Parameters.m_FrameCount= qMax(1, m_Parameters.m_FrameCount);
+}
+
+RenderBenchmark::~RenderBenchmark()
+{
+    // OpenGL resources must be released with the context current
+    if (m_Context.isValid())
+    {
+        m_Context.makeCurrent(&m_Surface);
+    }
+    delete m_pViewHandler;
+    delete m_pScene;
+    delete m_pFrameBuffer;
+    if (m_Context.isValid())
+    {
+        m_Context.doneCurrent();
+    }
+}
+
+bool RenderBenchmark::run()
+{
+    if (!initializeOpenGL()) return false;
+
+    QJsonObject stages;
+    QElapsedTimer timer;
+
+    // Scene generation
+    delete m_pScene;
+    timer.start();
+    m_pScene= new BenchmarkScene(m_Parameters);
+    stages.insert("sceneGeneration", elapsedMilliseconds(timer));
+    const QJsonObject generationMemory(processMemory());
+
+    // World attachment and space partitioning
+    timer.restart();
+    m_pViewHandler->setWorld(m_pScene->world());
+    stages.insert("setWorld", elapsedMilliseconds(timer));
+
+    GLC_3DViewCollection* pCollection= m_pViewHandler->world().collection();
+    GLC_Viewport* pViewport= m_pViewHandler->viewportHandle();
+    if (m_Parameters.m_UseOctree)
+    {
+        timer.restart();
+        m_pViewHandler->setSpacePartitionningEnabled(true);
+        pCollection->updateSpacePartitionning();
+        stages.insert("spacePartitioning", elapsedMilliseconds(timer));
+    }
+    pCollection->setLodUsage(m_Parameters.m_UseLod, pViewport);
+    pCollection->setOrderRenderingUsage(m_Parameters.m_UseOrderedRendering);
+
+    // First frame creates VBOs
+    timer.restart();
+    renderFrame();
+    stages.insert("firstFrame", elapsedMilliseconds(timer));
+
+    const int frameCount= m_Parameters.m_FrameCount;
+
+    // Culling
+    QList<double> durations;
+    for (int i= 0; i < frameCount; ++i)
+    {
+        moveCamera(i);
+        timer.restart();
+        pCollection->updateInstanceViewableState();
+        durations.append(elapsedMilliseconds(timer));
+    }
+    stages.insert("culling", timeStatistics(durations));
+
+    // Back to front sort of viewable instances
+    durations.clear();
+    for (int i= 0; i < frameCount; ++i)
+    {
+        moveCamera(i);
+        pCollection->updateInstanceViewableState();
+        timer.restart();
+        const GLC_Point3d eye(pViewport->cameraHandle()->eye());
+        QList<QPair<double, GLC_3DViewInstance*> > instances;
+        const QList<GLC_3DViewInstance*> viewableInstances(pCollection->viewableInstancesHandle());
+        for (GLC_3DViewInstance* pInstance : viewableInstances)
+        {
+            instances.append(qMakePair((pInstance->boundingBox().center() - eye).squaredLength(), pInstance));
+        }
+        std::sort(instances.begin(), instances.end(), [](const QPair<double, GLC_3DViewInstance*>& a, const QPair<double, GLC_3DViewInstance*>& b)
+        {
+            return a.first > b.first;
+        });
+        durations.append(elapsedMilliseconds(timer));
+    }
+    stages.insert("sorting", timeStatistics(durations));
+
+    // Rendering
+    GLC_RenderProfiler::setFrameHistorySize(frameCount);
+    GLC_RenderProfiler::setActivationFlag(true);
+    durations.clear();
+    for (int i= 0; i < frameCount; ++i)
+    {
+        moveCamera(i);
+        timer.restart();
+        renderFrame();
+        durations.append(elapsedMilliseconds(timer));
+    }
+    GLC_RenderProfiler::setActivationFlag(false);
+    stages.insert("rendering", timeStatistics(durations));
+
+    QJsonObject scene;
+    scene.insert("occurrences", m_pScene->occurrenceCount());
+    scene.insert("bodies", m_pViewHandler->world().numberOfBody());
+    scene.insert("instancedTriangles", static_cast<double>(m_pScene->instancedTriangleCount()));
+    scene.insert("geometryMemory", static_cast<double>(m_pScene->geometryMemorySize()));
+
+    QJsonObject memory;
+    memory.insert("afterGeneration", generationMemory);
+    memory.insert("afterRendering", processMemory());
+
+    QOpenGLFunctions* pFunctions= m_Context.functions();
+    QJsonObject environment;
+    environment.insert("qtVersion", QString(qVersion()));
+    environment.insert("glVendor", QString(reinterpret_cast<const char*>(pFunctions->glGetString(GL_VENDOR))));
+    environment.insert("glRenderer", QString(reinterpret_cast<const char*>(pFunctions->glGetString(GL_RENDERER))));
+    environment.insert("glVersion", QString(reinterpret_cast<const char*>(pFunctions->glGetString(GL_VERSION))));
+
+    m_Result= QJsonObject();
+    m_Result.insert("parameters", m_Parameters.toJson());
+    m_Result.insert("environment", environment);
+    m_Result.insert("scene", scene);
+    m_Result.insert("timeUnit", QString("ms"));
+    m_Result.insert("stages", stages);
+    m_Result.insert("renderProfiler", profilerSummary());
+    m_Result.insert("memory", memory);
+
+    return true;
+}
+
+bool RenderBenchmark::initializeOpenGL()
+{
+    if (nullptr != m_pViewHandler) return true;
+
+    // GLC_lib uses the fixed pipeline
+    QSurfaceFormat format;
+    format.setRenderableType(QSurfaceFormat::OpenGL);
+    format.setProfile(QSurfaceFormat::CompatibilityProfile);
+    format.setDepthBufferSize(24);
+    format.setStencilBufferSize(8);
+    m_Context.setFormat(format);
+    if (!m_Context.create())
+    {
+        m_ErrorString= "Unable to create an OpenGL context";
+        return false;
+    }
+
+    m_Surface.setFormat(m_Context.format());
+    m_Surface.create();
+    if (!m_Context.makeCurrent(&m_Surface))
+    {
+        m_ErrorString= "Unable to make the OpenGL context current";
+        return false;
+    }
+
+    GLC_State::init();
+
+    m_pFrameBuffer= new QOpenGLFramebufferObject(m_Parameters.m_Width, m_Parameters.m_Height, QOpenGLFramebufferObject::CombinedDepthStencil);
+    if (!m_pFrameBuffer->isValid() || !m_pFrameBuffer->bind())
+    {
+        m_ErrorString= "Unable to create the frame buffer";
+        return false;
+    }
+
+    m_pViewHandler= new GLC_OpenGLViewHandler();
+    m_pViewHandler->viewportHandle()->initGl();
+    m_pViewHandler->setSize(m_Parameters.m_Width, m_Parameters.m_Height);
+
+    return true;
+}
+
+void RenderBenchmark::moveCamera(int frame)
+{
+    // One turn around the scene during the measured frames
+    const double angle= (2.0 * M_PI) / m_Parameters.m_FrameCount;
+    if (frame > 0)
+    {
+        m_pViewHandler->viewportHandle()->cameraHandle()->rotateAroundTarget(GLC_Vector3d(0.0, 0.0, 1.0), angle);
+    }
+}
+
+void RenderBenchmark::renderFrame()
+{
+    m_pViewHandler->render();
+    m_Context.functions()->glFinish();
+}
+
+QJsonObject RenderBenchmark::profilerSummary()
+{
+    const QList<GLC_RenderProfiler::FrameStatistics> frames(GLC_RenderProfiler::frames());
+    const int count= frames.size();
+
+    double stageTime[GLC_RenderProfiler::StageCount]= {};
+    double counters[GLC_RenderProfiler::CounterCount]= {};
+    double lodHistogram[GLC_RenderProfiler::LodBinCount]= {};
+    for (const GLC_RenderProfiler::FrameStatistics& frame : frames)
+    {
+        for (int i= 0; i < GLC_RenderProfiler::StageCount; ++i)
+        {
+            stageTime[i]+= static_cast<double>(frame.m_StageTime[i]) / 1000000.0;
+        }
+        for (int i= 0; i < GLC_RenderProfiler::CounterCount; ++i)
+        {
+            counters[i]+= static_cast<double>(frame.m_Counters[i]);
+        }
+        for (int i= 0; i < GLC_RenderProfiler::LodBinCount; ++i)
+        {
+            lodHistogram[i]+= static_cast<double>(frame.m_LodHistogram[i]);
+        }
+    }
+
+    QJsonObject subject;
+    if (count > 0)
+    {
+        QJsonObject stages;
+        for (int i= 0; i < GLC_RenderProfiler::StageCount; ++i)
+        {
+            stages.insert(GLC_RenderProfiler::stageName(static_cast<GLC_RenderProfiler::Stage>(i)), stageTime[i] / count);
+        }
+        QJsonObject counterObject;
+        for (int i= 0; i < GLC_RenderProfiler::CounterCount; ++i)
+        {
+            counterObject.insert(GLC_RenderProfiler::counterName(static_cast<GLC_RenderProfiler::Counter>(i)), counters[i] / count);
+        }
+        QJsonArray lodArray;
+        for (int i= 0; i < GLC_RenderProfiler::LodBinCount; ++i)
+        {
+            lodArray.append(lodHistogram[i] / count);
+        }
+        subject.insert("frames", count);
+        subject.insert("meanStageSelfTime", stages);
+        subject.insert("meanCounters", counterObject);
+        subject.insert("meanLodHistogram", lodArray);
+    }
+
+    return subject;
+}
+
+QJsonObject RenderBenchmark::processMemory()
+{
+    QJsonObject subject;
+
+    // Only available on Linux
+    QFile statusFile("/proc/self/status");
+    if (statusFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        const QList<QByteArray> lines(statusFile.readAll().split('\n'));
+        for (const QByteArray& line : lines)
+        {
+            // Values are in kB
+            if (line.startsWith("VmRSS:") || line.startsWith("VmHWM:"))
+            {
+                const QList<QByteArray> fields(line.simplified().split(' '));
+                if (fields.size() >= 2)
+                {
+                    const QString key= line.startsWith("VmRSS:") ? "residentSize" : "peakResidentSize";
+                    subject.insert(key, fields.at(1).toDouble() * 1024.0);
+                }
+            }
+        }
+    }
+
+    return subject;
+}
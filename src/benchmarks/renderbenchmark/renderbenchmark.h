@@ -0,0 +1,93 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+#ifndef RENDERBENCHMARK_H_
+#define RENDERBENCHMARK_H_
+
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+#include <QOpenGLFramebufferObject>
+#include <QJsonObject>
+#include <QList>
+
+#include <GLC_OpenGLViewHandler>
+
+#include "benchmarkscene.h"
+
+//! Headless benchmark of the GLC_lib rendering pipeline
+/*! The benchmark renders a procedural scene in a frame buffer object of an
+ *  offscreen surface and measures, in milliseconds :
+ *  - sceneGeneration : Creation of meshes and of the product structure
+ *  - setWorld : Attachment of the world to the view handler
+ *  - spacePartitioning : Creation of the octree
+ *  - firstFrame : First frame, including VBO creation
+ *  - culling : Frustum culling for each camera position
+ *  - sorting : Back to front sort of viewable instances for each camera position
+ *  - rendering : Frames rendered with the camera orbiting around the scene
+ *
+ *  Rendering stage details come from GLC_RenderProfiler.*/
+class RenderBenchmark
+{
+public:
+    explicit RenderBenchmark(const BenchmarkParameters& parameters);
+    ~RenderBenchmark();
+
+public:
+    //! Run the benchmark. Return false if OpenGL is not available
+    bool run();
+
+    //! Return the result of the last run
+    QJsonObject result() const
+    {return m_Result;}
+
+    //! Return the error of the last run
+    QString errorString() const
+    {return m_ErrorString;}
+
+private:
+    //! Create the OpenGL context, the offscreen surface and the frame buffer
+    bool initializeOpenGL();
+
+    //! Move the camera to the position of the given frame
+    void moveCamera(int frame);
+
+    //! Render a frame and wait for its completion
+    void renderFrame();
+
+    //! Return the mean of render profiler frames
+    static QJsonObject profilerSummary();
+
+    //! Return the memory usage of the process in bytes
+    static QJsonObject processMemory();
+
+private:
+    BenchmarkParameters m_Parameters;
+    QOpenGLContext m_Context;
+    QOffscreenSurface m_Surface;
+    QOpenGLFramebufferObject* m_pFrameBuffer;
+    GLC_OpenGLViewHandler* m_pViewHandler;
+    BenchmarkScene* m_pScene;
+    QJsonObject m_Result;
+    QString m_ErrorString;
+};
+
+#endif /* RENDERBENCHMARK_H_ */
@@ -0,0 +1,106 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_aabbtree.cpp implementation of the GLC_AabbTree class.
+
+#include <algorithm>
+
+#include "glc_aabbtree.h"
+
+void GLC_AabbTree::build(const QVector<float>& boxes, QVector<Node>* pNodes, QVector<int>* pOrder)
+{
+    Q_ASSERT((nullptr != pNodes) && (nullptr != pOrder));
+    const int itemCount= boxes.size() / 6;
+    pNodes->clear();
+    pOrder->resize(itemCount);
+    if (0 == itemCount) return;
+
+    QVector<int>& order= *pOrder;
+    for (int i= 0; i < itemCount; ++i) order[i]= i;
+
+    // Median split on the largest extent of the item centers
+    struct Range
+    {
+        int m_Node;
+        int m_Begin;
+        int m_End;
+    };
+    QVector<Range> stack;
+    pNodes->append(Node());
+    stack.append(Range{0, 0, itemCount});
+    while (!stack.isEmpty())
+    {
+        const Range range= stack.takeLast();
+        Node node;
+        float centerMin[3];
+        float centerMax[3];
+        const int firstItem= order.at(range.m_Begin);
+        for (int axis= 0; axis < 3; ++axis)
+        {
+            node.m_Min[axis]= boxes.at(firstItem * 6 + axis);
+            node.m_Max[axis]= boxes.at(firstItem * 6 + 3 + axis);
+            centerMin[axis]= (node.m_Min[axis] + node.m_Max[axis]) * 0.5f;
+            centerMax[axis]= centerMin[axis];
+        }
+        for (int i= range.m_Begin + 1; i < range.m_End; ++i)
+        {
+            const int item= order.at(i);
+            for (int axis= 0; axis < 3; ++axis)
+            {
+                const float minValue= boxes.at(item * 6 + axis);
+                const float maxValue= boxes.at(item * 6 + 3 + axis);
+                const float center= (minValue + maxValue) * 0.5f;
+                node.m_Min[axis]= qMin(node.m_Min[axis], minValue);
+                node.m_Max[axis]= qMax(node.m_Max[axis], maxValue);
+                centerMin[axis]= qMin(centerMin[axis], center);
+                centerMax[axis]= qMax(centerMax[axis], center);
+            }
+        }
+
+        const int count= range.m_End - range.m_Begin;
+        if (count <= LeafSize)
+        {
+            node.m_First= range.m_Begin;
+            node.m_Count= count;
+        }
+        else
+        {
+            int splitAxis= 0;
+            for (int axis= 1; axis < 3; ++axis)
+            {
+                if ((centerMax[axis] - centerMin[axis]) > (centerMax[splitAxis] - centerMin[splitAxis])) splitAxis= axis;
+            }
+            const int middle= range.m_Begin + count / 2;
+            std::nth_element(order.begin() + range.m_Begin, order.begin() + middle, order.begin() + range.m_End, [&boxes, splitAxis](int item1, int item2)
+            {
+                return (boxes.at(item1 * 6 + splitAxis) + boxes.at(item1 * 6 + 3 + splitAxis)) < (boxes.at(item2 * 6 + splitAxis) + boxes.at(item2 * 6 + 3 + splitAxis));
+            });
+
+            node.m_First= pNodes->size();
+            node.m_Count= 0;
+            pNodes->append(Node());
+            pNodes->append(Node());
+            stack.append(Range{node.m_First, range.m_Begin, middle});
+            stack.append(Range{node.m_First + 1, middle, range.m_End});
+        }
+        (*pNodes)[range.m_Node]= node;
+    }
+}
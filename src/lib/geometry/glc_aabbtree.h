@@ -0,0 +1,75 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_aabbtree.h interface for the GLC_AabbTree class.
+
+#ifndef GLC_AABBTREE_H_
+#define GLC_AABBTREE_H_
+
+#include <QVector>
+
+#include "../glc_config.h"
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_AabbTree
+/*! \brief GLC_AabbTree : Builder of trees of axis aligned boxes*/
+
+/*! The tree of a set of items is built from the boxes of the items. Nodes are split
+ *  at the median of the item box centers on their largest extent, leaves have
+ *  at most LeafSize items.
+ *
+ *  The nodes are stored in an array, the first one is the root and the two children
+ *  of an inner node are consecutive. A leaf refers to a range of the items in tree order.
+ *  It is used by GLC_MeshBvh and GLC_KdTree.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_AabbTree
+{
+public:
+    //! A node of a tree
+    struct Node
+    {
+        float m_Min[3];
+        float m_Max[3];
+        //! Index of the first child or of the first item of a leaf
+        int m_First;
+        //! Number of items of a leaf, 0 for an inner node
+        int m_Count;
+    };
+
+    //! Maximum number of items of a leaf
+    enum {LeafSize= 8};
+
+private:
+    GLC_AabbTree();
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Build Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Build the nodes of the tree of the given item boxes, 6 values by item : minimum then maximum
+    /*! pNodes receives the nodes and pOrder the indices of the items in tree order.
+     *  There is no node if there is no item.*/
+    static void build(const QVector<float>& boxes, QVector<Node>* pNodes, QVector<int>* pOrder);
+//@}
+};
+
+#endif /* GLC_AABBTREE_H_ */
@@ -6,12 +6,453 @@
  */
 #include "glc_csghelper.h"
 
+#include <limits>
+
 #include "../3rdparty/csgjs/csgjs.h"
 
 #include "../maths/glc_matrix4x4.h"
 #include "../maths/glc_vector3d.h"
+#include "../glc_state.h"
 
 #include "glc_mesh.h"
+#include "glc_meshbvh.h"
+#include "glc_aabbtree.h"
+
+namespace
+{
+    //! Bounding box of the triangles of a model
+    struct ModelBox
+    {
+        ModelBox()
+        {
+            for (int axis= 0; axis < 3; ++axis)
+            {
+                m_Min[axis]= std::numeric_limits<double>::max();
+                m_Max[axis]= std::numeric_limits<double>::lowest();
+            }
+        }
+
+        bool isEmpty() const
+        {return (m_Min[0] > m_Max[0]) || (m_Min[1] > m_Max[1]) || (m_Min[2] > m_Max[2]);}
+
+        void combine(const csgjs_vector& point)
+        {
+            const double values[3]= {point.x, point.y, point.z};
+            for (int axis= 0; axis < 3; ++axis)
+            {
+                m_Min[axis]= qMin(m_Min[axis], values[axis]);
+                m_Max[axis]= qMax(m_Max[axis], values[axis]);
+            }
+        }
+
+        bool overlap(const ModelBox& other) const
+        {
+            for (int axis= 0; axis < 3; ++axis)
+            {
+                if ((m_Max[axis] < other.m_Min[axis]) || (other.m_Max[axis] < m_Min[axis])) return false;
+            }
+            return true;
+        }
+
+        double m_Min[3];
+        double m_Max[3];
+    };
+
+    ModelBox modelBox(const csgjs_model& model)
+    {
+        ModelBox subject;
+        const int indexCount= model.indices.size();
+        for (int i= 0; i < indexCount; ++i)
+        {
+            subject.combine(model.vertices.at(model.indices.at(i)).pos);
+        }
+
+        return subject;
+    }
+
+    //! Append the given triangle of the source model to the target model
+    void appendTriangle(const csgjs_model& source, int triangle, QVector<int>* pVertexMap, csgjs_model* pTarget)
+    {
+        for (int k= 0; k < 3; ++k)
+        {
+            const int sourceIndex= source.indices.at(triangle * 3 + k);
+            int& targetIndex= (*pVertexMap)[sourceIndex];
+            if (targetIndex < 0)
+            {
+                targetIndex= pTarget->vertices.size();
+                pTarget->vertices.append(source.vertices.at(sourceIndex));
+            }
+            pTarget->indices.append(targetIndex);
+        }
+    }
+
+    //! Split the triangles of the given model in the ones overlapping the given box and the others
+    void splitModel(const csgjs_model& model, const ModelBox& box, csgjs_model* pNear, csgjs_model* pFar)
+    {
+        QVector<int> nearMap(model.vertices.size(), -1);
+        QVector<int> farMap(model.vertices.size(), -1);
+        const int triangleCount= model.indices.size() / 3;
+        for (int i= 0; i < triangleCount; ++i)
+        {
+            ModelBox triangleBox;
+            for (int k= 0; k < 3; ++k)
+            {
+                triangleBox.combine(model.vertices.at(model.indices.at(i * 3 + k)).pos);
+            }
+            if (triangleBox.overlap(box))
+            {
+                appendTriangle(model, i, &nearMap, pNear);
+            }
+            else
+            {
+                appendTriangle(model, i, &farMap, pFar);
+            }
+        }
+    }
+
+    //! Append the given model to the target model, with reversed triangles if inverted
+    void appendModel(const csgjs_model& model, bool inverted, csgjs_model* pTarget)
+    {
+        const int offset= pTarget->vertices.size();
+        const int vertexCount= model.vertices.size();
+        for (int i= 0; i < vertexCount; ++i)
+        {
+            csgjs_vertex vertex= model.vertices.at(i);
+            if (inverted)
+            {
+                vertex.normal= csgjs_vector(-vertex.normal.x, -vertex.normal.y, -vertex.normal.z);
+            }
+            pTarget->vertices.append(vertex);
+        }
+        const int triangleCount= model.indices.size() / 3;
+        for (int i= 0; i < triangleCount; ++i)
+        {
+            pTarget->indices.append(offset + model.indices.at(i * 3));
+            pTarget->indices.append(offset + model.indices.at(i * 3 + (inverted ? 2 : 1)));
+            pTarget->indices.append(offset + model.indices.at(i * 3 + (inverted ? 1 : 2)));
+        }
+    }
+
+    //! Return the tree of the triangles of the given model
+    GLC_MeshBvh modelBvh(const csgjs_model& model)
+    {
+        GLfloatVector positions;
+        positions.reserve(model.vertices.size() * 3);
+        const int vertexCount= model.vertices.size();
+        for (int i= 0; i < vertexCount; ++i)
+        {
+            const csgjs_vector& position= model.vertices.at(i).pos;
+            positions << static_cast<GLfloat>(position.x) << static_cast<GLfloat>(position.y) << static_cast<GLfloat>(position.z);
+        }
+        QVector<GLuint> triangles;
+        triangles.reserve(model.indices.size());
+        const int indexCount= model.indices.size();
+        for (int i= 0; i < indexCount; ++i)
+        {
+            triangles.append(static_cast<GLuint>(model.indices.at(i)));
+        }
+
+        return GLC_MeshBvh(positions, triangles);
+    }
+
+    //! A convex polygon of a triangle fragment
+    typedef QVector<csgjs_vertex> Polygon;
+
+    //! A plane, the points x of the plane verify m_Normal * x == m_Distance
+    struct Plane
+    {
+        GLC_Vector3d m_Normal;
+        double m_Distance;
+    };
+
+    GLC_Point3d position(const csgjs_vertex& vertex)
+    {
+        return GLC_Point3d(vertex.pos.x, vertex.pos.y, vertex.pos.z);
+    }
+
+    //! Return the plane of the given triangle, false if the triangle is degenerated
+    bool trianglePlane(const csgjs_model& model, int triangle, Plane* pPlane)
+    {
+        const GLC_Point3d a(position(model.vertices.at(model.indices.at(triangle * 3))));
+        const GLC_Point3d b(position(model.vertices.at(model.indices.at(triangle * 3 + 1))));
+        const GLC_Point3d c(position(model.vertices.at(model.indices.at(triangle * 3 + 2))));
+        GLC_Vector3d normal((b - a) ^ (c - a));
+        if (normal.length() <= std::numeric_limits<double>::min()) return false;
+
+        normal.normalize();
+        pPlane->m_Normal= normal;
+        pPlane->m_Distance= normal * a;
+
+        return true;
+    }
+
+    csgjs_vertex interpolate(const csgjs_vertex& a, const csgjs_vertex& b, double t)
+    {
+        csgjs_vertex subject(a);
+        subject.pos= csgjs_vector(a.pos.x + (b.pos.x - a.pos.x) * t, a.pos.y + (b.pos.y - a.pos.y) * t, a.pos.z + (b.pos.z - a.pos.z) * t);
+        subject.normal= csgjs_vector(a.normal.x + (b.normal.x - a.normal.x) * t, a.normal.y + (b.normal.y - a.normal.y) * t, a.normal.z + (b.normal.z - a.normal.z) * t);
+        subject.uv= csgjs_vector(a.uv.x + (b.uv.x - a.uv.x) * t, a.uv.y + (b.uv.y - a.uv.y) * t, a.uv.z + (b.uv.z - a.uv.z) * t);
+
+        return subject;
+    }
+
+    //! Split the given polygons by the given plane, the polygons which don't cross it are unchanged
+    void splitPolygons(const Plane& plane, double epsilon, QVector<Polygon>* pPolygons)
+    {
+        QVector<Polygon> result;
+        for (const Polygon& polygon : qAsConst(*pPolygons))
+        {
+            const int count= polygon.size();
+            QVector<double> distances(count);
+            bool hasFront= false;
+            bool hasBack= false;
+            for (int i= 0; i < count; ++i)
+            {
+                distances[i]= (plane.m_Normal * position(polygon.at(i))) - plane.m_Distance;
+                hasFront= hasFront || (distances.at(i) > epsilon);
+                hasBack= hasBack || (distances.at(i) < -epsilon);
+            }
+            if (!hasFront || !hasBack)
+            {
+                result.append(polygon);
+                continue;
+            }
+
+            Polygon front;
+            Polygon back;
+            for (int i= 0; i < count; ++i)
+            {
+                const int j= (i + 1) % count;
+                const double distanceI= distances.at(i);
+                const double distanceJ= distances.at(j);
+                if (distanceI >= -epsilon) front.append(polygon.at(i));
+                if (distanceI <= epsilon) back.append(polygon.at(i));
+                if (((distanceI > epsilon) && (distanceJ < -epsilon)) || ((distanceI < -epsilon) && (distanceJ > epsilon)))
+                {
+                    const csgjs_vertex vertex(interpolate(polygon.at(i), polygon.at(j), distanceI / (distanceI - distanceJ)));
+                    front.append(vertex);
+                    back.append(vertex);
+                }
+            }
+            if (front.size() > 2) result.append(front);
+            if (back.size() > 2) result.append(back);
+        }
+        pPolygons->swap(result);
+    }
+
+    //! Append the given polygon as a triangle fan to the target model, with reversed triangles if inverted
+    void appendPolygon(const Polygon& polygon, bool inverted, csgjs_model* pTarget)
+    {
+        const int offset= pTarget->vertices.size();
+        const int count= polygon.size();
+        for (int i= 0; i < count; ++i)
+        {
+            csgjs_vertex vertex= polygon.at(i);
+            if (inverted)
+            {
+                vertex.normal= csgjs_vector(-vertex.normal.x, -vertex.normal.y, -vertex.normal.z);
+            }
+            pTarget->vertices.append(vertex);
+        }
+        for (int i= 2; i < count; ++i)
+        {
+            pTarget->indices.append(offset);
+            pTarget->indices.append(offset + (inverted ? i : i - 1));
+            pTarget->indices.append(offset + (inverted ? i - 1 : i));
+        }
+    }
+
+    //! Boxes of the triangles of a model and their tree
+    struct TriangleTree
+    {
+        explicit TriangleTree(const csgjs_model& model)
+            : m_Boxes()
+            , m_Nodes()
+            , m_Order()
+        {
+            const int triangleCount= model.indices.size() / 3;
+            m_Boxes.resize(triangleCount);
+            QVector<float> boxes(triangleCount * 6);
+            for (int i= 0; i < triangleCount; ++i)
+            {
+                for (int k= 0; k < 3; ++k)
+                {
+                    m_Boxes[i].combine(model.vertices.at(model.indices.at(i * 3 + k)).pos);
+                }
+                for (int axis= 0; axis < 3; ++axis)
+                {
+                    boxes[i * 6 + axis]= static_cast<float>(m_Boxes.at(i).m_Min[axis]);
+                    boxes[i * 6 + 3 + axis]= static_cast<float>(m_Boxes.at(i).m_Max[axis]);
+                }
+            }
+            GLC_AabbTree::build(boxes, &m_Nodes, &m_Order);
+        }
+
+        //! Set the triangles whose box overlaps the given box
+        void overlappingTriangles(const ModelBox& box, QVector<int>* pTriangles) const
+        {
+            pTriangles->clear();
+            if (m_Nodes.isEmpty()) return;
+
+            QVector<int> stack;
+            stack.append(0);
+            while (!stack.isEmpty())
+            {
+                const GLC_AabbTree::Node& node= m_Nodes.at(stack.takeLast());
+                bool overlap= true;
+                for (int axis= 0; overlap && (axis < 3); ++axis)
+                {
+                    overlap= (node.m_Min[axis] <= box.m_Max[axis]) && (box.m_Min[axis] <= node.m_Max[axis]);
+                }
+                if (!overlap) continue;
+
+                if (0 != node.m_Count)
+                {
+                    for (int i= 0; i < node.m_Count; ++i)
+                    {
+                        const int triangle= m_Order.at(node.m_First + i);
+                        if (m_Boxes.at(triangle).overlap(box)) pTriangles->append(triangle);
+                    }
+                }
+                else
+                {
+                    stack.append(node.m_First);
+                    stack.append(node.m_First + 1);
+                }
+            }
+        }
+
+        QVector<ModelBox> m_Boxes;
+        QVector<GLC_AabbTree::Node> m_Nodes;
+        QVector<int> m_Order;
+    };
+
+    //! Append the fragments of the triangles of a near model which are on the boundary of the result
+    /*! The triangles are split by the planes of the triangles of the other near model which cross them,
+     *  and by the edges of the coplanar ones, so each fragment is inside, outside or on the surface of
+     *  the other model. The fragments are classified against the full other model with points on both
+     *  sides of their center : a fragment is on the boundary if the result is inside on one side only.
+     *  pInsideResult gives if the result contains a point inside (first model, second model) at index
+     *  (inside first * 2 + inside second). The fragments of the second model which are on the surface
+     *  of the first one are skipped, the fragment of the first model stands for both.*/
+    void appendBoundaryFragments(const csgjs_model& near, bool isFirst, const csgjs_model& otherNear, const TriangleTree& otherTree
+                                 , const GLC_MeshBvh& otherBvh, const bool* pInsideResult, double epsilon, csgjs_model* pTarget)
+    {
+        const double offset= epsilon * 10.0;
+        QVector<int> candidates;
+        const int triangleCount= near.indices.size() / 3;
+        for (int i= 0; i < triangleCount; ++i)
+        {
+            Plane plane;
+            if (!trianglePlane(near, i, &plane)) continue;
+
+            ModelBox box;
+            Polygon polygon;
+            for (int k= 0; k < 3; ++k)
+            {
+                const csgjs_vertex& vertex= near.vertices.at(near.indices.at(i * 3 + k));
+                box.combine(vertex.pos);
+                polygon.append(vertex);
+            }
+            for (int axis= 0; axis < 3; ++axis)
+            {
+                box.m_Min[axis]-= epsilon;
+                box.m_Max[axis]+= epsilon;
+            }
+
+            QVector<Polygon> fragments;
+            fragments.append(polygon);
+            otherTree.overlappingTriangles(box, &candidates);
+            for (int candidate : qAsConst(candidates))
+            {
+                Plane otherPlane;
+                if (!trianglePlane(otherNear, candidate, &otherPlane)) continue;
+
+                bool coplanar= qAbs(plane.m_Normal * otherPlane.m_Normal) > (1.0 - 1.0e-9);
+                for (int k= 0; coplanar && (k < 3); ++k)
+                {
+                    coplanar= qAbs((otherPlane.m_Normal * position(polygon.at(k))) - otherPlane.m_Distance) <= epsilon;
+                }
+                if (coplanar)
+                {
+                    // The fragments are split by the edges of the coplanar triangle
+                    for (int k= 0; k < 3; ++k)
+                    {
+                        const GLC_Point3d start(position(otherNear.vertices.at(otherNear.indices.at(candidate * 3 + k))));
+                        const GLC_Point3d end(position(otherNear.vertices.at(otherNear.indices.at(candidate * 3 + (k + 1) % 3))));
+                        Plane edgePlane;
+                        edgePlane.m_Normal= otherPlane.m_Normal ^ (end - start);
+                        if (edgePlane.m_Normal.length() <= std::numeric_limits<double>::min()) continue;
+                        edgePlane.m_Normal.normalize();
+                        edgePlane.m_Distance= edgePlane.m_Normal * start;
+                        splitPolygons(edgePlane, epsilon, &fragments);
+                    }
+                }
+                else
+                {
+                    splitPolygons(otherPlane, epsilon, &fragments);
+                }
+            }
+
+            for (const Polygon& fragment : qAsConst(fragments))
+            {
+                GLC_Point3d center;
+                for (const csgjs_vertex& vertex : fragment)
+                {
+                    center+= position(vertex);
+                }
+                center= center * (1.0 / fragment.size());
+
+                // The front of a fragment is outside its model, the back inside
+                const bool frontInOther= otherBvh.contains(center + plane.m_Normal * offset);
+                const bool backInOther= otherBvh.contains(center - plane.m_Normal * offset);
+                if (!isFirst && (frontInOther != backInOther)) continue;
+
+                const int front= frontInOther ? 1 : 0;
+                const int back= backInOther ? 1 : 0;
+                const bool frontInResult= isFirst ? pInsideResult[front] : pInsideResult[front * 2];
+                const bool backInResult= isFirst ? pInsideResult[2 + back] : pInsideResult[back * 2 + 1];
+                if (frontInResult == backInResult) continue;
+
+                appendPolygon(fragment, frontInResult, pTarget);
+            }
+        }
+    }
+
+    //! Return true if the given point is inside the closed given model
+    /*! The triangles crossed by a ray are counted, the ray direction is not aligned on the axes*/
+    bool pointInModel(const csgjs_vector& point, const csgjs_model& model)
+    {
+        const GLC_Point3d origin(point.x, point.y, point.z);
+        const GLC_Vector3d direction(GLC_Vector3d(0.5773, 0.5776, 0.5771).normalize());
+        int crossingCount= 0;
+        const int triangleCount= model.indices.size() / 3;
+        for (int i= 0; i < triangleCount; ++i)
+        {
+            GLC_Point3d corners[3];
+            for (int k= 0; k < 3; ++k)
+            {
+                const csgjs_vector& position= model.vertices.at(model.indices.at(i * 3 + k)).pos;
+                corners[k].setVect(position.x, position.y, position.z);
+            }
+            const GLC_Vector3d edge1(corners[1] - corners[0]);
+            const GLC_Vector3d edge2(corners[2] - corners[0]);
+            const GLC_Vector3d p(direction ^ edge2);
+            const double determinant= edge1 * p;
+            if (qAbs(determinant) < std::numeric_limits<double>::min()) continue;
+
+            const GLC_Vector3d t(origin - corners[0]);
+            const double u= (t * p) / determinant;
+            if ((u < 0.0) || (u > 1.0)) continue;
+            const GLC_Vector3d q(t ^ edge1);
+            const double v= (direction * q) / determinant;
+            if ((v < 0.0) || ((u + v) > 1.0)) continue;
+            if (((edge2 * q) / determinant) > 0.0) ++crossingCount;
+        }
+
+        return (crossingCount % 2) == 1;
+    }
+}
 
 GLC_CsgHelper::GLC_CsgHelper()
 {
@@ -23,7 +464,7 @@ GLC_Mesh*GLC_CsgHelper::intersection(const GLC_Mesh* pMesh1, const GLC_Matrix4x4
     csgjs_model* pCsgModel1= csgModelFromMesh(pMesh1, m1);
     csgjs_model* pCsgModel2= csgModelFromMesh(pMesh2, m2);
 
-    csgjs_model result= csgjs_intersection(*pCsgModel1, *pCsgModel2);
+    csgjs_model result= csgIntersection(*pCsgModel1, *pCsgModel2);
 
     GLC_Mesh* pSubject= meshFromCsgModel(result, materialHash(pMesh1, pMesh2));
 
@@ -38,7 +479,7 @@ void GLC_CsgHelper::intersection(GLC_Mesh* pResultMesh, const GLC_Mesh* pMesh1,
     csgjs_model* pCsgModel1= csgModelFromMesh(pMesh1, m1);
     csgjs_model* pCsgModel2= csgModelFromMesh(pMesh2, m2);
 
-    csgjs_model result= csgjs_intersection(*pCsgModel1, *pCsgModel2);
+    csgjs_model result= csgIntersection(*pCsgModel1, *pCsgModel2);
 
     meshFromCsgModel(result, materialHash(pMesh1, pMesh2), pResultMesh);
 
@@ -54,7 +495,7 @@ GLC_Mesh*GLC_CsgHelper::add(const GLC_Mesh* pMesh1, const GLC_Matrix4x4& m1, con
     csgjs_model* pCsgModel1= csgModelFromMesh(pMesh1, m1);
     csgjs_model* pCsgModel2= csgModelFromMesh(pMesh2, m2);
 
-    csgjs_model result= csgjs_union(*pCsgModel1, *pCsgModel2);
+    csgjs_model result= csgUnion(*pCsgModel1, *pCsgModel2);
 
     GLC_Mesh* pSubject= meshFromCsgModel(result, materialHash(pMesh1, pMesh2));
 
@@ -69,7 +510,7 @@ void GLC_CsgHelper::add(GLC_Mesh* pResultMesh, const GLC_Mesh* pMesh1, const GLC
     csgjs_model* pCsgModel1= csgModelFromMesh(pMesh1, m1);
     csgjs_model* pCsgModel2= csgModelFromMesh(pMesh2, m2);
 
-    csgjs_model result= csgjs_union(*pCsgModel1, *pCsgModel2);
+    csgjs_model result= csgUnion(*pCsgModel1, *pCsgModel2);
 
     meshFromCsgModel(result, materialHash(pMesh1, pMesh2), pResultMesh);
 
@@ -85,7 +526,7 @@ GLC_Mesh *GLC_CsgHelper::soustract(const GLC_Mesh *pMesh1, const GLC_Matrix4x4&
     csgjs_model* pCsgModel1= csgModelFromMesh(pMesh1, m1);
     csgjs_model* pCsgModel2= csgModelFromMesh(pMesh2, m2);
 
-    csgjs_model result= csgjs_difference(*pCsgModel1, *pCsgModel2);
+    csgjs_model result= csgDifference(*pCsgModel1, *pCsgModel2);
 
     GLC_Mesh* pSubject= meshFromCsgModel(result, materialHash(pMesh1, pMesh2));
 
@@ -100,7 +541,7 @@ void GLC_CsgHelper::soustract(GLC_Mesh* pResultMesh, const GLC_Mesh* pMesh1, con
     csgjs_model* pCsgModel1= csgModelFromMesh(pMesh1, m1);
     csgjs_model* pCsgModel2= csgModelFromMesh(pMesh2, m2);
 
-    csgjs_model result= csgjs_difference(*pCsgModel1, *pCsgModel2);
+    csgjs_model result= csgDifference(*pCsgModel1, *pCsgModel2);
 
     meshFromCsgModel(result, materialHash(pMesh1, pMesh2), pResultMesh);
 
@@ -242,3 +683,123 @@ QHash<GLC_uint, GLC_Material*> GLC_CsgHelper::materialHash(const GLC_Mesh* pMesh
 
     return subject;
 }
+
+csgjs_model GLC_CsgHelper::csgUnion(const csgjs_model& model1, const csgjs_model& model2)
+{
+    return evaluate(CsgUnion, model1, model2);
+}
+
+csgjs_model GLC_CsgHelper::csgIntersection(const csgjs_model& model1, const csgjs_model& model2)
+{
+    return evaluate(CsgIntersection, model1, model2);
+}
+
+csgjs_model GLC_CsgHelper::csgDifference(const csgjs_model& model1, const csgjs_model& model2)
+{
+    return evaluate(CsgDifference, model1, model2);
+}
+
+csgjs_model GLC_CsgHelper::evaluate(CsgOperation operation, const csgjs_model& model1, const csgjs_model& model2)
+{
+    if (!GLC_State::isCsgOverlapCullingActivated()) return evaluateWithCsgjs(operation, model1, model2);
+
+    csgjs_model subject;
+    const ModelBox box1(modelBox(model1));
+    const ModelBox box2(modelBox(model2));
+
+    // The triangles of a model outside the box of the other model are outside the other model
+    ModelBox overlapBox;
+    double extent= 0.0;
+    for (int axis= 0; axis < 3; ++axis)
+    {
+        overlapBox.m_Min[axis]= qMax(box1.m_Min[axis], box2.m_Min[axis]);
+        overlapBox.m_Max[axis]= qMin(box1.m_Max[axis], box2.m_Max[axis]);
+        extent= qMax(extent, qMax(box1.m_Max[axis] - box1.m_Min[axis], box2.m_Max[axis] - box2.m_Min[axis]));
+    }
+    const double epsilon= extent * 1.0e-6;
+    for (int axis= 0; axis < 3; ++axis)
+    {
+        overlapBox.m_Min[axis]-= epsilon;
+        overlapBox.m_Max[axis]+= epsilon;
+    }
+
+    if (box1.isEmpty() || box2.isEmpty() || overlapBox.isEmpty())
+    {
+        if (operation != CsgIntersection) appendModel(model1, false, &subject);
+        if (operation == CsgUnion) appendModel(model2, false, &subject);
+
+        return subject;
+    }
+
+    csgjs_model near1;
+    csgjs_model far1;
+    splitModel(model1, overlapBox, &near1, &far1);
+    csgjs_model near2;
+    csgjs_model far2;
+    splitModel(model2, overlapBox, &near2, &far2);
+
+    // Surfaces which don't cross : one model is inside the other one or they are apart
+    const bool surfacesCross= !near1.indices.isEmpty() && !near2.indices.isEmpty()
+            && !GLC_MeshBvh::overlappingTriangles(modelBvh(near1), GLC_Matrix4x4(), modelBvh(near2), GLC_Matrix4x4(), -epsilon, 1).isEmpty();
+    if (!surfacesCross)
+    {
+        const bool model2InModel1= pointInModel(model2.vertices.at(model2.indices.first()).pos, model1);
+        const bool model1InModel2= !model2InModel1 && pointInModel(model1.vertices.at(model1.indices.first()).pos, model2);
+        switch (operation)
+        {
+        case CsgUnion:
+            if (!model1InModel2) appendModel(model1, false, &subject);
+            if (!model2InModel1) appendModel(model2, false, &subject);
+            break;
+        case CsgIntersection:
+            if (model2InModel1) appendModel(model2, false, &subject);
+            else if (model1InModel2) appendModel(model1, false, &subject);
+            break;
+        default:
+            if (!model1InModel2) appendModel(model1, false, &subject);
+            if (model2InModel1) appendModel(model2, true, &subject);
+            break;
+        }
+
+        return subject;
+    }
+
+    // The near triangles are split where the surfaces cross and classified against the full models
+    bool insideResult[4];
+    for (int inside1= 0; inside1 < 2; ++inside1)
+    {
+        for (int inside2= 0; inside2 < 2; ++inside2)
+        {
+            bool inside= false;
+            if (operation == CsgUnion) inside= inside1 || inside2;
+            else if (operation == CsgIntersection) inside= inside1 && inside2;
+            else inside= inside1 && !inside2;
+            insideResult[inside1 * 2 + inside2]= inside;
+        }
+    }
+    const TriangleTree tree1(near1);
+    const TriangleTree tree2(near2);
+    appendBoundaryFragments(near1, true, near2, tree2, modelBvh(model2), insideResult, epsilon, &subject);
+    appendBoundaryFragments(near2, false, near1, tree1, modelBvh(model1), insideResult, epsilon, &subject);
+
+    if (operation != CsgIntersection) appendModel(far1, false, &subject);
+    if (operation == CsgUnion) appendModel(far2, false, &subject);
+
+    return subject;
+}
+
+csgjs_model GLC_CsgHelper::evaluateWithCsgjs(CsgOperation operation, const csgjs_model& model1, const csgjs_model& model2)
+{
+    if (operation == CsgDifference)
+    {
+        return csgjs_difference(model1, model2);
+    }
+    else if (operation == CsgIntersection)
+    {
+        return csgjs_intersection(model1, model2);
+    }
+    else
+    {
+        return csgjs_union(model1, model2);
+    }
+}
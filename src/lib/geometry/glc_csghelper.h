@@ -37,8 +37,34 @@ public:
     static GLC_Mesh* meshFromCsgModel(const csgjs_model& model, const QHash<GLC_uint, GLC_Material*>& materialHash);
     static void meshFromCsgModel(const csgjs_model& model, const QHash<GLC_uint, GLC_Material*>& materialHash, GLC_Mesh* pMesh);
 
+    //! Return the union of the given models
+    /*! If GLC_State::isCsgOverlapCullingActivated(), only the triangles which overlap the
+     *  bounding box of the other model are split where the surfaces cross, the others are copied
+     *  unmodified. The fragments are classified against the full other model, so concave models
+     *  are supported. Otherwise the models are given to csgjs.*/
+    static csgjs_model csgUnion(const csgjs_model& model1, const csgjs_model& model2);
+
+    //! Return the intersection of the given models, see csgUnion()
+    static csgjs_model csgIntersection(const csgjs_model& model1, const csgjs_model& model2);
+
+    //! Return the difference of the given models, see csgUnion()
+    static csgjs_model csgDifference(const csgjs_model& model1, const csgjs_model& model2);
+
 private:
+    enum CsgOperation
+    {
+        CsgUnion,
+        CsgIntersection,
+        CsgDifference
+    };
+
     static QHash<GLC_uint, GLC_Material*> materialHash(const GLC_Mesh* pMesh1, const GLC_Mesh* pMesh2);
+
+    //! Return the result of the given operation on the given models
+    static csgjs_model evaluate(CsgOperation operation, const csgjs_model& model1, const csgjs_model& model2);
+
+    //! Return the result of csgjs for the given operation on the given models
+    static csgjs_model evaluateWithCsgjs(CsgOperation operation, const csgjs_model& model1, const csgjs_model& model2);
 };
 
 #endif // GLC_CSGHELPER_H
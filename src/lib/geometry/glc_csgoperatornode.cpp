@@ -85,15 +85,15 @@ bool GLC_CsgOperatorNode::update()
 
         if (m_OperationType == CsgDifference)
         {
-            m_pResultCsgModel= new csgjs_model(csgjs_difference(*pModel1, *pModel2));
+            m_pResultCsgModel= new csgjs_model(GLC_CsgHelper::csgDifference(*pModel1, *pModel2));
         }
         else if (m_OperationType == CsgIntersection)
         {
-            m_pResultCsgModel= new csgjs_model(csgjs_intersection(*pModel1, *pModel2));
+            m_pResultCsgModel= new csgjs_model(GLC_CsgHelper::csgIntersection(*pModel1, *pModel2));
         }
         else
         {
-            m_pResultCsgModel= new csgjs_model(csgjs_union(*pModel1, *pModel2));
+            m_pResultCsgModel= new csgjs_model(GLC_CsgHelper::csgUnion(*pModel1, *pModel2));
         }
         updateMaterialHash();
 
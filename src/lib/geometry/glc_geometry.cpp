@@ -27,6 +27,7 @@
 #include "../glc_state.h"
 #include "../glc_context.h"
 #include "../glc_contextmanager.h"
+#include "../glc_renderprofiler.h"
 
 #include "glc_geometry.h"
 
@@ -48,6 +49,7 @@ GLC_Geometry::GLC_Geometry(const QString& name, const bool typeIsWire)
     , m_Id(glc::GLC_GenGeomID())
     , m_Name(name)
     , m_UseVbo(GLC_State::vboUsed())
+    , m_Revision(0)
 {
 
 }
@@ -66,6 +68,7 @@ GLC_Geometry::GLC_Geometry(const GLC_Geometry& other)
     , m_Id(glc::GLC_GenGeomID())
     , m_Name(other.m_Name)
     , m_UseVbo(other.m_UseVbo)
+    , m_Revision(0)
 {
 
     innerCopy(other);
@@ -84,6 +87,7 @@ GLC_Geometry& GLC_Geometry::operator=(const GLC_Geometry& other)
         m_IsWire= other.m_IsWire;
         m_Name= other.m_Name;
         m_UseVbo= other.m_UseVbo;
+        ++m_Revision;
 
         innerCopy(other);
     }
@@ -98,8 +102,7 @@ GLC_Geometry::~GLC_Geometry()
         while (i != m_MaterialHash.constEnd())
         {
             // delete the material if necessary
-            i.value()->delGLC_Geom(id());
-            if (i.value()->isUnused()) delete i.value();
+            if (i.value()->releaseGLC_Geom(id())) delete i.value();
             ++i;
         }
     }
@@ -257,6 +260,7 @@ void GLC_Geometry::transformVertice(const GLC_Matrix4x4& matrix)
 {
     if (matrix.type() != GLC_Matrix4x4::Identity)
     {
+        ++m_Revision;
         delete m_pBoundingBox;
         m_pBoundingBox= NULL;
         const int stride= 3;
@@ -325,7 +329,11 @@ void GLC_Geometry::render(const GLC_RenderProperties& renderProperties)
             }
         }
 
-        glDraw(renderProperties);
+        {
+            GLC_RenderProfiler::ScopedTimer profilerTimer(GLC_RenderProfiler::DrawStage);
+            GLC_Context::current()->glcUpdateMatrixUniforms();
+            glDraw(renderProperties);
+        }
         if (!GLC_State::isInSelectionMode() && m_IsWire)
         {
             if (hasActiveShader)
@@ -357,7 +365,9 @@ void GLC_Geometry::glPropGeom(const GLC_RenderProperties& renderProperties)
     {
         glLineWidth(m_LineWidth);
         pContext->glcEnableLighting(false);
-        glDisable(GL_TEXTURE_2D);
+        pContext->renderStateCache()->glcDisable(GL_TEXTURE_2D);
+        // Wire colors overwrite the current material
+        pContext->renderStateCache()->invalidateMaterial();
         if (!renderProperties.isSelected())
         {
             // Set polyline colors
@@ -398,12 +408,11 @@ void GLC_Geometry::removeMaterial(GLC_uint id)
     // Remove the first material
     GLC_Material* pMaterial= m_MaterialHash.value(id);
     // delete the material if necessary
-    pMaterial->delGLC_Geom(this->id());
     if (pMaterial->isTransparent())
     {
         --m_TransparentMaterialNumber;
     }
-    if (pMaterial->isUnused()) delete pMaterial;
+    if (pMaterial->releaseGLC_Geom(this->id())) delete pMaterial;
     m_MaterialHash.remove(id);
 
 }
@@ -412,6 +421,7 @@ void GLC_Geometry::removeMaterial(GLC_uint id)
 void  GLC_Geometry::clearGeometry()
 {
     m_GeometryIsValid= false;
+    ++m_Revision;
 
     delete m_pBoundingBox;
     m_pBoundingBox= NULL;
@@ -422,8 +432,7 @@ void  GLC_Geometry::clearGeometry()
         while (i != m_MaterialHash.constEnd())
         {
             // delete the material if necessary
-            i.value()->delGLC_Geom(id());
-            if (i.value()->isUnused()) delete i.value();
+            if (i.value()->releaseGLC_Geom(id())) delete i.value();
             ++i;
         }
     }
@@ -56,6 +56,15 @@ typedef QHash<GLC_uint, GLC_Material*> MaterialHash;
  *      - Empty virtual method to get the number of vertex                                    : GLC_Geometry::numberOfVertex()
  *      - Empty virtual method to get the number of faces                                     : GLC_Geoetry::numberOfFaces()
  *
+ * Thread safety : \n
+ *      - Geometry ids are generated with an atomic counter (GLC_GenGeomID()), so geometries can be
+ *        created concurrently from loader or worker threads.
+ *      - The materials "where used" tables are locked by GLC_Material, and a material shared by several
+ *        geometries is released atomically, so geometries sharing materials can be created and deleted concurrently.
+ *      - The state owned by one geometry (material hash, cached bounding box, wire data) is not locked :
+ *        a geometry must not be modified while other threads use it. GLC_Geometry::boundingBox() computes its
+ *        cache lazily, call it once before sharing the geometry with concurrent readers.
+ *      - OpenGL and VBO methods must only be called from the thread owning the OpenGL context.
  */
 //////////////////////////////////////////////////////////////////////
 
@@ -99,6 +108,12 @@ public:
     bool isValid(void) const
 	{return m_GeometryIsValid;}
 
+	//! Return the revision of the geometry
+	/*! The revision changes when the vertices or the primitives of the geometry change,
+	 *  caches of data computed from the geometry can be keyed on its id and revision*/
+    quint64 revision() const
+	{return m_Revision;}
+
 	//! Return true if the geometry has material
     bool hasMaterial() const
 	{return !m_MaterialHash.isEmpty();}
@@ -328,8 +343,13 @@ protected:
 		m_pBoundingBox= NULL;
 		m_WireData.clear();
 		m_GeometryIsValid= false;
+		++m_Revision;
 	}
 
+	//! Increment the revision of this geometry, to call when its vertices or primitives change
+    void incrementRevision()
+	{++m_Revision;}
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -393,6 +413,9 @@ private:
 
 	//! VBO usage flag
 	bool m_UseVbo;
+
+	//! The revision of the geometry
+	quint64 m_Revision;
 };
 
 #endif /*GLC_GEOMETRY_H_*/
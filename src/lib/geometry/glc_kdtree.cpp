@@ -0,0 +1,567 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_kdtree.cpp implementation of the GLC_KdTree class.
+
+#include <algorithm>
+#include <cmath>
+
+#include <QSet>
+#include <QThread>
+#include <QVarLengthArray>
+#include <QtConcurrent>
+
+#include "glc_kdtree.h"
+#include "glc_mesh.h"
+#include "glc_pointcloud.h"
+#include "../sceneGraph/glc_3dviewinstance.h"
+#include "../shading/glc_material.h"
+
+namespace
+{
+    //! Return the squared distance between the given point and the given box
+    template <typename NodeType>
+    double boxSquaredDistance(const NodeType& node, const double* pPoint)
+    {
+        double subject= 0.0;
+        for (int axis= 0; axis < 3; ++axis)
+        {
+            double delta= 0.0;
+            if (pPoint[axis] < node.m_Min[axis]) delta= node.m_Min[axis] - pPoint[axis];
+            else if (pPoint[axis] > node.m_Max[axis]) delta= pPoint[axis] - node.m_Max[axis];
+            subject+= delta * delta;
+        }
+
+        return subject;
+    }
+
+    //! Return the squared distance between the given point and the given float point
+    double squaredDistance(const double* pPoint, const GLfloat* pOther)
+    {
+        const double dx= pOther[0] - pPoint[0];
+        const double dy= pOther[1] - pPoint[1];
+        const double dz= pOther[2] - pPoint[2];
+
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    //! Return the squared distance between the given point and the given segment and store the closest point
+    double segmentSquaredDistance(const double* pPoint, const GLfloat* pStart, const GLfloat* pEnd, double* pClosest)
+    {
+        double direction[3];
+        double toPoint[3];
+        double length2= 0.0;
+        double projection= 0.0;
+        for (int axis= 0; axis < 3; ++axis)
+        {
+            direction[axis]= static_cast<double>(pEnd[axis]) - pStart[axis];
+            toPoint[axis]= pPoint[axis] - pStart[axis];
+            length2+= direction[axis] * direction[axis];
+            projection+= direction[axis] * toPoint[axis];
+        }
+        const double t= (length2 > 0.0) ? qBound(0.0, projection / length2, 1.0) : 0.0;
+        double subject= 0.0;
+        for (int axis= 0; axis < 3; ++axis)
+        {
+            pClosest[axis]= pStart[axis] + t * direction[axis];
+            const double delta= pClosest[axis] - pPoint[axis];
+            subject+= delta * delta;
+        }
+
+        return subject;
+    }
+
+    //! Return true if the first neighbour is before the second one
+    bool neighbourLessThan(const GLC_KdTree::Neighbour& neighbour1, const GLC_KdTree::Neighbour& neighbour2)
+    {
+        return (neighbour1.m_Distance < neighbour2.m_Distance)
+                || ((neighbour1.m_Distance == neighbour2.m_Distance) && (neighbour1.m_Index < neighbour2.m_Index));
+    }
+
+    //! Return the squared value of the given distance which may be infinite
+    double squared(double distance)
+    {
+        if (distance < 0.0) return -1.0;
+        if (distance > std::sqrt(std::numeric_limits<double>::max())) return std::numeric_limits<double>::max();
+
+        return distance * distance;
+    }
+
+    //! A range of query points processed by one thread
+    struct Chunk
+    {
+        int m_Begin;
+        int m_End;
+    };
+
+    //! Call the given function on each index of [0, count[ in parallel chunks
+    template <typename Function>
+    void mapInChunks(int count, Function function)
+    {
+        const int chunkCount= qBound(1, count / GLC_KdTree::ChunkSize, QThread::idealThreadCount() * 4);
+        QVector<Chunk> chunks(chunkCount);
+        for (int i= 0; i < chunkCount; ++i)
+        {
+            chunks[i].m_Begin= static_cast<int>((static_cast<qint64>(count) * i) / chunkCount);
+            chunks[i].m_End= static_cast<int>((static_cast<qint64>(count) * (i + 1)) / chunkCount);
+        }
+
+        const auto processChunk= [&function](const Chunk& chunk)
+        {
+            for (int i= chunk.m_Begin; i < chunk.m_End; ++i)
+            {
+                function(i);
+            }
+        };
+        if (chunkCount > 1)
+        {
+            QtConcurrent::blockingMap(chunks, processChunk);
+        }
+        else
+        {
+            processChunk(chunks.first());
+        }
+    }
+}
+
+GLC_KdTree::GLC_KdTree()
+    : m_Positions()
+    , m_Edges()
+    , m_BodyOffsets()
+    , m_PointTree()
+    , m_EdgeTree()
+{
+
+}
+
+GLC_KdTree::GLC_KdTree(const GLfloatVector& positions, const GLC_Matrix4x4& matrix)
+    : m_Positions()
+    , m_Edges()
+    , m_BodyOffsets()
+    , m_PointTree()
+    , m_EdgeTree()
+{
+    appendPositions(positions, matrix.getData());
+    build();
+}
+
+GLC_KdTree::GLC_KdTree(const GLC_Geometry* pGeometry, const GLC_Matrix4x4& matrix)
+    : m_Positions()
+    , m_Edges()
+    , m_BodyOffsets()
+    , m_PointTree()
+    , m_EdgeTree()
+{
+    Q_ASSERT(nullptr != pGeometry);
+    appendGeometry(pGeometry, matrix.getData());
+    build();
+}
+
+GLC_KdTree::GLC_KdTree(const GLC_3DViewInstance* pInstance)
+    : m_Positions()
+    , m_Edges()
+    , m_BodyOffsets()
+    , m_PointTree()
+    , m_EdgeTree()
+{
+    Q_ASSERT(nullptr != pInstance);
+    const double* pMatrix= pInstance->matrix().getData();
+    const int bodyCount= pInstance->numberOfBody();
+    for (int i= 0; i < bodyCount; ++i)
+    {
+        m_BodyOffsets.append(pointCount());
+        appendGeometry(pInstance->geomAt(i), pMatrix);
+    }
+    build();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+int GLC_KdTree::bodyIndex(int pointIndex) const
+{
+    Q_ASSERT((pointIndex >= 0) && (pointIndex < pointCount()));
+    const QVector<int>::const_iterator iOffset= std::upper_bound(m_BodyOffsets.constBegin(), m_BodyOffsets.constEnd(), pointIndex);
+
+    return qMax(0, static_cast<int>(iOffset - m_BodyOffsets.constBegin()) - 1);
+}
+
+GLC_BoundingBox GLC_KdTree::boundingBox() const
+{
+    GLC_BoundingBox subject;
+    if (!isEmpty())
+    {
+        const Node& root= m_PointTree.m_Nodes.first();
+        subject.combine(GLC_Point3d(root.m_Min[0], root.m_Min[1], root.m_Min[2]));
+        subject.combine(GLC_Point3d(root.m_Max[0], root.m_Max[1], root.m_Max[2]));
+    }
+
+    return subject;
+}
+
+GLC_KdTree::Neighbour GLC_KdTree::nearest(const GLC_Point3d& point, double maxDistance) const
+{
+    Neighbour subject= {-1, maxDistance};
+    double bestDistance2= squared(maxDistance);
+    if (isEmpty() || (bestDistance2 < 0.0)) return subject;
+
+    const double position[3]= {point.x(), point.y(), point.z()};
+    const Node* pNodes= m_PointTree.m_Nodes.constData();
+    QVarLengthArray<int, 64> stack;
+    stack.append(0);
+    while (!stack.isEmpty())
+    {
+        const Node& node= pNodes[stack.takeLast()];
+        if (boxSquaredDistance(node, position) > bestDistance2) continue;
+
+        if (node.m_Count > 0)
+        {
+            for (int i= node.m_First; i < node.m_First + node.m_Count; ++i)
+            {
+                const int index= m_PointTree.m_Items.at(i);
+                const double distance2= squaredDistance(position, m_Positions.constData() + index * 3);
+                if ((distance2 < bestDistance2) || ((distance2 == bestDistance2) && ((subject.m_Index < 0) || (index < subject.m_Index))))
+                {
+                    bestDistance2= distance2;
+                    subject.m_Index= index;
+                }
+            }
+        }
+        else
+        {
+            // The nearest child is visited first
+            const double distance1= boxSquaredDistance(pNodes[node.m_First], position);
+            const double distance2= boxSquaredDistance(pNodes[node.m_First + 1], position);
+            const int nearChild= (distance1 <= distance2) ? node.m_First : node.m_First + 1;
+            stack.append((nearChild == node.m_First) ? node.m_First + 1 : node.m_First);
+            stack.append(nearChild);
+        }
+    }
+    if (subject.m_Index >= 0) subject.m_Distance= std::sqrt(bestDistance2);
+
+    return subject;
+}
+
+QVector<GLC_KdTree::Neighbour> GLC_KdTree::kNearest(const GLC_Point3d& point, int k, double maxDistance) const
+{
+    QVector<Neighbour> subject;
+    const double maxDistance2= squared(maxDistance);
+    if (isEmpty() || (k <= 0) || (maxDistance2 < 0.0)) return subject;
+
+    // The neighbours are kept in a max heap of squared distances
+    subject.reserve(qMin(k, pointCount()) + 1);
+    const double position[3]= {point.x(), point.y(), point.z()};
+    const Node* pNodes= m_PointTree.m_Nodes.constData();
+    QVarLengthArray<int, 64> stack;
+    stack.append(0);
+    while (!stack.isEmpty())
+    {
+        const double bound= (subject.size() < k) ? maxDistance2 : subject.first().m_Distance;
+        const Node& node= pNodes[stack.takeLast()];
+        if (boxSquaredDistance(node, position) > bound) continue;
+
+        if (node.m_Count > 0)
+        {
+            for (int i= node.m_First; i < node.m_First + node.m_Count; ++i)
+            {
+                const Neighbour neighbour= {m_PointTree.m_Items.at(i), squaredDistance(position, m_Positions.constData() + m_PointTree.m_Items.at(i) * 3)};
+                if (neighbour.m_Distance > maxDistance2) continue;
+
+                if (subject.size() < k)
+                {
+                    subject.append(neighbour);
+                    std::push_heap(subject.begin(), subject.end(), neighbourLessThan);
+                }
+                else if (neighbourLessThan(neighbour, subject.first()))
+                {
+                    std::pop_heap(subject.begin(), subject.end(), neighbourLessThan);
+                    subject.last()= neighbour;
+                    std::push_heap(subject.begin(), subject.end(), neighbourLessThan);
+                }
+            }
+        }
+        else
+        {
+            const double distance1= boxSquaredDistance(pNodes[node.m_First], position);
+            const double distance2= boxSquaredDistance(pNodes[node.m_First + 1], position);
+            const int nearChild= (distance1 <= distance2) ? node.m_First : node.m_First + 1;
+            stack.append((nearChild == node.m_First) ? node.m_First + 1 : node.m_First);
+            stack.append(nearChild);
+        }
+    }
+
+    std::sort_heap(subject.begin(), subject.end(), neighbourLessThan);
+    for (Neighbour& neighbour : subject)
+    {
+        neighbour.m_Distance= std::sqrt(neighbour.m_Distance);
+    }
+
+    return subject;
+}
+
+QVector<GLC_KdTree::Neighbour> GLC_KdTree::inRadius(const GLC_Point3d& point, double radius) const
+{
+    QVector<Neighbour> subject;
+    const double radius2= squared(radius);
+    if (isEmpty() || (radius2 < 0.0)) return subject;
+
+    const double position[3]= {point.x(), point.y(), point.z()};
+    const Node* pNodes= m_PointTree.m_Nodes.constData();
+    QVarLengthArray<int, 64> stack;
+    stack.append(0);
+    while (!stack.isEmpty())
+    {
+        const Node& node= pNodes[stack.takeLast()];
+        if (boxSquaredDistance(node, position) > radius2) continue;
+
+        if (node.m_Count > 0)
+        {
+            for (int i= node.m_First; i < node.m_First + node.m_Count; ++i)
+            {
+                const int index= m_PointTree.m_Items.at(i);
+                const double distance2= squaredDistance(position, m_Positions.constData() + index * 3);
+                if (distance2 <= radius2)
+                {
+                    subject.append(Neighbour{index, distance2});
+                }
+            }
+        }
+        else
+        {
+            stack.append(node.m_First);
+            stack.append(node.m_First + 1);
+        }
+    }
+
+    std::sort(subject.begin(), subject.end(), neighbourLessThan);
+    for (Neighbour& neighbour : subject)
+    {
+        neighbour.m_Distance= std::sqrt(neighbour.m_Distance);
+    }
+
+    return subject;
+}
+
+GLC_KdTree::EdgePoint GLC_KdTree::nearestEdgePoint(const GLC_Point3d& point, double maxDistance) const
+{
+    EdgePoint subject= {-1, point, maxDistance};
+    double bestDistance2= squared(maxDistance);
+    if (m_EdgeTree.m_Nodes.isEmpty() || (bestDistance2 < 0.0)) return subject;
+
+    const double position[3]= {point.x(), point.y(), point.z()};
+    const GLfloat* pPositions= m_Positions.constData();
+    const Node* pNodes= m_EdgeTree.m_Nodes.constData();
+    QVarLengthArray<int, 64> stack;
+    stack.append(0);
+    while (!stack.isEmpty())
+    {
+        const Node& node= pNodes[stack.takeLast()];
+        if (boxSquaredDistance(node, position) > bestDistance2) continue;
+
+        if (node.m_Count > 0)
+        {
+            for (int i= node.m_First; i < node.m_First + node.m_Count; ++i)
+            {
+                const int edge= m_EdgeTree.m_Items.at(i);
+                double closest[3];
+                const double distance2= segmentSquaredDistance(position, pPositions + m_Edges.at(edge * 2) * 3, pPositions + m_Edges.at(edge * 2 + 1) * 3, closest);
+                if ((distance2 < bestDistance2) || ((distance2 == bestDistance2) && ((subject.m_Edge < 0) || (edge < subject.m_Edge))))
+                {
+                    bestDistance2= distance2;
+                    subject.m_Edge= edge;
+                    subject.m_Point.setVect(closest[0], closest[1], closest[2]);
+                }
+            }
+        }
+        else
+        {
+            const double distance1= boxSquaredDistance(pNodes[node.m_First], position);
+            const double distance2= boxSquaredDistance(pNodes[node.m_First + 1], position);
+            const int nearChild= (distance1 <= distance2) ? node.m_First : node.m_First + 1;
+            stack.append((nearChild == node.m_First) ? node.m_First + 1 : node.m_First);
+            stack.append(nearChild);
+        }
+    }
+    if (subject.m_Edge >= 0) subject.m_Distance= std::sqrt(bestDistance2);
+
+    return subject;
+}
+
+GLC_KdTree::Snap GLC_KdTree::snap(const GLC_Point3d& point, double tolerance) const
+{
+    Snap subject= {NoSnap, -1, point};
+
+    const Neighbour neighbour= nearest(point, tolerance);
+    if (neighbour.m_Index >= 0)
+    {
+        subject.m_Type= VertexSnap;
+        subject.m_Index= neighbour.m_Index;
+        subject.m_Point= this->point(neighbour.m_Index);
+    }
+    else
+    {
+        const EdgePoint edgePoint= nearestEdgePoint(point, tolerance);
+        if (edgePoint.m_Edge >= 0)
+        {
+            subject.m_Type= EdgeSnap;
+            subject.m_Index= edgePoint.m_Edge;
+            subject.m_Point= edgePoint.m_Point;
+        }
+    }
+
+    return subject;
+}
+
+QVector<GLC_KdTree::Neighbour> GLC_KdTree::nearest(const QVector<GLC_Point3d>& points, double maxDistance) const
+{
+    QVector<Neighbour> subject(points.size());
+    Neighbour* pSubject= subject.data();
+    mapInChunks(points.size(), [this, &points, pSubject, maxDistance](int i)
+    {
+        pSubject[i]= nearest(points.at(i), maxDistance);
+    });
+
+    return subject;
+}
+
+QVector<QVector<GLC_KdTree::Neighbour> > GLC_KdTree::kNearest(const QVector<GLC_Point3d>& points, int k, double maxDistance) const
+{
+    QVector<QVector<Neighbour> > subject(points.size());
+    QVector<Neighbour>* pSubject= subject.data();
+    mapInChunks(points.size(), [this, &points, pSubject, k, maxDistance](int i)
+    {
+        pSubject[i]= kNearest(points.at(i), k, maxDistance);
+    });
+
+    return subject;
+}
+
+QVector<QVector<GLC_KdTree::Neighbour> > GLC_KdTree::inRadius(const QVector<GLC_Point3d>& points, double radius) const
+{
+    QVector<QVector<Neighbour> > subject(points.size());
+    QVector<Neighbour>* pSubject= subject.data();
+    mapInChunks(points.size(), [this, &points, pSubject, radius](int i)
+    {
+        pSubject[i]= inRadius(points.at(i), radius);
+    });
+
+    return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_KdTree::appendGeometry(const GLC_Geometry* pGeometry, const double* pMatrix)
+{
+    const GLC_Mesh* pMesh= dynamic_cast<const GLC_Mesh*>(pGeometry);
+    if (nullptr != pMesh)
+    {
+        // Each triangle edge once, in both triangles which share it
+        const GLuint firstPoint= static_cast<GLuint>(pointCount());
+        QSet<quint64> edgeSet;
+        const IndexList index(pMesh->equivalentTrianglesIndex(0));
+        const int indexCount= index.size();
+        for (int j= 0; j < indexCount; j+= 3)
+        {
+            for (int corner= 0; corner < 3; ++corner)
+            {
+                const GLuint start= qMin(index.at(j + corner), index.at(j + (corner + 1) % 3));
+                const GLuint end= qMax(index.at(j + corner), index.at(j + (corner + 1) % 3));
+                if (start == end) continue;
+
+                const quint64 key= (static_cast<quint64>(start) << 32) | end;
+                if (!edgeSet.contains(key))
+                {
+                    edgeSet.insert(key);
+                    m_Edges << (firstPoint + start) << (firstPoint + end);
+                }
+            }
+        }
+        appendPositions(pMesh->positionVector(), pMatrix);
+    }
+
+    // Polyline segments of the wire data, points of a point cloud
+    const GLuint firstPoint= static_cast<GLuint>(pointCount());
+    if (nullptr == dynamic_cast<const GLC_PointCloud*>(pGeometry))
+    {
+        const int polylineCount= pGeometry->wirePolylineCount();
+        for (int i= 0; i < polylineCount; ++i)
+        {
+            const GLuint offset= pGeometry->wirePolylineOffset(i);
+            const GLsizei size= pGeometry->wirePolylineSize(i);
+            for (GLsizei j= 1; j < size; ++j)
+            {
+                m_Edges << (firstPoint + offset + j - 1) << (firstPoint + offset + j);
+            }
+        }
+    }
+    appendPositions(pGeometry->wirePositionVector(), pMatrix);
+}
+
+void GLC_KdTree::appendPositions(const GLfloatVector& positions, const double* pMatrix)
+{
+    const int count= positions.size() / 3;
+    const int first= m_Positions.size();
+    m_Positions.resize(first + count * 3);
+    GLfloat* pTarget= m_Positions.data() + first;
+    const GLfloat* pSource= positions.constData();
+    for (int i= 0; i < count; ++i)
+    {
+        const double x= pSource[i * 3];
+        const double y= pSource[i * 3 + 1];
+        const double z= pSource[i * 3 + 2];
+        for (int row= 0; row < 3; ++row)
+        {
+            pTarget[i * 3 + row]= static_cast<GLfloat>(pMatrix[row] * x + pMatrix[4 + row] * y + pMatrix[8 + row] * z + pMatrix[12 + row]);
+        }
+    }
+}
+
+void GLC_KdTree::build()
+{
+    const int count= pointCount();
+    QVector<float> boxes(count * 6);
+    for (int i= 0; i < count; ++i)
+    {
+        for (int axis= 0; axis < 3; ++axis)
+        {
+            boxes[i * 6 + axis]= m_Positions.at(i * 3 + axis);
+            boxes[i * 6 + 3 + axis]= m_Positions.at(i * 3 + axis);
+        }
+    }
+    GLC_AabbTree::build(boxes, &m_PointTree.m_Nodes, &m_PointTree.m_Items);
+
+    const int edgeCount= this->edgeCount();
+    boxes.resize(edgeCount * 6);
+    for (int i= 0; i < edgeCount; ++i)
+    {
+        for (int axis= 0; axis < 3; ++axis)
+        {
+            const float value1= m_Positions.at(m_Edges.at(i * 2) * 3 + axis);
+            const float value2= m_Positions.at(m_Edges.at(i * 2 + 1) * 3 + axis);
+            boxes[i * 6 + axis]= qMin(value1, value2);
+            boxes[i * 6 + 3 + axis]= qMax(value1, value2);
+        }
+    }
+    GLC_AabbTree::build(boxes, &m_EdgeTree.m_Nodes, &m_EdgeTree.m_Items);
+}
@@ -0,0 +1,237 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_kdtree.h interface for the GLC_KdTree class.
+
+#ifndef GLC_KDTREE_H_
+#define GLC_KDTREE_H_
+
+#include <limits>
+
+#include <QVector>
+
+#include "../maths/glc_vector3d.h"
+#include "../maths/glc_matrix4x4.h"
+#include "../glc_boundingbox.h"
+#include "../glc_global.h"
+#include "glc_aabbtree.h"
+
+#include "../glc_config.h"
+
+class GLC_Geometry;
+class GLC_3DViewInstance;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_KdTree
+/*! \brief GLC_KdTree : Nearest neighbour, k nearest and radius queries on points and edges*/
+
+/*! The tree is built from a position buffer placed in the world by a matrix, from the
+ *  vertices of a geometry or from the vertices of all the bodies of an instance in its
+ *  absolute frame. Mesh triangle edges and wire polyline segments are kept as edges for
+ *  nearestEdgePoint() and snap(), point clouds have no edge.
+ *
+ *  Points and edges are stored in two trees of axis aligned boxes built by GLC_AabbTree,
+ *  leaves have at most LeafSize items. Queries
+ *  visit the nearest boxes first and skip the boxes farther than the current result.
+ *
+ *  Results are sorted by increasing distance, equal distances by increasing index.
+ *  The batch queries split the query points in chunks processed by the global thread pool,
+ *  their results are the same as the single queries.
+ *
+ *  A tree is immutable once built and can be shared by threads.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_KdTree
+{
+public:
+    //! A point found by a query
+    struct Neighbour
+    {
+        //! Index of the point, -1 if there is no point
+        int m_Index;
+        //! Distance between the query point and the point
+        double m_Distance;
+    };
+
+    //! A point on an edge found by a query
+    struct EdgePoint
+    {
+        //! Index of the edge, -1 if there is no edge
+        int m_Edge;
+        //! The closest point of the edge
+        GLC_Point3d m_Point;
+        //! Distance between the query point and the closest point
+        double m_Distance;
+    };
+
+    //! Kind of snapping
+    enum SnapType
+    {
+        NoSnap,
+        VertexSnap,
+        EdgeSnap
+    };
+
+    //! Result of a snapping
+    struct Snap
+    {
+        SnapType m_Type;
+        //! Index of the point or of the edge, -1 if there is no snapping
+        int m_Index;
+        //! The snapped point, the query point if there is no snapping
+        GLC_Point3d m_Point;
+    };
+
+    //! Maximum number of items of a leaf
+    enum {LeafSize= GLC_AabbTree::LeafSize};
+
+    //! Minimum number of query points of a parallel chunk
+    enum {ChunkSize= 256};
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Construct an empty tree
+    GLC_KdTree();
+
+    //! Construct the tree of the given positions transformed by the given matrix
+    explicit GLC_KdTree(const GLfloatVector& positions, const GLC_Matrix4x4& matrix= GLC_Matrix4x4());
+
+    //! Construct the tree of the vertices and edges of the given geometry transformed by the given matrix
+    explicit GLC_KdTree(const GLC_Geometry* pGeometry, const GLC_Matrix4x4& matrix= GLC_Matrix4x4());
+
+    //! Construct the tree of the vertices and edges of the bodies of the given instance in its absolute frame
+    explicit GLC_KdTree(const GLC_3DViewInstance* pInstance);
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return true if this tree has no point
+    inline bool isEmpty() const
+    {return m_PointTree.m_Nodes.isEmpty();}
+
+    //! Return the number of points
+    inline int pointCount() const
+    {return m_Positions.size() / 3;}
+
+    //! Return the given point in world coordinates
+    inline GLC_Point3d point(int index) const
+    {
+        const GLfloat* pPoint= m_Positions.constData() + index * 3;
+        return GLC_Point3d(pPoint[0], pPoint[1], pPoint[2]);
+    }
+
+    //! Return the positions of the points in world coordinates
+    inline const GLfloatVector& positions() const
+    {return m_Positions;}
+
+    //! Return the number of edges
+    inline int edgeCount() const
+    {return m_Edges.size() / 2;}
+
+    //! Return the index of the given end (0 or 1) of the given edge
+    inline int edgePoint(int edge, int end) const
+    {return static_cast<int>(m_Edges.at(edge * 2 + end));}
+
+    //! Return the index of the body of the given point
+    /*! It is 0 if the tree was not built from an instance*/
+    int bodyIndex(int pointIndex) const;
+
+    //! Return the bounding box of the points
+    GLC_BoundingBox boundingBox() const;
+
+    //! Return the nearest point of the given point if it is not farther than maxDistance
+    Neighbour nearest(const GLC_Point3d& point, double maxDistance= std::numeric_limits<double>::max()) const;
+
+    //! Return the k nearest points of the given point which are not farther than maxDistance
+    QVector<Neighbour> kNearest(const GLC_Point3d& point, int k, double maxDistance= std::numeric_limits<double>::max()) const;
+
+    //! Return the points which are not farther than radius from the given point
+    QVector<Neighbour> inRadius(const GLC_Point3d& point, double radius) const;
+
+    //! Return the nearest point of the edges to the given point if it is not farther than maxDistance
+    EdgePoint nearestEdgePoint(const GLC_Point3d& point, double maxDistance= std::numeric_limits<double>::max()) const;
+
+    //! Snap the given point to the nearest point or edge not farther than tolerance
+    /*! Points are preferred to edges, so a vertex near an edge is always reachable*/
+    Snap snap(const GLC_Point3d& point, double tolerance) const;
+
+    //! Return the nearest point of each of the given points
+    QVector<Neighbour> nearest(const QVector<GLC_Point3d>& points, double maxDistance= std::numeric_limits<double>::max()) const;
+
+    //! Return the k nearest points of each of the given points
+    QVector<QVector<Neighbour> > kNearest(const QVector<GLC_Point3d>& points, int k, double maxDistance= std::numeric_limits<double>::max()) const;
+
+    //! Return the points in the given radius of each of the given points
+    QVector<QVector<Neighbour> > inRadius(const QVector<GLC_Point3d>& points, double radius) const;
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! A node of a tree
+    typedef GLC_AabbTree::Node Node;
+
+    //! A tree of items
+    struct Tree
+    {
+        //! The nodes, the first one is the root
+        QVector<Node> m_Nodes;
+        //! Indices of the items in tree order
+        QVector<int> m_Items;
+    };
+
+    //! Append the given geometry transformed by the given column major matrix
+    void appendGeometry(const GLC_Geometry* pGeometry, const double* pMatrix);
+
+    //! Append the given positions transformed by the given column major matrix
+    void appendPositions(const GLfloatVector& positions, const double* pMatrix);
+
+    //! Build the trees of the points and of the edges
+    void build();
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Positions of the points in world coordinates
+    GLfloatVector m_Positions;
+
+    //! Point indices of the edges
+    QVector<GLuint> m_Edges;
+
+    //! Index of the first point of each body
+    QVector<int> m_BodyOffsets;
+
+    //! The tree of the points
+    Tree m_PointTree;
+
+    //! The tree of the edges
+    Tree m_EdgeTree;
+};
+
+#endif /* GLC_KDTREE_H_ */
@@ -242,6 +242,39 @@ IndexList GLC_Mesh::getEquivalentTrianglesStripsFansIndex(int lod, GLC_uint mate
     return subject;
 }
 
+IndexList GLC_Mesh::equivalentTrianglesIndex(int lod, GLC_uint materialId) const
+{
+    IndexList subject;
+    if (lodContainsMaterial(lod, materialId))
+    {
+        const IndexList index(getEquivalentTrianglesStripsFansIndex(lod, materialId));
+        const GLuint vertexCount= static_cast<GLuint>(m_MeshData.positionVector().size() / 3);
+        const int indexCount= index.size() - (index.size() % 3);
+        subject.reserve(indexCount);
+        for (int i= 0; i < indexCount; i+= 3)
+        {
+            if ((index.at(i) < vertexCount) && (index.at(i + 1) < vertexCount) && (index.at(i + 2) < vertexCount))
+            {
+                subject << index.at(i) << index.at(i + 1) << index.at(i + 2);
+            }
+        }
+    }
+
+    return subject;
+}
+
+IndexList GLC_Mesh::equivalentTrianglesIndex(int lod) const
+{
+    IndexList subject;
+    const QList<GLC_Material*> materials(materialSet().values());
+    for (GLC_Material* pMaterial : materials)
+    {
+        subject.append(equivalentTrianglesIndex(lod, pMaterial->id()));
+    }
+
+    return subject;
+}
+
 // Return the number of triangles
 int GLC_Mesh::numberOfTriangles(int lod, GLC_uint materialId) const
 {
@@ -710,6 +743,7 @@ void GLC_Mesh::finish()
 {
     if (m_MeshData.lodCount() > 0)
     {
+        incrementRevision();
         boundingBox();
 
         m_MeshData.finishLod();
@@ -732,7 +766,7 @@ void GLC_Mesh::setCurrentLod(const int value)
     {
         const int numberOfLod= m_MeshData.lodCount();
         // Clamp value to number of load
-        m_CurrentLod= static_cast<int>((static_cast<double>(value) / 100.0) * numberOfLod);
+        m_CurrentLod= (value * numberOfLod) / 100;
         if (m_CurrentLod >= numberOfLod) m_CurrentLod = numberOfLod - 1;
         if (m_CurrentLod < 0) m_CurrentLod = 0;
     }
@@ -758,12 +792,18 @@ void GLC_Mesh::replaceMasterMaterial(GLC_Material* pMat)
 // Replace the material specified by id with another one
 void GLC_Mesh::replaceMaterial(const GLC_uint oldId, GLC_Material* pMat)
 {
-    bool isValid= (containsMaterial(oldId));
-    isValid= isValid && (!containsMaterial(pMat->id()) || (pMat->id() == oldId));
-
-    if (isValid)
+    const GLC_uint newId= pMat->id();
+    if (containsMaterial(oldId))
     {
-        if (pMat->id() != oldId)
+        if ((newId != oldId) && containsMaterial(newId))
+        {
+            // Primitives of the old material are drawn with the new one
+            if (mergePrimitiveGroups(oldId, newId))
+            {
+                removeMaterial(oldId);
+            }
+        }
+        else if (newId != oldId)
         {
             // Iterate over Level of detail
             PrimitiveGroupsHash::const_iterator iGroups= m_PrimitiveGroups.constBegin();
@@ -780,9 +820,9 @@ void GLC_Mesh::replaceMaterial(const GLC_uint oldId, GLC_Material* pMat)
                         // Erase old group pointer
                         pPrimitiveGroups->erase(iGroup);
                         // Change the group ID
-                        pGroup->setId(pMat->id());
+                        pGroup->setId(newId);
                         // Add the group with  new ID
-                        pPrimitiveGroups->insert(pMat->id(), pGroup);
+                        pPrimitiveGroups->insert(newId, pGroup);
                         iGroup= pPrimitiveGroups->end();
                     }
                     else
@@ -802,6 +842,73 @@ void GLC_Mesh::replaceMaterial(const GLC_uint oldId, GLC_Material* pMat)
     }
 }
 
+bool GLC_Mesh::mergePrimitiveGroups(GLC_uint sourceId, GLC_uint targetId)
+{
+    // The IBOs would have to be filled again
+    bool subject= (sourceId != targetId) && !(vboIsUsed() && m_GeometryIsValid);
+
+    PrimitiveGroupsHash::const_iterator iGroups= m_PrimitiveGroups.constBegin();
+    while (subject && (m_PrimitiveGroups.constEnd() != iGroups))
+    {
+        const LodPrimitiveGroups* pPrimitiveGroups= iGroups.value();
+        if (pPrimitiveGroups->contains(sourceId) && pPrimitiveGroups->contains(targetId))
+        {
+            subject= primitivesCanBeMerged(*(pPrimitiveGroups->value(sourceId)), *(pPrimitiveGroups->value(targetId)));
+        }
+        ++iGroups;
+    }
+
+    if (subject)
+    {
+        iGroups= m_PrimitiveGroups.constBegin();
+        while (m_PrimitiveGroups.constEnd() != iGroups)
+        {
+            const int lod= iGroups.key();
+            LodPrimitiveGroups* pPrimitiveGroups= iGroups.value();
+            GLC_PrimitiveGroup* pSourceGroup= pPrimitiveGroups->take(sourceId);
+            if (nullptr == pSourceGroup)
+            {
+                // Nothing to merge
+            }
+            else if (!pPrimitiveGroups->contains(targetId))
+            {
+                pSourceGroup->setId(targetId);
+                pPrimitiveGroups->insert(targetId, pSourceGroup);
+            }
+            else if (!pSourceGroup->isFinished())
+            {
+                appendPrimitives(pPrimitiveGroups->value(targetId), *pSourceGroup, QVector<GLuint>());
+                delete pSourceGroup;
+            }
+            else
+            {
+                // Groups of the LOD are rebuilt from the index vector
+                const QVector<GLuint> lodIndex(m_MeshData.indexVector(lod));
+                m_MeshData.indexVectorHandle(lod)->clear();
+
+                LodPrimitiveGroups::iterator iGroup= pPrimitiveGroups->begin();
+                while (pPrimitiveGroups->end() != iGroup)
+                {
+                    GLC_PrimitiveGroup* pGroup= new GLC_PrimitiveGroup(iGroup.key());
+                    appendPrimitives(pGroup, *(iGroup.value()), lodIndex);
+                    if (iGroup.key() == targetId)
+                    {
+                        appendPrimitives(pGroup, *pSourceGroup, lodIndex);
+                    }
+                    delete iGroup.value();
+                    iGroup.value()= pGroup;
+                    moveIndexToMeshDataLod(lod, pGroup);
+                    ++iGroup;
+                }
+                delete pSourceGroup;
+            }
+            ++iGroups;
+        }
+    }
+
+    return subject;
+}
+
 void GLC_Mesh::releaseVboClientSide(bool update)
 {
     m_MeshData.releaseVboClientSide(update);
@@ -1096,6 +1203,8 @@ void GLC_Mesh::glDraw(const GLC_RenderProperties& renderProperties)
     // Update statistics
     GLC_RenderStatistics::addBodies(1);
     GLC_RenderStatistics::addTriangles(m_MeshData.trianglesCount(m_CurrentLod));
+    GLC_RenderProfiler::addCount(GLC_RenderProfiler::BodyCounter);
+    GLC_RenderProfiler::addCount(GLC_RenderProfiler::TriangleCounter, m_MeshData.trianglesCount(m_CurrentLod));
 }
 
 void GLC_Mesh::setClientState()
@@ -1129,6 +1238,8 @@ void GLC_Mesh::restoreClientState(GLC_Context *pContext)
     {
         pContext->glcDisableColorClientState();
         pContext->glcEnableColorMaterial(false);
+        // Vertex colors have overwritten the current material
+        pContext->renderStateCache()->invalidateMaterial();
     }
 
     pContext->glcDisableVertexClientState();
@@ -1162,6 +1273,7 @@ void GLC_Mesh::drawMeshWire(const GLC_RenderProperties& renderProperties, GLC_Co
                            static_cast<float>(m_WireColor.alphaF())};
 
         glColor4fv(color);
+        pContext->renderStateCache()->invalidateMaterial();
         m_WireData.glDraw(renderProperties, GL_LINE_STRIP);
         pContext->glcEnableLighting(true);
         if (hasActiveShader)
@@ -1256,6 +1368,7 @@ void GLC_Mesh::fillVbosAndIbos()
 // set primitive group offset
 void GLC_Mesh::finishSerialized()
 {
+    incrementRevision();
     PrimitiveGroupsHash::const_iterator iGroups= m_PrimitiveGroups.constBegin();
     while (iGroups != m_PrimitiveGroups.constEnd())
     {
@@ -1280,35 +1393,106 @@ void GLC_Mesh::moveIndexToMeshDataLod()
         LodPrimitiveGroups::const_iterator iGroup= iGroups.value()->constBegin();
         while (iGroup != iGroups.value()->constEnd())
         {
-            // Add group triangles index to mesh Data LOD triangles index vector
-            if (iGroup.value()->containsTriangles())
-            {
-                iGroup.value()->setTrianglesOffseti(m_MeshData.indexVectorSize(currentLod));
-                (*m_MeshData.indexVectorHandle(currentLod))+= iGroup.value()->trianglesIndex().toVector();
-            }
+            moveIndexToMeshDataLod(currentLod, iGroup.value());
+            ++iGroup;
+        }
+        ++iGroups;
+    }
+}
 
-            // Add group strip index to mesh Data LOD strip index vector
-            if (iGroup.value()->containsStrip())
-            {
-                iGroup.value()->setBaseTrianglesStripOffseti(m_MeshData.indexVectorSize(currentLod));
-                (*m_MeshData.indexVectorHandle(currentLod))+= iGroup.value()->stripsIndex().toVector();
-            }
+void GLC_Mesh::moveIndexToMeshDataLod(int lod, GLC_PrimitiveGroup* pGroup)
+{
+    // Add group triangles index to mesh Data LOD triangles index vector
+    if (pGroup->containsTriangles())
+    {
+        pGroup->setTrianglesOffseti(m_MeshData.indexVectorSize(lod));
+        (*m_MeshData.indexVectorHandle(lod))+= pGroup->trianglesIndex().toVector();
+    }
 
-            // Add group fan index to mesh Data LOD fan index vector
-            if (iGroup.value()->containsFan())
-            {
-                iGroup.value()->setBaseTrianglesFanOffseti(m_MeshData.indexVectorSize(currentLod));
-                (*m_MeshData.indexVectorHandle(currentLod))+= iGroup.value()->fansIndex().toVector();
-            }
+    // Add group strip index to mesh Data LOD strip index vector
+    if (pGroup->containsStrip())
+    {
+        pGroup->setBaseTrianglesStripOffseti(m_MeshData.indexVectorSize(lod));
+        (*m_MeshData.indexVectorHandle(lod))+= pGroup->stripsIndex().toVector();
+    }
 
-            iGroup.value()->computeVboOffset();
-            iGroup.value()->finish();
-            ++iGroup;
+    // Add group fan index to mesh Data LOD fan index vector
+    if (pGroup->containsFan())
+    {
+        pGroup->setBaseTrianglesFanOffseti(m_MeshData.indexVectorSize(lod));
+        (*m_MeshData.indexVectorHandle(lod))+= pGroup->fansIndex().toVector();
+    }
+
+    pGroup->computeVboOffset();
+    pGroup->finish();
+}
+
+void GLC_Mesh::appendPrimitives(GLC_PrimitiveGroup* pTarget, const GLC_PrimitiveGroup& source, const QVector<GLuint>& lodIndex)
+{
+    Q_ASSERT(!pTarget->isFinished());
+    const bool isFinished= source.isFinished();
+
+    // Offsets of unfinished groups are relative to their own index list
+    if (source.containsTriangles())
+    {
+        const IndexList index(isFinished ? IndexList() : source.trianglesIndex());
+        const int count= source.trianglesIndexSizes().size();
+        for (int i= 0; i < count; ++i)
+        {
+            const int offset= source.trianglesGroupOffseti().at(i);
+            const int size= source.trianglesIndexSizes().at(i);
+            const IndexList triangles(isFinished ? lodIndex.mid(offset, size).toList() : index.mid(offset, size));
+            pTarget->addTriangles(triangles, source.containsTrianglesGroupId() ? source.triangleGroupId(i) : 0);
+        }
+    }
+
+    if (source.containsStrip())
+    {
+        const IndexList index(isFinished ? IndexList() : source.stripsIndex());
+        const int count= source.stripsSizes().size();
+        for (int i= 0; i < count; ++i)
+        {
+            const int offset= source.stripsOffseti().at(i);
+            const int size= source.stripsSizes().at(i);
+            const IndexList strip(isFinished ? lodIndex.mid(offset, size).toList() : index.mid(offset, size));
+            pTarget->addTrianglesStrip(strip, source.containsStripGroupId() ? source.stripGroupId(i) : 0);
+        }
+    }
+
+    if (source.containsFan())
+    {
+        const IndexList index(isFinished ? IndexList() : source.fansIndex());
+        const int count= source.fansSizes().size();
+        for (int i= 0; i < count; ++i)
+        {
+            const int offset= source.fansOffseti().at(i);
+            const int size= source.fansSizes().at(i);
+            const IndexList fan(isFinished ? lodIndex.mid(offset, size).toList() : index.mid(offset, size));
+            pTarget->addTrianglesFan(fan, source.containsFanGroupId() ? source.fanGroupId(i) : 0);
         }
-        ++iGroups;
     }
 }
 
+bool GLC_Mesh::primitivesCanBeMerged(const GLC_PrimitiveGroup& group1, const GLC_PrimitiveGroup& group2)
+{
+    // A group can't mix primitives with and without id
+    bool subject= (group1.isFinished() == group2.isFinished());
+    if (group1.containsTriangles() && group2.containsTriangles())
+    {
+        subject= subject && (group1.containsTrianglesGroupId() == group2.containsTrianglesGroupId());
+    }
+    if (group1.containsStrip() && group2.containsStrip())
+    {
+        subject= subject && (group1.containsStripGroupId() == group2.containsStripGroupId());
+    }
+    if (group1.containsFan() && group2.containsFan())
+    {
+        subject= subject && (group1.containsFanGroupId() == group2.containsFanGroupId());
+    }
+
+    return subject;
+}
+
 // The normal display loop
 void GLC_Mesh::normalRenderLoop(const GLC_RenderProperties& renderProperties, bool vboIsUsed)
 {
@@ -1605,6 +1789,10 @@ void GLC_Mesh::outlineSilhouetteRenderLoop(const GLC_RenderProperties& renderPro
     //if ((!m_IsSelected || !isTransparent) || GLC_State::isInSelectionMode())
     if ((!isTransparent) || GLC_State::isInSelectionMode())
     {
+        // Silhouette colors overwrite the current material
+        GLC_RenderStateCache* pStateCache= GLC_Context::current()->renderStateCache();
+        pStateCache->invalidateMaterial();
+
         LodPrimitiveGroups::const_iterator iGroup= m_PrimitiveGroups.value(m_CurrentLod)->constBegin();
         while (iGroup != m_PrimitiveGroups.value(m_CurrentLod)->constEnd())
         {
@@ -1619,7 +1807,7 @@ void GLC_Mesh::outlineSilhouetteRenderLoop(const GLC_RenderProperties& renderPro
                 uid_flags = uid_flags | 0x800000; //Selection flag
             }
 
-            glDisable(GL_TEXTURE_2D);
+            pStateCache->glcDisable(GL_TEXTURE_2D);
             glEnable(GL_CULL_FACE);
             glCullFace(GL_BACK);
 
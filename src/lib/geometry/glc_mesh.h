@@ -36,6 +36,7 @@
 #include "../shading/glc_selectionmaterial.h"
 #include "../glc_context.h"
 #include "../glc_contextmanager.h"
+#include "../glc_renderprofiler.h"
 
 #include "../glc_config.h"
 
@@ -132,6 +133,14 @@ public:
 	//! Return the equivalent triangle index of (triangle, strip and fan)
     IndexList getEquivalentTrianglesStripsFansIndex(int lod, GLC_uint materialId) const;
 
+	//! Return the equivalent triangle index of (triangle, strip and fan) of the specified material in the specified LOD
+	/*! Empty if the LOD doesn't use the material. Only whole triangles of existing vertices are returned*/
+    IndexList equivalentTrianglesIndex(int lod, GLC_uint materialId) const;
+
+	//! Return the equivalent triangle index of (triangle, strip and fan) of all the materials of the specified LOD
+	/*! See equivalentTrianglesIndex(int, GLC_uint)*/
+    IndexList equivalentTrianglesIndex(int lod= 0) const;
+
 	//! Return the number of triangles in the specified LOD
 	int numberOfTriangles(int lod, GLC_uint materialId) const;
 
@@ -269,8 +278,16 @@ public:
     void replaceMasterMaterial(GLC_Material*) override;
 
 	//! Replace the material specified by id with another one
+	/*! If the mesh already contains the new material, primitive groups of the old material
+	 *  are merged into the groups of the new one, see mergePrimitiveGroups()*/
     void replaceMaterial(const GLC_uint, GLC_Material*) override;
 
+    //! Merge the primitive groups of the given source material id into the groups of the given target material id
+    /*! The index vector of the LODs are rebuilt, this is not possible once the IBOs of the mesh
+     *  are filled or if the groups mix primitives with and without id.
+     *  Return true if the groups have been merged, the source material is not removed from the mesh.*/
+    bool mergePrimitiveGroups(GLC_uint sourceId, GLC_uint targetId);
+
 	//! Set the mesh next primitive local id
 	inline void setNextPrimitiveLocalId(GLC_uint id)
 	{m_NextPrimitiveLocalId= id;}
@@ -351,6 +368,16 @@ private:
 	//! Move Indexs from the primitive groups to the mesh Data LOD and Set Index offsets
 	void moveIndexToMeshDataLod();
 
+    //! Move Indexs of the given primitive group to the given mesh Data LOD and Set Index offsets
+    void moveIndexToMeshDataLod(int lod, GLC_PrimitiveGroup* pGroup);
+
+    //! Append primitives of the given source group to the given unfinished group
+    /*! The index of a finished source group are read from the given LOD index vector*/
+    static void appendPrimitives(GLC_PrimitiveGroup* pTarget, const GLC_PrimitiveGroup& source, const QVector<GLuint>& lodIndex);
+
+    //! Return true if primitives of the given groups can be merged in the same group
+    static bool primitivesCanBeMerged(const GLC_PrimitiveGroup& group1, const GLC_PrimitiveGroup& group2);
+
 	//! Use VBO to Draw primitives from the specified GLC_PrimitiveGroup
 	inline void vboDrawPrimitivesOf(GLC_PrimitiveGroup*);
 
@@ -467,6 +494,12 @@ private:
 // Use VBO to Draw triangles from the specified GLC_PrimitiveGroup
 void GLC_Mesh::vboDrawPrimitivesOf(GLC_PrimitiveGroup* pCurrentGroup)
 {
+	if (GLC_RenderProfiler::isRecording())
+	{
+		const qint64 drawCallCount= (pCurrentGroup->containsTriangles() ? 1 : 0) + pCurrentGroup->stripsSizes().size() + pCurrentGroup->fansSizes().size();
+		GLC_RenderProfiler::addCount(GLC_RenderProfiler::DrawCallCounter, drawCallCount);
+	}
+
 	// Draw triangles
 	if (pCurrentGroup->containsTriangles())
 	{
@@ -496,6 +529,12 @@ void GLC_Mesh::vboDrawPrimitivesOf(GLC_PrimitiveGroup* pCurrentGroup)
 // Use Vertex Array to Draw triangles from the specified GLC_PrimitiveGroup
 void GLC_Mesh::vertexArrayDrawPrimitivesOf(GLC_PrimitiveGroup* pCurrentGroup)
 {
+	if (GLC_RenderProfiler::isRecording())
+	{
+		const qint64 drawCallCount= (pCurrentGroup->containsTriangles() ? 1 : 0) + pCurrentGroup->stripsSizes().size() + pCurrentGroup->fansSizes().size();
+		GLC_RenderProfiler::addCount(GLC_RenderProfiler::DrawCallCounter, drawCallCount);
+	}
+
 	// Draw triangles
 	if (pCurrentGroup->containsTriangles())
 	{
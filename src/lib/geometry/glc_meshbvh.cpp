@@ -0,0 +1,664 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_meshbvh.cpp implementation of the GLC_MeshBvh class.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+
+#include "glc_meshbvh.h"
+#include "glc_mesh.h"
+#include "../shading/glc_material.h"
+
+namespace
+{
+    //! A welded vertex position
+    struct WeldKey
+    {
+        float m_Values[3];
+
+        bool operator==(const WeldKey& other) const
+        {
+            return (m_Values[0] == other.m_Values[0]) && (m_Values[1] == other.m_Values[1]) && (m_Values[2] == other.m_Values[2]);
+        }
+    };
+
+    size_t qHash(const WeldKey& key, size_t seed= 0)
+    {
+        return qHashMulti(seed, key.m_Values[0], key.m_Values[1], key.m_Values[2]);
+    }
+
+    //! A node box in world coordinates
+    struct WorldBox
+    {
+        double m_Min[3];
+        double m_Max[3];
+    };
+
+    //! Return the box of the given node transformed by the given column major matrix
+    WorldBox worldBox(const GLC_MeshBvh::Node& node, const double* pMatrix)
+    {
+        WorldBox subject;
+        double center[3];
+        double extent[3];
+        for (int axis= 0; axis < 3; ++axis)
+        {
+            center[axis]= (static_cast<double>(node.m_Min[axis]) + node.m_Max[axis]) * 0.5;
+            extent[axis]= (static_cast<double>(node.m_Max[axis]) - node.m_Min[axis]) * 0.5;
+        }
+        for (int row= 0; row < 3; ++row)
+        {
+            const double worldCenter= pMatrix[row] * center[0] + pMatrix[4 + row] * center[1] + pMatrix[8 + row] * center[2] + pMatrix[12 + row];
+            const double worldExtent= qAbs(pMatrix[row]) * extent[0] + qAbs(pMatrix[4 + row]) * extent[1] + qAbs(pMatrix[8 + row]) * extent[2];
+            subject.m_Min[row]= worldCenter - worldExtent;
+            subject.m_Max[row]= worldCenter + worldExtent;
+        }
+
+        return subject;
+    }
+
+    //! Return the distance between the given boxes, 0 if they overlap
+    double boxDistance(const WorldBox& box1, const WorldBox& box2)
+    {
+        double squareDistance= 0.0;
+        for (int axis= 0; axis < 3; ++axis)
+        {
+            const double gap= qMax(box2.m_Min[axis] - box1.m_Max[axis], box1.m_Min[axis] - box2.m_Max[axis]);
+            if (gap > 0.0) squareDistance+= gap * gap;
+        }
+
+        return sqrt(squareDistance);
+    }
+
+    //! Return the size of the given box used to choose the node to descend
+    double boxSize(const WorldBox& box)
+    {
+        return (box.m_Max[0] - box.m_Min[0]) + (box.m_Max[1] - box.m_Min[1]) + (box.m_Max[2] - box.m_Min[2]);
+    }
+
+    //! Store the triangles of the given leaf in world coordinates
+    int leafTriangles(const GLC_MeshBvh& bvh, const GLC_MeshBvh::Node& node, const double* pMatrix, GLC_Point3d* pPoints)
+    {
+        for (int i= 0; i < node.m_Count; ++i)
+        {
+            for (int k= 0; k < 3; ++k)
+            {
+                const GLC_Point3d point(bvh.point(node.m_First + i, k));
+                pPoints[i * 3 + k].setVect(pMatrix[0] * point.x() + pMatrix[4] * point.y() + pMatrix[8] * point.z() + pMatrix[12]
+                                           , pMatrix[1] * point.x() + pMatrix[5] * point.y() + pMatrix[9] * point.z() + pMatrix[13]
+                                           , pMatrix[2] * point.x() + pMatrix[6] * point.y() + pMatrix[10] * point.z() + pMatrix[14]);
+            }
+        }
+
+        return node.m_Count;
+    }
+
+    //! Return the distance between the segments [p1, q1] and [p2, q2] and store their closest points
+    double segmentDistance(const GLC_Point3d& p1, const GLC_Point3d& q1, const GLC_Point3d& p2, const GLC_Point3d& q2
+                           , GLC_Point3d* pPoint1, GLC_Point3d* pPoint2)
+    {
+        const double epsilon= std::numeric_limits<double>::epsilon();
+        const GLC_Vector3d d1(q1 - p1);
+        const GLC_Vector3d d2(q2 - p2);
+        const GLC_Vector3d r(p1 - p2);
+        const double a= d1 * d1;
+        const double e= d2 * d2;
+        const double f= d2 * r;
+        double s= 0.0;
+        double t= 0.0;
+        if ((a <= epsilon) && (e <= epsilon))
+        {
+            // Both segments are points
+        }
+        else if (a <= epsilon)
+        {
+            t= qBound(0.0, f / e, 1.0);
+        }
+        else
+        {
+            const double c= d1 * r;
+            if (e <= epsilon)
+            {
+                s= qBound(0.0, -c / a, 1.0);
+            }
+            else
+            {
+                const double b= d1 * d2;
+                const double denominator= a * e - b * b;
+                if (denominator > 0.0) s= qBound(0.0, (b * f - c * e) / denominator, 1.0);
+                t= (b * s + f) / e;
+                if (t < 0.0)
+                {
+                    t= 0.0;
+                    s= qBound(0.0, -c / a, 1.0);
+                }
+                else if (t > 1.0)
+                {
+                    t= 1.0;
+                    s= qBound(0.0, (b - c) / a, 1.0);
+                }
+            }
+        }
+        *pPoint1= p1 + d1 * s;
+        *pPoint2= p2 + d2 * t;
+
+        return (*pPoint1 - *pPoint2).length();
+    }
+
+    //! Return the point of the triangle abc closest to the given point
+    GLC_Point3d closestPointOnTriangle(const GLC_Point3d& p, const GLC_Point3d& a, const GLC_Point3d& b, const GLC_Point3d& c)
+    {
+        const GLC_Vector3d ab(b - a);
+        const GLC_Vector3d ac(c - a);
+        const GLC_Vector3d ap(p - a);
+        const double d1= ab * ap;
+        const double d2= ac * ap;
+        if ((d1 <= 0.0) && (d2 <= 0.0)) return a;
+
+        const GLC_Vector3d bp(p - b);
+        const double d3= ab * bp;
+        const double d4= ac * bp;
+        if ((d3 >= 0.0) && (d4 <= d3)) return b;
+
+        const double vc= d1 * d4 - d3 * d2;
+        if ((vc <= 0.0) && (d1 >= 0.0) && (d3 <= 0.0)) return a + ab * (d1 / (d1 - d3));
+
+        const GLC_Vector3d cp(p - c);
+        const double d5= ab * cp;
+        const double d6= ac * cp;
+        if ((d6 >= 0.0) && (d5 <= d6)) return c;
+
+        const double vb= d5 * d2 - d1 * d6;
+        if ((vb <= 0.0) && (d2 >= 0.0) && (d6 <= 0.0)) return a + ac * (d2 / (d2 - d6));
+
+        const double va= d3 * d6 - d5 * d4;
+        if ((va <= 0.0) && ((d4 - d3) >= 0.0) && ((d5 - d6) >= 0.0)) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+        const double denominator= va + vb + vc;
+        if (denominator <= 0.0) return a;
+
+        return a + ab * (vb / denominator) + ac * (vc / denominator);
+    }
+
+    //! Return true if the ray of the given origin and inverse direction hits the box of the given node
+    bool rayHitsBox(const GLC_MeshBvh::Node& node, const double* pOrigin, const double* pInverseDirection)
+    {
+        double tMin= 0.0;
+        double tMax= std::numeric_limits<double>::max();
+        for (int axis= 0; axis < 3; ++axis)
+        {
+            const double t1= (node.m_Min[axis] - pOrigin[axis]) * pInverseDirection[axis];
+            const double t2= (node.m_Max[axis] - pOrigin[axis]) * pInverseDirection[axis];
+            tMin= qMax(tMin, qMin(t1, t2));
+            tMax= qMin(tMax, qMax(t1, t2));
+        }
+
+        return tMin <= tMax;
+    }
+
+    //! Return true if the ray of the given origin and direction crosses the triangle abc
+    bool rayCrossesTriangle(const GLC_Point3d& origin, const GLC_Vector3d& direction
+                            , const GLC_Point3d& a, const GLC_Point3d& b, const GLC_Point3d& c)
+    {
+        const GLC_Vector3d ab(b - a);
+        const GLC_Vector3d ac(c - a);
+        const GLC_Vector3d p(direction ^ ac);
+        const double determinant= ab * p;
+        if (qAbs(determinant) <= std::numeric_limits<double>::epsilon()) return false;
+
+        const double inverseDeterminant= 1.0 / determinant;
+        const GLC_Vector3d ao(origin - a);
+        const double u= (ao * p) * inverseDeterminant;
+        if ((u < 0.0) || (u > 1.0)) return false;
+
+        const GLC_Vector3d q(ao ^ ab);
+        const double v= (direction * q) * inverseDeterminant;
+        if ((v < 0.0) || ((u + v) > 1.0)) return false;
+
+        return ((ac * q) * inverseDeterminant) > 0.0;
+    }
+}
+
+GLC_MeshBvh::GLC_MeshBvh()
+    : m_Positions()
+    , m_Triangles()
+    , m_Nodes()
+{
+
+}
+
+GLC_MeshBvh::GLC_MeshBvh(const GLC_Mesh* pMesh)
+    : m_Positions()
+    , m_Triangles()
+    , m_Nodes()
+{
+    Q_ASSERT(nullptr != pMesh);
+    build(pMesh->positionVector(), pMesh->equivalentTrianglesIndex(0));
+}
+
+GLC_MeshBvh::GLC_MeshBvh(const GLfloatVector& positions, const QVector<GLuint>& triangles)
+    : m_Positions()
+    , m_Triangles()
+    , m_Nodes()
+{
+    build(positions, triangles);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+GLC_BoundingBox GLC_MeshBvh::boundingBox() const
+{
+    GLC_BoundingBox subject;
+    if (!m_Nodes.isEmpty())
+    {
+        const Node& root= m_Nodes.first();
+        subject.combine(GLC_Point3d(root.m_Min[0], root.m_Min[1], root.m_Min[2]));
+        subject.combine(GLC_Point3d(root.m_Max[0], root.m_Max[1], root.m_Max[2]));
+    }
+
+    return subject;
+}
+
+bool GLC_MeshBvh::contains(const GLC_Point3d& point) const
+{
+    bool subject= false;
+    if (!isEmpty() && boundingBox().intersect(point))
+    {
+        // Directions not aligned with the axes nor with each other, no component is null
+        const GLC_Vector3d directions[3]=
+        {
+            GLC_Vector3d(1.0, 0.3713, 0.1931),
+            GLC_Vector3d(-0.2417, 1.0, 0.4711),
+            GLC_Vector3d(0.3119, -0.5527, 1.0)
+        };
+        int insideCount= 0;
+        for (int i= 0; i < 3; ++i)
+        {
+            if (rayCrossingCount(point, directions[i]) % 2) ++insideCount;
+        }
+        subject= (insideCount >= 2);
+    }
+
+    return subject;
+}
+
+QVector<GLC_MeshBvh::TrianglePair> GLC_MeshBvh::overlappingTriangles(const GLC_MeshBvh& bvh1, const GLC_Matrix4x4& matrix1
+                                                                    , const GLC_MeshBvh& bvh2, const GLC_Matrix4x4& matrix2
+                                                                    , double tolerance, int maxPairCount)
+{
+    QVector<TrianglePair> subject;
+    if (bvh1.isEmpty() || bvh2.isEmpty()) return subject;
+
+    const double* pMatrix1= matrix1.getData();
+    const double* pMatrix2= matrix2.getData();
+
+    // Boxes closer than the tolerance may contain overlapping triangles
+    const double slack= qMax(0.0, -tolerance);
+    GLC_Point3d leaf1[LeafSize * 3];
+    GLC_Point3d leaf2[LeafSize * 3];
+    QVector<QPair<int, int> > stack;
+    stack.append(qMakePair(0, 0));
+    while (!stack.isEmpty())
+    {
+        const QPair<int, int> nodes= stack.takeLast();
+        const Node& node1= bvh1.m_Nodes.at(nodes.first);
+        const Node& node2= bvh2.m_Nodes.at(nodes.second);
+        const WorldBox box1(worldBox(node1, pMatrix1));
+        const WorldBox box2(worldBox(node2, pMatrix2));
+        if (boxDistance(box1, box2) > slack) continue;
+
+        if ((0 != node1.m_Count) && (0 != node2.m_Count))
+        {
+            const int count1= leafTriangles(bvh1, node1, pMatrix1, leaf1);
+            const int count2= leafTriangles(bvh2, node2, pMatrix2, leaf2);
+            for (int i= 0; i < count1; ++i)
+            {
+                for (int j= 0; j < count2; ++j)
+                {
+                    if (triangleOverlap(leaf1 + i * 3, leaf2 + j * 3) > tolerance)
+                    {
+                        TrianglePair pair;
+                        pair.m_Triangle1= node1.m_First + i;
+                        pair.m_Triangle2= node2.m_First + j;
+                        subject.append(pair);
+                        if ((maxPairCount > 0) && (subject.size() >= maxPairCount)) return subject;
+                    }
+                }
+            }
+        }
+        else if ((0 == node2.m_Count) && ((0 != node1.m_Count) || (boxSize(box2) > boxSize(box1))))
+        {
+            stack.append(qMakePair(nodes.first, node2.m_First));
+            stack.append(qMakePair(nodes.first, node2.m_First + 1));
+        }
+        else
+        {
+            stack.append(qMakePair(node1.m_First, nodes.second));
+            stack.append(qMakePair(node1.m_First + 1, nodes.second));
+        }
+    }
+
+    return subject;
+}
+
+double GLC_MeshBvh::distance(const GLC_MeshBvh& bvh1, const GLC_Matrix4x4& matrix1
+                             , const GLC_MeshBvh& bvh2, const GLC_Matrix4x4& matrix2
+                             , double maxDistance, GLC_Point3d* pPoint1, GLC_Point3d* pPoint2)
+{
+    double subject= maxDistance;
+    if (bvh1.isEmpty() || bvh2.isEmpty()) return subject;
+
+    const double* pMatrix1= matrix1.getData();
+    const double* pMatrix2= matrix2.getData();
+
+    GLC_Point3d leaf1[LeafSize * 3];
+    GLC_Point3d leaf2[LeafSize * 3];
+    QVector<QPair<int, int> > stack;
+    stack.append(qMakePair(0, 0));
+    while (!stack.isEmpty())
+    {
+        const QPair<int, int> nodes= stack.takeLast();
+        const Node& node1= bvh1.m_Nodes.at(nodes.first);
+        const Node& node2= bvh2.m_Nodes.at(nodes.second);
+        const WorldBox box1(worldBox(node1, pMatrix1));
+        const WorldBox box2(worldBox(node2, pMatrix2));
+        if (boxDistance(box1, box2) >= subject) continue;
+
+        if ((0 != node1.m_Count) && (0 != node2.m_Count))
+        {
+            const int count1= leafTriangles(bvh1, node1, pMatrix1, leaf1);
+            const int count2= leafTriangles(bvh2, node2, pMatrix2, leaf2);
+            for (int i= 0; i < count1; ++i)
+            {
+                for (int j= 0; j < count2; ++j)
+                {
+                    GLC_Point3d point1;
+                    GLC_Point3d point2;
+                    const double triangleDist= triangleDistance(leaf1 + i * 3, leaf2 + j * 3, &point1, &point2);
+                    if (triangleDist < subject)
+                    {
+                        subject= triangleDist;
+                        if (nullptr != pPoint1) *pPoint1= point1;
+                        if (nullptr != pPoint2) *pPoint2= point2;
+                        if (0.0 == subject) return subject;
+                    }
+                }
+            }
+        }
+        else
+        {
+            // The nearest child is visited first
+            int children[2][2];
+            if ((0 == node2.m_Count) && ((0 != node1.m_Count) || (boxSize(box2) > boxSize(box1))))
+            {
+                children[0][0]= nodes.first; children[0][1]= node2.m_First;
+                children[1][0]= nodes.first; children[1][1]= node2.m_First + 1;
+                const WorldBox first(worldBox(bvh2.m_Nodes.at(node2.m_First), pMatrix2));
+                const WorldBox second(worldBox(bvh2.m_Nodes.at(node2.m_First + 1), pMatrix2));
+                if (boxDistance(box1, first) < boxDistance(box1, second)) std::swap(children[0], children[1]);
+            }
+            else
+            {
+                children[0][0]= node1.m_First; children[0][1]= nodes.second;
+                children[1][0]= node1.m_First + 1; children[1][1]= nodes.second;
+                const WorldBox first(worldBox(bvh1.m_Nodes.at(node1.m_First), pMatrix1));
+                const WorldBox second(worldBox(bvh1.m_Nodes.at(node1.m_First + 1), pMatrix1));
+                if (boxDistance(box2, first) < boxDistance(box2, second)) std::swap(children[0], children[1]);
+            }
+            stack.append(qMakePair(children[0][0], children[0][1]));
+            stack.append(qMakePair(children[1][0], children[1][1]));
+        }
+    }
+
+    return subject;
+}
+
+double GLC_MeshBvh::triangleOverlap(const GLC_Point3d* pTriangle1, const GLC_Point3d* pTriangle2)
+{
+    const GLC_Vector3d edges1[3]= {pTriangle1[1] - pTriangle1[0], pTriangle1[2] - pTriangle1[1], pTriangle1[0] - pTriangle1[2]};
+    const GLC_Vector3d edges2[3]= {pTriangle2[1] - pTriangle2[0], pTriangle2[2] - pTriangle2[1], pTriangle2[0] - pTriangle2[2]};
+    const GLC_Vector3d normal1(edges1[0] ^ edges1[1]);
+    const GLC_Vector3d normal2(edges2[0] ^ edges2[1]);
+
+    double subject= std::numeric_limits<double>::max();
+    bool separated= false;
+    auto testAxis= [&](const GLC_Vector3d& axis, double factorLength)
+    {
+        // Axes from nearly parallel vectors are not reliable
+        const double length= axis.length();
+        if (length <= (factorLength * 1.0e-9)) return;
+
+        double min1= axis * pTriangle1[0];
+        double max1= min1;
+        double min2= axis * pTriangle2[0];
+        double max2= min2;
+        for (int k= 1; k < 3; ++k)
+        {
+            const double projection1= axis * pTriangle1[k];
+            min1= qMin(min1, projection1);
+            max1= qMax(max1, projection1);
+            const double projection2= axis * pTriangle2[k];
+            min2= qMin(min2, projection2);
+            max2= qMax(max2, projection2);
+        }
+        const double overlap= qMin(max1 - min2, max2 - min1) / length;
+        subject= qMin(subject, overlap);
+        separated= separated || (overlap < 0.0);
+    };
+
+    const double normalLength1= normal1.length();
+    const double normalLength2= normal2.length();
+    testAxis(normal1, edges1[0].length() * edges1[1].length());
+    testAxis(normal2, edges2[0].length() * edges2[1].length());
+    for (int i= 0; (i < 3) && !separated; ++i)
+    {
+        const double edgeLength1= edges1[i].length();
+        for (int j= 0; j < 3; ++j)
+        {
+            testAxis(edges1[i] ^ edges2[j], edgeLength1 * edges2[j].length());
+        }
+    }
+
+    // Coplanar triangles are separated by the normals of their edges in the plane
+    if (!separated && ((normal1 ^ normal2).length() <= (normalLength1 * normalLength2 * 1.0e-9)))
+    {
+        const GLC_Vector3d& normal= (normalLength1 >= normalLength2) ? normal1 : normal2;
+        const double normalLength= qMax(normalLength1, normalLength2);
+        for (int i= 0; i < 3; ++i)
+        {
+            testAxis(normal ^ edges1[i], normalLength * edges1[i].length());
+            testAxis(normal ^ edges2[i], normalLength * edges2[i].length());
+        }
+    }
+
+    if (std::numeric_limits<double>::max() == subject) subject= std::numeric_limits<double>::lowest();
+
+    return subject;
+}
+
+double GLC_MeshBvh::triangleDistance(const GLC_Point3d* pTriangle1, const GLC_Point3d* pTriangle2
+                                     , GLC_Point3d* pPoint1, GLC_Point3d* pPoint2)
+{
+    double subject= std::numeric_limits<double>::max();
+    GLC_Point3d point1;
+    GLC_Point3d point2;
+
+    // Edge against edge
+    for (int i= 0; i < 3; ++i)
+    {
+        for (int j= 0; j < 3; ++j)
+        {
+            const double edgeDistance= segmentDistance(pTriangle1[i], pTriangle1[(i + 1) % 3], pTriangle2[j], pTriangle2[(j + 1) % 3], &point1, &point2);
+            if (edgeDistance < subject)
+            {
+                subject= edgeDistance;
+                *pPoint1= point1;
+                *pPoint2= point2;
+            }
+        }
+    }
+
+    // Vertex against face
+    for (int i= 0; i < 3; ++i)
+    {
+        point2= closestPointOnTriangle(pTriangle1[i], pTriangle2[0], pTriangle2[1], pTriangle2[2]);
+        double vertexDistance= (pTriangle1[i] - point2).length();
+        if (vertexDistance < subject)
+        {
+            subject= vertexDistance;
+            *pPoint1= pTriangle1[i];
+            *pPoint2= point2;
+        }
+        point1= closestPointOnTriangle(pTriangle2[i], pTriangle1[0], pTriangle1[1], pTriangle1[2]);
+        vertexDistance= (pTriangle2[i] - point1).length();
+        if (vertexDistance < subject)
+        {
+            subject= vertexDistance;
+            *pPoint1= point1;
+            *pPoint2= pTriangle2[i];
+        }
+    }
+
+    // Crossing triangles don't have a closest feature pair at distance 0
+    if ((subject > 0.0) && (triangleOverlap(pTriangle1, pTriangle2) >= 0.0))
+    {
+        subject= 0.0;
+        *pPoint2= *pPoint1;
+    }
+
+    return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_MeshBvh::build(const GLfloatVector& positions, const QVector<GLuint>& triangles)
+{
+    // Vertices are welded so that adjacent triangles share their edges
+    const int vertexCount= positions.size() / 3;
+    QVector<GLuint> weldedIndex(vertexCount);
+    QHash<WeldKey, GLuint> weldHash;
+    weldHash.reserve(vertexCount);
+    for (int i= 0; i < vertexCount; ++i)
+    {
+        // -0.0 and 0.0 are the same position
+        WeldKey key;
+        key.m_Values[0]= positions.at(i * 3) + 0.0f;
+        key.m_Values[1]= positions.at(i * 3 + 1) + 0.0f;
+        key.m_Values[2]= positions.at(i * 3 + 2) + 0.0f;
+        QHash<WeldKey, GLuint>::const_iterator iKey= weldHash.constFind(key);
+        if (iKey == weldHash.constEnd())
+        {
+            const GLuint index= static_cast<GLuint>(m_Positions.size() / 3);
+            weldHash.insert(key, index);
+            m_Positions << key.m_Values[0] << key.m_Values[1] << key.m_Values[2];
+            weldedIndex[i]= index;
+        }
+        else
+        {
+            weldedIndex[i]= iKey.value();
+        }
+    }
+
+    QVector<GLuint> weldedTriangles;
+    weldedTriangles.reserve(triangles.size());
+    const int indexCount= triangles.size() - (triangles.size() % 3);
+    for (int i= 0; i < indexCount; i+= 3)
+    {
+        const GLuint i0= weldedIndex.at(triangles.at(i));
+        const GLuint i1= weldedIndex.at(triangles.at(i + 1));
+        const GLuint i2= weldedIndex.at(triangles.at(i + 2));
+        if ((i0 == i1) || (i1 == i2) || (i2 == i0)) continue;
+        weldedTriangles << i0 << i1 << i2;
+    }
+
+    const int triangleCount= weldedTriangles.size() / 3;
+    if (0 == triangleCount) return;
+
+    // Tree of the triangle boxes
+    const GLfloat* pPositions= m_Positions.constData();
+    QVector<float> boxes(triangleCount * 6);
+    for (int i= 0; i < triangleCount; ++i)
+    {
+        for (int axis= 0; axis < 3; ++axis)
+        {
+            float minValue= pPositions[weldedTriangles.at(i * 3) * 3 + axis];
+            float maxValue= minValue;
+            for (int k= 1; k < 3; ++k)
+            {
+                const float value= pPositions[weldedTriangles.at(i * 3 + k) * 3 + axis];
+                minValue= qMin(minValue, value);
+                maxValue= qMax(maxValue, value);
+            }
+            boxes[i * 6 + axis]= minValue;
+            boxes[i * 6 + 3 + axis]= maxValue;
+        }
+    }
+    QVector<int> order;
+    GLC_AabbTree::build(boxes, &m_Nodes, &order);
+
+    m_Triangles.resize(triangleCount * 3);
+    for (int i= 0; i < triangleCount; ++i)
+    {
+        const int triangle= order.at(i);
+        m_Triangles[i * 3]= weldedTriangles.at(triangle * 3);
+        m_Triangles[i * 3 + 1]= weldedTriangles.at(triangle * 3 + 1);
+        m_Triangles[i * 3 + 2]= weldedTriangles.at(triangle * 3 + 2);
+    }
+}
+
+int GLC_MeshBvh::rayCrossingCount(const GLC_Point3d& origin, const GLC_Vector3d& direction) const
+{
+    const double inverseDirection[3]= {1.0 / direction.x(), 1.0 / direction.y(), 1.0 / direction.z()};
+
+    int subject= 0;
+    QVector<int> stack;
+    stack.append(0);
+    while (!stack.isEmpty())
+    {
+        const Node& node= m_Nodes.at(stack.takeLast());
+        if (!rayHitsBox(node, origin.data(), inverseDirection)) continue;
+
+        if (0 != node.m_Count)
+        {
+            for (int i= 0; i < node.m_Count; ++i)
+            {
+                const int triangle= node.m_First + i;
+                if (rayCrossesTriangle(origin, direction, point(triangle, 0), point(triangle, 1), point(triangle, 2))) ++subject;
+            }
+        }
+        else
+        {
+            stack.append(node.m_First);
+            stack.append(node.m_First + 1);
+        }
+    }
+
+    return subject;
+}
@@ -0,0 +1,177 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_meshbvh.h interface for the GLC_MeshBvh class.
+
+#ifndef GLC_MESHBVH_H_
+#define GLC_MESHBVH_H_
+
+#include <QVector>
+
+#include "../maths/glc_vector3d.h"
+#include "../maths/glc_matrix4x4.h"
+#include "../glc_boundingbox.h"
+#include "../glc_global.h"
+#include "glc_aabbtree.h"
+
+#include "../glc_config.h"
+
+class GLC_Mesh;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_MeshBvh
+/*! \brief GLC_MeshBvh : Bounding volume hierarchy of the triangles of a mesh*/
+
+/*! The tree is built in the mesh coordinates from the triangles of the LOD 0 of all
+ *  the materials of the mesh. Vertices with the same position are welded, so triangles
+ *  which share an edge share its vertex indices.
+ *
+ *  The tree of the triangle boxes is built by GLC_AabbTree, leaves have at most
+ *  LeafSize triangles.
+ *
+ *  The pair queries work on two trees placed in the world by their matrices, the node boxes
+ *  and the triangles are transformed on the fly so the matrices may contain scaling.
+ *  contains() tests if a point is inside the surface of a closed mesh.
+ *
+ *  A tree is immutable once built and can be shared by threads.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_MeshBvh
+{
+public:
+    //! A node of the tree, the items of a leaf are triangles
+    typedef GLC_AabbTree::Node Node;
+
+    //! A pair of triangles of two trees
+    struct TrianglePair
+    {
+        int m_Triangle1;
+        int m_Triangle2;
+    };
+
+    //! Maximum number of triangles of a leaf
+    enum {LeafSize= GLC_AabbTree::LeafSize};
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Construct an empty tree
+    GLC_MeshBvh();
+
+    //! Construct the tree of the given mesh
+    explicit GLC_MeshBvh(const GLC_Mesh* pMesh);
+
+    //! Construct the tree of the given positions and triangle indices
+    GLC_MeshBvh(const GLfloatVector& positions, const QVector<GLuint>& triangles);
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return true if this tree has no triangle
+    inline bool isEmpty() const
+    {return m_Nodes.isEmpty();}
+
+    //! Return the number of triangles
+    inline int triangleCount() const
+    {return m_Triangles.size() / 3;}
+
+    //! Return the positions of the welded vertices
+    inline const GLfloatVector& positions() const
+    {return m_Positions;}
+
+    //! Return the welded vertex indices of the triangles, in tree order
+    inline const QVector<GLuint>& triangles() const
+    {return m_Triangles;}
+
+    //! Return the nodes of the tree, the first one is the root
+    inline const QVector<Node>& nodes() const
+    {return m_Nodes;}
+
+    //! Return the given corner of the given triangle in the mesh coordinates
+    inline GLC_Point3d point(int triangle, int corner) const
+    {
+        const GLfloat* pVertex= m_Positions.constData() + m_Triangles.at(triangle * 3 + corner) * 3;
+        return GLC_Point3d(pVertex[0], pVertex[1], pVertex[2]);
+    }
+
+    //! Return the bounding box of the tree in the mesh coordinates
+    GLC_BoundingBox boundingBox() const;
+
+    //! Return true if the given point, in the mesh coordinates, is inside the surface of the tree
+    /*! The parity of the triangles crossed by a ray cast from the point tells if it is inside,
+     *  three rays in different directions vote so a ray which grazes an edge doesn't change the result.
+     *  The result is only meaningful if the mesh is closed.*/
+    bool contains(const GLC_Point3d& point) const;
+
+    //! Return the triangle pairs of the given trees which overlap by more than the given tolerance
+    /*! The overlap of two triangles is their smallest overlap on the separating axes,
+     *  it is 0 when they touch and negative when they are apart. The search stops when
+     *  maxPairCount pairs are found if maxPairCount is positive.
+     *  The pairs are not sorted.*/
+    static QVector<TrianglePair> overlappingTriangles(const GLC_MeshBvh& bvh1, const GLC_Matrix4x4& matrix1
+                                                      , const GLC_MeshBvh& bvh2, const GLC_Matrix4x4& matrix2
+                                                      , double tolerance, int maxPairCount= -1);
+
+    //! Return the minimum distance between the given trees if it is less than the given maximum distance
+    /*! If the distance is less than maxDistance, the closest points in world coordinates are
+     *  stored in the given points, otherwise maxDistance is returned and the points are unchanged.*/
+    static double distance(const GLC_MeshBvh& bvh1, const GLC_Matrix4x4& matrix1
+                           , const GLC_MeshBvh& bvh2, const GLC_Matrix4x4& matrix2
+                           , double maxDistance, GLC_Point3d* pPoint1= nullptr, GLC_Point3d* pPoint2= nullptr);
+
+    //! Return the smallest overlap of the given triangles on their separating axes
+    static double triangleOverlap(const GLC_Point3d* pTriangle1, const GLC_Point3d* pTriangle2);
+
+    //! Return the distance between the given triangles and store their closest points
+    static double triangleDistance(const GLC_Point3d* pTriangle1, const GLC_Point3d* pTriangle2
+                                   , GLC_Point3d* pPoint1, GLC_Point3d* pPoint2);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Weld the given positions and build the tree of the given triangles
+    void build(const GLfloatVector& positions, const QVector<GLuint>& triangles);
+
+    //! Return the number of triangles crossed by the ray of the given origin and direction
+    int rayCrossingCount(const GLC_Point3d& origin, const GLC_Vector3d& direction) const;
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Positions of the welded vertices
+    GLfloatVector m_Positions;
+
+    //! Welded vertex indices of the triangles, in tree order
+    QVector<GLuint> m_Triangles;
+
+    //! The nodes of the tree
+    QVector<Node> m_Nodes;
+};
+
+#endif /* GLC_MESHBVH_H_ */
@@ -0,0 +1,590 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_pointcloudbuilder.cpp implementation of the GLC_PointCloudBuilder class.
+
+#include <cmath>
+
+#include <QDataStream>
+#include <QFileInfo>
+#include <QtEndian>
+#include <QtMath>
+
+#include "glc_pointcloudbuilder.h"
+
+namespace
+{
+    // Number of points buffered before being written to a temporary file
+    const int spillBufferSize= 65536;
+
+    // Number of points read at once from a temporary file
+    const int readBlockSize= 65536;
+}
+
+GLC_PointCloudBuilder::GLC_PointCloudBuilder(const QString& fileName)
+    : m_FileName(fileName)
+    , m_ChunkCapacity(0)
+    , m_GridResolution(0)
+    , m_MaximumInMemoryPointCount(4000000)
+    , m_pTemporaryDir()
+    , m_TemporaryFileCount(0)
+    , m_SpillFileName()
+    , m_SpillBuffer()
+    , m_PointCount(0)
+    , m_HasColors(false)
+    , m_CubeSize(0.0)
+    , m_UpperNodes()
+    , m_NodeTable()
+    , m_File()
+    , m_ErrorString()
+{
+    setChunkCapacity(32768);
+    for (int i= 0; i < 3; ++i)
+    {
+        m_Lower[i]= 0.0f;
+        m_Upper[i]= 0.0f;
+        m_CubeLower[i]= 0.0;
+    }
+}
+
+GLC_PointCloudBuilder::~GLC_PointCloudBuilder()
+{
+    qDeleteAll(m_UpperNodes);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+QString GLC_PointCloudBuilder::suffix()
+{
+    return QString("glcpc");
+}
+
+quint32 GLC_PointCloudBuilder::version()
+{
+    return 100;
+}
+
+QUuid GLC_PointCloudBuilder::magic()
+{
+    return QUuid("{5b0e6f3c-8d1a-4f57-9e2b-71c4a3d8f610}");
+}
+
+GLC_BoundingBox GLC_PointCloudBuilder::boundingBox() const
+{
+    GLC_BoundingBox subject;
+    if (m_PointCount > 0)
+    {
+        subject.combine(GLC_Point3d(m_Lower[0], m_Lower[1], m_Lower[2]));
+        subject.combine(GLC_Point3d(m_Upper[0], m_Upper[1], m_Upper[2]));
+    }
+    return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_PointCloudBuilder::setChunkCapacity(int capacity)
+{
+    m_ChunkCapacity= qMax(1, capacity);
+    m_GridResolution= qMax(1, static_cast<int>(std::floor(std::cbrt(static_cast<double>(m_ChunkCapacity)) + 1e-6)));
+    m_MaximumInMemoryPointCount= qMax(m_ChunkCapacity, m_MaximumInMemoryPointCount);
+}
+
+bool GLC_PointCloudBuilder::addPoints(const GLfloatVector& positions, const GLfloatVector& colors)
+{
+    const int count= positions.size() / 3;
+    const bool hasColors= !colors.isEmpty();
+    if (hasColors && (colors.size() != (count * 4)))
+    {
+        m_ErrorString= QString("GLC_PointCloudBuilder::addPoints Colors and positions count mismatch");
+        return false;
+    }
+
+    if (m_pTemporaryDir.isNull())
+    {
+        const QString pattern(QFileInfo(m_FileName).absolutePath() + QString("/glc_pointcloud_XXXXXX"));
+        m_pTemporaryDir.reset(new QTemporaryDir(pattern));
+        if (!m_pTemporaryDir->isValid())
+        {
+            m_ErrorString= QString("GLC_PointCloudBuilder::addPoints Unable to create temporary directory");
+            m_pTemporaryDir.reset();
+            return false;
+        }
+        m_SpillFileName= temporaryFileName();
+    }
+
+    m_HasColors= m_HasColors || hasColors;
+    for (int i= 0; i < count; ++i)
+    {
+        RawPoint point;
+        for (int j= 0; j < 3; ++j)
+        {
+            const float value= positions.at(i * 3 + j);
+            point.m_Position[j]= value;
+            if (m_PointCount == 0)
+            {
+                m_Lower[j]= value;
+                m_Upper[j]= value;
+            }
+            else
+            {
+                m_Lower[j]= qMin(m_Lower[j], value);
+                m_Upper[j]= qMax(m_Upper[j], value);
+            }
+        }
+        for (int j= 0; j < 4; ++j)
+        {
+            const float value= hasColors ? colors.at(i * 4 + j) : 1.0f;
+            point.m_Color[j]= static_cast<quint8>(qBound(0, qRound(value * 255.0f), 255));
+        }
+        m_SpillBuffer.append(point);
+        ++m_PointCount;
+
+        if ((m_SpillBuffer.size() >= spillBufferSize) && !flushSpillBuffer())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GLC_PointCloudBuilder::build()
+{
+    m_NodeTable.clear();
+    if (m_PointCount == 0)
+    {
+        m_ErrorString= QString("GLC_PointCloudBuilder::build No point to build");
+        return false;
+    }
+
+    bool subject= flushSpillBuffer();
+
+    // The root cube contains all points
+    m_CubeSize= 0.0;
+    for (int i= 0; i < 3; ++i)
+    {
+        m_CubeLower[i]= m_Lower[i];
+        m_CubeSize= qMax(m_CubeSize, static_cast<double>(m_Upper[i]) - static_cast<double>(m_Lower[i]));
+    }
+    if (m_CubeSize <= 0.0) m_CubeSize= 1.0;
+
+    m_File.setFileName(m_FileName);
+    if (subject && !m_File.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        m_ErrorString= QString("GLC_PointCloudBuilder::build Unable to open ") + m_FileName;
+        subject= false;
+    }
+
+    if (subject)
+    {
+        writeHeader(0);
+        Node root;
+        root.m_Level= 0;
+        root.m_X= 0;
+        root.m_Y= 0;
+        root.m_Z= 0;
+        subject= processFile(root, m_SpillFileName, m_PointCount);
+    }
+
+    // The upper nodes are written last, empty ones are needed to reach their children
+    if (subject)
+    {
+        QHash<quint64, UpperNode*>::const_iterator iNode= m_UpperNodes.constBegin();
+        while (subject && (iNode != m_UpperNodes.constEnd()))
+        {
+            subject= writeChunk(iNode.value()->m_Node, iNode.value()->m_Points);
+            ++iNode;
+        }
+    }
+
+    if (subject)
+    {
+        const qint64 tableOffset= m_File.pos();
+        QDataStream stream(&m_File);
+        stream.setVersion(QDataStream::Qt_4_6);
+        stream.setByteOrder(QDataStream::LittleEndian);
+        const int nodeCount= m_NodeTable.size();
+        for (int i= 0; i < nodeCount; ++i)
+        {
+            const NodeRecord& record= m_NodeTable.at(i);
+            stream << static_cast<quint8>(record.m_Node.m_Level);
+            stream << record.m_Node.m_X << record.m_Node.m_Y << record.m_Node.m_Z;
+            stream << record.m_PointCount << record.m_Offset;
+        }
+        writeHeader(tableOffset);
+        subject= (stream.status() == QDataStream::Ok) && (m_File.error() == QFileDevice::NoError);
+        if (!subject) m_ErrorString= QString("GLC_PointCloudBuilder::build Unable to write ") + m_FileName;
+    }
+
+    if (m_File.isOpen()) m_File.close();
+    if (!subject && m_File.exists()) m_File.remove();
+
+    // Remove the added points
+    qDeleteAll(m_UpperNodes);
+    m_UpperNodes.clear();
+    m_SpillBuffer.clear();
+    m_pTemporaryDir.reset();
+    m_SpillFileName.clear();
+    m_PointCount= 0;
+    m_HasColors= false;
+
+    return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+quint64 GLC_PointCloudBuilder::nodeKey(const Node& node)
+{
+    return (static_cast<quint64>(node.m_Level) << 57) | (static_cast<quint64>(node.m_X) << 38)
+            | (static_cast<quint64>(node.m_Y) << 19) | static_cast<quint64>(node.m_Z);
+}
+
+GLC_PointCloudBuilder::Node GLC_PointCloudBuilder::childNode(const Node& node, int octant)
+{
+    Node subject;
+    subject.m_Level= node.m_Level + 1;
+    subject.m_X= node.m_X * 2 + (octant & 1);
+    subject.m_Y= node.m_Y * 2 + ((octant >> 1) & 1);
+    subject.m_Z= node.m_Z * 2 + ((octant >> 2) & 1);
+    return subject;
+}
+
+GLC_PointCloudBuilder::Node GLC_PointCloudBuilder::ancestorNode(const Node& node, int level)
+{
+    const int shift= node.m_Level - level;
+    Node subject;
+    subject.m_Level= level;
+    subject.m_X= node.m_X >> shift;
+    subject.m_Y= node.m_Y >> shift;
+    subject.m_Z= node.m_Z >> shift;
+    return subject;
+}
+
+int GLC_PointCloudBuilder::octantOf(const Node& node, const RawPoint& point) const
+{
+    const double nodeSize= m_CubeSize / static_cast<double>(1 << node.m_Level);
+    const quint32 coordinates[3]= {node.m_X, node.m_Y, node.m_Z};
+    int subject= 0;
+    for (int i= 0; i < 3; ++i)
+    {
+        const double center= m_CubeLower[i] + (static_cast<double>(coordinates[i]) + 0.5) * nodeSize;
+        if (point.m_Position[i] >= center) subject|= (1 << i);
+    }
+    return subject;
+}
+
+int GLC_PointCloudBuilder::cellOf(const Node& node, const RawPoint& point) const
+{
+    const double nodeSize= m_CubeSize / static_cast<double>(1 << node.m_Level);
+    const quint32 coordinates[3]= {node.m_X, node.m_Y, node.m_Z};
+    int cell[3];
+    for (int i= 0; i < 3; ++i)
+    {
+        const double lower= m_CubeLower[i] + static_cast<double>(coordinates[i]) * nodeSize;
+        const double local= (point.m_Position[i] - lower) / nodeSize * m_GridResolution;
+        cell[i]= qBound(0, static_cast<int>(local), m_GridResolution - 1);
+    }
+    return (cell[2] * m_GridResolution + cell[1]) * m_GridResolution + cell[0];
+}
+
+GLC_PointCloudBuilder::UpperNode* GLC_PointCloudBuilder::upperNode(const Node& node)
+{
+    const quint64 key= nodeKey(node);
+    UpperNode* pSubject= m_UpperNodes.value(key, nullptr);
+    if (nullptr == pSubject)
+    {
+        pSubject= new UpperNode;
+        pSubject->m_Node= node;
+        pSubject->m_Cells.resize(m_GridResolution * m_GridResolution * m_GridResolution);
+        m_UpperNodes.insert(key, pSubject);
+    }
+    return pSubject;
+}
+
+QVector<GLC_PointCloudBuilder::UpperNode*> GLC_PointCloudBuilder::upperNodesOf(const Node& node)
+{
+    QVector<UpperNode*> subject;
+    for (int level= 0; level < node.m_Level; ++level)
+    {
+        subject.append(upperNode(ancestorNode(node, level)));
+    }
+    return subject;
+}
+
+bool GLC_PointCloudBuilder::addToUpperNodes(const QVector<UpperNode*>& upperNodes, const RawPoint& point) const
+{
+    const int count= upperNodes.size();
+    for (int i= 0; i < count; ++i)
+    {
+        UpperNode* pNode= upperNodes.at(i);
+        const int cell= cellOf(pNode->m_Node, point);
+        if (!pNode->m_Cells.testBit(cell))
+        {
+            pNode->m_Cells.setBit(cell);
+            pNode->m_Points.append(point);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GLC_PointCloudBuilder::appendToFile(const QString& fileName, const QVector<RawPoint>& points)
+{
+    QFile file(fileName);
+    const qint64 size= static_cast<qint64>(points.size()) * sizeof(RawPoint);
+    bool subject= file.open(QIODevice::WriteOnly | QIODevice::Append);
+    subject= subject && (file.write(reinterpret_cast<const char*>(points.constData()), size) == size);
+    if (!subject)
+    {
+        m_ErrorString= QString("GLC_PointCloudBuilder Unable to write temporary file ") + fileName;
+    }
+    return subject;
+}
+
+bool GLC_PointCloudBuilder::processFile(const Node& node, const QString& fileName, qint64 count)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        m_ErrorString= QString("GLC_PointCloudBuilder Unable to read temporary file ") + fileName;
+        return false;
+    }
+
+    QVector<UpperNode*> upperNodes(upperNodesOf(node));
+    const bool inMemory= (count <= m_MaximumInMemoryPointCount) || (node.m_Level >= MaximumLevel);
+    if (!inMemory)
+    {
+        // The node is split on disk and becomes an upper node
+        upperNodes.append(upperNode(node));
+    }
+
+    QVector<RawPoint> points;
+    QVector<RawPoint> octantPoints[8];
+    QString octantFileNames[8];
+    qint64 octantCounts[8]= {0, 0, 0, 0, 0, 0, 0, 0};
+
+    bool subject= true;
+    QVector<RawPoint> block(readBlockSize);
+    qint64 remaining= count;
+    while (subject && (remaining > 0))
+    {
+        const int blockCount= static_cast<int>(qMin(remaining, static_cast<qint64>(readBlockSize)));
+        const qint64 size= static_cast<qint64>(blockCount) * sizeof(RawPoint);
+        subject= (file.read(reinterpret_cast<char*>(block.data()), size) == size);
+        remaining-= blockCount;
+
+        for (int i= 0; subject && (i < blockCount); ++i)
+        {
+            const RawPoint& point= block.at(i);
+            if (addToUpperNodes(upperNodes, point)) continue;
+
+            if (inMemory)
+            {
+                points.append(point);
+            }
+            else
+            {
+                const int octant= octantOf(node, point);
+                octantPoints[octant].append(point);
+                if (octantPoints[octant].size() >= spillBufferSize)
+                {
+                    if (octantFileNames[octant].isEmpty()) octantFileNames[octant]= temporaryFileName();
+                    subject= appendToFile(octantFileNames[octant], octantPoints[octant]);
+                    octantCounts[octant]+= octantPoints[octant].size();
+                    octantPoints[octant].clear();
+                }
+            }
+        }
+    }
+    if (!subject && m_ErrorString.isEmpty())
+    {
+        m_ErrorString= QString("GLC_PointCloudBuilder Unable to read temporary file ") + fileName;
+    }
+    file.close();
+    file.remove();
+    block.clear();
+
+    if (subject && inMemory)
+    {
+        subject= buildSubTree(node, points);
+    }
+    else if (subject)
+    {
+        for (int octant= 0; subject && (octant < 8); ++octant)
+        {
+            if (!octantPoints[octant].isEmpty())
+            {
+                if (octantFileNames[octant].isEmpty()) octantFileNames[octant]= temporaryFileName();
+                subject= appendToFile(octantFileNames[octant], octantPoints[octant]);
+                octantCounts[octant]+= octantPoints[octant].size();
+                octantPoints[octant].clear();
+            }
+        }
+        for (int octant= 0; subject && (octant < 8); ++octant)
+        {
+            if (octantCounts[octant] > 0)
+            {
+                subject= processFile(childNode(node, octant), octantFileNames[octant], octantCounts[octant]);
+            }
+        }
+    }
+
+    return subject;
+}
+
+bool GLC_PointCloudBuilder::buildSubTree(const Node& node, QVector<RawPoint>& points)
+{
+    if ((points.size() <= m_ChunkCapacity) || (node.m_Level >= MaximumLevel))
+    {
+        return writeChunk(node, points);
+    }
+
+    // Keep one point by grid cell, the others go to the children
+    QBitArray cells(m_GridResolution * m_GridResolution * m_GridResolution);
+    QVector<RawPoint> kept;
+    QVector<RawPoint> octantPoints[8];
+    const int count= points.size();
+    for (int i= 0; i < count; ++i)
+    {
+        const RawPoint& point= points.at(i);
+        const int cell= cellOf(node, point);
+        if (!cells.testBit(cell))
+        {
+            cells.setBit(cell);
+            kept.append(point);
+        }
+        else
+        {
+            octantPoints[octantOf(node, point)].append(point);
+        }
+    }
+    points.clear();
+    points.squeeze();
+
+    bool subject= writeChunk(node, kept);
+    for (int octant= 0; subject && (octant < 8); ++octant)
+    {
+        if (!octantPoints[octant].isEmpty())
+        {
+            subject= buildSubTree(childNode(node, octant), octantPoints[octant]);
+        }
+    }
+    return subject;
+}
+
+bool GLC_PointCloudBuilder::writeChunk(const Node& node, const QVector<RawPoint>& points)
+{
+    NodeRecord record;
+    record.m_Node= node;
+    record.m_PointCount= static_cast<quint32>(points.size());
+    record.m_Offset= m_File.pos();
+
+    const int count= points.size();
+    const double nodeSize= m_CubeSize / static_cast<double>(1 << node.m_Level);
+    const double halfSize= nodeSize * 0.5;
+    const quint32 coordinates[3]= {node.m_X, node.m_Y, node.m_Z};
+    double center[3];
+    for (int i= 0; i < 3; ++i)
+    {
+        center[i]= m_CubeLower[i] + (static_cast<double>(coordinates[i]) + 0.5) * nodeSize;
+    }
+
+    QByteArray positions(count * 3 * static_cast<int>(sizeof(qint16)), Qt::Uninitialized);
+    uchar* pPosition= reinterpret_cast<uchar*>(positions.data());
+    for (int i= 0; i < count; ++i)
+    {
+        const RawPoint& point= points.at(i);
+        for (int j= 0; j < 3; ++j)
+        {
+            const double normalized= (point.m_Position[j] - center[j]) / halfSize;
+            const int value= qBound(-static_cast<int>(QuantizationRange), qRound(normalized * QuantizationRange), static_cast<int>(QuantizationRange));
+            qToLittleEndian<qint16>(static_cast<qint16>(value), pPosition);
+            pPosition+= sizeof(qint16);
+        }
+    }
+    bool subject= (m_File.write(positions) == positions.size());
+
+    if (subject && m_HasColors)
+    {
+        QByteArray colors(count * 4, Qt::Uninitialized);
+        for (int i= 0; i < count; ++i)
+        {
+            for (int j= 0; j < 4; ++j)
+            {
+                colors[i * 4 + j]= static_cast<char>(points.at(i).m_Color[j]);
+            }
+        }
+        subject= (m_File.write(colors) == colors.size());
+    }
+
+    if (subject)
+    {
+        m_NodeTable.append(record);
+    }
+    else
+    {
+        m_ErrorString= QString("GLC_PointCloudBuilder Unable to write ") + m_FileName;
+    }
+    return subject;
+}
+
+void GLC_PointCloudBuilder::writeHeader(qint64 tableOffset)
+{
+    const qint64 position= m_File.pos();
+    m_File.seek(0);
+
+    QDataStream stream(&m_File);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << magic() << version();
+    for (int i= 0; i < 3; ++i) stream << static_cast<double>(m_Lower[i]);
+    for (int i= 0; i < 3; ++i) stream << static_cast<double>(m_Upper[i]);
+    for (int i= 0; i < 3; ++i) stream << m_CubeLower[i];
+    stream << m_CubeSize;
+    stream << static_cast<qint32>(m_GridResolution);
+    stream << m_HasColors;
+    stream << m_PointCount;
+    stream << static_cast<quint32>(m_NodeTable.size());
+    stream << tableOffset;
+
+    if (position > m_File.pos()) m_File.seek(position);
+}
+
+QString GLC_PointCloudBuilder::temporaryFileName()
+{
+    return m_pTemporaryDir->filePath(QString("points_%1.tmp").arg(m_TemporaryFileCount++));
+}
+
+bool GLC_PointCloudBuilder::flushSpillBuffer()
+{
+    bool subject= true;
+    if (!m_SpillBuffer.isEmpty())
+    {
+        subject= appendToFile(m_SpillFileName, m_SpillBuffer);
+        m_SpillBuffer.clear();
+    }
+    return subject;
+}
@@ -0,0 +1,291 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_pointcloudbuilder.h interface for the GLC_PointCloudBuilder class.
+
+#ifndef GLC_POINTCLOUDBUILDER_H_
+#define GLC_POINTCLOUDBUILDER_H_
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QFile>
+#include <QUuid>
+#include <QBitArray>
+#include <QScopedPointer>
+#include <QTemporaryDir>
+
+#include "../glc_global.h"
+#include "../glc_boundingbox.h"
+
+#include "../glc_config.h"
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_PointCloudBuilder
+/*! \brief GLC_PointCloudBuilder : Build a chunked point cloud file for GLC_StreamedPointCloud*/
+
+/*! Points are added with addPoints() and spilled to a temporary file, then build()
+ *  partitions them in an octree written to the output file :
+ *  - Each node keeps a subsample of its points, one point by cell of a regular grid of
+ *    gridResolution()^3 cells, the other points go to its children.
+ *    A node without more points than the chunk capacity is a leaf and keeps all its points.
+ *  - Positions are quantized on 16 bits relative to the cube of the node and colors are stored on 8 bits.
+ *  - Points of a node are stored in one chunk, a node table at the end of the file gives
+ *    the position of the chunks.
+ *
+ *  Points which don't fit in memory (maximumInMemoryPointCount()) are split on disk
+ *  in octants until the octants fit, so the size of the point cloud is only limited by disk space.
+ *
+ *  The file starts with a header written by a little endian QDataStream :
+ *  magic uuid, version, tight bounding box, cube lower corner and size, grid resolution,
+ *  colors flag, point count, node count and node table offset.
+ *  A node of the table is : level (quint8), x, y, z (quint32), point count (quint32), chunk offset (qint64).
+ *  A chunk is point count * 3 little endian qint16 positions followed, if the file has colors,
+ *  by point count * 4 quint8 RGBA colors.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_PointCloudBuilder
+{
+public:
+    //! Maximum depth of the octree
+    enum {MaximumLevel= 18};
+
+    //! Quantization range of positions
+    enum {QuantizationRange= 32767};
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Construct a builder of the given point cloud file
+    explicit GLC_PointCloudBuilder(const QString& fileName);
+
+    ~GLC_PointCloudBuilder();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the point cloud file suffix
+    static QString suffix();
+
+    //! Return the point cloud file version
+    static quint32 version();
+
+    //! Return the point cloud file magic uuid
+    static QUuid magic();
+
+    //! Return the output file name
+    inline QString fileName() const
+    {return m_FileName;}
+
+    //! Return the maximum number of points of a chunk
+    inline int chunkCapacity() const
+    {return m_ChunkCapacity;}
+
+    //! Return the resolution of the subsampling grid of a node
+    inline int gridResolution() const
+    {return m_GridResolution;}
+
+    //! Return the maximum number of points processed in memory
+    inline int maximumInMemoryPointCount() const
+    {return m_MaximumInMemoryPointCount;}
+
+    //! Return the number of added points
+    inline qint64 pointCount() const
+    {return m_PointCount;}
+
+    //! Return the number of written nodes of the last build
+    inline int nodeCount() const
+    {return m_NodeTable.size();}
+
+    //! Return the bounding box of the added points
+    GLC_BoundingBox boundingBox() const;
+
+    //! Return the last error message
+    inline QString errorString() const
+    {return m_ErrorString;}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Set the maximum number of points of a chunk
+    /*! The grid resolution is set to the cube root of the capacity*/
+    void setChunkCapacity(int capacity);
+
+    //! Set the maximum number of points processed in memory
+    inline void setMaximumInMemoryPointCount(int count)
+    {m_MaximumInMemoryPointCount= qMax(m_ChunkCapacity, count);}
+
+    //! Add the given points to the point cloud
+    /*! positions contains 3 floats by point and colors is empty or contains 4 floats RGBA by point
+     *  Return false if the points cannot be spilled to disk*/
+    bool addPoints(const GLfloatVector& positions, const GLfloatVector& colors= GLfloatVector());
+
+    //! Build the point cloud file from the added points and return true on success
+    /*! The added points are removed*/
+    bool build();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! A point as spilled to temporary files
+    struct RawPoint
+    {
+        float m_Position[3];
+        quint8 m_Color[4];
+    };
+
+    //! A node of the octree
+    struct Node
+    {
+        int m_Level;
+        quint32 m_X;
+        quint32 m_Y;
+        quint32 m_Z;
+    };
+
+    //! A node above the nodes built in memory
+    struct UpperNode
+    {
+        Node m_Node;
+        QBitArray m_Cells;
+        QVector<RawPoint> m_Points;
+    };
+
+    //! A node of the written node table
+    struct NodeRecord
+    {
+        Node m_Node;
+        quint32 m_PointCount;
+        qint64 m_Offset;
+    };
+
+    //! Return the key of the given node
+    static quint64 nodeKey(const Node& node);
+
+    //! Return the child of the given node in the given octant
+    static Node childNode(const Node& node, int octant);
+
+    //! Return the parent of the given node at the given level
+    static Node ancestorNode(const Node& node, int level);
+
+    //! Return the octant of the given node child containing the given point
+    int octantOf(const Node& node, const RawPoint& point) const;
+
+    //! Return the index of the subsampling grid cell of the given node containing the given point
+    int cellOf(const Node& node, const RawPoint& point) const;
+
+    //! Return the upper node of the given node, create it if needed
+    UpperNode* upperNode(const Node& node);
+
+    //! Return the upper nodes from the root to the given node excluded
+    QVector<UpperNode*> upperNodesOf(const Node& node);
+
+    //! Try to add the given point to the given upper nodes, return true if the point has been taken
+    bool addToUpperNodes(const QVector<UpperNode*>& upperNodes, const RawPoint& point) const;
+
+    //! Append the given points to the given file
+    bool appendToFile(const QString& fileName, const QVector<RawPoint>& points);
+
+    //! Process the points of the given node stored in the given file
+    bool processFile(const Node& node, const QString& fileName, qint64 count);
+
+    //! Build in memory the subtree of the given node from the given points
+    bool buildSubTree(const Node& node, QVector<RawPoint>& points);
+
+    //! Write the chunk of the given node with the given points
+    bool writeChunk(const Node& node, const QVector<RawPoint>& points);
+
+    //! Write the header of the output file
+    void writeHeader(qint64 tableOffset);
+
+    //! Return the name of a new temporary file
+    QString temporaryFileName();
+
+    //! Flush the spill buffer to the spill file
+    bool flushSpillBuffer();
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The output file name
+    QString m_FileName;
+
+    //! The maximum number of points of a chunk
+    int m_ChunkCapacity;
+
+    //! The subsampling grid resolution
+    int m_GridResolution;
+
+    //! The maximum number of points processed in memory
+    int m_MaximumInMemoryPointCount;
+
+    //! Directory of temporary files
+    QScopedPointer<QTemporaryDir> m_pTemporaryDir;
+
+    //! Temporary file counter
+    int m_TemporaryFileCount;
+
+    //! The file of added points and its buffer
+    QString m_SpillFileName;
+    QVector<RawPoint> m_SpillBuffer;
+
+    //! The number of added points
+    qint64 m_PointCount;
+
+    //! True if colors have been added
+    bool m_HasColors;
+
+    //! The tight bounds of added points
+    float m_Lower[3];
+    float m_Upper[3];
+
+    //! The cube of the octree root
+    double m_CubeLower[3];
+    double m_CubeSize;
+
+    //! The upper nodes hash table
+    QHash<quint64, UpperNode*> m_UpperNodes;
+
+    //! The written node table
+    QVector<NodeRecord> m_NodeTable;
+
+    //! The output file
+    QFile m_File;
+
+    //! The last error message
+    QString m_ErrorString;
+
+    Q_DISABLE_COPY(GLC_PointCloudBuilder)
+};
+
+#endif /* GLC_POINTCLOUDBUILDER_H_ */
@@ -172,10 +172,14 @@ void GLC_PointSprite::render(const GLC_RenderProperties& renderProperties)
     glTexEnvf(GL_POINT_SPRITE, GL_COORD_REPLACE, GL_TRUE);
 
     glEnable(GL_POINT_SPRITE);
+    GLC_Context::current()->glcUpdateMatrixUniforms();
     glDraw(renderProperties);
 
     glPopAttrib();
 
+    // glPopAttrib restores the state without the render state cache
+    GLC_Context::current()->renderStateCache()->invalidate();
+
 }
 // Point sprite set up
 void GLC_PointSprite::glDraw(const GLC_RenderProperties& renderProperties)
@@ -0,0 +1,547 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_streamedpointcloud.cpp implementation of the GLC_StreamedPointCloud class.
+
+#include <algorithm>
+
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include "glc_streamedpointcloud.h"
+#include "glc_pointcloudbuilder.h"
+#include "../viewport/glc_frustum.h"
+#include "../glc_fileformatexception.h"
+#include "../glc_state.h"
+#include "../glc_context.h"
+#include "../glc_renderstatecache.h"
+
+namespace
+{
+    // Return the key of the node at the given level and coordinates
+    quint64 nodeKey(int level, quint32 x, quint32 y, quint32 z)
+    {
+        return (static_cast<quint64>(level) << 57) | (static_cast<quint64>(x) << 38)
+                | (static_cast<quint64>(y) << 19) | static_cast<quint64>(z);
+    }
+
+    // A node record of the node table
+    struct NodeRecord
+    {
+        quint8 m_Level;
+        quint32 m_X;
+        quint32 m_Y;
+        quint32 m_Z;
+        quint32 m_PointCount;
+        qint64 m_Offset;
+    };
+
+    // A node to visit with its priority
+    typedef QPair<double, int> Candidate;
+}
+
+GLC_StreamedPointCloud::Chunk::Chunk()
+    : m_Positions()
+    , m_Colors()
+    , m_IsValid(false)
+{
+
+}
+
+GLC_StreamedPointCloud::Node::Node()
+    : m_Center()
+    , m_HalfSize(0.0)
+    , m_PointCount(0)
+    , m_Offset(0)
+    , m_State(Unloaded)
+    , m_Future()
+    , m_Positions()
+    , m_Colors()
+    , m_Buffer(QOpenGLBuffer::VertexBuffer)
+    , m_LastUsedFrame(0)
+{
+    for (int i= 0; i < 8; ++i)
+    {
+        m_Children[i]= -1;
+    }
+}
+
+GLC_StreamedPointCloud::GLC_StreamedPointCloud(const QString& fileName)
+    : GLC_Geometry("Point Cloud", true)
+    , m_FileName(fileName)
+    , m_Nodes()
+    , m_PointCount(0)
+    , m_GridResolution(1)
+    , m_HasColors(false)
+    , m_Bounds()
+    , m_PointBudget(5000000)
+    , m_MaximumResidentPointCount(10000000)
+    , m_TargetPixelSpacing(2.0)
+    , m_MaximumPendingLoad(4)
+    , m_LoadingNodes()
+    , m_SelectedNodes()
+    , m_FrameIndex(0)
+    , m_RenderedPointCount(0)
+    , m_ResidentPointCount(0)
+{
+    readFile();
+}
+
+GLC_StreamedPointCloud::GLC_StreamedPointCloud(const GLC_StreamedPointCloud& other)
+    : GLC_Geometry(other)
+    , m_FileName(other.m_FileName)
+    , m_Nodes()
+    , m_PointCount(other.m_PointCount)
+    , m_GridResolution(other.m_GridResolution)
+    , m_HasColors(other.m_HasColors)
+    , m_Bounds(other.m_Bounds)
+    , m_PointBudget(other.m_PointBudget)
+    , m_MaximumResidentPointCount(other.m_MaximumResidentPointCount)
+    , m_TargetPixelSpacing(other.m_TargetPixelSpacing)
+    , m_MaximumPendingLoad(other.m_MaximumPendingLoad)
+    , m_LoadingNodes()
+    , m_SelectedNodes()
+    , m_FrameIndex(0)
+    , m_RenderedPointCount(0)
+    , m_ResidentPointCount(0)
+{
+    // Only the node table is copied
+    const int count= other.m_Nodes.size();
+    m_Nodes.resize(count);
+    for (int i= 0; i < count; ++i)
+    {
+        const Node& otherNode= other.m_Nodes.at(i);
+        Node& node= m_Nodes[i];
+        node.m_Center= otherNode.m_Center;
+        node.m_HalfSize= otherNode.m_HalfSize;
+        node.m_PointCount= otherNode.m_PointCount;
+        node.m_Offset= otherNode.m_Offset;
+        for (int j= 0; j < 8; ++j)
+        {
+            node.m_Children[j]= otherNode.m_Children[j];
+        }
+    }
+}
+
+GLC_StreamedPointCloud::~GLC_StreamedPointCloud()
+{
+    // Pending loading don't use this point cloud, their result is discarded
+    releaseNodes();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+const GLC_BoundingBox& GLC_StreamedPointCloud::boundingBox()
+{
+    if (nullptr == GLC_Geometry::m_pBoundingBox)
+    {
+        GLC_Geometry::m_pBoundingBox= new GLC_BoundingBox(m_Bounds);
+    }
+    return *GLC_Geometry::m_pBoundingBox;
+}
+
+GLC_Geometry* GLC_StreamedPointCloud::clone() const
+{
+    return new GLC_StreamedPointCloud(*this);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_StreamedPointCloud::releaseNodes()
+{
+    const int count= m_Nodes.size();
+    for (int i= 0; i < count; ++i)
+    {
+        releaseNode(&m_Nodes[i]);
+    }
+    m_LoadingNodes.clear();
+    m_SelectedNodes.clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+// OpenGL Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_StreamedPointCloud::glDraw(const GLC_RenderProperties& renderProperties)
+{
+    m_RenderedPointCount= 0;
+    if (m_Nodes.isEmpty()) return;
+
+    ++m_FrameIndex;
+    pollLoads();
+
+    GLC_Context* pContext= GLC_Context::current();
+    const GLC_Matrix4x4 modelView(pContext->modelViewMatrix());
+    const GLC_Matrix4x4 projection(pContext->projectionMatrix());
+
+    // The frustum in the point cloud coordinates
+    GLC_Frustum frustum;
+    frustum.update(projection * modelView);
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    selectNodes(frustum, modelView, projection, viewport[3]);
+
+    const bool useColors= m_HasColors && !GLC_State::isInSelectionMode() && !renderProperties.isSelected();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    if (useColors) glEnableClientState(GL_COLOR_ARRAY);
+
+    const int count= m_SelectedNodes.size();
+    for (int i= 0; i < count; ++i)
+    {
+        Node* pNode= &m_Nodes[m_SelectedNodes.at(i)];
+        drawNode(pNode, useColors);
+        m_RenderedPointCount+= pNode->m_PointCount;
+    }
+
+    if (useColors)
+    {
+        glDisableClientState(GL_COLOR_ARRAY);
+        // Vertex colors have overwritten the current material
+        GLC_RenderStateCache::current()->invalidateMaterial();
+    }
+    glDisableClientState(GL_VERTEX_ARRAY);
+    pContext->glcUpdateMatrixUniforms();
+
+    evictNodes();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_StreamedPointCloud::readFile()
+{
+    QFile file(m_FileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        QString message(QString("GLC_StreamedPointCloud::readFile Enable to open the file ") + m_FileName);
+        GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotFound);
+        throw(fileFormatException);
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    QUuid magic;
+    quint32 version;
+    stream >> magic >> version;
+
+    double lower[3];
+    double upper[3];
+    double cubeLower[3];
+    double cubeSize;
+    qint32 gridResolution;
+    quint32 nodeCount;
+    qint64 tableOffset;
+    for (int i= 0; i < 3; ++i) stream >> lower[i];
+    for (int i= 0; i < 3; ++i) stream >> upper[i];
+    for (int i= 0; i < 3; ++i) stream >> cubeLower[i];
+    stream >> cubeSize >> gridResolution >> m_HasColors >> m_PointCount >> nodeCount >> tableOffset;
+
+    bool headerOk= (magic == GLC_PointCloudBuilder::magic()) && (version <= GLC_PointCloudBuilder::version());
+    headerOk= headerOk && (stream.status() == QDataStream::Ok) && (nodeCount > 0) && (tableOffset > 0);
+    headerOk= headerOk && file.seek(tableOffset);
+
+    QVector<NodeRecord> records;
+    int rootIndex= -1;
+    if (headerOk)
+    {
+        records.resize(static_cast<int>(nodeCount));
+        for (int i= 0; i < records.size(); ++i)
+        {
+            NodeRecord& record= records[i];
+            stream >> record.m_Level >> record.m_X >> record.m_Y >> record.m_Z >> record.m_PointCount >> record.m_Offset;
+            if (record.m_Level == 0) rootIndex= i;
+        }
+        headerOk= (stream.status() == QDataStream::Ok) && (rootIndex != -1);
+    }
+
+    if (!headerOk)
+    {
+        QString message(QString("GLC_StreamedPointCloud::readFile Wrong file format ") + m_FileName);
+        GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
+        throw(fileFormatException);
+    }
+
+    m_GridResolution= qMax(1, static_cast<int>(gridResolution));
+    m_Bounds= GLC_BoundingBox(GLC_Point3d(lower[0], lower[1], lower[2]), GLC_Point3d(upper[0], upper[1], upper[2]));
+
+    // The root is the first node
+    qSwap(records[0], records[rootIndex]);
+
+    const int count= records.size();
+    m_Nodes.resize(count);
+    QHash<quint64, int> nodeIndexHash;
+    for (int i= 0; i < count; ++i)
+    {
+        const NodeRecord& record= records.at(i);
+        Node& node= m_Nodes[i];
+        const double nodeSize= cubeSize / static_cast<double>(1 << record.m_Level);
+        node.m_HalfSize= nodeSize * 0.5;
+        node.m_Center.setVect(cubeLower[0] + (static_cast<double>(record.m_X) + 0.5) * nodeSize,
+                              cubeLower[1] + (static_cast<double>(record.m_Y) + 0.5) * nodeSize,
+                              cubeLower[2] + (static_cast<double>(record.m_Z) + 0.5) * nodeSize);
+        node.m_PointCount= record.m_PointCount;
+        node.m_Offset= record.m_Offset;
+        nodeIndexHash.insert(nodeKey(record.m_Level, record.m_X, record.m_Y, record.m_Z), i);
+    }
+
+    for (int i= 1; i < count; ++i)
+    {
+        const NodeRecord& record= records.at(i);
+        const int parentIndex= nodeIndexHash.value(nodeKey(record.m_Level - 1, record.m_X >> 1, record.m_Y >> 1, record.m_Z >> 1), -1);
+        if (parentIndex != -1)
+        {
+            const int octant= (record.m_X & 1) | ((record.m_Y & 1) << 1) | ((record.m_Z & 1) << 2);
+            m_Nodes[parentIndex].m_Children[octant]= i;
+        }
+    }
+}
+
+GLC_StreamedPointCloud::Chunk GLC_StreamedPointCloud::readChunk(const QString& fileName, qint64 offset, quint32 pointCount, bool hasColors)
+{
+    Chunk subject;
+    QFile file(fileName);
+    if (file.open(QIODevice::ReadOnly) && file.seek(offset))
+    {
+        const int positionSize= static_cast<int>(pointCount) * 3 * static_cast<int>(sizeof(qint16));
+        subject.m_Positions= file.read(positionSize);
+        subject.m_IsValid= (subject.m_Positions.size() == positionSize);
+        if (subject.m_IsValid && hasColors)
+        {
+            const int colorSize= static_cast<int>(pointCount) * 4;
+            subject.m_Colors= file.read(colorSize);
+            subject.m_IsValid= (subject.m_Colors.size() == colorSize);
+        }
+
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+        qint16* pPositions= reinterpret_cast<qint16*>(subject.m_Positions.data());
+        const int count= subject.m_Positions.size() / static_cast<int>(sizeof(qint16));
+        for (int i= 0; i < count; ++i)
+        {
+            pPositions[i]= qFromLittleEndian(pPositions[i]);
+        }
+#endif
+    }
+    return subject;
+}
+
+void GLC_StreamedPointCloud::pollLoads()
+{
+    QList<int>::iterator iIndex= m_LoadingNodes.begin();
+    while (iIndex != m_LoadingNodes.end())
+    {
+        Node& node= m_Nodes[*iIndex];
+        if (node.m_Future.isFinished())
+        {
+            const Chunk chunk(node.m_Future.result());
+            node.m_Future= QFuture<Chunk>();
+            if (chunk.m_IsValid)
+            {
+                node.m_Positions= chunk.m_Positions;
+                node.m_Colors= chunk.m_Colors;
+                node.m_State= Loaded;
+                m_ResidentPointCount+= node.m_PointCount;
+            }
+            else
+            {
+                node.m_State= Failed;
+            }
+            iIndex= m_LoadingNodes.erase(iIndex);
+        }
+        else
+        {
+            ++iIndex;
+        }
+    }
+}
+
+void GLC_StreamedPointCloud::selectNodes(const GLC_Frustum& frustum, const GLC_Matrix4x4& modelView, const GLC_Matrix4x4& projection, int viewHeight)
+{
+    m_SelectedNodes.clear();
+
+    const double* pProjection= projection.getData();
+    const bool isPerspective= (pProjection[11] != 0.0);
+    const double pixelsPerUnit= pProjection[5] * static_cast<double>(viewHeight) * 0.5;
+    const double scale= modelView.scalingX();
+    const double sphereFactor= 1.7320508075688772;
+
+    // Visit nodes from the largest projected point spacing to the smallest
+    QVector<Candidate> heap;
+    heap.append(Candidate(0.0, 0));
+    qint64 selectedPointCount= 0;
+    while (!heap.isEmpty())
+    {
+        std::pop_heap(heap.begin(), heap.end());
+        const int index= heap.last().second;
+        heap.removeLast();
+
+        Node& node= m_Nodes[index];
+        const double radius= node.m_HalfSize * sphereFactor;
+        if (frustum.localizeSphere(node.m_Center, radius) == GLC_Frustum::OutFrustum) continue;
+
+        if (node.m_PointCount > 0)
+        {
+            if ((selectedPointCount + node.m_PointCount) > m_PointBudget) break;
+            selectedPointCount+= node.m_PointCount;
+
+            if (node.m_State == Loaded)
+            {
+                node.m_LastUsedFrame= m_FrameIndex;
+                m_SelectedNodes.append(index);
+            }
+            else
+            {
+                if ((node.m_State == Unloaded) && (m_LoadingNodes.size() < m_MaximumPendingLoad))
+                {
+                    node.m_State= Loading;
+                    node.m_Future= QtConcurrent::run(GLC_StreamedPointCloud::readChunk, m_FileName, node.m_Offset, node.m_PointCount, m_HasColors);
+                    m_LoadingNodes.append(index);
+                }
+                // Children are refinements of this node
+                continue;
+            }
+        }
+
+        for (int i= 0; i < 8; ++i)
+        {
+            const int childIndex= node.m_Children[i];
+            if (childIndex == -1) continue;
+
+            const Node& child= m_Nodes.at(childIndex);
+            const double childRadius= child.m_HalfSize * sphereFactor * scale;
+            double childPixelsPerUnit= pixelsPerUnit;
+            if (isPerspective)
+            {
+                const double depth= -(modelView * child.m_Center).z();
+                childPixelsPerUnit/= qMax(depth, childRadius);
+            }
+            const double spacing= (child.m_HalfSize * 2.0 * scale / m_GridResolution) * childPixelsPerUnit;
+
+            // Nodes with enough density on screen are not refined
+            if ((node.m_PointCount > 0) && (spacing < m_TargetPixelSpacing)) continue;
+
+            heap.append(Candidate(spacing, childIndex));
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+}
+
+void GLC_StreamedPointCloud::drawNode(Node* pNode, bool useColors)
+{
+    const int positionSize= pNode->m_Positions.size();
+    const bool useVbo= GLC_State::vboUsed();
+    if (useVbo && !pNode->m_Buffer.isCreated())
+    {
+        // Data are moved to the VBO
+        pNode->m_Buffer.create();
+        pNode->m_Buffer.bind();
+        pNode->m_Buffer.allocate(positionSize + pNode->m_Colors.size());
+        pNode->m_Buffer.write(0, pNode->m_Positions.constData(), positionSize);
+        if (!pNode->m_Colors.isEmpty())
+        {
+            pNode->m_Buffer.write(positionSize, pNode->m_Colors.constData(), pNode->m_Colors.size());
+        }
+        pNode->m_Positions.clear();
+        pNode->m_Colors.clear();
+    }
+
+    GLC_Context* pContext= GLC_Context::current();
+    pContext->glcPushMatrix();
+    const double scale= pNode->m_HalfSize / static_cast<double>(GLC_PointCloudBuilder::QuantizationRange);
+    GLC_Matrix4x4 matrix(pNode->m_Center);
+    pContext->glcMultMatrix(matrix * GLC_Matrix4x4().setMatScaling(scale, scale, scale));
+    pContext->glcUpdateMatrixUniforms();
+
+    if (pNode->m_Buffer.isCreated())
+    {
+        pNode->m_Buffer.bind();
+        glVertexPointer(3, GL_SHORT, 0, 0);
+        if (useColors)
+        {
+            const qintptr colorOffset= static_cast<qintptr>(pNode->m_PointCount) * 3 * sizeof(qint16);
+            glColorPointer(4, GL_UNSIGNED_BYTE, 0, reinterpret_cast<const GLvoid*>(colorOffset));
+        }
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(pNode->m_PointCount));
+        QOpenGLBuffer::release(QOpenGLBuffer::VertexBuffer);
+    }
+    else
+    {
+        glVertexPointer(3, GL_SHORT, 0, pNode->m_Positions.constData());
+        if (useColors)
+        {
+            glColorPointer(4, GL_UNSIGNED_BYTE, 0, pNode->m_Colors.constData());
+        }
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(pNode->m_PointCount));
+    }
+
+    pContext->glcPopMatrix();
+}
+
+void GLC_StreamedPointCloud::evictNodes()
+{
+    if (m_ResidentPointCount <= m_MaximumResidentPointCount) return;
+
+    // Least recently drawn nodes first
+    QVector<QPair<quint64, int> > candidates;
+    const int count= m_Nodes.size();
+    for (int i= 0; i < count; ++i)
+    {
+        const Node& node= m_Nodes.at(i);
+        if ((node.m_State == Loaded) && (node.m_LastUsedFrame != m_FrameIndex))
+        {
+            candidates.append(qMakePair(node.m_LastUsedFrame, i));
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    const int candidateCount= candidates.size();
+    for (int i= 0; (i < candidateCount) && (m_ResidentPointCount > m_MaximumResidentPointCount); ++i)
+    {
+        releaseNode(&m_Nodes[candidates.at(i).second]);
+    }
+}
+
+void GLC_StreamedPointCloud::releaseNode(Node* pNode)
+{
+    if (pNode->m_State == Loaded)
+    {
+        m_ResidentPointCount-= pNode->m_PointCount;
+    }
+    if (pNode->m_Buffer.isCreated())
+    {
+        pNode->m_Buffer.destroy();
+    }
+    pNode->m_Future= QFuture<Chunk>();
+    pNode->m_Positions.clear();
+    pNode->m_Colors.clear();
+    pNode->m_State= Unloaded;
+}
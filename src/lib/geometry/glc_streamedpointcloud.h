@@ -0,0 +1,275 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_streamedpointcloud.h interface for the GLC_StreamedPointCloud class.
+
+#ifndef GLC_STREAMEDPOINTCLOUD_H_
+#define GLC_STREAMEDPOINTCLOUD_H_
+
+#include <QByteArray>
+#include <QFuture>
+#include <QList>
+#include <QOpenGLBuffer>
+#include <QVector>
+
+#include "glc_geometry.h"
+#include "../maths/glc_vector3d.h"
+
+#include "../glc_config.h"
+
+class GLC_Frustum;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_StreamedPointCloud
+/*! \brief GLC_StreamedPointCloud : Point cloud streamed from a file built by GLC_PointCloudBuilder*/
+
+/*! Only the header and the node table of the file are read on construction.
+ *  On each draw :
+ *  - The nodes in the frustum are visited from the largest projected point spacing to the smallest,
+ *    the children of a node are visited while their point spacing in pixels is greater than the target pixel spacing.
+ *  - Nodes are selected until the point budget is reached.
+ *  - Selected nodes not in memory are loaded asynchronously on the global thread pool,
+ *    their children are not visited until they are loaded.
+ *  - Least recently drawn nodes are released while the resident point count is above its maximum.
+ *
+ *  Positions are drawn as 16 bits integers with a matrix by node and colors as 8 bits RGBA.
+ *  The view must be updated again while pendingLoadCount() is not 0 to show loaded nodes.
+ *  Throw GLC_FileFormatException if the file cannot be read.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_StreamedPointCloud : public GLC_Geometry
+{
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Construct a streamed point cloud of the given file
+    explicit GLC_StreamedPointCloud(const QString& fileName);
+
+    //! Copy constructor, loaded nodes are not copied
+    GLC_StreamedPointCloud(const GLC_StreamedPointCloud& other);
+
+    virtual ~GLC_StreamedPointCloud();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the point cloud bounding box
+    virtual const GLC_BoundingBox& boundingBox();
+
+    //! Return a copy of the geometry
+    virtual GLC_Geometry* clone() const;
+
+    //! Return the point cloud file name
+    inline QString fileName() const
+    {return m_FileName;}
+
+    //! Return the number of points of the point cloud
+    inline qint64 pointCount() const
+    {return m_PointCount;}
+
+    //! Return the number of nodes of the point cloud
+    inline int nodeCount() const
+    {return m_Nodes.size();}
+
+    //! Return true if points have colors
+    inline bool hasColors() const
+    {return m_HasColors;}
+
+    //! Return the maximum number of points drawn
+    inline qint64 pointBudget() const
+    {return m_PointBudget;}
+
+    //! Return the maximum number of points in memory
+    inline qint64 maximumResidentPointCount() const
+    {return m_MaximumResidentPointCount;}
+
+    //! Return the point spacing in pixels under which nodes are not visited
+    inline double targetPixelSpacing() const
+    {return m_TargetPixelSpacing;}
+
+    //! Return the maximum number of concurrent asynchronous loading
+    inline int maximumPendingLoad() const
+    {return m_MaximumPendingLoad;}
+
+    //! Return the number of points drawn by the last draw
+    inline qint64 renderedPointCount() const
+    {return m_RenderedPointCount;}
+
+    //! Return the number of points in memory
+    inline qint64 residentPointCount() const
+    {return m_ResidentPointCount;}
+
+    //! Return the number of nodes being loaded
+    inline int pendingLoadCount() const
+    {return m_LoadingNodes.size();}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Set the maximum number of points drawn
+    inline void setPointBudget(qint64 budget)
+    {m_PointBudget= qMax(static_cast<qint64>(1), budget);}
+
+    //! Set the maximum number of points in memory
+    /*! Nodes selected by the current draw are never released*/
+    inline void setMaximumResidentPointCount(qint64 count)
+    {m_MaximumResidentPointCount= qMax(static_cast<qint64>(0), count);}
+
+    //! Set the point spacing in pixels under which nodes are not visited
+    inline void setTargetPixelSpacing(double spacing)
+    {m_TargetPixelSpacing= qMax(0.1, spacing);}
+
+    //! Set the maximum number of concurrent asynchronous loading
+    inline void setMaximumPendingLoad(int count)
+    {m_MaximumPendingLoad= qMax(1, count);}
+
+    //! Release all loaded nodes
+    /*! Must be called with the OpenGL context of the point cloud current if VBO are used*/
+    void releaseNodes();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name OpenGL Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+protected:
+    //! Virtual interface for OpenGL Geometry set up.
+    /*! This Virtual function is implemented here.\n
+     *  Throw GLC_OpenGlException*/
+    virtual void glDraw(const GLC_RenderProperties& renderProperties);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The data of a loaded chunk
+    struct Chunk
+    {
+        Chunk();
+        QByteArray m_Positions;
+        QByteArray m_Colors;
+        bool m_IsValid;
+    };
+
+    //! The loading state of a node
+    enum NodeState
+    {
+        Unloaded,
+        Loading,
+        Loaded,
+        Failed
+    };
+
+    //! A node of the octree
+    struct Node
+    {
+        Node();
+        GLC_Point3d m_Center;
+        double m_HalfSize;
+        quint32 m_PointCount;
+        qint64 m_Offset;
+        int m_Children[8];
+        NodeState m_State;
+        QFuture<Chunk> m_Future;
+        QByteArray m_Positions;
+        QByteArray m_Colors;
+        QOpenGLBuffer m_Buffer;
+        quint64 m_LastUsedFrame;
+    };
+
+    //! Read the header and the node table of the file
+    void readFile();
+
+    //! Read the chunk of the given file at the given offset
+    static Chunk readChunk(const QString& fileName, qint64 offset, quint32 pointCount, bool hasColors);
+
+    //! Move finished loading into their nodes
+    void pollLoads();
+
+    //! Select the nodes to draw and request the loading of missing nodes
+    void selectNodes(const GLC_Frustum& frustum, const GLC_Matrix4x4& modelView, const GLC_Matrix4x4& projection, int viewHeight);
+
+    //! Draw the given node
+    void drawNode(Node* pNode, bool useColors);
+
+    //! Release nodes not used by the current draw while there are too many resident points
+    void evictNodes();
+
+    //! Release the given node
+    void releaseNode(Node* pNode);
+
+    //! Assignment is not allowed, loaded nodes cannot be shared
+    GLC_StreamedPointCloud& operator=(const GLC_StreamedPointCloud&);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The point cloud file name
+    QString m_FileName;
+
+    //! The nodes, the root is the first one
+    QVector<Node> m_Nodes;
+
+    //! The point count of the file
+    qint64 m_PointCount;
+
+    //! The subsampling grid resolution of the file
+    int m_GridResolution;
+
+    //! True if the file has colors
+    bool m_HasColors;
+
+    //! The tight bounding box of the file
+    GLC_BoundingBox m_Bounds;
+
+    //! Settings
+    qint64 m_PointBudget;
+    qint64 m_MaximumResidentPointCount;
+    double m_TargetPixelSpacing;
+    int m_MaximumPendingLoad;
+
+    //! Indexes of nodes being loaded
+    QList<int> m_LoadingNodes;
+
+    //! Indexes of nodes selected by the current draw
+    QVector<int> m_SelectedNodes;
+
+    //! Index of the current draw
+    quint64 m_FrameIndex;
+
+    //! Statistics
+    qint64 m_RenderedPointCount;
+    qint64 m_ResidentPointCount;
+};
+
+#endif /* GLC_STREAMEDPOINTCLOUD_H_ */
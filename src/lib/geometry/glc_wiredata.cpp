@@ -28,6 +28,7 @@
 #include "../glc_state.h"
 #include "../glc_exception.h"
 #include "../glc_contextmanager.h"
+#include "../glc_renderstatecache.h"
 
 // Class chunk id
 // Old chunkId = 0xA706
@@ -389,6 +390,8 @@ void GLC_WireData::glDraw(const GLC_RenderProperties&, GLenum mode)
 	if (m_ColorSize > 0)
 	{
 		glDisableClientState(GL_COLOR_ARRAY);
+		// Vertex colors have overwritten the current material
+		GLC_RenderStateCache::current()->invalidateMaterial();
 	}
 
 	glDisableClientState(GL_VERTEX_ARRAY);
@@ -23,6 +23,14 @@
 
 #include "glc_cachemanager.h"
 #include <QtDebug>
+#include <QSaveFile>
+#include <QDataStream>
+
+// The texture cache sub directory, file suffix, magic number and version
+static const char* glcTextureCacheContext= "textures";
+static const char* glcTextureCacheSuffix= "glctex";
+static const quint32 glcTextureCacheMagicNumber= 0x474C5458;
+static const quint32 glcTextureCacheVersion= 1;
 
 
 GLC_CacheManager::GLC_CacheManager(const QString& path)
@@ -163,6 +171,101 @@ bool GLC_CacheManager::addToCache(const QString& context, const GLC_3DRep& rep)
 	return addedToCache;
 }
 
+// Return the cached mipmap levels of the specified texture content key
+QList<QImage> GLC_CacheManager::textureLevels(const QString& key, bool* pHasAlphaChannel) const
+{
+	QList<QImage> levels;
+	if (!isReadable()) return levels;
+
+	QFile file(textureFileName(key));
+	if (file.open(QIODevice::ReadOnly))
+	{
+		QDataStream stream(&file);
+		stream.setVersion(QDataStream::Qt_5_0);
+		quint32 magicNumber= 0;
+		quint32 version= 0;
+		stream >> magicNumber >> version;
+		if ((magicNumber == glcTextureCacheMagicNumber) && (version == glcTextureCacheVersion))
+		{
+			bool hasAlphaChannel= false;
+			bool compressed= false;
+			qint32 levelCount= 0;
+			stream >> hasAlphaChannel >> compressed >> levelCount;
+			bool isValid= (levelCount > 0);
+			for (qint32 i= 0; isValid && (i < levelCount); ++i)
+			{
+				qint32 width= 0;
+				qint32 height= 0;
+				QByteArray data;
+				stream >> width >> height >> data;
+				if (compressed) data= qUncompress(data);
+
+				// RGBA8888 lines have no padding
+				isValid= (stream.status() == QDataStream::Ok) && (width > 0) && (height > 0)
+						&& (data.size() == (static_cast<qint64>(width) * height * 4));
+				if (isValid)
+				{
+					QImage level(width, height, QImage::Format_RGBA8888);
+					memcpy(level.bits(), data.constData(), data.size());
+					levels.append(level);
+				}
+			}
+			if (isValid)
+			{
+				*pHasAlphaChannel= hasAlphaChannel;
+			}
+			else
+			{
+				levels.clear();
+			}
+		}
+	}
+
+	return levels;
+}
+
+// Add the mipmap levels of the specified texture content key in the cache
+bool GLC_CacheManager::addTextureToCache(const QString& key, const QList<QImage>& levels, bool hasAlphaChannel)
+{
+	Q_ASSERT(!levels.isEmpty());
+	bool addedToCache= isWritable();
+	if (addedToCache)
+	{
+		// Textures are added from several threads, mkpath succeeds if the directory exists
+		addedToCache= m_Dir.mkpath(glcTextureCacheContext);
+	}
+	if (addedToCache)
+	{
+		// Write in a temporary file, the same content may be added by another thread
+		QSaveFile file(textureFileName(key));
+		addedToCache= file.open(QIODevice::WriteOnly);
+		if (addedToCache)
+		{
+			QDataStream stream(&file);
+			stream.setVersion(QDataStream::Qt_5_0);
+			stream << glcTextureCacheMagicNumber << glcTextureCacheVersion;
+			stream << hasAlphaChannel << m_UseCompression << static_cast<qint32>(levels.size());
+			for (const QImage& level : levels)
+			{
+				Q_ASSERT(level.format() == QImage::Format_RGBA8888);
+				const QByteArray data(reinterpret_cast<const char*>(level.constBits()), level.sizeInBytes());
+				stream << static_cast<qint32>(level.width()) << static_cast<qint32>(level.height());
+				if (m_UseCompression)
+				{
+					stream << qCompress(data, m_CompressionLevel);
+				}
+				else
+				{
+					stream << data;
+				}
+			}
+			addedToCache= (stream.status() == QDataStream::Ok) && file.commit();
+		}
+	}
+
+	return addedToCache;
+}
+
 //////////////////////////////////////////////////////////////////////
 //Set Functions
 //////////////////////////////////////////////////////////////////////
@@ -181,3 +284,12 @@ bool GLC_CacheManager::setCachePath(const QString& path)
 	return result;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+// Return the file name of the specified texture content key
+QString GLC_CacheManager::textureFileName(const QString& key) const
+{
+	return m_Dir.absolutePath() + QDir::separator() + glcTextureCacheContext + QDir::separator() + key + '.' + glcTextureCacheSuffix;
+}
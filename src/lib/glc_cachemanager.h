@@ -27,6 +27,8 @@
 #include <QDir>
 #include <QString>
 #include <QDateTime>
+#include <QImage>
+#include <QList>
 #include "geometry/glc_bsrep.h"
 
 #include "glc_config.h"
@@ -90,6 +92,14 @@ public:
 	//! Add the specified file in the cache
 	bool addToCache(const QString&, const GLC_3DRep&);
 
+	//! Return the cached mipmap levels of the specified texture content key
+	/*! Return an empty list if the texture is not cached*/
+	QList<QImage> textureLevels(const QString& key, bool* pHasAlphaChannel) const;
+
+	//! Add the mipmap levels of the specified texture content key in the cache
+	/*! Levels must be in the RGBA8888 format*/
+	bool addTextureToCache(const QString& key, const QList<QImage>& levels, bool hasAlphaChannel);
+
 	//! Return true if the compression is used
 	inline bool compressionIsUsed() const
 	{return m_UseCompression;}
@@ -118,6 +128,13 @@ public:
 	{m_CompressionLevel= level;}
 //@}
 
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Return the file name of the specified texture content key
+	QString textureFileName(const QString& key) const;
+
 //////////////////////////////////////////////////////////////////////
 // Private members
 //////////////////////////////////////////////////////////////////////
@@ -26,6 +26,7 @@
 #include "glc_context.h"
 #include "glc_contextmanager.h"
 #include "shading/glc_shader.h"
+#include "shading/glc_oitrenderer.h"
 
 #include "glc_state.h"
 
@@ -34,13 +35,15 @@ GLC_Context::GLC_Context(QOpenGLContext *pOpenGLContext, QSurface *pSurface)
     , m_pOpenGLContext(pOpenGLContext)
     , m_pSurface(pSurface)
     , m_ContextSharedData()
+    , m_RenderStateCache()
+    , m_pOitRenderer(nullptr)
 {
     connect(m_pOpenGLContext, SIGNAL(aboutToBeDestroyed()), this, SLOT(openGLContextDestroyed()), Qt::DirectConnection);
 }
 
 GLC_Context::~GLC_Context()
 {
-
+    delete m_pOitRenderer;
 }
 
 GLC_Context *GLC_Context::current()
@@ -53,6 +56,16 @@ GLC_Context *GLC_Context::current()
 // Get Functions
 //////////////////////////////////////////////////////////////////////
 
+GLC_OitRenderer* GLC_Context::oitRenderer()
+{
+    if (nullptr == m_pOitRenderer)
+    {
+        m_pOitRenderer= new GLC_OitRenderer;
+    }
+
+    return m_pOitRenderer;
+}
+
 void GLC_Context::glcUseVertexPointer(const GLvoid *pointer)
 {
     Q_ASSERT(m_pOpenGLContext);
@@ -292,6 +305,12 @@ void GLC_Context::unuseDefaultShader()
 
 void GLC_Context::openGLContextDestroyed()
 {
+    // OpenGL resources are released while the context still exists
+    if (QOpenGLContext::currentContext() == m_pOpenGLContext)
+    {
+        delete m_pOitRenderer;
+        m_pOitRenderer= nullptr;
+    }
     m_ContextSharedData.clear();
     emit destroyed(this);
 }
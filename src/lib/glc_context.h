@@ -32,8 +32,10 @@
 #include "maths/glc_matrix4x4.h"
 #include "glc_contextshareddata.h"
 #include "glc_uniformshaderdata.h"
+#include "glc_renderstatecache.h"
 
 class GLC_ContextSharedData;
+class GLC_OitRenderer;
 class QOpenGLContext;
 class QSurface;
 
@@ -109,6 +111,14 @@ public:
     inline QOpenGLContext* contextHandle() const
     {return m_pOpenGLContext;}
 
+    //! Return the render state cache of this GLC_Context
+    inline GLC_RenderStateCache* renderStateCache()
+    {return &m_RenderStateCache;}
+
+    //! Return the order independent transparency renderer of this GLC_Context
+    /*! The renderer is created on the first call*/
+    GLC_OitRenderer* oitRenderer();
+
 //@}
 //////////////////////////////////////////////////////////////////////
 /*! \name OpenGL Functions*/
@@ -174,6 +184,11 @@ public:
     inline void glcSetTwoSidedLight(GLint twoSided)
     {m_ContextSharedData->glcSetTwoSidedLight(twoSided);}
 
+    //! Send the modified matrices to the active shader
+    /*! Matrices are sent lazily, this function must be called before drawing with a shader*/
+    inline void glcUpdateMatrixUniforms()
+    {m_ContextSharedData->glcUpdateMatrixUniforms();}
+
     //! Use vertex array pointer and enable it
     void glcUseVertexPointer(const GLvoid* pointer);
 
@@ -243,6 +258,12 @@ private:
 
 	//! The context shared data
 	QSharedPointer<GLC_ContextSharedData> m_ContextSharedData;
+
+    //! The OpenGL state shadow of this context
+    GLC_RenderStateCache m_RenderStateCache;
+
+    //! The order independent transparency renderer of this context
+    GLC_OitRenderer* m_pOitRenderer;
 };
 
 #endif /* GLC_CONTEXT_H_ */
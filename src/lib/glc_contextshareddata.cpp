@@ -30,25 +30,22 @@
 GLC_ContextSharedData::GLC_ContextSharedData()
     : m_pDefaultShader(NULL)
     , m_IsClean(false)
-    , m_CurrentMatrixMode()
-    , m_MatrixStackHash()
+    , m_CurrentMatrixMode(GL_MODELVIEW)
+    , m_pCurrentMatrixStack(&(m_MatrixStacks[ModelViewStack]))
+    , m_ModelViewIsChanged(true)
+    , m_ProjectionIsChanged(true)
     , m_UniformShaderData()
     , m_ColorMaterialIsEnable()
     , m_LightingIsEnable()
     , m_TwoSidedLighting()
     , m_LightsEnableState()
 {
-    QStack<GLC_Matrix4x4>* pStack1= new QStack<GLC_Matrix4x4>();
-    pStack1->push(GLC_Matrix4x4());
-    m_MatrixStackHash.insert(GL_MODELVIEW, pStack1);
-
-    QStack<GLC_Matrix4x4>* pStack2= new QStack<GLC_Matrix4x4>();
-    pStack2->push(GLC_Matrix4x4());
-    m_MatrixStackHash.insert(GL_PROJECTION, pStack2);
-
-    QStack<GLC_Matrix4x4>* pStack3= new QStack<GLC_Matrix4x4>();
-    pStack3->push(GLC_Matrix4x4());
-    m_MatrixStackHash.insert(GL_TEXTURE, pStack3);
+    // Same depth as the minimum OpenGL model view stack depth
+    for (int i= 0; i < MatrixStackCount; ++i)
+    {
+        m_MatrixStacks[i].reserve(32);
+        m_MatrixStacks[i].push(GLC_Matrix4x4());
+    }
 
     m_ColorMaterialIsEnable.push(false);
     m_LightingIsEnable.push(false);
@@ -59,13 +56,6 @@ GLC_ContextSharedData::GLC_ContextSharedData()
 
 GLC_ContextSharedData::~GLC_ContextSharedData()
 {
-    QHash<GLenum, QStack<GLC_Matrix4x4>* >::iterator iStack= m_MatrixStackHash.begin();
-    while (iStack != m_MatrixStackHash.end())
-    {
-        delete iStack.value();
-        ++iStack;
-    }
-
     delete m_pDefaultShader;
 }
 
@@ -102,6 +92,9 @@ void GLC_ContextSharedData::glcMatrixMode(GLenum mode)
     Q_ASSERT((mode == GL_MODELVIEW) || (mode == GL_PROJECTION) || (mode == GL_TEXTURE));
 
     m_CurrentMatrixMode= mode;
+    if (mode == GL_MODELVIEW) m_pCurrentMatrixStack= &(m_MatrixStacks[ModelViewStack]);
+    else if (mode == GL_PROJECTION) m_pCurrentMatrixStack= &(m_MatrixStacks[ProjectionStack]);
+    else m_pCurrentMatrixStack= &(m_MatrixStacks[TextureStack]);
 #ifdef GLC_OPENGL_ES_2
 
 #else
@@ -111,22 +104,17 @@ void GLC_ContextSharedData::glcMatrixMode(GLenum mode)
 
 void GLC_ContextSharedData::glcLoadIdentity()
 {
-    m_MatrixStackHash.value(m_CurrentMatrixMode)->top().setToIdentity();
+    m_pCurrentMatrixStack->top().setToIdentity();
+    currentMatrixChanged();
 
-#ifdef GLC_OPENGL_ES_2
-    m_UniformShaderData.setModelViewProjectionMatrix(m_MatrixStackHash.value(GL_MODELVIEW)->top(), m_MatrixStackHash.value(GL_PROJECTION)->top());
-#else
-    if (GLC_Shader::hasActiveShader())
-    {
-        m_UniformShaderData.setModelViewProjectionMatrix(m_MatrixStackHash.value(GL_MODELVIEW)->top(), m_MatrixStackHash.value(GL_PROJECTION)->top());
-    }
+#ifndef GLC_OPENGL_ES_2
     glLoadIdentity();
 #endif
 }
 
 void GLC_ContextSharedData::glcPushMatrix()
 {
-    m_MatrixStackHash.value(m_CurrentMatrixMode)->push(m_MatrixStackHash.value(m_CurrentMatrixMode)->top());
+    m_pCurrentMatrixStack->push(m_pCurrentMatrixStack->top());
 
 #ifndef GLC_OPENGL_ES_2
     glPushMatrix();
@@ -135,47 +123,47 @@ void GLC_ContextSharedData::glcPushMatrix()
 
 void GLC_ContextSharedData::glcPopMatrix()
 {
-    m_MatrixStackHash.value(m_CurrentMatrixMode)->pop();
+    m_pCurrentMatrixStack->pop();
+    currentMatrixChanged();
 
-#ifdef GLC_OPENGL_ES_2
-    this->glcLoadMatrix(m_MatrixStackHash.value(m_CurrentMatrixMode)->top());
-#else
-    if (GLC_Shader::hasActiveShader())
-    {
-        this->glcLoadMatrix(m_MatrixStackHash.value(m_CurrentMatrixMode)->top());
-    }
+#ifndef GLC_OPENGL_ES_2
     glPopMatrix();
 #endif
 }
 
 void GLC_ContextSharedData::glcLoadMatrix(const GLC_Matrix4x4 &matrix)
 {
-    m_MatrixStackHash.value(m_CurrentMatrixMode)->top()= matrix;
+    m_pCurrentMatrixStack->top()= matrix;
+    currentMatrixChanged();
 
-#ifdef GLC_OPENGL_ES_2
-    m_UniformShaderData.setModelViewProjectionMatrix(m_MatrixStackHash.value(GL_MODELVIEW)->top(), m_MatrixStackHash.value(GL_PROJECTION)->top());
-#else
-    if (GLC_Shader::hasActiveShader())
-    {
-        m_UniformShaderData.setModelViewProjectionMatrix(m_MatrixStackHash.value(GL_MODELVIEW)->top(), m_MatrixStackHash.value(GL_PROJECTION)->top());
-    }
+#ifndef GLC_OPENGL_ES_2
     ::glLoadMatrixd(matrix.getData());
 #endif
 }
 
 void GLC_ContextSharedData::glcMultMatrix(const GLC_Matrix4x4 &matrix)
 {
-    const GLC_Matrix4x4 current= m_MatrixStackHash.value(m_CurrentMatrixMode)->top();
-    m_MatrixStackHash.value(m_CurrentMatrixMode)->top()= current * matrix;
-#ifdef GLC_OPENGL_ES_2
-    m_UniformShaderData.setModelViewProjectionMatrix(m_MatrixStackHash.value(GL_MODELVIEW)->top(), m_MatrixStackHash.value(GL_PROJECTION)->top());
-#else
+    if (matrix.type() == GLC_Matrix4x4::Identity) return;
+
+    GLC_Matrix4x4& current= m_pCurrentMatrixStack->top();
+    current= current * matrix;
+    currentMatrixChanged();
+
+#ifndef GLC_OPENGL_ES_2
+    ::glMultMatrixd(matrix.getData());
+#endif
+}
+
+void GLC_ContextSharedData::glcUpdateMatrixUniforms()
+{
+    // The shader may have changed even if matrices have not
     if (GLC_Shader::hasActiveShader())
     {
-        m_UniformShaderData.setModelViewProjectionMatrix(m_MatrixStackHash.value(GL_MODELVIEW)->top(), m_MatrixStackHash.value(GL_PROJECTION)->top());
+        m_UniformShaderData.updateMatrices(m_MatrixStacks[ModelViewStack].top(), m_ModelViewIsChanged
+                                           , m_MatrixStacks[ProjectionStack].top(), m_ProjectionIsChanged);
+        m_ModelViewIsChanged= false;
+        m_ProjectionIsChanged= false;
     }
-    ::glMultMatrixd(matrix.getData());
-#endif
 }
 
 void GLC_ContextSharedData::glcScaled(double x, double y, double z)
@@ -50,11 +50,11 @@ public:
 
     //! Return the model view matrix
     inline GLC_Matrix4x4 modelViewMatrix() const
-    {Q_ASSERT(m_MatrixStackHash.contains(GL_MODELVIEW)); return m_MatrixStackHash.value(GL_MODELVIEW)->top();}
+    {return m_MatrixStacks[ModelViewStack].top();}
 
     //! Return the projection matrix
     inline GLC_Matrix4x4 projectionMatrix() const
-    {Q_ASSERT(m_MatrixStackHash.contains(GL_PROJECTION)); return m_MatrixStackHash.value(GL_PROJECTION)->top();}
+    {return m_MatrixStacks[ProjectionStack].top();}
 
     //! Return lighting enable state
     inline bool lightingIsEnable() const
@@ -84,7 +84,15 @@ public:
 
     //! Update uniform variable
     inline void updateUniformVariables(GLC_Context* pContext)
-    {m_UniformShaderData.updateAll(pContext);}
+    {
+        m_UniformShaderData.updateAll(pContext);
+        m_ModelViewIsChanged= false;
+        m_ProjectionIsChanged= false;
+    }
+
+    //! Send changed matrices to the current shader
+    /*! Matrix uniforms are updated lazily, this function must be called before drawing*/
+    void glcUpdateMatrixUniforms();
 
     //! Use the default shader
     void useDefaultShader();
@@ -145,15 +153,38 @@ private:
     void initDefaultShader();
     void initLightEnableState();
 
+    //! Mark the matrix of the current stack as changed
+    inline void currentMatrixChanged()
+    {
+        if (m_pCurrentMatrixStack == &(m_MatrixStacks[ModelViewStack])) m_ModelViewIsChanged= true;
+        else if (m_pCurrentMatrixStack == &(m_MatrixStacks[ProjectionStack])) m_ProjectionIsChanged= true;
+    }
+
 private:
+    //! Index of the matrix stack of each matrix mode
+    enum MatrixStackIndex
+    {
+        ModelViewStack= 0,
+        ProjectionStack,
+        TextureStack,
+        MatrixStackCount
+    };
+
     GLC_Shader* m_pDefaultShader;
     bool m_IsClean;
 
     //! The current matrix mode
     GLenum m_CurrentMatrixMode;
 
-    //! Mapping between matrixMode and matrix stack
-    QHash<GLenum, QStack<GLC_Matrix4x4>* > m_MatrixStackHash;
+    //! Matrix stack of each matrix mode
+    QStack<GLC_Matrix4x4> m_MatrixStacks[MatrixStackCount];
+
+    //! The matrix stack of the current matrix mode
+    QStack<GLC_Matrix4x4>* m_pCurrentMatrixStack;
+
+    //! True if the matrix has changed since the last update of the matrix uniforms
+    bool m_ModelViewIsChanged;
+    bool m_ProjectionIsChanged;
 
     //! The uniform data of the current shader
     GLC_UniformShaderData m_UniformShaderData;
@@ -32,6 +32,7 @@
 #include "glc_factory.h"
 #include "io/glc_fileloader.h"
 #include "io/glc_3dxmltoworld.h"
+#include "io/glc_glcwtoworld.h"
 #include "io/glc_worldreaderplugin.h"
 
 #include "viewport/glc_panmover.h"
@@ -297,7 +298,12 @@ GLC_3DRep GLC_Factory::create3DRepFromFile(const QString& fileName, bool useZipM
 {
 	GLC_3DRep rep;
 
-	if ((QFileInfo(fileName).suffix().toLower() == "3dxml") || (QFileInfo(fileName).suffix().toLower() == "3drep") || (QFileInfo(fileName).suffix().toLower() == "xml"))
+	if (GLC_GlcwToWorld::isGlcwRepresentation(fileName))
+	{
+		GLC_GlcwToWorld glcwToWorld;
+		rep= glcwToWorld.create3DRepFromGlcwRep(fileName);
+	}
+	else if ((QFileInfo(fileName).suffix().toLower() == "3dxml") || (QFileInfo(fileName).suffix().toLower() == "3drep") || (QFileInfo(fileName).suffix().toLower() == "xml"))
 	{
 		GLC_3dxmlToWorld d3dxmlToWorld;
 		connect(&d3dxmlToWorld, SIGNAL(currentQuantum(int)), this, SIGNAL(currentQuantum(int)));
@@ -22,57 +22,40 @@
 
 //! \file glc_global.cpp implementation of usefull utilities
 
+#include <QAtomicInteger>
+
 #include "glc_global.h"
 
-QMutex glc::iDMutex;
-QMutex glc::geomIdMutex;
-QMutex glc::userIdMutex;
-QMutex glc::widget3dIdMutex;
-QMutex glc::shadingGroupIdMutex;
+// Id generators are lock free, they can be used by concurrent loaders
+static QAtomicInteger<GLC_uint> glcId(0);
+static QAtomicInteger<GLC_uint> glcGeomId(0);
+static QAtomicInteger<GLC_uint> glcUserId(0);
+static QAtomicInteger<GLC_uint> glc3DWidgetId(0);
+static QAtomicInteger<GLC_uint> glcShadingGroupId(1);
 
 GLC_uint glc::GLC_GenID(void)
 {
-	static GLC_uint Id= 0;
-	glc::iDMutex.lock();
-	Id++;
-	glc::iDMutex.unlock();
-	return Id;
+	return glcId.fetchAndAddRelaxed(1) + 1;
 }
 
 GLC_uint glc::GLC_GenGeomID(void)
 {
-	static GLC_uint Id= 0;
-	glc::geomIdMutex.lock();
-	Id++;
-	glc::geomIdMutex.unlock();
-	return Id;
+	return glcGeomId.fetchAndAddRelaxed(1) + 1;
 }
 
 GLC_uint glc::GLC_GenUserID(void)
 {
-	static GLC_uint Id= 0;
-	glc::userIdMutex.lock();
-	Id++;
-	glc::userIdMutex.unlock();
-	return Id;
+	return glcUserId.fetchAndAddRelaxed(1) + 1;
 }
 
 GLC_uint glc::GLC_Gen3DWidgetID(void)
 {
-	static GLC_uint Id= 0;
-	glc::widget3dIdMutex.lock();
-	Id++;
-	glc::widget3dIdMutex.unlock();
-	return Id;
+	return glc3DWidgetId.fetchAndAddRelaxed(1) + 1;
 }
 
 GLC_uint glc::GLC_GenShaderGroupID()
 {
-	static GLC_uint Id= 1;
-	glc::shadingGroupIdMutex.lock();
-	Id++;
-	glc::shadingGroupIdMutex.unlock();
-	return Id;
+	return glcShadingGroupId.fetchAndAddRelaxed(1) + 1;
 }
 
 const QString glc::archivePrefix()
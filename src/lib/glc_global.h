@@ -52,6 +52,7 @@ typedef QVector<GLuint> OffsetVectori;
 namespace glc
 {
 	//! Simple ID generation
+	/*! Id generation functions are thread safe and lock free*/
 	GLC_LIB_EXPORT GLC_uint GLC_GenID();
 
 	//! Simple Geom ID generation
@@ -75,12 +76,6 @@ namespace glc
 	const int GLC_DISCRET= 70;
 	const int GLC_POLYDISCRET= 60;
 
-	extern QMutex iDMutex;
-	extern QMutex geomIdMutex;
-	extern QMutex userIdMutex;
-	extern QMutex widget3dIdMutex;
-	extern QMutex shadingGroupIdMutex;
-
 	//! 3D widget event flag
 	enum WidgetEventFlag
 	{
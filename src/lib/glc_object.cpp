@@ -31,7 +31,6 @@
 GLC_Object::GLC_Object(const QString& name)
 : m_Uid(glc::GLC_GenID())	// Object ID
 , m_Name(name)			// Object Name
-, m_Mutex()
 {
 
 }
@@ -39,7 +38,6 @@ GLC_Object::GLC_Object(const QString& name)
 GLC_Object::GLC_Object(GLC_uint id, const QString& name)
 : m_Uid(id)
 , m_Name(name)
-, m_Mutex()
 {
 
 }
@@ -47,7 +45,6 @@ GLC_Object::GLC_Object(GLC_uint id, const QString& name)
 GLC_Object::GLC_Object(const GLC_Object& sourceObject)
 : m_Uid(sourceObject.m_Uid)
 , m_Name(sourceObject.m_Name)
-, m_Mutex()
 {
 }
 
@@ -63,20 +60,17 @@ GLC_Object::~GLC_Object()
 
 void GLC_Object::setId(const GLC_uint id)
 {
-	QMutexLocker mutexLocker(&m_Mutex);
 	m_Uid= id;
 }
 
 void GLC_Object::setName(const QString& name)
 {
-	QMutexLocker mutexLocker(&m_Mutex);
 	m_Name= name;
 }
 
 
 GLC_Object& GLC_Object::operator=(const GLC_Object& object)
 {
-	QMutexLocker mutexLocker(&m_Mutex);
 	m_Uid= object.m_Uid;
 	m_Name= object.m_Name;
 	return *this;
@@ -28,7 +28,6 @@
     #include <QtOpenGL>
     #include <QString>
     #include <QUuid>
-    #include <QMutex>
     #include "glc_global.h"
 
     #include "glc_config.h"
@@ -92,15 +91,12 @@
     public:
 
         //! Set this object Id
-        /*! This method is thread safe*/
         void setId(const GLC_uint id);
 
         //! Set this object Name
-        /*! This method is thread safe*/
         void setName(const QString& name);
 
         //! Set this object from the given object
-        /*! This method is thread safe*/
         GLC_Object &operator=(const GLC_Object&);
 
     //@}
@@ -117,8 +113,5 @@
 
         //! Name of an GLC_Object
         QString m_Name;
-
-        //! GLC_Object Mutex
-        QMutex m_Mutex;
     };
     #endif //GLC_OBJECT_H_
@@ -0,0 +1,335 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_renderprofiler.cpp implementation of the GLC_RenderProfiler class.
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QThread>
+
+#include "glc_renderprofiler.h"
+
+// Static variables initialisation
+bool GLC_RenderProfiler::m_IsActivated= false;
+bool GLC_RenderProfiler::m_IsRecording= false;
+QElapsedTimer GLC_RenderProfiler::m_Clock;
+GLC_RenderProfiler::FrameStatistics GLC_RenderProfiler::m_CurrentFrame;
+QThread* GLC_RenderProfiler::m_pRecordingThread= nullptr;
+QVector<GLC_RenderProfiler::FrameStatistics> GLC_RenderProfiler::m_Frames;
+int GLC_RenderProfiler::m_NextFrameIndex= 0;
+int GLC_RenderProfiler::m_FrameHistorySize= 120;
+int GLC_RenderProfiler::m_MaximumTraceEventCount= 10000;
+quint64 GLC_RenderProfiler::m_FrameCount= 0;
+
+namespace
+{
+    // The innermost running scoped timer of the calling thread
+    thread_local GLC_RenderProfiler::ScopedTimer* pCurrentTimer= nullptr;
+
+    const char* const stageNames[GLC_RenderProfiler::StageCount]=
+    {
+        "culling",
+        "lodSelection",
+        "traversal",
+        "material",
+        "draw"
+    };
+
+    const char* const counterNames[GLC_RenderProfiler::CounterCount]=
+    {
+        "drawCalls",
+        "materialChanges",
+        "viewableInstances",
+        "culledInstances",
+        "bodies",
+        "triangles",
+        "issuedStateChanges",
+        "filteredStateChanges",
+        "occludedInstances"
+    };
+
+    // Convert nanoseconds to microseconds
+    double toMicroseconds(qint64 nsecs)
+    {
+        return static_cast<double>(nsecs) / 1000.0;
+    }
+}
+
+GLC_RenderProfiler::FrameStatistics::FrameStatistics()
+    : m_FrameNumber(0)
+    , m_Start(0)
+    , m_Duration(0)
+    , m_TraceEvents()
+{
+    for (int i= 0; i < StageCount; ++i)
+    {
+        m_StageTime[i]= 0;
+        m_StageCalls[i]= 0;
+    }
+    for (int i= 0; i < CounterCount; ++i)
+    {
+        m_Counters[i]= 0;
+    }
+    for (int i= 0; i < LodBinCount; ++i)
+    {
+        m_LodHistogram[i]= 0;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// ScopedTimer
+//////////////////////////////////////////////////////////////////////
+
+void GLC_RenderProfiler::ScopedTimer::start()
+{
+    Q_ASSERT_X(QThread::currentThread() == GLC_RenderProfiler::m_pRecordingThread, "GLC_RenderProfiler::ScopedTimer"
+               , "Scoped timers must be used from the thread which has begun the frame");
+    m_pParent= pCurrentTimer;
+    pCurrentTimer= this;
+    m_Start= GLC_RenderProfiler::m_Clock.nsecsElapsed();
+}
+
+void GLC_RenderProfiler::ScopedTimer::stop()
+{
+    const qint64 duration= GLC_RenderProfiler::m_Clock.nsecsElapsed() - m_Start;
+    pCurrentTimer= m_pParent;
+
+    // The frame may have ended in this scope
+    if (!GLC_RenderProfiler::m_IsRecording) return;
+
+    if (nullptr != m_pParent) m_pParent->m_ChildTime+= duration;
+
+    FrameStatistics& frame= GLC_RenderProfiler::m_CurrentFrame;
+    frame.m_StageTime[m_Stage]+= duration - m_ChildTime;
+    frame.m_StageCalls[m_Stage]+= 1;
+    if (frame.m_TraceEvents.size() < GLC_RenderProfiler::m_MaximumTraceEventCount)
+    {
+        TraceEvent event;
+        event.m_Stage= m_Stage;
+        event.m_Start= m_Start;
+        event.m_Duration= duration;
+        frame.m_TraceEvents.append(event);
+    }
+}
+
+GLC_RenderProfiler::GLC_RenderProfiler()
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+QList<GLC_RenderProfiler::FrameStatistics> GLC_RenderProfiler::frames()
+{
+    QList<FrameStatistics> subject;
+    const int count= m_Frames.size();
+    // When the ring buffer is full, the oldest frame is the next to be overwritten
+    const int first= (count < m_FrameHistorySize) ? 0 : m_NextFrameIndex;
+    for (int i= 0; i < count; ++i)
+    {
+        subject.append(m_Frames.at((first + i) % count));
+    }
+
+    return subject;
+}
+
+GLC_RenderProfiler::FrameStatistics GLC_RenderProfiler::lastFrame()
+{
+    FrameStatistics subject;
+    if (!m_Frames.isEmpty())
+    {
+        const int count= m_Frames.size();
+        subject= m_Frames.at((m_NextFrameIndex + count - 1) % count);
+    }
+
+    return subject;
+}
+
+QByteArray GLC_RenderProfiler::toJson()
+{
+    QJsonArray framesArray;
+    const QList<FrameStatistics> frameList(frames());
+    for (const FrameStatistics& frame : frameList)
+    {
+        QJsonObject stages;
+        for (int i= 0; i < StageCount; ++i)
+        {
+            QJsonObject stage;
+            stage.insert("time", toMicroseconds(frame.m_StageTime[i]));
+            stage.insert("calls", static_cast<double>(frame.m_StageCalls[i]));
+            stages.insert(stageNames[i], stage);
+        }
+
+        QJsonObject counters;
+        for (int i= 0; i < CounterCount; ++i)
+        {
+            counters.insert(counterNames[i], static_cast<double>(frame.m_Counters[i]));
+        }
+
+        QJsonArray lodHistogram;
+        for (int i= 0; i < LodBinCount; ++i)
+        {
+            lodHistogram.append(static_cast<double>(frame.m_LodHistogram[i]));
+        }
+
+        QJsonObject frameObject;
+        frameObject.insert("frame", static_cast<double>(frame.m_FrameNumber));
+        frameObject.insert("start", toMicroseconds(frame.m_Start));
+        frameObject.insert("duration", toMicroseconds(frame.m_Duration));
+        frameObject.insert("stages", stages);
+        frameObject.insert("counters", counters);
+        frameObject.insert("lodHistogram", lodHistogram);
+        framesArray.append(frameObject);
+    }
+
+    QJsonObject root;
+    root.insert("timeUnit", QString("us"));
+    root.insert("frames", framesArray);
+
+    return QJsonDocument(root).toJson();
+}
+
+QByteArray GLC_RenderProfiler::toChromeTrace()
+{
+    QJsonArray events;
+    const QList<FrameStatistics> frameList(frames());
+    for (const FrameStatistics& frame : frameList)
+    {
+        QJsonObject frameEvent;
+        frameEvent.insert("name", QString("frame %1").arg(frame.m_FrameNumber));
+        frameEvent.insert("cat", QString("frame"));
+        frameEvent.insert("ph", QString("X"));
+        frameEvent.insert("pid", 0);
+        frameEvent.insert("tid", 0);
+        frameEvent.insert("ts", toMicroseconds(frame.m_Start));
+        frameEvent.insert("dur", toMicroseconds(frame.m_Duration));
+        events.append(frameEvent);
+
+        for (const TraceEvent& traceEvent : frame.m_TraceEvents)
+        {
+            QJsonObject stageEvent;
+            stageEvent.insert("name", QString(stageNames[traceEvent.m_Stage]));
+            stageEvent.insert("cat", QString("stage"));
+            stageEvent.insert("ph", QString("X"));
+            stageEvent.insert("pid", 0);
+            stageEvent.insert("tid", 0);
+            stageEvent.insert("ts", toMicroseconds(traceEvent.m_Start));
+            stageEvent.insert("dur", toMicroseconds(traceEvent.m_Duration));
+            events.append(stageEvent);
+        }
+
+        QJsonObject counterArgs;
+        for (int i= 0; i < CounterCount; ++i)
+        {
+            counterArgs.insert(counterNames[i], static_cast<double>(frame.m_Counters[i]));
+        }
+        QJsonObject counterEvent;
+        counterEvent.insert("name", QString("counters"));
+        counterEvent.insert("ph", QString("C"));
+        counterEvent.insert("pid", 0);
+        counterEvent.insert("ts", toMicroseconds(frame.m_Start));
+        counterEvent.insert("args", counterArgs);
+        events.append(counterEvent);
+    }
+
+    QJsonObject root;
+    root.insert("traceEvents", events);
+    root.insert("displayTimeUnit", QString("ms"));
+
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+QString GLC_RenderProfiler::stageName(Stage stage)
+{
+    Q_ASSERT(stage < StageCount);
+    return QString(stageNames[stage]);
+}
+
+QString GLC_RenderProfiler::counterName(Counter counter)
+{
+    Q_ASSERT(counter < CounterCount);
+    return QString(counterNames[counter]);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_RenderProfiler::setActivationFlag(bool flag)
+{
+    m_IsActivated= flag;
+    if (m_IsActivated && !m_Clock.isValid())
+    {
+        m_Clock.start();
+    }
+    if (!m_IsActivated)
+    {
+        m_IsRecording= false;
+    }
+}
+
+void GLC_RenderProfiler::setFrameHistorySize(int size)
+{
+    m_FrameHistorySize= qMax(1, size);
+    clear();
+}
+
+void GLC_RenderProfiler::beginFrame()
+{
+    m_IsRecording= m_IsActivated;
+    if (m_IsRecording)
+    {
+        m_CurrentFrame= FrameStatistics();
+        m_CurrentFrame.m_FrameNumber= m_FrameCount++;
+        m_CurrentFrame.m_Start= m_Clock.nsecsElapsed();
+        m_pRecordingThread= QThread::currentThread();
+        pCurrentTimer= nullptr;
+    }
+}
+
+void GLC_RenderProfiler::endFrame()
+{
+    if (m_IsRecording)
+    {
+        m_IsRecording= false;
+        m_CurrentFrame.m_Duration= m_Clock.nsecsElapsed() - m_CurrentFrame.m_Start;
+
+        if (m_Frames.size() < m_FrameHistorySize)
+        {
+            m_Frames.append(m_CurrentFrame);
+        }
+        else
+        {
+            m_Frames[m_NextFrameIndex]= m_CurrentFrame;
+        }
+        m_NextFrameIndex= (m_NextFrameIndex + 1) % m_FrameHistorySize;
+        m_CurrentFrame.m_TraceEvents.clear();
+    }
+}
+
+void GLC_RenderProfiler::clear()
+{
+    m_Frames.clear();
+    m_NextFrameIndex= 0;
+}
@@ -0,0 +1,271 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_renderprofiler.h interface for the GLC_RenderProfiler class.
+
+#ifndef GLC_RENDERPROFILER_H_
+#define GLC_RENDERPROFILER_H_
+
+#include <QElapsedTimer>
+#include <QVector>
+#include <QList>
+#include <QString>
+#include <QByteArray>
+
+#include "glc_config.h"
+
+class QThread;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_RenderProfiler
+/*! \brief GLC_RenderProfiler : Per frame render timings and counters*/
+
+/*! The profiler records, between beginFrame() and endFrame() :
+ *  - The time spent in each render stage with GLC_RenderProfiler::ScopedTimer
+ *  - Counters of draw calls, material changes, viewable and culled instances,
+ *    issued and filtered state changes (See GLC_RenderStateCache)...
+ *  - The histogram of chosen level of details
+ *
+ *  Stage times are self times : the time of nested stages (Material in Draw...)
+ *  is not counted in the enclosing stage.
+ *  The last frameHistorySize() frames are kept and can be exported in JSON
+ *  or in the Chrome trace event format (chrome://tracing, Perfetto).
+ *
+ *  GLC_ViewHandler::render() begins and ends a frame, the profiler must only be used
+ *  from the thread which begins the frame (the rendering thread) : frame statistics are not locked.
+ *  The chain of nested scoped timers is thread local and scoped timers assert the rendering thread
+ *  in debug. When the profiler is not activated the cost of instrumentation is a boolean test.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_RenderProfiler
+{
+public:
+    //! Profiled render stages
+    enum Stage
+    {
+        CullingStage= 0,
+        LodSelectionStage,
+        TraversalStage,
+        MaterialStage,
+        DrawStage,
+        StageCount
+    };
+
+    //! Profiled counters
+    enum Counter
+    {
+        DrawCallCounter= 0,
+        MaterialChangeCounter,
+        ViewableInstanceCounter,
+        CulledInstanceCounter,
+        BodyCounter,
+        TriangleCounter,
+        IssuedStateChangeCounter,
+        FilteredStateChangeCounter,
+        OccludedInstanceCounter,
+        CounterCount
+    };
+
+    //! Number of bins of the level of detail histogram
+    /*! Bin i counts LOD in [i * 10, i * 10 + 9], the last bin counts pixel culled bodies*/
+    enum {LodBinCount= 12};
+
+    //! A timed stage occurrence
+    struct TraceEvent
+    {
+        Stage m_Stage;
+        //! Start time in nanoseconds
+        qint64 m_Start;
+        //! Duration in nanoseconds
+        qint64 m_Duration;
+    };
+
+    //! Statistics of a frame
+    struct FrameStatistics
+    {
+        FrameStatistics();
+
+        //! The frame number
+        quint64 m_FrameNumber;
+        //! Frame start time in nanoseconds
+        qint64 m_Start;
+        //! Frame duration in nanoseconds
+        qint64 m_Duration;
+        //! Self time of each stage in nanoseconds
+        qint64 m_StageTime[StageCount];
+        //! Number of timed scopes of each stage
+        quint64 m_StageCalls[StageCount];
+        //! Counter values
+        quint64 m_Counters[CounterCount];
+        //! Level of detail histogram
+        quint64 m_LodHistogram[LodBinCount];
+        //! Timed scopes, limited to maximumTraceEventCount()
+        QVector<TraceEvent> m_TraceEvents;
+    };
+
+    //! Time the enclosing scope as the given stage
+    class GLC_LIB_EXPORT ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Stage stage)
+            : m_Stage(stage)
+            , m_Start(-1)
+            , m_ChildTime(0)
+            , m_pParent(nullptr)
+        {if (GLC_RenderProfiler::isRecording()) start();}
+
+        ~ScopedTimer()
+        {if (m_Start >= 0) stop();}
+
+    private:
+        void start();
+        void stop();
+
+    private:
+        Stage m_Stage;
+        qint64 m_Start;
+        qint64 m_ChildTime;
+        ScopedTimer* m_pParent;
+
+        Q_DISABLE_COPY(ScopedTimer)
+    };
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Private constructor. This class is static only
+    GLC_RenderProfiler();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return true if the profiler is activated
+    static bool activated()
+    {return m_IsActivated;}
+
+    //! Return true if the profiler is activated and a frame is begun
+    static bool isRecording()
+    {return m_IsRecording;}
+
+    //! Return the number of frames kept by the profiler
+    static int frameHistorySize()
+    {return m_FrameHistorySize;}
+
+    //! Return the maximum number of trace events recorded per frame
+    static int maximumTraceEventCount()
+    {return m_MaximumTraceEventCount;}
+
+    //! Return the recorded frames, oldest first
+    static QList<FrameStatistics> frames();
+
+    //! Return the last recorded frame
+    /*! Return an empty frame if there is no recorded frame*/
+    static FrameStatistics lastFrame();
+
+    //! Return the recorded frames in JSON
+    static QByteArray toJson();
+
+    //! Return the recorded frames in the Chrome trace event format
+    static QByteArray toChromeTrace();
+
+    //! Return the name of the given stage
+    static QString stageName(Stage stage);
+
+    //! Return the name of the given counter
+    static QString counterName(Counter counter);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Set activation flag to the given flag
+    static void setActivationFlag(bool flag);
+
+    //! Set the number of frames kept by the profiler
+    /*! Recorded frames are cleared*/
+    static void setFrameHistorySize(int size);
+
+    //! Set the maximum number of trace events recorded per frame
+    static void setMaximumTraceEventCount(int count)
+    {m_MaximumTraceEventCount= qMax(0, count);}
+
+    //! Begin a new frame
+    static void beginFrame();
+
+    //! End the current frame and add it to the frame history
+    static void endFrame();
+
+    //! Clear the recorded frames
+    static void clear();
+
+    //! Add the given value to the given counter of the current frame
+    static void addCount(Counter counter, quint64 value= 1)
+    {if (m_IsRecording) m_CurrentFrame.m_Counters[counter]+= value;}
+
+    //! Add the given level of detail to the histogram of the current frame
+    static void addLod(int lod)
+    {if (m_IsRecording) m_CurrentFrame.m_LodHistogram[qBound(0, lod / 10, LodBinCount - 1)]+= 1;}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Flag to know if the profiler is activated
+    static bool m_IsActivated;
+
+    //! Flag to know if the current frame is recorded
+    static bool m_IsRecording;
+
+    //! The profiler clock
+    static QElapsedTimer m_Clock;
+
+    //! The frame being recorded
+    static FrameStatistics m_CurrentFrame;
+
+    //! The thread which has begun the current frame
+    static QThread* m_pRecordingThread;
+
+    //! Frame ring buffer
+    static QVector<FrameStatistics> m_Frames;
+
+    //! Index of the next frame in the ring buffer
+    static int m_NextFrameIndex;
+
+    //! Number of frames kept
+    static int m_FrameHistorySize;
+
+    //! Maximum number of trace events per frame
+    static int m_MaximumTraceEventCount;
+
+    //! Frame counter
+    static quint64 m_FrameCount;
+};
+
+#endif /* GLC_RENDERPROFILER_H_ */
@@ -0,0 +1,248 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_renderstatecache.cpp implementation of the GLC_RenderStateCache class.
+
+#include <QOpenGLShaderProgram>
+
+#include "glc_renderstatecache.h"
+#include "glc_context.h"
+#include "glc_openglexception.h"
+#include "glc_renderprofiler.h"
+#include "shading/glc_texture.h"
+
+bool GLC_RenderStateCache::m_FilteringIsEnabled= true;
+bool GLC_RenderStateCache::m_ErrorCheckingIsEnabled= false;
+
+GLC_RenderStateCache::GLC_RenderStateCache()
+    : m_Capabilities()
+    , m_BoundTexture(0)
+    , m_BoundTextureIsValid(false)
+    , m_MaterialRevision(0)
+    , m_MaterialTexture(0)
+    , m_MaterialProgram(0)
+    , m_MaterialOpacity(-1.0f)
+    , m_MaterialIsValid(false)
+    , m_Uniforms()
+    , m_IssuedCallCount(0)
+    , m_FilteredCallCount(0)
+{
+
+}
+
+GLC_RenderStateCache::~GLC_RenderStateCache()
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+GLC_RenderStateCache* GLC_RenderStateCache::current()
+{
+    GLC_Context* pContext= GLC_Context::current();
+    Q_ASSERT(nullptr != pContext);
+
+    return pContext->renderStateCache();
+}
+
+bool GLC_RenderStateCache::isEnabled(GLenum capability)
+{
+    QHash<GLenum, bool>::const_iterator iCapability= m_Capabilities.constFind(capability);
+    bool subject;
+    if (iCapability != m_Capabilities.constEnd())
+    {
+        subject= iCapability.value();
+    }
+    else
+    {
+        subject= (GL_TRUE == glIsEnabled(capability));
+        m_Capabilities.insert(capability, subject);
+    }
+
+    return subject;
+}
+
+bool GLC_RenderStateCache::materialIsCurrent(GLC_uint materialRevision, GLuint textureId, GLuint programId, GLfloat opacity)
+{
+    const bool subject= m_FilteringIsEnabled && m_MaterialIsValid
+            && (materialRevision == m_MaterialRevision)
+            && (textureId == m_MaterialTexture)
+            && (programId == m_MaterialProgram)
+            && (opacity == m_MaterialOpacity);
+
+    if (subject) addCall(false);
+
+    return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_RenderStateCache::setFilteringEnabled(bool enabled)
+{
+    m_FilteringIsEnabled= enabled;
+}
+
+void GLC_RenderStateCache::setErrorCheckingEnabled(bool enabled)
+{
+    m_ErrorCheckingIsEnabled= enabled;
+}
+
+void GLC_RenderStateCache::invalidate()
+{
+    m_Capabilities.clear();
+    m_BoundTextureIsValid= false;
+    m_MaterialIsValid= false;
+    m_Uniforms.clear();
+}
+
+void GLC_RenderStateCache::resetCounters()
+{
+    m_IssuedCallCount= 0;
+    m_FilteredCallCount= 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// OpenGL Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_RenderStateCache::glcSetCapability(GLenum capability, bool enable)
+{
+    QHash<GLenum, bool>::iterator iCapability= m_Capabilities.find(capability);
+    if (m_FilteringIsEnabled && (iCapability != m_Capabilities.end()) && (iCapability.value() == enable))
+    {
+        addCall(false);
+    }
+    else
+    {
+        if (enable) glEnable(capability);
+        else glDisable(capability);
+
+        if (iCapability != m_Capabilities.end()) iCapability.value()= enable;
+        else m_Capabilities.insert(capability, enable);
+
+        // The material enables or disables texturing
+        if (GL_TEXTURE_2D == capability) m_MaterialIsValid= false;
+
+        addCall(true);
+    }
+}
+
+void GLC_RenderStateCache::glcBindTexture(GLC_Texture* pTexture)
+{
+    Q_ASSERT(nullptr != pTexture);
+    const GLuint textureId= pTexture->textureId();
+
+    // Texture id is 0 until the texture is loaded
+    if (m_FilteringIsEnabled && m_BoundTextureIsValid && (0 != textureId) && (textureId == m_BoundTexture))
+    {
+        addCall(false);
+    }
+    else
+    {
+        pTexture->glcBindTexture();
+        m_BoundTexture= pTexture->textureId();
+        m_BoundTextureIsValid= true;
+        m_MaterialIsValid= false;
+        addCall(true);
+    }
+}
+
+void GLC_RenderStateCache::setCurrentMaterial(GLC_uint materialRevision, GLuint textureId, GLuint programId, GLfloat opacity)
+{
+    m_MaterialRevision= materialRevision;
+    m_MaterialTexture= textureId;
+    m_MaterialProgram= programId;
+    m_MaterialOpacity= opacity;
+    m_MaterialIsValid= true;
+    addCall(true);
+}
+
+void GLC_RenderStateCache::glcSetUniformValue(QOpenGLShaderProgram* pProgram, const char* name, GLint value)
+{
+    Q_ASSERT(nullptr != pProgram);
+    QVector<UniformValue>& uniforms= m_Uniforms[pProgram->programId()];
+
+    // Programs have a few uniforms set through the cache
+    UniformValue* pUniform= nullptr;
+    const int uniformCount= uniforms.size();
+    for (int i= 0; (i < uniformCount) && (nullptr == pUniform); ++i)
+    {
+        if (uniforms.at(i).m_Name == name) pUniform= &(uniforms[i]);
+    }
+
+    if (nullptr == pUniform)
+    {
+        UniformValue uniform;
+        uniform.m_Name= name;
+        uniform.m_Location= pProgram->uniformLocation(name);
+        uniform.m_Value= value;
+        uniforms.append(uniform);
+
+        pProgram->setUniformValue(uniform.m_Location, value);
+        addCall(true);
+    }
+    else if (m_FilteringIsEnabled && (pUniform->m_Value == value))
+    {
+        addCall(false);
+    }
+    else
+    {
+        pUniform->m_Value= value;
+        pProgram->setUniformValue(pUniform->m_Location, value);
+        addCall(true);
+    }
+}
+
+void GLC_RenderStateCache::glcCheckError(const QString& location)
+{
+    if (m_ErrorCheckingIsEnabled)
+    {
+        const GLenum error= glGetError();
+        if (error != GL_NO_ERROR)
+        {
+            GLC_OpenGlException openGlException(location, error);
+            throw(openGlException);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_RenderStateCache::addCall(bool issued)
+{
+    if (issued)
+    {
+        ++m_IssuedCallCount;
+        GLC_RenderProfiler::addCount(GLC_RenderProfiler::IssuedStateChangeCounter);
+    }
+    else
+    {
+        ++m_FilteredCallCount;
+        GLC_RenderProfiler::addCount(GLC_RenderProfiler::FilteredStateChangeCounter);
+    }
+}
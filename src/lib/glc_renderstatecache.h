@@ -0,0 +1,211 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_renderstatecache.h interface for the GLC_RenderStateCache class.
+
+#ifndef GLC_RENDERSTATECACHE_H_
+#define GLC_RENDERSTATECACHE_H_
+
+#include <QtOpenGL>
+#include <QHash>
+#include <QVector>
+#include <QByteArray>
+#include <QString>
+
+#include "glc_global.h"
+
+#include "glc_config.h"
+
+class GLC_Texture;
+class QOpenGLShaderProgram;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_RenderStateCache
+/*! \brief GLC_RenderStateCache : Shadow of the OpenGL state of a GLC_Context*/
+
+/*! The cache keeps the last value sent to OpenGL for :
+ *  - Enabled capabilities (GL_TEXTURE_2D...)
+ *  - The texture bound to the active texture unit
+ *  - The current GLC_Material
+ *  - Integer uniform values of each shader program
+ *
+ *  Requests which do not change the shadowed state are dropped and counted
+ *  as filtered, the others are sent to OpenGL and counted as issued.
+ *
+ *  There is one cache per GLC_Context, see GLC_Context::renderStateCache().
+ *  The cache is invalidated at the beginning of each frame by GLC_ViewHandler::render()
+ *  and GLC_Viewport::glExecuteCam(). Applications which render without them must call
+ *  invalidate() at the beginning of each frame.
+ *  Code which changes the shadowed state without the cache (glPopAttrib, QPainter,
+ *  direct glColor or glMaterial calls...) must call invalidate() or invalidateMaterial().
+ *
+ *  OpenGL error checking is an opt-in debug mode, see setErrorCheckingEnabled().*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_RenderStateCache
+{
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    GLC_RenderStateCache();
+    ~GLC_RenderStateCache();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the render state cache of the current GLC_Context
+    static GLC_RenderStateCache* current();
+
+    //! Return true if redundant requests are filtered
+    static bool filteringIsEnabled()
+    {return m_FilteringIsEnabled;}
+
+    //! Return true if OpenGL errors are checked after state changes
+    static bool errorCheckingIsEnabled()
+    {return m_ErrorCheckingIsEnabled;}
+
+    //! Return true if the given capability is enabled
+    /*! Unknown capabilities are queried to OpenGL*/
+    bool isEnabled(GLenum capability);
+
+    //! Return true if the material of the given key is the current one
+    /*! The key is made of the state revision of the material, of its texture id,
+     *  of the current shader program id and of the overwritten opacity (-1 if not overwritten).
+     *  Count a filtered call if it's the case.*/
+    bool materialIsCurrent(GLC_uint materialRevision, GLuint textureId, GLuint programId, GLfloat opacity);
+
+    //! Return the number of requests sent to OpenGL since the last resetCounters()
+    inline quint64 issuedCallCount() const
+    {return m_IssuedCallCount;}
+
+    //! Return the number of dropped requests since the last resetCounters()
+    inline quint64 filteredCallCount() const
+    {return m_FilteredCallCount;}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Set filtering of redundant requests enabled (Enabled by default)
+    static void setFilteringEnabled(bool enabled);
+
+    //! Set OpenGL error checking enabled (Disabled by default)
+    static void setErrorCheckingEnabled(bool enabled);
+
+    //! Forget the shadowed state, the next requests are sent to OpenGL
+    void invalidate();
+
+    //! Forget the current material
+    inline void invalidateMaterial()
+    {m_MaterialIsValid= false;}
+
+    //! Reset issued and filtered counters
+    void resetCounters();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name OpenGL Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Enable or disable the given capability
+    void glcSetCapability(GLenum capability, bool enable);
+
+    //! Enable the given capability
+    inline void glcEnable(GLenum capability)
+    {glcSetCapability(capability, true);}
+
+    //! Disable the given capability
+    inline void glcDisable(GLenum capability)
+    {glcSetCapability(capability, false);}
+
+    //! Bind the given texture to the active texture unit
+    void glcBindTexture(GLC_Texture* pTexture);
+
+    //! Set the current material key, see materialIsCurrent()
+    /*! Must be called after the material has been sent to OpenGL*/
+    void setCurrentMaterial(GLC_uint materialRevision, GLuint textureId, GLuint programId, GLfloat opacity);
+
+    //! Set the integer uniform of the given name of the given shader program
+    void glcSetUniformValue(QOpenGLShaderProgram* pProgram, const char* name, GLint value);
+
+    //! Throw a GLC_OpenGlException if error checking is enabled and an OpenGL error occurred
+    static void glcCheckError(const QString& location);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Update counters of a request
+    void addCall(bool issued);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Shadowed uniform of a shader program
+    struct UniformValue
+    {
+        QByteArray m_Name;
+        GLint m_Location;
+        GLint m_Value;
+    };
+
+    //! Shadowed capabilities
+    QHash<GLenum, bool> m_Capabilities;
+
+    //! Bound texture
+    GLuint m_BoundTexture;
+    bool m_BoundTextureIsValid;
+
+    //! Current material key
+    GLC_uint m_MaterialRevision;
+    GLuint m_MaterialTexture;
+    GLuint m_MaterialProgram;
+    GLfloat m_MaterialOpacity;
+    bool m_MaterialIsValid;
+
+    //! Shadowed uniforms of each shader program id
+    QHash<GLuint, QVector<UniformValue> > m_Uniforms;
+
+    //! Counters
+    quint64 m_IssuedCallCount;
+    quint64 m_FilteredCallCount;
+
+    //! Filtering and error checking flags
+    static bool m_FilteringIsEnabled;
+    static bool m_ErrorCheckingIsEnabled;
+
+    Q_DISABLE_COPY(GLC_RenderStateCache)
+};
+
+#endif /* GLC_RENDERSTATECACHE_H_ */
@@ -50,6 +50,8 @@ GLC_CacheManager GLC_State::m_CacheManager;
 
 bool GLC_State::m_IsSpacePartitionningActivated= false;
 bool GLC_State::m_IsFrustumCullingActivated= false;
+bool GLC_State::m_IsParallelCullingActivated= true;
+bool GLC_State::m_IsCsgOverlapCullingActivated= true;
 bool GLC_State::m_IsValid= false;
 
 double GLC_State::m_DevicePixelRatio= 1.0;
@@ -149,6 +151,16 @@ bool GLC_State::isFrustumCullingActivated()
     return m_IsFrustumCullingActivated;
 }
 
+bool GLC_State::isParallelCullingActivated()
+{
+    return m_IsParallelCullingActivated;
+}
+
+bool GLC_State::isCsgOverlapCullingActivated()
+{
+    return m_IsCsgOverlapCullingActivated;
+}
+
 void GLC_State::init()
 {
     if (!m_IsValid)
@@ -256,6 +268,16 @@ void GLC_State::setFrustumCullingUsage(bool usage)
     m_IsFrustumCullingActivated= usage;
 }
 
+void GLC_State::setParallelCullingUsage(bool usage)
+{
+    m_IsParallelCullingActivated= usage;
+}
+
+void GLC_State::setCsgOverlapCullingUsage(bool usage)
+{
+    m_IsCsgOverlapCullingActivated= usage;
+}
+
 void GLC_State::setGlobalDevicePixelRatio(double value)
 {
     m_DevicePixelRatio= value;
@@ -98,6 +98,12 @@ public:
 	//! Return true if frustum culling is activated
 	static bool isFrustumCullingActivated();
 
+	//! Return true if frustum culling and LOD selection use worker threads
+	static bool isParallelCullingActivated();
+
+	//! Return true if CSG operations only evaluate the triangles of the overlap of their operands
+	static bool isCsgOverlapCullingActivated();
+
 	//! Return true valid
 	static bool isValid();
 
@@ -154,6 +160,12 @@ public:
 	//! Set the frustum culling usage
 	static void setFrustumCullingUsage(bool);
 
+	//! Set the worker threads usage of frustum culling and LOD selection
+	static void setParallelCullingUsage(bool);
+
+	//! Set the usage of the overlap culling of CSG operations
+	static void setCsgOverlapCullingUsage(bool);
+
     static void setGlobalDevicePixelRatio(double value);
 
     static void setGlobalDevicePixelRatioEnableState(bool value);
@@ -203,6 +215,12 @@ private:
 	//! Frustum culling activated
 	static bool m_IsFrustumCullingActivated;
 
+	//! Parallel frustum culling and LOD selection activated
+	static bool m_IsParallelCullingActivated;
+
+	//! CSG overlap culling activated
+	static bool m_IsCsgOverlapCullingActivated;
+
 	//! Frame buffer supported
 	static bool m_IsFrameBufferSupported;
 
@@ -29,6 +29,8 @@
 
 
 GLC_UniformShaderData::GLC_UniformShaderData()
+    : m_MatricesAreValid(false)
+    , m_MatricesProgramId(0)
 {
 
 }
@@ -80,43 +82,28 @@ void GLC_UniformShaderData::setLightsEnableState(QVector<int> &lightsEnableState
 
 void GLC_UniformShaderData::setModelViewProjectionMatrix(const GLC_Matrix4x4& modelView, const GLC_Matrix4x4& projection)
 {
-	// Set model view matrix
-	const double* pMvmatrixData= modelView.getData();
-	GLfloat mvFloatMatrix[4][4];
-	GLfloat* pData= &(mvFloatMatrix[0][0]);
-	for (int i= 0; i < 16; ++i)
-	{
-		pData[i]= static_cast<GLfloat>(pMvmatrixData[i]);
-	}
-
-	// Set model view projection matrix
-	GLC_Matrix4x4 modelViewProjectionMatrix= projection * modelView;
-	const double* pMvpmatrixData= modelViewProjectionMatrix.getData();
-	GLfloat mvpFloatMatrix[4][4];
-	pData= &(mvpFloatMatrix[0][0]);
-	for (int i= 0; i < 16; ++i)
-	{
-		pData[i]= static_cast<GLfloat>(pMvpmatrixData[i]);
-	}
+	Q_ASSERT(GLC_Shader::hasActiveShader());
 
-	// Set the transpose of inv model view matrix (For normal computation)
-	GLC_Matrix4x4 invTransposeModelView= modelView.inverted();
-	invTransposeModelView.transpose();
-	GLfloat invTmdv[3][3];
-	{
-		const double* data= invTransposeModelView.getData();
+	computeModelViewMatrices(modelView);
+	computeMvpMatrix(modelView, projection);
+	m_MatricesAreValid= true;
 
-		invTmdv[0][0]= static_cast<GLfloat>(data[0]); invTmdv[1][0]= static_cast<GLfloat>(data[4]); invTmdv[2][0]= static_cast<GLfloat>(data[8]);
-		invTmdv[0][1]= static_cast<GLfloat>(data[1]); invTmdv[1][1]= static_cast<GLfloat>(data[5]); invTmdv[2][1]= static_cast<GLfloat>(data[9]);
-		invTmdv[0][2]= static_cast<GLfloat>(data[2]); invTmdv[1][2]= static_cast<GLfloat>(data[6]); invTmdv[2][2]= static_cast<GLfloat>(data[10]);
-	}
+	sendMatrices(true, true);
+}
 
+void GLC_UniformShaderData::updateMatrices(const GLC_Matrix4x4& modelView, bool modelViewChanged, const GLC_Matrix4x4& projection, bool projectionChanged)
+{
 	Q_ASSERT(GLC_Shader::hasActiveShader());
 
-	GLC_Shader* pCurrentShader= GLC_Shader::currentShaderHandle();
-	pCurrentShader->programShaderHandle()->setUniformValue(pCurrentShader->modelViewLocationId(), mvFloatMatrix);
-	pCurrentShader->programShaderHandle()->setUniformValue(pCurrentShader->mvpLocationId(), mvpFloatMatrix);
-	pCurrentShader->programShaderHandle()->setUniformValue(pCurrentShader->invModelViewLocationId(), invTmdv);
+	modelViewChanged= modelViewChanged || !m_MatricesAreValid;
+	const bool mvpChanged= modelViewChanged || projectionChanged;
+	if (modelViewChanged) computeModelViewMatrices(modelView);
+	if (mvpChanged) computeMvpMatrix(modelView, projection);
+	m_MatricesAreValid= true;
+
+	// Uniforms are stored by the program, a program which has not received the current matrices needs all of them
+	const bool programChanged= (GLC_Shader::currentShaderHandle()->programShaderHandle()->programId() != m_MatricesProgramId);
+	sendMatrices(modelViewChanged || programChanged, mvpChanged || programChanged);
 }
 
 void GLC_UniformShaderData::updateAll(const GLC_Context* pContext)
@@ -129,3 +116,91 @@ void GLC_UniformShaderData::updateAll(const GLC_Context* pContext)
     QVector<int> enableLightState= pContext->enableLights();
     setLightsEnableState(enableLightState);
 }
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_UniformShaderData::computeModelViewMatrices(const GLC_Matrix4x4& modelView)
+{
+	const double* pData= modelView.getData();
+	GLfloat* pFloatData= &(m_ModelViewMatrix[0][0]);
+	for (int i= 0; i < 16; ++i)
+	{
+		pFloatData[i]= static_cast<GLfloat>(pData[i]);
+	}
+
+	// m_NormalMatrix[i][j] is the element (j, i) of the transpose of the inverse
+	if (modelView.type() == GLC_Matrix4x4::Identity)
+	{
+		m_NormalMatrix[0][0]= 1.0f; m_NormalMatrix[1][0]= 0.0f; m_NormalMatrix[2][0]= 0.0f;
+		m_NormalMatrix[0][1]= 0.0f; m_NormalMatrix[1][1]= 1.0f; m_NormalMatrix[2][1]= 0.0f;
+		m_NormalMatrix[0][2]= 0.0f; m_NormalMatrix[1][2]= 0.0f; m_NormalMatrix[2][2]= 1.0f;
+	}
+	else if (modelView.isAffine())
+	{
+		// The transpose of the inverse of the linear part is its co-matrix divided by the determinant
+		const double c00= pData[5] * pData[10] - pData[9] * pData[6];
+		const double c01= pData[9] * pData[2] - pData[1] * pData[10];
+		const double c02= pData[1] * pData[6] - pData[5] * pData[2];
+		const double c10= pData[8] * pData[6] - pData[4] * pData[10];
+		const double c11= pData[0] * pData[10] - pData[8] * pData[2];
+		const double c12= pData[4] * pData[2] - pData[0] * pData[6];
+		const double c20= pData[4] * pData[9] - pData[8] * pData[5];
+		const double c21= pData[8] * pData[1] - pData[0] * pData[9];
+		const double c22= pData[0] * pData[5] - pData[4] * pData[1];
+		const double det= pData[0] * c00 + pData[4] * c01 + pData[8] * c02;
+
+		if (det != 0.0)
+		{
+			const double invDet= 1.0 / det;
+			m_NormalMatrix[0][0]= static_cast<GLfloat>(c00 * invDet); m_NormalMatrix[1][0]= static_cast<GLfloat>(c01 * invDet); m_NormalMatrix[2][0]= static_cast<GLfloat>(c02 * invDet);
+			m_NormalMatrix[0][1]= static_cast<GLfloat>(c10 * invDet); m_NormalMatrix[1][1]= static_cast<GLfloat>(c11 * invDet); m_NormalMatrix[2][1]= static_cast<GLfloat>(c12 * invDet);
+			m_NormalMatrix[0][2]= static_cast<GLfloat>(c20 * invDet); m_NormalMatrix[1][2]= static_cast<GLfloat>(c21 * invDet); m_NormalMatrix[2][2]= static_cast<GLfloat>(c22 * invDet);
+		}
+		else
+		{
+			// Not invertible, use the transpose of the linear part like GLC_Matrix4x4::invert()
+			m_NormalMatrix[0][0]= pFloatData[0]; m_NormalMatrix[1][0]= pFloatData[1]; m_NormalMatrix[2][0]= pFloatData[2];
+			m_NormalMatrix[0][1]= pFloatData[4]; m_NormalMatrix[1][1]= pFloatData[5]; m_NormalMatrix[2][1]= pFloatData[6];
+			m_NormalMatrix[0][2]= pFloatData[8]; m_NormalMatrix[1][2]= pFloatData[9]; m_NormalMatrix[2][2]= pFloatData[10];
+		}
+	}
+	else
+	{
+		GLC_Matrix4x4 invTransposeModelView= modelView.inverted();
+		invTransposeModelView.transpose();
+		const double* data= invTransposeModelView.getData();
+
+		m_NormalMatrix[0][0]= static_cast<GLfloat>(data[0]); m_NormalMatrix[1][0]= static_cast<GLfloat>(data[4]); m_NormalMatrix[2][0]= static_cast<GLfloat>(data[8]);
+		m_NormalMatrix[0][1]= static_cast<GLfloat>(data[1]); m_NormalMatrix[1][1]= static_cast<GLfloat>(data[5]); m_NormalMatrix[2][1]= static_cast<GLfloat>(data[9]);
+		m_NormalMatrix[0][2]= static_cast<GLfloat>(data[2]); m_NormalMatrix[1][2]= static_cast<GLfloat>(data[6]); m_NormalMatrix[2][2]= static_cast<GLfloat>(data[10]);
+	}
+}
+
+void GLC_UniformShaderData::computeMvpMatrix(const GLC_Matrix4x4& modelView, const GLC_Matrix4x4& projection)
+{
+	const GLC_Matrix4x4 modelViewProjectionMatrix= projection * modelView;
+	const double* pData= modelViewProjectionMatrix.getData();
+	GLfloat* pFloatData= &(m_MvpMatrix[0][0]);
+	for (int i= 0; i < 16; ++i)
+	{
+		pFloatData[i]= static_cast<GLfloat>(pData[i]);
+	}
+}
+
+void GLC_UniformShaderData::sendMatrices(bool sendModelView, bool sendMvp)
+{
+	GLC_Shader* pCurrentShader= GLC_Shader::currentShaderHandle();
+	QOpenGLShaderProgram* pProgram= pCurrentShader->programShaderHandle();
+	if (sendModelView)
+	{
+		pProgram->setUniformValue(pCurrentShader->modelViewLocationId(), m_ModelViewMatrix);
+		pProgram->setUniformValue(pCurrentShader->invModelViewLocationId(), m_NormalMatrix);
+	}
+	if (sendMvp)
+	{
+		pProgram->setUniformValue(pCurrentShader->mvpLocationId(), m_MvpMatrix);
+	}
+	m_MatricesProgramId= pProgram->programId();
+}
@@ -59,16 +59,47 @@ public:
 	//! Set the model view matrix
 	void setModelViewProjectionMatrix(const GLC_Matrix4x4& modelView, const GLC_Matrix4x4& projection);
 
+	//! Update the matrix uniforms of the current shader
+	/*! Derived matrices (Model view projection and normal matrix) are only computed
+	 *  for changed matrices and uniforms are only sent if a matrix or the shader has changed*/
+	void updateMatrices(const GLC_Matrix4x4& modelView, bool modelViewChanged, const GLC_Matrix4x4& projection, bool projectionChanged);
+
 	//! Update all uniform variables
 	void updateAll(const GLC_Context* pContext);
 
 //@}
 
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Compute the float model view matrix and the normal matrix
+	void computeModelViewMatrices(const GLC_Matrix4x4& modelView);
+
+	//! Compute the float model view projection matrix
+	void computeMvpMatrix(const GLC_Matrix4x4& modelView, const GLC_Matrix4x4& projection);
+
+	//! Send the matrix uniforms to the current shader
+	void sendMatrices(bool sendModelView, bool sendMvp);
+
 //////////////////////////////////////////////////////////////////////
 // private members
 //////////////////////////////////////////////////////////////////////
 private:
+	//! Float copy of the model view matrix
+	GLfloat m_ModelViewMatrix[4][4];
+
+	//! Float copy of the model view projection matrix
+	GLfloat m_MvpMatrix[4][4];
+
+	//! Transpose of the inverse of the model view matrix (For normal computation)
+	GLfloat m_NormalMatrix[3][3];
+
+	//! True if float matrices have been computed
+	bool m_MatricesAreValid;
 
+	//! Id of the shader program which has received the matrix uniforms
+	GLuint m_MatricesProgramId;
 };
 
 #endif /* GLC_UNIFORMSHADERDATA_H_ */
@@ -23,6 +23,7 @@
 //! \file glc_3dstoworld.cpp implementation of the GLC_3dsToWorld class.
 
 #include "glc_3dstoworld.h"
+#include "glc_inputdata.h"
 
 #include "../geometry/glc_mesh.h"
 #include "../sceneGraph/glc_world.h"
@@ -36,9 +37,88 @@
 #include "3rdparty/lib3ds/mesh.h"
 #include "3rdparty/lib3ds/node.h"
 #include "3rdparty/lib3ds/material.h"
+#include "3rdparty/lib3ds/io.h"
 
 #include <QFileInfo>
 
+#include <climits>
+#include <cstring>
+
+namespace
+{
+    //! The input data read by lib3ds
+    struct InputDataIo
+    {
+        const char* m_pData;
+        long m_Size;
+        long m_Pos;
+    };
+
+    Lib3dsBool inputDataErrorFunc(void*)
+    {
+        return LIB3DS_FALSE;
+    }
+
+    long inputDataSeekFunc(void* self, long offset, Lib3dsIoSeek origin)
+    {
+        InputDataIo* pIo= static_cast<InputDataIo*>(self);
+        long pos= offset;
+        if (LIB3DS_SEEK_CUR == origin) pos+= pIo->m_Pos;
+        else if (LIB3DS_SEEK_END == origin) pos+= pIo->m_Size;
+
+        if ((pos < 0) || (pos > pIo->m_Size)) return -1;
+        pIo->m_Pos= pos;
+        return 0;
+    }
+
+    long inputDataTellFunc(void* self)
+    {
+        return static_cast<InputDataIo*>(self)->m_Pos;
+    }
+
+    size_t inputDataReadFunc(void* self, void* buffer, size_t size)
+    {
+        InputDataIo* pIo= static_cast<InputDataIo*>(self);
+        const size_t count= qMin(size, static_cast<size_t>(pIo->m_Size - pIo->m_Pos));
+        memcpy(buffer, pIo->m_pData + pIo->m_Pos, count);
+        pIo->m_Pos+= static_cast<long>(count);
+        return count;
+    }
+
+    size_t inputDataWriteFunc(void*, const void*, size_t)
+    {
+        return 0;
+    }
+
+    //! Load the 3ds file of the given data, return NULL on failure
+    Lib3dsFile* load3dsFile(const GLC_InputData& input)
+    {
+        if (input.size() > LONG_MAX) return NULL;
+
+        InputDataIo inputDataIo;
+        inputDataIo.m_pData= input.constData();
+        inputDataIo.m_Size= static_cast<long>(input.size());
+        inputDataIo.m_Pos= 0;
+
+        Lib3dsFile* pFile= lib3ds_file_new();
+        if (NULL == pFile) return NULL;
+        Lib3dsIo* pIo= lib3ds_io_new(&inputDataIo, inputDataErrorFunc, inputDataSeekFunc, inputDataTellFunc, inputDataReadFunc, inputDataWriteFunc);
+        if (NULL == pIo)
+        {
+            lib3ds_file_free(pFile);
+            return NULL;
+        }
+        if (!lib3ds_file_read(pFile, pIo))
+        {
+            lib3ds_file_free(pFile);
+            pFile= NULL;
+        }
+        lib3ds_io_free(pIo);
+
+        return pFile;
+    }
+}
+
 GLC_3dsToWorld::GLC_3dsToWorld()
 : m_pWorld(NULL)
 , m_FileName()
@@ -64,28 +144,33 @@ GLC_3dsToWorld::~GLC_3dsToWorld()
 // Create an GLC_World from an input 3DS File
 GLC_World* GLC_3dsToWorld::CreateWorldFrom3ds(QFile &file)
 {
-	clear();
-	m_FileName= file.fileName();
-
 	//////////////////////////////////////////////////////////////////
 	// Test if the file exist and can be opened
 	//////////////////////////////////////////////////////////////////
-	if (!file.open(QIODevice::ReadOnly))
+	const GLC_InputData input(GLC_InputData::fromDevice(&file));
+	if (input.isNull())
 	{
-		QString message(QString("GLC_3dsToWorld::CreateWorldFrom3ds File ") + m_FileName + QString(" doesn't exist"));
-		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotFound);
+		QString message(QString("GLC_3dsToWorld::CreateWorldFrom3ds File ") + file.fileName() + QString(" doesn't exist"));
+		GLC_FileFormatException fileFormatException(message, file.fileName(), GLC_FileFormatException::FileNotFound);
 		throw(fileFormatException);
 	}
-	// Close the file before open it with lib3ds
-	file.close();
+
+	return CreateWorldFrom3ds(input);
+}
+
+// Create an GLC_World from the given 3DS data
+GLC_World* GLC_3dsToWorld::CreateWorldFrom3ds(const GLC_InputData& input)
+{
+	clear();
+	m_FileName= input.fileName();
 
 	//////////////////////////////////////////////////////////////////
 	// Init member
 	//////////////////////////////////////////////////////////////////
 	m_pWorld= new GLC_World;
 
-	//Load 3ds File
-	m_pLib3dsFile=lib3ds_file_load(m_FileName.toLocal8Bit().data());
+	//Load 3ds data
+	m_pLib3dsFile= load3dsFile(input);
 	if (!m_pLib3dsFile)
 	{
 		QString message= "GLC_3dsToWorld::CreateWorldFrom3ds : Loading Failed";
@@ -41,6 +41,7 @@ class GLC_World;
 class GLC_Mesh;
 class GLC_StructOccurrence;
 class GLC_Material;
+class GLC_InputData;
 
 struct Lib3dsFile;
 struct Lib3dsNode;
@@ -83,6 +84,9 @@ public:
 	//! Create an GLC_World from an input 3DS File
 	GLC_World* CreateWorldFrom3ds(QFile &file);
 
+	//! Create an GLC_World from the given 3DS data, textures are searched next to the data file name
+	GLC_World* CreateWorldFrom3ds(const GLC_InputData& input);
+
 	//! Get the list of attached files
 	inline QStringList listOfAttachedFileName() const
     {return m_ListOfAttachedFileName.values();}
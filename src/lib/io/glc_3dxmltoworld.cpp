@@ -28,6 +28,7 @@
 #include "../geometry/glc_mesh.h"
 #include "../geometry/glc_3drep.h"
 #include "glc_xmlutil.h"
+#include "glc_inputdata.h"
 
 // Quazip library
 #include "../3rdparty/quazip/quazip.h"
@@ -35,6 +36,7 @@
 
 #include <QString>
 #include <QFileInfo>
+#include <QBuffer>
 #include <QSet>
 #include <QMutexLocker>
 
@@ -42,8 +44,6 @@
 
 QMutex GLC_3dxmlToWorld::m_ZipMutex;
 
-static qint64 chunckSize= 10000000;
-
 GLC_3dxmlToWorld::GLC_3dxmlToWorld()
     : QObject()
     , m_pStreamReader(NULL)
@@ -73,7 +73,7 @@ GLC_3dxmlToWorld::GLC_3dxmlToWorld()
     , m_V3OccurrenceAttribHash()
     , m_V4OccurrenceAttribList()
     , m_GetExternalRef3DName(false)
-    , m_ByteArrayList()
+    , m_pInputBuffer(NULL)
     , m_IsVersion3(false)
     , m_UseZipMutex(true)
     , m_productGroupRootId(1)
@@ -89,6 +89,7 @@ GLC_3dxmlToWorld::~GLC_3dxmlToWorld()
 
 	delete m_pCurrentFile;
 	delete m_p3dxmlArchive;
+	delete m_pInputBuffer;
 
 	clearMaterialHash();
 
@@ -211,6 +212,19 @@ GLC_World* GLC_3dxmlToWorld::createWorldFrom3dxml(QIODevice* pDevice)
     return m_pWorld;
 }
 
+GLC_World* GLC_3dxmlToWorld::createWorldFrom3dxml(const GLC_InputData& input)
+{
+    // Close the archive which may use the previous buffer
+    clear();
+
+    // The archive reads the data without copy
+    delete m_pInputBuffer;
+    m_pInputBuffer= new QBuffer();
+    input.openBuffer(m_pInputBuffer);
+
+    return createWorldFrom3dxml(m_pInputBuffer);
+}
+
 // Create 3DRep from an 3DXML rep
 GLC_3DRep GLC_3dxmlToWorld::create3DrepFrom3dxmlRep(const QString& fileName, bool useZipMutex)
 {
@@ -342,7 +356,6 @@ void GLC_3dxmlToWorld::clear()
 	delete m_pStreamReader;
 	m_pStreamReader= NULL;
 
-	m_ByteArrayList.clear();
 	// Clear current file
 	if (NULL != m_pCurrentFile)
 	{
@@ -1495,7 +1508,6 @@ bool GLC_3dxmlToWorld::setStreamReaderToFile(QString fileName, bool test)
 	if (m_IsInArchive)
 	{
         if (m_UseZipMutex) m_ZipMutex.lock();
-		m_ByteArrayList.clear();
 		// Create QuaZip File
 		QuaZipFile* p3dxmlFile= new QuaZipFile(m_p3dxmlArchive);
 
@@ -1539,13 +1551,19 @@ bool GLC_3dxmlToWorld::setStreamReaderToFile(QString fileName, bool test)
 		// Set the stream reader
 		delete m_pStreamReader;
 
-		QByteArray currentByteArray;
-		while (!currentByteArray.isEmpty() || m_ByteArrayList.isEmpty())
+		// The entry is read once in a buffer shared with the stream reader
+		QByteArray entryData;
+		const qint64 entrySize= p3dxmlFile->usize();
+		if (entrySize >= 0)
+		{
+			entryData.resize(entrySize);
+			entryData.resize(qMax(Q_INT64_C(0), p3dxmlFile->read(entryData.data(), entrySize)));
+		}
+		else
 		{
-			currentByteArray= p3dxmlFile->read(chunckSize);
-			m_ByteArrayList.append(currentByteArray);
+			entryData= p3dxmlFile->readAll();
 		}
-		m_pStreamReader= new QXmlStreamReader(m_ByteArrayList.takeFirst());
+		m_pStreamReader= new QXmlStreamReader(entryData);
 		delete p3dxmlFile;
         if (m_UseZipMutex) m_ZipMutex.unlock();
 	}
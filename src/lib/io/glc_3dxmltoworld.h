@@ -37,8 +37,12 @@
 #include "../glc_config.h"
 
 class GLC_World;
+class GLC_InputData;
 class QuaZip;
 class QuaZipFile;
+QT_BEGIN_NAMESPACE
+class QBuffer;
+QT_END_NAMESPACE
 class GLC_StructReference;
 class GLC_StructInstance;
 class GLC_StructOccurrence;
@@ -152,6 +156,10 @@ public:
     //! Create an GLC_World from an input 3DXML File
     GLC_World* createWorldFrom3dxml(QIODevice* pDevice);
 
+    //! Create an GLC_World from the given compressed 3DXML data
+    /*! The archive is read in place, the data can be a part of a mapped container file.*/
+    GLC_World* createWorldFrom3dxml(const GLC_InputData& input);
+
 	//! Create 3DRep from an 3DXML rep
     GLC_3DRep create3DrepFrom3dxmlRep(const QString&, bool useZipMutex= true);
 
@@ -401,7 +409,8 @@ private:
 
 	static QMutex m_ZipMutex;
 
-	QList<QByteArray> m_ByteArrayList;
+	//! The buffer on the input data of the archive
+	QBuffer* m_pInputBuffer;
 
 	//! Flag to know if the 3DXML is in version 3.x
 	bool m_IsVersion3;
@@ -417,17 +426,7 @@ private:
 
 QXmlStreamReader::TokenType GLC_3dxmlToWorld::readNext()
 {
-	QXmlStreamReader::TokenType token= m_pStreamReader->readNext();
-	if (QXmlStreamReader::PrematureEndOfDocumentError == m_pStreamReader->error())
-	{
-		//qDebug() << "QXmlStreamReader::PrematureEndOfDocumentError == m_pStreamReader->error()";
-		if (!m_ByteArrayList.isEmpty())
-		{
-			m_pStreamReader->addData(m_ByteArrayList.takeFirst());
-			return readNext();
-		}
-	}
-	return token;
+	return m_pStreamReader->readNext();
 }
 
 bool GLC_3dxmlToWorld::goToElement(QXmlStreamReader* pReader, const QString& element)
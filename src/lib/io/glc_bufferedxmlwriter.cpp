@@ -0,0 +1,398 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_bufferedxmlwriter.cpp implementation of the GLC_BufferedXmlWriter class.
+
+#include <charconv>
+
+#include <QIODevice>
+
+#include "glc_bufferedxmlwriter.h"
+
+namespace
+{
+    // Default size of chunks written to the device
+    const int defaultChunkSize= 1 << 20;
+
+    // Number of spaces by indentation level, as QXmlStreamWriter
+    const int indentationSize= 4;
+}
+
+GLC_BufferedXmlWriter::GLC_BufferedXmlWriter()
+    : m_pDevice(nullptr)
+    , m_Buffer()
+    , m_ChunkSize(defaultChunkSize)
+    , m_AutoFormatting(false)
+    , m_IndentationOffset(0)
+    , m_ElementStack()
+    , m_InStartTag(false)
+    , m_InAttribute(false)
+    , m_HasContent(false)
+    , m_HasError(false)
+{
+
+}
+
+GLC_BufferedXmlWriter::GLC_BufferedXmlWriter(QIODevice* pDevice)
+    : m_pDevice(pDevice)
+    , m_Buffer()
+    , m_ChunkSize(defaultChunkSize)
+    , m_AutoFormatting(false)
+    , m_IndentationOffset(0)
+    , m_ElementStack()
+    , m_InStartTag(false)
+    , m_InAttribute(false)
+    , m_HasContent(false)
+    , m_HasError(false)
+{
+    m_Buffer.reserve(m_ChunkSize);
+}
+
+GLC_BufferedXmlWriter::GLC_BufferedXmlWriter(int indentationLevel)
+    : m_pDevice(nullptr)
+    , m_Buffer()
+    , m_ChunkSize(defaultChunkSize)
+    , m_AutoFormatting(true)
+    , m_IndentationOffset(qMax(0, indentationLevel))
+    , m_ElementStack()
+    , m_InStartTag(false)
+    , m_InAttribute(false)
+    , m_HasContent(indentationLevel > 0)
+    , m_HasError(false)
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_BufferedXmlWriter::appendFloat(QByteArray* pBuffer, float value)
+{
+#if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611L)
+    char text[32];
+    const std::to_chars_result result= std::to_chars(text, text + sizeof(text), value);
+    pBuffer->append(text, static_cast<int>(result.ptr - text));
+#else
+    // The shortest precision which reads back to the same value
+    QByteArray text;
+    for (int precision= 6; precision <= 9; ++precision)
+    {
+        text= QByteArray::number(static_cast<double>(value), 'g', precision);
+        if (text.toFloat() == value) break;
+    }
+    pBuffer->append(text);
+#endif
+}
+
+void GLC_BufferedXmlWriter::appendDouble(QByteArray* pBuffer, double value)
+{
+#if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611L)
+    char text[32];
+    const std::to_chars_result result= std::to_chars(text, text + sizeof(text), value);
+    pBuffer->append(text, static_cast<int>(result.ptr - text));
+#else
+    QByteArray text;
+    for (int precision= 15; precision <= 17; ++precision)
+    {
+        text= QByteArray::number(value, 'g', precision);
+        if (text.toDouble() == value) break;
+    }
+    pBuffer->append(text);
+#endif
+}
+
+void GLC_BufferedXmlWriter::appendUInt(QByteArray* pBuffer, quint64 value)
+{
+    char text[24];
+    char* pEnd= text + sizeof(text);
+    char* pBegin= pEnd;
+    do
+    {
+        *(--pBegin)= static_cast<char>('0' + (value % 10));
+        value/= 10;
+    }
+    while (value != 0);
+    pBuffer->append(pBegin, static_cast<int>(pEnd - pBegin));
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_BufferedXmlWriter::setDevice(QIODevice* pDevice)
+{
+    if (nullptr != m_pDevice) flush();
+    m_pDevice= pDevice;
+    m_Buffer.clear();
+    m_ElementStack.clear();
+    m_InStartTag= false;
+    m_InAttribute= false;
+    m_HasContent= false;
+    m_HasError= false;
+    if (nullptr != m_pDevice) m_Buffer.reserve(m_ChunkSize);
+}
+
+void GLC_BufferedXmlWriter::writeStartDocument()
+{
+    m_Buffer.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>");
+    m_HasContent= true;
+}
+
+void GLC_BufferedXmlWriter::writeEndDocument()
+{
+    while (!m_ElementStack.isEmpty())
+    {
+        writeEndElement();
+    }
+    if (m_AutoFormatting) m_Buffer.append('\n');
+    flush();
+}
+
+void GLC_BufferedXmlWriter::writeStartElement(const QString& name)
+{
+    closeStartTag();
+    if (!m_ElementStack.isEmpty())
+    {
+        m_ElementStack.last().m_HasChildElement= true;
+    }
+    writeIndentation(indentationLevel());
+
+    Element element;
+    element.m_Name= name.toUtf8();
+    element.m_HasChildElement= false;
+    m_Buffer.append('<');
+    m_Buffer.append(element.m_Name);
+    m_ElementStack.append(element);
+    m_InStartTag= true;
+    m_HasContent= true;
+}
+
+void GLC_BufferedXmlWriter::writeEndElement()
+{
+    Q_ASSERT(!m_ElementStack.isEmpty());
+    Q_ASSERT(!m_InAttribute);
+    const Element element(m_ElementStack.takeLast());
+    if (m_InStartTag)
+    {
+        m_Buffer.append("/>");
+        m_InStartTag= false;
+    }
+    else
+    {
+        if (element.m_HasChildElement)
+        {
+            writeIndentation(indentationLevel());
+        }
+        m_Buffer.append("</");
+        m_Buffer.append(element.m_Name);
+        m_Buffer.append('>');
+    }
+    flushIfNeeded();
+}
+
+void GLC_BufferedXmlWriter::writeAttribute(const QString& name, const QString& value)
+{
+    writeStartAttribute(name);
+    appendEscaped(value, true);
+    writeEndAttribute();
+}
+
+void GLC_BufferedXmlWriter::writeCharacters(const QString& text)
+{
+    closeStartTag();
+    appendEscaped(text, false);
+    flushIfNeeded();
+}
+
+void GLC_BufferedXmlWriter::writeTextElement(const QString& name, const QString& text)
+{
+    writeStartElement(name);
+    writeCharacters(text);
+    writeEndElement();
+}
+
+void GLC_BufferedXmlWriter::writeStartAttribute(const QString& name)
+{
+    Q_ASSERT(m_InStartTag && !m_InAttribute);
+    m_Buffer.append(' ');
+    m_Buffer.append(name.toUtf8());
+    m_Buffer.append("=\"");
+    m_InAttribute= true;
+}
+
+void GLC_BufferedXmlWriter::writeEndAttribute()
+{
+    Q_ASSERT(m_InAttribute);
+    m_Buffer.append('"');
+    m_InAttribute= false;
+    flushIfNeeded();
+}
+
+void GLC_BufferedXmlWriter::writeRaw(const char* pText)
+{
+    closeStartTag();
+    m_Buffer.append(pText);
+    flushIfNeeded();
+}
+
+void GLC_BufferedXmlWriter::writeFloat(float value)
+{
+    closeStartTag();
+    appendFloat(&m_Buffer, value);
+    flushIfNeeded();
+}
+
+void GLC_BufferedXmlWriter::writeDouble(double value)
+{
+    closeStartTag();
+    appendDouble(&m_Buffer, value);
+    flushIfNeeded();
+}
+
+void GLC_BufferedXmlWriter::writeUInt(quint64 value)
+{
+    closeStartTag();
+    appendUInt(&m_Buffer, value);
+    flushIfNeeded();
+}
+
+void GLC_BufferedXmlWriter::writeFloats(const GLfloat* pData, int count, int tupleSize, const char* pTupleSeparator)
+{
+    closeStartTag();
+    tupleSize= qMax(1, tupleSize);
+    for (int i= 0; i < count; ++i)
+    {
+        if (i > 0)
+        {
+            if ((i % tupleSize) == 0) m_Buffer.append(pTupleSeparator);
+            else m_Buffer.append(' ');
+        }
+        appendFloat(&m_Buffer, pData[i]);
+        flushIfNeeded();
+    }
+}
+
+void GLC_BufferedXmlWriter::writeIndexes(const GLuint* pData, int count, const char* pSeparator)
+{
+    closeStartTag();
+    for (int i= 0; i < count; ++i)
+    {
+        if (i > 0) m_Buffer.append(pSeparator);
+        appendUInt(&m_Buffer, pData[i]);
+        flushIfNeeded();
+    }
+}
+
+void GLC_BufferedXmlWriter::writeFragment(const QByteArray& fragment)
+{
+    if (!fragment.isEmpty())
+    {
+        closeStartTag();
+        if (!m_ElementStack.isEmpty())
+        {
+            m_ElementStack.last().m_HasChildElement= true;
+        }
+        if (nullptr != m_pDevice)
+        {
+            // Large fragments are written directly
+            flush();
+            if (m_pDevice->write(fragment) != fragment.size()) m_HasError= true;
+        }
+        else
+        {
+            m_Buffer.append(fragment);
+        }
+        m_HasContent= true;
+    }
+}
+
+void GLC_BufferedXmlWriter::flush()
+{
+    if ((nullptr != m_pDevice) && !m_Buffer.isEmpty())
+    {
+        if (m_pDevice->write(m_Buffer) != m_Buffer.size()) m_HasError= true;
+        m_Buffer.resize(0);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_BufferedXmlWriter::closeStartTag()
+{
+    if (m_InStartTag && !m_InAttribute)
+    {
+        m_Buffer.append('>');
+        m_InStartTag= false;
+    }
+}
+
+void GLC_BufferedXmlWriter::writeIndentation(int level)
+{
+    if (m_AutoFormatting && m_HasContent)
+    {
+        m_Buffer.append('\n');
+        m_Buffer.append(QByteArray(level * indentationSize, ' '));
+    }
+}
+
+void GLC_BufferedXmlWriter::appendEscaped(const QString& text, bool isAttribute)
+{
+    const QByteArray utf8(text.toUtf8());
+    const int size= utf8.size();
+    const char* pData= utf8.constData();
+    for (int i= 0; i < size; ++i)
+    {
+        const char c= pData[i];
+        switch (c)
+        {
+        case '<':
+            m_Buffer.append("&lt;");
+            break;
+        case '>':
+            m_Buffer.append("&gt;");
+            break;
+        case '&':
+            m_Buffer.append("&amp;");
+            break;
+        case '"':
+            if (isAttribute) m_Buffer.append("&quot;");
+            else m_Buffer.append(c);
+            break;
+        case '\n':
+            if (isAttribute) m_Buffer.append("&#10;");
+            else m_Buffer.append(c);
+            break;
+        case '\r':
+            m_Buffer.append("&#13;");
+            break;
+        case '\t':
+            if (isAttribute) m_Buffer.append("&#9;");
+            else m_Buffer.append(c);
+            break;
+        default:
+            m_Buffer.append(c);
+            break;
+        }
+    }
+}
@@ -0,0 +1,256 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_bufferedxmlwriter.h interface for the GLC_BufferedXmlWriter class.
+
+#ifndef GLC_BUFFEREDXMLWRITER_H_
+#define GLC_BUFFEREDXMLWRITER_H_
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "../glc_global.h"
+
+#include "../glc_config.h"
+
+QT_BEGIN_NAMESPACE
+class QIODevice;
+QT_END_NAMESPACE
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_BufferedXmlWriter
+/*! \brief GLC_BufferedXmlWriter : UTF-8 XML writer with numeric arrays support*/
+
+/*! GLC_BufferedXmlWriter writes the subset of QXmlStreamWriter used by exporters
+ *  in a byte buffer which is written to the device by chunks of chunkSize() bytes.
+ *  The output is the same as QXmlStreamWriter with the same auto formatting.
+ *
+ *  Numbers are formatted directly in the buffer without temporary strings :
+ *  floats with the shortest representation which reads back to the same value,
+ *  integers in decimal. writeFloats() and writeIndexes() write whole arrays as
+ *  element text or, between writeStartAttribute() and writeEndAttribute(), as attribute value.
+ *
+ *  A writer without device is a fragment : its buffer() is only written by
+ *  writeFragment() of another writer. Fragments of independent elements can be
+ *  written by several threads and appended in order, the indentation level of
+ *  the fragment is given on construction.
+ *
+ *  Buffered data are written to the device by flush() and writeEndDocument().*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_BufferedXmlWriter
+{
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Construct a writer without device
+    GLC_BufferedXmlWriter();
+
+    //! Construct a writer of the given device
+    explicit GLC_BufferedXmlWriter(QIODevice* pDevice);
+
+    //! Construct a fragment writer of elements at the given indentation level
+    explicit GLC_BufferedXmlWriter(int indentationLevel);
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the device of this writer
+    inline QIODevice* device() const
+    {return m_pDevice;}
+
+    //! Return true if auto formatting is used
+    inline bool autoFormatting() const
+    {return m_AutoFormatting;}
+
+    //! Return the size in bytes of chunks written to the device
+    inline int chunkSize() const
+    {return m_ChunkSize;}
+
+    //! Return the buffered data not yet written to the device
+    inline const QByteArray& buffer() const
+    {return m_Buffer;}
+
+    //! Return the current indentation level
+    inline int indentationLevel() const
+    {return m_IndentationOffset + m_ElementStack.size();}
+
+    //! Return true if writing to the device failed
+    inline bool hasError() const
+    {return m_HasError;}
+
+    //! Append the shortest representation of the given float to the given buffer
+    static void appendFloat(QByteArray* pBuffer, float value);
+
+    //! Append the shortest representation of the given double to the given buffer
+    static void appendDouble(QByteArray* pBuffer, double value);
+
+    //! Append the decimal representation of the given integer to the given buffer
+    static void appendUInt(QByteArray* pBuffer, quint64 value);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Set the device of this writer, buffered data are written to the previous device
+    void setDevice(QIODevice* pDevice);
+
+    //! Set auto formatting usage
+    inline void setAutoFormatting(bool autoFormatting)
+    {m_AutoFormatting= autoFormatting;}
+
+    //! Set the size in bytes of chunks written to the device
+    inline void setChunkSize(int size)
+    {m_ChunkSize= qMax(1, size);}
+
+    //! Write the XML declaration
+    void writeStartDocument();
+
+    //! Close all open elements and write buffered data to the device
+    void writeEndDocument();
+
+    //! Write the start tag of the given element
+    void writeStartElement(const QString& name);
+
+    //! Write the end tag of the current element
+    void writeEndElement();
+
+    //! Write an attribute of the current start tag
+    void writeAttribute(const QString& name, const QString& value);
+
+    //! Write escaped text
+    void writeCharacters(const QString& text);
+
+    //! Write an element containing only the given text
+    void writeTextElement(const QString& name, const QString& text);
+
+    //! Start an attribute of the current start tag which value is written by the following calls
+    void writeStartAttribute(const QString& name);
+
+    //! End the current attribute
+    void writeEndAttribute();
+
+    //! Write the given text which must not need escaping
+    void writeRaw(const char* pText);
+
+    //! Write the given float
+    void writeFloat(float value);
+
+    //! Write the given double
+    void writeDouble(double value);
+
+    //! Write the given integer
+    void writeUInt(quint64 value);
+
+    //! Write the given floats
+    /*! Values of a tuple of the given size are separated by a space,
+     *  tuples are separated by the given separator*/
+    void writeFloats(const GLfloat* pData, int count, int tupleSize= 1, const char* pTupleSeparator= " ");
+
+    //! Write the given floats
+    inline void writeFloats(const GLfloatVector& data, int tupleSize= 1, const char* pTupleSeparator= " ")
+    {writeFloats(data.constData(), data.size(), tupleSize, pTupleSeparator);}
+
+    //! Write the given indexes separated by the given separator
+    void writeIndexes(const GLuint* pData, int count, const char* pSeparator= " ");
+
+    //! Write the given indexes separated by the given separator
+    inline void writeIndexes(const QVector<GLuint>& data, const char* pSeparator= " ")
+    {writeIndexes(data.constData(), data.size(), pSeparator);}
+
+    //! Append the given buffer of a fragment writer as children of the current element
+    void writeFragment(const QByteArray& fragment);
+
+    //! Write buffered data to the device
+    void flush();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! An open element
+    struct Element
+    {
+        QByteArray m_Name;
+        bool m_HasChildElement;
+    };
+
+    //! Close the current start tag if it is open and not in an attribute
+    void closeStartTag();
+
+    //! Write a new line and the indentation of the given level if auto formatting is used
+    void writeIndentation(int level);
+
+    //! Append the given text escaped to the buffer
+    void appendEscaped(const QString& text, bool isAttribute);
+
+    //! Write the buffer to the device if it is larger than the chunk size
+    inline void flushIfNeeded()
+    {if ((m_Buffer.size() >= m_ChunkSize) && (nullptr != m_pDevice)) flush();}
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The device
+    QIODevice* m_pDevice;
+
+    //! The buffer
+    QByteArray m_Buffer;
+
+    //! The chunk size
+    int m_ChunkSize;
+
+    //! Auto formatting usage
+    bool m_AutoFormatting;
+
+    //! The indentation level of the root of the fragment
+    int m_IndentationOffset;
+
+    //! The open elements
+    QVector<Element> m_ElementStack;
+
+    //! True if the current start tag is open
+    bool m_InStartTag;
+
+    //! True if an attribute value is being written
+    bool m_InAttribute;
+
+    //! True if something has been written on the current line
+    bool m_HasContent;
+
+    //! True if writing to the device failed
+    bool m_HasError;
+
+    Q_DISABLE_COPY(GLC_BufferedXmlWriter)
+};
+
+#endif /* GLC_BUFFEREDXMLWRITER_H_ */
@@ -22,7 +22,15 @@
 
 #include <QStringView>
 
+#include <QBuffer>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <climits>
+#include <cmath>
+
 #include "glc_colladatoworld.h"
+#include "glc_inputdata.h"
 #include "../sceneGraph/glc_world.h"
 #include "../glc_fileformatexception.h"
 #include "../maths/glc_geomtools.h"
@@ -34,24 +42,259 @@ static int currentNodeId= 0;
 
 using namespace glcXmlUtil;
 
+namespace
+{
+	// Powers of ten exactly representable by a double
+	const double powersOfTen[]= {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+								 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+	inline bool isArraySpace(QChar c)
+	{
+		const char16_t code= c.unicode();
+		return (code == ' ') || (code == '\n') || (code == '\r') || (code == '\t');
+	}
+
+	inline int digitValue(QChar c)
+	{
+		return static_cast<int>(c.unicode()) - '0';
+	}
+
+	// Convert the given token to a float, the decimal notation is parsed without allocation
+	bool toNumber(QStringView token, float* pValue)
+	{
+		const QChar* p= token.begin();
+		const QChar* pEnd= token.end();
+
+		bool isNegative= false;
+		if ((p != pEnd) && ((*p == '-') || (*p == '+')))
+		{
+			isNegative= (*p == '-');
+			++p;
+		}
+
+		// Significant digits are accumulated in an integer
+		quint64 mantissa= 0;
+		int significantDigitCount= 0;
+		int exponent= 0;
+		bool hasDigit= false;
+		while ((p != pEnd) && (static_cast<unsigned int>(digitValue(*p)) < 10))
+		{
+			if (significantDigitCount < 19)
+			{
+				mantissa= mantissa * 10 + digitValue(*p);
+				if (mantissa != 0) ++significantDigitCount;
+			}
+			else ++exponent;
+			hasDigit= true;
+			++p;
+		}
+		if ((p != pEnd) && (*p == '.'))
+		{
+			++p;
+			while ((p != pEnd) && (static_cast<unsigned int>(digitValue(*p)) < 10))
+			{
+				if (significantDigitCount < 19)
+				{
+					mantissa= mantissa * 10 + digitValue(*p);
+					if (mantissa != 0) ++significantDigitCount;
+					--exponent;
+				}
+				hasDigit= true;
+				++p;
+			}
+		}
+		if (hasDigit && (p != pEnd) && ((*p == 'e') || (*p == 'E')))
+		{
+			++p;
+			bool isNegativeExponent= false;
+			if ((p != pEnd) && ((*p == '-') || (*p == '+')))
+			{
+				isNegativeExponent= (*p == '-');
+				++p;
+			}
+			int explicitExponent= 0;
+			bool hasExponentDigit= false;
+			while ((p != pEnd) && (static_cast<unsigned int>(digitValue(*p)) < 10))
+			{
+				if (explicitExponent < 10000) explicitExponent= explicitExponent * 10 + digitValue(*p);
+				hasExponentDigit= true;
+				++p;
+			}
+			hasDigit= hasExponentDigit;
+			exponent+= isNegativeExponent ? -explicitExponent : explicitExponent;
+		}
+
+		bool subject= hasDigit && (p == pEnd);
+		if (subject)
+		{
+			double value= static_cast<double>(mantissa);
+			if ((mantissa != 0) && (exponent != 0))
+			{
+				if ((exponent > 0) && (exponent <= 22)) value*= powersOfTen[exponent];
+				else if ((exponent < 0) && (exponent >= -22)) value/= powersOfTen[-exponent];
+				else value*= std::pow(10.0, exponent);
+			}
+			*pValue= static_cast<float>(isNegative ? -value : value);
+		}
+		else
+		{
+			// Special values like INF and NaN
+			*pValue= token.toFloat(&subject);
+		}
+
+		return subject;
+	}
+
+	// Convert the given token to an int
+	bool toNumber(QStringView token, int* pValue)
+	{
+		const QChar* p= token.begin();
+		const QChar* pEnd= token.end();
+
+		bool isNegative= false;
+		if ((p != pEnd) && ((*p == '-') || (*p == '+')))
+		{
+			isNegative= (*p == '-');
+			++p;
+		}
+
+		bool subject= (p != pEnd);
+		qint64 value= 0;
+		while (subject && (p != pEnd))
+		{
+			const unsigned int digit= static_cast<unsigned int>(digitValue(*p));
+			value= value * 10 + digit;
+			subject= (digit < 10) && (value <= INT_MAX);
+			++p;
+		}
+		if (subject)
+		{
+			*pValue= static_cast<int>(isNegative ? -value : value);
+		}
+
+		return subject;
+	}
+
+	// Scanner of the white space separated numbers of a Collada array
+	/* The text of an array can be split in several parts by the stream reader,
+	 * a number cut at the end of a part is completed by the next part*/
+	template <typename T>
+	class ArrayScanner
+	{
+	public:
+		explicit ArrayScanner(QVector<T>* pValues)
+		: m_pValues(pValues)
+		, m_Pending()
+		, m_InvalidToken()
+		{}
+
+		// Scan the given part of the array, return false if a token is not a number
+		bool scan(QStringView text)
+		{
+			const QChar* p= text.begin();
+			const QChar* pEnd= text.end();
+			bool subject= true;
+
+			if (!m_Pending.isEmpty())
+			{
+				const QChar* pTokenEnd= p;
+				while ((pTokenEnd != pEnd) && !isArraySpace(*pTokenEnd)) ++pTokenEnd;
+				m_Pending.append(QStringView(p, pTokenEnd));
+				p= pTokenEnd;
+				if (p == pEnd) return true;
+
+				subject= append(m_Pending);
+				m_Pending.clear();
+			}
+
+			while (subject && (p != pEnd))
+			{
+				while ((p != pEnd) && isArraySpace(*p)) ++p;
+				const QChar* pTokenBegin= p;
+				while ((p != pEnd) && !isArraySpace(*p)) ++p;
+				if (pTokenBegin != p)
+				{
+					if (p == pEnd) m_Pending= QStringView(pTokenBegin, p).toString();
+					else subject= append(QStringView(pTokenBegin, p));
+				}
+			}
+
+			return subject;
+		}
+
+		// Add the last number of the array, return false if it is not a number
+		bool finish()
+		{
+			bool subject= true;
+			if (!m_Pending.isEmpty())
+			{
+				subject= append(m_Pending);
+				m_Pending.clear();
+			}
+			return subject;
+		}
+
+		// Return the token which is not a number
+		inline QString invalidToken() const
+		{return m_InvalidToken;}
+
+	private:
+		bool append(QStringView token)
+		{
+			T value;
+			const bool subject= toNumber(token, &value);
+			if (subject) m_pValues->append(value);
+			else m_InvalidToken= token.toString();
+
+			return subject;
+		}
+
+	private:
+		QVector<T>* m_pValues;
+		QString m_Pending;
+		QString m_InvalidToken;
+	};
+
+	// Read the numbers of the current array element directly from the text of the stream reader
+	template <typename T>
+	bool readArray(QXmlStreamReader* pStreamReader, const QString& element, QVector<T>* pValues, QString* pInvalidToken)
+	{
+		ArrayScanner<T> scanner(pValues);
+		bool subject= true;
+		while(endElementNotReached(pStreamReader, element))
+		{
+			pStreamReader->readNext();
+			if (subject && pStreamReader->isCharacters())
+			{
+				subject= scanner.scan(pStreamReader->text());
+			}
+		}
+		if (subject) subject= scanner.finish();
+		if (!subject) *pInvalidToken= scanner.invalidToken();
+
+		return subject;
+	}
+}
+
 // Default constructor
 GLC_ColladaToWorld::GLC_ColladaToWorld()
 : QObject()
 , m_pWorld(NULL)
 , m_pStreamReader(NULL)
 , m_FileName()
-, m_pFile(NULL)
+, m_pBuffer(NULL)
 , m_ImageFileHash()
 , m_MaterialLibHash()
 , m_SurfaceImageHash()
 , m_MaterialEffectHash()
 , m_pCurrentMaterial(NULL)
 , m_TextureToMaterialHash()
-, m_BulkDataHash()
-, m_DataAccessorHash()
 , m_VerticesSourceHash()
 , m_pMeshInfo(NULL)
 , m_GeometryHash()
+, m_PendingMeshInfos()
+, m_BuildingMeshInfos()
+, m_MeshInfoFuture()
 , m_ColladaNodeHash()
 , m_TopLevelColladaNode()
 , m_MaterialInstanceMap()
@@ -80,23 +323,32 @@ GLC_ColladaToWorld::~GLC_ColladaToWorld()
 // Create an GLC_World from an input Collada File
 GLC_World* GLC_ColladaToWorld::CreateWorldFromCollada(QFile &file)
 {
-	m_pWorld= new GLC_World();
-	m_FileName= file.fileName();
-	m_pFile= &file;
-
 	//////////////////////////////////////////////////////////////////
 	// Test if the file exist and can be opened
 	//////////////////////////////////////////////////////////////////
-	if (!m_pFile->open(QIODevice::ReadOnly))
+	const GLC_InputData input(GLC_InputData::fromDevice(&file));
+	if (input.isNull())
 	{
-		QString message(QString("GLC_ColladaToWorld::CreateWorldFromCollada File ") + m_FileName + QString(" doesn't exist"));
-		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotFound);
+		QString message(QString("GLC_ColladaToWorld::CreateWorldFromCollada File ") + file.fileName() + QString(" doesn't exist"));
+		GLC_FileFormatException fileFormatException(message, file.fileName(), GLC_FileFormatException::FileNotFound);
 		throw(fileFormatException);
 	}
-	// Get the file size
-	m_FileSize= QFileInfo(m_FileName).size();
 
-	m_pStreamReader= new QXmlStreamReader(m_pFile);
+	return CreateWorldFromCollada(input);
+}
+
+// Create an GLC_World from the given Collada data
+GLC_World* GLC_ColladaToWorld::CreateWorldFromCollada(const GLC_InputData& input)
+{
+	m_pWorld= new GLC_World();
+	m_FileName= input.fileName();
+
+	// The stream reader reads the data without copy
+	m_pBuffer= new QBuffer();
+	input.openBuffer(m_pBuffer);
+	m_FileSize= input.size();
+
+	m_pStreamReader= new QXmlStreamReader(m_pBuffer);
 
 	// Go to the collada root Element
 	goToElement("COLLADA");
@@ -140,8 +392,12 @@ GLC_World* GLC_ColladaToWorld::CreateWorldFromCollada(QFile &file)
 		m_pStreamReader->readNext();
 	}
 
-	m_pFile->close();
-	m_pFile= NULL;
+	delete m_pBuffer;
+	m_pBuffer= NULL;
+
+	// Build the last mesh infos
+	buildPendingMeshInfos();
+	waitForMeshInfos();
 
 	// Link the textures to materials
 	linkTexturesToMaterials();
@@ -196,6 +452,26 @@ QString GLC_ColladaToWorld::getContent(const QString& element)
     return subject.trimmed();
 }
 
+// Read the numbers of the specified array element in the given vector
+void GLC_ColladaToWorld::readFloatArray(const QString& element, QVector<float>* pValues)
+{
+	QString invalidToken;
+	if (!readArray(m_pStreamReader, element, pValues, &invalidToken))
+	{
+		throwException("Unable to convert string :" + invalidToken + " To float");
+	}
+}
+
+// Read the integers of the specified array element in the given vector
+void GLC_ColladaToWorld::readIntArray(const QString& element, QVector<int>* pValues)
+{
+	QString invalidToken;
+	if (!readArray(m_pStreamReader, element, pValues, &invalidToken))
+	{
+		throwException("Unable to convert string :" + invalidToken + " To int");
+	}
+}
+
 // Read the specified attribute
 QString GLC_ColladaToWorld::readAttribute(const QString& name, bool required)
 {
@@ -242,8 +518,8 @@ void GLC_ColladaToWorld::clear()
 	delete m_pStreamReader;
 	m_pStreamReader= NULL;
 
-	if (m_pFile != NULL) m_pFile->close();
-	m_pFile= NULL;
+	delete m_pBuffer;
+	m_pBuffer= NULL;
 
 	m_ImageFileHash.clear();
 	m_MaterialLibHash.clear();
@@ -263,11 +539,13 @@ void GLC_ColladaToWorld::clear()
 
 	m_TextureToMaterialHash.clear();
 
-	m_BulkDataHash.clear();
-	m_DataAccessorHash.clear();
-
 	m_VerticesSourceHash.clear();
 
+	// The mesh infos being built are owned by the geometry hash
+	m_MeshInfoFuture.waitForFinished();
+	m_PendingMeshInfos.clear();
+	m_BuildingMeshInfos.clear();
+
 	delete m_pMeshInfo;
 	m_pMeshInfo= NULL;
 
@@ -774,7 +1052,13 @@ void GLC_ColladaToWorld::loadGeometry()
 	if (!id.isEmpty())
 	{
 		m_GeometryHash.insert(id, m_pMeshInfo);
+		// Geometries are independent, they are built while the next ones are read
+		m_PendingMeshInfos.append(m_pMeshInfo);
 		m_pMeshInfo= NULL;
+		if (m_PendingMeshInfos.size() >= (QThread::idealThreadCount() * 2))
+		{
+			buildPendingMeshInfos();
+		}
 	}
 }
 
@@ -808,7 +1092,7 @@ void GLC_ColladaToWorld::loadVertexBulkData()
 	// load Vertex Bulk data id
 	m_CurrentId= readAttribute("id", true);
 	//qDebug() << "id=" << m_CurrentId;
-	QList<float> vertices;
+	QVector<float> vertices;
 
 	while (endElementNotReached(m_pStreamReader, "source"))
 	{
@@ -817,16 +1101,12 @@ void GLC_ColladaToWorld::loadVertexBulkData()
             const QStringView currentElementName= m_pStreamReader->name();
 			if ((currentElementName == "float_array"))
 			{
-				int count= readAttribute("count", true).toInt();
-				QString array= getContent("float_array");
-				QStringList list= array.split(' ');
+				const int count= readAttribute("count", true).toInt();
+				// The array is decoded from the text of the reader in a vector of the right size
+				vertices.reserve(qMax(0, count));
+				readFloatArray("float_array", &vertices);
 				// Check the array size
-				if (count != list.size()) throwException("float_array size not match");
-
-				for (int i= 0; i < count; ++i)
-				{
-					vertices.append(list.at(i).toFloat());
-				}
+				if (count != vertices.size()) throwException("float_array size not match");
 			}
 			else if (currentElementName == "technique_common") loadTechniqueCommon();
 		}
@@ -834,7 +1114,7 @@ void GLC_ColladaToWorld::loadVertexBulkData()
 		m_pStreamReader->readNext();
 	}
 	checkForXmlError("Error occur while loading element : source");
-	m_BulkDataHash.insert(m_CurrentId, vertices);
+	m_pMeshInfo->m_BulkDataHash.insert(m_CurrentId, vertices);
 
 	updateProgressBar();
 }
@@ -884,7 +1164,7 @@ void GLC_ColladaToWorld::loadAccessor()
 	}
 	checkForXmlError("Error occur while loading element : technique_common");
 
-	m_DataAccessorHash.insert(m_CurrentId, accessor);
+	m_pMeshInfo->m_DataAccessorHash.insert(m_CurrentId, accessor);
 }
 
 // Load attributes and identity of mesh vertices
@@ -907,76 +1187,49 @@ void GLC_ColladaToWorld::loadPolylist()
 	// The number of polygon
 	const int polygonCount= readAttribute("count", true).toInt();
 
+	PrimitiveInfo primitiveInfo;
+	primitiveInfo.m_Type= Polygons;
 	// The material id
-	const QString materialId= readAttribute("material", false);
+	primitiveInfo.m_MaterialId= readAttribute("material", false);
 
-	// Offsets and data source list
-	QList<InputData> inputDataList;
-
-	// Polygon number of vertice list
-	QList<int> vcountList;
-
-	// Polygon index list
-	QList<int> polyIndexList;
+	// The number of index of a vertice
+	int vertexIndexCount= 0;
 
 	while (endElementNotReached(m_pStreamReader, "polylist"))
 	{
 		if (QXmlStreamReader::StartElement == m_pStreamReader->tokenType())
 		{
             const QStringView currentElementName= m_pStreamReader->name();
-			if ((currentElementName == "input") && vcountList.isEmpty())
+			if ((currentElementName == "input") && primitiveInfo.m_VCount.isEmpty())
 			{
-				InputData currentInput;
-				// Get input data offset
-				currentInput.m_Offset= readAttribute("offset", true).toInt();
-				// Get input data semantic
-				const QString semantic= readAttribute("semantic", true);
-				if (semantic == "VERTEX") currentInput.m_Semantic= VERTEX;
-				else if (semantic == "NORMAL") currentInput.m_Semantic= NORMAL;
-				else if (semantic == "TEXCOORD") currentInput.m_Semantic= TEXCOORD;
-				else throwException("Source semantic :" + semantic + "Not supported");
-				// Get input data source id
-				currentInput.m_Source= readAttribute("source", true).remove('#');
-
-				// Bypasss vertices indirection
-				if (m_VerticesSourceHash.contains(currentInput.m_Source))
-				{
-					currentInput.m_Source= m_VerticesSourceHash.value(currentInput.m_Source);
-				}
-				inputDataList.append(currentInput);
+				const InputData currentInput= loadInput();
+				vertexIndexCount= qMax(vertexIndexCount, currentInput.m_Offset + 1);
+				primitiveInfo.m_Inputs.append(currentInput);
 			}
-			else if ((currentElementName == "vcount") && (inputDataList.size() > 0))
+			else if ((currentElementName == "vcount") && !primitiveInfo.m_Inputs.isEmpty())
 			{
-				QString vcountString= getContent("vcount");
-				QStringList vcountStringList= vcountString.split(' ');
-				if (vcountStringList.size() != polygonCount) throwException("vcount size not match");
-				bool toIntOK;
-				for (int i= 0; i < polygonCount; ++i)
-				{
-					vcountList.append(vcountStringList.at(i).toInt(&toIntOK));
-					if (!toIntOK) throwException("Unable to convert string :" + vcountStringList.at(i) + " To int");
-				}
+				primitiveInfo.m_VCount.reserve(qMax(0, polygonCount));
+				readIntArray("vcount", &primitiveInfo.m_VCount);
+				if (primitiveInfo.m_VCount.size() != polygonCount) throwException("vcount size not match");
 			}
-			else if ((currentElementName == "p") && !vcountList.isEmpty() && polyIndexList.isEmpty())
+			else if ((currentElementName == "p") && !primitiveInfo.m_VCount.isEmpty() && primitiveInfo.m_Index.isEmpty())
 			{
-				{ // Fill index List
-					QString pString= getContent("p");
-					QStringList pStringList= pString.split(' ');
-					bool toIntOK;
-					const int size= pStringList.size();
-					for (int i= 0; i < size; ++i)
-					{
-						polyIndexList.append(pStringList.at(i).toInt(&toIntOK));
-						if (!toIntOK) throwException("Unable to convert string :" + pStringList.at(i) + " To int");
-					}
+				// The index list size is given by the polygons size
+				qint64 indexCount= 0;
+				for (int i= 0; i < polygonCount; ++i)
+				{
+					indexCount+= qMax(0, primitiveInfo.m_VCount.at(i));
 				}
+				indexCount*= vertexIndexCount;
+				if (indexCount < INT_MAX) primitiveInfo.m_Index.reserve(static_cast<int>(indexCount));
 
+				readIntArray("p", &primitiveInfo.m_Index);
 			}
 		}
 		m_pStreamReader->readNext();
 	}
-	// Add the polylist to the current mesh
-	addPolylistToCurrentMesh(inputDataList, vcountList, polyIndexList, materialId);
+	// The polylist is added to the mesh when the geometry is built
+	m_pMeshInfo->m_Primitives.append(primitiveInfo);
 
 	updateProgressBar();
 }
@@ -984,510 +1237,547 @@ void GLC_ColladaToWorld::loadPolylist()
 // Load Polygons
 void GLC_ColladaToWorld::loadPolygons()
 {
+	PrimitiveInfo primitiveInfo;
+	primitiveInfo.m_Type= Polygons;
 	// The material id
-	const QString materialId= readAttribute("material", false);
-
-	// Offsets and data source list
-	QList<InputData> inputDataList;
+	primitiveInfo.m_MaterialId= readAttribute("material", false);
 
-	// Polygon number of vertice list
-	QList<int> vcountList;
+	// The number of index of a vertice
+	int vertexIndexCount= 0;
 
-	// The input number
-	int inputCount= 0;
-	// Polygon index list
-	QList<int> polyIndexList;
 	while (endElementNotReached(m_pStreamReader, "polygons"))
 	{
 		if (QXmlStreamReader::StartElement == m_pStreamReader->tokenType())
 		{
             const QStringView currentElementName= m_pStreamReader->name();
-			if ((currentElementName == "input") && vcountList.isEmpty())
+			if ((currentElementName == "input") && primitiveInfo.m_VCount.isEmpty())
 			{
-				++inputCount;
-				InputData currentInput;
-				// Get input data offset
-				currentInput.m_Offset= readAttribute("offset", true).toInt();
-				// Get input data semantic
-				const QString semantic= readAttribute("semantic", true);
-				if (semantic == "VERTEX") currentInput.m_Semantic= VERTEX;
-				else if (semantic == "NORMAL") currentInput.m_Semantic= NORMAL;
-				else if (semantic == "TEXCOORD") currentInput.m_Semantic= TEXCOORD;
-				else throwException("Source semantic :" + semantic + "Not supported");
-				// Get input data source id
-				currentInput.m_Source= readAttribute("source", true).remove('#');
-
-				// Bypasss vertices indirection
-				if (m_VerticesSourceHash.contains(currentInput.m_Source))
-				{
-					currentInput.m_Source= m_VerticesSourceHash.value(currentInput.m_Source);
-				}
-				inputDataList.append(currentInput);
+				const InputData currentInput= loadInput();
+				vertexIndexCount= qMax(vertexIndexCount, currentInput.m_Offset + 1);
+				primitiveInfo.m_Inputs.append(currentInput);
 			}
-			else if (currentElementName == "p")
+			else if ((currentElementName == "p") && (vertexIndexCount > 0))
 			{
-				{ // Fill index List
-					QString pString= getContent("p");
-					QStringList pStringList= pString.split(' ');
-					bool toIntOK;
-					const int size= pStringList.size();
-					for (int i= 0; i < size; ++i)
-					{
-						polyIndexList.append(pStringList.at(i).toInt(&toIntOK));
-						if (!toIntOK) throwException("Unable to convert string :" + pStringList.at(i) + " To int");
-					}
-					// Add the polygon size in vcountList
-					vcountList.append(size / inputCount);
-				}
+				// Each p element is a polygon appended to the index list
+				const int previousSize= primitiveInfo.m_Index.size();
+				readIntArray("p", &primitiveInfo.m_Index);
+				// Add the polygon size in vcountList
+				primitiveInfo.m_VCount.append((primitiveInfo.m_Index.size() - previousSize) / vertexIndexCount);
 			}
 		}
 		m_pStreamReader->readNext();
 	}
-	// Add the polylist to the current mesh
-	addPolylistToCurrentMesh(inputDataList, vcountList, polyIndexList, materialId);
+	// The polygons are added to the mesh when the geometry is built
+	m_pMeshInfo->m_Primitives.append(primitiveInfo);
 
 	updateProgressBar();
 }
 
-// Add the polylist to the current mesh
-void GLC_ColladaToWorld::addPolylistToCurrentMesh(const QList<InputData>& inputDataList, const QList<int>& vcountList, const QList<int>& polyIndexList, const QString& materialId)
+// Load the input of a primitive element
+GLC_ColladaToWorld::InputData GLC_ColladaToWorld::loadInput()
 {
-	//qDebug() << "GLC_ColladaToWorld::addPolylistToCurrentMesh";
+	InputData subject;
+	// Get input data offset
+	subject.m_Offset= readAttribute("offset", true).toInt();
+	if (subject.m_Offset < 0) throwException("Input offset :" + QString::number(subject.m_Offset) + " Not valid");
+	// Get input data semantic
+	const QString semantic= readAttribute("semantic", true);
+	if (semantic == "VERTEX") subject.m_Semantic= VERTEX;
+	else if (semantic == "NORMAL") subject.m_Semantic= NORMAL;
+	else if (semantic == "TEXCOORD") subject.m_Semantic= TEXCOORD;
+	else throwException("Source semantic :" + semantic + "Not supported");
+	// Get input data source id
+	subject.m_Source= readAttribute("source", true).remove('#');
+
+	// Bypasss vertices indirection
+	if (m_VerticesSourceHash.contains(subject.m_Source))
+	{
+		subject.m_Source= m_VerticesSourceHash.value(subject.m_Source);
+	}
+
+	return subject;
+}
 
-	const int polygonCount= vcountList.size();
-	const int inputDataCount= inputDataList.size();
-	const int polyIndexCount= polyIndexList.size();
+// Load triangles
+void  GLC_ColladaToWorld::loadTriangles()
+{
+	//qDebug() << "GLC_ColladaToWorld::loadTriangles()";
+	PrimitiveInfo primitiveInfo;
+	primitiveInfo.m_Type= Triangles;
+	// The material id
+	primitiveInfo.m_MaterialId= readAttribute("material", false);
 
-	// Flag to know if the polylist has normal
-	bool hasNormals= false;
-	bool hasTexture= false;
-	// Check the existance of data source
-	for (int dataIndex= 0; dataIndex < inputDataCount; ++dataIndex)
-	{
-		const QString source= inputDataList.at(dataIndex).m_Source;
-		if ( !m_BulkDataHash.contains(source))
-		{
-			throwException(" Source : " + source + " Not found");
-		}
-		if (inputDataList.at(dataIndex).m_Semantic == NORMAL) hasNormals= true;
-		if (inputDataList.at(dataIndex).m_Semantic == TEXCOORD) hasTexture= true;
-	}
+	// The number of triangles
+	const int triangleCount= readAttribute("count", false).toInt();
 
-	int maxOffset= 0;
-	for (int i= 0; i < inputDataCount; ++i)
+	// The number of index of a vertice
+	int vertexIndexCount= 0;
+
+	while (endElementNotReached(m_pStreamReader, "triangles"))
 	{
-		if (inputDataList.at(i).m_Offset > maxOffset)
+		if (QXmlStreamReader::StartElement == m_pStreamReader->tokenType())
 		{
-			maxOffset= inputDataList.at(i).m_Offset;
+            const QStringView currentElementName= m_pStreamReader->name();
+			if ((currentElementName == "input") && primitiveInfo.m_Index.isEmpty())
+			{
+				const InputData currentInput= loadInput();
+				vertexIndexCount= qMax(vertexIndexCount, currentInput.m_Offset + 1);
+				primitiveInfo.m_Inputs.append(currentInput);
+			}
+			else if ((currentElementName == "p") && primitiveInfo.m_Index.isEmpty())
+			{
+				const qint64 indexCount= static_cast<qint64>(triangleCount) * 3 * vertexIndexCount;
+				if ((indexCount > 0) && (indexCount < INT_MAX)) primitiveInfo.m_Index.reserve(static_cast<int>(indexCount));
+
+				readIntArray("p", &primitiveInfo.m_Index);
+			}
 		}
+		m_pStreamReader->readNext();
 	}
-	//qDebug() << " Max Offset :" << maxOffset;
 
-	// the polygonIndex of the polylist
-	QList<int> polygonIndex;
+	// The triangles are added to the mesh when the geometry is built
+	m_pMeshInfo->m_Primitives.append(primitiveInfo);
 
-	// Fill the mapping, bulk data and index list of the current mesh info
-	for (int i= 0; i < polyIndexCount; i+= maxOffset + 1)
-	{
-		// Create and set the current vertice index
-		ColladaVertice currentVertice;
-		for (int dataIndex= 0; dataIndex < inputDataCount; ++dataIndex)
-		{
-			currentVertice.m_Values[inputDataList.at(dataIndex).m_Semantic]= polyIndexList.at(i + inputDataList.at(dataIndex).m_Offset);
-		}
+	updateProgressBar();
 
-		if (m_pMeshInfo->m_Mapping.contains(currentVertice))
-		{
-			// Add the the index to the polygon index
-			polygonIndex.append(m_pMeshInfo->m_Mapping.value(currentVertice));
-		}
-		else
-		{
-			// Add the current vertice to the current mesh info mapping hash table and increment the freeIndex
-			m_pMeshInfo->m_Mapping.insert(currentVertice, (m_pMeshInfo->m_FreeIndex)++);
-			// Add the the index to the polygon index
-			polygonIndex.append(m_pMeshInfo->m_Mapping.value(currentVertice));
+}
+
+void GLC_ColladaToWorld::loadLineStrips()
+{
+	PrimitiveInfo primitiveInfo;
+	primitiveInfo.m_Type= LineStrips;
 
-			// Add the bulk data associated to the current vertice to the current mesh info
-			for (int dataIndex= 0; dataIndex < inputDataCount; ++dataIndex)
+	while (endElementNotReached(m_pStreamReader, "linestrips"))
+	{
+		if (QXmlStreamReader::StartElement == m_pStreamReader->tokenType())
+		{
+            const QStringView currentElementName= m_pStreamReader->name();
+			if ((currentElementName == "input") && primitiveInfo.m_Index.isEmpty())
 			{
-				// The current input data
-				InputData currentInputData= inputDataList.at(dataIndex);
-				// QHash iterator on the right QList<float>
-				BulkDataHash::const_iterator iBulkHash= m_BulkDataHash.find(currentInputData.m_Source);
-				int stride;
-				if (m_DataAccessorHash.contains(currentInputData.m_Source))
-				{
-					stride= m_DataAccessorHash.value(currentInputData.m_Source).m_Stride;
-				}
-				else if (currentInputData.m_Semantic != TEXCOORD) stride= 3; else stride= 2;
-				// Firts value
-				m_pMeshInfo->m_Datas[currentInputData.m_Semantic].append(iBulkHash.value().at(polyIndexList.at(i + currentInputData.m_Offset) * stride));
-				// Second value
-				m_pMeshInfo->m_Datas[currentInputData.m_Semantic].append(iBulkHash.value().at(polyIndexList.at(i + currentInputData.m_Offset) * stride + 1));
-				// Fird value
-				if (currentInputData.m_Semantic != TEXCOORD)
-				{
-					m_pMeshInfo->m_Datas[currentInputData.m_Semantic].append(iBulkHash.value().at(polyIndexList.at(i + currentInputData.m_Offset) * stride + 2));
-				}
+				const InputData currentInput= loadInput();
+				if (currentInput.m_Semantic != VERTEX) throwException("Source semantic :" + readAttribute("semantic") + "Not supported");
+				primitiveInfo.m_Inputs.clear();
+				primitiveInfo.m_Inputs.append(currentInput);
 			}
-			// Avoid problem wich occur with mesh containing materials with and without texture
-			if (!hasTexture)
+			else if ((currentElementName == "p") && !primitiveInfo.m_Inputs.isEmpty())
 			{
-				m_pMeshInfo->m_Datas[TEXCOORD].append(0.0);
+				// Each p element is a line strip appended to the index list
+				const int vertexIndexCount= primitiveInfo.m_Inputs.first().m_Offset + 1;
+				const int previousSize= primitiveInfo.m_Index.size();
+				readIntArray("p", &primitiveInfo.m_Index);
+				const int vertexCount= (primitiveInfo.m_Index.size() - previousSize) / vertexIndexCount;
+				primitiveInfo.m_Index.resize(previousSize + vertexCount * vertexIndexCount);
+				primitiveInfo.m_VCount.append(vertexCount);
 			}
-
 		}
+		m_pStreamReader->readNext();
 	}
 
-	// Save mesh info index offset
-	const int indexOffset= m_pMeshInfo->m_Index.size();
-	// Triangulate the polygons of the polylist
-	// Input polygon index must start from 0 and succesive : (0 1 2 3 4)
-	QList<GLuint> onePolygonIndex;
-	for (int i= 0; i < polygonCount; ++i)
+	// The line strips are added to the mesh when the geometry is built
+	m_pMeshInfo->m_Primitives.append(primitiveInfo);
+
+	updateProgressBar();
+
+}
+
+// Build the pending mesh infos in parallel while the next ones are read
+void GLC_ColladaToWorld::buildPendingMeshInfos()
+{
+	waitForMeshInfos();
+
+	m_BuildingMeshInfos= m_PendingMeshInfos;
+	m_PendingMeshInfos.clear();
+	if (!m_BuildingMeshInfos.isEmpty())
 	{
-		const int polygonSize= vcountList.at(i);
-		Q_ASSERT(polygonSize > 2);
-		for (int i= 0; i < polygonSize; ++i)
-		{
-			onePolygonIndex.append(polygonIndex.takeFirst());
-		}
-		// Triangulate the current polygon if the polygon as more than 3 vertice
-		if (polygonSize > 3)
-		{
-            glc::triangulatePolygonClip2TRi(&onePolygonIndex, m_pMeshInfo->m_Datas.at(VERTEX));
-		}
-		// Add index to the mesh info
-		//Q_ASSERT(not onePolygonIndex.isEmpty());
-		if (!onePolygonIndex.isEmpty())
-		{
-			m_pMeshInfo->m_Index.append(onePolygonIndex);
-		}
-		else
+		m_MeshInfoFuture= QtConcurrent::map(m_BuildingMeshInfos, [this](MeshInfo*& pMeshInfo)
 		{
-			QStringList stringList(m_FileName);
-			stringList.append("Unable to triangulate a polygon of " + m_pMeshInfo->m_pMesh->name());
-			GLC_ErrorLog::addError(stringList);
-		}
-		onePolygonIndex.clear();
+			buildMeshInfo(pMeshInfo);
+		});
 	}
+}
 
-	// Check if normal computation is needed
-	if (!hasNormals)
+// Wait for the build of the mesh infos
+void GLC_ColladaToWorld::waitForMeshInfos()
+{
+	m_MeshInfoFuture.waitForFinished();
+
+	QString error;
+	const int count= m_BuildingMeshInfos.size();
+	for (int i= 0; (i < count) && error.isEmpty(); ++i)
 	{
-		qDebug() << "Compute Normals with offset " << indexOffset;
-		computeNormalOfCurrentPrimitiveOfCurrentMesh(indexOffset);
+		error= m_BuildingMeshInfos.at(i)->m_Error;
 	}
+	m_BuildingMeshInfos.clear();
 
-	// Add material the current mesh info
-	MatOffsetSize matInfo;
-	matInfo.m_Offset= indexOffset;
-	matInfo.m_size= m_pMeshInfo->m_Index.size() - indexOffset;
-	m_pMeshInfo->m_Materials.insert(materialId, matInfo);
-
+	if (!error.isEmpty()) throwException(error);
 }
-// Compute Normals for the current primitive element of the current mesh
-void GLC_ColladaToWorld::computeNormalOfCurrentPrimitiveOfCurrentMesh(int indexOffset)
+
+// Add the primitives to the mesh of the given mesh info
+void GLC_ColladaToWorld::buildMeshInfo(MeshInfo* pMeshInfo) const
 {
-	const QList<float>* pData= &(m_pMeshInfo->m_Datas.at(VERTEX));
-	// Fill the list of normal
-	QList<float>* pNormal= &(m_pMeshInfo->m_Datas[NORMAL]);
-	const int normalOffset= pNormal->size();
-	const int normalCount= pData->size() - normalOffset;
-	for (int i= 0; i < normalCount; ++i)
+	bool isValid= true;
+	const int primitiveCount= pMeshInfo->m_Primitives.size();
+	for (int i= 0; isValid && (i < primitiveCount); ++i)
 	{
-		pNormal->append(0.0f);
+		const PrimitiveInfo& primitiveInfo= pMeshInfo->m_Primitives.at(i);
+		if (primitiveInfo.m_Type == Polygons) isValid= addPolygonsToMeshInfo(pMeshInfo, primitiveInfo);
+		else if (primitiveInfo.m_Type == Triangles) isValid= addTrianglesToMeshInfo(pMeshInfo, primitiveInfo);
+		else isValid= addLineStripsToMeshInfo(pMeshInfo, primitiveInfo);
 	}
-	// Compute the normals and add them to the current mesh info
-	const int size= m_pMeshInfo->m_Index.size() - indexOffset;
-
-	for (int i= indexOffset; i < size; i+=3)
-	{
-		// Vertex 1
-        const double xn1= pData->at(m_pMeshInfo->m_Index.at(i) * 3);
-        const double yn1= pData->at(m_pMeshInfo->m_Index.at(i) * 3 + 1);
-        const double zn1= pData->at(m_pMeshInfo->m_Index.at(i) * 3 + 2);
-        const GLC_Vector3d vect1(xn1, yn1, zn1);
 
-		// Vertex 2
-        const double xn2= pData->at(m_pMeshInfo->m_Index.at(i + 1) * 3);
-        const double yn2= pData->at(m_pMeshInfo->m_Index.at(i + 1) * 3  + 1);
-        const double zn2= pData->at(m_pMeshInfo->m_Index.at(i + 1) * 3 + 2);
-        const GLC_Vector3d vect2(xn2, yn2, zn2);
-
-		// Vertex 3
-        const double xn3= pData->at(m_pMeshInfo->m_Index.at(i + 2) * 3);
-        const double yn3= pData->at(m_pMeshInfo->m_Index.at(i + 2) * 3 + 1);
-        const double zn3= pData->at(m_pMeshInfo->m_Index.at(i + 2) * 3 + 2);
-        const GLC_Vector3d vect3(xn3, yn3, zn3);
+	// The read data are not used anymore
+	pMeshInfo->m_Primitives.clear();
+	pMeshInfo->m_BulkDataHash.clear();
+	pMeshInfo->m_DataAccessorHash.clear();
+	pMeshInfo->m_Mapping.clear();
 
-		const GLC_Vector3d edge1(vect3 - vect2);
-		const GLC_Vector3d edge2(vect1 - vect2);
-
-		GLC_Vector3d normal(edge1 ^ edge2);
-		normal.normalize();
+	if (isValid)
+	{
+		// Add Bulk Data to the mesh
+		GLC_Mesh* pMesh= pMeshInfo->m_pMesh;
+		pMesh->addVertice(pMeshInfo->m_Datas.at(VERTEX));
+		pMesh->addNormals(pMeshInfo->m_Datas.at(NORMAL));
 
-		GLC_Vector3df curNormal= normal.toVector3df();
-		for (int curVertex= 0; curVertex < 3; ++curVertex)
+		// Add texel if necessary
+		if (!pMeshInfo->m_Datas.at(TEXCOORD).isEmpty())
 		{
-			(*pNormal)[m_pMeshInfo->m_Index.at(i + curVertex) * 3]= curNormal.x();
-			(*pNormal)[m_pMeshInfo->m_Index.at(i + curVertex) * 3 + 1]= curNormal.y();
-			(*pNormal)[m_pMeshInfo->m_Index.at(i + curVertex) * 3 + 2]= curNormal.z();
+			pMesh->addTexels(pMeshInfo->m_Datas.at(TEXCOORD));
 		}
 	}
+	pMeshInfo->m_Datas= QVector<GLfloatVector>(3);
 }
 
-// Load triangles
-void  GLC_ColladaToWorld::loadTriangles()
+// Add the de-indexed vertices of the given primitive to the given mesh info
+bool GLC_ColladaToWorld::addVerticesToMeshInfo(MeshInfo* pMeshInfo, const PrimitiveInfo& primitiveInfo, IndexList* pIndex) const
 {
-	//qDebug() << "GLC_ColladaToWorld::loadTriangles()";
-	// The material id
-	const QString materialId= readAttribute("material", false);
-
-	// Offsets and data source list
-	QList<InputData> inputDataList;
-
-	// triangle index list
-	QList<int> trianglesIndexList;
+	// The source of an input
+	struct Source
+	{
+		const QVector<float>* m_pValues;
+		QString m_Id;
+		int m_Offset;
+		Semantic m_Semantic;
+		int m_Stride;
+		int m_Size;
+	};
+
+	QString error;
+
+	// The sources are searched once for all the vertices, an input by semantic is used
+	QVector<Source> sources;
+	bool hasSemantic[3]= {false, false, false};
+	int maxOffset= 0;
+	const int inputDataCount= primitiveInfo.m_Inputs.size();
+	for (int dataIndex= 0; (dataIndex < inputDataCount) && error.isEmpty(); ++dataIndex)
+	{
+		const InputData& currentInputData= primitiveInfo.m_Inputs.at(dataIndex);
+		BulkDataHash::const_iterator iBulkHash= pMeshInfo->m_BulkDataHash.constFind(currentInputData.m_Source);
+		if (pMeshInfo->m_BulkDataHash.constEnd() == iBulkHash)
+		{
+			error= " Source : " + currentInputData.m_Source + " Not found";
+		}
+		else if (!hasSemantic[currentInputData.m_Semantic])
+		{
+			hasSemantic[currentInputData.m_Semantic]= true;
+			Source source;
+			source.m_pValues= &(iBulkHash.value());
+			source.m_Id= currentInputData.m_Source;
+			source.m_Offset= currentInputData.m_Offset;
+			source.m_Semantic= currentInputData.m_Semantic;
+			source.m_Size= (currentInputData.m_Semantic != TEXCOORD) ? 3 : 2;
+			DataAccessorHash::const_iterator iAccessor= pMeshInfo->m_DataAccessorHash.constFind(currentInputData.m_Source);
+			if (pMeshInfo->m_DataAccessorHash.constEnd() != iAccessor)
+			{
+				source.m_Stride= static_cast<int>(iAccessor.value().m_Stride);
+			}
+			else source.m_Stride= source.m_Size;
+			sources.append(source);
+		}
+		maxOffset= qMax(maxOffset, currentInputData.m_Offset);
+	}
+	if (error.isEmpty() && !hasSemantic[VERTEX])
+	{
+		error= "VERTEX input not found in " + pMeshInfo->m_pMesh->name();
+	}
 
-	while (endElementNotReached(m_pStreamReader, "triangles"))
+	// Fill the mapping, bulk data and index list of the mesh info in one pass
+	const int vertexIndexCount= maxOffset + 1;
+	const int sourceCount= sources.size();
+	const int indexCount= primitiveInfo.m_Index.size();
+	const int* pIndexValues= primitiveInfo.m_Index.constData();
+	QHash<ColladaVertice, GLuint>& mapping= pMeshInfo->m_Mapping;
+	QVector<GLfloatVector>& datas= pMeshInfo->m_Datas;
+	if (error.isEmpty()) pIndex->reserve(pIndex->size() + (indexCount / vertexIndexCount));
+	for (int i= 0; error.isEmpty() && ((i + maxOffset) < indexCount); i+= vertexIndexCount)
 	{
-		if (QXmlStreamReader::StartElement == m_pStreamReader->tokenType())
+		// Create and set the current vertice index
+		ColladaVertice currentVertice;
+		for (int sourceIndex= 0; sourceIndex < sourceCount; ++sourceIndex)
 		{
-            const QStringView currentElementName= m_pStreamReader->name();
-			if ((currentElementName == "input") && trianglesIndexList.isEmpty())
+			const Source& source= sources.at(sourceIndex);
+			currentVertice.m_Values[source.m_Semantic]= pIndexValues[i + source.m_Offset];
+		}
+
+		QHash<ColladaVertice, GLuint>::const_iterator iVertice= mapping.constFind(currentVertice);
+		if (mapping.constEnd() != iVertice)
+		{
+			pIndex->append(iVertice.value());
+		}
+		else
+		{
+			// Add the bulk data associated to the new vertice to the mesh info
+			for (int sourceIndex= 0; (sourceIndex < sourceCount) && error.isEmpty(); ++sourceIndex)
 			{
-				InputData currentInput;
-				// Get input data offset
-				currentInput.m_Offset= readAttribute("offset", true).toInt();
-				// Get input data semantic
-				const QString semantic= readAttribute("semantic", true);
-				if (semantic == "VERTEX") currentInput.m_Semantic= VERTEX;
-				else if (semantic == "NORMAL") currentInput.m_Semantic= NORMAL;
-				else if (semantic == "TEXCOORD") currentInput.m_Semantic= TEXCOORD;
-				else throwException("Source semantic :" + semantic + "Not supported");
-				// Get input data source id
-				currentInput.m_Source= readAttribute("source", true).remove('#');
-
-				// Bypasss vertices indirection
-				if (m_VerticesSourceHash.contains(currentInput.m_Source))
+				const Source& source= sources.at(sourceIndex);
+				const int valueIndex= currentVertice.m_Values[source.m_Semantic];
+				const qint64 firstValue= static_cast<qint64>(valueIndex) * source.m_Stride;
+				if ((valueIndex < 0) || ((firstValue + source.m_Size) > source.m_pValues->size()))
 				{
-					currentInput.m_Source= m_VerticesSourceHash.value(currentInput.m_Source);
+					error= "Index " + QString::number(valueIndex) + " out of source : " + source.m_Id;
 				}
-				inputDataList.append(currentInput);
-			}
-			else if ((currentElementName == "p") && trianglesIndexList.isEmpty())
-			{
-				{ // Fill index List
-					QString pString= getContent("p");
-					QStringList pStringList= pString.split(' ');
-					bool toIntOK;
-					const int size= pStringList.size();
-					for (int i= 0; i < size; ++i)
+				else
+				{
+					const float* pValue= source.m_pValues->constData() + firstValue;
+					GLfloatVector& data= datas[source.m_Semantic];
+					for (int k= 0; k < source.m_Size; ++k)
 					{
-						trianglesIndexList.append(pStringList.at(i).toInt(&toIntOK));
-						if (!toIntOK) throwException("Unable to convert string :" + pStringList.at(i) + " To int");
+						data.append(pValue[k]);
 					}
 				}
-
 			}
+			// Avoid problem wich occur with mesh containing materials with and without texture
+			if (!hasSemantic[TEXCOORD])
+			{
+				datas[TEXCOORD].append(0.0f);
+				datas[TEXCOORD].append(0.0f);
+			}
+
+			mapping.insert(currentVertice, pMeshInfo->m_FreeIndex);
+			pIndex->append((pMeshInfo->m_FreeIndex)++);
 		}
-		m_pStreamReader->readNext();
 	}
 
-	// Add the polylist to the current mesh
-	addTrianglesToCurrentMesh(inputDataList, trianglesIndexList, materialId);
-
-	updateProgressBar();
+	if (!error.isEmpty()) pMeshInfo->m_Error= error;
 
+	return error.isEmpty();
 }
 
-void GLC_ColladaToWorld::loadLineStrips()
+// Add the given polygons to the given mesh info
+bool GLC_ColladaToWorld::addPolygonsToMeshInfo(MeshInfo* pMeshInfo, const PrimitiveInfo& primitiveInfo) const
 {
-    // Offsets and data source list
-    InputData inputData;
+	// The mesh info index of the polygons vertices
+	IndexList polygonIndex;
+	bool subject= addVerticesToMeshInfo(pMeshInfo, primitiveInfo, &polygonIndex);
 
-    // triangle index list
-    QList<int> lineStripsIndexList;
+	// Check the polygons size
+	const int polygonCount= primitiveInfo.m_VCount.size();
+	qint64 vertexCount= 0;
+	qint64 triangleCount= 0;
+	for (int i= 0; subject && (i < polygonCount); ++i)
+	{
+		const int polygonSize= primitiveInfo.m_VCount.at(i);
+		subject= (polygonSize >= 0);
+		vertexCount+= polygonSize;
+		if (polygonSize > 2) triangleCount+= polygonSize - 2;
+	}
+	if (subject && (vertexCount > polygonIndex.size()))
+	{
+		subject= false;
+	}
+	if (!subject && pMeshInfo->m_Error.isEmpty())
+	{
+		pMeshInfo->m_Error= "Polygons size of " + pMeshInfo->m_pMesh->name() + " not match";
+	}
 
-    while (endElementNotReached(m_pStreamReader, "linestrips"))
-    {
-        if (QXmlStreamReader::StartElement == m_pStreamReader->tokenType())
-        {
-            const QStringView currentElementName= m_pStreamReader->name();
-            if ((currentElementName == "input") && lineStripsIndexList.isEmpty())
-            {
-                // Get input data offset
-                inputData.m_Offset= readAttribute("offset", true).toInt();
-                // Get input data semantic
-                const QString semantic= readAttribute("semantic", true);
-                if (semantic == "VERTEX") inputData.m_Semantic= VERTEX;
-                else throwException("Source semantic :" + semantic + "Not supported");
-                // Get input data source id
-                inputData.m_Source= readAttribute("source", true).remove('#');
+	if (subject)
+	{
+		bool hasNormals= false;
+		for (const InputData& inputData : primitiveInfo.m_Inputs)
+		{
+			hasNormals= hasNormals || (inputData.m_Semantic == NORMAL);
+		}
 
-                // Bypasss vertices indirection
-                if (m_VerticesSourceHash.contains(inputData.m_Source))
-                {
-                    inputData.m_Source= m_VerticesSourceHash.value(inputData.m_Source);
-                }
-            }
-            else if ((currentElementName == "p") && lineStripsIndexList.isEmpty())
-            {
-                { // Fill index List
-                    QString pString= getContent("p");
-                    QStringList pStringList= pString.split(' ');
-                    bool toIntOK;
-                    const int size= pStringList.size();
-                    for (int i= 0; i < size; ++i)
-                    {
-                        lineStripsIndexList.append(pStringList.at(i).toInt(&toIntOK));
-                        if (!toIntOK) throwException("Unable to convert string :" + pStringList.at(i) + " To int");
-                    }
-                }
+		// Save mesh info index offset
+		const int indexOffset= pMeshInfo->m_Index.size();
+		if ((triangleCount * 3) < (INT_MAX - indexOffset))
+		{
+			pMeshInfo->m_Index.reserve(indexOffset + static_cast<int>(triangleCount * 3));
+		}
 
-            }
-        }
-        m_pStreamReader->readNext();
-    }
+		// Triangulate the polygons of the primitive
+		// Input polygon index must start from 0 and succesive : (0 1 2 3 4)
+		QList<GLuint> onePolygonIndex;
+		int firstIndex= 0;
+		for (int i= 0; i < polygonCount; ++i)
+		{
+			const int polygonSize= primitiveInfo.m_VCount.at(i);
+			if (polygonSize == 3)
+			{
+				pMeshInfo->m_Index.append(polygonIndex.at(firstIndex));
+				pMeshInfo->m_Index.append(polygonIndex.at(firstIndex + 1));
+				pMeshInfo->m_Index.append(polygonIndex.at(firstIndex + 2));
+			}
+			else if (polygonSize > 3)
+			{
+				// Triangulate the current polygon if the polygon as more than 3 vertice
+				onePolygonIndex= polygonIndex.mid(firstIndex, polygonSize);
+				glc::triangulatePolygonClip2TRi(&onePolygonIndex, pMeshInfo->m_Datas.at(VERTEX));
+				if (!onePolygonIndex.isEmpty())
+				{
+					pMeshInfo->m_Index.append(onePolygonIndex);
+				}
+				else
+				{
+					QStringList stringList(m_FileName);
+					stringList.append("Unable to triangulate a polygon of " + pMeshInfo->m_pMesh->name());
+					GLC_ErrorLog::addError(stringList);
+				}
+			}
+			firstIndex+= polygonSize;
+		}
 
-    addLineStripsToCurrentMesh(inputData, lineStripsIndexList);
+		// Check if normal computation is needed
+		if (!hasNormals)
+		{
+			computeNormals(pMeshInfo, indexOffset);
+		}
 
-    updateProgressBar();
+		// Add material the mesh info
+		MatOffsetSize matInfo;
+		matInfo.m_Offset= indexOffset;
+		matInfo.m_size= pMeshInfo->m_Index.size() - indexOffset;
+		pMeshInfo->m_Materials.insert(primitiveInfo.m_MaterialId, matInfo);
+	}
 
+	return subject;
 }
 
-// Add the triangles to current mesh
-void GLC_ColladaToWorld::addTrianglesToCurrentMesh(const QList<InputData>& inputDataList, const QList<int>& trianglesIndexList, const QString& materialId)
+// Add the given triangles to the given mesh info
+bool GLC_ColladaToWorld::addTrianglesToMeshInfo(MeshInfo* pMeshInfo, const PrimitiveInfo& primitiveInfo) const
 {
-	//qDebug() << "GLC_ColladaToWorld::addTrianglesToCurrentMesh";
-
-	const int inputDataCount= inputDataList.size();
-	const int trianglesIndexCount= trianglesIndexList.size();
-
-	// Flag to know if the polylist has normal
-	bool hasNormals= false;
-	bool hasTexture= false;
+	// Save mesh info index offset
+	const int indexOffset= pMeshInfo->m_Index.size();
 
-	// Check the existance of data source
-	for (int dataIndex= 0; dataIndex < inputDataCount; ++dataIndex)
+	// The triangles index are added to the mesh info index
+	const bool subject= addVerticesToMeshInfo(pMeshInfo, primitiveInfo, &(pMeshInfo->m_Index));
+	if (subject)
 	{
-		const QString source= inputDataList.at(dataIndex).m_Source;
-		if ( !m_BulkDataHash.contains(source))
+		// Remove the index of an incomplete triangle
+		const int triangleCount= (pMeshInfo->m_Index.size() - indexOffset) / 3;
+		pMeshInfo->m_Index.resize(indexOffset + triangleCount * 3);
+
+		bool hasNormals= false;
+		for (const InputData& inputData : primitiveInfo.m_Inputs)
 		{
-			throwException(" Source : " + source + " Not found");
+			hasNormals= hasNormals || (inputData.m_Semantic == NORMAL);
 		}
-		if (inputDataList.at(dataIndex).m_Semantic == NORMAL) hasNormals= true;
-		if (inputDataList.at(dataIndex).m_Semantic == TEXCOORD) hasTexture= true;
-	}
 
-	int maxOffset= 0;
-	for (int i= 0; i < inputDataCount; ++i)
-	{
-		if (inputDataList.at(i).m_Offset > maxOffset)
+		// Check if normal computation is needed
+		if (!hasNormals)
 		{
-			maxOffset= inputDataList.at(i).m_Offset;
+			computeNormals(pMeshInfo, indexOffset);
 		}
+
+		// Add material the mesh info
+		MatOffsetSize matInfo;
+		matInfo.m_Offset= indexOffset;
+		matInfo.m_size= pMeshInfo->m_Index.size() - indexOffset;
+		pMeshInfo->m_Materials.insert(primitiveInfo.m_MaterialId, matInfo);
 	}
-	//qDebug() << " Triangles Max Offset :" << maxOffset;
 
-	// the polygonIndex of the polylist
-	QList<GLuint> trianglesIndex;
+	return subject;
+}
 
-	// Fill the mapping, bulk data and index list of the current mesh info
-	for (int i= 0; i < trianglesIndexCount; i+= maxOffset + 1)
+// Add the given line strips to the given mesh info
+bool GLC_ColladaToWorld::addLineStripsToMeshInfo(MeshInfo* pMeshInfo, const PrimitiveInfo& primitiveInfo) const
+{
+	bool subject= true;
+	if (!primitiveInfo.m_Inputs.isEmpty())
 	{
-		// Create and set the current vertice index
-		ColladaVertice currentVertice;
-		for (int dataIndex= 0; dataIndex < inputDataCount; ++dataIndex)
+		const InputData& inputData= primitiveInfo.m_Inputs.first();
+		BulkDataHash::const_iterator iBulkHash= pMeshInfo->m_BulkDataHash.constFind(inputData.m_Source);
+		subject= (pMeshInfo->m_BulkDataHash.constEnd() != iBulkHash);
+		if (!subject)
 		{
-			currentVertice.m_Values[inputDataList.at(dataIndex).m_Semantic]= trianglesIndexList.at(i + inputDataList.at(dataIndex).m_Offset);
+			pMeshInfo->m_Error= " Source : " + inputData.m_Source + " Not found";
 		}
 
-		if (m_pMeshInfo->m_Mapping.contains(currentVertice))
+		const int stride= 3;
+		const int vertexIndexCount= inputData.m_Offset + 1;
+		const int stripCount= primitiveInfo.m_VCount.size();
+		int firstIndex= 0;
+		for (int stripIndex= 0; subject && (stripIndex < stripCount); ++stripIndex)
 		{
-			// Add the the index to the triangles index
-			trianglesIndex.append(m_pMeshInfo->m_Mapping.value(currentVertice));
-		}
-		else
-		{
-			// Add the current vertice to the current mesh info mapping hash table and increment the freeIndex
-			m_pMeshInfo->m_Mapping.insert(currentVertice, (m_pMeshInfo->m_FreeIndex)++);
-			// Add the the index to the triangles index
-			trianglesIndex.append(m_pMeshInfo->m_Mapping.value(currentVertice));
-
-			// Add the bulk data associated to the current vertice to the current mesh info
-			for (int dataIndex= 0; dataIndex < inputDataCount; ++dataIndex)
+			const int vertexCount= primitiveInfo.m_VCount.at(stripIndex);
+			GLfloatVector verticeGroup(vertexCount * stride);
+			for (int i= 0; subject && (i < vertexCount); ++i)
 			{
-				// The current input data
-				InputData currentInputData= inputDataList.at(dataIndex);
-				// QHash iterator on the right QList<float>
-				BulkDataHash::const_iterator iBulkHash= m_BulkDataHash.find(currentInputData.m_Source);
-				int stride;
-				if (m_DataAccessorHash.contains(currentInputData.m_Source))
-				{
-					stride= m_DataAccessorHash.value(currentInputData.m_Source).m_Stride;
-				}
-				else if (currentInputData.m_Semantic != TEXCOORD) stride= 3; else stride= 2;
-				// Firts value
-				m_pMeshInfo->m_Datas[currentInputData.m_Semantic].append(iBulkHash.value().at(trianglesIndexList.at(i + currentInputData.m_Offset) * stride));
-				// Second value
-				m_pMeshInfo->m_Datas[currentInputData.m_Semantic].append(iBulkHash.value().at(trianglesIndexList.at(i + currentInputData.m_Offset) * stride + 1));
-				// Fird value
-				if (currentInputData.m_Semantic != TEXCOORD)
+				const int valueIndex= primitiveInfo.m_Index.at(firstIndex + i * vertexIndexCount + inputData.m_Offset);
+				const qint64 firstValue= static_cast<qint64>(valueIndex) * stride;
+				subject= (valueIndex >= 0) && ((firstValue + stride) <= iBulkHash.value().size());
+				if (subject)
 				{
-					m_pMeshInfo->m_Datas[currentInputData.m_Semantic].append(iBulkHash.value().at(trianglesIndexList.at(i + currentInputData.m_Offset) * stride + 2));
+					const float* pValue= iBulkHash.value().constData() + firstValue;
+					verticeGroup[i * stride]= pValue[0];
+					verticeGroup[i * stride + 1]= pValue[1];
+					verticeGroup[i * stride + 2]= pValue[2];
 				}
-				// Avoid problem wich occur with mesh containing materials with and without texture
-				if (!hasTexture)
+				else
 				{
-					m_pMeshInfo->m_Datas[TEXCOORD].append(0.0);
+					pMeshInfo->m_Error= "Index " + QString::number(valueIndex) + " out of source : " + inputData.m_Source;
 				}
 			}
+			if (subject && (vertexCount > 1))
+			{
+				pMeshInfo->m_pMesh->addVerticeGroup(verticeGroup);
+			}
+			firstIndex+= vertexCount * vertexIndexCount;
 		}
 	}
 
-	// Save mesh info index offset
-	const int indexOffset= m_pMeshInfo->m_Index.size();
+	return subject;
+}
 
-	// Add index to the mesh info
-	m_pMeshInfo->m_Index.append(trianglesIndex);
+// Compute Normals of the given mesh info
+void GLC_ColladaToWorld::computeNormals(MeshInfo* pMeshInfo, int indexOffset)
+{
+	// Fill the list of normal
+	GLfloatVector& normals= pMeshInfo->m_Datas[NORMAL];
+	const GLfloatVector& data= pMeshInfo->m_Datas.at(VERTEX);
+	normals.resize(data.size());
 
-	// Check if normal computation is needed
-	if (!hasNormals)
+	// Compute the normals and add them to the mesh info
+	const IndexList& index= pMeshInfo->m_Index;
+	const int size= index.size();
+	for (int i= indexOffset; (i + 2) < size; i+=3)
 	{
-		computeNormalOfCurrentPrimitiveOfCurrentMesh(indexOffset);
-	}
+		// Vertex 1
+		const int first1= index.at(i) * 3;
+		const GLC_Vector3d vect1(data.at(first1), data.at(first1 + 1), data.at(first1 + 2));
 
-	// Add material the current mesh info
-	MatOffsetSize matInfo;
-	matInfo.m_Offset= indexOffset;
-	matInfo.m_size= m_pMeshInfo->m_Index.size() - indexOffset;
-    m_pMeshInfo->m_Materials.insert(materialId, matInfo);
+		// Vertex 2
+		const int first2= index.at(i + 1) * 3;
+		const GLC_Vector3d vect2(data.at(first2), data.at(first2 + 1), data.at(first2 + 2));
 
-}
+		// Vertex 3
+		const int first3= index.at(i + 2) * 3;
+		const GLC_Vector3d vect3(data.at(first3), data.at(first3 + 1), data.at(first3 + 2));
 
-void GLC_ColladaToWorld::addLineStripsToCurrentMesh(const GLC_ColladaToWorld::InputData& inputData, const QList<int> lineStripsIndexList)
-{
-    const int indexCount= lineStripsIndexList.size();
+		const GLC_Vector3d edge1(vect3 - vect2);
+		const GLC_Vector3d edge2(vect1 - vect2);
 
-    if ( !m_BulkDataHash.contains(inputData.m_Source))
-    {
-        throwException(" Source : " + inputData.m_Source + " Not found");
-    }
+		GLC_Vector3d normal(edge1 ^ edge2);
+		normal.normalize();
 
-    GLC_Mesh* pMesh= m_pMeshInfo->m_pMesh;
-    BulkDataHash::const_iterator iBulkHash= m_BulkDataHash.find(inputData.m_Source);
-    const int stride= 3;
-    GLfloatVector verticeGroup(indexCount * stride);
-    for (int i= 0; i < indexCount; ++i)
-    {
-        verticeGroup[i * stride]= iBulkHash.value().at(lineStripsIndexList.at(i + inputData.m_Offset) * stride);
-        verticeGroup[i * stride + 1]= iBulkHash.value().at(lineStripsIndexList.at(i + inputData.m_Offset) * stride + 1);
-        verticeGroup[i * stride + 2]= iBulkHash.value().at(lineStripsIndexList.at(i + inputData.m_Offset) * stride + 2);
-    }
-    pMesh->addVerticeGroup(verticeGroup);
+		GLC_Vector3df curNormal= normal.toVector3df();
+		for (int curVertex= 0; curVertex < 3; ++curVertex)
+		{
+			const int first= index.at(i + curVertex) * 3;
+			normals[first]= curNormal.x();
+			normals[first + 1]= curNormal.y();
+			normals[first + 2]= curNormal.z();
+		}
+	}
 }
 
 // Load the library nodes
@@ -1919,24 +2209,7 @@ void GLC_ColladaToWorld::createMesh()
 	while (m_GeometryHash.constEnd() != iMeshInfo)
 	{
 		MeshInfo* pCurrentMeshInfo= iMeshInfo.value();
-		// Add Bulk Data to the mesh
-		// Add vertice
-		pCurrentMeshInfo->m_pMesh->addVertice(pCurrentMeshInfo->m_Datas.at(VERTEX).toVector());
-		//qDebug() << "Add " << pCurrentMeshInfo->m_Datas[VERTEX].size() << " Vertice";
-		pCurrentMeshInfo->m_Datas[VERTEX].clear();
-
-		// Add Normal
-		pCurrentMeshInfo->m_pMesh->addNormals(pCurrentMeshInfo->m_Datas.at(NORMAL).toVector());
-		//qDebug() << "Add " << pCurrentMeshInfo->m_Datas[NORMAL].size() << " Normal";
-		pCurrentMeshInfo->m_Datas[NORMAL].clear();
-
-		// Add texel if necessary
-		//qDebug() << "Add " << pCurrentMeshInfo->m_Datas[TEXCOORD].size() << " texel";
-		if (!pCurrentMeshInfo->m_Datas.at(TEXCOORD).isEmpty())
-		{
-			pCurrentMeshInfo->m_pMesh->addTexels(pCurrentMeshInfo->m_Datas.at(TEXCOORD).toVector());
-			pCurrentMeshInfo->m_Datas[TEXCOORD].clear();
-		}
+		// The bulk data have been added to the mesh when the mesh info has been built
 
 		// Add face index and material to the mesh
         QMultiHash<QString, MatOffsetSize>::iterator iMatInfo= pCurrentMeshInfo->m_Materials.begin();
@@ -1973,11 +2246,7 @@ void GLC_ColladaToWorld::createMesh()
 			const int offset= iMatInfo.value().m_Offset;
 			const int size= iMatInfo.value().m_size;
 			//qDebug() << "Offset : " << offset << " size : " << size;
-			QList<GLuint> triangles;
-			for (int i= offset; i < (offset + size); ++i)
-			{
-				triangles.append(pCurrentMeshInfo->m_Index.at(i));
-			}
+			const IndexList triangles(pCurrentMeshInfo->m_Index.mid(offset, size));
 			//qDebug() << "Add " << triangles.size() << " elment to the triangle index";
 			// Add the list of triangle to the mesh
 			if (!triangles.isEmpty())
@@ -1987,6 +2256,7 @@ void GLC_ColladaToWorld::createMesh()
 
 			++iMatInfo;
 		}
+		pCurrentMeshInfo->m_Index.clear();
 		pCurrentMeshInfo->m_pMesh->finish();
 		GLC_3DRep* pRep= new GLC_3DRep(pCurrentMeshInfo->m_pMesh);
 		pCurrentMeshInfo->m_pMesh= NULL;
@@ -29,6 +29,8 @@
 #include <QFile>
 #include <QXmlStreamReader>
 #include <QHash>
+#include <QVector>
+#include <QFuture>
 #include <QColor>
 
 #include "../shading/glc_material.h"
@@ -38,6 +40,11 @@
 #include "../glc_config.h"
 
 class GLC_World;
+class GLC_InputData;
+
+QT_BEGIN_NAMESPACE
+class QBuffer;
+QT_END_NAMESPACE
 
 //////////////////////////////////////////////////////////////////////
 //! \class GLC_ColladaToWorld
@@ -68,14 +75,13 @@ public:
 	struct ColladaVertice
 	{
 		ColladaVertice()
-		: m_Values(3)
 		{
 			m_Values[0]= 0;
 			m_Values[1]= 0;
 			m_Values[2]= 0;
 		}
 
-		QVector<int> m_Values;
+		int m_Values[3];
 	};
 private:
 
@@ -99,22 +105,57 @@ private:
 		unsigned int m_Stride;
 	};
 
+	typedef QHash<const QString, QVector<float> > BulkDataHash;
+	typedef QHash<const QString, Accessor> DataAccessorHash;
+
+	// The supported primitive elements
+	enum PrimitiveType
+	{
+		Polygons,
+		Triangles,
+		LineStrips
+	};
+
+	// A primitive element read and not yet added to its mesh
+	struct PrimitiveInfo
+	{
+		PrimitiveType m_Type;
+		// Offsets and data source list
+		QList<InputData> m_Inputs;
+		// Polygon number of vertice list
+		QVector<int> m_VCount;
+		// Index list
+		QVector<int> m_Index;
+		// The material id
+		QString m_MaterialId;
+	};
+
 	// The loading mesh info
 	struct MeshInfo
 	{
 		MeshInfo()
 		: m_pMesh(NULL)
+		, m_BulkDataHash()
+		, m_DataAccessorHash()
+		, m_Primitives()
 		, m_Datas(3)
 		, m_Mapping()
 		, m_Index()
         , m_FreeIndex(0)
+		, m_Error()
 		{}
 
 		~MeshInfo() {delete m_pMesh;}
 		// Mesh of the mesh info
 		GLC_Mesh* m_pMesh;
+		// Bulk data of the sources of the mesh
+		BulkDataHash m_BulkDataHash;
+		// Data accessor of the sources of the mesh
+		DataAccessorHash m_DataAccessorHash;
+		// The primitive elements of the mesh
+		QList<PrimitiveInfo> m_Primitives;
 		// Bulk data vector (Position, normal, texel)
-		QVector<QList<float> > m_Datas;
+		QVector<GLfloatVector> m_Datas;
 		// Mapping between collada vertice and index
 		QHash<ColladaVertice, GLuint> m_Mapping;
 		// Triangle index
@@ -123,6 +164,8 @@ private:
 		GLuint m_FreeIndex;
 		// QHash containing material id and associated offset and size
         QMultiHash<QString, MatOffsetSize> m_Materials;
+		// Error which occurs while building the mesh info
+		QString m_Error;
 	};
 
 	// The collada Node
@@ -152,8 +195,6 @@ private:
 	};
 
 	typedef QHash<const QString, GLC_Material*> MaterialHash;
-	typedef QHash<const QString, QList<float> > BulkDataHash;
-	typedef QHash<const QString, Accessor> DataAccessorHash;
 //////////////////////////////////////////////////////////////////////
 /*! @name Constructor / Destructor */
 //@{
@@ -174,6 +215,9 @@ public:
 	//! Create an GLC_World from an input Collada File
 	GLC_World* CreateWorldFromCollada(QFile &);
 
+	//! Create an GLC_World from the given Collada data, images are searched next to the data file name
+	GLC_World* CreateWorldFromCollada(const GLC_InputData& input);
+
 	//! Get the list of attached files
 	inline QStringList listOfAttachedFileName() const
     {return m_ListOfAttachedFileName.values();}
@@ -200,6 +244,12 @@ private:
 	// Return the content of an element
 	QString getContent(const QString&);
 
+	//! Read the numbers of the specified array element in the given vector
+	void readFloatArray(const QString&, QVector<float>*);
+
+	//! Read the integers of the specified array element in the given vector
+	void readIntArray(const QString&, QVector<int>*);
+
 	//! Read the specified attribute
 	QString readAttribute(const QString&, bool required= false);
 
@@ -291,21 +341,39 @@ private:
 	//! Load Polygons
 	void loadPolygons();
 
-	//! Add the polylist to the current mesh
-	void addPolylistToCurrentMesh(const QList<InputData>&, const QList<int>&, const QList<int>&, const QString&);
-
-	//! Compute Normals for the current primitive element of the current mesh from the specified offset
-	void computeNormalOfCurrentPrimitiveOfCurrentMesh(int offset);
+	//! Load the input of a primitive element and return it
+	InputData loadInput();
 
 	//! Load triangles
 	void loadTriangles();
 
     void loadLineStrips();
 
-	//! Add the triangles to current mesh
-	void addTrianglesToCurrentMesh(const QList<InputData>&, const QList<int>&, const QString&);
+	//! Build the pending mesh infos in parallel while the next ones are read
+	/*! Waits for the build of the previous mesh infos*/
+	void buildPendingMeshInfos();
+
+	//! Wait for the build of the mesh infos, throw an exception if a build failed
+	void waitForMeshInfos();
+
+	//! Add the primitives to the mesh of the given mesh info, can be called from any thread
+	void buildMeshInfo(MeshInfo*) const;
+
+	//! Add the de-indexed vertices of the given primitive to the given mesh info
+	/*! Return false and set the mesh info error if the primitive is not valid*/
+	bool addVerticesToMeshInfo(MeshInfo*, const PrimitiveInfo&, IndexList*) const;
+
+	//! Add the given polygons to the given mesh info
+	bool addPolygonsToMeshInfo(MeshInfo*, const PrimitiveInfo&) const;
+
+	//! Add the given triangles to the given mesh info
+	bool addTrianglesToMeshInfo(MeshInfo*, const PrimitiveInfo&) const;
 
-    void addLineStripsToCurrentMesh(const InputData& inputData, const QList<int> lineStripsIndexList);
+	//! Add the given line strips to the given mesh info
+	bool addLineStripsToMeshInfo(MeshInfo*, const PrimitiveInfo&) const;
+
+	//! Compute Normals of the given mesh info from the specified offset
+	static void computeNormals(MeshInfo*, int offset);
 
 	//! Load the library nodes
 	void loadLibraryNodes();
@@ -377,8 +445,8 @@ private:
 	//! The collada fileName
 	QString m_FileName;
 
-	//! The collada file
-	QFile* m_pFile;
+	//! The buffer on the collada data
+	QBuffer* m_pBuffer;
 
 	//! Map image id to image file name
 	QHash<QString, QString> m_ImageFileHash;
@@ -401,12 +469,6 @@ private:
 	//! Texture to material link
 	MaterialHash m_TextureToMaterialHash;
 
-	//! Bulk data hash table
-	BulkDataHash m_BulkDataHash;
-
-	//! Data accessor hash
-	DataAccessorHash m_DataAccessorHash;
-
 	//! Map vertices id to source data id
 	QHash<QString, QString> m_VerticesSourceHash;
 
@@ -416,6 +478,15 @@ private:
 	//! Hash table off geometry (MeshInfo*)
 	QHash<const QString, MeshInfo*> m_GeometryHash;
 
+	//! The mesh infos read and not yet built
+	QList<MeshInfo*> m_PendingMeshInfos;
+
+	//! The mesh infos being built
+	QList<MeshInfo*> m_BuildingMeshInfos;
+
+	//! The build of the mesh infos in progress
+	QFuture<void> m_MeshInfoFuture;
+
 	//! Hash table off collada node
 	QHash<const QString, ColladaNode*> m_ColladaNodeHash;
 
@@ -450,9 +521,9 @@ private:
 
 // To use ColladaVertice as a QHash key
 inline bool operator==(const GLC_ColladaToWorld::ColladaVertice& vertice1, const GLC_ColladaToWorld::ColladaVertice& vertice2)
-{ return (vertice1.m_Values == vertice2.m_Values);}
+{ return (vertice1.m_Values[0] == vertice2.m_Values[0]) && (vertice1.m_Values[1] == vertice2.m_Values[1]) && (vertice1.m_Values[2] == vertice2.m_Values[2]);}
 
-inline uint qHash(const GLC_ColladaToWorld::ColladaVertice& vertice)
-{ return qHash(QString::number(vertice.m_Values.at(0)) + QString::number(vertice.m_Values.at(1)) + QString::number(vertice.m_Values.at(2)));}
+inline size_t qHash(const GLC_ColladaToWorld::ColladaVertice& vertice, size_t seed= 0)
+{ return qHashMulti(seed, vertice.m_Values[0], vertice.m_Values[1], vertice.m_Values[2]);}
 
 #endif /* GLC_COLLADATOWORLD_H_ */
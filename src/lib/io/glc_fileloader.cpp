@@ -33,12 +33,17 @@
 #include "glc_3dxmltoworld.h"
 #include "glc_colladatoworld.h"
 #include "glc_bsreptoworld.h"
+#include "glc_glcwtoworld.h"
+#include "glc_worldtoglcw.h"
+#include "glc_inputdata.h"
 
 #include "../sceneGraph/glc_world.h"
 #include "../glc_fileformatexception.h"
 #include "../glc_factory.h"
 #include "glc_worldreaderplugin.h"
 
+bool GLC_FileLoader::m_MaterialMergingIsEnabled= false;
+
 //////////////////////////////////////////////////////////////////////
 // Constructor
 //////////////////////////////////////////////////////////////////////
@@ -82,6 +87,7 @@ GLC_World GLC_FileLoader::createWorldFromFile(QFile &file, QStringList* pAttache
 			}
 
 			delete pReaderHandler;
+			finishWorld(resultWorld);
 			return resultWorld;
 		}
 	}
@@ -138,6 +144,17 @@ GLC_World GLC_FileLoader::createWorldFromFile(QFile &file, QStringList* pAttache
 			(*pAttachedFileName)= colladaToWorld.listOfAttachedFileName();
 		}
 	}
+	else if (QFileInfo(file).suffix().toLower() == GLC_WorldToGlcw::suffix())
+	{
+		// Only the structure is loaded, representations are loaded on demand
+		GLC_GlcwToWorld glcwToWorld;
+		connect(&glcwToWorld, SIGNAL(currentQuantum(int)), this, SIGNAL(currentQuantum(int)));
+		pWorld= glcwToWorld.createWorldFromGlcw(file);
+        if (nullptr != pAttachedFileName)
+		{
+			(*pAttachedFileName)= glcwToWorld.listOfAttachedFileName();
+		}
+	}
 	else if (QFileInfo(file).suffix().toLower() == "bsrep")
 	{
 		GLC_BSRepToWorld bsRepToWorld;
@@ -154,14 +171,33 @@ GLC_World GLC_FileLoader::createWorldFromFile(QFile &file, QStringList* pAttache
 	}
 	GLC_World resulWorld(*pWorld);
 	delete pWorld;
+	finishWorld(resulWorld);
 
     return resulWorld;
 }
 
 GLC_World GLC_FileLoader::createWorldFromIoDevice(QIODevice* pDevice, const QString suffix)
 {
-
     GLC_World subject;
+
+    const GLC_InputData input(GLC_InputData::fromDevice(pDevice));
+    if (!input.isNull())
+    {
+        try
+        {
+            subject= createWorldFromInputData(input, suffix);
+        }
+        catch (GLC_FileFormatException&)
+        {
+            return GLC_World();
+        }
+    }
+
+    return subject;
+}
+
+GLC_World GLC_FileLoader::createWorldFromInputData(const GLC_InputData& input, const QString& suffix, QStringList* pAttachedFileName)
+{
 #if defined(Q_OS_WIN)
     // We need to force the connection type on Windows, not sure why:
     // Qt::DirectConnection should be selected automatically since
@@ -170,27 +206,93 @@ GLC_World GLC_FileLoader::createWorldFromIoDevice(QIODevice* pDevice, const QStr
         connect(snd, sig, rcv, memb, Qt::DirectConnection)
 #endif
 
+    const QString lowerSuffix= suffix.toLower();
     GLC_World* pWorld= nullptr;
-    if (suffix.toLower() == "3dxml")
+    if (lowerSuffix == "obj")
+    {
+        GLC_ObjToWorld objToWorld;
+        connect(&objToWorld, SIGNAL(currentQuantum(int)), this, SIGNAL(currentQuantum(int)));
+        pWorld= objToWorld.CreateWorldFromObj(input);
+        if (nullptr != pAttachedFileName)
+        {
+            (*pAttachedFileName)= objToWorld.listOfAttachedFileName();
+        }
+    }
+    else if (lowerSuffix == "stl")
+    {
+        GLC_StlToWorld stlToWorld;
+        connect(&stlToWorld, SIGNAL(currentQuantum(int)), this, SIGNAL(currentQuantum(int)));
+        pWorld= stlToWorld.CreateWorldFromStl(input);
+    }
+    else if (lowerSuffix == "off")
+    {
+        GLC_OffToWorld offToWorld;
+        connect(&offToWorld, SIGNAL(currentQuantum(int)), this, SIGNAL(currentQuantum(int)));
+        pWorld= offToWorld.CreateWorldFromOff(input);
+    }
+    else if (lowerSuffix == "3ds")
+    {
+        GLC_3dsToWorld studioToWorld;
+        connect(&studioToWorld, SIGNAL(currentQuantum(int)), this, SIGNAL(currentQuantum(int)));
+        pWorld= studioToWorld.CreateWorldFrom3ds(input);
+        if (nullptr != pAttachedFileName)
+        {
+            (*pAttachedFileName)= studioToWorld.listOfAttachedFileName();
+        }
+    }
+    else if (lowerSuffix == "3dxml")
     {
         GLC_3dxmlToWorld d3dxmlToWorld;
         connect(&d3dxmlToWorld, SIGNAL(currentQuantum(int)), this, SIGNAL(currentQuantum(int)));
-        try
+        pWorld= d3dxmlToWorld.createWorldFrom3dxml(input);
+        if (nullptr != pAttachedFileName)
+        {
+            (*pAttachedFileName)= d3dxmlToWorld.listOfAttachedFileName();
+        }
+    }
+    else if (lowerSuffix == "dae")
+    {
+        GLC_ColladaToWorld colladaToWorld;
+        connect(&colladaToWorld, SIGNAL(currentQuantum(int)), this, SIGNAL(currentQuantum(int)));
+        pWorld= colladaToWorld.CreateWorldFromCollada(input);
+        if (nullptr != pAttachedFileName)
         {
-            pWorld= d3dxmlToWorld.createWorldFrom3dxml(pDevice);
+            (*pAttachedFileName)= colladaToWorld.listOfAttachedFileName();
         }
-        catch (GLC_FileFormatException &e)
+    }
+    else if (lowerSuffix == GLC_WorldToGlcw::suffix())
+    {
+        GLC_GlcwToWorld glcwToWorld;
+        connect(&glcwToWorld, SIGNAL(currentQuantum(int)), this, SIGNAL(currentQuantum(int)));
+        pWorld= glcwToWorld.createWorldFromGlcw(input);
+        if (nullptr != pAttachedFileName)
         {
-            delete pWorld;
-            return subject;
+            (*pAttachedFileName)= glcwToWorld.listOfAttachedFileName();
         }
     }
 
-    if (nullptr != pWorld)
+    if (nullptr == pWorld)
     {
-        subject= (*pWorld);
-        delete pWorld;
+        // Format not recognize or data not loaded
+        QString message(QString("GLC_FileLoader::createWorldFromInputData Data ") + input.fileName() + QString(" not loaded"));
+        GLC_FileFormatException fileFormatException(message, input.fileName(), GLC_FileFormatException::FileNotSupported);
+        throw(fileFormatException);
     }
+    GLC_World subject(*pWorld);
+    delete pWorld;
+    finishWorld(subject);
 
     return subject;
 }
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_FileLoader::finishWorld(GLC_World& world)
+{
+    if (m_MaterialMergingIsEnabled)
+    {
+        world.mergeEqualMaterials();
+    }
+}
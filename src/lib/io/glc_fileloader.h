@@ -36,6 +36,7 @@
 #include "../glc_config.h"
 
 class GLC_World;
+class GLC_InputData;
 
 //////////////////////////////////////////////////////////////////////
 //! \class GLC_FileLoader
@@ -59,16 +60,45 @@ public:
 	virtual ~GLC_FileLoader();
 //@}
 //////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return true if equal materials of loaded worlds are merged
+	static bool materialMergingIsEnabled()
+	{return m_MaterialMergingIsEnabled;}
+
+//@}
+//////////////////////////////////////////////////////////////////////
 /*! @name Set Functions*/
 //@{
 //////////////////////////////////////////////////////////////////////
 public:
+	//! Set merging of equal materials of loaded worlds enabled (Disabled by default)
+	/*! See GLC_World::mergeEqualMaterials()*/
+	static void setMaterialMergingEnabled(bool enabled)
+	{m_MaterialMergingIsEnabled= enabled;}
+
 	//! Create a GLC_World from a file
 	GLC_World createWorldFromFile(QFile &file, QStringList* pAttachedFileName= NULL);
 
+	//! Create a GLC_World from the content of the given device with the given format suffix
+	/*! Files are mapped and buffers are read without copy. Return an empty world if the content can't be loaded*/
     GLC_World createWorldFromIoDevice(QIODevice* pDevice, const QString suffix);
+
+	//! Create a GLC_World from the given input data with the given format suffix
+	/*! The data is read in place, see GLC_InputData. Files referenced by the model are searched next to
+	 *  the input data file name. Throw a GLC_FileFormatException if the data can't be loaded*/
+	GLC_World createWorldFromInputData(const GLC_InputData& input, const QString& suffix, QStringList* pAttachedFileName= NULL);
 //@}
 
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Apply the loading options to the given loaded world
+	static void finishWorld(GLC_World& world);
+
 
 //////////////////////////////////////////////////////////////////////
 // Qt Signals
@@ -80,6 +110,8 @@ public:
 // Private members
 //////////////////////////////////////////////////////////////////////
 private:
+	//! Material merging flag
+	static bool m_MaterialMergingIsEnabled;
 };
 
 #endif /*GLC_FILELOADER_H_*/
@@ -0,0 +1,805 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_glcwtoworld.cpp implementation of the GLC_GlcwToWorld class.
+
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSet>
+#include <QtEndian>
+
+#include <climits>
+
+#include "glc_glcwtoworld.h"
+#include "glc_worldtoglcw.h"
+#include "../geometry/glc_mesh.h"
+#include "../sceneGraph/glc_world.h"
+#include "../sceneGraph/glc_structoccurrence.h"
+#include "../sceneGraph/glc_structinstance.h"
+#include "../sceneGraph/glc_structreference.h"
+#include "../sceneGraph/glc_attributes.h"
+#include "../shading/glc_material.h"
+#include "../glc_fileformatexception.h"
+#include "../glc_errorlog.h"
+
+namespace
+{
+    template <typename T>
+    T readValue(const char* pData)
+    {
+        return qFromLittleEndian<T>(pData);
+    }
+
+    QColor readColor(const char* pData)
+    {
+        return QColor::fromRgbF(readValue<float>(pData), readValue<float>(pData + 4),
+                                readValue<float>(pData + 8), readValue<float>(pData + 12));
+    }
+
+    // Minimum record size of the sections known by this reader
+    quint32 knownRecordSize(int type)
+    {
+        switch (type)
+        {
+        case GLC_WorldToGlcw::StringOffsetSection: return GLC_WorldToGlcw::StringOffsetRecordSize;
+        case GLC_WorldToGlcw::StringDataSection: return 1;
+        case GLC_WorldToGlcw::AttributeSection: return GLC_WorldToGlcw::AttributeRecordSize;
+        case GLC_WorldToGlcw::TextureSection: return GLC_WorldToGlcw::TextureRecordSize;
+        case GLC_WorldToGlcw::MaterialSection: return GLC_WorldToGlcw::MaterialRecordSize;
+        case GLC_WorldToGlcw::RepresentationMaterialSection: return GLC_WorldToGlcw::RepresentationMaterialRecordSize;
+        case GLC_WorldToGlcw::RepresentationSection: return GLC_WorldToGlcw::RepresentationRecordSize;
+        case GLC_WorldToGlcw::ReferenceSection: return GLC_WorldToGlcw::ReferenceRecordSize;
+        case GLC_WorldToGlcw::InstanceSection: return GLC_WorldToGlcw::InstanceRecordSize;
+        case GLC_WorldToGlcw::OccurrenceSection: return GLC_WorldToGlcw::OccurrenceRecordSize;
+        default: return 0;
+        }
+    }
+}
+
+// Static member initialization
+QList<QSharedPointer<GLC_GlcwToWorld::OpenedFile> > GLC_GlcwToWorld::m_OpenedFiles;
+QMutex GLC_GlcwToWorld::m_OpenedFilesMutex;
+
+GLC_GlcwToWorld::Section::Section()
+    : m_pData(nullptr)
+    , m_RecordSize(0)
+    , m_RecordCount(0)
+{
+
+}
+
+GLC_GlcwToWorld::MaterialCache::MaterialCache()
+    : m_Materials()
+    , m_UsageId(0)
+    , m_Mutex()
+{
+
+}
+
+GLC_GlcwToWorld::OpenedFile::OpenedFile()
+    : m_FilePath()
+    , m_LastModified(0)
+    , m_Input()
+    , m_Sections()
+    , m_MaterialCache()
+{
+    m_MaterialCache.m_UsageId= glc::GLC_GenID();
+}
+
+GLC_GlcwToWorld::OpenedFile::~OpenedFile()
+{
+    // Materials still used by loaded representations are kept
+    QHash<int, GLC_Material*>::const_iterator iMaterial= m_MaterialCache.m_Materials.constBegin();
+    while (iMaterial != m_MaterialCache.m_Materials.constEnd())
+    {
+        if (iMaterial.value()->releaseUsage(m_MaterialCache.m_UsageId)) delete iMaterial.value();
+        ++iMaterial;
+    }
+}
+
+GLC_GlcwToWorld::GLC_GlcwToWorld()
+    : QObject()
+    , m_Input()
+    , m_Sections()
+    , m_References()
+{
+
+}
+
+GLC_GlcwToWorld::~GLC_GlcwToWorld()
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_GlcwToWorld::isGlcwRepresentation(const QString& fileName)
+{
+    bool subject= glc::isArchiveString(fileName);
+    subject= subject && (QFileInfo(glc::archiveFileName(fileName)).suffix().toLower() == GLC_WorldToGlcw::suffix());
+
+    return subject;
+}
+
+int GLC_GlcwToWorld::occurrenceCount() const
+{
+    return static_cast<int>(recordCount(GLC_WorldToGlcw::OccurrenceSection));
+}
+
+int GLC_GlcwToWorld::referenceCount() const
+{
+    return static_cast<int>(recordCount(GLC_WorldToGlcw::ReferenceSection));
+}
+
+int GLC_GlcwToWorld::representationCount() const
+{
+    return static_cast<int>(recordCount(GLC_WorldToGlcw::RepresentationSection));
+}
+
+GLC_BoundingBox GLC_GlcwToWorld::referenceBoundingBox(int index) const
+{
+    GLC_BoundingBox subject;
+    const char* pRecord= record(GLC_WorldToGlcw::ReferenceSection, index);
+    if (nullptr != pRecord)
+    {
+        subject= readBoundingBox(pRecord + 16);
+    }
+
+    return subject;
+}
+
+GLC_BoundingBox GLC_GlcwToWorld::representationBoundingBox(int index) const
+{
+    GLC_BoundingBox subject;
+    const char* pRecord= record(GLC_WorldToGlcw::RepresentationSection, index);
+    if (nullptr != pRecord)
+    {
+        subject= readBoundingBox(pRecord + 32);
+    }
+
+    return subject;
+}
+
+GLC_StructReference* GLC_GlcwToWorld::structReference(int index) const
+{
+    return m_References.value(index, nullptr);
+}
+
+QStringList GLC_GlcwToWorld::listOfAttachedFileName() const
+{
+    QStringList subject;
+    const int count= static_cast<int>(recordCount(GLC_WorldToGlcw::TextureSection));
+    for (int i= 0; i < count; ++i)
+    {
+        const QString fileName(string(readValue<quint32>(record(GLC_WorldToGlcw::TextureSection, i))));
+        if (!glc::isArchiveString(fileName)) subject.append(fileName);
+    }
+
+    return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+GLC_World* GLC_GlcwToWorld::createWorldFromGlcw(QFile& file, bool structureOnly)
+{
+    const GLC_InputData input(GLC_InputData::fromDevice(&file));
+    if (input.isNull())
+    {
+        QString message(QString("GLC_GlcwToWorld::createWorldFromGlcw Enable to open the file ") + file.fileName());
+        GLC_FileFormatException fileFormatException(message, file.fileName(), GLC_FileFormatException::FileNotFound);
+        throw(fileFormatException);
+    }
+
+    return createWorldFromGlcw(input, structureOnly);
+}
+
+GLC_World* GLC_GlcwToWorld::createWorldFromGlcw(const GLC_InputData& input, bool structureOnly)
+{
+    open(input);
+    checkStructureTables();
+    m_References.clear();
+
+    // Representations can be loaded later only from a file
+    const GLC_InputData::Origin origin= m_Input.origin();
+    const bool isFile= ((origin == GLC_InputData::MappedFile) || (origin == GLC_InputData::FileContent)) && !m_Input.fileName().isEmpty();
+    const bool loadRepresentations= !structureOnly || !isFile;
+
+    // References, representations shared by references are shared
+    MaterialCache materialCache;
+    QHash<int, GLC_3DRep> representations;
+    const int referenceCount= this->referenceCount();
+    m_References.resize(referenceCount);
+    for (int i= 0; i < referenceCount; ++i)
+    {
+        const char* pRecord= record(GLC_WorldToGlcw::ReferenceSection, i);
+        GLC_StructReference* pReference= new GLC_StructReference(string(readValue<quint32>(pRecord)));
+        const qint32 representationIndex= readValue<qint32>(pRecord + 4);
+        if (representationIndex >= 0)
+        {
+            if (!representations.contains(representationIndex))
+            {
+                if (loadRepresentations)
+                {
+                    representations.insert(representationIndex, representation(representationIndex, &materialCache));
+                }
+                else
+                {
+                    GLC_3DRep rep;
+                    rep.setName(string(readValue<quint32>(record(GLC_WorldToGlcw::RepresentationSection, representationIndex))));
+                    rep.setFileName(glc::builtArchiveString(m_Input.fileName(), QString::number(representationIndex)));
+                    representations.insert(representationIndex, rep);
+                }
+            }
+            pReference->setRepresentation(representations.value(representationIndex));
+        }
+        const GLC_Attributes referenceAttributes(attributes(pRecord + 8));
+        if (!referenceAttributes.isEmpty()) pReference->setAttributes(referenceAttributes);
+        m_References[i]= pReference;
+    }
+    if (loadRepresentations) emit currentQuantum(50);
+
+    // Instances
+    const int instanceCount= static_cast<int>(recordCount(GLC_WorldToGlcw::InstanceSection));
+    QVector<GLC_StructInstance*> instances(instanceCount);
+    for (int i= 0; i < instanceCount; ++i)
+    {
+        const char* pRecord= record(GLC_WorldToGlcw::InstanceSection, i);
+        GLC_StructInstance* pInstance= new GLC_StructInstance(m_References.at(readValue<quint32>(pRecord + 4)));
+        pInstance->setName(string(readValue<quint32>(pRecord)));
+        const GLC_Attributes instanceAttributes(attributes(pRecord + 8));
+        if (!instanceAttributes.isEmpty()) pInstance->setAttributes(instanceAttributes);
+        double matrix[16];
+        for (int j= 0; j < 16; ++j)
+        {
+            matrix[j]= readValue<double>(pRecord + 16 + (j * 8));
+        }
+        pInstance->setMatrix(GLC_Matrix4x4(matrix));
+        instances[i]= pInstance;
+    }
+
+    GLC_World* pWorld= createOccurrences(instances);
+
+    // The representations are loaded on demand from the same opened file
+    if (!loadRepresentations) keepOpenedFile();
+
+    // Remove the unused instances and references
+    for (int i= 0; i < instanceCount; ++i)
+    {
+        if (!instances.at(i)->hasStructOccurrence()) delete instances.at(i);
+    }
+    for (int i= 0; i < referenceCount; ++i)
+    {
+        if (!m_References.at(i)->hasStructInstance())
+        {
+            delete m_References.at(i);
+            m_References[i]= nullptr;
+        }
+    }
+
+    emit currentQuantum(100);
+
+    return pWorld;
+}
+
+GLC_3DRep GLC_GlcwToWorld::create3DRepFromGlcwRep(const QString& fileName)
+{
+    GLC_3DRep subject;
+    if (isGlcwRepresentation(fileName))
+    {
+        const QString glcwFileName(glc::archiveFileName(fileName));
+        bool indexOk= false;
+        const int index= glc::archiveEntryFileName(fileName).toInt(&indexOk);
+        try
+        {
+            // The file is opened once, the representation is read in place
+            const QSharedPointer<OpenedFile> pFile(openedFile(glcwFileName));
+            if (indexOk) subject= representation(index, &pFile->m_MaterialCache);
+        }
+        catch (GLC_FileFormatException& e)
+        {
+            QStringList stringList("GLC_GlcwToWorld::create3DRepFromGlcwRep");
+            stringList.append(e.what());
+            GLC_ErrorLog::addError(stringList);
+        }
+        if (subject.isEmpty())
+        {
+            QStringList stringList("GLC_GlcwToWorld::create3DRepFromGlcwRep");
+            stringList.append("Representation not loaded : " + fileName);
+            GLC_ErrorLog::addError(stringList);
+        }
+    }
+
+    return subject;
+}
+
+GLC_3DRep GLC_GlcwToWorld::representation(int index)
+{
+    MaterialCache materialCache;
+    return representation(index, &materialCache);
+}
+
+void GLC_GlcwToWorld::releaseOpenedFiles()
+{
+    QList<QSharedPointer<OpenedFile> > openedFiles;
+    {
+        QMutexLocker locker(&m_OpenedFilesMutex);
+        openedFiles.swap(m_OpenedFiles);
+    }
+    // The files are released without lock
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_GlcwToWorld::open(const GLC_InputData& input)
+{
+    m_Input= input;
+    m_Sections.clear();
+    if (m_Input.isNull())
+    {
+        QString message(QString("GLC_GlcwToWorld::open Enable to open the file ") + m_Input.fileName());
+        GLC_FileFormatException fileFormatException(message, m_Input.fileName(), GLC_FileFormatException::FileNotFound);
+        throw(fileFormatException);
+    }
+
+    const QByteArray data(m_Input.byteArray());
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    QUuid magic;
+    quint32 version;
+    quint32 sectionCount;
+    stream >> magic >> version >> sectionCount;
+
+    bool headerOk= (magic == GLC_WorldToGlcw::magic()) && (version <= GLC_WorldToGlcw::version());
+    headerOk= headerOk && (stream.status() == QDataStream::Ok);
+    headerOk= headerOk && (sectionCount <= 1024) && (GLC_WorldToGlcw::headerSize(static_cast<int>(sectionCount)) <= m_Input.size());
+    if (!headerOk) throwWrongFormat("GLC_GlcwToWorld::open Wrong file header ");
+
+    m_Sections.resize(GLC_WorldToGlcw::GeometrySection + 1);
+    for (quint32 i= 0; i < sectionCount; ++i)
+    {
+        quint32 type;
+        quint32 recordSize;
+        quint64 recordCount;
+        qint64 offset;
+        qint64 size;
+        stream >> type >> recordSize >> recordCount >> offset >> size;
+
+        bool sectionOk= (offset >= 0) && (size >= 0) && (offset <= m_Input.size()) && (size <= (m_Input.size() - offset));
+        sectionOk= sectionOk && ((recordSize == 0) || (recordCount <= (static_cast<quint64>(size) / recordSize)));
+        if (!sectionOk) throwWrongFormat("GLC_GlcwToWorld::open Wrong section ");
+
+        // Unknown sections are ignored
+        if ((type > 0) && (type < static_cast<quint32>(m_Sections.size())))
+        {
+            Section& section= m_Sections[type];
+            section.m_pData= m_Input.constData() + offset;
+            section.m_RecordSize= recordSize;
+            section.m_RecordCount= recordCount;
+        }
+    }
+    if (stream.status() != QDataStream::Ok) throwWrongFormat("GLC_GlcwToWorld::open Wrong section directory ");
+
+    // All known sections are needed, their records can be larger than the known ones
+    for (int type= GLC_WorldToGlcw::StringOffsetSection; type < GLC_WorldToGlcw::GeometrySection; ++type)
+    {
+        const Section& section= m_Sections.at(type);
+        if ((nullptr == section.m_pData) || (section.m_RecordSize < knownRecordSize(type)))
+        {
+            throwWrongFormat("GLC_GlcwToWorld::open Missing section ");
+        }
+    }
+    if (recordCount(GLC_WorldToGlcw::StringOffsetSection) == 0) throwWrongFormat("GLC_GlcwToWorld::open Wrong string table ");
+}
+
+void GLC_GlcwToWorld::checkStructureTables() const
+{
+    const quint64 referenceCount= recordCount(GLC_WorldToGlcw::ReferenceSection);
+    const quint64 instanceCount= recordCount(GLC_WorldToGlcw::InstanceSection);
+    const quint64 occurrenceCount= recordCount(GLC_WorldToGlcw::OccurrenceSection);
+    const qint64 representationCount= static_cast<qint64>(recordCount(GLC_WorldToGlcw::RepresentationSection));
+
+    bool tablesOk= (occurrenceCount > 0) && (occurrenceCount < static_cast<quint64>(INT_MAX));
+    tablesOk= tablesOk && (instanceCount < static_cast<quint64>(INT_MAX)) && (referenceCount < static_cast<quint64>(INT_MAX));
+    for (quint64 i= 0; tablesOk && (i < referenceCount); ++i)
+    {
+        const qint32 representation= readValue<qint32>(record(GLC_WorldToGlcw::ReferenceSection, i) + 4);
+        tablesOk= (representation < representationCount);
+    }
+    for (quint64 i= 0; tablesOk && (i < instanceCount); ++i)
+    {
+        tablesOk= (readValue<quint32>(record(GLC_WorldToGlcw::InstanceSection, i) + 4) < referenceCount);
+    }
+    for (quint64 i= 0; tablesOk && (i < occurrenceCount); ++i)
+    {
+        const char* pRecord= record(GLC_WorldToGlcw::OccurrenceSection, i);
+        const qint64 parent= readValue<qint32>(pRecord);
+        const quint64 end= readValue<quint32>(pRecord + 8);
+        tablesOk= (readValue<quint32>(pRecord + 4) < instanceCount) && (end > i) && (end <= occurrenceCount);
+        // The root is the first occurrence and its subtree contains all occurrences, parents are before their children
+        tablesOk= tablesOk && ((i == 0) ? ((parent == -1) && (end == occurrenceCount)) : ((parent >= 0) && (static_cast<quint64>(parent) < i)));
+        if (tablesOk && (i > 0))
+        {
+            // The subtree of an occurrence is in the subtree of its parent
+            const quint64 parentEnd= readValue<quint32>(record(GLC_WorldToGlcw::OccurrenceSection, static_cast<quint64>(parent)) + 8);
+            tablesOk= (i < parentEnd) && (end <= parentEnd);
+        }
+    }
+
+    if (!tablesOk) throwWrongFormat("GLC_GlcwToWorld::checkStructureTables Wrong structure table ");
+}
+
+const char* GLC_GlcwToWorld::record(int type, quint64 index) const
+{
+    const char* pSubject= nullptr;
+    if (type < m_Sections.size())
+    {
+        const Section& section= m_Sections.at(type);
+        if (index < section.m_RecordCount)
+        {
+            pSubject= section.m_pData + (index * section.m_RecordSize);
+        }
+    }
+
+    return pSubject;
+}
+
+quint64 GLC_GlcwToWorld::recordCount(int type) const
+{
+    quint64 subject= 0;
+    if (type < m_Sections.size())
+    {
+        subject= m_Sections.at(type).m_RecordCount;
+    }
+
+    return subject;
+}
+
+QString GLC_GlcwToWorld::string(quint32 index) const
+{
+    QString subject;
+    const char* pOffset= record(GLC_WorldToGlcw::StringOffsetSection, static_cast<quint64>(index) + 1);
+    if (nullptr != pOffset)
+    {
+        const Section& offsets= m_Sections.at(GLC_WorldToGlcw::StringOffsetSection);
+        const quint64 begin= readValue<quint32>(pOffset - offsets.m_RecordSize);
+        const quint64 end= readValue<quint32>(pOffset);
+        const quint64 size= recordCount(GLC_WorldToGlcw::StringDataSection);
+        if ((begin <= end) && (end <= size))
+        {
+            const char* pData= m_Sections.at(GLC_WorldToGlcw::StringDataSection).m_pData;
+            subject= QString::fromUtf8(pData + begin, static_cast<int>(end - begin));
+        }
+    }
+
+    return subject;
+}
+
+GLC_BoundingBox GLC_GlcwToWorld::readBoundingBox(const char* pData)
+{
+    GLC_BoundingBox subject;
+    const GLC_Point3d lower(readValue<double>(pData), readValue<double>(pData + 8), readValue<double>(pData + 16));
+    const GLC_Point3d upper(readValue<double>(pData + 24), readValue<double>(pData + 32), readValue<double>(pData + 40));
+    if (lower.x() <= upper.x())
+    {
+        subject= GLC_BoundingBox(lower, upper);
+    }
+
+    return subject;
+}
+
+GLC_Attributes GLC_GlcwToWorld::attributes(const char* pRange) const
+{
+    GLC_Attributes subject;
+    const quint32 first= readValue<quint32>(pRange);
+    const quint32 count= readValue<quint32>(pRange + 4);
+    for (quint32 i= 0; i < count; ++i)
+    {
+        const char* pRecord= record(GLC_WorldToGlcw::AttributeSection, static_cast<quint64>(first) + i);
+        if (nullptr == pRecord) break;
+        subject.insert(string(readValue<quint32>(pRecord)), string(readValue<quint32>(pRecord + 4)));
+    }
+
+    return subject;
+}
+
+GLC_Material* GLC_GlcwToWorld::material(int index, MaterialCache* pCache) const
+{
+    QMutexLocker locker(&pCache->m_Mutex);
+    GLC_Material* pSubject= pCache->m_Materials.value(index, nullptr);
+    if (nullptr == pSubject)
+    {
+        const char* pRecord= record(GLC_WorldToGlcw::MaterialSection, index);
+        if (nullptr != pRecord)
+        {
+            pSubject= new GLC_Material();
+            pSubject->setName(string(readValue<quint32>(pRecord)));
+            pSubject->setAmbientColor(readColor(pRecord + 8));
+            pSubject->setDiffuseColor(readColor(pRecord + 24));
+            pSubject->setSpecularColor(readColor(pRecord + 40));
+            pSubject->setEmissiveColor(readColor(pRecord + 56));
+            pSubject->setShininess(readValue<float>(pRecord + 72));
+            pSubject->setOpacity(readValue<float>(pRecord + 76));
+
+            const qint32 texture= readValue<qint32>(pRecord + 4);
+            const char* pTextureRecord= (texture >= 0) ? record(GLC_WorldToGlcw::TextureSection, texture) : nullptr;
+            if (nullptr != pTextureRecord)
+            {
+                pSubject->setTexture(new GLC_Texture(string(readValue<quint32>(pTextureRecord))));
+            }
+            if (0 != pCache->m_UsageId) pSubject->addUsage(pCache->m_UsageId);
+            pCache->m_Materials.insert(index, pSubject);
+        }
+    }
+
+    return pSubject;
+}
+
+GLC_3DRep GLC_GlcwToWorld::representation(int index, MaterialCache* pCache)
+{
+    GLC_3DRep subject;
+    const char* pRecord= record(GLC_WorldToGlcw::RepresentationSection, index);
+    if (nullptr == pRecord) return subject;
+
+    subject.setName(string(readValue<quint32>(pRecord)));
+    const quint32 firstMaterial= readValue<quint32>(pRecord + 4);
+    const quint32 materialCount= readValue<quint32>(pRecord + 8);
+    const qint64 offset= readValue<qint64>(pRecord + 16);
+    const qint64 size= readValue<qint64>(pRecord + 24);
+    if ((offset < 0) || (size < 0) || (offset > m_Input.size()) || (size > (m_Input.size() - offset)))
+    {
+        throwWrongFormat("GLC_GlcwToWorld::representation Wrong representation offset ");
+    }
+
+    // Materials of the meshes from their id in the file
+    MaterialHash materialHash;
+    QHash<GLC_uint, GLC_uint> materialIdMap;
+    for (quint32 i= 0; i < materialCount; ++i)
+    {
+        const char* pMaterialRecord= record(GLC_WorldToGlcw::RepresentationMaterialSection, static_cast<quint64>(firstMaterial) + i);
+        if (nullptr == pMaterialRecord) break;
+        GLC_Material* pMaterial= material(static_cast<int>(readValue<quint32>(pMaterialRecord + 4)), pCache);
+        if (nullptr != pMaterial)
+        {
+            materialIdMap.insert(readValue<quint32>(pMaterialRecord), pMaterial->id());
+            materialHash.insert(pMaterial->id(), pMaterial);
+        }
+    }
+
+    // The meshes are read in place
+    const QByteArray data(m_Input.mid(offset, size).byteArray());
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    qint32 meshCount= 0;
+    stream >> meshCount;
+    for (qint32 i= 0; (i < meshCount) && (stream.status() == QDataStream::Ok); ++i)
+    {
+        GLC_Mesh* pMesh= new GLC_Mesh();
+        pMesh->loadFromDataStream(stream, materialHash, materialIdMap);
+        subject.addGeom(pMesh);
+    }
+    if (stream.status() != QDataStream::Ok)
+    {
+        throwWrongFormat("GLC_GlcwToWorld::representation Wrong representation data ");
+    }
+
+    if (!m_Input.fileName().isEmpty())
+    {
+        subject.setFileName(glc::builtArchiveString(m_Input.fileName(), QString::number(index)));
+    }
+
+    return subject;
+}
+
+GLC_World* GLC_GlcwToWorld::createOccurrences(const QVector<GLC_StructInstance*>& instances)
+{
+    const int count= occurrenceCount();
+    QVector<GLC_StructOccurrence*> occurrences(count, nullptr);
+
+    // The tree is built without world, the world handle is set once at the end
+    occurrences[0]= new GLC_StructOccurrence(instances.at(readValue<quint32>(record(GLC_WorldToGlcw::OccurrenceSection, 0) + 4)));
+    int previousQuantum= 0;
+    int index= 1;
+    while (index < count)
+    {
+        const char* pRecord= record(GLC_WorldToGlcw::OccurrenceSection, index);
+        GLC_StructOccurrence* pParent= occurrences.at(readValue<qint32>(pRecord));
+        if (nullptr == pParent)
+        {
+            // Not filled parent slot of inconsistent tables
+            deleteStructure(occurrences.at(0), instances);
+            throwWrongFormat("GLC_GlcwToWorld::createOccurrences Wrong occurrence parent ");
+        }
+        GLC_StructInstance* pInstance= instances.at(readValue<quint32>(pRecord + 4));
+
+        // The subtree of an instance with occurrences is cloned from its first occurrence,
+        // which is complete because it is before in depth first order
+        const bool isCloned= pInstance->hasStructOccurrence();
+        GLC_StructOccurrence* pOccurrence= new GLC_StructOccurrence(pInstance);
+        pParent->addChild(pOccurrence);
+        if (isCloned)
+        {
+            index= attachClonedSubtree(pOccurrence, index, &occurrences);
+        }
+        else
+        {
+            occurrences[index]= pOccurrence;
+            ++index;
+        }
+
+        const int quantum= 50 + ((index * 50) / count);
+        if (quantum > previousQuantum)
+        {
+            previousQuantum= quantum;
+            emit currentQuantum(quantum);
+        }
+    }
+
+    // Hidden occurrences
+    for (int i= 0; i < count; ++i)
+    {
+        GLC_StructOccurrence* pOccurrence= occurrences.at(i);
+        const quint32 flags= readValue<quint32>(record(GLC_WorldToGlcw::OccurrenceSection, i) + 12);
+        if ((nullptr != pOccurrence) && !(flags & GLC_WorldToGlcw::Visible) && pOccurrence->isVisible())
+        {
+            pOccurrence->setVisibility(false);
+        }
+    }
+
+    GLC_StructOccurrence* pRoot= occurrences.at(0);
+    GLC_World* pSubject= new GLC_World(pRoot);
+    pRoot->updateOccurrenceNumber(1);
+
+    return pSubject;
+}
+
+QSharedPointer<GLC_GlcwToWorld::OpenedFile> GLC_GlcwToWorld::openedFile(const QString& fileName)
+{
+    const QFileInfo fileInfo(fileName);
+    const QString filePath(fileInfo.absoluteFilePath());
+    const qint64 lastModified= fileInfo.lastModified().toMSecsSinceEpoch();
+
+    QSharedPointer<OpenedFile> pSubject;
+    {
+        QMutexLocker locker(&m_OpenedFilesMutex);
+        const int count= m_OpenedFiles.size();
+        for (int i= 0; (i < count) && pSubject.isNull(); ++i)
+        {
+            // A modified file is opened again
+            if ((m_OpenedFiles.at(i)->m_FilePath == filePath) && (m_OpenedFiles.at(i)->m_LastModified == lastModified))
+            {
+                pSubject= m_OpenedFiles.takeAt(i);
+                m_OpenedFiles.prepend(pSubject);
+            }
+        }
+    }
+
+    if (pSubject.isNull())
+    {
+        open(GLC_InputData::fromFile(fileName));
+        pSubject= keepOpenedFile();
+    }
+    else
+    {
+        m_Input= pSubject->m_Input;
+        m_Sections= pSubject->m_Sections;
+    }
+
+    return pSubject;
+}
+
+QSharedPointer<GLC_GlcwToWorld::OpenedFile> GLC_GlcwToWorld::keepOpenedFile()
+{
+    const QFileInfo fileInfo(m_Input.fileName());
+    QSharedPointer<OpenedFile> pSubject(new OpenedFile);
+    pSubject->m_FilePath= fileInfo.absoluteFilePath();
+    pSubject->m_LastModified= fileInfo.lastModified().toMSecsSinceEpoch();
+    pSubject->m_Input= m_Input;
+    pSubject->m_Sections= m_Sections;
+
+    // Files are released without lock
+    QList<QSharedPointer<OpenedFile> > releasedFiles;
+    {
+        QMutexLocker locker(&m_OpenedFilesMutex);
+        int i= 0;
+        while (i < m_OpenedFiles.size())
+        {
+            const QSharedPointer<OpenedFile> pFile(m_OpenedFiles.at(i));
+            if (pFile->m_FilePath != pSubject->m_FilePath)
+            {
+                ++i;
+            }
+            else if (pFile->m_LastModified == pSubject->m_LastModified)
+            {
+                // The file has been opened by another loader
+                pSubject= pFile;
+                m_OpenedFiles.removeAt(i);
+            }
+            else
+            {
+                // Previous version of the file
+                releasedFiles.append(m_OpenedFiles.takeAt(i));
+            }
+        }
+        m_OpenedFiles.prepend(pSubject);
+        while (m_OpenedFiles.size() > MaxOpenedFileCount)
+        {
+            releasedFiles.append(m_OpenedFiles.takeLast());
+        }
+    }
+
+    return pSubject;
+}
+
+void GLC_GlcwToWorld::deleteStructure(GLC_StructOccurrence* pRoot, const QVector<GLC_StructInstance*>& instances)
+{
+    // The instances and references which are not deleted with the occurrences
+    QList<GLC_StructInstance*> unusedInstances;
+    for (GLC_StructInstance* pInstance : instances)
+    {
+        if (!pInstance->hasStructOccurrence()) unusedInstances.append(pInstance);
+    }
+    QList<GLC_StructReference*> unusedReferences;
+    for (GLC_StructReference* pReference : std::as_const(m_References))
+    {
+        if ((nullptr != pReference) && !pReference->hasStructInstance()) unusedReferences.append(pReference);
+    }
+
+    delete pRoot;
+    qDeleteAll(unusedInstances);
+    qDeleteAll(unusedReferences);
+    m_References.clear();
+}
+
+int GLC_GlcwToWorld::attachClonedSubtree(GLC_StructOccurrence* pOccurrence, int index, QVector<GLC_StructOccurrence*>* pOccurrences)
+{
+    (*pOccurrences)[index]= pOccurrence;
+    const int end= static_cast<int>(readValue<quint32>(record(GLC_WorldToGlcw::OccurrenceSection, index) + 8));
+
+    // The children of the clone are in the order of the children of the file
+    int child= index + 1;
+    int childIndex= 0;
+    while ((child < end) && (childIndex < pOccurrence->childCount()))
+    {
+        child= attachClonedSubtree(pOccurrence->child(childIndex), child, pOccurrences);
+        ++childIndex;
+    }
+
+    return end;
+}
+
+void GLC_GlcwToWorld::throwWrongFormat(const QString& message) const
+{
+    const QString fileName(m_Input.fileName());
+    GLC_FileFormatException fileFormatException(message + fileName, fileName, GLC_FileFormatException::WrongFileFormat);
+    throw(fileFormatException);
+}
@@ -0,0 +1,269 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_glcwtoworld.h interface for the GLC_GlcwToWorld class.
+
+#ifndef GLC_GLCWTOWORLD_H_
+#define GLC_GLCWTOWORLD_H_
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "glc_inputdata.h"
+#include "../geometry/glc_3drep.h"
+#include "../glc_boundingbox.h"
+
+#include "../glc_config.h"
+
+QT_BEGIN_NAMESPACE
+class QFile;
+QT_END_NAMESPACE
+class GLC_World;
+class GLC_Attributes;
+class GLC_Material;
+class GLC_StructInstance;
+class GLC_StructReference;
+class GLC_StructOccurrence;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_GlcwToWorld
+/*! \brief GLC_GlcwToWorld : Create a GLC_World from a glcw binary world file*/
+
+/*! The file format is described in GLC_WorldToGlcw.
+ *
+ *  The tables are read in place from the input data, files are mapped so opening
+ *  the structure doesn't read the geometry. If the structure only is loaded,
+ *  representations are not loaded and their file name is an archive string
+ *  (see glc::builtArchiveString()) of the glcw file and the representation index :
+ *  GLC_3DRep::load() loads them one by one with create3DRepFromGlcwRep().
+ *  The glcw files opened for these loads are kept with their parsed header and the materials
+ *  already created, so representations of the same file share their materials and the file
+ *  is mapped once. The last opened files are kept until releaseOpenedFiles() is called.
+ *
+ *  The bounding boxes of references are available before their representation is loaded.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_GlcwToWorld : public QObject
+{
+    Q_OBJECT
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    GLC_GlcwToWorld();
+    virtual ~GLC_GlcwToWorld();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return true if the given representation file name is a representation of a glcw file
+    static bool isGlcwRepresentation(const QString& fileName);
+
+    //! Return the number of occurrences of the opened file
+    int occurrenceCount() const;
+
+    //! Return the number of references of the opened file
+    int referenceCount() const;
+
+    //! Return the number of representations of the opened file
+    int representationCount() const;
+
+    //! Return the bounding box of the given reference and its children in reference coordinates
+    GLC_BoundingBox referenceBoundingBox(int index) const;
+
+    //! Return the bounding box of the given representation
+    GLC_BoundingBox representationBoundingBox(int index) const;
+
+    //! Return the reference of the given index of the last created world
+    /*! Return nullptr if the index is not valid, the reference is owned by the world*/
+    GLC_StructReference* structReference(int index) const;
+
+    //! Return the list of texture files used by the opened file
+    QStringList listOfAttachedFileName() const;
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Create and return a world from the given glcw file
+    /*! Throw a GLC_FileFormatException if the file can't be loaded*/
+    GLC_World* createWorldFromGlcw(QFile& file, bool structureOnly= true);
+
+    //! Create and return a world from the given glcw input data
+    /*! If the input data has no file name, the representations are loaded.
+     *  Throw a GLC_FileFormatException if the data can't be loaded*/
+    GLC_World* createWorldFromGlcw(const GLC_InputData& input, bool structureOnly= true);
+
+    //! Return the representation of the given glcw representation file name
+    /*! Return an empty representation if the representation can't be loaded.
+     *  This method is thread safe, different loaders can load representations concurrently*/
+    GLC_3DRep create3DRepFromGlcwRep(const QString& fileName);
+
+    //! Return the representation of the given index of the opened file
+    GLC_3DRep representation(int index);
+
+    //! Release the glcw files kept opened for the load of representations
+    /*! Materials kept by the files are deleted if they are not used anymore*/
+    static void releaseOpenedFiles();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! A section of the opened file
+    struct Section
+    {
+        Section();
+
+        const char* m_pData;
+        quint32 m_RecordSize;
+        quint64 m_RecordCount;
+    };
+
+    //! Materials created by a loading from their index
+    struct MaterialCache
+    {
+        MaterialCache();
+
+        QHash<int, GLC_Material*> m_Materials;
+
+        //! If not 0, the usage added to the cached materials to keep them while the cache exists
+        GLC_uint m_UsageId;
+
+        //! Lock of the cache, shared caches are used by concurrent loadings
+        QMutex m_Mutex;
+    };
+
+    //! A glcw file kept opened for the load of its representations
+    struct OpenedFile
+    {
+        OpenedFile();
+        ~OpenedFile();
+
+        //! The absolute file name and the last modification time of the file
+        QString m_FilePath;
+        qint64 m_LastModified;
+
+        //! The opened input data and its sections
+        GLC_InputData m_Input;
+        QVector<Section> m_Sections;
+
+        //! The materials created by the loaded representations
+        MaterialCache m_MaterialCache;
+
+        Q_DISABLE_COPY(OpenedFile)
+    };
+
+    //! Maximum number of files kept opened
+    enum {MaxOpenedFileCount= 8};
+
+    //! Open the given input data
+    /*! Throw a GLC_FileFormatException if the data isn't a valid glcw file*/
+    void open(const GLC_InputData& input);
+
+    //! Check the indexes of the structure tables of the opened data
+    /*! The parent of an occurrence must be before it and the subtree ranges must nest.
+     *  Throw a GLC_FileFormatException if an index is out of range*/
+    void checkStructureTables() const;
+
+    //! Return the opened file of the given glcw file name, the file is opened only if it isn't kept
+    /*! The opened data of this loader are the data of the returned file.
+     *  Throw a GLC_FileFormatException if the file can't be opened*/
+    QSharedPointer<OpenedFile> openedFile(const QString& fileName);
+
+    //! Keep the opened data of this loader for the load of its representations and return the kept file
+    QSharedPointer<OpenedFile> keepOpenedFile();
+
+    //! Return the record of the given index of the given section
+    const char* record(int type, quint64 index) const;
+
+    //! Return the number of records of the given section
+    quint64 recordCount(int type) const;
+
+    //! Return the string of the given index
+    QString string(quint32 index) const;
+
+    //! Return the bounding box at the given position
+    static GLC_BoundingBox readBoundingBox(const char* pData);
+
+    //! Return the attributes of the given range of the attribute table
+    GLC_Attributes attributes(const char* pRange) const;
+
+    //! Return the material of the given index, created once by loading
+    GLC_Material* material(int index, MaterialCache* pCache) const;
+
+    //! Return the representation of the given index using the given material cache
+    GLC_3DRep representation(int index, MaterialCache* pCache);
+
+    //! Create the occurrences of the opened file from the given instances and return the world
+    GLC_World* createOccurrences(const QVector<GLC_StructInstance*>& instances);
+
+    //! Delete the given partially created occurrence tree with the instances and the references of the opened file
+    void deleteStructure(GLC_StructOccurrence* pRoot, const QVector<GLC_StructInstance*>& instances);
+
+    //! Attach the cloned occurrence at the given index and its subtree, return the index after the subtree
+    int attachClonedSubtree(GLC_StructOccurrence* pOccurrence, int index, QVector<GLC_StructOccurrence*>* pOccurrences);
+
+    //! Throw a wrong file format exception with the given message
+    void throwWrongFormat(const QString& message) const;
+
+//////////////////////////////////////////////////////////////////////
+// Qt Signals
+//////////////////////////////////////////////////////////////////////
+    signals:
+    void currentQuantum(int);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The opened input data
+    GLC_InputData m_Input;
+
+    //! The known sections of the opened data indexed by type
+    QVector<Section> m_Sections;
+
+    //! The references of the last created world
+    QVector<GLC_StructReference*> m_References;
+
+    //! The files kept opened, the most recently used first
+    static QList<QSharedPointer<OpenedFile> > m_OpenedFiles;
+
+    //! Lock of the kept opened files
+    static QMutex m_OpenedFilesMutex;
+};
+
+#endif /* GLC_GLCWTOWORLD_H_ */
@@ -0,0 +1,261 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_inputdata.cpp implementation of the GLC_InputData class.
+
+#include <QBuffer>
+#include <QFile>
+
+#include <cstring>
+
+#include "glc_inputdata.h"
+
+class GLC_InputData::Holder
+{
+public:
+    Holder()
+        : m_Origin(GLC_InputData::NullData)
+        , m_pFile(nullptr)
+        , m_Data()
+    {}
+
+    ~Holder()
+    {
+        // Unmap the file
+        delete m_pFile;
+    }
+
+    //! The origin of the bytes
+    GLC_InputData::Origin m_Origin;
+
+    //! The mapped file
+    QFile* m_pFile;
+
+    //! The bytes if they are not mapped or owned by the caller
+    QByteArray m_Data;
+
+private:
+    Q_DISABLE_COPY(Holder)
+};
+
+GLC_InputData::GLC_InputData()
+    : m_pHolder()
+    , m_pData(nullptr)
+    , m_Size(0)
+    , m_FileName()
+{
+
+}
+
+GLC_InputData::GLC_InputData(const QSharedPointer<Holder>& pHolder, const QString& fileName)
+    : m_pHolder(pHolder)
+    , m_pData(pHolder->m_Data.constData())
+    , m_Size(pHolder->m_Data.size())
+    , m_FileName(fileName)
+{
+
+}
+
+GLC_InputData GLC_InputData::fromFile(const QString& fileName)
+{
+    QFile* pFile= new QFile(fileName);
+    if (!pFile->open(QIODevice::ReadOnly))
+    {
+        delete pFile;
+        return GLC_InputData();
+    }
+
+    QSharedPointer<Holder> pHolder(new Holder);
+    const qint64 size= pFile->size();
+    uchar* pMappedData= (size > 0) ? pFile->map(0, size) : nullptr;
+    if (nullptr != pMappedData)
+    {
+        pHolder->m_Origin= MappedFile;
+        pHolder->m_pFile= pFile;
+        GLC_InputData subject(pHolder, fileName);
+        subject.m_pData= reinterpret_cast<const char*>(pMappedData);
+        subject.m_Size= size;
+        return subject;
+    }
+    else
+    {
+        // The file can't be mapped, it is read in memory
+        pHolder->m_Origin= FileContent;
+        pHolder->m_Data= pFile->readAll();
+        delete pFile;
+        return GLC_InputData(pHolder, fileName);
+    }
+}
+
+GLC_InputData GLC_InputData::fromByteArray(const QByteArray& data, const QString& fileName)
+{
+    QSharedPointer<Holder> pHolder(new Holder);
+    pHolder->m_Origin= ByteArray;
+    pHolder->m_Data= data;
+
+    return GLC_InputData(pHolder, fileName);
+}
+
+GLC_InputData GLC_InputData::fromRawData(const char* pData, qint64 size, const QString& fileName)
+{
+    QSharedPointer<Holder> pHolder(new Holder);
+    pHolder->m_Origin= RawData;
+
+    GLC_InputData subject(pHolder, fileName);
+    subject.m_pData= pData;
+    subject.m_Size= qMax(Q_INT64_C(0), size);
+
+    return subject;
+}
+
+GLC_InputData GLC_InputData::fromDevice(QIODevice* pDevice)
+{
+    GLC_InputData subject;
+    if (nullptr == pDevice) return subject;
+
+    // A named file is mapped by the input data
+    QFile* pFile= qobject_cast<QFile*>(pDevice);
+    if ((nullptr != pFile) && !pFile->fileName().isEmpty() && !pFile->isSequential())
+    {
+        const qint64 pos= pFile->isOpen() ? pFile->pos() : 0;
+        subject= fromFile(pFile->fileName());
+        if (!subject.isNull())
+        {
+            return subject.mid(pos);
+        }
+    }
+
+    // A buffer is shared
+    QBuffer* pBuffer= qobject_cast<QBuffer*>(pDevice);
+    if (nullptr != pBuffer)
+    {
+        const qint64 pos= pBuffer->isOpen() ? pBuffer->pos() : 0;
+        return fromByteArray(pBuffer->data()).mid(pos);
+    }
+
+    // Other devices are read once
+    const bool wasOpen= pDevice->isOpen();
+    if (!wasOpen && !pDevice->open(QIODevice::ReadOnly)) return subject;
+    if (pDevice->isReadable())
+    {
+        QSharedPointer<Holder> pHolder(new Holder);
+        pHolder->m_Origin= DeviceContent;
+        pHolder->m_Data= pDevice->readAll();
+        subject= GLC_InputData(pHolder, QString());
+    }
+    if (!wasOpen) pDevice->close();
+
+    return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+GLC_InputData::Origin GLC_InputData::origin() const
+{
+    Origin subject= NullData;
+    if (!m_pHolder.isNull())
+    {
+        subject= m_pHolder->m_Origin;
+    }
+    return subject;
+}
+
+GLC_InputData GLC_InputData::mid(qint64 offset, qint64 size) const
+{
+    GLC_InputData subject(*this);
+    offset= qBound(Q_INT64_C(0), offset, m_Size);
+    if ((size < 0) || (size > (m_Size - offset)))
+    {
+        size= m_Size - offset;
+    }
+    if (nullptr != m_pData)
+    {
+        subject.m_pData= m_pData + offset;
+    }
+    subject.m_Size= size;
+
+    return subject;
+}
+
+QByteArray GLC_InputData::byteArray() const
+{
+    return QByteArray::fromRawData(m_pData, static_cast<qsizetype>(m_Size));
+}
+
+bool GLC_InputData::startsWith(const char* pPrefix) const
+{
+    const qint64 prefixSize= static_cast<qint64>(strlen(pPrefix));
+    return (prefixSize <= m_Size) && (0 == memcmp(m_pData, pPrefix, static_cast<size_t>(prefixSize)));
+}
+
+QByteArray GLC_InputData::readLine(qint64* pPos) const
+{
+    const qint64 pos= qBound(Q_INT64_C(0), *pPos, m_Size);
+    if (pos == m_Size)
+    {
+        *pPos= m_Size;
+        return QByteArray();
+    }
+
+    const char* pBegin= m_pData + pos;
+    const char* pEnd= static_cast<const char*>(memchr(pBegin, '\n', static_cast<size_t>(m_Size - pos)));
+    qint64 length;
+    if (nullptr != pEnd)
+    {
+        length= pEnd - pBegin;
+        *pPos= pos + length + 1;
+    }
+    else
+    {
+        length= m_Size - pos;
+        *pPos= m_Size;
+    }
+    if ((length > 0) && ('\r' == pBegin[length - 1])) --length;
+
+    return QByteArray::fromRawData(pBegin, static_cast<qsizetype>(length));
+}
+
+qint64 GLC_InputData::lineCount() const
+{
+    qint64 subject= 0;
+    const char* pCurrent= m_pData;
+    const char* pEnd= m_pData + m_Size;
+    while (pCurrent < pEnd)
+    {
+        const char* pNewLine= static_cast<const char*>(memchr(pCurrent, '\n', static_cast<size_t>(pEnd - pCurrent)));
+        ++subject;
+        pCurrent= (nullptr != pNewLine) ? (pNewLine + 1) : pEnd;
+    }
+    return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_InputData::openBuffer(QBuffer* pBuffer) const
+{
+    if (pBuffer->isOpen()) pBuffer->close();
+    pBuffer->setData(byteArray());
+    return pBuffer->open(QIODevice::ReadOnly);
+}
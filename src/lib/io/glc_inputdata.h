@@ -0,0 +1,173 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_inputdata.h interface for the GLC_InputData class.
+
+#ifndef GLC_INPUTDATA_H_
+#define GLC_INPUTDATA_H_
+
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QString>
+
+#include "../glc_config.h"
+
+QT_BEGIN_NAMESPACE
+class QBuffer;
+class QIODevice;
+QT_END_NAMESPACE
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_InputData
+/*! \brief GLC_InputData : Contiguous read only bytes of a model to load*/
+
+/*! A GLC_InputData is a span of bytes read by world readers without copy :
+ *  - a memory mapped file (fromFile()), read in memory only if it can't be mapped,
+ *  - a byte array shared with the caller (fromByteArray()),
+ *  - a region of memory owned by the caller (fromRawData()), for example
+ *    a model embedded in a container file already mapped by the caller,
+ *  - the content of a device (fromDevice()). Files and buffers are used without copy,
+ *    other devices like archive entries are read once.
+ *
+ *  Copies share the same bytes, mid() returns a part of the span which keeps the whole data alive.
+ *  The file name is used by readers in messages and to find the files referenced by the model.
+ *
+ *  Readers which need a device use openBuffer(), readers of text formats can use readLine().*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_InputData
+{
+public:
+    //! The origin of the bytes
+    enum Origin
+    {
+        NullData,
+        MappedFile,
+        FileContent,
+        ByteArray,
+        RawData,
+        DeviceContent
+    };
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Construct a null input data
+    GLC_InputData();
+
+    //! Return the input data of the given file, null if the file can't be opened
+    static GLC_InputData fromFile(const QString& fileName);
+
+    //! Return the input data of the given byte array
+    static GLC_InputData fromByteArray(const QByteArray& data, const QString& fileName= QString());
+
+    //! Return the input data of the given memory region, which must outlive the input data and its copies
+    static GLC_InputData fromRawData(const char* pData, qint64 size, const QString& fileName= QString());
+
+    //! Return the input data of the given device from its current position, null if the device can't be read
+    /*! A QFile is mapped again by the input data and a QBuffer is shared, the device can be closed after the call.*/
+    static GLC_InputData fromDevice(QIODevice* pDevice);
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return true if this input data is null
+    inline bool isNull() const
+    {return m_pHolder.isNull();}
+
+    //! Return the origin of the bytes
+    Origin origin() const;
+
+    //! Return the bytes
+    inline const char* constData() const
+    {return m_pData;}
+
+    //! Return the number of bytes
+    inline qint64 size() const
+    {return m_Size;}
+
+    //! Return the file name of the input data
+    inline QString fileName() const
+    {return m_FileName;}
+
+    //! Return the given part of this input data, to the end if size is negative
+    GLC_InputData mid(qint64 offset, qint64 size= -1) const;
+
+    //! Return a byte array on the bytes without copy, valid while this input data is alive
+    QByteArray byteArray() const;
+
+    //! Return true if the bytes start with the given prefix
+    bool startsWith(const char* pPrefix) const;
+
+    //! Return the line starting at the given position without end of line characters and move the position to the next line
+    /*! The returned array doesn't copy the bytes, it is valid while this input data is alive.*/
+    QByteArray readLine(qint64* pPos) const;
+
+    //! Return the number of lines
+    qint64 lineCount() const;
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Set the file name of the input data
+    inline void setFileName(const QString& fileName)
+    {m_FileName= fileName;}
+
+    //! Set the given buffer on the bytes and open it read only, return true on success
+    /*! The buffer doesn't copy the bytes, it must not outlive this input data.*/
+    bool openBuffer(QBuffer* pBuffer) const;
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Owner of the bytes shared by copies
+    class Holder;
+
+    //! Construct an input data on the given holder
+    GLC_InputData(const QSharedPointer<Holder>& pHolder, const QString& fileName);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The owner of the bytes
+    QSharedPointer<Holder> m_pHolder;
+
+    //! The first byte
+    const char* m_pData;
+
+    //! The number of bytes
+    qint64 m_Size;
+
+    //! The file name
+    QString m_FileName;
+};
+
+#endif /* GLC_INPUTDATA_H_ */
@@ -27,6 +27,7 @@
 #include <QRegularExpression>
 
 #include "glc_objtoworld.h"
+#include "glc_inputdata.h"
 #include "../sceneGraph/glc_world.h"
 #include "glc_objmtlloader.h"
 #include "../glc_fileformatexception.h"
@@ -36,6 +37,7 @@
 #include "../sceneGraph/glc_structoccurrence.h"
 #include <QTextStream>
 #include <QFileInfo>
+#include <QBuffer>
 
 //////////////////////////////////////////////////////////////////////
 // Constructor
@@ -75,19 +77,27 @@ GLC_ObjToWorld::~GLC_ObjToWorld()
 // Create an GLC_World from an input OBJ File
 GLC_World* GLC_ObjToWorld::CreateWorldFromObj(QFile &file)
 {
-	m_ListOfAttachedFileName.clear();
-	m_FileName= file.fileName();
 	//////////////////////////////////////////////////////////////////
 	// Test if the file exist and can be opened
 	//////////////////////////////////////////////////////////////////
-	if (!file.open(QIODevice::ReadOnly))
+	const GLC_InputData input(GLC_InputData::fromDevice(&file));
+	if (input.isNull())
 	{
-		QString message(QString("GLC_ObjToWorld::CreateWorldFromObj File ") + m_FileName + QString(" doesn't exist"));
+		QString message(QString("GLC_ObjToWorld::CreateWorldFromObj File ") + file.fileName() + QString(" doesn't exist"));
 		//qDebug() << message;
-		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotFound);
+		GLC_FileFormatException fileFormatException(message, file.fileName(), GLC_FileFormatException::FileNotFound);
 		throw(fileFormatException);
 	}
 
+	return CreateWorldFromObj(input);
+}
+
+// Create an GLC_World from the given OBJ data
+GLC_World* GLC_ObjToWorld::CreateWorldFromObj(const GLC_InputData& input)
+{
+	m_ListOfAttachedFileName.clear();
+	m_FileName= input.fileName();
+
 	//////////////////////////////////////////////////////////////////
 	// Init member
 	//////////////////////////////////////////////////////////////////
@@ -98,8 +108,10 @@ GLC_World* GLC_ObjToWorld::CreateWorldFromObj(QFile &file)
 	int previousQuantumValue= 0;
 	int numberOfLine= 0;
 
-	// Create the input file stream
-	QTextStream objStream(&file);
+	// Create the input stream on the data without copy
+	QBuffer buffer;
+	input.openBuffer(&buffer);
+	QTextStream objStream(&buffer);
 
 	// QString buffer
 	QString lineBuff;
@@ -190,8 +202,6 @@ GLC_World* GLC_ObjToWorld::CreateWorldFromObj(QFile &file)
 		previousQuantumValue= currentQuantumValue;
 
 	}
-	file.close();
-
 	addCurrentObjMeshToWorld();
 
 	//! Test if there is meshes in the world
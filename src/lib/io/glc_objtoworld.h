@@ -44,6 +44,7 @@
 
 class GLC_World;
 class GLC_ObjMtlLoader;
+class GLC_InputData;
 
 //////////////////////////////////////////////////////////////////////
 //! \class GLC_ObjToWorld
@@ -167,6 +168,9 @@ public:
 	//! Create an GLC_World from an input OBJ File
 	GLC_World* CreateWorldFromObj(QFile &file);
 
+	//! Create an GLC_World from the given OBJ data, the mtl file is searched next to the data file name
+	GLC_World* CreateWorldFromObj(const GLC_InputData& input);
+
 	//! Get the list of attached files
 	inline QStringList listOfAttachedFileName() const{return m_ListOfAttachedFileName;}
 //@}
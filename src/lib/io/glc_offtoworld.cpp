@@ -24,6 +24,7 @@
 //! \file glc_offtoworld.cpp implementation of the GLC_OffToWorld class.
 
 #include "glc_offtoworld.h"
+#include "glc_inputdata.h"
 #include "../sceneGraph/glc_world.h"
 #include "../glc_fileformatexception.h"
 #include "../sceneGraph/glc_structreference.h"
@@ -32,6 +33,7 @@
 
 #include <QTextStream>
 #include <QFileInfo>
+#include <QBuffer>
 
 GLC_OffToWorld::GLC_OffToWorld()
 : m_pWorld(NULL)
@@ -63,18 +65,26 @@ GLC_OffToWorld::~GLC_OffToWorld()
 // Create an GLC_World from an input OFF File
 GLC_World* GLC_OffToWorld::CreateWorldFromOff(QFile &file)
 {
-	clear();
-	m_FileName= file.fileName();
 	//////////////////////////////////////////////////////////////////
 	// Test if the file exist and can be opened
 	//////////////////////////////////////////////////////////////////
-	if (!file.open(QIODevice::ReadOnly))
+	const GLC_InputData input(GLC_InputData::fromDevice(&file));
+	if (input.isNull())
 	{
-		QString message(QString("GLC_OffToWorld::CreateWorldFromOff File ") + m_FileName + QString(" doesn't exist"));
-		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotFound);
+		QString message(QString("GLC_OffToWorld::CreateWorldFromOff File ") + file.fileName() + QString(" doesn't exist"));
+		GLC_FileFormatException fileFormatException(message, file.fileName(), GLC_FileFormatException::FileNotFound);
 		throw(fileFormatException);
 	}
 
+	return CreateWorldFromOff(input);
+}
+
+// Create an GLC_World from the given OFF data
+GLC_World* GLC_OffToWorld::CreateWorldFromOff(const GLC_InputData& input)
+{
+	clear();
+	m_FileName= input.fileName();
+
 	//////////////////////////////////////////////////////////////////
 	// Init member
 	//////////////////////////////////////////////////////////////////
@@ -84,8 +94,10 @@ GLC_World* GLC_OffToWorld::CreateWorldFromOff(QFile &file)
 	int currentQuantumValue= 0;
 	int previousQuantumValue= 0;
 
-	// Create the input file stream
-	QTextStream offStream(&file);
+	// Create the input stream on the data without copy
+	QBuffer buffer;
+	input.openBuffer(&buffer);
+	QTextStream offStream(&buffer);
 
 	// QString buffer
 	QString lineBuff;
@@ -206,7 +218,6 @@ GLC_World* GLC_OffToWorld::CreateWorldFromOff(QFile &file)
 
 	}
 
-	file.close();
 	// Compute mesh normals
 	computeNormal();
 
@@ -40,6 +40,7 @@
 #include "../glc_config.h"
 
 class GLC_World;
+class GLC_InputData;
 
 //////////////////////////////////////////////////////////////////////
 //! \class GLC_OffToWorld
@@ -74,6 +75,9 @@ public:
 public:
 	//! Create an GLC_World from an input OFF File
 	GLC_World* CreateWorldFromOff(QFile &file);
+
+	//! Create an GLC_World from the given OFF data
+	GLC_World* CreateWorldFromOff(const GLC_InputData& input);
 //@}
 
 //////////////////////////////////////////////////////////////////////
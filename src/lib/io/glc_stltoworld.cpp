@@ -31,14 +31,17 @@
 
 #include <QTextStream>
 #include <QFileInfo>
-#include <QDataStream>
+#include <QtEndian>
+
+#include <algorithm>
 
 GLC_StlToWorld::GLC_StlToWorld()
 : QObject()
 , m_pWorld(NULL)
 , m_FileName()
 , m_CurrentLineNumber(0)
-, m_StlStream()
+, m_Input()
+, m_InputPos(0)
 , m_pCurrentMesh(NULL)
 , m_CurrentFace()
 , m_VertexBulk()
@@ -60,17 +63,28 @@ GLC_StlToWorld::~GLC_StlToWorld()
 // Create an GLC_World from an input STL File
 GLC_World* GLC_StlToWorld::CreateWorldFromStl(QFile &file)
 {
-	clear();
-	m_FileName= file.fileName();
 	//////////////////////////////////////////////////////////////////
 	// Test if the file exist and can be opened
 	//////////////////////////////////////////////////////////////////
-	if (!file.open(QIODevice::ReadOnly))
+	const GLC_InputData input(GLC_InputData::fromDevice(&file));
+	if (input.isNull())
 	{
-		QString message(QString("GLC_StlToWorld::CreateWorldFromStl File ") + m_FileName + QString(" doesn't exist"));
-		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::FileNotFound);
+		QString message(QString("GLC_StlToWorld::CreateWorldFromStl File ") + file.fileName() + QString(" doesn't exist"));
+		GLC_FileFormatException fileFormatException(message, file.fileName(), GLC_FileFormatException::FileNotFound);
 		throw(fileFormatException);
 	}
+
+	return CreateWorldFromStl(input);
+}
+
+// Create an GLC_World from the given STL data
+GLC_World* GLC_StlToWorld::CreateWorldFromStl(const GLC_InputData& input)
+{
+	clear();
+	m_FileName= input.fileName();
+	m_Input= input;
+	m_InputPos= 0;
+
 	//////////////////////////////////////////////////////////////////
 	// Init member
 	//////////////////////////////////////////////////////////////////
@@ -78,34 +92,24 @@ GLC_World* GLC_StlToWorld::CreateWorldFromStl(QFile &file)
 
 	// Create Working variables
 	int currentQuantumValue= 0;
-	int numberOfLine= 0;
-
-	// Attach the stream to the file
-	m_StlStream.setDevice(&file);
-
-	// QString buffer
-	QString lineBuff;
 
 	//////////////////////////////////////////////////////////////////
-	// Count the number of lines of the STL file
-    // And test if the STL file is ASCII
+	// Test if the STL file is ASCII
+	// A binary STL contains 84 bytes and 50 bytes by facet
 	//////////////////////////////////////////////////////////////////
-    bool stlIsAscii= false;
-	while (!m_StlStream.atEnd())
+	bool stlIsAscii= false;
+	const qint64 size= m_Input.size();
+	const bool binarySize= (size >= 84) && ((84 + 50 * static_cast<qint64>(qFromLittleEndian<quint32>(m_Input.constData() + 80))) == size);
+	if (!binarySize)
 	{
-		++numberOfLine;
-        const QString currentLine= m_StlStream.readLine();
-        if (!stlIsAscii)
-        {
-            stlIsAscii= currentLine.contains("facet", Qt::CaseInsensitive);
-        }
+		const char facet[]= "facet";
+		const char* pEnd= m_Input.constData() + size;
+		stlIsAscii= std::search(m_Input.constData(), pEnd, facet, facet + 5, [](char c1, char c2)
+		{
+			return (c1 == c2) || ((c1 >= 'A') && (c1 <= 'Z') && ((c1 - 'A' + 'a') == c2));
+		}) != pEnd;
 	}
 
-	//////////////////////////////////////////////////////////////////
-	// Reset the stream
-	//////////////////////////////////////////////////////////////////
-	m_StlStream.resetStatus();
-	m_StlStream.seek(0);
 	//////////////////////////////////////////////////////////////////
 	// Read Buffer and create the world
 	//////////////////////////////////////////////////////////////////
@@ -114,14 +118,15 @@ GLC_World* GLC_StlToWorld::CreateWorldFromStl(QFile &file)
 	m_CurrentLineNumber= 0;
 	// Search Object section in the STL
 
-	// Test if the STL File is ASCII or Binary
-	++m_CurrentLineNumber;
-	lineBuff= m_StlStream.readLine();
-	lineBuff= lineBuff.trimmed().toLower();
     if (!stlIsAscii)
 	{
 		// The STL File is not ASCII trying to load Binary STL File
 		m_pCurrentMesh= new GLC_Mesh();
+
+		// The name is in the 80 bytes header
+		qint64 headerPos= 0;
+		QString lineBuff(QString::fromUtf8(m_Input.mid(0, 80).readLine(&headerPos)));
+		lineBuff= lineBuff.trimmed().toLower();
         if (lineBuff.startsWith("solid"))
         {
             lineBuff.remove(0, 5);
@@ -129,8 +134,7 @@ GLC_World* GLC_StlToWorld::CreateWorldFromStl(QFile &file)
             m_pCurrentMesh->setName(lineBuff);
         }
 
-		file.reset();
-		LoadBinariStl(file);
+		LoadBinariStl();
 		m_pCurrentMesh->addTriangles(NULL, m_CurrentFace);
 		m_CurrentFace.clear();
 		m_pCurrentMesh->addVertice(m_VertexBulk.toVector());
@@ -144,7 +148,13 @@ GLC_World* GLC_StlToWorld::CreateWorldFromStl(QFile &file)
 	}
 	else
 	{
+		// Count the number of lines of the STL file
+		const qint64 numberOfLine= m_Input.lineCount();
+
 		// The STL File is ASCII
+		++m_CurrentLineNumber;
+		QString lineBuff(readLine());
+		lineBuff= lineBuff.trimmed().toLower();
 		m_pCurrentMesh= new GLC_Mesh();
         if (lineBuff.startsWith("solid"))
         {
@@ -155,7 +165,7 @@ GLC_World* GLC_StlToWorld::CreateWorldFromStl(QFile &file)
         // Read the mesh facet
         int previousQuantumValue= 0;
 
-		while (!m_StlStream.atEnd())
+		while (!atEnd())
 		{
 			scanFacet();
 
@@ -167,7 +177,8 @@ GLC_World* GLC_StlToWorld::CreateWorldFromStl(QFile &file)
 			previousQuantumValue= currentQuantumValue;
 		}
 	}
-	file.close();
+	m_Input= GLC_InputData();
+	m_InputPos= 0;
 
 	return m_pWorld;
 }
@@ -186,6 +197,8 @@ void GLC_StlToWorld::clear()
 	}
 	m_pWorld= NULL;
 	m_FileName.clear();
+	m_Input= GLC_InputData();
+	m_InputPos= 0;
 	m_CurrentLineNumber= 0;
 	m_pCurrentMesh= NULL;
 	m_CurrentFace.clear();
@@ -196,7 +209,7 @@ void GLC_StlToWorld::scanFacet()
 {
 ////////////////////////////////////////////// Test end of solid section////////////////////
 	++m_CurrentLineNumber;
-	QString lineBuff(m_StlStream.readLine());
+	QString lineBuff(readLine());
 	lineBuff= lineBuff.trimmed().toLower();
 	// Test if this is the end of current solid
 	if (lineBuff.startsWith("endsolid") || lineBuff.startsWith("end solid"))
@@ -248,7 +261,7 @@ void GLC_StlToWorld::scanFacet()
 
 ////////////////////////////////////////////// Outer Loop////////////////////////////////
 	++m_CurrentLineNumber;
-	lineBuff= m_StlStream.readLine();
+	lineBuff= readLine();
 	lineBuff= lineBuff.trimmed().toLower();
 	// lineBuff Must begin with "outer loop"
 	if (!lineBuff.startsWith("outer loop"))
@@ -266,7 +279,7 @@ void GLC_StlToWorld::scanFacet()
 	for (int i= 0; i < 3; ++i)
 	{
 		++m_CurrentLineNumber;
-		lineBuff= m_StlStream.readLine();
+		lineBuff= readLine();
 		lineBuff= lineBuff.trimmed().toLower();
 		// lineBuff Must begin with "vertex"
 		if (!lineBuff.startsWith("vertex"))
@@ -292,7 +305,7 @@ void GLC_StlToWorld::scanFacet()
 
 ////////////////////////////////////////////// End Loop////////////////////////////////
 	++m_CurrentLineNumber;
-	lineBuff= m_StlStream.readLine();
+	lineBuff= readLine();
 	lineBuff= lineBuff.trimmed().toLower();
 	// lineBuff Must begin with "endloop"
 	if (!lineBuff.startsWith("endloop"))
@@ -307,7 +320,7 @@ void GLC_StlToWorld::scanFacet()
 
 ////////////////////////////////////////////// End Facet////////////////////////////////
 	++m_CurrentLineNumber;
-	lineBuff= m_StlStream.readLine();
+	lineBuff= readLine();
 	lineBuff= lineBuff.trimmed().toLower();
 	// lineBuff Must begin with "endfacet"
 	if (!lineBuff.startsWith("endfacet"))
@@ -355,67 +368,52 @@ GLC_Vector3df GLC_StlToWorld::extract3dVect(QString &line)
 
 }
 // Load Binarie STL File
-void GLC_StlToWorld::LoadBinariStl(QFile &file)
+void GLC_StlToWorld::LoadBinariStl()
 {
 	// Create Working variables
 	int previousQuantumValue= 0;
 
-	QDataStream stlBinFile(&file);
-	stlBinFile.setVersion(QDataStream::Qt_4_6);
-	stlBinFile.setFloatingPointPrecision(QDataStream::SinglePrecision);
-	stlBinFile.setByteOrder(QDataStream::LittleEndian);
-
-	// Skip 80 Bytes STL header
-	int SkipedData= stlBinFile.skipRawData(80);
-	// Check if an error occur
-	if (-1 == SkipedData)
+	// Skip 80 Bytes STL header and read the number of facet
+	if (m_Input.size() < 84)
 	{
-		QString message= "GLC_StlToWorld::LoadBinariStl : Failed to skip Header of binary STL";
+		QString message= "GLC_StlToWorld::LoadBinariStl : Failed to read the number of facets of binary STL";
 		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
 		clear();
 		throw(fileFormatException);
 	}
-	// Read the number of facet
-	quint32 numberOfFacet= 0;
-	stlBinFile >> numberOfFacet;
-	// Check if an error occur
-	if (QDataStream::Ok != stlBinFile.status())
+	const char* pData= m_Input.constData();
+	const quint32 numberOfFacet= qFromLittleEndian<quint32>(pData + 80);
+
+	// A facet is a normal, 3 vertexs and 2 fill-bytes
+	const qint64 facetSize= 50;
+	if ((84 + static_cast<qint64>(numberOfFacet) * facetSize) > m_Input.size())
 	{
-		QString message= "GLC_StlToWorld::LoadBinariStl : Failed to read the number of facets of binary STL";
+		QString message= "GLC_StlToWorld::LoadBinariStl : Failed to read the facets of binary STL";
 		GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
 		clear();
 		throw(fileFormatException);
 	}
+
+	m_VertexBulk.reserve(m_VertexBulk.size() + numberOfFacet * 9);
+	m_NormalBulk.reserve(m_NormalBulk.size() + numberOfFacet * 9);
+	m_CurrentFace.reserve(m_CurrentFace.size() + numberOfFacet * 3);
+
+	// The facets are read in place
+	const char* pFacet= pData + 84;
 	for (quint32 i= 0; i < numberOfFacet; ++i)
 	{
 		// Extract the facet normal
-		float nx, ny, nz;
-		stlBinFile >> nx >> ny >> nz;
-		// Check if an error occur
-		if (QDataStream::Ok != stlBinFile.status())
-		{
-			QString message= "GLC_StlToWorld::LoadBinariStl : Failed to read the Normal of binary STL";
-			GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-			clear();
-			throw(fileFormatException);
-		}
+		const float nx= qFromLittleEndian<float>(pFacet);
+		const float ny= qFromLittleEndian<float>(pFacet + 4);
+		const float nz= qFromLittleEndian<float>(pFacet + 8);
 
 		// Extract the 3 Vertexs
 		for (int j= 0; j < 3; ++j)
 		{
-			float x, y, z;
-			stlBinFile >> x >> y >> z;
-			// Check if an error occur
-			if (QDataStream::Ok != stlBinFile.status())
-			{
-				QString message= "GLC_StlToWorld::LoadBinariStl : Failed to read the Vertex of binary STL";
-				GLC_FileFormatException fileFormatException(message, m_FileName, GLC_FileFormatException::WrongFileFormat);
-				clear();
-				throw(fileFormatException);
-			}
-			m_VertexBulk.append(x);
-			m_VertexBulk.append(y);
-			m_VertexBulk.append(z);
+			const char* pVertex= pFacet + 12 * (j + 1);
+			m_VertexBulk.append(qFromLittleEndian<float>(pVertex));
+			m_VertexBulk.append(qFromLittleEndian<float>(pVertex + 4));
+			m_VertexBulk.append(qFromLittleEndian<float>(pVertex + 8));
 
 			m_NormalBulk.append(nx);
 			m_NormalBulk.append(ny);
@@ -431,9 +429,12 @@ void GLC_StlToWorld::LoadBinariStl(QFile &file)
 		}
 		previousQuantumValue= currentQuantumValue;
 
-		// Skip 2 fill-bytes not needed !!!!
-		stlBinFile.skipRawData(2);
-
+		pFacet+= facetSize;
 	}
 }
 
+// Return the next line of the input data
+QString GLC_StlToWorld::readLine()
+{
+	return QString::fromUtf8(m_Input.readLine(&m_InputPos));
+}
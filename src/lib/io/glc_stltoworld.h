@@ -31,6 +31,7 @@
 #include <QTextStream>
 
 #include "../geometry/glc_mesh.h"
+#include "glc_inputdata.h"
 #include "../maths/glc_vector3df.h"
 
 #include "../glc_config.h"
@@ -67,6 +68,9 @@ public:
 public:
 	//! Create and return an GLC_World* from an input STL File
 	GLC_World* CreateWorldFromStl(QFile &file);
+
+	//! Create and return an GLC_World* from the given STL data
+	GLC_World* CreateWorldFromStl(const GLC_InputData& input);
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -81,7 +85,14 @@ private:
 	//! Extract a 3D Vector from a string
 	GLC_Vector3df extract3dVect(QString &);
 	//! Load Binarie STL File
-	void LoadBinariStl(QFile &);
+	void LoadBinariStl();
+
+	//! Return the next line of the input data
+	QString readLine();
+
+	//! Return true if the end of the input data is reached
+	inline bool atEnd() const
+	{return m_InputPos >= m_Input.size();}
 
 
 
@@ -106,8 +117,11 @@ private:
 	//! The current line number
 	int m_CurrentLineNumber;
 
-	//! The Text Stream
-	QTextStream m_StlStream;
+	//! The input data
+	GLC_InputData m_Input;
+
+	//! The current position in the input data
+	qint64 m_InputPos;
 
 	//! The current mesh
 	GLC_Mesh* m_pCurrentMesh;
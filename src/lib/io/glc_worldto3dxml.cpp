@@ -31,6 +31,63 @@
 
 #include <QFileInfo>
 #include <QDataStream>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    //! Deflate the given data without zlib header with the given level, return true on success
+    bool deflateData(const QByteArray& data, int level, QByteArray* pCompressed)
+    {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        if (Z_OK != deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, DEF_MEM_LEVEL, Z_DEFAULT_STRATEGY))
+        {
+            return false;
+        }
+
+        // The input is given by chunks, avail_in is 32 bits
+        const qint64 chunkSize= 1 << 30;
+        const char* pInput= data.constData();
+        qint64 remainingSize= data.size();
+        pCompressed->resize(static_cast<qsizetype>(deflateBound(&stream, static_cast<uLong>(qMin(remainingSize, chunkSize)))));
+        qint64 outputSize= 0;
+        int result= Z_OK;
+        do
+        {
+            const uInt inputSize= static_cast<uInt>(qMin(remainingSize, chunkSize));
+            stream.next_in= reinterpret_cast<Bytef*>(const_cast<char*>(pInput));
+            stream.avail_in= inputSize;
+            pInput+= inputSize;
+            remainingSize-= inputSize;
+            const int flush= (remainingSize > 0) ? Z_NO_FLUSH : Z_FINISH;
+            do
+            {
+                if (outputSize == pCompressed->size())
+                {
+                    pCompressed->resize(pCompressed->size() * 2);
+                }
+                const uInt availableSize= static_cast<uInt>(qMin(pCompressed->size() - outputSize, chunkSize));
+                stream.next_out= reinterpret_cast<Bytef*>(pCompressed->data() + outputSize);
+                stream.avail_out= availableSize;
+                result= deflate(&stream, flush);
+                // No progress is possible when the chunk is consumed and the output is full
+                if ((Z_BUF_ERROR == result) && (Z_NO_FLUSH == flush)) result= Z_OK;
+                outputSize+= availableSize - stream.avail_out;
+            }
+            while ((Z_OK == result) && (0 == stream.avail_out));
+        }
+        while ((Z_OK == result) && (remainingSize > 0));
+
+        deflateEnd(&stream);
+        pCompressed->resize(static_cast<qsizetype>(outputSize));
+
+        return Z_STREAM_END == result;
+    }
+}
 
 GLC_WorldTo3dxml::GLC_WorldTo3dxml(const GLC_World& world, bool threaded)
 : QObject()
@@ -60,12 +117,16 @@ GLC_WorldTo3dxml::GLC_WorldTo3dxml(const GLC_World& world, bool threaded)
 , m_pReadWriteLock(NULL)
 , m_pIsInterupted(NULL)
 , m_IsThreaded(threaded)
+, m_ParallelExport(true)
+, m_XmlCompressionLevel(Z_DEFAULT_COMPRESSION)
+, m_BinaryCompressionLevel(Z_DEFAULT_COMPRESSION)
 {
 	m_World.rootOccurrence()->updateOccurrenceNumber(1);
 }
 
 GLC_WorldTo3dxml::~GLC_WorldTo3dxml()
 {
+	delete m_pOutStream;
     delete m_pCurrentFile;
 	delete m_pCurrentZipFile;
     delete m_p3dxmlArchive;
@@ -108,32 +169,7 @@ bool GLC_WorldTo3dxml::exportTo3dxml(const QString& filename, GLC_WorldTo3dxml::
 
 		if (m_ExportType != StructureOnly)
 		{
-			int previousQuantumValue= 0;
-			int currentQuantumValue= 0;
-			emit currentQuantum(currentQuantumValue);
-
-			int currentRepIndex= 0;
-			const int size= m_ReferenceRepTo3dxmlFileName.size();
-			// Export the representation
-			QHash<const GLC_3DRep*, QString>::const_iterator iRep= m_ReferenceRepTo3dxmlFileName.constBegin();
-			while ((m_ReferenceRepTo3dxmlFileName.constEnd() != iRep) && continu())
-			{
-				write3DRep(iRep.key(), iRep.value());
-				++iRep;
-
-				// Progrees bar indicator
-				++currentRepIndex;
-				currentQuantumValue = static_cast<int>((static_cast<double>(currentRepIndex) / size) * 100);
-				if (currentQuantumValue > previousQuantumValue)
-				{
-					emit currentQuantum(currentQuantumValue);
-				}
-				previousQuantumValue= currentQuantumValue;
-				if (!m_IsThreaded)
-				{
-					QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-				}
-			}
+			exportRepresentations();
 		}
 	}
 
@@ -162,32 +198,7 @@ bool GLC_WorldTo3dxml::exportTo3dxml(QIODevice* pDevice, const QString& fileName
         // Export the assembly structure from the list of structure reference
         exportAssemblyStructure();
 
-        int previousQuantumValue= 0;
-        int currentQuantumValue= 0;
-        emit currentQuantum(currentQuantumValue);
-
-        int currentRepIndex= 0;
-        const int size= m_ReferenceRepTo3dxmlFileName.size();
-        // Export the representation
-        QHash<const GLC_3DRep*, QString>::const_iterator iRep= m_ReferenceRepTo3dxmlFileName.constBegin();
-        while ((m_ReferenceRepTo3dxmlFileName.constEnd() != iRep) && continu())
-        {
-            write3DRep(iRep.key(), iRep.value());
-            ++iRep;
-
-            // Progrees bar indicator
-            ++currentRepIndex;
-            currentQuantumValue = static_cast<int>((static_cast<double>(currentRepIndex) / size) * 100);
-            if (currentQuantumValue > previousQuantumValue)
-            {
-                emit currentQuantum(currentQuantumValue);
-            }
-            previousQuantumValue= currentQuantumValue;
-            if (!m_IsThreaded)
-            {
-                QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-            }
-        }
+        exportRepresentations();
     }
 
     emit currentQuantum(100);
@@ -215,32 +226,7 @@ bool GLC_WorldTo3dxml::exportToNative(QIODevice* pDevice, const QString& fileNam
         // Export the assembly structure from the list of structure reference
         exportAssemblyStructure();
 
-        int previousQuantumValue= 0;
-        int currentQuantumValue= 0;
-        emit currentQuantum(currentQuantumValue);
-
-        int currentRepIndex= 0;
-        const int size= m_ReferenceRepTo3dxmlFileName.size();
-        // Export the representation
-        QHash<const GLC_3DRep*, QString>::const_iterator iRep= m_ReferenceRepTo3dxmlFileName.constBegin();
-        while ((m_ReferenceRepTo3dxmlFileName.constEnd() != iRep) && continu())
-        {
-            write3DRep(iRep.key(), iRep.value());
-            ++iRep;
-
-            // Progrees bar indicator
-            ++currentRepIndex;
-            currentQuantumValue = static_cast<int>((static_cast<double>(currentRepIndex) / size) * 100);
-            if (currentQuantumValue > previousQuantumValue)
-            {
-                emit currentQuantum(currentQuantumValue);
-            }
-            previousQuantumValue= currentQuantumValue;
-            if (!m_IsThreaded)
-            {
-                QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-            }
-        }
+        exportRepresentations();
     }
 
     emit currentQuantum(100);
@@ -380,10 +366,10 @@ void GLC_WorldTo3dxml::setStreamWriterToFile(const QString& fileName)
 		}
 		QuaZipNewInfo quazipNewInfo(fileName);
 		m_pCurrentZipFile= new QuaZipFile(m_p3dxmlArchive);
-		success= m_pCurrentZipFile->open(QIODevice::WriteOnly, quazipNewInfo);
+		success= m_pCurrentZipFile->open(QIODevice::WriteOnly, quazipNewInfo, NULL, 0, Z_DEFLATED, m_XmlCompressionLevel);
 		if (success)
 		{
-			m_pOutStream= new QXmlStreamWriter(m_pCurrentZipFile);
+			m_pOutStream= new GLC_BufferedXmlWriter(m_pCurrentZipFile);
 		}
 	}
 	else
@@ -393,7 +379,7 @@ void GLC_WorldTo3dxml::setStreamWriterToFile(const QString& fileName)
 		success= m_pCurrentFile->open(QIODevice::WriteOnly);
 		if (success)
 		{
-			m_pOutStream= new QXmlStreamWriter(m_pCurrentFile);
+			m_pOutStream= new GLC_BufferedXmlWriter(m_pCurrentFile);
 		}
 	}
 
@@ -539,27 +525,17 @@ void GLC_WorldTo3dxml::exportAssemblyFromOccurrence(const GLC_StructOccurrence*
 
 QString GLC_WorldTo3dxml::matrixString(const GLC_Matrix4x4& matrix)
 {
-	QString resultMatrix;
-	const QChar spaceChar(' ');
-	// Rotation
-	resultMatrix+= QString::number(matrix.getData()[0], 'g', 16) + spaceChar;
-	resultMatrix+= QString::number(matrix.getData()[1], 'g', 16) + spaceChar;
-	resultMatrix+= QString::number(matrix.getData()[2], 'g', 16) + spaceChar;
-
-	resultMatrix+= QString::number(matrix.getData()[4], 'g', 16) + spaceChar;
-	resultMatrix+= QString::number(matrix.getData()[5], 'g', 16) + spaceChar;
-	resultMatrix+= QString::number(matrix.getData()[6], 'g', 16) + spaceChar;
-
-	resultMatrix+= QString::number(matrix.getData()[8], 'g', 16) + spaceChar;
-	resultMatrix+= QString::number(matrix.getData()[9], 'g', 16) + spaceChar;
-	resultMatrix+= QString::number(matrix.getData()[10], 'g', 16) + spaceChar;
-
-	// Translation
-	resultMatrix+= QString::number(matrix.getData()[12], 'g', 16) + spaceChar;
-	resultMatrix+= QString::number(matrix.getData()[13], 'g', 16) + spaceChar;
-	resultMatrix+= QString::number(matrix.getData()[14], 'g', 16);
-
-	return resultMatrix;
+	// Rotation columns followed by the translation
+	const int indexes[12]= {0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14};
+	const double* pData= matrix.getData();
+	QByteArray resultMatrix;
+	for (int i= 0; i < 12; ++i)
+	{
+		if (i > 0) resultMatrix.append(' ');
+		GLC_BufferedXmlWriter::appendDouble(&resultMatrix, pData[indexes[i]]);
+	}
+
+	return QString::fromLatin1(resultMatrix);
 }
 
 void GLC_WorldTo3dxml::write3DRep(const GLC_3DRep* pRep, const QString& fileName)
@@ -578,7 +554,7 @@ void GLC_WorldTo3dxml::write3DRep(const GLC_3DRep* pRep, const QString& fileName
         }
         QuaZipNewInfo quazipNewInfo(fileName);
         m_pCurrentZipFile= new QuaZipFile(m_p3dxmlArchive);
-        success= m_pCurrentZipFile->open(QIODevice::WriteOnly, quazipNewInfo);
+        success= m_pCurrentZipFile->open(QIODevice::WriteOnly, quazipNewInfo, nullptr, 0, Z_DEFLATED, m_BinaryCompressionLevel);
         if (success)
         {
             QDataStream dataStream(m_pCurrentZipFile);
@@ -592,31 +568,236 @@ void GLC_WorldTo3dxml::write3DRep(const GLC_3DRep* pRep, const QString& fileName
     {
         setStreamWriterToFile(fileName);
 
-        m_pOutStream->writeStartDocument();
-        m_pOutStream->writeStartElement("XMLRepresentation");
-        m_pOutStream->writeAttribute("version", "1.2");
-        m_pOutStream->writeAttribute("xmlns", "http://www.3ds.com/xsd/3DXML");
-        m_pOutStream->writeAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-        m_pOutStream->writeAttribute("xmlns:xlink", "http://www.w3.org/1999/xlink");
-        m_pOutStream->writeAttribute("xsi:schemaLocation", "http://www.3ds.com/xsd/3DXML ./3DXMLMesh.xsd");
-
-        m_pOutStream->writeStartElement("Root"); // Root
-        m_pOutStream->writeAttribute("xsi:type", "BagRepType");
-        m_pOutStream->writeAttribute("id", QString::number(++m_CurrentId));
-        const int bodyCount= pRep->numberOfBody();
-        for (int i= 0; i < bodyCount; ++i)
+        const unsigned int firstId= m_CurrentId + 1;
+        m_CurrentId+= representationIdCount(pRep);
+        writeXmlRepresentation(m_pOutStream, pRep, firstId, m_ParallelExport);
+    }
+}
+
+void GLC_WorldTo3dxml::exportRepresentations()
+{
+    // Representations are written in the order of their ids so the output is deterministic
+    QList<const GLC_3DRep*> repList= m_ReferenceRepTo3dxmlFileName.keys();
+    std::sort(repList.begin(), repList.end(), [this](const GLC_3DRep* pRep1, const GLC_3DRep* pRep2)
+    {
+        return m_ReferenceRepToIdHash.value(pRep1) < m_ReferenceRepToIdHash.value(pRep2);
+    });
+
+    emit currentQuantum(0);
+    if (m_ParallelExport && (repList.size() > 1))
+    {
+        exportRepresentationsInParallel(repList);
+    }
+    else
+    {
+        int previousQuantumValue= 0;
+        const int size= repList.size();
+        for (int i= 0; (i < size) && continu(); ++i)
+        {
+            const GLC_3DRep* pRep= repList.at(i);
+            write3DRep(pRep, m_ReferenceRepTo3dxmlFileName.value(pRep));
+            updateProgress(i + 1, size, &previousQuantumValue);
+        }
+    }
+}
+
+void GLC_WorldTo3dxml::exportRepresentationsInParallel(const QList<const GLC_3DRep*>& repList)
+{
+    // Ids are given serially, XML representations use the same ids as the serial export
+    typedef QPair<const GLC_3DRep*, unsigned int> RepAndId;
+    QList<RepAndId> repAndIds;
+    for (const GLC_3DRep* pRep : repList)
+    {
+        repAndIds.append(qMakePair(pRep, m_CurrentId + 1));
+        if (m_ExportType != GLC_WorldTo3dxml::CompressedNative)
+        {
+            m_CurrentId+= representationIdCount(pRep);
+        }
+    }
+
+    // Entries are prepared by batches to bound the memory used,
+    // the next batch is prepared while the current one is appended
+    const int size= repAndIds.size();
+    const int batchSize= QThread::idealThreadCount() * 2;
+    auto prepareBatch= [this, &repAndIds, batchSize](int index)
+    {
+        return QtConcurrent::mapped(repAndIds.mid(index, batchSize), [this](const RepAndId& repAndId)
+        {
+            return prepareEntry(repAndId.first, m_ReferenceRepTo3dxmlFileName.value(repAndId.first), repAndId.second);
+        });
+    };
+
+    int previousQuantumValue= 0;
+    int index= 0;
+    bool isInterupted= false;
+    QFuture<PreparedEntry> future= prepareBatch(index);
+    while ((index < size) && !isInterupted)
+    {
+        const QList<PreparedEntry> entries(future.results());
+        const int nextIndex= index + entries.size();
+        if (nextIndex < size)
+        {
+            future= prepareBatch(nextIndex);
+        }
+
+        try
+        {
+            const int entryCount= entries.size();
+            for (int i= 0; (i < entryCount) && !isInterupted; ++i)
+            {
+                // An entry is not prepared only if the export has been interrupted
+                isInterupted= !entries.at(i).m_IsValid || !continu();
+                if (!isInterupted)
+                {
+                    appendPreparedEntry(entries.at(i));
+                    ++index;
+                    updateProgress(index, size, &previousQuantumValue);
+                }
+            }
+        }
+        catch (...)
+        {
+            future.waitForFinished();
+            throw;
+        }
+    }
+    future.waitForFinished();
+}
+
+GLC_WorldTo3dxml::PreparedEntry GLC_WorldTo3dxml::prepareEntry(const GLC_3DRep* pRep, const QString& fileName, unsigned int firstId) const
+{
+    PreparedEntry subject;
+    subject.m_FileName= fileName;
+    subject.m_Crc= 0;
+    subject.m_UncompressedSize= 0;
+    subject.m_Level= m_XmlCompressionLevel;
+    subject.m_IsValid= false;
+
+    if (continu())
+    {
+        QByteArray data;
+        if (m_ExportType == GLC_WorldTo3dxml::CompressedNative)
+        {
+            QDataStream dataStream(&data, QIODevice::WriteOnly);
+            dataStream << *pRep;
+            subject.m_Level= m_BinaryCompressionLevel;
+        }
+        else
+        {
+            // The meshes are written by this thread, the representations are already written in parallel
+            GLC_BufferedXmlWriter writer;
+            writer.setAutoFormatting(true);
+            writeXmlRepresentation(&writer, pRep, firstId, false);
+            data= writer.buffer();
+        }
+
+        subject.m_UncompressedSize= static_cast<quint64>(data.size());
+        if (nullptr != m_p3dxmlArchive)
         {
-            GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(pRep->geomAt(i));
-            if (NULL != pMesh)
+            subject.m_Crc= static_cast<quint32>(crc32_z(0L, reinterpret_cast<const Bytef*>(data.constData()), static_cast<z_size_t>(data.size())));
+            if ((0 == subject.m_Level) || !deflateData(data, subject.m_Level, &subject.m_Data))
             {
-                writeGeometry(pMesh);
+                // The entry is stored
+                subject.m_Level= 0;
+                subject.m_Data= data;
             }
         }
-        m_pOutStream->writeEndElement(); // Root
+        else
+        {
+            subject.m_Data= data;
+        }
+        subject.m_IsValid= true;
+    }
+
+    return subject;
+}
 
-        m_pOutStream->writeEndElement(); // XMLRepresentation
+void GLC_WorldTo3dxml::appendPreparedEntry(const PreparedEntry& entry)
+{
+    delete m_pOutStream;
+    m_pOutStream= nullptr;
 
-        m_pOutStream->writeEndDocument();
+    bool success= false;
+    if (nullptr != m_p3dxmlArchive)
+    {
+        if (nullptr != m_pCurrentZipFile)
+        {
+            m_pCurrentZipFile->close();
+            delete m_pCurrentZipFile;
+            m_pCurrentZipFile= nullptr;
+        }
+        QuaZipNewInfo quazipNewInfo(entry.m_FileName);
+        quazipNewInfo.uncompressedSize= static_cast<ulong>(entry.m_UncompressedSize);
+
+        // The data is already compressed, the entry is opened in raw mode
+        const int method= (0 == entry.m_Level) ? 0 : Z_DEFLATED;
+        QuaZipFile zipFile(m_p3dxmlArchive);
+        success= zipFile.open(QIODevice::WriteOnly, quazipNewInfo, nullptr, entry.m_Crc, method, entry.m_Level, true);
+        if (success)
+        {
+            success= (zipFile.write(entry.m_Data) == entry.m_Data.size());
+            zipFile.close();
+            success= success && (ZIP_OK == zipFile.getZipError());
+        }
+    }
+    else
+    {
+        QFile file(m_AbsolutePath + entry.m_FileName);
+        success= file.open(QIODevice::WriteOnly) && (file.write(entry.m_Data) == entry.m_Data.size());
+    }
+
+    if (!success)
+    {
+        QString message(QString("GLC_WorldTo3dxml::appendPreparedEntry Unable to write ") + entry.m_FileName);
+        GLC_Exception fileException(message);
+        throw(fileException);
+    }
+}
+
+void GLC_WorldTo3dxml::writeXmlRepresentation(GLC_BufferedXmlWriter* pWriter, const GLC_3DRep* pRep, unsigned int firstId, bool parallel) const
+{
+    pWriter->writeStartDocument();
+    pWriter->writeStartElement("XMLRepresentation");
+    pWriter->writeAttribute("version", "1.2");
+    pWriter->writeAttribute("xmlns", "http://www.3ds.com/xsd/3DXML");
+    pWriter->writeAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
+    pWriter->writeAttribute("xmlns:xlink", "http://www.w3.org/1999/xlink");
+    pWriter->writeAttribute("xsi:schemaLocation", "http://www.3ds.com/xsd/3DXML ./3DXMLMesh.xsd");
+
+    pWriter->writeStartElement("Root"); // Root
+    pWriter->writeAttribute("xsi:type", "BagRepType");
+    pWriter->writeAttribute("id", QString::number(firstId));
+    writeGeometries(pWriter, pRep, firstId + 1, parallel);
+    pWriter->writeEndElement(); // Root
+
+    pWriter->writeEndElement(); // XMLRepresentation
+
+    pWriter->writeEndDocument();
+}
+
+unsigned int GLC_WorldTo3dxml::representationIdCount(const GLC_3DRep* pRep)
+{
+    // The root and the meshes
+    unsigned int subject= 1;
+    const int bodyCount= pRep->numberOfBody();
+    for (int i= 0; i < bodyCount; ++i)
+    {
+        if (nullptr != dynamic_cast<GLC_Mesh*>(pRep->geomAt(i))) ++subject;
+    }
+    return subject;
+}
+
+void GLC_WorldTo3dxml::updateProgress(int currentRepIndex, int size, int* pPreviousQuantumValue)
+{
+    const int currentQuantumValue= static_cast<int>((static_cast<double>(currentRepIndex) / size) * 100);
+    if (currentQuantumValue > *pPreviousQuantumValue)
+    {
+        emit currentQuantum(currentQuantumValue);
+    }
+    *pPreviousQuantumValue= currentQuantumValue;
+    if (!m_IsThreaded)
+    {
+        QCoreApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
     }
 }
 
@@ -656,18 +837,59 @@ QString GLC_WorldTo3dxml::representationFileName(const GLC_3DRep* pRep)
 	return xmlFileName(fileName);
 }
 
-void GLC_WorldTo3dxml::writeGeometry(const GLC_Mesh* pMesh)
+void GLC_WorldTo3dxml::writeGeometries(GLC_BufferedXmlWriter* pWriter, const GLC_3DRep* pRep, unsigned int firstId, bool parallel) const
+{
+	// Rep ids are given in the order of the bodies
+	QList<QPair<const GLC_Mesh*, unsigned int> > meshAndIds;
+	unsigned int id= firstId;
+	const int bodyCount= pRep->numberOfBody();
+	for (int i= 0; i < bodyCount; ++i)
+	{
+		const GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(pRep->geomAt(i));
+		if (NULL != pMesh)
+		{
+			meshAndIds.append(qMakePair(pMesh, id++));
+		}
+	}
+
+	if (parallel && (meshAndIds.size() > 1))
+	{
+		const int indentationLevel= pWriter->indentationLevel();
+		const bool autoFormatting= pWriter->autoFormatting();
+		const QList<QByteArray> fragments(QtConcurrent::blockingMapped<QList<QByteArray> >(meshAndIds, [this, indentationLevel, autoFormatting](const QPair<const GLC_Mesh*, unsigned int>& meshAndId)
+		{
+			GLC_BufferedXmlWriter writer(indentationLevel);
+			writer.setAutoFormatting(autoFormatting);
+			writeGeometry(&writer, meshAndId.first, meshAndId.second);
+			return writer.buffer();
+		}));
+		for (const QByteArray& fragment : fragments)
+		{
+			pWriter->writeFragment(fragment);
+		}
+	}
+	else
+	{
+		const int count= meshAndIds.size();
+		for (int i= 0; i < count; ++i)
+		{
+			writeGeometry(pWriter, meshAndIds.at(i).first, meshAndIds.at(i).second);
+		}
+	}
+}
+
+void GLC_WorldTo3dxml::writeGeometry(GLC_BufferedXmlWriter* pWriter, const GLC_Mesh* pMesh, unsigned int id) const
 {
 	// Get the list of material id
 	QList<GLC_uint> materialList= pMesh->materialIds();
 	const int materialCount= materialList.size();
 
-	m_pOutStream->writeStartElement("Rep");
-	m_pOutStream->writeAttribute("xsi:type", "PolygonalRepType");
-	m_pOutStream->writeAttribute("id", QString::number(++m_CurrentId));
+	pWriter->writeStartElement("Rep");
+	pWriter->writeAttribute("xsi:type", "PolygonalRepType");
+	pWriter->writeAttribute("id", QString::number(id));
 	const double masterAccuracy= pMesh->getLodAccuracy(0);
-	m_pOutStream->writeAttribute("accuracy", QString::number(masterAccuracy));
-	m_pOutStream->writeAttribute("solid", "1");
+	pWriter->writeAttribute("accuracy", QString::number(masterAccuracy));
+	pWriter->writeAttribute("solid", "1");
 	const int lodCount= pMesh->lodCount();
 	if (lodCount > 1)
 	{
@@ -675,241 +897,168 @@ void GLC_WorldTo3dxml::writeGeometry(const GLC_Mesh* pMesh)
 		for (int i= 1; i < lodCount; ++i)
 		{
 			const double lodAccuracy= pMesh->getLodAccuracy(i);
-			m_pOutStream->writeStartElement("PolygonalLOD");
-			m_pOutStream->writeAttribute("accuracy", QString::number(lodAccuracy));
-			m_pOutStream->writeStartElement("Faces");
+			pWriter->writeStartElement("PolygonalLOD");
+			pWriter->writeAttribute("accuracy", QString::number(lodAccuracy));
+			pWriter->writeStartElement("Faces");
 			for (int matIndex= 0; matIndex < materialCount; ++matIndex)
 			{
 				const GLC_uint materialId= materialList.at(matIndex);
 				if (pMesh->lodContainsMaterial(i, materialId))
 				{
-					writeGeometryFace(pMesh, i, materialId);
+					writeGeometryFace(pWriter, pMesh, i, materialId);
 				}
 			}
-			m_pOutStream->writeEndElement(); // Faces
-			m_pOutStream->writeEndElement(); // PolygonalLOD
+			pWriter->writeEndElement(); // Faces
+			pWriter->writeEndElement(); // PolygonalLOD
 		}
 	}
 
 	// Master LOD
-	m_pOutStream->writeStartElement("Faces");
+	pWriter->writeStartElement("Faces");
 	for (int matIndex= 0; matIndex < materialCount; ++matIndex)
 	{
 		const GLC_uint materialId= materialList.at(matIndex);
 		if (pMesh->lodContainsMaterial(0, materialId))
 		{
-			writeGeometryFace(pMesh, 0, materialId);
+			writeGeometryFace(pWriter, pMesh, 0, materialId);
 		}
 	}
-	m_pOutStream->writeEndElement(); // Faces
+	pWriter->writeEndElement(); // Faces
 	if (!pMesh->wireDataIsEmpty())
 	{
-		writeEdges(pMesh);
+		writeEdges(pWriter, pMesh);
 	}
 
 	// Save Bulk data
-	m_pOutStream->writeStartElement("VertexBuffer");
-	{
-		// Get positions
-        const GLfloatVector& positionVector= pMesh->positionVector();
-		QString positions;
-		const int size= positionVector.size();
-		for (int i= 0; i < size; i+=3)
-		{
-			positions.append(QString::number(positionVector.at(i)));
-			positions.append(' ');
-			positions.append(QString::number(positionVector.at(i + 1)));
-			positions.append(' ');
-			positions.append(QString::number(positionVector.at(i + 2)));
-			positions.append(", ");
-		}
-		positions.remove(positions.size() - 2, 2);
-		m_pOutStream->writeTextElement("Positions", positions);
-	}
-	{
-		// Get normals
-		GLfloatVector normalVector= pMesh->normalVector();
-		QString normals;
-		const int size= normalVector.size();
-		for (int i= 0; i < size; i+=3)
-		{
-			normals.append(QString::number(normalVector.at(i)));
-			normals.append(' ');
-			normals.append(QString::number(normalVector.at(i + 1)));
-			normals.append(' ');
-			normals.append(QString::number(normalVector.at(i + 2)));
-			normals.append(", ");
-		}
-		normals.remove(normals.size() - 2, 2);
-		m_pOutStream->writeTextElement("Normals", normals);
-	}
-	{
-		// Get texture coordinates
-		GLfloatVector texelVector= pMesh->texelVector();
-		if (!texelVector.isEmpty())
-		{
-			QString texels;
-			const int size= texelVector.size();
-			for (int i= 0; i < size; i+=2)
-			{
-				texels.append(QString::number(texelVector.at(i)));
-				texels.append(' ');
-				texels.append(QString::number(texelVector.at(i + 1)));
-				texels.append(", ");
-			}
-			texels.remove(texels.size() - 2, 2);
+	pWriter->writeStartElement("VertexBuffer");
 
-			m_pOutStream->writeStartElement("TextureCoordinates");
-			m_pOutStream->writeAttribute("dimension", "2D");
-			m_pOutStream->writeAttribute("channel", "0");
-			m_pOutStream->writeCharacters(texels);
-			m_pOutStream->writeEndElement(); // TexturesCoordinates
-		}
-	}
+	// Positions and normals are written as "x y z, x y z"
+	pWriter->writeStartElement("Positions");
+	pWriter->writeFloats(pMesh->positionVector(), 3, ", ");
+	pWriter->writeEndElement(); // Positions
 
+	pWriter->writeStartElement("Normals");
+	pWriter->writeFloats(pMesh->normalVector(), 3, ", ");
+	pWriter->writeEndElement(); // Normals
 
-	m_pOutStream->writeEndElement(); // VertexBuffer
-	m_pOutStream->writeEndElement(); // Rep
+	// Get texture coordinates
+	const GLfloatVector& texelVector= pMesh->texelVector();
+	if (!texelVector.isEmpty())
+	{
+		pWriter->writeStartElement("TextureCoordinates");
+		pWriter->writeAttribute("dimension", "2D");
+		pWriter->writeAttribute("channel", "0");
+		pWriter->writeFloats(texelVector, 2, ", ");
+		pWriter->writeEndElement(); // TexturesCoordinates
+	}
+
+	pWriter->writeEndElement(); // VertexBuffer
+	pWriter->writeEndElement(); // Rep
 
 }
-void GLC_WorldTo3dxml::writeGeometryFace(const GLC_Mesh* pMesh, int lod, GLC_uint materialId)
+void GLC_WorldTo3dxml::writeGeometryFace(GLC_BufferedXmlWriter* pWriter, const GLC_Mesh* pMesh, int lod, GLC_uint materialId) const
 {
-	m_pOutStream->writeStartElement("Face");
+	pWriter->writeStartElement("Face");
 	if (pMesh->containsTriangles(lod, materialId))
 	{
-		QVector<GLuint> triangleIndex= pMesh->getTrianglesIndex(lod, materialId);
-		QString indexString;
-		const int indexSize= triangleIndex.size();
-		for (int index= 0; index < indexSize; ++index)
-		{
-			indexString.append(QString::number(triangleIndex.at(index)));
-			indexString.append(' ');
-		}
-		indexString.remove(indexString.size() - 1, 1);
-		m_pOutStream->writeAttribute("triangles", indexString);
+		pWriter->writeStartAttribute("triangles");
+		pWriter->writeIndexes(pMesh->getTrianglesIndex(lod, materialId));
+		pWriter->writeEndAttribute();
 	}
 	if (pMesh->containsStrips(lod, materialId))
 	{
-		QList<QVector<GLuint> > stripsIndex= pMesh->getStripsIndex(lod, materialId);
-		QString indexStrips;
+		// Strips are separated by a comma
+		const QList<QVector<GLuint> > stripsIndex= pMesh->getStripsIndex(lod, materialId);
+		pWriter->writeStartAttribute("strips");
 		const int stripCount= stripsIndex.size();
 		for (int stripIndex= 0; stripIndex < stripCount; ++stripIndex)
 		{
-			QVector<GLuint> currentStripIndex= stripsIndex.at(stripIndex);
-			QString currentIndex;
-			const int indexSize= currentStripIndex.size();
-			for (int index= 0; index < indexSize; ++index)
-			{
-				currentIndex.append(QString::number(currentStripIndex.at(index)));
-				currentIndex.append(' ');
-			}
-			currentIndex.remove(currentIndex.size() - 1, 1);
-			indexStrips.append(currentIndex);
-			indexStrips.append(',');
+			if (stripIndex > 0) pWriter->writeRaw(",");
+			pWriter->writeIndexes(stripsIndex.at(stripIndex));
 		}
-		indexStrips.remove(indexStrips.size() - 1, 1);
-		m_pOutStream->writeAttribute("strips", indexStrips);
+		pWriter->writeEndAttribute();
 	}
 	if (pMesh->containsFans(lod, materialId))
 	{
-		QList<QVector<GLuint> > fansIndex= pMesh->getFansIndex(lod, materialId);
-		QString indexFans;
+		// Fans are separated by a comma
+		const QList<QVector<GLuint> > fansIndex= pMesh->getFansIndex(lod, materialId);
+		pWriter->writeStartAttribute("fans");
 		const int fanCount= fansIndex.size();
 		for (int fanIndex= 0; fanIndex < fanCount; ++fanIndex)
 		{
-			QVector<GLuint> currentFanIndex= fansIndex.at(fanIndex);
-			QString currentIndex;
-			const int indexSize= currentFanIndex.size();
-			for (int index= 0; index < indexSize; ++index)
-			{
-				currentIndex.append(QString::number(currentFanIndex.at(index)));
-				currentIndex.append(' ');
-			}
-			currentIndex.remove(currentIndex.size() - 1, 1);
-			indexFans.append(currentIndex);
-			indexFans.append(',');
+			if (fanIndex > 0) pWriter->writeRaw(",");
+			pWriter->writeIndexes(fansIndex.at(fanIndex));
 		}
-		indexFans.remove(indexFans.size() - 1, 1);
-		m_pOutStream->writeAttribute("fans", indexFans);
+		pWriter->writeEndAttribute();
 	}
 
-	writeSurfaceAttributes(pMesh->material(materialId));
+	writeSurfaceAttributes(pWriter, pMesh->material(materialId));
 
-	m_pOutStream->writeEndElement(); // Face
+	pWriter->writeEndElement(); // Face
 
 }
 
-void GLC_WorldTo3dxml::writeSurfaceAttributes(const GLC_Material* pMaterial)
+void GLC_WorldTo3dxml::writeSurfaceAttributes(GLC_BufferedXmlWriter* pWriter, const GLC_Material* pMaterial) const
 {
 	QColor diffuseColor= pMaterial->diffuseColor();
-	m_pOutStream->writeStartElement("SurfaceAttributes");
+	pWriter->writeStartElement("SurfaceAttributes");
 	if (m_ExportMaterial)
 	{
 		const QString material3dxmlId=(QString::number(m_MaterialIdToMaterialId.value(pMaterial->id())));
-		m_pOutStream->writeStartElement("MaterialApplication");
-			m_pOutStream->writeAttribute("xsi:type", "MaterialApplicationType");
-			m_pOutStream->writeAttribute("mappingChannel", "0");
-			m_pOutStream->writeStartElement("MaterialId");
-				m_pOutStream->writeAttribute("id", "urn:3DXML:CATMaterialRef.3dxml#" + material3dxmlId);
-			m_pOutStream->writeEndElement(); // MaterialId
-		m_pOutStream->writeEndElement(); // MaterialApplication
+		pWriter->writeStartElement("MaterialApplication");
+			pWriter->writeAttribute("xsi:type", "MaterialApplicationType");
+			pWriter->writeAttribute("mappingChannel", "0");
+			pWriter->writeStartElement("MaterialId");
+				pWriter->writeAttribute("id", "urn:3DXML:CATMaterialRef.3dxml#" + material3dxmlId);
+			pWriter->writeEndElement(); // MaterialId
+		pWriter->writeEndElement(); // MaterialApplication
 	}
 	else
 	{
-		m_pOutStream->writeStartElement("Color");
-			m_pOutStream->writeAttribute("xsi:type", "RGBAColorType");
-			m_pOutStream->writeAttribute("red", QString::number(diffuseColor.redF()));
-			m_pOutStream->writeAttribute("green", QString::number(diffuseColor.greenF()));
-			m_pOutStream->writeAttribute("blue", QString::number(diffuseColor.blueF()));
-			m_pOutStream->writeAttribute("alpha", QString::number(diffuseColor.alphaF()));
-		m_pOutStream->writeEndElement(); // Color
+		pWriter->writeStartElement("Color");
+			pWriter->writeAttribute("xsi:type", "RGBAColorType");
+			pWriter->writeAttribute("red", QString::number(diffuseColor.redF()));
+			pWriter->writeAttribute("green", QString::number(diffuseColor.greenF()));
+			pWriter->writeAttribute("blue", QString::number(diffuseColor.blueF()));
+			pWriter->writeAttribute("alpha", QString::number(diffuseColor.alphaF()));
+		pWriter->writeEndElement(); // Color
 	}
-	m_pOutStream->writeEndElement(); // SurfaceAttributes
+	pWriter->writeEndElement(); // SurfaceAttributes
 }
 
-void GLC_WorldTo3dxml::writeEdges(const GLC_Mesh* pMesh)
+void GLC_WorldTo3dxml::writeEdges(GLC_BufferedXmlWriter* pWriter, const GLC_Mesh* pMesh) const
 {
-	m_pOutStream->writeStartElement("Edges");
-	writeLineAttributes(pMesh->wireColor());
+	pWriter->writeStartElement("Edges");
+	writeLineAttributes(pWriter, pMesh->wireColor());
 
-	GLfloatVector positionVector= pMesh->wirePositionVector();
+	const GLfloatVector positionVector(pMesh->wirePositionVector());
 	const int polylineCount= pMesh->wirePolylineCount();
 	for (int i= 0; i < polylineCount; ++i)
 	{
-		m_pOutStream->writeStartElement("Polyline");
-		QString polylinePosition;
+		pWriter->writeStartElement("Polyline");
 		const GLuint offset= pMesh->wirePolylineOffset(i);
 		const GLsizei size= pMesh->wirePolylineSize(i);
-		for (GLsizei index= 0; index < size; ++index)
-		{
-			const int startIndex= 3 * (offset + index);
-			polylinePosition.append(QString::number(positionVector.at(startIndex)));
-			polylinePosition.append(' ');
-			polylinePosition.append(QString::number(positionVector.at(startIndex + 1)));
-			polylinePosition.append(' ');
-			polylinePosition.append(QString::number(positionVector.at(startIndex + 2)));
-			polylinePosition.append(',');
-		}
-		polylinePosition.remove(polylinePosition.size() - 1, 1);
-		m_pOutStream->writeAttribute("vertices", polylinePosition);
-		m_pOutStream->writeEndElement(); // Polyline
+		pWriter->writeStartAttribute("vertices");
+		pWriter->writeFloats(positionVector.constData() + 3 * offset, 3 * size, 3, ",");
+		pWriter->writeEndAttribute();
+		pWriter->writeEndElement(); // Polyline
 	}
-	m_pOutStream->writeEndElement(); // Edges
+	pWriter->writeEndElement(); // Edges
 }
 
-void GLC_WorldTo3dxml::writeLineAttributes(const QColor& color)
+void GLC_WorldTo3dxml::writeLineAttributes(GLC_BufferedXmlWriter* pWriter, const QColor& color) const
 {
-	m_pOutStream->writeStartElement("LineAttributes");
-	m_pOutStream->writeAttribute("lineType", "SOLID");
-	m_pOutStream->writeAttribute("thickness", "1");
-		m_pOutStream->writeStartElement("Color");
-			m_pOutStream->writeAttribute("xsi:type", "RGBAColorType");
-			m_pOutStream->writeAttribute("red", QString::number(color.redF()));
-			m_pOutStream->writeAttribute("green", QString::number(color.greenF()));
-			m_pOutStream->writeAttribute("blue", QString::number(color.blueF()));
-			m_pOutStream->writeAttribute("alpha", QString::number(color.alphaF()));
-		m_pOutStream->writeEndElement(); // Color
-	m_pOutStream->writeEndElement(); // LineAttributes
+	pWriter->writeStartElement("LineAttributes");
+	pWriter->writeAttribute("lineType", "SOLID");
+	pWriter->writeAttribute("thickness", "1");
+		pWriter->writeStartElement("Color");
+			pWriter->writeAttribute("xsi:type", "RGBAColorType");
+			pWriter->writeAttribute("red", QString::number(color.redF()));
+			pWriter->writeAttribute("green", QString::number(color.greenF()));
+			pWriter->writeAttribute("blue", QString::number(color.blueF()));
+			pWriter->writeAttribute("alpha", QString::number(color.alphaF()));
+		pWriter->writeEndElement(); // Color
+	pWriter->writeEndElement(); // LineAttributes
 }
 
 void GLC_WorldTo3dxml::writeMaterial(const GLC_Material* pMaterial)
@@ -1282,7 +1431,7 @@ void GLC_WorldTo3dxml::addImageTextureTo3dxml(const QImage& image, const QString
 		}
 		QuaZipNewInfo quazipNewInfo(fileName);
 		m_pCurrentZipFile= new QuaZipFile(m_p3dxmlArchive);
-		success= m_pCurrentZipFile->open(QIODevice::WriteOnly, quazipNewInfo);
+		success= m_pCurrentZipFile->open(QIODevice::WriteOnly, quazipNewInfo, NULL, 0, Z_DEFLATED, m_BinaryCompressionLevel);
 		if (success)
 		{
 			image.save(m_pCurrentZipFile, QFileInfo(fileName).suffix().toLatin1().constData());
@@ -1444,7 +1593,7 @@ void GLC_WorldTo3dxml::writeOccurrenceDefaultViewProperty(const GLC_StructOccurr
 	m_pOutStream->writeEndElement(); // DefaultViewProperty
 }
 
-bool GLC_WorldTo3dxml::continu()
+bool GLC_WorldTo3dxml::continu() const
 {
 	bool continuValue= true;
 	if (NULL != m_pReadWriteLock)
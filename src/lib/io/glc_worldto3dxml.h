@@ -24,9 +24,9 @@
 #ifndef GLC_WORLDTO3DXML_H_
 #define GLC_WORLDTO3DXML_H_
 #include <QObject>
-#include <QXmlStreamWriter>
 
 #include "../sceneGraph/glc_world.h"
+#include "glc_bufferedxmlwriter.h"
 #include "../glc_config.h"
 #include <QReadWriteLock>
 
@@ -83,6 +83,34 @@ public:
 
 	//! set interrupt flag adress
 	void setInterupt(QReadWriteLock* pReadWriteLock, bool* pInterupt);
+
+	//! Set the usage of threads to write the representations and their meshes, the output is the same
+	/*! Representation entries are serialized and compressed by the global thread pool
+	 *  and appended to the archive in the order of their ids.*/
+	void setParallelExport(bool parallel)
+	{m_ParallelExport= parallel;}
+
+	//! Set the zlib compression level of XML entries, -1 is the zlib default
+	void setXmlCompressionLevel(int level)
+	{m_XmlCompressionLevel= qBound(-1, level, 9);}
+
+	//! Set the zlib compression level of binary entries (native representations and images), -1 is the zlib default
+	void setBinaryCompressionLevel(int level)
+	{m_BinaryCompressionLevel= qBound(-1, level, 9);}
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+	//! Return the zlib compression level of XML entries
+	int xmlCompressionLevel() const
+	{return m_XmlCompressionLevel;}
+
+	//! Return the zlib compression level of binary entries
+	int binaryCompressionLevel() const
+	{return m_BinaryCompressionLevel;}
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -90,6 +118,27 @@ public:
 //@{
 //////////////////////////////////////////////////////////////////////
 private:
+	//! A representation entry serialized in memory
+	struct PreparedEntry
+	{
+		//! The entry file name
+		QString m_FileName;
+
+		//! The entry data, deflated if the export is compressed
+		QByteArray m_Data;
+
+		//! The crc 32 of the uncompressed data
+		quint32 m_Crc;
+
+		//! The size of the uncompressed data
+		quint64 m_UncompressedSize;
+
+		//! The compression level of the entry
+		int m_Level;
+
+		//! True if the entry has been prepared
+		bool m_IsValid;
+	};
 
 	//! Write 3DXML Header
 	void writeHeader();
@@ -124,23 +173,47 @@ private:
 	//! Write the given 3DRep to 3DXML 3DRep
 	void write3DRep(const GLC_3DRep* pRep, const QString& fileName);
 
+	//! Write the representations of the structure in the order of their ids
+	void exportRepresentations();
+
+	//! Write the representations of the structure in parallel
+	void exportRepresentationsInParallel(const QList<const GLC_3DRep*>& repList);
+
+	//! Serialize, and compress if needed, the given 3DRep in memory with the given first id
+	PreparedEntry prepareEntry(const GLC_3DRep* pRep, const QString& fileName, unsigned int firstId) const;
+
+	//! Append the given prepared entry to the 3DXML archive or folder
+	void appendPreparedEntry(const PreparedEntry& entry);
+
+	//! Write the XML representation of the given 3DRep with the given writer and first id
+	void writeXmlRepresentation(GLC_BufferedXmlWriter* pWriter, const GLC_3DRep* pRep, unsigned int firstId, bool parallel) const;
+
+	//! Return the number of ids used by the XML representation of the given 3DRep
+	static unsigned int representationIdCount(const GLC_3DRep* pRep);
+
+	//! Emit the progress of the export of the representations
+	void updateProgress(int currentRepIndex, int size, int* pPreviousQuantumValue);
+
 	//! Return the file name of the given 3DRep
 	QString representationFileName(const GLC_3DRep* pRep);
 
-	//! Write the given mesh to 3DXML 3DRep
-	void writeGeometry(const GLC_Mesh* pMesh);
+	//! Write the meshes of the given 3DRep with the given writer and first id
+	void writeGeometries(GLC_BufferedXmlWriter* pWriter, const GLC_3DRep* pRep, unsigned int firstId, bool parallel) const;
+
+	//! Write the given mesh to 3DXML 3DRep with the given writer and id
+	void writeGeometry(GLC_BufferedXmlWriter* pWriter, const GLC_Mesh* pMesh, unsigned int id) const;
 
 	//! Write the geometry face from the given lod and material
-	void writeGeometryFace(const GLC_Mesh* pMesh, int lod, GLC_uint materialId);
+	void writeGeometryFace(GLC_BufferedXmlWriter* pWriter, const GLC_Mesh* pMesh, int lod, GLC_uint materialId) const;
 
 	//! Write surface attributes
-	void writeSurfaceAttributes(const GLC_Material* pMaterial);
+	void writeSurfaceAttributes(GLC_BufferedXmlWriter* pWriter, const GLC_Material* pMaterial) const;
 
 	//! Write edges
-	void writeEdges(const GLC_Mesh* pMesh);
+	void writeEdges(GLC_BufferedXmlWriter* pWriter, const GLC_Mesh* pMesh) const;
 
 	//! Write lines attributes
-	void writeLineAttributes(const QColor& color);
+	void writeLineAttributes(GLC_BufferedXmlWriter* pWriter, const QColor& color) const;
 
 	//! Write Material
 	void writeMaterial(const GLC_Material* pMaterial);
@@ -184,7 +257,7 @@ private:
 	void writeOccurrenceDefaultViewProperty(const GLC_StructOccurrence* pOccurrence);
 
 	//! return true if export must continu
-	bool continu();
+	bool continu() const;
 
 	//! Return the simplified name of the given name
 	QString symplifyName(QString name);
@@ -214,7 +287,7 @@ private:
 	QString m_FileName;
 
 	//! The Stream writer
-	QXmlStreamWriter* m_pOutStream;
+	GLC_BufferedXmlWriter* m_pOutStream;
 
 	//! QString the 3DXML Generator
 	QString m_Generator;
@@ -282,6 +355,15 @@ private:
 	//! Flag to know if export is threaded (the default)
 	bool m_IsThreaded;
 
+	//! Flag to know if representations and their meshes are written by several threads
+	bool m_ParallelExport;
+
+	//! The compression level of XML entries
+	int m_XmlCompressionLevel;
+
+	//! The compression level of binary entries
+	int m_BinaryCompressionLevel;
+
 };
 
 #endif /* GLC_WORLDTO3DXML_H_ */
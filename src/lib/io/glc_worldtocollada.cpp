@@ -11,6 +11,8 @@
 #include <QFile>
 #include <QDateTime>
 #include <QUrl>
+#include <QThread>
+#include <QtConcurrent>
 
 #include "../shading/glc_material.h"
 #include "../sceneGraph/glc_structreference.h"
@@ -40,6 +42,7 @@ GLC_WorldToCollada::GLC_WorldToCollada(const GLC_World& world)
     , m_BasePath()
     , m_BasePathPrefix()
     , m_UrlEncoding(false)
+    , m_ParallelExport(true)
 {
 
 }
@@ -88,7 +91,8 @@ bool GLC_WorldToCollada::exportToCollada(const QString& absoluteFileName)
 
         m_Writer.writeEndElement(); // Collada top element
         m_Writer.writeEndDocument();
-        subject= true;
+        subject= !m_Writer.hasError();
+        m_Writer.setDevice(nullptr);
     }
 
     return subject;
@@ -132,7 +136,8 @@ bool GLC_WorldToCollada::exportToCollada(QIODevice* pIoDevice, const QString& ba
 
         m_Writer.writeEndElement(); // Collada top element
         m_Writer.writeEndDocument();
-        subject= true;
+        subject= !m_Writer.hasError();
+        m_Writer.setDevice(nullptr);
     }
 
     return subject;
@@ -175,6 +180,7 @@ void GLC_WorldToCollada::writeInstanciateGeometries()
 {
     m_Writer.writeStartElement(ColladaElement::libraryGeometriesElement);
 
+    QList<GLC_Mesh*> meshes;
     const QList<GLC_StructReference*> referencies(m_World.references());
     for (GLC_StructReference* pRef : referencies)
     {
@@ -189,12 +195,13 @@ void GLC_WorldToCollada::writeInstanciateGeometries()
                     GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(pRep->geomAt(i));
                     if (nullptr != pMesh)
                     {
-                        writeMesh(pMesh);
+                        meshes.append(pMesh);
                     }
                 }
             }
         }
     }
+    writeMeshes(meshes);
 
     m_Writer.writeEndElement();
 }
@@ -203,10 +210,7 @@ void GLC_WorldToCollada::writeNotInstanciateGeometries()
 {
     m_Writer.writeStartElement(ColladaElement::libraryGeometriesElement);
 
-    for (GLC_Mesh* pMesh : std::as_const(m_CopiedMesh))
-    {
-        writeMesh(pMesh);
-    }
+    writeMeshes(m_CopiedMesh);
     m_Writer.writeEndElement();
 }
 
@@ -500,196 +504,226 @@ void GLC_WorldToCollada::writeColor(const QColor& color)
     m_Writer.writeTextElement(ColladaElement::colorElement, value);
 }
 
-void GLC_WorldToCollada::writeMesh(GLC_Mesh* pMesh)
+void GLC_WorldToCollada::writeMeshes(const QList<GLC_Mesh*>& meshes)
 {
-    if (!pMesh->isEmpty())
+    // Mesh ids are given in the order of the list
+    QList<QPair<GLC_Mesh*, QString> > meshAndIds;
+    for (GLC_Mesh* pMesh : meshes)
+    {
+        if (!pMesh->isEmpty())
+        {
+            const QString meshId(this->meshId());
+            m_MeshIdHash.insert(pMesh, meshId);
+            meshAndIds.append(qMakePair(pMesh, meshId));
+        }
+    }
+
+    const int count= meshAndIds.count();
+    if (m_ParallelExport && (count > 1))
+    {
+        // Meshes are written in fragments by batch to bound the memory used
+        const int indentationLevel= m_Writer.indentationLevel();
+        const bool autoFormatting= m_Writer.autoFormatting();
+        const int batchSize= QThread::idealThreadCount() * 4;
+        for (int first= 0; first < count; first+= batchSize)
+        {
+            const QList<QPair<GLC_Mesh*, QString> > batch(meshAndIds.mid(first, batchSize));
+            const QList<QByteArray> fragments(QtConcurrent::blockingMapped<QList<QByteArray> >(batch, [this, indentationLevel, autoFormatting](const QPair<GLC_Mesh*, QString>& meshAndId)
+            {
+                GLC_BufferedXmlWriter writer(indentationLevel);
+                writer.setAutoFormatting(autoFormatting);
+                writeMesh(&writer, meshAndId.first, meshAndId.second);
+                return writer.buffer();
+            }));
+            for (const QByteArray& fragment : fragments)
+            {
+                m_Writer.writeFragment(fragment);
+            }
+        }
+    }
+    else
     {
-        const QString meshId(this->meshId());
-        m_MeshIdHash.insert(pMesh, meshId);
-        m_Writer.writeStartElement(ColladaElement::geometryElement);
-        m_Writer.writeAttribute(ColladaElement::idAttribute, meshId);
-        m_Writer.writeAttribute(ColladaElement::nameAttribute, meshId);
-        m_Writer.writeStartElement(ColladaElement::meshElement);
-        writeMeshPosition(pMesh, meshId);
-        writeMeshNormal(pMesh, meshId);
-        writeMeshTexel(pMesh, meshId);
-        writeVertices(pMesh, meshId, pMesh->vertexCount());
-
-        m_Writer.writeEndElement(); // Mesh element
-
-        m_Writer.writeEndElement(); // Geometry element
+        for (const QPair<GLC_Mesh*, QString>& meshAndId : std::as_const(meshAndIds))
+        {
+            writeMesh(&m_Writer, meshAndId.first, meshAndId.second);
+        }
     }
 }
 
-void GLC_WorldToCollada::writeMeshPosition(GLC_Mesh* pMesh, const QString& meshId)
+void GLC_WorldToCollada::writeMesh(GLC_BufferedXmlWriter* pWriter, GLC_Mesh* pMesh, const QString& meshId) const
 {
-    m_Writer.writeStartElement(ColladaElement::sourceElement);
+    pWriter->writeStartElement(ColladaElement::geometryElement);
+    pWriter->writeAttribute(ColladaElement::idAttribute, meshId);
+    pWriter->writeAttribute(ColladaElement::nameAttribute, meshId);
+    pWriter->writeStartElement(ColladaElement::meshElement);
+    writeMeshPosition(pWriter, pMesh, meshId);
+    writeMeshNormal(pWriter, pMesh, meshId);
+    writeMeshTexel(pWriter, pMesh, meshId);
+    writeVertices(pWriter, pMesh, meshId, pMesh->vertexCount());
+
+    pWriter->writeEndElement(); // Mesh element
+
+    pWriter->writeEndElement(); // Geometry element
+}
+
+void GLC_WorldToCollada::writeMeshPosition(GLC_BufferedXmlWriter* pWriter, GLC_Mesh* pMesh, const QString& meshId) const
+{
+    pWriter->writeStartElement(ColladaElement::sourceElement);
     const QString sourceId(meshId + "-positions");
-    m_Writer.writeAttribute(ColladaElement::idAttribute, sourceId);
-    m_Writer.writeAttribute(ColladaElement::nameAttribute, sourceId);
+    pWriter->writeAttribute(ColladaElement::idAttribute, sourceId);
+    pWriter->writeAttribute(ColladaElement::nameAttribute, sourceId);
 
-    m_Writer.writeStartElement(ColladaElement::floatArrayElement);
-    GLfloatVector positionVector(pMesh->positionVector());
+    pWriter->writeStartElement(ColladaElement::floatArrayElement);
+    const GLfloatVector& positionVector= pMesh->positionVector();
+    GLfloatVector wirePositionVector;
     if (m_ExportMeshWire)
     {
-        positionVector= positionVector + pMesh->wirePositionVector();
+        wirePositionVector= pMesh->wirePositionVector();
     }
+    const int positionCount= positionVector.count() + wirePositionVector.count();
     const QString arrayId(sourceId + "-array");
-    m_Writer.writeAttribute(ColladaElement::idAttribute, arrayId);
-    m_Writer.writeAttribute(ColladaElement::countAttribute, QString::number(positionVector.count()));
+    pWriter->writeAttribute(ColladaElement::idAttribute, arrayId);
+    pWriter->writeAttribute(ColladaElement::countAttribute, QString::number(positionCount));
 
-    QString positions;
-    for (const GLfloat& value : std::as_const(positionVector))
+    pWriter->writeFloats(positionVector);
+    if (!wirePositionVector.isEmpty())
     {
-        positions.append(QString::number(value) + ' ');
+        if (!positionVector.isEmpty()) pWriter->writeRaw(" ");
+        pWriter->writeFloats(wirePositionVector);
     }
-    positions.resize(positions.size() - 1);
-    m_Writer.writeCharacters(positions);
-    m_Writer.writeEndElement(); // Float array
+    pWriter->writeEndElement(); // Float array
 
-    m_Writer.writeStartElement(ColladaElement::techniqueCommonElement);
-    m_Writer.writeStartElement(ColladaElement::accessorElement);
+    pWriter->writeStartElement(ColladaElement::techniqueCommonElement);
+    pWriter->writeStartElement(ColladaElement::accessorElement);
     const int stride= 3;
-    m_Writer.writeAttribute(ColladaElement::countAttribute, QString::number(positionVector.count() / stride));
-    m_Writer.writeAttribute(ColladaElement::sourceAttribute, '#' + arrayId);
-    m_Writer.writeAttribute(ColladaElement::strideAttribute, QString::number(stride));
+    pWriter->writeAttribute(ColladaElement::countAttribute, QString::number(positionCount / stride));
+    pWriter->writeAttribute(ColladaElement::sourceAttribute, '#' + arrayId);
+    pWriter->writeAttribute(ColladaElement::strideAttribute, QString::number(stride));
 
-    m_Writer.writeStartElement(ColladaElement::paramElement);
-    m_Writer.writeAttribute(ColladaElement::nameAttribute, "X");
-    m_Writer.writeAttribute(ColladaElement::typeAttribute, "float");
-    m_Writer.writeEndElement(); // paramElement
+    pWriter->writeStartElement(ColladaElement::paramElement);
+    pWriter->writeAttribute(ColladaElement::nameAttribute, "X");
+    pWriter->writeAttribute(ColladaElement::typeAttribute, "float");
+    pWriter->writeEndElement(); // paramElement
 
-    m_Writer.writeStartElement(ColladaElement::paramElement);
-    m_Writer.writeAttribute(ColladaElement::nameAttribute, "Y");
-    m_Writer.writeAttribute(ColladaElement::typeAttribute, "float");
-    m_Writer.writeEndElement(); // paramElement
+    pWriter->writeStartElement(ColladaElement::paramElement);
+    pWriter->writeAttribute(ColladaElement::nameAttribute, "Y");
+    pWriter->writeAttribute(ColladaElement::typeAttribute, "float");
+    pWriter->writeEndElement(); // paramElement
 
-    m_Writer.writeStartElement(ColladaElement::paramElement);
-    m_Writer.writeAttribute(ColladaElement::nameAttribute, "Z");
-    m_Writer.writeAttribute(ColladaElement::typeAttribute, "float");
-    m_Writer.writeEndElement(); // paramElement
+    pWriter->writeStartElement(ColladaElement::paramElement);
+    pWriter->writeAttribute(ColladaElement::nameAttribute, "Z");
+    pWriter->writeAttribute(ColladaElement::typeAttribute, "float");
+    pWriter->writeEndElement(); // paramElement
 
-    m_Writer.writeEndElement(); // Accessor
+    pWriter->writeEndElement(); // Accessor
 
-    m_Writer.writeEndElement(); // Technique common
+    pWriter->writeEndElement(); // Technique common
 
-    m_Writer.writeEndElement(); // source element
+    pWriter->writeEndElement(); // source element
 }
 
-void GLC_WorldToCollada::writeMeshNormal(GLC_Mesh* pMesh, const QString& meshId)
+void GLC_WorldToCollada::writeMeshNormal(GLC_BufferedXmlWriter* pWriter, GLC_Mesh* pMesh, const QString& meshId) const
 {
-    m_Writer.writeStartElement(ColladaElement::sourceElement);
+    pWriter->writeStartElement(ColladaElement::sourceElement);
     const QString sourceId(meshId + "-normals");
-    m_Writer.writeAttribute(ColladaElement::idAttribute, sourceId);
-    m_Writer.writeAttribute(ColladaElement::nameAttribute, sourceId);
+    pWriter->writeAttribute(ColladaElement::idAttribute, sourceId);
+    pWriter->writeAttribute(ColladaElement::nameAttribute, sourceId);
 
-    m_Writer.writeStartElement(ColladaElement::floatArrayElement);
-    GLfloatVector normalVector(pMesh->normalVector());
+    pWriter->writeStartElement(ColladaElement::floatArrayElement);
+    const GLfloatVector& normalVector= pMesh->normalVector();
 
     const QString arrayId(sourceId + "-array");
-    m_Writer.writeAttribute(ColladaElement::idAttribute, arrayId);
-    m_Writer.writeAttribute(ColladaElement::countAttribute, QString::number(normalVector.count()));
+    pWriter->writeAttribute(ColladaElement::idAttribute, arrayId);
+    pWriter->writeAttribute(ColladaElement::countAttribute, QString::number(normalVector.count()));
 
-    QString normals;
-    for (const GLfloat& value : normalVector)
-    {
-        normals.append(QString::number(value) + ' ');
-    }
-    normals.resize(normals.size() - 1);
-    m_Writer.writeCharacters(normals);
-    m_Writer.writeEndElement(); // Float array
+    pWriter->writeFloats(normalVector);
+    pWriter->writeEndElement(); // Float array
 
-    m_Writer.writeStartElement(ColladaElement::techniqueCommonElement);
-    m_Writer.writeStartElement(ColladaElement::accessorElement);
+    pWriter->writeStartElement(ColladaElement::techniqueCommonElement);
+    pWriter->writeStartElement(ColladaElement::accessorElement);
     const int stride= 3;
-    m_Writer.writeAttribute(ColladaElement::countAttribute, QString::number(normalVector.count() / stride));
-    m_Writer.writeAttribute(ColladaElement::sourceAttribute, '#' + arrayId);
-    m_Writer.writeAttribute(ColladaElement::strideAttribute, QString::number(stride));
+    pWriter->writeAttribute(ColladaElement::countAttribute, QString::number(normalVector.count() / stride));
+    pWriter->writeAttribute(ColladaElement::sourceAttribute, '#' + arrayId);
+    pWriter->writeAttribute(ColladaElement::strideAttribute, QString::number(stride));
 
-    m_Writer.writeStartElement(ColladaElement::paramElement);
-    m_Writer.writeAttribute(ColladaElement::nameAttribute, "X");
-    m_Writer.writeAttribute(ColladaElement::typeAttribute, "float");
-    m_Writer.writeEndElement(); // paramElement
+    pWriter->writeStartElement(ColladaElement::paramElement);
+    pWriter->writeAttribute(ColladaElement::nameAttribute, "X");
+    pWriter->writeAttribute(ColladaElement::typeAttribute, "float");
+    pWriter->writeEndElement(); // paramElement
 
-    m_Writer.writeStartElement(ColladaElement::paramElement);
-    m_Writer.writeAttribute(ColladaElement::nameAttribute, "Y");
-    m_Writer.writeAttribute(ColladaElement::typeAttribute, "float");
-    m_Writer.writeEndElement(); // paramElement
+    pWriter->writeStartElement(ColladaElement::paramElement);
+    pWriter->writeAttribute(ColladaElement::nameAttribute, "Y");
+    pWriter->writeAttribute(ColladaElement::typeAttribute, "float");
+    pWriter->writeEndElement(); // paramElement
 
-    m_Writer.writeStartElement(ColladaElement::paramElement);
-    m_Writer.writeAttribute(ColladaElement::nameAttribute, "Z");
-    m_Writer.writeAttribute(ColladaElement::typeAttribute, "float");
-    m_Writer.writeEndElement(); // paramElement
+    pWriter->writeStartElement(ColladaElement::paramElement);
+    pWriter->writeAttribute(ColladaElement::nameAttribute, "Z");
+    pWriter->writeAttribute(ColladaElement::typeAttribute, "float");
+    pWriter->writeEndElement(); // paramElement
 
-    m_Writer.writeEndElement(); // Accessor
+    pWriter->writeEndElement(); // Accessor
 
-    m_Writer.writeEndElement(); // Technique common
+    pWriter->writeEndElement(); // Technique common
 
-    m_Writer.writeEndElement(); // source element
+    pWriter->writeEndElement(); // source element
 }
 
-void GLC_WorldToCollada::writeMeshTexel(GLC_Mesh* pMesh, const QString& meshId)
+void GLC_WorldToCollada::writeMeshTexel(GLC_BufferedXmlWriter* pWriter, GLC_Mesh* pMesh, const QString& meshId) const
 {
-    GLfloatVector texelVector(pMesh->texelVector());
+    const GLfloatVector& texelVector= pMesh->texelVector();
     if (!texelVector.isEmpty())
     {
-        m_Writer.writeStartElement(ColladaElement::sourceElement);
+        pWriter->writeStartElement(ColladaElement::sourceElement);
         const QString sourceId(meshId + "-map");
-        m_Writer.writeAttribute(ColladaElement::idAttribute, sourceId);
-        m_Writer.writeAttribute(ColladaElement::nameAttribute, sourceId);
+        pWriter->writeAttribute(ColladaElement::idAttribute, sourceId);
+        pWriter->writeAttribute(ColladaElement::nameAttribute, sourceId);
 
-        m_Writer.writeStartElement(ColladaElement::floatArrayElement);
+        pWriter->writeStartElement(ColladaElement::floatArrayElement);
 
         const QString arrayId(sourceId + "-array");
-        m_Writer.writeAttribute(ColladaElement::idAttribute, arrayId);
-        m_Writer.writeAttribute(ColladaElement::countAttribute, QString::number(texelVector.count()));
+        pWriter->writeAttribute(ColladaElement::idAttribute, arrayId);
+        pWriter->writeAttribute(ColladaElement::countAttribute, QString::number(texelVector.count()));
 
-        QString texel;
-        for (const GLfloat& value : texelVector)
-        {
-            texel.append(QString::number(value) + ' ');
-        }
-        texel.resize(texel.size() - 1);
-        m_Writer.writeCharacters(texel);
-        m_Writer.writeEndElement(); // Float array
+        pWriter->writeFloats(texelVector);
+        pWriter->writeEndElement(); // Float array
 
-        m_Writer.writeStartElement(ColladaElement::techniqueCommonElement);
-        m_Writer.writeStartElement(ColladaElement::accessorElement);
+        pWriter->writeStartElement(ColladaElement::techniqueCommonElement);
+        pWriter->writeStartElement(ColladaElement::accessorElement);
         const int stride= 2;
-        m_Writer.writeAttribute(ColladaElement::countAttribute, QString::number(texelVector.count() / stride));
-        m_Writer.writeAttribute(ColladaElement::sourceAttribute, '#' + arrayId);
-        m_Writer.writeAttribute(ColladaElement::strideAttribute, QString::number(stride));
+        pWriter->writeAttribute(ColladaElement::countAttribute, QString::number(texelVector.count() / stride));
+        pWriter->writeAttribute(ColladaElement::sourceAttribute, '#' + arrayId);
+        pWriter->writeAttribute(ColladaElement::strideAttribute, QString::number(stride));
 
-        m_Writer.writeStartElement(ColladaElement::paramElement);
-        m_Writer.writeAttribute(ColladaElement::nameAttribute, "S");
-        m_Writer.writeAttribute(ColladaElement::typeAttribute, "float");
-        m_Writer.writeEndElement(); // paramElement
+        pWriter->writeStartElement(ColladaElement::paramElement);
+        pWriter->writeAttribute(ColladaElement::nameAttribute, "S");
+        pWriter->writeAttribute(ColladaElement::typeAttribute, "float");
+        pWriter->writeEndElement(); // paramElement
 
-        m_Writer.writeStartElement(ColladaElement::paramElement);
-        m_Writer.writeAttribute(ColladaElement::nameAttribute, "T");
-        m_Writer.writeAttribute(ColladaElement::typeAttribute, "float");
-        m_Writer.writeEndElement(); // paramElement
+        pWriter->writeStartElement(ColladaElement::paramElement);
+        pWriter->writeAttribute(ColladaElement::nameAttribute, "T");
+        pWriter->writeAttribute(ColladaElement::typeAttribute, "float");
+        pWriter->writeEndElement(); // paramElement
 
-        m_Writer.writeEndElement(); // Accessor
+        pWriter->writeEndElement(); // Accessor
 
-        m_Writer.writeEndElement(); // Technique common
+        pWriter->writeEndElement(); // Technique common
 
-        m_Writer.writeEndElement(); // source element
+        pWriter->writeEndElement(); // source element
     }
 }
 
-void GLC_WorldToCollada::writeVertices(GLC_Mesh* pMesh, const QString& meshId, unsigned int wireOffset)
+void GLC_WorldToCollada::writeVertices(GLC_BufferedXmlWriter* pWriter, GLC_Mesh* pMesh, const QString& meshId, unsigned int wireOffset) const
 {
-    m_Writer.writeStartElement(ColladaElement::verticesElement);
+    pWriter->writeStartElement(ColladaElement::verticesElement);
     const QString verticesId(meshId + "-vertices");
-    m_Writer.writeAttribute(ColladaElement::idAttribute, verticesId);
+    pWriter->writeAttribute(ColladaElement::idAttribute, verticesId);
     const QString positionId('#' + meshId + "-positions");
-    m_Writer.writeStartElement(ColladaElement::inputElement);
-    m_Writer.writeAttribute(ColladaElement::semanticAttribute, "POSITION");
-    m_Writer.writeAttribute(ColladaElement::sourceAttribute, positionId);
-    m_Writer.writeEndElement(); // input element
+    pWriter->writeStartElement(ColladaElement::inputElement);
+    pWriter->writeAttribute(ColladaElement::semanticAttribute, "POSITION");
+    pWriter->writeAttribute(ColladaElement::sourceAttribute, positionId);
+    pWriter->writeEndElement(); // input element
 
-    m_Writer.writeEndElement(); // vertices element
+    pWriter->writeEndElement(); // vertices element
     QSet<GLC_Material*> materialSet(pMesh->materialSet());
     QSet<GLC_Material*>::const_iterator iMat= materialSet.constBegin();
     while (iMat != materialSet.constEnd())
@@ -698,62 +732,57 @@ void GLC_WorldToCollada::writeVertices(GLC_Mesh* pMesh, const QString& meshId, u
         if (m_MaterialUidToStringIdHash.contains(pMat->id()))
         {
             const IndexList index(pMesh->getEquivalentTrianglesStripsFansIndex(0, pMat->id()));
-            writeMeshTriangle(index, meshId, pMat);
+            writeMeshTriangle(pWriter, index, meshId, pMat);
         }
         ++iMat;
     }
 
     if (m_ExportMeshWire)
     {
-        writeLineStrips(pMesh, meshId, wireOffset);
+        writeLineStrips(pWriter, pMesh, meshId, wireOffset);
     }
 }
 
-void GLC_WorldToCollada::writeMeshTriangle(const IndexList& index, const QString& meshId, GLC_Material* pMat)
+void GLC_WorldToCollada::writeMeshTriangle(GLC_BufferedXmlWriter* pWriter, const IndexList& index, const QString& meshId, GLC_Material* pMat) const
 {
     if (!index.isEmpty())
     {
         // GLC_lib index are not interleaved (VBO index is used)
         const QString materialId(m_MaterialUidToStringIdHash.value(pMat->id()) + "SG");
-        m_Writer.writeStartElement(ColladaElement::trianglesElement);
-        m_Writer.writeAttribute(ColladaElement::countAttribute, QString::number(index.count() / 3));
-        m_Writer.writeAttribute(ColladaElement::materialAttribute, materialId);
-
-        m_Writer.writeStartElement(ColladaElement::inputElement);
-        m_Writer.writeAttribute(ColladaElement::offsetAttribute, "0");
-        m_Writer.writeAttribute(ColladaElement::semanticAttribute, "VERTEX");
-        m_Writer.writeAttribute(ColladaElement::sourceAttribute, QString('#' + meshId + "-vertices"));
-        m_Writer.writeEndElement(); // input element
-
-        m_Writer.writeStartElement(ColladaElement::inputElement);
-        m_Writer.writeAttribute(ColladaElement::offsetAttribute, "0");
-        m_Writer.writeAttribute(ColladaElement::semanticAttribute, "NORMAL");
-        m_Writer.writeAttribute(ColladaElement::sourceAttribute, QString('#' + meshId + "-normals"));
-        m_Writer.writeEndElement(); // input element
+        pWriter->writeStartElement(ColladaElement::trianglesElement);
+        pWriter->writeAttribute(ColladaElement::countAttribute, QString::number(index.count() / 3));
+        pWriter->writeAttribute(ColladaElement::materialAttribute, materialId);
+
+        pWriter->writeStartElement(ColladaElement::inputElement);
+        pWriter->writeAttribute(ColladaElement::offsetAttribute, "0");
+        pWriter->writeAttribute(ColladaElement::semanticAttribute, "VERTEX");
+        pWriter->writeAttribute(ColladaElement::sourceAttribute, QString('#' + meshId + "-vertices"));
+        pWriter->writeEndElement(); // input element
+
+        pWriter->writeStartElement(ColladaElement::inputElement);
+        pWriter->writeAttribute(ColladaElement::offsetAttribute, "0");
+        pWriter->writeAttribute(ColladaElement::semanticAttribute, "NORMAL");
+        pWriter->writeAttribute(ColladaElement::sourceAttribute, QString('#' + meshId + "-normals"));
+        pWriter->writeEndElement(); // input element
 
         if (pMat->hasTexture())
         {
-            m_Writer.writeStartElement(ColladaElement::inputElement);
-            m_Writer.writeAttribute(ColladaElement::offsetAttribute, "0");
-            m_Writer.writeAttribute(ColladaElement::semanticAttribute, "TEXCOORD");
-            m_Writer.writeAttribute(ColladaElement::sourceAttribute, QString('#' + meshId + "-map"));
-            m_Writer.writeAttribute(ColladaElement::setAttribute, "0");
-            m_Writer.writeEndElement(); // input element
+            pWriter->writeStartElement(ColladaElement::inputElement);
+            pWriter->writeAttribute(ColladaElement::offsetAttribute, "0");
+            pWriter->writeAttribute(ColladaElement::semanticAttribute, "TEXCOORD");
+            pWriter->writeAttribute(ColladaElement::sourceAttribute, QString('#' + meshId + "-map"));
+            pWriter->writeAttribute(ColladaElement::setAttribute, "0");
+            pWriter->writeEndElement(); // input element
         }
 
-        QString indexString;
-        for (GLuint currentIndex : index)
-        {
-            const QString current(QString::number(currentIndex));
-            indexString.append(current + ' ');
-        }
-        indexString.resize(indexString.size() - 1);
-        m_Writer.writeTextElement(ColladaElement::primitiveElement, indexString);
-        m_Writer.writeEndElement(); // triangles element
+        pWriter->writeStartElement(ColladaElement::primitiveElement);
+        pWriter->writeIndexes(index.constData(), index.count());
+        pWriter->writeEndElement(); // primitive element
+        pWriter->writeEndElement(); // triangles element
     }
 }
 
-void GLC_WorldToCollada::writeLineStrips(const GLC_Mesh* pMesh, const QString& meshId, unsigned int offset)
+void GLC_WorldToCollada::writeLineStrips(GLC_BufferedXmlWriter* pWriter, const GLC_Mesh* pMesh, const QString& meshId, unsigned int offset) const
 {
     if (!pMesh->wireDataIsEmpty())
     {
@@ -762,25 +791,25 @@ void GLC_WorldToCollada::writeLineStrips(const GLC_Mesh* pMesh, const QString& m
         for (int i= 0; i < count; ++i)
         {
             const int currentSize= wireData.verticeGroupSize(i);
-            m_Writer.writeStartElement(ColladaElement::linestripsElement);
-            m_Writer.writeAttribute(ColladaElement::countAttribute, QString::number(currentSize));
+            pWriter->writeStartElement(ColladaElement::linestripsElement);
+            pWriter->writeAttribute(ColladaElement::countAttribute, QString::number(currentSize));
 
-            m_Writer.writeStartElement(ColladaElement::inputElement);
-            m_Writer.writeAttribute(ColladaElement::offsetAttribute, "0");
-            m_Writer.writeAttribute(ColladaElement::semanticAttribute, "VERTEX");
-            m_Writer.writeAttribute(ColladaElement::sourceAttribute, QString('#' + meshId + "-vertices"));
-            m_Writer.writeEndElement(); // input element
+            pWriter->writeStartElement(ColladaElement::inputElement);
+            pWriter->writeAttribute(ColladaElement::offsetAttribute, "0");
+            pWriter->writeAttribute(ColladaElement::semanticAttribute, "VERTEX");
+            pWriter->writeAttribute(ColladaElement::sourceAttribute, QString('#' + meshId + "-vertices"));
+            pWriter->writeEndElement(); // input element
 
-            QString indexString;
+            pWriter->writeStartElement(ColladaElement::primitiveElement);
             unsigned int index= wireData.verticeGroupOffset(i) + offset;
             for (int j= 0; j < currentSize; ++j)
             {
-                indexString.append(QString::number(index++) + ' ');
+                if (j > 0) pWriter->writeRaw(" ");
+                pWriter->writeUInt(index++);
             }
-            indexString.resize(indexString.size() - 1);
-            m_Writer.writeTextElement(ColladaElement::primitiveElement, indexString);
+            pWriter->writeEndElement(); // primitive element
 
-            m_Writer.writeEndElement(); // line strips
+            pWriter->writeEndElement(); // line strips
         }
     }
 }
@@ -881,32 +910,18 @@ void GLC_WorldToCollada::writeNode(GLC_StructOccurrence* pOcc)
 
 void GLC_WorldToCollada::writeMatrix(const GLC_Matrix4x4& matrix)
 {
-    QString subject;
-    const QChar spaceChar(' ');
-    // Rotation
-    subject+= QString::number(static_cast<float>(matrix.getData()[0]), 'g', 16) + spaceChar;
-    subject+= QString::number(static_cast<float>(matrix.getData()[4]), 'g', 16) + spaceChar;
-    subject+= QString::number(static_cast<float>(matrix.getData()[8]), 'g', 16) + spaceChar;
-    subject+= QString::number(static_cast<float>(matrix.getData()[12]), 'g', 16) + spaceChar;
-
-    subject+= QString::number(static_cast<float>(matrix.getData()[1]), 'g', 16) + spaceChar;
-    subject+= QString::number(static_cast<float>(matrix.getData()[5]), 'g', 16) + spaceChar;
-    subject+= QString::number(static_cast<float>(matrix.getData()[9]), 'g', 16) + spaceChar;
-    subject+= QString::number(static_cast<float>(matrix.getData()[13]), 'g', 16) + spaceChar;
-
-    subject+= QString::number(static_cast<float>(matrix.getData()[2]), 'g', 16) + spaceChar;
-    subject+= QString::number(static_cast<float>(matrix.getData()[6]), 'g', 16) + spaceChar;
-    subject+= QString::number(static_cast<float>(matrix.getData()[10]), 'g', 16) + spaceChar;
-    subject+= QString::number(static_cast<float>(matrix.getData()[14]), 'g', 16) + spaceChar;
-
-    // Translation
-    subject+= QString::number(static_cast<float>(matrix.getData()[3]), 'g', 16) + spaceChar;
-    subject+= QString::number(static_cast<float>(matrix.getData()[7]), 'g', 16) + spaceChar;
-    subject+= QString::number(static_cast<float>(matrix.getData()[11]), 'g', 16) + spaceChar;
-    subject+= QString::number(static_cast<float>(matrix.getData()[15]), 'g', 16);
-
-
-    m_Writer.writeTextElement(ColladaElement::matrixElement, subject);
+    // Collada matrices are written row by row
+    const double* pData= matrix.getData();
+    m_Writer.writeStartElement(ColladaElement::matrixElement);
+    for (int row= 0; row < 4; ++row)
+    {
+        for (int column= 0; column < 4; ++column)
+        {
+            if ((row + column) > 0) m_Writer.writeRaw(" ");
+            m_Writer.writeFloat(static_cast<float>(pData[column * 4 + row]));
+        }
+    }
+    m_Writer.writeEndElement(); // matrix element
 }
 
 void GLC_WorldToCollada::writeMeshesNode(const QList<GLC_Mesh*> meshes)
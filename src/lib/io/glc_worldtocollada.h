@@ -8,12 +8,12 @@
 #define GLC_WORLDTOCOLLADA_H
 
 #include <QString>
-#include <QXmlStreamWriter>
 #include <QSet>
 #include <QHash>
 #include <QMultiHash>
 
 #include "../sceneGraph/glc_world.h"
+#include "glc_bufferedxmlwriter.h"
 
 #include "../glc_config.h"
 
@@ -43,6 +43,10 @@ public:
     void setUrlEncoding(bool value)
     {m_UrlEncoding= value;}
 
+    //! Set the usage of threads to write meshes, the output is the same
+    void setParallelExport(bool value)
+    {m_ParallelExport= value;}
+
 private:
     void writeHeaderAsset();
     void writeMaterials(const QList<GLC_Material*> materialList, bool writeImage= true);
@@ -65,13 +69,14 @@ private:
     void writeTextureProfile(GLC_Texture* pTexture);
     void writeMaterialTechnique(GLC_Material* pMat);
     void writeColor(const QColor& color);
-    void writeMesh(GLC_Mesh* pMesh);
-    void writeMeshPosition(GLC_Mesh* pMesh, const QString& meshId);
-    void writeMeshNormal(GLC_Mesh* pMesh, const QString& meshId);
-    void writeMeshTexel(GLC_Mesh* pMesh, const QString& meshId);
-    void writeVertices(GLC_Mesh* pMesh, const QString& meshId, unsigned int wireOffset);
-    void writeMeshTriangle(const IndexList& index, const QString& meshId, GLC_Material* pMat);
-    void writeLineStrips(const GLC_Mesh* pMesh, const QString& meshId, unsigned int offset);
+    void writeMeshes(const QList<GLC_Mesh*>& meshes);
+    void writeMesh(GLC_BufferedXmlWriter* pWriter, GLC_Mesh* pMesh, const QString& meshId) const;
+    void writeMeshPosition(GLC_BufferedXmlWriter* pWriter, GLC_Mesh* pMesh, const QString& meshId) const;
+    void writeMeshNormal(GLC_BufferedXmlWriter* pWriter, GLC_Mesh* pMesh, const QString& meshId) const;
+    void writeMeshTexel(GLC_BufferedXmlWriter* pWriter, GLC_Mesh* pMesh, const QString& meshId) const;
+    void writeVertices(GLC_BufferedXmlWriter* pWriter, GLC_Mesh* pMesh, const QString& meshId, unsigned int wireOffset) const;
+    void writeMeshTriangle(GLC_BufferedXmlWriter* pWriter, const IndexList& index, const QString& meshId, GLC_Material* pMat) const;
+    void writeLineStrips(GLC_BufferedXmlWriter* pWriter, const GLC_Mesh* pMesh, const QString& meshId, unsigned int offset) const;
     void writeLibraryNode();
     void writeLibraryVisualScenes();
     void writeInstanciateVisualScene();
@@ -90,7 +95,7 @@ private:
     GLC_World m_World;
     QString m_AuthoringTool;
     QString m_AbsoluteFileName;
-    QXmlStreamWriter m_Writer;
+    GLC_BufferedXmlWriter m_Writer;
     int m_ImageIndex;
     QHash<QString, QString> m_ImageSourceFileNameToTarget;
     QList<GLC_Material*> m_MaterialList;
@@ -105,6 +110,7 @@ private:
     QString m_BasePath;
     QString m_BasePathPrefix;
     bool m_UrlEncoding;
+    bool m_ParallelExport;
 };
 
 
@@ -0,0 +1,572 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_worldtoglcw.cpp implementation of the GLC_WorldToGlcw class.
+
+#include <QDataStream>
+#include <QFile>
+#include <QtEndian>
+
+#include "glc_worldtoglcw.h"
+#include "../geometry/glc_3drep.h"
+#include "../geometry/glc_mesh.h"
+#include "../sceneGraph/glc_structoccurrence.h"
+#include "../sceneGraph/glc_structinstance.h"
+#include "../sceneGraph/glc_structreference.h"
+#include "../sceneGraph/glc_attributes.h"
+#include "../shading/glc_material.h"
+#include "../glc_factory.h"
+
+namespace
+{
+    // Number of sections of the written files
+    const int sectionCount= GLC_WorldToGlcw::GeometrySection;
+
+    // Sections start on multiples of this size
+    const qint64 sectionAlignment= 8;
+
+    template <typename T>
+    void appendValue(QByteArray* pData, T value)
+    {
+        char buffer[sizeof(T)];
+        qToLittleEndian(value, buffer);
+        pData->append(buffer, sizeof(T));
+    }
+
+    void appendBoundingBox(QByteArray* pData, const GLC_BoundingBox& box)
+    {
+        GLC_Point3d lower(1.0, 1.0, 1.0);
+        GLC_Point3d upper(-1.0, -1.0, -1.0);
+        if (!box.isEmpty())
+        {
+            lower= box.lowerCorner();
+            upper= box.upperCorner();
+        }
+        for (int i= 0; i < 3; ++i) appendValue<double>(pData, lower.data()[i]);
+        for (int i= 0; i < 3; ++i) appendValue<double>(pData, upper.data()[i]);
+    }
+
+    void appendColor(QByteArray* pData, const QColor& color)
+    {
+        appendValue<float>(pData, static_cast<float>(color.redF()));
+        appendValue<float>(pData, static_cast<float>(color.greenF()));
+        appendValue<float>(pData, static_cast<float>(color.blueF()));
+        appendValue<float>(pData, static_cast<float>(color.alphaF()));
+    }
+
+    bool alignFile(QFile* pFile)
+    {
+        const qint64 padding= (sectionAlignment - (pFile->pos() % sectionAlignment)) % sectionAlignment;
+        return (padding == 0) || (pFile->write(QByteArray(static_cast<int>(padding), '\0')) == padding);
+    }
+}
+
+GLC_WorldToGlcw::GLC_WorldToGlcw(const GLC_World& world)
+    : QObject()
+    , m_World(world)
+    , m_Occurrences()
+    , m_Instances()
+    , m_InstanceHash()
+    , m_References()
+    , m_ReferenceHash()
+    , m_ReferenceFirstOccurrence()
+    , m_ReferenceBoxes()
+    , m_ReferenceBoxIsValid()
+    , m_Representations()
+    , m_RepresentationHash()
+    , m_RepresentationBoxes()
+    , m_StringHash()
+    , m_StringOffsets()
+    , m_StringData()
+    , m_MaterialHash()
+    , m_TextureHash()
+    , m_Attributes()
+    , m_Textures()
+    , m_Materials()
+    , m_RepresentationMaterials()
+    , m_RepresentationRecords()
+    , m_ReferenceRecords()
+    , m_InstanceRecords()
+    , m_Sections()
+{
+
+}
+
+GLC_WorldToGlcw::~GLC_WorldToGlcw()
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+QString GLC_WorldToGlcw::suffix()
+{
+    return QString("glcw");
+}
+
+quint32 GLC_WorldToGlcw::version()
+{
+    return 100;
+}
+
+QUuid GLC_WorldToGlcw::magic()
+{
+    return QUuid("{9c3f52a1-6e0b-4d8e-b7a4-2f19c85d0e73}");
+}
+
+qint64 GLC_WorldToGlcw::headerSize(int sectionCount)
+{
+    // Magic, version, section count and the directory
+    return 16 + 4 + 4 + (static_cast<qint64>(sectionCount) * 32);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_WorldToGlcw::exportToGlcw(const QString& fileName)
+{
+    clear();
+    addOccurrence(m_World.rootOccurrence(), -1);
+
+    QFile file(fileName);
+    bool subject= file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    if (subject)
+    {
+        // The header is written last, when the sections are known
+        const qint64 size= headerSize(sectionCount);
+        subject= (file.write(QByteArray(static_cast<int>(size), '\0')) == size);
+        subject= subject && writeRepresentations(&file);
+        if (subject)
+        {
+            buildStructureTables();
+
+            QByteArray occurrences;
+            occurrences.reserve(m_Occurrences.size() * OccurrenceRecordSize);
+            const int occurrenceCount= m_Occurrences.size();
+            for (int i= 0; i < occurrenceCount; ++i)
+            {
+                const Occurrence& occurrence= m_Occurrences.at(i);
+                appendValue<qint32>(&occurrences, occurrence.m_Parent);
+                appendValue<quint32>(&occurrences, occurrence.m_Instance);
+                appendValue<quint32>(&occurrences, occurrence.m_End);
+                appendValue<quint32>(&occurrences, occurrence.m_Flags);
+            }
+
+            QByteArray stringOffsets;
+            stringOffsets.reserve(m_StringOffsets.size() * StringOffsetRecordSize);
+            const int offsetCount= m_StringOffsets.size();
+            for (int i= 0; i < offsetCount; ++i)
+            {
+                appendValue<quint32>(&stringOffsets, m_StringOffsets.at(i));
+            }
+
+            subject= writeSection(&file, AttributeSection, AttributeRecordSize, m_Attributes);
+            subject= subject && writeSection(&file, TextureSection, TextureRecordSize, m_Textures);
+            subject= subject && writeSection(&file, MaterialSection, MaterialRecordSize, m_Materials);
+            subject= subject && writeSection(&file, RepresentationMaterialSection, RepresentationMaterialRecordSize, m_RepresentationMaterials);
+            subject= subject && writeSection(&file, RepresentationSection, RepresentationRecordSize, m_RepresentationRecords);
+            subject= subject && writeSection(&file, ReferenceSection, ReferenceRecordSize, m_ReferenceRecords);
+            subject= subject && writeSection(&file, InstanceSection, InstanceRecordSize, m_InstanceRecords);
+            subject= subject && writeSection(&file, OccurrenceSection, OccurrenceRecordSize, occurrences);
+            subject= subject && writeSection(&file, StringOffsetSection, StringOffsetRecordSize, stringOffsets);
+            subject= subject && writeSection(&file, StringDataSection, 1, m_StringData);
+        }
+        subject= subject && writeHeader(&file);
+        subject= subject && (file.error() == QFileDevice::NoError);
+
+        file.close();
+        if (!subject) file.remove();
+    }
+
+    clear();
+    emit currentQuantum(100);
+
+    return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_WorldToGlcw::clear()
+{
+    m_Occurrences.clear();
+    m_Instances.clear();
+    m_InstanceHash.clear();
+    m_References.clear();
+    m_ReferenceHash.clear();
+    m_ReferenceFirstOccurrence.clear();
+    m_ReferenceBoxes.clear();
+    m_ReferenceBoxIsValid.clear();
+    m_Representations.clear();
+    m_RepresentationHash.clear();
+    m_RepresentationBoxes.clear();
+    m_StringHash.clear();
+    m_StringOffsets.clear();
+    m_StringOffsets.append(0);
+    m_StringData.clear();
+    m_MaterialHash.clear();
+    m_TextureHash.clear();
+    m_Attributes.clear();
+    m_Textures.clear();
+    m_Materials.clear();
+    m_RepresentationMaterials.clear();
+    m_RepresentationRecords.clear();
+    m_ReferenceRecords.clear();
+    m_InstanceRecords.clear();
+    m_Sections.clear();
+}
+
+void GLC_WorldToGlcw::addOccurrence(const GLC_StructOccurrence* pOccurrence, int parentIndex)
+{
+    const int index= m_Occurrences.size();
+
+    Occurrence occurrence;
+    occurrence.m_Parent= parentIndex;
+    occurrence.m_Instance= instanceIndex(pOccurrence->structInstance());
+    occurrence.m_End= 0;
+    occurrence.m_Flags= pOccurrence->isVisible() ? Visible : 0;
+    m_Occurrences.append(occurrence);
+
+    const quint32 reference= referenceIndex(pOccurrence->structReference());
+    if (m_ReferenceFirstOccurrence.at(reference) == -1)
+    {
+        m_ReferenceFirstOccurrence[reference]= index;
+    }
+
+    const int childCount= pOccurrence->childCount();
+    for (int i= 0; i < childCount; ++i)
+    {
+        addOccurrence(pOccurrence->child(i), index);
+    }
+    m_Occurrences[index].m_End= static_cast<quint32>(m_Occurrences.size());
+}
+
+quint32 GLC_WorldToGlcw::instanceIndex(const GLC_StructInstance* pInstance)
+{
+    QHash<const GLC_StructInstance*, quint32>::const_iterator iInstance= m_InstanceHash.constFind(pInstance);
+    if (iInstance != m_InstanceHash.constEnd()) return iInstance.value();
+
+    const quint32 subject= static_cast<quint32>(m_Instances.size());
+    m_Instances.append(pInstance);
+    m_InstanceHash.insert(pInstance, subject);
+
+    return subject;
+}
+
+quint32 GLC_WorldToGlcw::referenceIndex(const GLC_StructReference* pReference)
+{
+    QHash<const GLC_StructReference*, quint32>::const_iterator iReference= m_ReferenceHash.constFind(pReference);
+    if (iReference != m_ReferenceHash.constEnd()) return iReference.value();
+
+    const quint32 subject= static_cast<quint32>(m_References.size());
+    m_References.append(pReference);
+    m_ReferenceHash.insert(pReference, subject);
+    m_ReferenceFirstOccurrence.append(-1);
+
+    // Representations shared by references are written once
+    if (pReference->hasRepresentation())
+    {
+        const GLC_3DRep* pRep= dynamic_cast<const GLC_3DRep*>(pReference->representationHandle());
+        if ((nullptr != pRep) && !m_RepresentationHash.contains(pRep))
+        {
+            m_RepresentationHash.insert(pRep, m_Representations.size());
+            m_Representations.append(pRep);
+        }
+    }
+
+    return subject;
+}
+
+quint32 GLC_WorldToGlcw::stringIndex(const QString& string)
+{
+    QHash<QString, quint32>::const_iterator iString= m_StringHash.constFind(string);
+    if (iString != m_StringHash.constEnd()) return iString.value();
+
+    const quint32 subject= static_cast<quint32>(m_StringOffsets.size() - 1);
+    m_StringData.append(string.toUtf8());
+    m_StringOffsets.append(static_cast<quint32>(m_StringData.size()));
+    m_StringHash.insert(string, subject);
+
+    return subject;
+}
+
+void GLC_WorldToGlcw::appendAttributes(const GLC_Attributes* pAttributes, QByteArray* pRecord)
+{
+    const quint32 first= static_cast<quint32>(m_Attributes.size() / AttributeRecordSize);
+    quint32 count= 0;
+    if (nullptr != pAttributes)
+    {
+        const QList<QString> names(pAttributes->names());
+        const int size= names.size();
+        for (int i= 0; i < size; ++i)
+        {
+            const QString& name= names.at(i);
+            appendValue<quint32>(&m_Attributes, stringIndex(name));
+            appendValue<quint32>(&m_Attributes, stringIndex(pAttributes->value(name).toString()));
+        }
+        count= static_cast<quint32>(size);
+    }
+    appendValue<quint32>(pRecord, first);
+    appendValue<quint32>(pRecord, count);
+}
+
+quint32 GLC_WorldToGlcw::materialIndex(const GLC_Material* pMaterial)
+{
+    qint32 texture= -1;
+    if (pMaterial->hasTexture())
+    {
+        const QString textureFileName(pMaterial->textureHandle()->fileName());
+        texture= m_TextureHash.value(textureFileName, -1);
+        if (texture == -1)
+        {
+            texture= m_TextureHash.size();
+            m_TextureHash.insert(textureFileName, texture);
+            appendValue<quint32>(&m_Textures, stringIndex(textureFileName));
+        }
+    }
+
+    QByteArray record;
+    record.reserve(MaterialRecordSize);
+    appendValue<quint32>(&record, stringIndex(pMaterial->name()));
+    appendValue<qint32>(&record, texture);
+    appendColor(&record, pMaterial->ambientColor());
+    appendColor(&record, pMaterial->diffuseColor());
+    appendColor(&record, pMaterial->specularColor());
+    appendColor(&record, pMaterial->emissiveColor());
+    appendValue<float>(&record, static_cast<float>(pMaterial->shininess()));
+    appendValue<float>(&record, static_cast<float>(pMaterial->opacity()));
+
+    // The record is the key of equal materials
+    QHash<QByteArray, quint32>::const_iterator iMaterial= m_MaterialHash.constFind(record);
+    if (iMaterial != m_MaterialHash.constEnd()) return iMaterial.value();
+
+    const quint32 subject= static_cast<quint32>(m_MaterialHash.size());
+    m_MaterialHash.insert(record, subject);
+    m_Materials.append(record);
+
+    return subject;
+}
+
+bool GLC_WorldToGlcw::writeRepresentations(QFile* pFile)
+{
+    bool subject= alignFile(pFile);
+
+    Section section;
+    section.m_Type= GeometrySection;
+    section.m_RecordSize= 0;
+    section.m_RecordCount= static_cast<quint64>(m_Representations.size());
+    section.m_Offset= pFile->pos();
+
+    const int count= m_Representations.size();
+    int previousQuantum= 0;
+    for (int i= 0; subject && (i < count); ++i)
+    {
+        const GLC_3DRep* pRep= m_Representations.at(i);
+        if (pRep->isEmpty() && !pRep->isLoaded() && !pRep->fileName().isEmpty())
+        {
+            // Load a copy of the representation, the exported world is not modified
+            GLC_3DRep loadedRep(GLC_Factory::instance()->create3DRepFromFile(pRep->fileName()));
+            loadedRep.setName(pRep->name());
+            subject= writeRepresentation(pFile, i, loadedRep);
+        }
+        else
+        {
+            subject= writeRepresentation(pFile, i, *pRep);
+        }
+
+        const int quantum= ((i + 1) * 100) / (count + 1);
+        if (quantum > previousQuantum)
+        {
+            previousQuantum= quantum;
+            emit currentQuantum(quantum);
+        }
+    }
+
+    section.m_Size= pFile->pos() - section.m_Offset;
+    m_Sections.append(section);
+
+    return subject;
+}
+
+bool GLC_WorldToGlcw::writeRepresentation(QFile* pFile, int index, const GLC_3DRep& rep)
+{
+    Q_ASSERT(m_RepresentationBoxes.size() == index);
+    Q_UNUSED(index);
+
+    const qint64 offset= pFile->pos();
+
+    // Materials used by the meshes, their id is used by the serialized meshes
+    const quint32 firstMaterial= static_cast<quint32>(m_RepresentationMaterials.size() / RepresentationMaterialRecordSize);
+    const QList<GLC_Material*> materials(rep.materialSet().values());
+    const int materialCount= materials.size();
+    for (int i= 0; i < materialCount; ++i)
+    {
+        const GLC_Material* pMaterial= materials.at(i);
+        appendValue<quint32>(&m_RepresentationMaterials, pMaterial->id());
+        appendValue<quint32>(&m_RepresentationMaterials, materialIndex(pMaterial));
+    }
+
+    QList<const GLC_Mesh*> meshes;
+    const int bodyCount= rep.numberOfBody();
+    for (int i= 0; i < bodyCount; ++i)
+    {
+        const GLC_Mesh* pMesh= dynamic_cast<const GLC_Mesh*>(rep.geomAt(i));
+        if (nullptr != pMesh) meshes.append(pMesh);
+    }
+
+    QDataStream stream(pFile);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << static_cast<qint32>(meshes.size());
+    const int meshCount= meshes.size();
+    for (int i= 0; i < meshCount; ++i)
+    {
+        meshes.at(i)->saveToDataStream(stream);
+    }
+
+    const GLC_BoundingBox boundingBox(rep.boundingBox());
+    m_RepresentationBoxes.append(boundingBox);
+
+    appendValue<quint32>(&m_RepresentationRecords, stringIndex(rep.name()));
+    appendValue<quint32>(&m_RepresentationRecords, firstMaterial);
+    appendValue<quint32>(&m_RepresentationRecords, static_cast<quint32>(materialCount));
+    appendValue<quint32>(&m_RepresentationRecords, static_cast<quint32>(meshCount));
+    appendValue<qint64>(&m_RepresentationRecords, offset);
+    appendValue<qint64>(&m_RepresentationRecords, pFile->pos() - offset);
+    appendBoundingBox(&m_RepresentationRecords, boundingBox);
+
+    return stream.status() == QDataStream::Ok;
+}
+
+void GLC_WorldToGlcw::buildStructureTables()
+{
+    const int referenceCount= m_References.size();
+    m_ReferenceBoxes.resize(referenceCount);
+    m_ReferenceBoxIsValid.fill(false, referenceCount);
+    m_ReferenceRecords.reserve(referenceCount * ReferenceRecordSize);
+    for (int i= 0; i < referenceCount; ++i)
+    {
+        const GLC_StructReference* pReference= m_References.at(i);
+        qint32 representation= -1;
+        if (pReference->hasRepresentation())
+        {
+            const GLC_3DRep* pRep= dynamic_cast<const GLC_3DRep*>(pReference->representationHandle());
+            representation= m_RepresentationHash.value(pRep, -1);
+        }
+        appendValue<quint32>(&m_ReferenceRecords, stringIndex(pReference->name()));
+        appendValue<qint32>(&m_ReferenceRecords, representation);
+        appendAttributes(pReference->attributesHandle(), &m_ReferenceRecords);
+        appendBoundingBox(&m_ReferenceRecords, referenceBoundingBox(i));
+    }
+
+    const int instanceCount= m_Instances.size();
+    m_InstanceRecords.reserve(instanceCount * InstanceRecordSize);
+    for (int i= 0; i < instanceCount; ++i)
+    {
+        const GLC_StructInstance* pInstance= m_Instances.at(i);
+        appendValue<quint32>(&m_InstanceRecords, stringIndex(pInstance->name()));
+        appendValue<quint32>(&m_InstanceRecords, m_ReferenceHash.value(pInstance->structReference()));
+        appendAttributes(pInstance->attributesHandle(), &m_InstanceRecords);
+        const GLC_Matrix4x4 matrix(pInstance->relativeMatrix());
+        const double* pData= matrix.getData();
+        for (int j= 0; j < 16; ++j)
+        {
+            appendValue<double>(&m_InstanceRecords, pData[j]);
+        }
+    }
+}
+
+GLC_BoundingBox GLC_WorldToGlcw::referenceBoundingBox(int index)
+{
+    if (!m_ReferenceBoxIsValid.at(index))
+    {
+        GLC_BoundingBox subject;
+        const GLC_StructReference* pReference= m_References.at(index);
+        if (pReference->hasRepresentation())
+        {
+            const GLC_3DRep* pRep= dynamic_cast<const GLC_3DRep*>(pReference->representationHandle());
+            const int representation= m_RepresentationHash.value(pRep, -1);
+            if (representation != -1) subject= m_RepresentationBoxes.at(representation);
+        }
+
+        // The children of the reference are the children of its first occurrence
+        const int first= m_ReferenceFirstOccurrence.at(index);
+        const int end= static_cast<int>(m_Occurrences.at(first).m_End);
+        int child= first + 1;
+        while (child < end)
+        {
+            const Occurrence& occurrence= m_Occurrences.at(child);
+            const GLC_StructInstance* pInstance= m_Instances.at(occurrence.m_Instance);
+            GLC_BoundingBox childBox(referenceBoundingBox(m_ReferenceHash.value(pInstance->structReference())));
+            if (!childBox.isEmpty())
+            {
+                childBox.transform(pInstance->relativeMatrix());
+                subject.combine(childBox);
+            }
+            child= static_cast<int>(occurrence.m_End);
+        }
+
+        m_ReferenceBoxes[index]= subject;
+        m_ReferenceBoxIsValid[index]= true;
+    }
+
+    return m_ReferenceBoxes.at(index);
+}
+
+bool GLC_WorldToGlcw::writeSection(QFile* pFile, quint32 type, quint32 recordSize, const QByteArray& data)
+{
+    Q_ASSERT(recordSize > 0);
+    const bool subject= alignFile(pFile);
+
+    Section section;
+    section.m_Type= type;
+    section.m_RecordSize= recordSize;
+    section.m_RecordCount= static_cast<quint64>(data.size() / recordSize);
+    section.m_Offset= pFile->pos();
+    section.m_Size= data.size();
+    m_Sections.append(section);
+
+    return subject && (pFile->write(data) == data.size());
+}
+
+bool GLC_WorldToGlcw::writeHeader(QFile* pFile)
+{
+    Q_ASSERT(m_Sections.size() == sectionCount);
+    bool subject= pFile->seek(0);
+
+    QDataStream stream(pFile);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << magic() << version() << static_cast<quint32>(m_Sections.size());
+    const int count= m_Sections.size();
+    for (int i= 0; i < count; ++i)
+    {
+        const Section& section= m_Sections.at(i);
+        stream << section.m_Type << section.m_RecordSize << section.m_RecordCount << section.m_Offset << section.m_Size;
+    }
+    subject= subject && (stream.status() == QDataStream::Ok);
+
+    return subject;
+}
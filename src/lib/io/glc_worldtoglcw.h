@@ -0,0 +1,284 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ *****************************************************************************/
+//! \file glc_worldtoglcw.h interface for the GLC_WorldToGlcw class.
+
+#ifndef GLC_WORLDTOGLCW_H_
+#define GLC_WORLDTOGLCW_H_
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QUuid>
+#include <QVector>
+
+#include "../sceneGraph/glc_world.h"
+#include "../glc_boundingbox.h"
+
+#include "../glc_config.h"
+
+QT_BEGIN_NAMESPACE
+class QFile;
+QT_END_NAMESPACE
+class GLC_3DRep;
+class GLC_Attributes;
+class GLC_Material;
+class GLC_StructInstance;
+class GLC_StructOccurrence;
+class GLC_StructReference;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_WorldToGlcw
+/*! \brief GLC_WorldToGlcw : Export a GLC_World to a glcw binary world file*/
+
+/*! A glcw file stores the product structure in flat tables and each representation
+ *  once, so GLC_GlcwToWorld opens the structure without parsing and loads the representations
+ *  on demand. The file can be mapped, all tables are read in place.
+ *
+ *  The file starts with a header written by a little endian QDataStream :
+ *  magic uuid, version, section count and the section directory.
+ *  A section of the directory is : type (quint32), record size (quint32), record count (quint64),
+ *  offset (qint64) and size (qint64). Readers ignore unknown sections and the unknown end of records,
+ *  so sections and record fields can be added without breaking older readers.
+ *
+ *  Records are little endian, strings are indexes in the string table and
+ *  bounding boxes are lower and upper corners (6 doubles), lower x greater than upper x if empty :
+ *  - StringOffsetSection : string count + 1 offsets (quint32) in the UTF-8 data of StringDataSection.
+ *  - AttributeSection : name, value. Owners store their first attribute and attribute count.
+ *  - TextureSection : file name. Textures are shared by materials.
+ *  - MaterialSection : name, texture index (qint32, -1 if none), ambient, diffuse, specular
+ *    and emissive RGBA (4 floats each), shininess and opacity (float). Equal materials are stored once.
+ *  - RepresentationMaterialSection : material id used by the meshes of the representation, material index.
+ *  - RepresentationSection : name, first representation material, representation material count,
+ *    mesh count, geometry offset (qint64), geometry size (qint64), bounding box.
+ *  - ReferenceSection : name, representation index (qint32, -1 if none), first attribute,
+ *    attribute count, bounding box of the reference and its children in reference coordinates.
+ *  - InstanceSection : name, reference index, first attribute, attribute count, relative matrix (16 doubles).
+ *  - OccurrenceSection : occurrences in depth first order, parent index (qint32, -1 for the root),
+ *    instance index, index of the occurrence after the subtree, flags (Visible).
+ *  - GeometrySection : representations written by a QDataStream (Qt_4_6, single precision) :
+ *    mesh count followed by the meshes (GLC_Mesh::saveToDataStream()).
+ *
+ *  Representations shared by references are stored once. Not loaded representations
+ *  are loaded from their file during the export.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_WorldToGlcw : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! Section types
+    enum SectionType
+    {
+        StringOffsetSection= 1,
+        StringDataSection,
+        AttributeSection,
+        TextureSection,
+        MaterialSection,
+        RepresentationMaterialSection,
+        RepresentationSection,
+        ReferenceSection,
+        InstanceSection,
+        OccurrenceSection,
+        GeometrySection
+    };
+
+    //! Size of the records of the sections in this version
+    enum RecordSize
+    {
+        StringOffsetRecordSize= 4,
+        AttributeRecordSize= 8,
+        TextureRecordSize= 4,
+        MaterialRecordSize= 80,
+        RepresentationMaterialRecordSize= 8,
+        RepresentationRecordSize= 80,
+        ReferenceRecordSize= 64,
+        InstanceRecordSize= 144,
+        OccurrenceRecordSize= 16
+    };
+
+    //! Occurrence flags
+    enum OccurrenceFlag
+    {
+        Visible= 0x1
+    };
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Construct an exporter of the given world
+    explicit GLC_WorldToGlcw(const GLC_World& world);
+    virtual ~GLC_WorldToGlcw();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the glcw file suffix
+    static QString suffix();
+
+    //! Return the glcw file version
+    static quint32 version();
+
+    //! Return the glcw file magic uuid
+    static QUuid magic();
+
+    //! Return the size of the header of a file with the given section count
+    static qint64 headerSize(int sectionCount);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Save the world to the given file name, return true on success
+    bool exportToGlcw(const QString& fileName);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! An occurrence of the occurrence table
+    struct Occurrence
+    {
+        qint32 m_Parent;
+        quint32 m_Instance;
+        quint32 m_End;
+        quint32 m_Flags;
+    };
+
+    //! A section of the written file
+    struct Section
+    {
+        quint32 m_Type;
+        quint32 m_RecordSize;
+        quint64 m_RecordCount;
+        qint64 m_Offset;
+        qint64 m_Size;
+    };
+
+    //! Clear the tables of the last export
+    void clear();
+
+    //! Add the given occurrence and its children to the tables
+    void addOccurrence(const GLC_StructOccurrence* pOccurrence, int parentIndex);
+
+    //! Return the index of the given instance, add it if needed
+    quint32 instanceIndex(const GLC_StructInstance* pInstance);
+
+    //! Return the index of the given reference, add it if needed
+    quint32 referenceIndex(const GLC_StructReference* pReference);
+
+    //! Return the index of the given string, add it if needed
+    quint32 stringIndex(const QString& string);
+
+    //! Append the given attributes to the attribute table and their range to the given record
+    void appendAttributes(const GLC_Attributes* pAttributes, QByteArray* pRecord);
+
+    //! Return the index of the given material, add it if needed
+    quint32 materialIndex(const GLC_Material* pMaterial);
+
+    //! Write the representations in the given file
+    bool writeRepresentations(QFile* pFile);
+
+    //! Write the given loaded representation at the end of the given file
+    bool writeRepresentation(QFile* pFile, int index, const GLC_3DRep& rep);
+
+    //! Build the reference and instance tables
+    void buildStructureTables();
+
+    //! Return the bounding box of the given reference and its children
+    GLC_BoundingBox referenceBoundingBox(int index);
+
+    //! Append the given section data at the end of the given file
+    bool writeSection(QFile* pFile, quint32 type, quint32 recordSize, const QByteArray& data);
+
+    //! Write the header at the beginning of the given file
+    bool writeHeader(QFile* pFile);
+
+//////////////////////////////////////////////////////////////////////
+// Qt Signals
+//////////////////////////////////////////////////////////////////////
+    signals:
+    void currentQuantum(int);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The exported world
+    GLC_World m_World;
+
+    //! The occurrences in depth first order
+    QVector<Occurrence> m_Occurrences;
+
+    //! The instances and their index
+    QList<const GLC_StructInstance*> m_Instances;
+    QHash<const GLC_StructInstance*, quint32> m_InstanceHash;
+
+    //! The references, their index and their first occurrence
+    QList<const GLC_StructReference*> m_References;
+    QHash<const GLC_StructReference*, quint32> m_ReferenceHash;
+    QVector<int> m_ReferenceFirstOccurrence;
+
+    //! The bounding boxes of references, computed on demand
+    QVector<GLC_BoundingBox> m_ReferenceBoxes;
+    QVector<bool> m_ReferenceBoxIsValid;
+
+    //! The representations and their index
+    QList<const GLC_3DRep*> m_Representations;
+    QHash<const GLC_3DRep*, int> m_RepresentationHash;
+
+    //! The bounding boxes of representations
+    QVector<GLC_BoundingBox> m_RepresentationBoxes;
+
+    //! The string table
+    QHash<QString, quint32> m_StringHash;
+    QVector<quint32> m_StringOffsets;
+    QByteArray m_StringData;
+
+    //! The material table, equal materials are stored once
+    QHash<QByteArray, quint32> m_MaterialHash;
+    QHash<QString, qint32> m_TextureHash;
+
+    //! The records of the tables
+    QByteArray m_Attributes;
+    QByteArray m_Textures;
+    QByteArray m_Materials;
+    QByteArray m_RepresentationMaterials;
+    QByteArray m_RepresentationRecords;
+    QByteArray m_ReferenceRecords;
+    QByteArray m_InstanceRecords;
+
+    //! The written sections
+    QList<Section> m_Sections;
+};
+
+#endif /* GLC_WORLDTOGLCW_H_ */
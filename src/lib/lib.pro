@@ -121,7 +121,11 @@ HEADERS_GLC_IO +=   io/glc_objmtlloader.h \
                     io/glc_worldtoobj.h \
                     io/glc_assimptoworld.h \
                     io/glc_colladaxmlelement.h \
-                    io/glc_worldtocollada.h
+                    io/glc_worldtocollada.h \
+                    io/glc_bufferedxmlwriter.h \
+                    io/glc_inputdata.h \
+                    io/glc_worldtoglcw.h \
+                    io/glc_glcwtoworld.h
 
 HEADERS_GLC_SCENEGRAPH +=   sceneGraph/glc_3dviewcollection.h \
                             sceneGraph/glc_3dviewinstance.h \
@@ -134,7 +138,16 @@ HEADERS_GLC_SCENEGRAPH +=   sceneGraph/glc_3dviewcollection.h \
                             sceneGraph/glc_spacepartitioning.h \
                             sceneGraph/glc_octree.h \
                             sceneGraph/glc_octreenode.h \
-                            sceneGraph/glc_selectionset.h
+                            sceneGraph/glc_selectionset.h \
+                            sceneGraph/glc_occurrenceindex.h \
+                            sceneGraph/glc_residencymanager.h \
+                            sceneGraph/glc_staticbatch.h \
+                            sceneGraph/glc_depthsorter.h \
+                            sceneGraph/glc_occlusionculler.h \
+                            sceneGraph/glc_lodselector.h \
+                            sceneGraph/glc_frustumculler.h \
+                            sceneGraph/glc_sectionengine.h \
+                            sceneGraph/glc_clashdetector.h
 							
 HEADERS_GLC_GEOMETRY += geometry/glc_geometry.h \
                         geometry/glc_circle.h \
@@ -165,7 +178,12 @@ HEADERS_GLC_GEOMETRY += geometry/glc_geometry.h \
                         geometry/glc_csgoperatornode.h \
                         geometry/glc_csgleafnode.h \
                         geometry/glc_lathemesh.h \
-                        geometry/glc_image.h
+                        geometry/glc_image.h \
+                        geometry/glc_pointcloudbuilder.h \
+                        geometry/glc_streamedpointcloud.h \
+                        geometry/glc_aabbtree.h \
+                        geometry/glc_meshbvh.h \
+                        geometry/glc_kdtree.h
 
 
 HEADERS_GLC_SHADING +=  shading/glc_material.h \
@@ -174,7 +192,9 @@ HEADERS_GLC_SHADING +=  shading/glc_material.h \
                         shading/glc_selectionmaterial.h \
                         shading/glc_light.h \
                         shading/glc_renderproperties.h \
-                        shading/glc_renderer.h
+                        shading/glc_renderer.h \
+                        shading/glc_texturemanager.h \
+                        shading/glc_oitrenderer.h
 						
 HEADERS_GLC_VIEWPORT +=	viewport/glc_camera.h \
                         viewport/glc_imageplane.h \
@@ -214,6 +234,8 @@ HEADERS_GLC += glc_global.h \
                glc_config.h \
                glc_cachemanager.h \
                glc_renderstatistics.h \
+               glc_renderprofiler.h \
+               glc_renderstatecache.h \
                glc_log.h \
                glc_errorlog.h \
                glc_tracelog.h \
@@ -341,7 +363,11 @@ SOURCES +=	io/glc_objmtlloader.cpp \
                 io/glc_fileloader.cpp \
                 io/glc_worldtoobj.cpp \
                 io/glc_assimptoworld.cpp \
-                io/glc_worldtocollada.cpp
+                io/glc_worldtocollada.cpp \
+                io/glc_bufferedxmlwriter.cpp \
+                io/glc_inputdata.cpp \
+                io/glc_worldtoglcw.cpp \
+                io/glc_glcwtoworld.cpp
 
 SOURCES +=	sceneGraph/glc_3dviewcollection.cpp \
                 sceneGraph/glc_3dviewinstance.cpp \
@@ -354,7 +380,16 @@ SOURCES +=	sceneGraph/glc_3dviewcollection.cpp \
                 sceneGraph/glc_octree.cpp \
                 sceneGraph/glc_octreenode.cpp \
                 sceneGraph/glc_selectionset.cpp \
-                sceneGraph/glc_structoccurrence.cpp
+                sceneGraph/glc_structoccurrence.cpp \
+                sceneGraph/glc_occurrenceindex.cpp \
+                sceneGraph/glc_residencymanager.cpp \
+                sceneGraph/glc_staticbatch.cpp \
+                sceneGraph/glc_depthsorter.cpp \
+                sceneGraph/glc_occlusionculler.cpp \
+                sceneGraph/glc_lodselector.cpp \
+                sceneGraph/glc_frustumculler.cpp \
+                sceneGraph/glc_sectionengine.cpp \
+                sceneGraph/glc_clashdetector.cpp
 
 SOURCES +=	geometry/glc_geometry.cpp \
                 geometry/glc_circle.cpp \
@@ -385,12 +420,19 @@ SOURCES +=	geometry/glc_geometry.cpp \
                 geometry/glc_csgoperatornode.cpp \
                 geometry/glc_csgleafnode.cpp \
                 geometry/glc_lathemesh.cpp \
-                geometry/glc_image.cpp
+                geometry/glc_image.cpp \
+                geometry/glc_pointcloudbuilder.cpp \
+                geometry/glc_streamedpointcloud.cpp \
+                geometry/glc_aabbtree.cpp \
+                geometry/glc_meshbvh.cpp \
+                geometry/glc_kdtree.cpp
 
 
 
 SOURCES +=	shading/glc_material.cpp \
                 shading/glc_texture.cpp \
+                shading/glc_texturemanager.cpp \
+                shading/glc_oitrenderer.cpp \
                 shading/glc_light.cpp \
                 shading/glc_selectionmaterial.cpp \
                 shading/glc_shader.cpp \
@@ -434,6 +476,8 @@ SOURCES +=	glc_global.cpp \
                 glc_state.cpp \
                 glc_cachemanager.cpp \
                 glc_renderstatistics.cpp \
+                glc_renderprofiler.cpp \
+                glc_renderstatecache.cpp \
                 glc_log.cpp \
                 glc_errorlog.cpp \
                 glc_tracelog.cpp \
@@ -541,6 +585,10 @@ HEADERS_INST = GLC_BoundingBox \
                GLC_WorldTo3dxml \
                GLC_WorldTo3ds \
                GLC_RenderStatistics \
+               GLC_RenderProfiler \
+               GLC_RenderStateCache \
+               GLC_TextureManager \
+               GLC_OitRenderer \
                GLC_Ext \
                GLC_Cone \
                GLC_Sphere \
@@ -581,7 +629,25 @@ HEADERS_INST = GLC_BoundingBox \
                GLC_Polygon \
                GLC_OpenGLViewInterface \
                GLC_WorldToCollada \
-               GLC_Image
+               GLC_Image \
+               GLC_OccurrenceIndex \
+               GLC_ResidencyManager \
+               GLC_StaticBatch \
+               GLC_DepthSorter \
+               GLC_OcclusionCuller \
+               GLC_LodSelector \
+               GLC_FrustumCuller \
+               GLC_PointCloudBuilder \
+               GLC_StreamedPointCloud \
+               GLC_BufferedXmlWriter \
+               GLC_InputData \
+               GLC_WorldToGlcw \
+               GLC_GlcwToWorld \
+               GLC_SectionEngine \
+               GLC_AabbTree \
+               GLC_MeshBvh \
+               GLC_KdTree \
+               GLC_ClashDetector
 
 
 include (../../install.pri)
@@ -195,6 +195,10 @@ public:
 	inline bool isDirect() const
 	{return (m_Type & Direct);}
 
+	//! Return true if this matrix is affine (Last row is 0, 0, 0, 1)
+	inline bool isAffine() const
+	{return (m_Type == Identity) || ((m_Matrix[3] == 0.0) && (m_Matrix[7] == 0.0) && (m_Matrix[11] == 0.0) && (m_Matrix[15] == 1.0));}
+
 	//! Return this matrix trace
 	inline double trace() const
 	{return (m_Matrix[0] + m_Matrix[5] + m_Matrix[10] + m_Matrix[15]);}
@@ -235,6 +239,7 @@ public:
 	inline GLC_Matrix4x4& setMatScaling(const double, const double, const double);
 
 	//! Inverse this Matrix and return a reference to this matrix
+	/*! Identity and affine matrices are inverted without the general co-matrix*/
 	inline GLC_Matrix4x4& invert(void);
 
 	//! Set this matrix to the identify matrix and return a reference to this matrix
@@ -262,6 +267,9 @@ private:
 	//! Compute Sub 3X3 matrix given by 2 int and set the given double pointeur
 	inline void getSubMat(const int, const int, double *) const;
 
+	//! Inverse this affine Matrix and return a reference to this matrix
+	inline GLC_Matrix4x4& invertAffine(void);
+
 	//! Return the transpose matrix of this matrix
 	inline GLC_Matrix4x4 getTranspose(void) const;
 
@@ -604,6 +612,9 @@ GLC_Matrix4x4& GLC_Matrix4x4::setMatScaling(const double sX, const double sY, co
 
 GLC_Matrix4x4& GLC_Matrix4x4::invert(void)
 {
+	if (m_Type == Identity) return *this;
+	if (isAffine()) return invertAffine();
+
 	const double det= determinant();
 
 	// Test if the inverion is possible
@@ -620,6 +631,41 @@ GLC_Matrix4x4& GLC_Matrix4x4::invert(void)
 	return *this;
 }
 
+GLC_Matrix4x4& GLC_Matrix4x4::invertAffine(void)
+{
+	// Co-factors of the linear part
+	const double c00= m_Matrix[5] * m_Matrix[10] - m_Matrix[9] * m_Matrix[6];
+	const double c01= m_Matrix[9] * m_Matrix[2] - m_Matrix[1] * m_Matrix[10];
+	const double c02= m_Matrix[1] * m_Matrix[6] - m_Matrix[5] * m_Matrix[2];
+	const double c10= m_Matrix[8] * m_Matrix[6] - m_Matrix[4] * m_Matrix[10];
+	const double c11= m_Matrix[0] * m_Matrix[10] - m_Matrix[8] * m_Matrix[2];
+	const double c12= m_Matrix[4] * m_Matrix[2] - m_Matrix[0] * m_Matrix[6];
+	const double c20= m_Matrix[4] * m_Matrix[9] - m_Matrix[8] * m_Matrix[5];
+	const double c21= m_Matrix[8] * m_Matrix[1] - m_Matrix[0] * m_Matrix[9];
+	const double c22= m_Matrix[0] * m_Matrix[5] - m_Matrix[4] * m_Matrix[1];
+
+	const double det= m_Matrix[0] * c00 + m_Matrix[4] * c01 + m_Matrix[8] * c02;
+
+	// Test if the inverion is possible
+	if (det == 0.0) return *this;
+
+	const double invDet= 1.0 / det;
+	const double tx= m_Matrix[12];
+	const double ty= m_Matrix[13];
+	const double tz= m_Matrix[14];
+
+	// The inverse of the linear part is the transposed co-matrix divided by the determinant
+	m_Matrix[0]= c00 * invDet; m_Matrix[4]= c10 * invDet; m_Matrix[8]=  c20 * invDet;
+	m_Matrix[1]= c01 * invDet; m_Matrix[5]= c11 * invDet; m_Matrix[9]=  c21 * invDet;
+	m_Matrix[2]= c02 * invDet; m_Matrix[6]= c12 * invDet; m_Matrix[10]= c22 * invDet;
+
+	m_Matrix[12]= -(m_Matrix[0] * tx + m_Matrix[4] * ty + m_Matrix[8] * tz);
+	m_Matrix[13]= -(m_Matrix[1] * tx + m_Matrix[5] * ty + m_Matrix[9] * tz);
+	m_Matrix[14]= -(m_Matrix[2] * tx + m_Matrix[6] * ty + m_Matrix[10] * tz);
+
+	return *this;
+}
+
 GLC_Matrix4x4& GLC_Matrix4x4::setToIdentity()
 {
 	m_Matrix[0]= 1.0; m_Matrix[4]= 0.0; m_Matrix[8]=  0.0; m_Matrix[12]= 0.0;
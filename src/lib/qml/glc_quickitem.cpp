@@ -180,6 +180,38 @@ void GLC_QuickItem::setDefaultUpVector(const QVector3D &vect)
     }
 }
 
+QVariantList GLC_QuickItem::findOccurrences(const QString& text, int maxCount) const
+{
+    QVariantList subject;
+    if (!m_Viewhandler.isNull() && !text.isEmpty())
+    {
+        const GLC_OccurrenceIndex* pIndex= m_Viewhandler->world().worldHandle()->occurrenceIndex();
+        const QList<GLC_uint> idList(pIndex->occurrencesIdFromNamePrefix(text, maxCount));
+        for (GLC_uint id : idList)
+        {
+            subject.append(id);
+        }
+    }
+
+    return subject;
+}
+
+QVariantList GLC_QuickItem::findOccurrencesByAttribute(const QString& attributeName, const QString& value) const
+{
+    QVariantList subject;
+    if (!m_Viewhandler.isNull())
+    {
+        const GLC_OccurrenceIndex* pIndex= m_Viewhandler->world().worldHandle()->occurrenceIndex();
+        const QList<GLC_uint> idList(pIndex->occurrencesIdFromAttribute(attributeName, value));
+        for (GLC_uint id : idList)
+        {
+            subject.append(id);
+        }
+    }
+
+    return subject;
+}
+
 void GLC_QuickItem::select(uint id)
 {
     if (!m_Viewhandler.isNull())
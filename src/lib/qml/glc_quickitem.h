@@ -106,6 +106,12 @@ public:
     GLC_QuickSelection* selection() const
     {return m_pQuickSelection;}
 
+    //! Return the id of occurrences which name starts with the given text (case insensitive)
+    Q_INVOKABLE QVariantList findOccurrences(const QString& text, int maxCount= 100) const;
+
+    //! Return the id of occurrences which have the given attribute value
+    Q_INVOKABLE QVariantList findOccurrencesByAttribute(const QString& attributeName, const QString& value) const;
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -30,8 +30,11 @@
 #include "../shading/glc_shader.h"
 #include "../viewport/glc_viewport.h"
 #include "glc_spacepartitioning.h"
+#include "glc_occlusionculler.h"
 #include "../glc_context.h"
 #include "../glc_contextmanager.h"
+#include "../glc_renderprofiler.h"
+#include "../shading/glc_oitrenderer.h"
 
 //////////////////////////////////////////////////////////////////////
 // Constructor/Destructor
@@ -49,8 +52,14 @@ GLC_3DViewCollection::GLC_3DViewCollection()
     , m_ViewportChanged(true)
     , m_pSpacePartitioning(nullptr)
     , m_UseSpacePartitioning(false)
+    , m_pOcclusionCuller(nullptr)
+    , m_UseOcclusionCulling(false)
     , m_IsViewable(true)
     , m_UseOrderRendering(false)
+    , m_TransparencyMode(UnsortedTransparency)
+    , m_DepthSorter()
+    , m_LodSelector()
+    , m_UseLodSelector(false)
 {
 }
 
@@ -66,8 +75,14 @@ GLC_3DViewCollection::GLC_3DViewCollection(const GLC_3DViewCollection& other)
     , m_ViewportChanged(other.m_ViewportChanged)
     , m_pSpacePartitioning(nullptr)
     , m_UseSpacePartitioning(false)
+    , m_pOcclusionCuller(nullptr)
+    , m_UseOcclusionCulling(false)
     , m_IsViewable(other.m_IsViewable)
     , m_UseOrderRendering(other.m_UseOrderRendering)
+    , m_TransparencyMode(other.m_TransparencyMode)
+    , m_DepthSorter()
+    , m_LodSelector(other.m_LodSelector)
+    , m_UseLodSelector(other.m_UseLodSelector)
 {
     PointerViewInstanceHash::const_iterator iInstance= other.m_3DViewInstanceHash.constBegin();
     while (iInstance != other.m_3DViewInstanceHash.constEnd())
@@ -167,6 +182,11 @@ bool GLC_3DViewCollection::add(GLC_3DViewInstance* pInstance, GLC_uint shaderID)
     if (!m_3DViewInstanceHash.contains(key))
     {
         m_3DViewInstanceHash.insert(key, pInstance);
+        if (nullptr != m_pSpacePartitioning)
+        {
+            m_pSpacePartitioning->insertInstance(pInstance);
+            m_ViewportChanged= true;
+        }
         // Chose the hash where instance is
         if(0 != shaderID)
         {
@@ -271,7 +291,11 @@ bool GLC_3DViewCollection::remove(GLC_uint key)
 		}
 
         m_MainInstances.remove(key);
-        delete m_3DViewInstanceHash.take(key);		// Delete the conteneur
+        GLC_3DViewInstance* pInstance= m_3DViewInstanceHash.take(key);
+        if (nullptr != m_pSpacePartitioning) m_pSpacePartitioning->removeInstance(pInstance);
+        delete pInstance;		// Delete the conteneur
+        m_DepthSorter.invalidate();
+        if (nullptr != m_pOcclusionCuller) m_pOcclusionCuller->removeOccluder(key);
 
         subject= true;
 	}
@@ -283,6 +307,16 @@ bool GLC_3DViewCollection::remove(GLC_uint key)
     return subject;
 }
 
+void GLC_3DViewCollection::instanceMoved(GLC_uint key)
+{
+    Q_ASSERT(m_3DViewInstanceHash.contains(key));
+    if (nullptr != m_pSpacePartitioning)
+    {
+        m_pSpacePartitioning->moveInstance(m_3DViewInstanceHash.value(key));
+        m_ViewportChanged= true;
+    }
+}
+
 void GLC_3DViewCollection::clear(void)
 {
 	// Clear Selected node Hash Table
@@ -297,10 +331,15 @@ void GLC_3DViewCollection::clear(void)
 	// Clear main Hash table
     qDeleteAll(m_3DViewInstanceHash);
     m_3DViewInstanceHash.clear();
+    m_DepthSorter.invalidate();
 
 	// delete the space partitioning
 	delete m_pSpacePartitioning;
     m_pSpacePartitioning= nullptr;
+
+    delete m_pOcclusionCuller;
+    m_pOcclusionCuller= nullptr;
+    m_UseOcclusionCulling= false;
 }
 
 bool GLC_3DViewCollection::select(GLC_uint key, bool primitive)
@@ -431,6 +470,7 @@ void GLC_3DViewCollection::setVisibility(const GLC_uint key, const bool visibili
 	if (iNode != m_3DViewInstanceHash.end())
 	{	// Ok, the key exist
         iNode.value()->setVisibility(visibility);
+        if (nullptr != m_pOcclusionCuller) m_pOcclusionCuller->invalidate();
 	}
 }
 
@@ -458,6 +498,11 @@ void GLC_3DViewCollection::hideAll()
 
 void GLC_3DViewCollection::setLodUsage(const bool usage, GLC_Viewport* pView)
 {
+    // Instances are drawn with their finest LOD again
+    if (!usage && m_UseLod)
+    {
+        GLC_LodSelector::clearLods(this);
+    }
     m_UseLod= usage;
     if (m_pViewport != pView)
     {
@@ -475,6 +520,48 @@ void GLC_3DViewCollection::bindSpacePartitioning(GLC_SpacePartitioning* pSpacePa
     m_pSpacePartitioning->set3DViewCollection(this);
 }
 
+void GLC_3DViewCollection::bindOcclusionCuller(GLC_OcclusionCuller* pOcclusionCuller)
+{
+    Q_ASSERT(nullptr != pOcclusionCuller);
+
+    unbindOcclusionCuller();
+    m_pOcclusionCuller= pOcclusionCuller;
+    m_pOcclusionCuller->set3DViewCollection(this);
+}
+
+void GLC_3DViewCollection::unbindOcclusionCuller()
+{
+    if (nullptr != m_pOcclusionCuller)
+    {
+        m_pOcclusionCuller->restoreOccludedInstances();
+        delete m_pOcclusionCuller;
+        m_pOcclusionCuller= nullptr;
+    }
+    m_UseOcclusionCulling= false;
+}
+
+void GLC_3DViewCollection::setOcclusionCullingUsage(bool use)
+{
+    if (!use && (nullptr != m_pOcclusionCuller))
+    {
+        m_pOcclusionCuller->restoreOccludedInstances();
+    }
+    else if (use && (nullptr != m_pOcclusionCuller))
+    {
+        m_pOcclusionCuller->invalidate();
+    }
+    m_UseOcclusionCulling= use;
+}
+
+void GLC_3DViewCollection::setLodSelectorUsage(bool use)
+{
+    if (!use && m_UseLodSelector)
+    {
+        GLC_LodSelector::clearLods(this);
+    }
+    m_UseLodSelector= use;
+}
+
 void GLC_3DViewCollection::unbindSpacePartitioning()
 {
 	delete m_pSpacePartitioning;
@@ -492,11 +579,26 @@ void GLC_3DViewCollection::unbindSpacePartitioning()
 
 void GLC_3DViewCollection::updateInstanceViewableState(GLC_Matrix4x4* pMatrix)
 {
-    if ((nullptr != m_pViewport) && m_UseSpacePartitioning && (nullptr != m_pSpacePartitioning))
+    const bool useSpacePartitioning= m_UseSpacePartitioning && (nullptr != m_pSpacePartitioning);
+    const bool useOcclusionCulling= m_UseOcclusionCulling && (nullptr != m_pOcclusionCuller);
+    if ((nullptr != m_pViewport) && (useSpacePartitioning || useOcclusionCulling))
 	{
-        if (m_pViewport->updateFrustum(pMatrix) || m_ViewportChanged)
+        bool updateNeeded= m_pViewport->updateFrustum(pMatrix) || m_ViewportChanged;
+        // Moved instances may be hidden or revealed by the occluders
+        if (useOcclusionCulling) updateNeeded= updateNeeded || m_pOcclusionCuller->isOutdated();
+
+        if (updateNeeded)
         {
-            m_pSpacePartitioning->updateViewableInstances(m_pViewport->frustum());
+            GLC_RenderProfiler::ScopedTimer profilerTimer(GLC_RenderProfiler::CullingStage);
+            // The frustum culling resets the viewable state of occluded instances
+            if (useSpacePartitioning) m_pSpacePartitioning->updateViewableInstances(m_pViewport->frustum());
+            else m_pOcclusionCuller->restoreOccludedInstances();
+
+            if (useOcclusionCulling)
+            {
+                const GLC_Matrix4x4 compositionMatrix((nullptr != pMatrix) ? *pMatrix : m_pViewport->compositionMatrix());
+                m_pOcclusionCuller->updateViewableInstances(compositionMatrix);
+            }
             m_ViewportChanged= false;
         }
 	}
@@ -506,6 +608,7 @@ void GLC_3DViewCollection::updateInstanceViewableState(const GLC_Frustum& frustu
 {
     if (nullptr != m_pSpacePartitioning)
     {
+        GLC_RenderProfiler::ScopedTimer profilerTimer(GLC_RenderProfiler::CullingStage);
         m_pSpacePartitioning->updateViewableInstances(frustum);
         m_ViewportChanged= false;
     }
@@ -692,6 +795,19 @@ void GLC_3DViewCollection::render(GLuint groupId, glc::RenderFlag renderFlag)
     GLC_Context* pContext= GLC_ContextManager::instance()->currentContext();
 	if (!isEmpty() && m_IsViewable)
 	{
+        GLC_RenderProfiler::ScopedTimer profilerTimer(GLC_RenderProfiler::TraversalStage);
+        if (GLC_RenderProfiler::isRecording() && (groupId == 0) && (renderFlag != glc::TransparentRenderFlag))
+        {
+            addViewableStateToProfiler();
+        }
+
+        // The selected LODs are used by the following groups and passes
+        if (m_UseLodSelector && m_UseLod && (nullptr != m_pViewport) && (groupId == 0) && (renderFlag != glc::TransparentRenderFlag)
+                && !GLC_State::isInSelectionMode())
+        {
+            m_LodSelector.selectLods(this, m_pViewport);
+        }
+
 		if (renderFlag == glc::WireRenderFlag)
 		{
 	        glEnable(GL_POLYGON_OFFSET_FILL);
@@ -701,7 +817,9 @@ void GLC_3DViewCollection::render(GLuint groupId, glc::RenderFlag renderFlag)
 		{
 			glDisable(GL_BLEND);
             pContext->glcEnableLighting(false);
-			glDisable(GL_TEXTURE_2D);
+            pContext->renderStateCache()->glcDisable(GL_TEXTURE_2D);
+            // Selection colors overwrite the current material
+            pContext->renderStateCache()->invalidateMaterial();
 		}
 		else
 		{
@@ -719,11 +837,15 @@ void GLC_3DViewCollection::renderShaderGroup(glc::RenderFlag renderFlag)
 {
 	if (!isEmpty() && m_IsViewable)
 	{
+        GLC_RenderProfiler::ScopedTimer profilerTimer(GLC_RenderProfiler::TraversalStage);
 		if (GLC_State::isInSelectionMode())
 		{
+            GLC_Context* pContext= GLC_ContextManager::instance()->currentContext();
 			glDisable(GL_BLEND);
-            GLC_ContextManager::instance()->currentContext()->glcEnableLighting(false);
-			glDisable(GL_TEXTURE_2D);
+            pContext->glcEnableLighting(false);
+            pContext->renderStateCache()->glcDisable(GL_TEXTURE_2D);
+            // Selection colors overwrite the current material
+            pContext->renderStateCache()->invalidateMaterial();
 		}
 
         HashList::const_iterator iEntry= m_ShadedPointerViewInstanceHash.constBegin();
@@ -737,15 +859,26 @@ void GLC_3DViewCollection::renderShaderGroup(glc::RenderFlag renderFlag)
 
 void GLC_3DViewCollection::glDraw(GLC_uint groupId, glc::RenderFlag renderFlag)
 {
+	const bool sortTransparency= (renderFlag == glc::TransparentRenderFlag) && (groupId == 0)
+			&& !GLC_State::isInSelectionMode() && (m_TransparencyMode != UnsortedTransparency);
+	GLC_OitRenderer* pOitRenderer= nullptr;
+
 	// Set render Mode and OpenGL state
 	if (!GLC_State::isInSelectionMode() && (groupId == 0))
 	{
 		if (renderFlag == glc::TransparentRenderFlag)
 		{
-	        glEnable(GL_BLEND);
-	        glDepthMask(GL_FALSE);
-	        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
+			if (m_TransparencyMode == WeightedBlendedTransparency)
+			{
+				pOitRenderer= GLC_ContextManager::instance()->currentContext()->oitRenderer();
+				if (!pOitRenderer->glBeginAccumulation()) pOitRenderer= nullptr;
+			}
+			if (nullptr == pOitRenderer)
+			{
+				glEnable(GL_BLEND);
+				glDepthMask(GL_FALSE);
+				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			}
 		}
 		else
 		{
@@ -758,8 +891,15 @@ void GLC_3DViewCollection::glDraw(GLC_uint groupId, glc::RenderFlag renderFlag)
 	// Normal GLC_3DViewInstance
 	if ((groupId == 0) && !m_MainInstances.isEmpty())
 	{
-		glDrawInstancesOf(&m_MainInstances, renderFlag);
-
+		// The order doesn't matter with order independent transparency
+		if (sortTransparency && (nullptr == pOitRenderer))
+		{
+			glDrawSortedTransparentInstancesOf(&m_MainInstances);
+		}
+		else
+		{
+			glDrawInstancesOf(&m_MainInstances, renderFlag);
+		}
 	}
 	// Selected GLC_3DVIewInstance
 	else if ((groupId == 1) && !m_SelectedInstances.isEmpty())
@@ -783,6 +923,11 @@ void GLC_3DViewCollection::glDraw(GLC_uint groupId, glc::RenderFlag renderFlag)
 	    }
 	}
 
+	if (nullptr != pOitRenderer)
+	{
+		pOitRenderer->glEndAccumulation();
+	}
+
 	// Restore OpenGL state
 	if (renderFlag && !GLC_State::isInSelectionMode() && (groupId == 0))
 	{
@@ -791,3 +936,53 @@ void GLC_3DViewCollection::glDraw(GLC_uint groupId, glc::RenderFlag renderFlag)
 		glEnable(GL_DEPTH_TEST);
 	}
 }
+
+void GLC_3DViewCollection::glDrawSortedTransparentInstancesOf(PointerViewInstanceHash* pHash)
+{
+    GLC_Context* pContext= GLC_ContextManager::instance()->currentContext();
+
+    // The hash order is stable while the hash is not modified
+    m_DepthSorter.beginUpdate(pContext->modelViewMatrix());
+    PointerViewInstanceHash::const_iterator iEntry= pHash->constBegin();
+    while (iEntry != pHash->constEnd())
+    {
+        GLC_3DViewInstance* pInstance= iEntry.value();
+        if ((pInstance->viewableFlag() != GLC_3DViewInstance::NoViewable) && (pInstance->isVisible() == m_IsInShowSate)
+                && pInstance->hasTransparentMaterials())
+        {
+            m_DepthSorter.addCandidate(pInstance);
+        }
+        ++iEntry;
+    }
+    m_DepthSorter.endUpdate();
+
+    const QVector<GLC_3DViewInstance*>& sortedInstances= m_DepthSorter.sortedInstances();
+    const int count= sortedInstances.size();
+    for (int i= 0; i < count; ++i)
+    {
+        sortedInstances.at(i)->render(glc::TransparentRenderFlag, m_UseLod, m_pViewport);
+    }
+}
+
+void GLC_3DViewCollection::addViewableStateToProfiler() const
+{
+    quint64 viewableCount= 0;
+    quint64 culledCount= 0;
+    PointerViewInstanceHash::const_iterator iEntry= m_3DViewInstanceHash.constBegin();
+    while (iEntry != m_3DViewInstanceHash.constEnd())
+    {
+        const GLC_3DViewInstance* pInstance= iEntry.value();
+        if (pInstance->isVisible() == m_IsInShowSate)
+        {
+            if (pInstance->viewableFlag() != GLC_3DViewInstance::NoViewable) ++viewableCount;
+            else ++culledCount;
+        }
+        ++iEntry;
+    }
+    GLC_RenderProfiler::addCount(GLC_RenderProfiler::ViewableInstanceCounter, viewableCount);
+    GLC_RenderProfiler::addCount(GLC_RenderProfiler::CulledInstanceCounter, culledCount);
+    if (m_UseOcclusionCulling && (nullptr != m_pOcclusionCuller))
+    {
+        GLC_RenderProfiler::addCount(GLC_RenderProfiler::OccludedInstanceCounter, m_pOcclusionCuller->culledCount());
+    }
+}
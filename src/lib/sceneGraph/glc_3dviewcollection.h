@@ -28,12 +28,15 @@
 
 #include <QHash>
 #include "glc_3dviewinstance.h"
+#include "glc_depthsorter.h"
+#include "glc_lodselector.h"
 #include "../glc_global.h"
 #include "../viewport/glc_frustum.h"
 
 #include "../glc_config.h"
 
 class GLC_SpacePartitioning;
+class GLC_OcclusionCuller;
 class GLC_Material;
 class GLC_Shader;
 class GLC_Viewport;
@@ -59,6 +62,18 @@ typedef QHash<GLC_uint, GLC_uint> ShaderIdToInstancesId;
 
 class GLC_LIB_EXPORT GLC_3DViewCollection
 {
+public:
+    //! Rendering of transparent primitives of the main group
+    enum TransparencyMode
+    {
+        //! Instances are blended in collection order
+        UnsortedTransparency,
+        //! Instances are blended from back to front
+        SortedTransparency,
+        //! Weighted blended order independent transparency, sorted if not supported
+        WeightedBlendedTransparency
+    };
+
 
 //////////////////////////////////////////////////////////////////////
 /*! @name Constructor / Destructor */
@@ -156,6 +171,22 @@ public:
     GLC_SpacePartitioning* spacePartitioningHandle()
 	{return m_pSpacePartitioning;}
 
+    //! Return true if the occlusion culling is used
+    bool occlusionCullingIsUsed() const
+    {return m_UseOcclusionCulling;}
+
+    //! Return an handle to the occlusion culler
+    GLC_OcclusionCuller* occlusionCullerHandle()
+    {return m_pOcclusionCuller;}
+
+    //! Return true if the LOD of bodies is selected from their screen space error
+    bool lodSelectorIsUsed() const
+    {return m_UseLodSelector;}
+
+    //! Return an handle to the LOD selector
+    GLC_LodSelector* lodSelectorHandle()
+    {return &m_LodSelector;}
+
 	//! Return true if the collection is viewable
     bool isViewable() const
 	{return m_IsViewable;}
@@ -163,6 +194,10 @@ public:
     bool useOrderRendering() const
     {return m_UseOrderRendering;}
 
+    //! Return the transparency mode of this collection
+    TransparencyMode transparencyMode() const
+    {return m_TransparencyMode;}
+
     int faceCount() const;
 
 //@}
@@ -207,6 +242,10 @@ public:
 	 * return true if success false otherwise*/
     bool remove(GLC_uint key);
 
+    //! Update the space partitioning and the viewable state after the given instance has moved
+    /*! Must be called when the matrix or the geometry of the instance have changed*/
+    void instanceMoved(GLC_uint key);
+
 	//! Remove and delete all GLC_Geometry from the collection
 	void clear(void);
 
@@ -239,6 +278,7 @@ public:
 	{m_IsInShowSate= !m_IsInShowSate;}
 
 	//! Set the LOD usage
+	/*! When the LOD usage is disabled, the LOD of all bodies is reset to the finest one*/
     void setLodUsage(const bool usage, GLC_Viewport* pView);
 
 	//! Bind the space partitioning
@@ -251,9 +291,23 @@ public:
     void setSpacePartitionningUsage(bool use)
 	{m_UseSpacePartitioning= use;}
 
+    //! Bind the occlusion culler, the collection takes its ownership
+    void bindOcclusionCuller(GLC_OcclusionCuller* pOcclusionCuller);
+
+    //! Unbind and delete the occlusion culler
+    void unbindOcclusionCuller();
+
+    //! Use the occlusion culler
+    void setOcclusionCullingUsage(bool use);
+
+    //! Select the LOD of bodies from their screen space error
+    /*! Used only if the LOD usage is set, see setLodUsage()*/
+    void setLodSelectorUsage(bool use);
+
 	//! Update the instance viewable state
 	/*! Update the frustrum culling from the viewport
-	 * If the specified matrix pointer is not null*/
+	 * If the specified matrix pointer is not null
+	 * then the occlusion culling if it is used*/
     void updateInstanceViewableState(GLC_Matrix4x4* pMatrix= nullptr);
 
 	//! Update the instance viewable state with the specified frustum
@@ -275,6 +329,11 @@ public:
     void setOrderRenderingUsage(bool use)
     {m_UseOrderRendering= use;}
 
+    //! Set the transparency mode of this collection
+    /*! The sorted modes override the order rendering of transparent instances*/
+    void setTransparencyMode(TransparencyMode mode)
+    {m_TransparencyMode= mode;}
+
     void setMeshWireColorAndLineWidth(const QColor& color, GLfloat lineWidth);
 
 //@}
@@ -311,6 +370,12 @@ private:
     //! Draw orded instances of a PointerViewInstanceHash
     inline void glDrawOrderedInstancesOf(PointerViewInstanceHash*, glc::RenderFlag);
 
+    //! Draw the transparent instances of a PointerViewInstanceHash from back to front
+    void glDrawSortedTransparentInstancesOf(PointerViewInstanceHash*);
+
+    //! Add the number of viewable and culled instances to the render profiler
+    void addViewableStateToProfiler() const;
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -350,10 +415,28 @@ private:
 	//! The space partition usage
 	bool m_UseSpacePartitioning;
 
+    //! The occlusion culler
+    GLC_OcclusionCuller* m_pOcclusionCuller;
+
+    //! The occlusion culling usage
+    bool m_UseOcclusionCulling;
+
 	//! Viewable state
 	bool m_IsViewable;
 
     bool m_UseOrderRendering;
+
+    //! The transparency mode
+    TransparencyMode m_TransparencyMode;
+
+    //! The depth sorter of transparent instances
+    GLC_DepthSorter m_DepthSorter;
+
+    //! The screen space error LOD selector
+    GLC_LodSelector m_LodSelector;
+
+    //! The LOD selector usage
+    bool m_UseLodSelector;
 };
 
 // Draw instances of a PointerViewInstanceHash
@@ -27,10 +27,14 @@
 #include "../viewport/glc_viewport.h"
 #include "../glc_state.h"
 #include "../glc_renderstate.h"
+#include "../glc_renderprofiler.h"
 
 //! The global default LOD
 int GLC_3DViewInstance::m_GlobalDefaultLOD= 10;
 
+//! The revision of instances matrix
+QAtomicInteger<quint64> GLC_3DViewInstance::m_MatrixRevision(0);
+
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
@@ -49,6 +53,7 @@ GLC_3DViewInstance::GLC_3DViewInstance()
     , m_ViewableGeomFlag()
     , m_pRenderState(new GLC_RenderState)
     , m_OrderWeight(0)
+    , m_BodyLodValues()
 {
 	// Encode Color Id
 	glc::encodeRgbId(m_Uid, m_colorId);
@@ -68,6 +73,7 @@ GLC_3DViewInstance::GLC_3DViewInstance(GLC_Geometry* pGeom)
     , m_ViewableGeomFlag()
     , m_pRenderState(new GLC_RenderState)
     , m_OrderWeight(0)
+    , m_BodyLodValues()
 {
 	// Encode Color Id
 	glc::encodeRgbId(m_Uid, m_colorId);
@@ -88,6 +94,7 @@ GLC_3DViewInstance::GLC_3DViewInstance(GLC_Geometry* pGeom, GLC_uint id)
     , m_ViewableGeomFlag()
     , m_pRenderState(new GLC_RenderState)
     , m_OrderWeight(0)
+    , m_BodyLodValues()
 {
 	// Encode Color Id
 	glc::encodeRgbId(m_Uid, m_colorId);
@@ -108,6 +115,7 @@ GLC_3DViewInstance::GLC_3DViewInstance(const GLC_3DRep& rep)
     , m_ViewableGeomFlag()
     , m_pRenderState(new GLC_RenderState)
     , m_OrderWeight(0)
+    , m_BodyLodValues()
 {
 	// Encode Color Id
 	glc::encodeRgbId(m_Uid, m_colorId);
@@ -127,6 +135,7 @@ GLC_3DViewInstance::GLC_3DViewInstance(const GLC_3DRep& rep, GLC_uint id)
     , m_ViewableGeomFlag()
     , m_pRenderState(new GLC_RenderState)
     , m_OrderWeight(0)
+    , m_BodyLodValues()
 {
 	// Encode Color Id
 	glc::encodeRgbId(m_Uid, m_colorId);
@@ -147,6 +156,7 @@ GLC_3DViewInstance::GLC_3DViewInstance(const GLC_3DViewInstance& inputNode)
     , m_ViewableGeomFlag(inputNode.m_ViewableGeomFlag)
     , m_pRenderState(inputNode.m_pRenderState->clone())
     , m_OrderWeight(inputNode.m_OrderWeight)
+    , m_BodyLodValues(inputNode.m_BodyLodValues)
 
 {
 	// Encode Color Id
@@ -177,6 +187,7 @@ GLC_3DViewInstance& GLC_3DViewInstance::operator=(const GLC_3DViewInstance& inpu
 		}
 		m_AbsoluteMatrix= inputNode.m_AbsoluteMatrix;
 		m_IsBoundingBoxValid= inputNode.m_IsBoundingBoxValid;
+		++m_MatrixRevision;
 		m_RenderProperties= inputNode.m_RenderProperties;
 		m_IsVisible= inputNode.m_IsVisible;
 		m_DefaultLOD= inputNode.m_DefaultLOD;
@@ -186,6 +197,7 @@ GLC_3DViewInstance& GLC_3DViewInstance::operator=(const GLC_3DViewInstance& inpu
         delete m_pRenderState;
         m_pRenderState= inputNode.m_pRenderState->clone();
         m_OrderWeight= inputNode.m_OrderWeight;
+        m_BodyLodValues= inputNode.m_BodyLodValues;
 
 		//qDebug() << "GLC_3DViewInstance::operator= :ID = " << m_Uid;
 		//qDebug() << "Number of instance" << (*m_pNumberOfInstance);
@@ -278,11 +290,26 @@ int GLC_3DViewInstance::globalDefaultLod()
     return m_GlobalDefaultLOD;
 }
 
+quint64 GLC_3DViewInstance::matrixRevision()
+{
+    return m_MatrixRevision.loadAcquire();
+}
+
 bool GLC_3DViewInstance::firstIsLower(GLC_3DViewInstance* pInstance1, GLC_3DViewInstance* pInstance2)
 {
     return (pInstance1->m_OrderWeight < pInstance2->m_OrderWeight);
 }
 
+void GLC_3DViewInstance::setBodyLodValue(int index, int value)
+{
+    Q_ASSERT((index >= 0) && (index < numberOfBody()));
+    if (m_BodyLodValues.size() != numberOfBody())
+    {
+        m_BodyLodValues.fill(-1, numberOfBody());
+    }
+    m_BodyLodValues[index]= value;
+}
+
 void GLC_3DViewInstance::setMeshWireColorAndLineWidth(const QColor& color, GLfloat lineWidth)
 {
     m_3DRep.setMeshWireColorAndLineWidth(color, lineWidth);
@@ -321,6 +348,7 @@ GLC_3DViewInstance& GLC_3DViewInstance::multMatrix(const GLC_Matrix4x4 &MultMat)
 {
 	m_AbsoluteMatrix= MultMat * m_AbsoluteMatrix;
 	m_IsBoundingBoxValid= false;
+	++m_MatrixRevision;
 
 	return *this;
 }
@@ -330,6 +358,7 @@ GLC_3DViewInstance& GLC_3DViewInstance::setMatrix(const GLC_Matrix4x4 &SetMat)
 {
 	m_AbsoluteMatrix= SetMat;
 	m_IsBoundingBoxValid= false;
+	++m_MatrixRevision;
 
 	return *this;
 }
@@ -339,6 +368,7 @@ GLC_3DViewInstance& GLC_3DViewInstance::resetMatrix(void)
 {
 	m_AbsoluteMatrix.setToIdentity();
 	m_IsBoundingBoxValid= false;
+	++m_MatrixRevision;
 
 	return *this;
 }
@@ -387,7 +417,9 @@ void GLC_3DViewInstance::render(glc::RenderFlag renderFlag, bool useLod, GLC_Vie
             {
                 if (m_ViewableGeomFlag.at(i))
                 {
-                    const int lodValue= choseLod(m_3DRep.geomAt(i)->boundingBox(), pView, useLod);
+                    // The LOD selected by GLC_LodSelector if any
+                    int lodValue= bodyLodValue(i);
+                    if (lodValue < 0) lodValue= choseLod(m_3DRep.geomAt(i)->boundingBox(), pView, useLod);
                     if (lodValue <= 100)
                     {
                         m_3DRep.geomAt(i)->setCurrentLod(lodValue);
@@ -560,6 +592,8 @@ void GLC_3DViewInstance::clear()
 int GLC_3DViewInstance::choseLod(const GLC_BoundingBox& boundingBox, GLC_Viewport* pView, bool useLod)
 {
     if (nullptr == pView) return 0;
+    GLC_RenderProfiler::ScopedTimer profilerTimer(GLC_RenderProfiler::LodSelectionStage);
+
 	double pixelCullingRatio= 0.0;
 	if (useLod)
 	{
@@ -592,6 +626,7 @@ int GLC_3DViewInstance::choseLod(const GLC_BoundingBox& boundingBox, GLC_Viewpor
 	{
 		ratio= static_cast<double>(m_DefaultLOD);
 	}
+    GLC_RenderProfiler::addLod(static_cast<int>(ratio));
 
 	return static_cast<int>(ratio);
 }
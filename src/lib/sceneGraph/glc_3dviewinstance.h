@@ -25,6 +25,8 @@
 #ifndef GLC_3DVIEWINSTANCE_H_
 #define GLC_3DVIEWINSTANCE_H_
 
+#include <QAtomicInteger>
+
 #include "../glc_global.h"
 #include "../glc_boundingbox.h"
 #include "../glc_object.h"
@@ -170,6 +172,10 @@ public:
     bool isGeomViewable(int index) const
 	{return m_ViewableGeomFlag.at(index);}
 
+    //! Return the LOD value of the body at the index set by setBodyLodValue(), -1 if not set
+    int bodyLodValue(int index) const
+    {return (index < m_BodyLodValues.size()) ? m_BodyLodValues.at(index) : -1;}
+
 	//! Get number of faces
     unsigned int numberOfFaces() const
 	{return m_3DRep.faceCount();}
@@ -201,6 +207,9 @@ public:
 	//! Return the global default LOD value
     static int globalDefaultLod();
 
+    //! Return the revision of instances matrix, incremented each time the matrix of an instance changes
+    static quint64 matrixRevision();
+
     static bool firstIsLower(GLC_3DViewInstance* pInstance1, GLC_3DViewInstance* pInstance2);
 
     int orderWeight() const
@@ -279,6 +288,14 @@ public:
     void setGeomViewable(int index, bool flag)
 	{m_ViewableGeomFlag[index]= flag;}
 
+    //! Set the LOD value of the body at the index used by render() with LOD
+    /*! The value is between 0 and 100, above 100 the body is not rendered*/
+    void setBodyLodValue(int index, int value);
+
+    //! Remove the LOD values set by setBodyLodValue(), render() choses the LOD of bodies
+    void clearBodyLodValues()
+    {m_BodyLodValues.clear();}
+
 
 	//! Set the global default LOD value
     static void setGlobalDefaultLod(int);
@@ -379,8 +396,14 @@ private:
 
     int m_OrderWeight;
 
+    //! LOD value of bodies set by setBodyLodValue()
+    QVector<int> m_BodyLodValues;
+
 	//! The global default LOD
 	static int m_GlobalDefaultLOD;
+
+    //! The revision of instances matrix
+    static QAtomicInteger<quint64> m_MatrixRevision;
 };
 
 // Return true if the all instance's mesh are transparent
@@ -0,0 +1,415 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_clashdetector.cpp implementation of the GLC_ClashDetector class.
+
+#include <algorithm>
+
+#include <QSet>
+#include <QtConcurrent>
+
+#include "glc_clashdetector.h"
+#include "glc_3dviewcollection.h"
+#include "glc_3dviewinstance.h"
+#include "../geometry/glc_mesh.h"
+
+GLC_ClashDetector::Clash::Clash()
+    : m_OccurrenceId1(0)
+    , m_BodyId1(0)
+    , m_OccurrenceId2(0)
+    , m_BodyId2(0)
+    , m_Type(Interference)
+    , m_Distance(0.0)
+    , m_Point1()
+    , m_Point2()
+    , m_TrianglePairCount(0)
+{
+
+}
+
+GLC_ClashDetector::Statistics::Statistics()
+    : m_BodyCount(0)
+    , m_CandidatePairCount(0)
+    , m_InterferenceCount(0)
+    , m_ContactCount(0)
+    , m_ClearanceCount(0)
+    , m_BuiltTreeCount(0)
+{
+
+}
+
+GLC_ClashDetector::GLC_ClashDetector()
+    : m_Clearance(0.0)
+    , m_ContactTolerance(0.0)
+    , m_MaxTrianglePairCount(64)
+    , m_MeshTrees()
+    , m_Bodies()
+    , m_Pairs()
+    , m_World()
+    , m_Clashes()
+    , m_Statistics()
+{
+
+}
+
+GLC_ClashDetector::~GLC_ClashDetector()
+{
+    clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+GLC_SelectionSet GLC_ClashDetector::selectionSet() const
+{
+    GLC_SelectionSet subject;
+    subject.setAttachedWorld(m_World);
+    const int clashCount= m_Clashes.size();
+    for (int i= 0; i < clashCount; ++i)
+    {
+        const Clash& clash= m_Clashes.at(i);
+        subject.insert(clash.m_OccurrenceId1, clash.m_BodyId1);
+        subject.insert(clash.m_OccurrenceId2, clash.m_BodyId2);
+    }
+
+    return subject;
+}
+
+GLC_SelectionSet GLC_ClashDetector::selectionSet(int clashIndex) const
+{
+    Q_ASSERT((clashIndex >= 0) && (clashIndex < m_Clashes.size()));
+    GLC_SelectionSet subject;
+    subject.setAttachedWorld(m_World);
+    const Clash& clash= m_Clashes.at(clashIndex);
+    subject.insert(clash.m_OccurrenceId1, clash.m_BodyId1);
+    subject.insert(clash.m_OccurrenceId2, clash.m_BodyId2);
+
+    return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_ClashDetector::detect(GLC_World& world)
+{
+    detectClashes(world, nullptr);
+}
+
+void GLC_ClashDetector::detect(GLC_World& world, const GLC_SelectionSet& selection)
+{
+    detectClashes(world, &selection);
+}
+
+void GLC_ClashDetector::clear()
+{
+    QHash<GLC_uint, MeshTree>::const_iterator iTree= m_MeshTrees.constBegin();
+    while (iTree != m_MeshTrees.constEnd())
+    {
+        delete iTree.value().m_pBvh;
+        ++iTree;
+    }
+    m_MeshTrees.clear();
+    m_Bodies.clear();
+    m_Pairs.clear();
+    m_World= GLC_World();
+    m_Clashes.clear();
+    m_Statistics= Statistics();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_ClashDetector::detectClashes(GLC_World& world, const GLC_SelectionSet* pSelection)
+{
+    m_World= world;
+    m_Clashes.clear();
+    m_Statistics= Statistics();
+    m_Bodies.clear();
+
+    // Collect the bodies, the id of an instance of the world collection is the id of its occurrence
+    QVector<const GLC_Mesh*> newMeshes;
+    QSet<GLC_uint> usedMeshes;
+    const QList<GLC_3DViewInstance*> instances(world.collection()->instancesHandle());
+    const int instanceCount= instances.size();
+    for (int i= 0; i < instanceCount; ++i)
+    {
+        GLC_3DViewInstance* pInstance= instances.at(i);
+        const GLC_uint occurrenceId= pInstance->id();
+        const bool occurrenceSelected= (nullptr == pSelection) || pSelection->contains(occurrenceId);
+        const BodySelection bodySelection((nullptr != pSelection) ? pSelection->occurrenceSelection().value(occurrenceId) : BodySelection());
+
+        const int bodyCount= pInstance->numberOfBody();
+        for (int j= 0; j < bodyCount; ++j)
+        {
+            GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(pInstance->geomAt(j));
+            if ((nullptr == pMesh) || pMesh->isEmpty()) continue;
+
+            // The tree of a modified mesh is built again
+            const GLC_uint meshId= pMesh->id();
+            if (!usedMeshes.contains(meshId))
+            {
+                QHash<GLC_uint, MeshTree>::iterator iTree= m_MeshTrees.find(meshId);
+                if ((iTree != m_MeshTrees.end()) && (iTree.value().m_Revision != pMesh->revision()))
+                {
+                    delete iTree.value().m_pBvh;
+                    m_MeshTrees.erase(iTree);
+                    iTree= m_MeshTrees.end();
+                }
+                if (iTree == m_MeshTrees.end()) newMeshes.append(pMesh);
+                usedMeshes.insert(meshId);
+            }
+
+            Body body;
+            body.m_OccurrenceId= occurrenceId;
+            body.m_BodyId= meshId;
+            body.m_MeshId= meshId;
+            body.m_pBvh= nullptr;
+            body.m_Matrix= pInstance->matrix();
+            body.m_InverseMatrix= body.m_Matrix.inverted();
+            body.m_InSelection= occurrenceSelected && (bodySelection.isEmpty() || bodySelection.contains(meshId));
+
+            GLC_BoundingBox box(pMesh->boundingBox());
+            box.transform(body.m_Matrix);
+            for (int axis= 0; axis < 3; ++axis)
+            {
+                body.m_Min[axis]= box.lowerCorner().data()[axis];
+                body.m_Max[axis]= box.upperCorner().data()[axis];
+            }
+            m_Bodies.append(body);
+        }
+    }
+    m_Statistics.m_BodyCount= m_Bodies.size();
+
+    // Remove the trees of the meshes which are not in the world
+    QHash<GLC_uint, MeshTree>::iterator iTree= m_MeshTrees.begin();
+    while (iTree != m_MeshTrees.end())
+    {
+        if (usedMeshes.contains(iTree.key()))
+        {
+            ++iTree;
+        }
+        else
+        {
+            delete iTree.value().m_pBvh;
+            iTree= m_MeshTrees.erase(iTree);
+        }
+    }
+
+    // Trees of the new meshes
+    if (!newMeshes.isEmpty())
+    {
+        const QList<GLC_MeshBvh*> newTrees(QtConcurrent::blockingMapped<QList<GLC_MeshBvh*> >(newMeshes, [](const GLC_Mesh* pMesh)
+        {
+            return new GLC_MeshBvh(pMesh);
+        }));
+        const int newMeshCount= newMeshes.size();
+        for (int i= 0; i < newMeshCount; ++i)
+        {
+            const MeshTree meshTree= {newTrees.at(i), newMeshes.at(i)->revision()};
+            m_MeshTrees.insert(newMeshes.at(i)->id(), meshTree);
+        }
+        m_Statistics.m_BuiltTreeCount= newMeshCount;
+    }
+
+    const int bodyCount= m_Bodies.size();
+    for (int i= 0; i < bodyCount; ++i)
+    {
+        m_Bodies[i].m_pBvh= m_MeshTrees.value(m_Bodies.at(i).m_MeshId).m_pBvh;
+    }
+
+    const double margin= qMax(m_Clearance, m_ContactTolerance);
+    findCandidatePairs(margin);
+    m_Statistics.m_CandidatePairCount= m_Pairs.size();
+
+    if (m_Pairs.size() > 1)
+    {
+        QtConcurrent::blockingMap(m_Pairs, [this](Pair& pair)
+        {
+            testPair(&pair);
+        });
+    }
+    else if (!m_Pairs.isEmpty())
+    {
+        testPair(&m_Pairs[0]);
+    }
+
+    const int pairCount= m_Pairs.size();
+    for (int i= 0; i < pairCount; ++i)
+    {
+        const Pair& pair= m_Pairs.at(i);
+        if (!pair.m_IsClash) continue;
+
+        m_Clashes.append(pair.m_Clash);
+        switch (pair.m_Clash.m_Type)
+        {
+        case Interference:
+            ++m_Statistics.m_InterferenceCount;
+            break;
+        case Contact:
+            ++m_Statistics.m_ContactCount;
+            break;
+        default:
+            ++m_Statistics.m_ClearanceCount;
+            break;
+        }
+    }
+    m_Pairs.clear();
+    m_Bodies.clear();
+}
+
+void GLC_ClashDetector::findCandidatePairs(double margin)
+{
+    m_Pairs.clear();
+
+    // Sweep the boxes enlarged by half the margin on the X axis
+    const double halfMargin= margin * 0.5;
+    const int bodyCount= m_Bodies.size();
+    QVector<int> order(bodyCount);
+    for (int i= 0; i < bodyCount; ++i) order[i]= i;
+    std::stable_sort(order.begin(), order.end(), [this](int body1, int body2)
+    {
+        return m_Bodies.at(body1).m_Min[0] < m_Bodies.at(body2).m_Min[0];
+    });
+
+    QVector<int> activeBodies;
+    for (int i= 0; i < bodyCount; ++i)
+    {
+        const int bodyIndex= order.at(i);
+        const Body& body= m_Bodies.at(bodyIndex);
+        const double minX= body.m_Min[0] - halfMargin;
+
+        int activeCount= 0;
+        const int previousActiveCount= activeBodies.size();
+        for (int j= 0; j < previousActiveCount; ++j)
+        {
+            const int otherIndex= activeBodies.at(j);
+            const Body& other= m_Bodies.at(otherIndex);
+            if ((other.m_Max[0] + halfMargin) < minX) continue;
+            activeBodies[activeCount++]= otherIndex;
+
+            if (other.m_OccurrenceId == body.m_OccurrenceId) continue;
+            if (!other.m_InSelection && !body.m_InSelection) continue;
+            if (((other.m_Max[1] + margin) < body.m_Min[1]) || ((body.m_Max[1] + margin) < other.m_Min[1])) continue;
+            if (((other.m_Max[2] + margin) < body.m_Min[2]) || ((body.m_Max[2] + margin) < other.m_Min[2])) continue;
+
+            Pair pair;
+            pair.m_Body1= qMin(bodyIndex, otherIndex);
+            pair.m_Body2= qMax(bodyIndex, otherIndex);
+            pair.m_IsClash= false;
+            m_Pairs.append(pair);
+        }
+        activeBodies.resize(activeCount);
+        activeBodies.append(bodyIndex);
+    }
+
+    // Pairs in collection order
+    std::sort(m_Pairs.begin(), m_Pairs.end(), [](const Pair& pair1, const Pair& pair2)
+    {
+        return (pair1.m_Body1 < pair2.m_Body1) || ((pair1.m_Body1 == pair2.m_Body1) && (pair1.m_Body2 < pair2.m_Body2));
+    });
+}
+
+void GLC_ClashDetector::testPair(Pair* pPair) const
+{
+    const Body& body1= m_Bodies.at(pPair->m_Body1);
+    const Body& body2= m_Bodies.at(pPair->m_Body2);
+    if ((nullptr == body1.m_pBvh) || (nullptr == body2.m_pBvh)) return;
+
+    Clash& clash= pPair->m_Clash;
+    clash.m_OccurrenceId1= body1.m_OccurrenceId;
+    clash.m_BodyId1= body1.m_BodyId;
+    clash.m_OccurrenceId2= body2.m_OccurrenceId;
+    clash.m_BodyId2= body2.m_BodyId;
+
+    const QVector<GLC_MeshBvh::TrianglePair> overlaps(GLC_MeshBvh::overlappingTriangles(*body1.m_pBvh, body1.m_Matrix, *body2.m_pBvh, body2.m_Matrix
+                                                                                        , m_ContactTolerance, m_MaxTrianglePairCount));
+    if (!overlaps.isEmpty())
+    {
+        // A point of the interference from the first overlapping pair
+        const GLC_MeshBvh::TrianglePair& first= overlaps.first();
+        GLC_Point3d triangle1[3];
+        GLC_Point3d triangle2[3];
+        for (int k= 0; k < 3; ++k)
+        {
+            triangle1[k]= body1.m_Matrix * body1.m_pBvh->point(first.m_Triangle1, k);
+            triangle2[k]= body2.m_Matrix * body2.m_pBvh->point(first.m_Triangle2, k);
+        }
+        GLC_MeshBvh::triangleDistance(triangle1, triangle2, &clash.m_Point1, &clash.m_Point2);
+
+        clash.m_Type= Interference;
+        clash.m_Distance= 0.0;
+        clash.m_TrianglePairCount= overlaps.size();
+        pPair->m_IsClash= true;
+        return;
+    }
+
+    // Without crossing triangles, a body can be inside the other one
+    if (isInside(body1, body2, &clash.m_Point1) || isInside(body2, body1, &clash.m_Point1))
+    {
+        clash.m_Point2= clash.m_Point1;
+        clash.m_Type= Interference;
+        clash.m_Distance= 0.0;
+        clash.m_TrianglePairCount= 0;
+        pPair->m_IsClash= true;
+        return;
+    }
+
+    const double margin= qMax(m_Clearance, m_ContactTolerance);
+    if (margin <= 0.0) return;
+
+    const double distance= GLC_MeshBvh::distance(*body1.m_pBvh, body1.m_Matrix, *body2.m_pBvh, body2.m_Matrix
+                                                 , margin, &clash.m_Point1, &clash.m_Point2);
+    if (distance >= margin)
+    {
+        return;
+    }
+    else if (distance <= m_ContactTolerance)
+    {
+        clash.m_Type= Contact;
+    }
+    else
+    {
+        clash.m_Type= Clearance;
+    }
+    clash.m_Distance= distance;
+    clash.m_TrianglePairCount= 0;
+    pPair->m_IsClash= true;
+}
+
+bool GLC_ClashDetector::isInside(const Body& body, const Body& container, GLC_Point3d* pPoint)
+{
+    // The box of the body must be inside the box of the container
+    for (int axis= 0; axis < 3; ++axis)
+    {
+        if ((body.m_Min[axis] < container.m_Min[axis]) || (body.m_Max[axis] > container.m_Max[axis])) return false;
+    }
+    if (body.m_pBvh->isEmpty()) return false;
+
+    // The triangles don't cross, any vertex of the body is inside if the body is inside
+    const GLC_Point3d point(body.m_Matrix * body.m_pBvh->point(0, 0));
+    const bool subject= container.m_pBvh->contains(container.m_InverseMatrix * point);
+    if (subject) *pPoint= point;
+
+    return subject;
+}
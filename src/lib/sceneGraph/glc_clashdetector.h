@@ -0,0 +1,277 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_clashdetector.h interface for the GLC_ClashDetector class.
+
+#ifndef GLC_CLASHDETECTOR_H_
+#define GLC_CLASHDETECTOR_H_
+
+#include <QVector>
+#include <QList>
+#include <QHash>
+
+#include "glc_selectionset.h"
+#include "glc_world.h"
+#include "../geometry/glc_meshbvh.h"
+#include "../maths/glc_vector3d.h"
+#include "../maths/glc_matrix4x4.h"
+#include "../glc_global.h"
+
+#include "../glc_config.h"
+
+class GLC_Mesh;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_ClashDetector
+/*! \brief GLC_ClashDetector : Find the bodies of a world which overlap, touch or are too close*/
+
+/*! detect() tests the bodies of the occurrences of a world two by two, the bodies
+ *  of the same occurrence are not tested together.
+ *
+ *  The broad phase sorts the absolute bounding boxes of the bodies on the X axis and
+ *  sweeps them to find the pairs of boxes which overlap on the three axes, the boxes are
+ *  enlarged by the clearance. The narrow phase tests the triangles of the pairs with the
+ *  GLC_MeshBvh of their meshes placed by the absolute matrix of their occurrence:
+ *  - Two bodies interfere if two of their triangles overlap by more than the contact tolerance,
+ *    or if one of them is inside the other one, which must be closed (See GLC_MeshBvh::contains()).
+ *  - Two bodies which don't interfere are in contact if their distance is not greater than the contact tolerance.
+ *  - Two bodies which are not in contact clash on clearance if their distance is less than the clearance.
+ *
+ *  Contacts and clearances are only searched if the contact tolerance or the clearance is positive.
+ *
+ *  The trees of the meshes are kept between detections and built again when the revision of
+ *  their mesh changes (See GLC_Geometry::revision()), the trees of meshes which are not in the
+ *  last detected world are removed. The trees of new meshes and the pairs of bodies are
+ *  processed by the global thread pool.
+ *
+ *  The clashes can be converted to a GLC_SelectionSet of occurrence and body ids.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_ClashDetector
+{
+public:
+    //! The kind of clash between two bodies
+    enum ClashType
+    {
+        Interference,
+        Contact,
+        Clearance
+    };
+
+    //! A clash between two bodies
+    struct Clash
+    {
+        Clash();
+
+        //! Occurrence and body ids of the first body
+        GLC_uint m_OccurrenceId1;
+        GLC_uint m_BodyId1;
+
+        //! Occurrence and body ids of the second body
+        GLC_uint m_OccurrenceId2;
+        GLC_uint m_BodyId2;
+
+        //! The kind of clash
+        ClashType m_Type;
+
+        //! The distance between the bodies, 0 for an interference
+        double m_Distance;
+
+        //! Closest points of the bodies or a point of the interference, in world coordinates
+        GLC_Point3d m_Point1;
+        GLC_Point3d m_Point2;
+
+        //! Number of overlapping triangle pairs found of an interference, 0 if a body is inside the other one or of a contact or a clearance
+        int m_TrianglePairCount;
+    };
+
+    //! Statistics of a detection
+    struct Statistics
+    {
+        Statistics();
+
+        //! Number of tested bodies
+        int m_BodyCount;
+
+        //! Number of body pairs whose bounding boxes overlap
+        int m_CandidatePairCount;
+
+        //! Number of interferences, contacts and clearance clashes
+        int m_InterferenceCount;
+        int m_ContactCount;
+        int m_ClearanceCount;
+
+        //! Number of trees built by the detection
+        int m_BuiltTreeCount;
+    };
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    GLC_ClashDetector();
+    ~GLC_ClashDetector();
+private:
+    Q_DISABLE_COPY(GLC_ClashDetector)
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the minimum distance required between bodies
+    inline double clearance() const
+    {return m_Clearance;}
+
+    //! Return the contact tolerance
+    inline double contactTolerance() const
+    {return m_ContactTolerance;}
+
+    //! Return the maximum number of overlapping triangle pairs searched by interference
+    inline int maxTrianglePairCount() const
+    {return m_MaxTrianglePairCount;}
+
+    //! Return the clashes of the last detection
+    inline const QList<Clash>& clashes() const
+    {return m_Clashes;}
+
+    //! Return the statistics of the last detection
+    inline const Statistics& statistics() const
+    {return m_Statistics;}
+
+    //! Return the selection set of the bodies of the clashes of the last detection
+    GLC_SelectionSet selectionSet() const;
+
+    //! Return the selection set of the two bodies of the given clash of the last detection
+    GLC_SelectionSet selectionSet(int clashIndex) const;
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Set the minimum distance required between bodies, 0 to search only interferences and contacts
+    inline void setClearance(double clearance)
+    {m_Clearance= qMax(0.0, clearance);}
+
+    //! Set the contact tolerance
+    inline void setContactTolerance(double tolerance)
+    {m_ContactTolerance= qMax(0.0, tolerance);}
+
+    //! Set the maximum number of overlapping triangle pairs searched by interference, 0 for no limit
+    inline void setMaxTrianglePairCount(int count)
+    {m_MaxTrianglePairCount= qMax(0, count);}
+
+    //! Detect the clashes between the bodies of the given world
+    void detect(GLC_World& world);
+
+    //! Detect the clashes of the bodies of the given world with at least one body in the given selection
+    /*! A selected occurrence without selected bodies selects all its bodies*/
+    void detect(GLC_World& world, const GLC_SelectionSet& selection);
+
+    //! Remove the clashes and the trees of the meshes
+    void clear();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! A body of the current detection
+    struct Body
+    {
+        GLC_uint m_OccurrenceId;
+        GLC_uint m_BodyId;
+        GLC_uint m_MeshId;
+        const GLC_MeshBvh* m_pBvh;
+        GLC_Matrix4x4 m_Matrix;
+        GLC_Matrix4x4 m_InverseMatrix;
+        double m_Min[3];
+        double m_Max[3];
+        bool m_InSelection;
+    };
+
+    //! A pair of bodies whose boxes overlap
+    struct Pair
+    {
+        int m_Body1;
+        int m_Body2;
+        bool m_IsClash;
+        Clash m_Clash;
+    };
+
+    //! Detect the clashes of the given world, only in the given selection if it is not null
+    void detectClashes(GLC_World& world, const GLC_SelectionSet* pSelection);
+
+    //! Find the pairs of bodies whose enlarged boxes overlap
+    void findCandidatePairs(double margin);
+
+    //! Test the triangles of the given pair
+    void testPair(Pair* pPair) const;
+
+    //! Return true if the given body, whose triangles don't cross the container ones, is inside the container
+    /*! Store a point of the body in world coordinates*/
+    static bool isInside(const Body& body, const Body& container, GLC_Point3d* pPoint);
+
+    //! The tree of a mesh and the revision of the mesh used to build it
+    struct MeshTree
+    {
+        GLC_MeshBvh* m_pBvh;
+        quint64 m_Revision;
+    };
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The minimum distance required between bodies
+    double m_Clearance;
+
+    //! The contact tolerance
+    double m_ContactTolerance;
+
+    //! The maximum number of overlapping triangle pairs searched by interference
+    int m_MaxTrianglePairCount;
+
+    //! The trees of the meshes from their id
+    QHash<GLC_uint, MeshTree> m_MeshTrees;
+
+    //! The bodies of the current detection
+    QVector<Body> m_Bodies;
+
+    //! The candidate pairs of the current detection
+    QVector<Pair> m_Pairs;
+
+    //! The world of the last detection
+    GLC_World m_World;
+
+    //! The clashes of the last detection
+    QList<Clash> m_Clashes;
+
+    //! The statistics of the last detection
+    Statistics m_Statistics;
+};
+
+#endif /* GLC_CLASHDETECTOR_H_ */
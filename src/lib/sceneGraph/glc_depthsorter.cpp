@@ -0,0 +1,182 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_depthsorter.cpp implementation of the GLC_DepthSorter class.
+
+#include <cstring>
+
+#include "glc_depthsorter.h"
+#include "glc_3dviewinstance.h"
+
+GLC_DepthSorter::GLC_DepthSorter()
+    : m_Candidates()
+    , m_CandidateCount(0)
+    , m_CandidatesAreUnchanged(false)
+    , m_Instances()
+    , m_Keys()
+    , m_TempInstances()
+    , m_TempKeys()
+    , m_ViewMatrix()
+    , m_NextViewMatrix()
+    , m_MatrixRevision(0)
+    , m_IsValid(false)
+    , m_SortCount(0)
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+quint32 GLC_DepthSorter::sortableKey(float depth)
+{
+    quint32 bits;
+    memcpy(&bits, &depth, sizeof(bits));
+
+    // Negative values are reversed, positive values are moved above negative ones
+    if (bits & 0x80000000u) return ~bits;
+    else return bits | 0x80000000u;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_DepthSorter::beginUpdate(const GLC_Matrix4x4& viewMatrix)
+{
+    m_NextViewMatrix= viewMatrix;
+    m_CandidateCount= 0;
+    m_CandidatesAreUnchanged= true;
+}
+
+void GLC_DepthSorter::addCandidate(GLC_3DViewInstance* pInstance)
+{
+    if (m_CandidateCount < m_Candidates.size())
+    {
+        if (m_Candidates.at(m_CandidateCount) != pInstance)
+        {
+            m_Candidates[m_CandidateCount]= pInstance;
+            m_CandidatesAreUnchanged= false;
+        }
+    }
+    else
+    {
+        m_Candidates.append(pInstance);
+        m_CandidatesAreUnchanged= false;
+    }
+    ++m_CandidateCount;
+}
+
+void GLC_DepthSorter::endUpdate()
+{
+    if (m_CandidateCount != m_Candidates.size())
+    {
+        m_Candidates.resize(m_CandidateCount);
+        m_CandidatesAreUnchanged= false;
+    }
+
+    const quint64 matrixRevision= GLC_3DViewInstance::matrixRevision();
+    const bool isUpToDate= m_IsValid && m_CandidatesAreUnchanged
+            && (matrixRevision == m_MatrixRevision) && (m_NextViewMatrix == m_ViewMatrix);
+
+    if (!isUpToDate)
+    {
+        m_ViewMatrix= m_NextViewMatrix;
+        m_MatrixRevision= matrixRevision;
+
+        // Only the view depth is needed : the third row of the view matrix
+        const double* pMatrix= m_ViewMatrix.getData();
+        m_Instances.resize(m_CandidateCount);
+        m_Keys.resize(m_CandidateCount);
+        for (int i= 0; i < m_CandidateCount; ++i)
+        {
+            GLC_3DViewInstance* pInstance= m_Candidates.at(i);
+            const GLC_Point3d center(pInstance->boundingBox().center());
+            const double depth= pMatrix[2] * center.x() + pMatrix[6] * center.y() + pMatrix[10] * center.z() + pMatrix[14];
+
+            // The farthest instance has the lowest depth
+            m_Instances[i]= pInstance;
+            m_Keys[i]= sortableKey(static_cast<float>(depth));
+        }
+
+        radixSort();
+        m_IsValid= true;
+        ++m_SortCount;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_DepthSorter::radixSort()
+{
+    const int count= m_Keys.size();
+    // Nothing to sort, the passes read the first key
+    if (count < 2) return;
+
+    m_TempKeys.resize(count);
+    m_TempInstances.resize(count);
+
+    quint32* pKeys= m_Keys.data();
+    GLC_3DViewInstance** pInstances= m_Instances.data();
+    quint32* pTempKeys= m_TempKeys.data();
+    GLC_3DViewInstance** pTempInstances= m_TempInstances.data();
+
+    // Least significant byte first, each pass is stable
+    for (int shift= 0; shift < 32; shift+= 8)
+    {
+        int histogram[256]= {};
+        for (int i= 0; i < count; ++i)
+        {
+            ++histogram[(pKeys[i] >> shift) & 0xFF];
+        }
+
+        // The pass doesn't change the order if all keys have the same byte
+        if (histogram[(pKeys[0] >> shift) & 0xFF] == count) continue;
+
+        int offset= 0;
+        for (int i= 0; i < 256; ++i)
+        {
+            const int size= histogram[i];
+            histogram[i]= offset;
+            offset+= size;
+        }
+
+        for (int i= 0; i < count; ++i)
+        {
+            const int index= histogram[(pKeys[i] >> shift) & 0xFF]++;
+            pTempKeys[index]= pKeys[i];
+            pTempInstances[index]= pInstances[i];
+        }
+
+        qSwap(pKeys, pTempKeys);
+        qSwap(pInstances, pTempInstances);
+    }
+
+    // The sorted data are in the temporary buffers after an odd number of passes
+    if (pKeys != m_Keys.data())
+    {
+        m_Keys.swap(m_TempKeys);
+        m_Instances.swap(m_TempInstances);
+    }
+}
@@ -0,0 +1,137 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_depthsorter.h interface for the GLC_DepthSorter class.
+
+#ifndef GLC_DEPTHSORTER_H_
+#define GLC_DEPTHSORTER_H_
+
+#include <QVector>
+
+#include "../maths/glc_matrix4x4.h"
+
+#include "../glc_config.h"
+
+class GLC_3DViewInstance;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_DepthSorter
+/*! \brief GLC_DepthSorter : Sort instances from back to front*/
+
+/*! Instances are sorted by the view depth of their bounding box center
+ *  with a radix sort on 32 bits keys.
+ *
+ *  Candidates are given with beginUpdate(), addCandidate() and endUpdate().
+ *  The sort is done again only if the candidates, the view matrix or the
+ *  matrix of an instance (see GLC_3DViewInstance::matrixRevision()) have changed.
+ *  Key and instance buffers are kept between updates, sorting does not allocate
+ *  once the buffers have reached the number of candidates.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_DepthSorter
+{
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    GLC_DepthSorter();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the instances of the last update from back to front
+    inline const QVector<GLC_3DViewInstance*>& sortedInstances() const
+    {return m_Instances;}
+
+    //! Return the number of sorts done since the construction
+    inline quint64 sortCount() const
+    {return m_SortCount;}
+
+    //! Return the sortable key of the given depth
+    /*! The order of keys is the order of depths*/
+    static quint32 sortableKey(float depth);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Begin the update of the candidates with the given view matrix
+    void beginUpdate(const GLC_Matrix4x4& viewMatrix);
+
+    //! Add the given candidate, candidates must be added in a stable order
+    void addCandidate(GLC_3DViewInstance* pInstance);
+
+    //! End the update and sort the candidates if needed
+    void endUpdate();
+
+    //! Sort the candidates on next update
+    inline void invalidate()
+    {m_IsValid= false;}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Sort m_Instances by m_Keys
+    void radixSort();
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The candidates in insertion order
+    QVector<GLC_3DViewInstance*> m_Candidates;
+
+    //! Number of candidates of the current update
+    int m_CandidateCount;
+
+    //! True if the candidates of the current update are the previous ones
+    bool m_CandidatesAreUnchanged;
+
+    //! Sorted instances and their keys
+    QVector<GLC_3DViewInstance*> m_Instances;
+    QVector<quint32> m_Keys;
+
+    //! Radix sort buffers
+    QVector<GLC_3DViewInstance*> m_TempInstances;
+    QVector<quint32> m_TempKeys;
+
+    //! The view matrix and instance matrix revision of the last sort
+    GLC_Matrix4x4 m_ViewMatrix;
+    GLC_Matrix4x4 m_NextViewMatrix;
+    quint64 m_MatrixRevision;
+
+    //! False if the candidates must be sorted
+    bool m_IsValid;
+
+    //! The number of sorts
+    quint64 m_SortCount;
+};
+
+#endif /* GLC_DEPTHSORTER_H_ */
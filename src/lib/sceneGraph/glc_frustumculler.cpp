@@ -0,0 +1,189 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_frustumculler.cpp implementation of the GLC_FrustumCuller class.
+
+#include <QThread>
+#include <QtConcurrent>
+
+#include "glc_frustumculler.h"
+#include "glc_3dviewinstance.h"
+#include "../glc_state.h"
+
+GLC_FrustumCuller::Statistics::Statistics()
+    : m_ViewableInstanceCount(0)
+    , m_CulledInstanceCount(0)
+    , m_TestedInstanceCount(0)
+    , m_PartialInstanceCount(0)
+    , m_CulledBodyCount(0)
+{
+
+}
+
+GLC_FrustumCuller::Statistics& GLC_FrustumCuller::Statistics::operator+=(const Statistics& other)
+{
+    m_ViewableInstanceCount+= other.m_ViewableInstanceCount;
+    m_CulledInstanceCount+= other.m_CulledInstanceCount;
+    m_TestedInstanceCount+= other.m_TestedInstanceCount;
+    m_PartialInstanceCount+= other.m_PartialInstanceCount;
+    m_CulledBodyCount+= other.m_CulledBodyCount;
+
+    return *this;
+}
+
+GLC_FrustumCuller::GLC_FrustumCuller()
+    : m_Entries()
+    , m_Chunks()
+    , m_Statistics()
+    , m_ChunkCount(0)
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_FrustumCuller::addInstance(GLC_3DViewInstance* pInstance, GLC_Frustum::Localisation nodeLocalisation)
+{
+    // Bounding boxes are computed on first use, they must be computed before the parallel update
+    if ((nodeLocalisation == GLC_Frustum::IntersectFrustum) && !pInstance->boundingBoxValidity())
+    {
+        pInstance->boundingBox();
+    }
+
+    Entry entry;
+    entry.m_pInstance= pInstance;
+    entry.m_NodeLocalisation= nodeLocalisation;
+    m_Entries.append(entry);
+}
+
+void GLC_FrustumCuller::updateViewableInstances(const GLC_Frustum& frustum)
+{
+    const int count= m_Entries.size();
+
+    // More chunks than threads to balance the load
+    m_ChunkCount= 1;
+    if (GLC_State::isParallelCullingActivated())
+    {
+        m_ChunkCount= qBound(1, count / ChunkSize, QThread::idealThreadCount() * 4);
+    }
+
+    m_Chunks.resize(m_ChunkCount);
+    for (int i= 0; i < m_ChunkCount; ++i)
+    {
+        Chunk& chunk= m_Chunks[i];
+        chunk.m_Begin= static_cast<int>((static_cast<qint64>(count) * i) / m_ChunkCount);
+        chunk.m_End= static_cast<int>((static_cast<qint64>(count) * (i + 1)) / m_ChunkCount);
+        chunk.m_Statistics= Statistics();
+    }
+
+    if (m_ChunkCount > 1)
+    {
+        QtConcurrent::blockingMap(m_Chunks, [this, &frustum](Chunk& chunk)
+        {
+            updateChunk(frustum, &chunk);
+        });
+    }
+    else
+    {
+        updateChunk(frustum, &m_Chunks[0]);
+    }
+
+    m_Statistics= Statistics();
+    for (int i= 0; i < m_ChunkCount; ++i)
+    {
+        m_Statistics+= m_Chunks.at(i).m_Statistics;
+    }
+    m_Entries.clear();
+}
+
+void GLC_FrustumCuller::updateViewableInstance(const GLC_Frustum& frustum, GLC_3DViewInstance* pInstance, Statistics* pStatistics)
+{
+    ++(pStatistics->m_TestedInstanceCount);
+    const GLC_Frustum::Localisation instanceLocalisation= frustum.localizeBoundingBox(pInstance->boundingBox());
+
+    if (instanceLocalisation == GLC_Frustum::OutFrustum)
+    {
+        pInstance->setViewable(GLC_3DViewInstance::NoViewable);
+        ++(pStatistics->m_CulledInstanceCount);
+    }
+    else if (instanceLocalisation == GLC_Frustum::InFrustum)
+    {
+        pInstance->setViewable(GLC_3DViewInstance::FullViewable);
+        ++(pStatistics->m_ViewableInstanceCount);
+    }
+    else
+    {
+        ++(pStatistics->m_ViewableInstanceCount);
+        const int size= pInstance->numberOfBody();
+        if (size > 1)
+        {
+            pInstance->setViewable(GLC_3DViewInstance::PartialViewable);
+            ++(pStatistics->m_PartialInstanceCount);
+            //Update the geometries viewable property of the instance
+            const GLC_Matrix4x4& instanceMat= pInstance->matrix();
+            for (int i= 0; i < size; ++i)
+            {
+                // Get the geometry bounding box
+                GLC_BoundingBox geomBox= pInstance->geomAt(i)->boundingBox();
+                geomBox.transform(instanceMat);
+                const double radius= geomBox.boundingSphereRadius();
+                const GLC_Frustum::Localisation geomLocalisation= frustum.localizeSphere(geomBox.center(), radius);
+
+                const bool geomViewable= (geomLocalisation != GLC_Frustum::OutFrustum);
+                pInstance->setGeomViewable(i, geomViewable);
+                if (!geomViewable) ++(pStatistics->m_CulledBodyCount);
+            }
+        }
+        else
+        {
+            pInstance->setViewable(GLC_3DViewInstance::FullViewable);
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_FrustumCuller::updateChunk(const GLC_Frustum& frustum, Chunk* pChunk) const
+{
+    Statistics& statistics= pChunk->m_Statistics;
+    for (int i= pChunk->m_Begin; i < pChunk->m_End; ++i)
+    {
+        const Entry& entry= m_Entries.at(i);
+        switch (entry.m_NodeLocalisation)
+        {
+        case GLC_Frustum::InFrustum:
+            entry.m_pInstance->setViewable(GLC_3DViewInstance::FullViewable);
+            ++statistics.m_ViewableInstanceCount;
+            break;
+        case GLC_Frustum::OutFrustum:
+            entry.m_pInstance->setViewable(GLC_3DViewInstance::NoViewable);
+            ++statistics.m_CulledInstanceCount;
+            break;
+        default:
+            updateViewableInstance(frustum, entry.m_pInstance, &statistics);
+            break;
+        }
+    }
+}
@@ -0,0 +1,163 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_frustumculler.h interface for the GLC_FrustumCuller class.
+
+#ifndef GLC_FRUSTUMCULLER_H_
+#define GLC_FRUSTUMCULLER_H_
+
+#include <QVector>
+
+#include "../viewport/glc_frustum.h"
+
+#include "../glc_config.h"
+
+class GLC_3DViewInstance;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_FrustumCuller
+/*! \brief GLC_FrustumCuller : Update the viewable state of instances in parallel*/
+
+/*! Instances are added with the localisation of the space partitioning node which
+ *  contains them. Instances of nodes inside or outside the frustum get the state
+ *  of their node, the others are tested one by one, body by body if they cross the frustum.
+ *
+ *  updateViewableInstances() splits the instances in chunks processed by the
+ *  global thread pool if GLC_State::isParallelCullingActivated() and there are
+ *  enough instances. Each instance is updated by one thread only and the statistics
+ *  of the chunks are summed in order, so the result is the same as the serial one.
+ *
+ *  An instance must be added only once by update.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_FrustumCuller
+{
+public:
+    //! Statistics of an update
+    struct Statistics
+    {
+        Statistics();
+
+        //! Add the given statistics to these statistics
+        Statistics& operator+=(const Statistics& other);
+
+        //! Number of instances set viewable
+        int m_ViewableInstanceCount;
+
+        //! Number of instances set not viewable
+        int m_CulledInstanceCount;
+
+        //! Number of instances tested one by one
+        int m_TestedInstanceCount;
+
+        //! Number of instances partially viewable
+        int m_PartialInstanceCount;
+
+        //! Number of bodies of partially viewable instances set not viewable
+        int m_CulledBodyCount;
+    };
+
+    //! Minimum number of instances of a parallel chunk
+    enum {ChunkSize= 256};
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    GLC_FrustumCuller();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the number of instances added since the last update
+    inline int instanceCount() const
+    {return m_Entries.size();}
+
+    //! Return the statistics of the last update
+    inline const Statistics& statistics() const
+    {return m_Statistics;}
+
+    //! Return the number of chunks of the last update
+    inline int chunkCount() const
+    {return m_ChunkCount;}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Add the given instance contained in a node with the given localisation
+    void addInstance(GLC_3DViewInstance* pInstance, GLC_Frustum::Localisation nodeLocalisation);
+
+    //! Update the viewable state of the added instances from the given frustum and remove them
+    void updateViewableInstances(const GLC_Frustum& frustum);
+
+    //! Update the viewable state of the given instance from the given frustum
+    /*! The statistics of the instance are added to the given statistics*/
+    static void updateViewableInstance(const GLC_Frustum& frustum, GLC_3DViewInstance* pInstance, Statistics* pStatistics);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! An added instance
+    struct Entry
+    {
+        GLC_3DViewInstance* m_pInstance;
+        GLC_Frustum::Localisation m_NodeLocalisation;
+    };
+
+    //! A range of entries processed by one thread
+    struct Chunk
+    {
+        int m_Begin;
+        int m_End;
+        Statistics m_Statistics;
+    };
+
+    //! Update the viewable state of the entries of the given chunk
+    void updateChunk(const GLC_Frustum& frustum, Chunk* pChunk) const;
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The added instances
+    QVector<Entry> m_Entries;
+
+    //! The chunks of the last update
+    QVector<Chunk> m_Chunks;
+
+    //! The statistics of the last update
+    Statistics m_Statistics;
+
+    //! The number of chunks of the last update
+    int m_ChunkCount;
+};
+
+#endif /* GLC_FRUSTUMCULLER_H_ */
@@ -0,0 +1,326 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_lodselector.cpp implementation of the GLC_LodSelector class.
+
+#include <algorithm>
+
+#include <QThread>
+#include <QtConcurrent>
+
+#include "glc_lodselector.h"
+#include "glc_3dviewcollection.h"
+#include "glc_3dviewinstance.h"
+#include "../geometry/glc_mesh.h"
+#include "../viewport/glc_viewport.h"
+#include "../glc_renderprofiler.h"
+#include "../glc_state.h"
+
+GLC_LodSelector::GLC_LodSelector()
+    : m_PixelErrorThreshold(1.0)
+    , m_Hysteresis(0.2)
+    , m_TriangleBudget(0)
+    , m_Bodies()
+    , m_Instances()
+    , m_Chunks()
+    , m_SelectedTriangleCount(0)
+    , m_CoarsenedBodyCount(0)
+    , m_CulledBodyCount(0)
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+int GLC_LodSelector::lodValue(int lodIndex, int lodCount)
+{
+    Q_ASSERT(lodCount > 0);
+    // Smallest value giving this index in GLC_Mesh::setCurrentLod()
+    return (lodIndex * 100 + lodCount - 1) / lodCount;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_LodSelector::selectLods(GLC_3DViewCollection* pCollection, GLC_Viewport* pView)
+{
+    Q_ASSERT(nullptr != pCollection);
+    Q_ASSERT(nullptr != pView);
+    GLC_RenderProfiler::ScopedTimer profilerTimer(GLC_RenderProfiler::LodSelectionStage);
+
+    View view;
+    view.m_UseOrtho= pView->useOrtho();
+    view.m_Eye= pView->cameraHandle()->eye();
+    view.m_DistEyeTarget= pView->cameraHandle()->distEyeTarget();
+    view.m_ViewTangent= pView->viewTangent();
+    view.m_ViewHeight= static_cast<double>(pView->viewVSize());
+    view.m_CullingRatio= pView->minimumDynamicPixelCullingRatio();
+    view.m_PixelCulling= GLC_State::isPixelCullingActivated();
+    view.m_RecordLods= GLC_RenderProfiler::isRecording();
+
+    // Bounding boxes are computed on first use, they must be computed before the parallel selection
+    m_Instances.clear();
+    const bool showState= pCollection->showState();
+    const QList<GLC_3DViewInstance*> instances(pCollection->instancesHandle());
+    const int instanceCount= instances.size();
+    for (int i= 0; i < instanceCount; ++i)
+    {
+        GLC_3DViewInstance* pInstance= instances.at(i);
+        if ((pInstance->viewableFlag() != GLC_3DViewInstance::NoViewable) && (pInstance->isVisible() == showState))
+        {
+            if (!pInstance->boundingBoxValidity()) pInstance->boundingBox();
+            m_Instances.append(pInstance);
+        }
+    }
+
+    const int count= m_Instances.size();
+    int chunkCount= 1;
+    if (GLC_State::isParallelCullingActivated())
+    {
+        chunkCount= qBound(1, count / ChunkSize, QThread::idealThreadCount() * 4);
+    }
+    m_Chunks.resize(chunkCount);
+    for (int i= 0; i < chunkCount; ++i)
+    {
+        Chunk& chunk= m_Chunks[i];
+        chunk.m_Begin= static_cast<int>((static_cast<qint64>(count) * i) / chunkCount);
+        chunk.m_End= static_cast<int>((static_cast<qint64>(count) * (i + 1)) / chunkCount);
+    }
+
+    if (chunkCount > 1)
+    {
+        QtConcurrent::blockingMap(m_Chunks, [this, &view](Chunk& chunk)
+        {
+            selectChunkLods(view, &chunk);
+        });
+    }
+    else
+    {
+        selectChunkLods(view, &m_Chunks[0]);
+    }
+
+    // Merge the chunks in order
+    m_Bodies.clear();
+    m_SelectedTriangleCount= 0;
+    m_CoarsenedBodyCount= 0;
+    m_CulledBodyCount= 0;
+    for (int i= 0; i < chunkCount; ++i)
+    {
+        const Chunk& chunk= m_Chunks.at(i);
+        m_Bodies+= chunk.m_Bodies;
+        m_SelectedTriangleCount+= chunk.m_TriangleCount;
+        m_CulledBodyCount+= chunk.m_CulledBodyCount;
+        const int lodCount= chunk.m_LodValues.size();
+        for (int iLod= 0; iLod < lodCount; ++iLod)
+        {
+            GLC_RenderProfiler::addLod(chunk.m_LodValues.at(iLod));
+        }
+    }
+
+    if ((m_TriangleBudget > 0) && (m_SelectedTriangleCount > m_TriangleBudget))
+    {
+        applyBudget();
+    }
+
+    const int bodyCount= m_Bodies.size();
+    for (int i= 0; i < bodyCount; ++i)
+    {
+        const Body& body= m_Bodies.at(i);
+        const int lodValue= GLC_LodSelector::lodValue(body.m_LodIndex, body.m_pMesh->lodCount());
+        body.m_pInstance->setBodyLodValue(body.m_BodyIndex, lodValue);
+        GLC_RenderProfiler::addLod(lodValue);
+    }
+}
+
+void GLC_LodSelector::clearLods(GLC_3DViewCollection* pCollection)
+{
+    Q_ASSERT(nullptr != pCollection);
+    const QList<GLC_3DViewInstance*> instances(pCollection->instancesHandle());
+    const int count= instances.size();
+    for (int i= 0; i < count; ++i)
+    {
+        instances.at(i)->clearBodyLodValues();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_LodSelector::selectChunkLods(const View& view, Chunk* pChunk) const
+{
+    pChunk->m_Bodies.clear();
+    pChunk->m_LodValues.clear();
+    pChunk->m_TriangleCount= 0;
+    pChunk->m_CulledBodyCount= 0;
+
+    for (int iInstance= pChunk->m_Begin; iInstance < pChunk->m_End; ++iInstance)
+    {
+        GLC_3DViewInstance* pInstance= m_Instances.at(iInstance);
+        const GLC_Matrix4x4& matrix= pInstance->matrix();
+        double scaling= qMax(matrix.scalingX(), matrix.scalingY());
+        scaling= qMax(scaling, matrix.scalingZ());
+
+        const int bodyCount= pInstance->numberOfBody();
+        for (int iBody= 0; iBody < bodyCount; ++iBody)
+        {
+            if (!pInstance->isGeomViewable(iBody)) continue;
+
+            GLC_Geometry* pGeom= pInstance->geomAt(iBody);
+            const GLC_BoundingBox& boundingBox= pGeom->boundingBox();
+            double dist= 0.0;
+            if (view.m_UseOrtho) dist= view.m_DistEyeTarget;
+            else dist= (matrix * boundingBox.center() - view.m_Eye).length();
+
+            // Size of a world unit in pixels at the distance of the body
+            const double cameraCover= dist * view.m_ViewTangent;
+            const double pixelsPerUnit= (cameraCover > 0.0) ? (view.m_ViewHeight / cameraCover) : view.m_ViewHeight;
+            const double diameter= boundingBox.boundingSphereRadius() * 2.0 * scaling;
+            const double coverRatio= qMin(100.0, diameter * pixelsPerUnit / view.m_ViewHeight * 100.0);
+
+            int lodValue= 0;
+            if (view.m_PixelCulling && (coverRatio < view.m_CullingRatio))
+            {
+                lodValue= 110;
+                ++(pChunk->m_CulledBodyCount);
+            }
+            else
+            {
+                GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(pGeom);
+                const int lodCount= (nullptr != pMesh) ? pMesh->lodCount() : 0;
+                if (lodCount > 1)
+                {
+                    const int previousValue= pInstance->bodyLodValue(iBody);
+                    const int previousLod= ((previousValue >= 0) && (previousValue <= 100)) ? qMin((previousValue * lodCount) / 100, lodCount - 1) : -1;
+                    const int lodIndex= lodFromError(pMesh, previousLod, scaling * pixelsPerUnit);
+                    if (lodIndex >= 0)
+                    {
+                        Body body;
+                        body.m_pInstance= pInstance;
+                        body.m_pMesh= pMesh;
+                        body.m_BodyIndex= iBody;
+                        body.m_LodIndex= lodIndex;
+                        body.m_Coverage= coverRatio;
+                        pChunk->m_Bodies.append(body);
+                        pChunk->m_TriangleCount+= pMesh->faceCount(lodIndex);
+                        continue;
+                    }
+                }
+
+                // No LOD accuracy : LOD from the screen coverage
+                const double ratio= 100.0 - coverRatio;
+                const int defaultLod= pInstance->defaultLodValue();
+                if (ratio > 50.0) lodValue= qMax(defaultLod, static_cast<int>((ratio - 50.0) * 2.0));
+                else lodValue= defaultLod;
+
+                if (lodCount > 0)
+                {
+                    pChunk->m_TriangleCount+= pMesh->faceCount(qMin((lodValue * lodCount) / 100, lodCount - 1));
+                }
+            }
+            pInstance->setBodyLodValue(iBody, lodValue);
+            if (view.m_RecordLods) pChunk->m_LodValues.append(lodValue);
+        }
+    }
+}
+
+int GLC_LodSelector::lodFromError(const GLC_Mesh* pMesh, int previousLod, double pixelsPerUnit) const
+{
+    const int lodCount= pMesh->lodCount();
+
+    // LODs are ordered from the finest to the coarsest, the first one is exact
+    for (int lod= 1; lod < lodCount; ++lod)
+    {
+        if (!pMesh->containsLod(lod) || (pMesh->getLodAccuracy(lod) <= 0.0)) return -1;
+    }
+
+    const double lowThreshold= m_PixelErrorThreshold * (1.0 - m_Hysteresis);
+    const double highThreshold= m_PixelErrorThreshold * (1.0 + m_Hysteresis);
+
+    int subject= 0;
+    if ((previousLod == 0) || ((previousLod > 0) && ((pMesh->getLodAccuracy(previousLod) * pixelsPerUnit) <= highThreshold)))
+    {
+        // The previous LOD is still good enough, only a coarser one can be chosen
+        subject= previousLod;
+    }
+    else
+    {
+        // The previous LOD is too coarse : coarsest finer LOD with an error below the threshold,
+        // the exact LOD if there is none
+        const int lastLod= (previousLod > 0) ? previousLod : lodCount;
+        for (int lod= lastLod - 1; lod > 0; --lod)
+        {
+            if ((pMesh->getLodAccuracy(lod) * pixelsPerUnit) <= m_PixelErrorThreshold)
+            {
+                subject= lod;
+                break;
+            }
+        }
+    }
+
+    // Coarser LOD with an error well below the threshold
+    for (int lod= lodCount - 1; lod > subject; --lod)
+    {
+        if ((pMesh->getLodAccuracy(lod) * pixelsPerUnit) <= lowThreshold)
+        {
+            subject= lod;
+            break;
+        }
+    }
+
+    return subject;
+}
+
+void GLC_LodSelector::applyBudget()
+{
+    // Smallest bodies on screen are coarsened first
+    std::stable_sort(m_Bodies.begin(), m_Bodies.end(), [](const Body& body1, const Body& body2)
+    {
+        return body1.m_Coverage < body2.m_Coverage;
+    });
+
+    QVector<bool> coarsened(m_Bodies.size(), false);
+    bool bodyChanged= true;
+    while (bodyChanged && (m_SelectedTriangleCount > m_TriangleBudget))
+    {
+        bodyChanged= false;
+        const int count= m_Bodies.size();
+        for (int i= 0; (i < count) && (m_SelectedTriangleCount > m_TriangleBudget); ++i)
+        {
+            Body& body= m_Bodies[i];
+            if (body.m_LodIndex < (body.m_pMesh->lodCount() - 1))
+            {
+                m_SelectedTriangleCount-= body.m_pMesh->faceCount(body.m_LodIndex);
+                ++body.m_LodIndex;
+                m_SelectedTriangleCount+= body.m_pMesh->faceCount(body.m_LodIndex);
+                if (!coarsened.at(i))
+                {
+                    coarsened[i]= true;
+                    ++m_CoarsenedBodyCount;
+                }
+                bodyChanged= true;
+            }
+        }
+    }
+}
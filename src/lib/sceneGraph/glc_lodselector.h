@@ -0,0 +1,206 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_lodselector.h interface for the GLC_LodSelector class.
+
+#ifndef GLC_LODSELECTOR_H_
+#define GLC_LODSELECTOR_H_
+
+#include <QVector>
+
+#include "../maths/glc_vector3d.h"
+
+#include "../glc_config.h"
+
+class GLC_3DViewCollection;
+class GLC_3DViewInstance;
+class GLC_Mesh;
+class GLC_Viewport;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_LodSelector
+/*! \brief GLC_LodSelector : Select the LOD of bodies from their screen space error*/
+
+/*! selectLods() choses the LOD of each viewable body of a collection in one pass
+ *  and stores it in the instance with GLC_3DViewInstance::setBodyLodValue().
+ *
+ *  The error of a LOD in pixels is its accuracy (GLC_Mesh::getLodAccuracy()) projected
+ *  at the distance of the body. The coarsest LOD with an error below the pixel error threshold
+ *  is used. A body moves to a coarser LOD only when the error is below
+ *  threshold * (1 - hysteresis) and to a finer LOD only when the current error is above
+ *  threshold * (1 + hysteresis), so the LOD doesn't change back and forth near the threshold.
+ *
+ *  If the selected LODs have more triangles than the triangle budget, the bodies with the
+ *  smallest screen coverage are made coarser first, one LOD at a time, until the budget is reached.
+ *
+ *  Meshes without LOD accuracy keep the LOD chosen from their screen coverage.
+ *
+ *  Instances are processed in chunks by the global thread pool if GLC_State::isParallelCullingActivated()
+ *  and there are enough instances, the selected LODs are the same as the serial ones.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_LodSelector
+{
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    GLC_LodSelector();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the maximum error in pixels
+    inline double pixelErrorThreshold() const
+    {return m_PixelErrorThreshold;}
+
+    //! Return the hysteresis ratio
+    inline double hysteresis() const
+    {return m_Hysteresis;}
+
+    //! Return the triangle budget, 0 if there is no budget
+    inline quint64 triangleBudget() const
+    {return m_TriangleBudget;}
+
+    //! Return the number of triangles of the LODs selected by the last selection
+    inline quint64 selectedTriangleCount() const
+    {return m_SelectedTriangleCount;}
+
+    //! Return the number of bodies made coarser to fit the budget by the last selection
+    inline int coarsenedBodyCount() const
+    {return m_CoarsenedBodyCount;}
+
+    //! Return the number of bodies culled because they are too small by the last selection
+    inline int culledBodyCount() const
+    {return m_CulledBodyCount;}
+
+    //! Return the LOD value (0 to 100) of the given LOD index of a mesh with the given LOD count
+    static int lodValue(int lodIndex, int lodCount);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Set the maximum error in pixels
+    inline void setPixelErrorThreshold(double threshold)
+    {m_PixelErrorThreshold= qMax(0.0, threshold);}
+
+    //! Set the hysteresis ratio, between 0 and 1
+    inline void setHysteresis(double hysteresis)
+    {m_Hysteresis= qBound(0.0, hysteresis, 1.0);}
+
+    //! Set the triangle budget, 0 for no budget
+    inline void setTriangleBudget(quint64 budget)
+    {m_TriangleBudget= budget;}
+
+    //! Select the LOD of the viewable bodies of the given collection seen from the given viewport
+    void selectLods(GLC_3DViewCollection* pCollection, GLC_Viewport* pView);
+
+    //! Remove the selected LODs from the instances of the given collection
+    static void clearLods(GLC_3DViewCollection* pCollection);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Body of the current selection
+    struct Body
+    {
+        GLC_3DViewInstance* m_pInstance;
+        GLC_Mesh* m_pMesh;
+        int m_BodyIndex;
+        int m_LodIndex;
+        double m_Coverage;
+    };
+
+    //! View parameters of the current selection
+    struct View
+    {
+        bool m_UseOrtho;
+        GLC_Point3d m_Eye;
+        double m_DistEyeTarget;
+        double m_ViewTangent;
+        double m_ViewHeight;
+        double m_CullingRatio;
+        bool m_PixelCulling;
+        bool m_RecordLods;
+    };
+
+    //! A range of instances processed by one thread
+    struct Chunk
+    {
+        int m_Begin;
+        int m_End;
+        QVector<Body> m_Bodies;
+        QVector<int> m_LodValues;
+        quint64 m_TriangleCount;
+        int m_CulledBodyCount;
+    };
+
+    //! Minimum number of instances of a parallel chunk
+    enum {ChunkSize= 128};
+
+    //! Select the LOD of the bodies of the instances of the given chunk
+    void selectChunkLods(const View& view, Chunk* pChunk) const;
+
+    //! Return the LOD index of the given body from its LOD accuracies
+    int lodFromError(const GLC_Mesh* pMesh, int previousLod, double pixelsPerUnit) const;
+
+    //! Coarsen the bodies until the triangle budget is reached
+    void applyBudget();
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The maximum error in pixels
+    double m_PixelErrorThreshold;
+
+    //! The hysteresis ratio
+    double m_Hysteresis;
+
+    //! The triangle budget
+    quint64 m_TriangleBudget;
+
+    //! Bodies with more than one LOD of the current selection
+    QVector<Body> m_Bodies;
+
+    //! Viewable instances of the current selection
+    QVector<GLC_3DViewInstance*> m_Instances;
+
+    //! Chunks of the current selection
+    QVector<Chunk> m_Chunks;
+
+    //! Statistics of the last selection
+    quint64 m_SelectedTriangleCount;
+    int m_CoarsenedBodyCount;
+    int m_CulledBodyCount;
+};
+
+#endif /* GLC_LODSELECTOR_H_ */
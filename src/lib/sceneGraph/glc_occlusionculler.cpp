@@ -0,0 +1,483 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_occlusionculler.cpp implementation of the GLC_OcclusionCuller class.
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define GLC_OCCLUSION_USE_SSE2 1
+#endif
+
+#include "glc_occlusionculler.h"
+#include "glc_3dviewcollection.h"
+#include "glc_3dviewinstance.h"
+#include "../geometry/glc_mesh.h"
+#include "../shading/glc_material.h"
+
+namespace
+{
+    //! Vertices behind this clip w are not projected
+    const float nearClipW= 1e-5f;
+
+    //! Return the size of the given pyramid level
+    inline int levelSize(int size, int level)
+    {
+        return qMax(1, (size + (1 << level) - 1) >> level);
+    }
+}
+
+GLC_OcclusionCuller::GLC_OcclusionCuller(GLC_3DViewCollection* pCollection, int width, int height)
+    : m_pCollection(pCollection)
+    , m_Width(0)
+    , m_Height(0)
+    , m_Stride(0)
+    , m_DepthBuffer()
+    , m_Pyramid()
+    , m_CompositionMatrix()
+    , m_OccluderIds()
+    , m_OccluderTrianglesHash()
+    , m_ClipVertices()
+    , m_OccludedIds()
+    , m_TestedCount(0)
+    , m_RasterizedTriangleCount(0)
+    , m_MatrixRevision(0)
+    , m_IsValid(false)
+{
+    setResolution(width, height);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_OcclusionCuller::isOutdated() const
+{
+    return !m_IsValid || (m_MatrixRevision != GLC_3DViewInstance::matrixRevision());
+}
+
+QVector<float> GLC_OcclusionCuller::depthBuffer() const
+{
+    QVector<float> subject;
+    if (!m_Pyramid.isEmpty()) subject= m_Pyramid.first();
+
+    return subject;
+}
+
+bool GLC_OcclusionCuller::isOccluded(const GLC_BoundingBox& box) const
+{
+    if (box.isEmpty() || m_Pyramid.isEmpty()) return false;
+
+    const double* pMatrix= m_CompositionMatrix.getData();
+    const GLC_Point3d& lower= box.lowerCorner();
+    const GLC_Point3d& upper= box.upperCorner();
+
+    float minX= static_cast<float>(m_Width);
+    float maxX= 0.0f;
+    float minY= static_cast<float>(m_Height);
+    float maxY= 0.0f;
+    float minDepth= 1.0f;
+    for (int i= 0; i < 8; ++i)
+    {
+        const double x= (i & 1) ? upper.x() : lower.x();
+        const double y= (i & 2) ? upper.y() : lower.y();
+        const double z= (i & 4) ? upper.z() : lower.z();
+        const double clipW= pMatrix[3] * x + pMatrix[7] * y + pMatrix[11] * z + pMatrix[15];
+
+        // The box crosses the near plane
+        if (clipW <= nearClipW) return false;
+
+        const double clipX= pMatrix[0] * x + pMatrix[4] * y + pMatrix[8] * z + pMatrix[12];
+        const double clipY= pMatrix[1] * x + pMatrix[5] * y + pMatrix[9] * z + pMatrix[13];
+        const double clipZ= pMatrix[2] * x + pMatrix[6] * y + pMatrix[10] * z + pMatrix[14];
+        const float screenX= static_cast<float>((clipX / clipW * 0.5 + 0.5) * m_Width);
+        const float screenY= static_cast<float>((clipY / clipW * 0.5 + 0.5) * m_Height);
+        const float depth= static_cast<float>(clipZ / clipW * 0.5 + 0.5);
+
+        minX= qMin(minX, screenX);
+        maxX= qMax(maxX, screenX);
+        minY= qMin(minY, screenY);
+        maxY= qMax(maxY, screenY);
+        minDepth= qMin(minDepth, depth);
+    }
+
+    if (minDepth <= 0.0f) return false;
+
+    // Off screen parts are left to the frustum culling
+    const int x0= qMax(0, static_cast<int>(std::floor(minX)));
+    const int x1= qMin(m_Width - 1, static_cast<int>(std::floor(maxX)));
+    const int y0= qMax(0, static_cast<int>(std::floor(minY)));
+    const int y1= qMin(m_Height - 1, static_cast<int>(std::floor(maxY)));
+    if ((x0 > x1) || (y0 > y1)) return false;
+
+    // Level where the box covers at most 2 x 2 texels
+    const int levelCount= m_Pyramid.size();
+    int level= 0;
+    while (((level + 1) < levelCount) && (((x1 >> level) - (x0 >> level)) > 1 || ((y1 >> level) - (y0 >> level)) > 1))
+    {
+        ++level;
+    }
+
+    const QVector<float>& depths= m_Pyramid.at(level);
+    const int width= levelSize(m_Width, level);
+    float maxDepth= 0.0f;
+    for (int y= (y0 >> level); y <= (y1 >> level); ++y)
+    {
+        for (int x= (x0 >> level); x <= (x1 >> level); ++x)
+        {
+            maxDepth= qMax(maxDepth, depths.at(y * width + x));
+        }
+    }
+
+    return minDepth > maxDepth;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_OcclusionCuller::set3DViewCollection(GLC_3DViewCollection* pCollection)
+{
+    m_pCollection= pCollection;
+    m_OccluderTrianglesHash.clear();
+    m_OccludedIds.clear();
+    m_IsValid= false;
+}
+
+void GLC_OcclusionCuller::setResolution(int width, int height)
+{
+    m_Width= qMax(1, width);
+    m_Height= qMax(1, height);
+
+    // Rows are padded to be written 4 pixels at a time
+    m_Stride= (m_Width + 3) & ~3;
+    m_DepthBuffer.fill(1.0f, m_Stride * m_Height);
+    m_Pyramid.clear();
+    m_IsValid= false;
+}
+
+void GLC_OcclusionCuller::addOccluder(GLC_uint instanceId)
+{
+    m_OccluderIds.insert(instanceId);
+    m_IsValid= false;
+}
+
+void GLC_OcclusionCuller::removeOccluder(GLC_uint instanceId)
+{
+    m_OccluderIds.remove(instanceId);
+    m_OccluderTrianglesHash.remove(instanceId);
+    m_IsValid= false;
+}
+
+void GLC_OcclusionCuller::clearOccluders()
+{
+    m_OccluderIds.clear();
+    m_OccluderTrianglesHash.clear();
+    m_IsValid= false;
+}
+
+void GLC_OcclusionCuller::restoreOccludedInstances()
+{
+    if (nullptr != m_pCollection)
+    {
+        const int count= m_OccludedIds.size();
+        for (int i= 0; i < count; ++i)
+        {
+            const GLC_uint instanceId= m_OccludedIds.at(i);
+            if (m_pCollection->contains(instanceId))
+            {
+                m_pCollection->instanceHandle(instanceId)->setViewable(GLC_3DViewInstance::FullViewable);
+            }
+        }
+    }
+    m_OccludedIds.clear();
+}
+
+void GLC_OcclusionCuller::updateViewableInstances(const GLC_Matrix4x4& compositionMatrix)
+{
+    Q_ASSERT(nullptr != m_pCollection);
+
+    m_CompositionMatrix= compositionMatrix;
+    m_MatrixRevision= GLC_3DViewInstance::matrixRevision();
+    m_IsValid= true;
+    m_OccludedIds.clear();
+    m_TestedCount= 0;
+
+    rasterizeOccluders();
+    buildPyramid();
+
+    const bool showState= m_pCollection->showState();
+    const QList<GLC_3DViewInstance*> instances(m_pCollection->instancesHandle());
+    const int count= instances.size();
+    for (int i= 0; i < count; ++i)
+    {
+        GLC_3DViewInstance* pInstance= instances.at(i);
+        if ((pInstance->isVisible() == showState) && (pInstance->viewableFlag() != GLC_3DViewInstance::NoViewable)
+                && !m_OccluderIds.contains(pInstance->id()))
+        {
+            ++m_TestedCount;
+            if (isOccluded(pInstance->boundingBox()))
+            {
+                pInstance->setViewable(GLC_3DViewInstance::NoViewable);
+                m_OccludedIds.append(pInstance->id());
+            }
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_OcclusionCuller::rasterizeOccluders()
+{
+    m_DepthBuffer.fill(1.0f);
+    m_RasterizedTriangleCount= 0;
+
+    const bool showState= m_pCollection->showState();
+    const QList<GLC_uint> occluderIds(m_OccluderIds.values());
+    for (GLC_uint occluderId : occluderIds)
+    {
+        if (!m_pCollection->contains(occluderId)) continue;
+        GLC_3DViewInstance* pInstance= m_pCollection->instanceHandle(occluderId);
+        if ((pInstance->isVisible() != showState) || (pInstance->viewableFlag() == GLC_3DViewInstance::NoViewable)) continue;
+
+        const QPair<GLfloatVector, IndexList>& triangles= occluderTriangles(pInstance);
+        const GLfloatVector& positions= triangles.first;
+        const IndexList& indexList= triangles.second;
+        if (indexList.isEmpty()) continue;
+
+        // Clip coordinates of the occluder vertices
+        const GLC_Matrix4x4 matrix(m_CompositionMatrix * pInstance->matrix());
+        const double* pMatrix= matrix.getData();
+        const int vertexCount= positions.size() / 3;
+        m_ClipVertices.resize(vertexCount * 4);
+        float* pClip= m_ClipVertices.data();
+        for (int i= 0; i < vertexCount; ++i)
+        {
+            const double x= positions.at(i * 3);
+            const double y= positions.at(i * 3 + 1);
+            const double z= positions.at(i * 3 + 2);
+            const double clipW= pMatrix[3] * x + pMatrix[7] * y + pMatrix[11] * z + pMatrix[15];
+            float* pVertex= pClip + i * 4;
+            pVertex[3]= static_cast<float>(clipW);
+            if (clipW > nearClipW)
+            {
+                // Screen coordinates and depth
+                pVertex[0]= static_cast<float>(((pMatrix[0] * x + pMatrix[4] * y + pMatrix[8] * z + pMatrix[12]) / clipW * 0.5 + 0.5) * m_Width);
+                pVertex[1]= static_cast<float>(((pMatrix[1] * x + pMatrix[5] * y + pMatrix[9] * z + pMatrix[13]) / clipW * 0.5 + 0.5) * m_Height);
+                pVertex[2]= static_cast<float>((pMatrix[2] * x + pMatrix[6] * y + pMatrix[10] * z + pMatrix[14]) / clipW * 0.5 + 0.5);
+            }
+        }
+
+        const int indexCount= indexList.size() - (indexList.size() % 3);
+        for (int i= 0; i < indexCount; i+= 3)
+        {
+            const float* pV0= pClip + indexList.at(i) * 4;
+            const float* pV1= pClip + indexList.at(i + 1) * 4;
+            const float* pV2= pClip + indexList.at(i + 2) * 4;
+
+            // Triangles crossing the near plane are not clipped, they don't occlude
+            if ((pV0[3] <= nearClipW) || (pV1[3] <= nearClipW) || (pV2[3] <= nearClipW)) continue;
+            rasterizeTriangle(pV0, pV1, pV2);
+        }
+    }
+}
+
+void GLC_OcclusionCuller::rasterizeTriangle(const float* pV0, const float* pV1, const float* pV2)
+{
+    float area= (pV1[0] - pV0[0]) * (pV2[1] - pV0[1]) - (pV1[1] - pV0[1]) * (pV2[0] - pV0[0]);
+    if (std::fabs(area) < 1e-8f) return;
+
+    // Occluders are two sided, the triangle is made counter clockwise
+    if (area < 0.0f)
+    {
+        qSwap(pV1, pV2);
+        area= -area;
+    }
+
+    const int minX= qMax(0, static_cast<int>(std::floor(qMin(pV0[0], qMin(pV1[0], pV2[0])))));
+    const int maxX= qMin(m_Width - 1, static_cast<int>(std::floor(qMax(pV0[0], qMax(pV1[0], pV2[0])))));
+    const int minY= qMax(0, static_cast<int>(std::floor(qMin(pV0[1], qMin(pV1[1], pV2[1])))));
+    const int maxY= qMin(m_Height - 1, static_cast<int>(std::floor(qMax(pV0[1], qMax(pV1[1], pV2[1])))));
+    if ((minX > maxX) || (minY > maxY)) return;
+    ++m_RasterizedTriangleCount;
+
+    // Edge functions, the one of an edge is the barycentric weight of the opposite vertex
+    const float stepX0= pV1[1] - pV2[1];
+    const float stepX1= pV2[1] - pV0[1];
+    const float stepX2= pV0[1] - pV1[1];
+
+    // Depth is affine in screen space
+    const float invArea= 1.0f / area;
+    const float z0= pV0[2] * invArea;
+    const float z1= pV1[2] * invArea;
+    const float z2= pV2[2] * invArea;
+
+    // Rows start on a 4 pixels boundary
+    const int startX= minX & ~3;
+    const float pixelX= static_cast<float>(startX) + 0.5f;
+
+#if defined(GLC_OCCLUSION_USE_SSE2)
+    const __m128 offsets= _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    const __m128 stepX0x4= _mm_set1_ps(stepX0 * 4.0f);
+    const __m128 stepX1x4= _mm_set1_ps(stepX1 * 4.0f);
+    const __m128 stepX2x4= _mm_set1_ps(stepX2 * 4.0f);
+    const __m128 depth0= _mm_set1_ps(z0);
+    const __m128 depth1= _mm_set1_ps(z1);
+    const __m128 depth2= _mm_set1_ps(z2);
+    const __m128 zero= _mm_setzero_ps();
+#endif
+
+    for (int y= minY; y <= maxY; ++y)
+    {
+        const float pixelY= static_cast<float>(y) + 0.5f;
+        const float w0Row= (pV2[0] - pV1[0]) * (pixelY - pV1[1]) - (pV2[1] - pV1[1]) * (pixelX - pV1[0]);
+        const float w1Row= (pV0[0] - pV2[0]) * (pixelY - pV2[1]) - (pV0[1] - pV2[1]) * (pixelX - pV2[0]);
+        const float w2Row= (pV1[0] - pV0[0]) * (pixelY - pV0[1]) - (pV1[1] - pV0[1]) * (pixelX - pV0[0]);
+        float* pRow= m_DepthBuffer.data() + y * m_Stride;
+
+#if defined(GLC_OCCLUSION_USE_SSE2)
+        __m128 w0= _mm_add_ps(_mm_set1_ps(w0Row), _mm_mul_ps(offsets, _mm_set1_ps(stepX0)));
+        __m128 w1= _mm_add_ps(_mm_set1_ps(w1Row), _mm_mul_ps(offsets, _mm_set1_ps(stepX1)));
+        __m128 w2= _mm_add_ps(_mm_set1_ps(w2Row), _mm_mul_ps(offsets, _mm_set1_ps(stepX2)));
+        for (int x= startX; x <= maxX; x+= 4)
+        {
+            const __m128 inside= _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(w0, zero), _mm_cmpge_ps(w1, zero)), _mm_cmpge_ps(w2, zero));
+            if (_mm_movemask_ps(inside))
+            {
+                const __m128 depth= _mm_add_ps(_mm_add_ps(_mm_mul_ps(w0, depth0), _mm_mul_ps(w1, depth1)), _mm_mul_ps(w2, depth2));
+                const __m128 current= _mm_loadu_ps(pRow + x);
+                const __m128 nearest= _mm_min_ps(current, depth);
+                _mm_storeu_ps(pRow + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+            }
+            w0= _mm_add_ps(w0, stepX0x4);
+            w1= _mm_add_ps(w1, stepX1x4);
+            w2= _mm_add_ps(w2, stepX2x4);
+        }
+#else
+        float w0= w0Row;
+        float w1= w1Row;
+        float w2= w2Row;
+        for (int x= startX; x <= maxX; ++x)
+        {
+            if ((w0 >= 0.0f) && (w1 >= 0.0f) && (w2 >= 0.0f))
+            {
+                const float depth= w0 * z0 + w1 * z1 + w2 * z2;
+                if (depth < pRow[x]) pRow[x]= depth;
+            }
+            w0+= stepX0;
+            w1+= stepX1;
+            w2+= stepX2;
+        }
+#endif
+    }
+}
+
+void GLC_OcclusionCuller::buildPyramid()
+{
+    // First level is the depth buffer without row padding
+    QVector<float> firstLevel(m_Width * m_Height);
+    for (int y= 0; y < m_Height; ++y)
+    {
+        memcpy(firstLevel.data() + y * m_Width, m_DepthBuffer.constData() + y * m_Stride, m_Width * sizeof(float));
+    }
+    m_Pyramid.clear();
+    m_Pyramid.append(firstLevel);
+
+    // Each texel is the farthest depth of the 2 x 2 texels of the previous level
+    int level= 0;
+    while ((levelSize(m_Width, level) > 1) || (levelSize(m_Height, level) > 1))
+    {
+        const QVector<float>& previous= m_Pyramid.at(level);
+        const int previousWidth= levelSize(m_Width, level);
+        const int previousHeight= levelSize(m_Height, level);
+        ++level;
+        const int width= levelSize(m_Width, level);
+        const int height= levelSize(m_Height, level);
+
+        QVector<float> current(width * height);
+        for (int y= 0; y < height; ++y)
+        {
+            const int y0= qMin(y * 2, previousHeight - 1);
+            const int y1= qMin(y * 2 + 1, previousHeight - 1);
+            for (int x= 0; x < width; ++x)
+            {
+                const int x0= qMin(x * 2, previousWidth - 1);
+                const int x1= qMin(x * 2 + 1, previousWidth - 1);
+                const float depth= qMax(qMax(previous.at(y0 * previousWidth + x0), previous.at(y0 * previousWidth + x1))
+                                        , qMax(previous.at(y1 * previousWidth + x0), previous.at(y1 * previousWidth + x1)));
+                current[y * width + x]= depth;
+            }
+        }
+        m_Pyramid.append(current);
+    }
+}
+
+const QPair<GLfloatVector, IndexList>& GLC_OcclusionCuller::occluderTriangles(GLC_3DViewInstance* pInstance)
+{
+    const GLC_uint instanceId= pInstance->id();
+    const QVector<quint64> revisions(meshRevisions(pInstance));
+    QHash<GLC_uint, OccluderTriangles>::iterator iTriangles= m_OccluderTrianglesHash.find(instanceId);
+    if ((iTriangles == m_OccluderTrianglesHash.end()) || (iTriangles.value().m_MeshRevisions != revisions))
+    {
+        QPair<GLfloatVector, IndexList> triangles;
+        const int bodyCount= pInstance->numberOfBody();
+        for (int i= 0; i < bodyCount; ++i)
+        {
+            GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(pInstance->geomAt(i));
+            if ((nullptr == pMesh) || pMesh->isEmpty()) continue;
+
+            const GLfloatVector& positions= pMesh->positionVector();
+            if (positions.size() < 3) continue;
+            const GLuint offset= static_cast<GLuint>(triangles.first.size() / 3);
+            triangles.first+= positions;
+
+            const IndexList index(pMesh->equivalentTrianglesIndex(0));
+            for (GLuint vertexIndex : index)
+            {
+                triangles.second.append(offset + vertexIndex);
+            }
+        }
+        const OccluderTriangles cachedTriangles= {triangles, revisions};
+        iTriangles= m_OccluderTrianglesHash.insert(instanceId, cachedTriangles);
+    }
+
+    return iTriangles.value().m_Triangles;
+}
+
+QVector<quint64> GLC_OcclusionCuller::meshRevisions(GLC_3DViewInstance* pInstance)
+{
+    QVector<quint64> subject;
+    const int bodyCount= pInstance->numberOfBody();
+    for (int i= 0; i < bodyCount; ++i)
+    {
+        const GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(pInstance->geomAt(i));
+        if (nullptr != pMesh)
+        {
+            subject << pMesh->id() << pMesh->revision();
+        }
+    }
+
+    return subject;
+}
@@ -0,0 +1,223 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_occlusionculler.h interface for the GLC_OcclusionCuller class.
+
+#ifndef GLC_OCCLUSIONCULLER_H_
+#define GLC_OCCLUSIONCULLER_H_
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QSet>
+#include <QVector>
+
+#include "../glc_global.h"
+#include "../maths/glc_matrix4x4.h"
+
+#include "../glc_config.h"
+
+class GLC_3DViewCollection;
+class GLC_3DViewInstance;
+class GLC_BoundingBox;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_OcclusionCuller
+/*! \brief GLC_OcclusionCuller : Occlusion culling with a software depth buffer*/
+
+/*! The triangles of the occluder instances are rasterized in a low resolution
+ *  depth buffer on the CPU, then a hierarchical Z pyramid (farthest depth of each
+ *  2 x 2 block) is built from it.
+ *
+ *  The bounding box of each other viewable instance is projected on the screen,
+ *  the instance is not viewable if the nearest depth of its box is behind the
+ *  farthest depth of the pyramid texels which cover it.
+ *
+ *  Occluders should be few, big and closed : walls, floors, hulls...
+ *  Only the first LOD of their meshes is used and their client side data must be available.
+ *  The triangles of an occluder are kept until the revision of one of its meshes changes
+ *  (See GLC_Geometry::revision()).
+ *  Instances crossing the near plane are never culled.
+ *
+ *  The culler is bound to a GLC_3DViewCollection which runs it after the frustum culling.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_OcclusionCuller
+{
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Construct an occlusion culler of the given collection with the given depth buffer size
+    explicit GLC_OcclusionCuller(GLC_3DViewCollection* pCollection= nullptr, int width= 256, int height= 128);
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the width of the depth buffer
+    inline int width() const
+    {return m_Width;}
+
+    //! Return the height of the depth buffer
+    inline int height() const
+    {return m_Height;}
+
+    //! Return the id of occluder instances
+    inline QList<GLC_uint> occluderIds() const
+    {return m_OccluderIds.values();}
+
+    //! Return true if the given instance is an occluder
+    inline bool isOccluder(GLC_uint instanceId) const
+    {return m_OccluderIds.contains(instanceId);}
+
+    //! Return true if the viewable state must be updated
+    bool isOutdated() const;
+
+    //! Return the number of instances tested by the last update
+    inline int testedCount() const
+    {return m_TestedCount;}
+
+    //! Return the number of instances culled by the last update
+    inline int culledCount() const
+    {return m_OccludedIds.size();}
+
+    //! Return the number of occluder triangles rasterized by the last update
+    inline int rasterizedTriangleCount() const
+    {return m_RasterizedTriangleCount;}
+
+    //! Return the depth buffer of the last update, row by row, 1.0 is the far plane
+    QVector<float> depthBuffer() const;
+
+    //! Return true if the given world box is hidden in the last update depth buffer
+    bool isOccluded(const GLC_BoundingBox& box) const;
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Set the collection of this culler
+    void set3DViewCollection(GLC_3DViewCollection* pCollection);
+
+    //! Set the size of the depth buffer
+    void setResolution(int width, int height);
+
+    //! Add the given instance to the occluders
+    void addOccluder(GLC_uint instanceId);
+
+    //! Remove the given instance from the occluders
+    void removeOccluder(GLC_uint instanceId);
+
+    //! Remove all occluders
+    void clearOccluders();
+
+    //! Update the viewable state on next update
+    /*! Must be called when the visibility or the geometry of instances have changed*/
+    inline void invalidate()
+    {m_IsValid= false;}
+
+    //! Set the instances culled by the last update viewable
+    void restoreOccludedInstances();
+
+    //! Rasterize the occluders and set the hidden instances not viewable
+    /*! The given matrix is the projection matrix multiplied by the model view matrix*/
+    void updateViewableInstances(const GLC_Matrix4x4& compositionMatrix);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Clear the depth buffer and rasterize the occluders
+    void rasterizeOccluders();
+
+    //! Rasterize the given triangle in screen coordinates (x, y, depth)
+    void rasterizeTriangle(const float* pV0, const float* pV1, const float* pV2);
+
+    //! Build the hierarchical Z pyramid from the depth buffer
+    void buildPyramid();
+
+    //! Return the triangles of the given occluder, built again when its meshes have changed
+    const QPair<GLfloatVector, IndexList>& occluderTriangles(GLC_3DViewInstance* pInstance);
+
+    //! Return the id and the revision of the meshes of the given instance
+    static QVector<quint64> meshRevisions(GLC_3DViewInstance* pInstance);
+
+    //! The triangles of an occluder and the revisions of the meshes used to build them
+    struct OccluderTriangles
+    {
+        QPair<GLfloatVector, IndexList> m_Triangles;
+        QVector<quint64> m_MeshRevisions;
+    };
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The culled collection
+    GLC_3DViewCollection* m_pCollection;
+
+    //! Depth buffer size and row stride
+    int m_Width;
+    int m_Height;
+    int m_Stride;
+
+    //! The depth buffer
+    QVector<float> m_DepthBuffer;
+
+    //! The pyramid levels, the first one is the depth buffer
+    QList<QVector<float> > m_Pyramid;
+
+    //! The composition matrix of the last update
+    GLC_Matrix4x4 m_CompositionMatrix;
+
+    //! The occluder instances id
+    QSet<GLC_uint> m_OccluderIds;
+
+    //! Local positions and triangles index of occluder instances
+    QHash<GLC_uint, OccluderTriangles> m_OccluderTrianglesHash;
+
+    //! Clip coordinates of the current occluder vertices
+    QVector<float> m_ClipVertices;
+
+    //! The instances culled by the last update
+    QList<GLC_uint> m_OccludedIds;
+
+    //! Statistics of the last update
+    int m_TestedCount;
+    int m_RasterizedTriangleCount;
+
+    //! The instance matrix revision of the last update
+    quint64 m_MatrixRevision;
+
+    //! False if the viewable state must be updated
+    bool m_IsValid;
+
+    Q_DISABLE_COPY(GLC_OcclusionCuller)
+};
+
+#endif /* GLC_OCCLUSIONCULLER_H_ */
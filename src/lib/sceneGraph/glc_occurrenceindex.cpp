@@ -0,0 +1,264 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_occurrenceindex.cpp implementation of the GLC_OccurrenceIndex class.
+
+#include "glc_occurrenceindex.h"
+#include "glc_structoccurrence.h"
+#include "glc_structreference.h"
+
+GLC_OccurrenceIndex::GLC_OccurrenceIndex()
+    : m_Entries()
+    , m_NameMap()
+    , m_AttributeIndex()
+    , m_ChildrenIndex()
+{
+
+}
+
+GLC_OccurrenceIndex::~GLC_OccurrenceIndex()
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+QList<GLC_uint> GLC_OccurrenceIndex::occurrencesIdFromName(const QString& name, Qt::CaseSensitivity cs) const
+{
+    QList<GLC_uint> subject;
+    QMap<QString, QSet<GLC_uint> >::const_iterator iName= m_NameMap.constFind(name.toCaseFolded());
+    if (iName != m_NameMap.constEnd())
+    {
+        if (cs == Qt::CaseInsensitive)
+        {
+            subject= iName.value().values();
+        }
+        else
+        {
+            for (GLC_uint occId : iName.value())
+            {
+                if (m_Entries.value(occId).m_Name == name)
+                {
+                    subject.append(occId);
+                }
+            }
+        }
+    }
+
+    return subject;
+}
+
+QList<GLC_uint> GLC_OccurrenceIndex::occurrencesIdFromNamePrefix(const QString& prefix, int maxCount) const
+{
+    QList<GLC_uint> subject;
+    const QString foldedPrefix(prefix.toCaseFolded());
+
+    // Names starting with the prefix are contiguous in the sorted map
+    QMap<QString, QSet<GLC_uint> >::const_iterator iName= m_NameMap.lowerBound(foldedPrefix);
+    bool continu= true;
+    while (continu && (iName != m_NameMap.constEnd()) && iName.key().startsWith(foldedPrefix))
+    {
+        QSet<GLC_uint>::const_iterator iId= iName.value().constBegin();
+        while (continu && (iId != iName.value().constEnd()))
+        {
+            subject.append(*iId);
+            continu= (maxCount < 0) || (subject.size() < maxCount);
+            ++iId;
+        }
+        ++iName;
+    }
+
+    return subject;
+}
+
+QList<GLC_uint> GLC_OccurrenceIndex::occurrencesIdWithAttribute(const QString& attributeName) const
+{
+    QSet<GLC_uint> subjectSet;
+    const QHash<QString, QSet<GLC_uint> > values(m_AttributeIndex.value(attributeName));
+    QHash<QString, QSet<GLC_uint> >::const_iterator iValue= values.constBegin();
+    while (iValue != values.constEnd())
+    {
+        subjectSet.unite(iValue.value());
+        ++iValue;
+    }
+
+    return subjectSet.values();
+}
+
+QList<GLC_uint> GLC_OccurrenceIndex::occurrencesIdFromAttribute(const QString& attributeName, const QString& value) const
+{
+    QList<GLC_uint> subject;
+    QHash<QString, QHash<QString, QSet<GLC_uint> > >::const_iterator iAttrib= m_AttributeIndex.constFind(attributeName);
+    if (iAttrib != m_AttributeIndex.constEnd())
+    {
+        subject= iAttrib.value().value(value).values();
+    }
+
+    return subject;
+}
+
+QList<GLC_uint> GLC_OccurrenceIndex::childrenIdFromReferenceName(GLC_uint parentId, const QString& referenceName) const
+{
+    QList<GLC_uint> subject;
+    QHash<GLC_uint, QHash<QString, QSet<GLC_uint> > >::const_iterator iParent= m_ChildrenIndex.constFind(parentId);
+    if (iParent != m_ChildrenIndex.constEnd())
+    {
+        subject= iParent.value().value(referenceName).values();
+    }
+
+    return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_OccurrenceIndex::insert(const GLC_StructOccurrence* pOcc)
+{
+    Q_ASSERT(nullptr != pOcc);
+    const GLC_uint occId= pOcc->id();
+
+    // Update : remove the previous entry
+    remove(occId);
+
+    IndexEntry entry;
+    entry.m_ParentId= 0;
+    if (nullptr != pOcc->structInstance())
+    {
+        entry.m_Name= pOcc->name();
+        entry.m_FoldedName= entry.m_Name.toCaseFolded();
+        m_NameMap[entry.m_FoldedName].insert(occId);
+
+        if (nullptr != pOcc->structReference())
+        {
+            entry.m_ReferenceName= pOcc->structReference()->name();
+        }
+        appendAttributes(&entry, pOcc);
+        for (const QPair<QString, QString>& attribute : entry.m_Attributes)
+        {
+            m_AttributeIndex[attribute.first][attribute.second].insert(occId);
+        }
+    }
+
+    if (pOcc->hasParent())
+    {
+        entry.m_ParentId= pOcc->parent()->id();
+        m_ChildrenIndex[entry.m_ParentId][entry.m_ReferenceName].insert(occId);
+    }
+
+    m_Entries.insert(occId, entry);
+}
+
+void GLC_OccurrenceIndex::remove(GLC_uint occId)
+{
+    QHash<GLC_uint, IndexEntry>::iterator iEntry= m_Entries.find(occId);
+    if (iEntry != m_Entries.end())
+    {
+        unlinkEntry(occId, iEntry.value());
+        m_Entries.erase(iEntry);
+    }
+}
+
+void GLC_OccurrenceIndex::clear()
+{
+    m_Entries.clear();
+    m_NameMap.clear();
+    m_AttributeIndex.clear();
+    m_ChildrenIndex.clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_OccurrenceIndex::appendAttributes(IndexEntry* pEntry, const GLC_StructOccurrence* pOcc)
+{
+    // Instance attributes overload reference attributes
+    const GLC_StructInstance* pInstance= pOcc->structInstance();
+    QSet<QString> names;
+    if (pInstance->containsAttributes())
+    {
+        const GLC_Attributes* pAttributes= pInstance->attributesHandle();
+        const QList<QString> attributesName(pAttributes->names());
+        for (const QString& name : attributesName)
+        {
+            names.insert(name);
+            pEntry->m_Attributes.append(qMakePair(name, pAttributes->value(name).toString()));
+        }
+    }
+
+    const GLC_StructReference* pRef= pInstance->structReference();
+    if ((nullptr != pRef) && pRef->containsAttributes())
+    {
+        const GLC_Attributes* pAttributes= pRef->attributesHandle();
+        const QList<QString> attributesName(pAttributes->names());
+        for (const QString& name : attributesName)
+        {
+            if (!names.contains(name))
+            {
+                pEntry->m_Attributes.append(qMakePair(name, pAttributes->value(name).toString()));
+            }
+        }
+    }
+}
+
+void GLC_OccurrenceIndex::unlinkEntry(GLC_uint occId, const IndexEntry& entry)
+{
+    QMap<QString, QSet<GLC_uint> >::iterator iName= m_NameMap.find(entry.m_FoldedName);
+    if (iName != m_NameMap.end())
+    {
+        iName.value().remove(occId);
+        if (iName.value().isEmpty()) m_NameMap.erase(iName);
+    }
+
+    for (const QPair<QString, QString>& attribute : entry.m_Attributes)
+    {
+        QHash<QString, QHash<QString, QSet<GLC_uint> > >::iterator iAttrib= m_AttributeIndex.find(attribute.first);
+        if (iAttrib != m_AttributeIndex.end())
+        {
+            QHash<QString, QSet<GLC_uint> >::iterator iValue= iAttrib.value().find(attribute.second);
+            if (iValue != iAttrib.value().end())
+            {
+                iValue.value().remove(occId);
+                if (iValue.value().isEmpty()) iAttrib.value().erase(iValue);
+            }
+            if (iAttrib.value().isEmpty()) m_AttributeIndex.erase(iAttrib);
+        }
+    }
+
+    if (0 != entry.m_ParentId)
+    {
+        QHash<GLC_uint, QHash<QString, QSet<GLC_uint> > >::iterator iParent= m_ChildrenIndex.find(entry.m_ParentId);
+        if (iParent != m_ChildrenIndex.end())
+        {
+            QHash<QString, QSet<GLC_uint> >::iterator iChildren= iParent.value().find(entry.m_ReferenceName);
+            if (iChildren != iParent.value().end())
+            {
+                iChildren.value().remove(occId);
+                if (iChildren.value().isEmpty()) iParent.value().erase(iChildren);
+            }
+            if (iParent.value().isEmpty()) m_ChildrenIndex.erase(iParent);
+        }
+    }
+}
@@ -0,0 +1,163 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_occurrenceindex.h interface for the GLC_OccurrenceIndex class.
+
+#ifndef GLC_OCCURRENCEINDEX_H_
+#define GLC_OCCURRENCEINDEX_H_
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+#include "../glc_global.h"
+
+#include "../glc_config.h"
+
+class GLC_StructOccurrence;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_OccurrenceIndex
+/*! \brief GLC_OccurrenceIndex : Lookup index of the occurrences of a GLC_WorldHandle */
+
+/*! The index is maintained incrementally by the world handle when occurrences
+ *  are added, removed or re-parented. It contains :
+ *  - A sorted case folded name map used for exact and prefix (search as you type) queries
+ *  - An inverted index of instance and reference attributes (name -> value -> occurrences)
+ *  - A per parent children map keyed by reference name used to resolve occurrence paths
+ *
+ *  Names and attributes set with the set functions of GLC_StructInstance and GLC_StructReference
+ *  update the index. Attributes modified in place through attributesHandle() are not seen,
+ *  GLC_WorldHandle::updateOccurrenceIndex() must be called afterward.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_OccurrenceIndex
+{
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Construct an empty index
+    GLC_OccurrenceIndex();
+
+    ~GLC_OccurrenceIndex();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return true if the given occurrence id is indexed
+    bool contains(GLC_uint occId) const
+    {return m_Entries.contains(occId);}
+
+    //! Return the number of indexed occurrences
+    int size() const
+    {return m_Entries.size();}
+
+    //! Return the id of occurrences with the given name
+    QList<GLC_uint> occurrencesIdFromName(const QString& name, Qt::CaseSensitivity cs= Qt::CaseSensitive) const;
+
+    //! Return the id of occurrences which name starts with the given prefix (case insensitive)
+    /*! If maxCount is positive, the search is stopped when maxCount ids are found
+     *  Ids are sorted by occurrence name*/
+    QList<GLC_uint> occurrencesIdFromNamePrefix(const QString& prefix, int maxCount= -1) const;
+
+    //! Return the id of occurrences which have the given attribute
+    QList<GLC_uint> occurrencesIdWithAttribute(const QString& attributeName) const;
+
+    //! Return the id of occurrences which have the given attribute with the given value
+    QList<GLC_uint> occurrencesIdFromAttribute(const QString& attributeName, const QString& value) const;
+
+    //! Return the list of indexed attribute names
+    QStringList attributeNames() const
+    {return m_AttributeIndex.keys();}
+
+    //! Return the list of distinct values of the given attribute
+    QStringList attributeValues(const QString& attributeName) const
+    {return m_AttributeIndex.value(attributeName).keys();}
+
+    //! Return the id of the children of the given occurrence id which reference has the given name
+    QList<GLC_uint> childrenIdFromReferenceName(GLC_uint parentId, const QString& referenceName) const;
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Insert or update the given occurrence in this index
+    void insert(const GLC_StructOccurrence* pOcc);
+
+    //! Remove the given occurrence id from this index
+    void remove(GLC_uint occId);
+
+    //! Clear this index
+    void clear();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Occurrence entry of the index
+    struct IndexEntry
+    {
+        QString m_Name;
+        QString m_FoldedName;
+        GLC_uint m_ParentId;
+        QString m_ReferenceName;
+        QList<QPair<QString, QString> > m_Attributes;
+    };
+
+    //! Add the attributes of the given occurrence to the given entry
+    static void appendAttributes(IndexEntry* pEntry, const GLC_StructOccurrence* pOcc);
+
+    //! Remove the given entry from the index tables
+    void unlinkEntry(GLC_uint occId, const IndexEntry& entry);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Index entries by occurrence id
+    QHash<GLC_uint, IndexEntry> m_Entries;
+
+    //! Sorted case folded occurrence name to occurrences id
+    QMap<QString, QSet<GLC_uint> > m_NameMap;
+
+    //! Attribute name -> attribute value -> occurrences id
+    QHash<QString, QHash<QString, QSet<GLC_uint> > > m_AttributeIndex;
+
+    //! Parent occurrence id -> reference name -> children occurrences id
+    QHash<GLC_uint, QHash<QString, QSet<GLC_uint> > > m_ChildrenIndex;
+
+    Q_DISABLE_COPY(GLC_OccurrenceIndex)
+};
+
+#endif /* GLC_OCCURRENCEINDEX_H_ */
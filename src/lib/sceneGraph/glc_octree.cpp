@@ -32,6 +32,9 @@ GLC_Octree::GLC_Octree(GLC_3DViewCollection* pCollection)
 : GLC_SpacePartitioning(pCollection)
 , m_pRootNode(NULL)
 , m_OctreeDepth(m_DefaultOctreeDepth)
+, m_Looseness(2.0)
+, m_InstanceNodeHash()
+, m_FrustumCuller()
 {
 
 }
@@ -40,6 +43,9 @@ GLC_Octree::GLC_Octree(const GLC_Octree& octree)
 : GLC_SpacePartitioning(octree)
 , m_pRootNode(NULL)
 , m_OctreeDepth(octree.m_OctreeDepth)
+, m_Looseness(octree.m_Looseness)
+, m_InstanceNodeHash()
+, m_FrustumCuller()
 {
 
 }
@@ -76,28 +82,68 @@ void GLC_Octree::updateViewableInstances(const GLC_Frustum& frustum)
 	{
 		updateSpacePartitioning();
 	}
-	m_pRootNode->updateViewableInstances(frustum);
+	m_pRootNode->updateViewableInstances(frustum, &m_FrustumCuller);
+	m_FrustumCuller.updateViewableInstances(frustum);
     //qDebug() << "ViewVable instance count " << m_pRootNode->viewableInstanceCount();
 }
 
 void GLC_Octree::updateSpacePartitioning()
 {
-	delete m_pRootNode;
+	clear();
 	m_pRootNode= new GLC_OctreeNode(m_pCollection->boundingBox(true));
+	m_pRootNode->setLooseness(m_Looseness);
 	// fill the octree
 	QList<GLC_3DViewInstance*> instanceList(m_pCollection->instancesHandle());
 	const int size= instanceList.size();
 	for (int i= 0; i < size; ++i)
 	{
-		m_pRootNode->addInstance(instanceList.at(i), m_OctreeDepth);
+		GLC_3DViewInstance* pInstance= instanceList.at(i);
+		if (!addToNode(pInstance) && !pInstance->boundingBox().isEmpty())
+		{
+			// Bounding box of the collection not up to date
+			m_InstanceNodeHash.insert(pInstance, m_pRootNode->insertInstance(pInstance, pInstance->boundingBox(), 0));
+		}
 	}
-	m_pRootNode->removeEmptyChildren();
 }
 
 void GLC_Octree::clear()
 {
 	delete m_pRootNode;
 	m_pRootNode= NULL;
+	m_InstanceNodeHash.clear();
+}
+
+void GLC_Octree::insertInstance(GLC_3DViewInstance* pInstance)
+{
+	// The octree is filled on first use
+	if (NULL == m_pRootNode) return;
+
+	Q_ASSERT(!m_InstanceNodeHash.contains(pInstance));
+	if (!addToNode(pInstance) && !pInstance->boundingBox().isEmpty())
+	{
+		clear();
+	}
+}
+
+void GLC_Octree::removeInstance(GLC_3DViewInstance* pInstance)
+{
+	GLC_OctreeNode* pNode= m_InstanceNodeHash.take(pInstance);
+	if (NULL != pNode)
+	{
+		pNode->removeInstance(pInstance);
+	}
+}
+
+void GLC_Octree::moveInstance(GLC_3DViewInstance* pInstance)
+{
+	if (NULL == m_pRootNode) return;
+
+	GLC_OctreeNode* pNode= m_InstanceNodeHash.value(pInstance, NULL);
+	if ((NULL == pNode) || !pNode->looselyContains(pInstance->boundingBox()))
+	{
+		removeInstance(pInstance);
+		insertInstance(pInstance);
+	}
 }
 
 void GLC_Octree::setDepth(int depth)
@@ -109,6 +155,15 @@ void GLC_Octree::setDepth(int depth)
 	}
 }
 
+void GLC_Octree::setLooseness(double looseness)
+{
+	m_Looseness= qMax(1.0, looseness);
+	if (NULL != m_pRootNode)
+	{
+		updateSpacePartitioning();
+	}
+}
+
 void GLC_Octree::createBox(GLC_Material* pMat, GLC_3DViewCollection* pCol)
 {
 	if (NULL == m_pRootNode)
@@ -152,3 +207,15 @@ void GLC_Octree::createBoxWithMaterial(GLC_3DViewCollection* pCol, GLC_OctreeNod
 
 }
 
+bool GLC_Octree::addToNode(GLC_3DViewInstance* pInstance)
+{
+	Q_ASSERT(NULL != m_pRootNode);
+	const GLC_BoundingBox instanceBox(pInstance->boundingBox());
+	const bool subject= m_pRootNode->looselyContains(instanceBox);
+	if (subject)
+	{
+		m_InstanceNodeHash.insert(pInstance, m_pRootNode->insertInstance(pInstance, instanceBox, m_OctreeDepth));
+	}
+
+	return subject;
+}
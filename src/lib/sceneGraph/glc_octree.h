@@ -24,7 +24,10 @@
 #ifndef GLC_OCTREE_H_
 #define GLC_OCTREE_H_
 
+#include <QHash>
+
 #include "glc_spacepartitioning.h"
+#include "glc_frustumculler.h"
 #include "../glc_config.h"
 
 class GLC_OctreeNode;
@@ -34,6 +37,12 @@ class GLC_3DViewInstance;
 //////////////////////////////////////////////////////////////////////
 //! \class GLC_Octree
 /*! \brief GLC_Octree : represent space partioning implementation with octree */
+
+/*! The octree is loose : the bounds of each node are enlarged by the looseness and
+ *  an instance is stored in the deepest node whose loose bounds contain it.
+ *  Instances can be inserted, removed or moved one by one, a moved instance is
+ *  reinserted only if it leaves the loose bounds of its node.
+ *  The octree is rebuilt on next use if an instance leaves the loose bounds of the root node.*/
 //////////////////////////////////////////////////////////////////////
 class GLC_LIB_EXPORT GLC_Octree : public GLC_SpacePartitioning
 {
@@ -66,6 +75,14 @@ public:
 	//! Return the list off instances inside or intersect the given bounding box
 	virtual QList<GLC_3DViewInstance*> listOfIntersectedInstances(const GLC_BoundingBox& bBox);
 
+	//! Return the looseness of this octree nodes
+	inline double looseness() const
+	{return m_Looseness;}
+
+	//! Return the statistics of the last viewable instances update
+	inline const GLC_FrustumCuller::Statistics& cullingStatistics() const
+	{return m_FrustumCuller.statistics();}
+
 //@}
 //////////////////////////////////////////////////////////////////////
 /*! \name Set Functions*/
@@ -82,10 +99,23 @@ public:
 	//! Clear the space partionning
 	virtual void clear();
 
+	//! Insert the given instance added to the collection
+	virtual void insertInstance(GLC_3DViewInstance* pInstance);
+
+	//! Remove the given instance before it is removed from the collection
+	virtual void removeInstance(GLC_3DViewInstance* pInstance);
+
+	//! Update the given instance after its bounding box has changed
+	virtual void moveInstance(GLC_3DViewInstance* pInstance);
+
 	//! Set this octree depth
 	/*! If space partitionning is already done, update it*/
 	void setDepth(int);
 
+	//! Set the looseness of this octree nodes, 1.0 for tight nodes
+	/*! If space partitionning is already done, update it*/
+	void setLooseness(double looseness);
+
 	//! Create octree box representation in the given collection with the specified material
 	void createBox(GLC_Material*, GLC_3DViewCollection* pCol= NULL);
 
@@ -103,6 +133,9 @@ private:
 	/*! Create box of the given Octree node with the given material*/
 	void createBoxWithMaterial(GLC_3DViewCollection*, GLC_OctreeNode*, GLC_Material*);
 
+	//! Insert the given instance in the octree, return false if it is outside the root node
+	bool addToNode(GLC_3DViewInstance* pInstance);
+
 //////////////////////////////////////////////////////////////////////
 // Private members
 //////////////////////////////////////////////////////////////////////
@@ -113,6 +146,15 @@ private:
 	//! Octree depth
 	int m_OctreeDepth;
 
+	//! Octree nodes looseness
+	double m_Looseness;
+
+	//! The node of each inserted instance
+	QHash<GLC_3DViewInstance*, GLC_OctreeNode*> m_InstanceNodeHash;
+
+	//! The culler of instances, its buffers are kept between updates
+	GLC_FrustumCuller m_FrustumCuller;
+
 	//! The default octree Depth
 	static int m_DefaultOctreeDepth;
 };
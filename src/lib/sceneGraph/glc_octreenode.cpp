@@ -22,22 +22,38 @@
 //! \file glc_octreenode.cpp implementation for the GLC_OctreeNode class.
 
 #include "glc_octreenode.h"
+#include "glc_frustumculler.h"
 
 bool GLC_OctreeNode::m_useBoundingSphere= true;
 
+namespace
+{
+// Return true if the given point is inside or on the given box
+bool boxContainsPoint(const GLC_BoundingBox& box, const GLC_Point3d& point)
+{
+	const GLC_Point3d& lower= box.lowerCorner();
+	const GLC_Point3d& upper= box.upperCorner();
+	return (point.x() >= lower.x()) && (point.y() >= lower.y()) && (point.z() >= lower.z())
+			&& (point.x() <= upper.x()) && (point.y() <= upper.y()) && (point.z() <= upper.z());
+}
+}
+
 GLC_OctreeNode::GLC_OctreeNode(const GLC_BoundingBox& boundingBox, GLC_OctreeNode* pParent)
 : m_BoundingBox(boundingBox)
+, m_Looseness((NULL != pParent) ? pParent->m_Looseness : 1.0)
+, m_LooseBoundingBox()
 , m_pParent(pParent)
 , m_Children()
 , m_3DViewInstanceSet()
 , m_Empty(true)
 {
-
-
+	m_LooseBoundingBox= looseBox(m_BoundingBox);
 }
 
 GLC_OctreeNode::GLC_OctreeNode(const GLC_OctreeNode& octreeNode, GLC_OctreeNode* pParent)
 : m_BoundingBox(octreeNode.m_BoundingBox)
+, m_Looseness(octreeNode.m_Looseness)
+, m_LooseBoundingBox(octreeNode.m_LooseBoundingBox)
 , m_pParent(pParent)
 , m_Children()
 , m_3DViewInstanceSet(octreeNode.m_3DViewInstanceSet)
@@ -67,6 +83,12 @@ bool GLC_OctreeNode::intersectionWithBoundingSphereUsed()
 	return m_useBoundingSphere;
 }
 
+bool GLC_OctreeNode::looselyContains(const GLC_BoundingBox& boundingBox) const
+{
+	return !boundingBox.isEmpty() && boxContainsPoint(m_LooseBoundingBox, boundingBox.lowerCorner())
+			&& boxContainsPoint(m_LooseBoundingBox, boundingBox.upperCorner());
+}
+
 QSet<GLC_3DViewInstance*> GLC_OctreeNode::setOfIntersectedInstances(const GLC_BoundingBox& bBox)
 {
 	QSet<GLC_3DViewInstance*> instanceSet;
@@ -188,130 +210,99 @@ void GLC_OctreeNode::addChildren()
 }
 
 
-void GLC_OctreeNode::addInstance(GLC_3DViewInstance* pInstance, int depth)
+GLC_OctreeNode* GLC_OctreeNode::insertInstance(GLC_3DViewInstance* pInstance, const GLC_BoundingBox& instanceBox, int depth)
 {
 	m_Empty= false;
-	const GLC_BoundingBox instanceBox= pInstance->boundingBox();
-	// Check if the instance's bounding box intersect this node bounding box
-	if (!instanceBox.isEmpty() && intersect(instanceBox))
+	if (depth > 0)
 	{
-		if (0 == depth)
-		{
-			m_3DViewInstanceSet.insert(pInstance);
-		}
-		else
+		// The child is chosen from the center of the instance, its loose bounds must contain the instance
+		const GLC_Point3d center(instanceBox.center());
+		const int size= m_Children.size();
+		for (int i= 0; i < size; ++i)
 		{
-			if (m_Children.isEmpty())
-			{
-				// Create children
-				addChildren();
-			}
-			QVector<bool> childIntersect(8);
-			bool allIntersect= true;
-			for (int i= 0; i < 8; ++i)
-			{
-                const bool currentIntersect= m_Children.at(i)->intersect(instanceBox);
-				allIntersect= allIntersect && currentIntersect;
-				childIntersect[i]= currentIntersect;
-			}
-			if (allIntersect)
-			{
-				m_3DViewInstanceSet.insert(pInstance);
-			}
-			else
+			GLC_OctreeNode* pChild= m_Children.at(i);
+			if (boxContainsPoint(pChild->m_BoundingBox, center))
 			{
-				for (int i= 0; i < 8; ++i)
+				if (pChild->looselyContains(instanceBox))
 				{
-					if (childIntersect[i])
-					{
-						m_Children[i]->addInstance(pInstance, depth - 1);
-					}
+					return pChild->insertInstance(pInstance, instanceBox, depth - 1);
 				}
+				m_3DViewInstanceSet.insert(pInstance);
+				return this;
 			}
 		}
 
+		const GLC_BoundingBox childBox(octantBox(center));
+		const GLC_BoundingBox looseChildBox(looseBox(childBox));
+		if (boxContainsPoint(looseChildBox, instanceBox.lowerCorner()) && boxContainsPoint(looseChildBox, instanceBox.upperCorner()))
+		{
+			GLC_OctreeNode* pChild= new GLC_OctreeNode(childBox, this);
+			m_Children.append(pChild);
+			return pChild->insertInstance(pInstance, instanceBox, depth - 1);
+		}
 	}
-}
+	m_3DViewInstanceSet.insert(pInstance);
 
+	return this;
+}
 
-void GLC_OctreeNode::updateViewableInstances(const GLC_Frustum& frustum, QSet<GLC_3DViewInstance*>* pInstanceSet)
+void GLC_OctreeNode::removeInstance(GLC_3DViewInstance* pInstance)
 {
+	m_3DViewInstanceSet.remove(pInstance);
 
-	bool firstCall= false;
-	// Create the set of viewable instance if necessary
-	if (NULL == pInstanceSet)
+	// Delete empty nodes up to the root, this node may be deleted
+	GLC_OctreeNode* pNode= this;
+	while (pNode->m_3DViewInstanceSet.isEmpty() && pNode->m_Children.isEmpty())
 	{
-		pInstanceSet= new QSet<GLC_3DViewInstance*>();
-		firstCall= true;
+		GLC_OctreeNode* pParent= pNode->m_pParent;
+		if (NULL == pParent)
+		{
+			pNode->m_Empty= true;
+			break;
+		}
+		pParent->m_Children.removeOne(pNode);
+		delete pNode;
+		pNode= pParent;
 	}
+}
 
-	// Test the localisation of current octree node
-	GLC_Frustum::Localisation nodeLocalisation= frustum.localizeBoundingBox(m_BoundingBox);
-	if (nodeLocalisation == GLC_Frustum::OutFrustum)
+void GLC_OctreeNode::setLooseness(double looseness)
+{
+	Q_ASSERT(m_Children.isEmpty());
+	m_Looseness= qMax(1.0, looseness);
+	m_LooseBoundingBox= looseBox(m_BoundingBox);
+}
+
+void GLC_OctreeNode::updateViewableInstances(const GLC_Frustum& frustum, GLC_FrustumCuller* pCuller)
+{
+	if (NULL == pCuller)
 	{
-		disableViewFlag(pInstanceSet);
+		GLC_FrustumCuller culler;
+		updateViewableInstances(frustum, &culler);
+		culler.updateViewableInstances(frustum);
+		return;
 	}
-	else if (nodeLocalisation == GLC_Frustum::InFrustum)
+
+	// Test the localisation of current octree node
+	GLC_Frustum::Localisation nodeLocalisation= frustum.localizeBoundingBox(m_LooseBoundingBox);
+	if (nodeLocalisation != GLC_Frustum::IntersectFrustum)
 	{
-		unableViewFlag(pInstanceSet);
+		addBranchToCuller(pCuller, nodeLocalisation);
 	}
 	else // The current node intersect the frustum
 	{
-        QSet<GLC_3DViewInstance*>::const_iterator iInstance= m_3DViewInstanceSet.constBegin();
+		QSet<GLC_3DViewInstance*>::const_iterator iInstance= m_3DViewInstanceSet.constBegin();
 		while (m_3DViewInstanceSet.constEnd() != iInstance)
 		{
-			// Test if the instances is in the viewable set
-			if (!pInstanceSet->contains(*iInstance))
-			{
-				GLC_3DViewInstance* pCurrentInstance= (*iInstance);
-				// Test the localisation of the current instance
-				GLC_Frustum::Localisation instanceLocalisation= frustum.localizeBoundingBox(pCurrentInstance->boundingBox());
-
-				if (instanceLocalisation == GLC_Frustum::OutFrustum)
-				{
-					pCurrentInstance->setViewable(GLC_3DViewInstance::NoViewable);
-				}
-				else if (instanceLocalisation == GLC_Frustum::InFrustum)
-				{
-					pInstanceSet->insert(pCurrentInstance);
-					pCurrentInstance->setViewable(GLC_3DViewInstance::FullViewable);
-				}
-				else
-				{
-					pInstanceSet->insert(pCurrentInstance);
-                    const int size= pCurrentInstance->numberOfBody();
-                    if (size > 1)
-                    {
-                        pCurrentInstance->setViewable(GLC_3DViewInstance::PartialViewable);
-                        //Update the geometries viewable property of the instance
-                        GLC_Matrix4x4 instanceMat= pCurrentInstance->matrix();
-                        for (int i= 0; i < size; ++i)
-                        {
-                            // Get the geometry bounding box
-                            GLC_BoundingBox geomBox= pCurrentInstance->geomAt(i)->boundingBox();
-                            geomBox.transform(instanceMat);
-                            double radius= geomBox.boundingSphereRadius();
-                            GLC_Frustum::Localisation geomLocalisation= frustum.localizeSphere(geomBox.center(), radius);
-
-                            pCurrentInstance->setGeomViewable(i, geomLocalisation != GLC_Frustum::OutFrustum);
-                        }
-                    }
-                    else
-                    {
-                        pCurrentInstance->setViewable(GLC_3DViewInstance::FullViewable);
-                    }
-				}
-			}
-
+			pCuller->addInstance(*iInstance, GLC_Frustum::IntersectFrustum);
 			++iInstance;
 		}
 		const int size= m_Children.size();
 		for (int i= 0; i < size; ++i)
 		{
-			m_Children.at(i)->updateViewableInstances(frustum, pInstanceSet);
+			m_Children.at(i)->updateViewableInstances(frustum, pCuller);
 		}
 	}
-	if (firstCall) delete pInstanceSet;
 }
 
 
@@ -354,41 +345,46 @@ void GLC_OctreeNode::useBoundingSphereIntersection(bool use)
 	m_useBoundingSphere= use;
 }
 
-void GLC_OctreeNode::unableViewFlag(QSet<GLC_3DViewInstance*>* pInstanceSet)
+void GLC_OctreeNode::addBranchToCuller(GLC_FrustumCuller* pCuller, GLC_Frustum::Localisation localisation)
 {
-	QSet<GLC_3DViewInstance*>::iterator iInstance= m_3DViewInstanceSet.begin();
+	QSet<GLC_3DViewInstance*>::const_iterator iInstance= m_3DViewInstanceSet.constBegin();
 	while (m_3DViewInstanceSet.constEnd() != iInstance)
 	{
-		if (!pInstanceSet->contains(*iInstance))
-		{
-			(*iInstance)->setViewable(GLC_3DViewInstance::FullViewable);
-			pInstanceSet->insert(*iInstance);
-		}
-
+		pCuller->addInstance(*iInstance, localisation);
 		++iInstance;
 	}
 	const int size= m_Children.size();
 	for (int i= 0; i < size; ++i)
 	{
-		m_Children.at(i)->unableViewFlag(pInstanceSet);
+		m_Children.at(i)->addBranchToCuller(pCuller, localisation);
 	}
 }
 
-
-void GLC_OctreeNode::disableViewFlag(QSet<GLC_3DViewInstance*>* pInstanceSet)
+GLC_BoundingBox GLC_OctreeNode::looseBox(const GLC_BoundingBox& boundingBox) const
 {
-	QSet<GLC_3DViewInstance*>::iterator iInstance= m_3DViewInstanceSet.begin();
-	while (m_3DViewInstanceSet.constEnd() != iInstance)
-	{
-		if (!pInstanceSet->contains(*iInstance))
-			(*iInstance)->setViewable(GLC_3DViewInstance::NoViewable);
+	if (boundingBox.isEmpty() || (m_Looseness <= 1.0)) return boundingBox;
 
-		++iInstance;
-	}
-	const int size= m_Children.size();
-	for (int i= 0; i < size; ++i)
-	{
-		m_Children.at(i)->disableViewFlag(pInstanceSet);
-	}
+	// The same margin on each axis, flat nodes are enlarged too
+	const GLC_Vector3d size(boundingBox.upperCorner() - boundingBox.lowerCorner());
+	const double maxSize= qMax(size.x(), qMax(size.y(), size.z()));
+	const double margin= (m_Looseness - 1.0) * maxSize / 2.0;
+	const GLC_Vector3d marginVector(margin, margin, margin);
+
+	return GLC_BoundingBox(boundingBox.lowerCorner() - marginVector, boundingBox.upperCorner() + marginVector);
 }
 
+GLC_BoundingBox GLC_OctreeNode::octantBox(const GLC_Point3d& point) const
+{
+	const GLC_Point3d& lower= m_BoundingBox.lowerCorner();
+	const GLC_Point3d& upper= m_BoundingBox.upperCorner();
+	const GLC_Point3d middle(lower + (upper - lower) * 0.5);
+
+	const GLC_Point3d childLower(point.x() < middle.x() ? lower.x() : middle.x()
+								, point.y() < middle.y() ? lower.y() : middle.y()
+								, point.z() < middle.z() ? lower.z() : middle.z());
+	const GLC_Point3d childUpper(point.x() < middle.x() ? middle.x() : upper.x()
+								, point.y() < middle.y() ? middle.y() : upper.y()
+								, point.z() < middle.z() ? middle.z() : upper.z());
+
+	return GLC_BoundingBox(childLower, childUpper);
+}
@@ -33,6 +33,7 @@
 #include <QSet>
 
 class GLC_LIB_EXPORT GLC_OctreeNode;
+class GLC_FrustumCuller;
 
 //////////////////////////////////////////////////////////////////////
 //! \class GLC_OctreeNode
@@ -65,6 +66,18 @@ public:
 	inline GLC_BoundingBox& boundingBox()
 	{return m_BoundingBox;}
 
+	//! Return this octree node loose bounding box
+	/*! The bounding box enlarged by the looseness, used for culling and insertion*/
+	inline const GLC_BoundingBox& looseBoundingBox() const
+	{return m_LooseBoundingBox;}
+
+	//! Return the looseness of this octree node
+	inline double looseness() const
+	{return m_Looseness;}
+
+	//! Return true if the given bounding box is inside this node loose bounding box
+	bool looselyContains(const GLC_BoundingBox& boundingBox) const;
+
 	//! Return True if this octree node intersect the bounding box
 	inline bool intersect(const GLC_BoundingBox& boundingBox);
 
@@ -113,12 +126,25 @@ public:
 	//! Add 8 octree node children to this octree node
 	void addChildren();
 
-	//! Add 3d view instance in this octree node branch
-	void addInstance(GLC_3DViewInstance*, int);
+	//! Insert the given 3d view instance with the given bounding box in one node of this branch
+	/*! The instance is stored in the deepest node, up to the given depth, whose loose
+	 *  bounding box contains the instance bounding box. Missing children are created.
+	 *  Return the node which stores the instance*/
+	GLC_OctreeNode* insertInstance(GLC_3DViewInstance* pInstance, const GLC_BoundingBox& instanceBox, int depth);
+
+	//! Remove the given 3d view instance inserted in this node with insertInstance()
+	/*! This node and its ancestors are deleted if they become empty, the root node is never deleted*/
+	void removeInstance(GLC_3DViewInstance* pInstance);
+
+	//! Set the looseness of this node, 1.0 for a tight node
+	/*! Children created afterwards have the same looseness*/
+	void setLooseness(double looseness);
 
 	//! Update 3d view instances visibility of this octree node branch from the given frustum
-	/*! Viewable 3d view instance are inserted the the given set if exist also the set is created*/
-	void updateViewableInstances(const GLC_Frustum&, QSet<GLC_3DViewInstance*>* pInstanceSet= NULL);
+	/*! The nodes are localized and their instances are added to the given culler which updates them.
+	 *  If the culler is null, a culler is created and the instances are updated before returning.
+	 *  Each instance must be stored in one node, see insertInstance()*/
+	void updateViewableInstances(const GLC_Frustum&, GLC_FrustumCuller* pCuller= NULL);
 
 	//! Remove empty child octree node from this octree node
 	void removeEmptyChildren();
@@ -131,11 +157,14 @@ public:
 // Private services function
 //////////////////////////////////////////////////////////////////////
 private:
-	//! Unable the node and sub node view flag
-	void unableViewFlag(QSet<GLC_3DViewInstance*>*);
+	//! Add the instances of this node branch to the given culler with the given localisation
+	void addBranchToCuller(GLC_FrustumCuller* pCuller, GLC_Frustum::Localisation localisation);
+
+	//! Return the given box enlarged by the looseness of this node
+	GLC_BoundingBox looseBox(const GLC_BoundingBox& boundingBox) const;
 
-	//! Disable the node and sub node view flag
-	void disableViewFlag(QSet<GLC_3DViewInstance*>*);
+	//! Return the bounding box of the child octant containing the given point
+	GLC_BoundingBox octantBox(const GLC_Point3d& point) const;
 
 //////////////////////////////////////////////////////////////////////
 // Private members
@@ -144,6 +173,12 @@ private:
 	//! Octree node bounding box
 	GLC_BoundingBox m_BoundingBox;
 
+	//! Octree node looseness
+	double m_Looseness;
+
+	//! Octree node bounding box enlarged by the looseness
+	GLC_BoundingBox m_LooseBoundingBox;
+
 	//! Parent Octree node
 	GLC_OctreeNode* m_pParent;
 
@@ -164,9 +199,9 @@ private:
 bool GLC_OctreeNode::intersect(const GLC_BoundingBox& boundingBox)
 {
 	if (m_useBoundingSphere)
-		return m_BoundingBox.intersectBoundingSphere(boundingBox);
+		return m_LooseBoundingBox.intersectBoundingSphere(boundingBox);
 	else
-		return m_BoundingBox.intersect(boundingBox);
+		return m_LooseBoundingBox.intersect(boundingBox);
 }
 
 #endif /* GLC_OCTREENODE_H_ */
@@ -0,0 +1,434 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_residencymanager.cpp implementation of the GLC_ResidencyManager class.
+
+#include <QtConcurrent>
+#include <QThread>
+
+#include <algorithm>
+
+#include <QFileInfo>
+
+#include "glc_residencymanager.h"
+#include "glc_structreference.h"
+#include "glc_structoccurrence.h"
+#include "../viewport/glc_viewport.h"
+#include "../glc_factory.h"
+
+GLC_ResidencyManager::GLC_ResidencyManager(const GLC_World& world, QObject* pParent)
+    : QObject(pParent)
+    , m_World(world)
+    , m_References()
+    , m_Entries()
+    , m_EntryIndex()
+    , m_WorldRevision(0)
+    , m_ViewMatrix()
+    , m_ViewHeight(0)
+    , m_Resident()
+    , m_PendingLoad()
+    , m_LoadingReferences()
+    , m_KnownBoundingBox()
+    , m_KnownMemorySize()
+    , m_MemoryBudget(Q_INT64_C(1024) * 1024 * 1024)
+    , m_ResidentMemory(0)
+    , m_PendingMemory(0)
+    , m_MaximumPendingLoad(qMax(1, QThread::idealThreadCount()))
+    , m_MinimumPixelSize(2.0)
+    , m_SizeHint(1.0)
+    , m_FrameCount(0)
+{
+    // The factory must be created in the GUI thread
+    GLC_Factory::instance();
+}
+
+GLC_ResidencyManager::~GLC_ResidencyManager()
+{
+    discardPendingLoad();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+qint64 GLC_ResidencyManager::memorySize(const GLC_3DRep& rep)
+{
+    // Position, normal, texel and color per vertex and 3 indexes per face
+    const qint64 vertexSize= 12 * sizeof(GLfloat);
+    const qint64 faceSize= 3 * sizeof(GLuint);
+
+    return (static_cast<qint64>(rep.vertexCount()) * vertexSize) + (static_cast<qint64>(rep.faceCount()) * faceSize);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_ResidencyManager::setWorld(const GLC_World& world)
+{
+    discardPendingLoad();
+    m_World= world;
+    m_References.clear();
+    m_Entries.clear();
+    m_EntryIndex.clear();
+    m_WorldRevision= 0;
+    m_Resident.clear();
+    m_KnownBoundingBox.clear();
+    m_KnownMemorySize.clear();
+    m_ResidentMemory= 0;
+}
+
+void GLC_ResidencyManager::setBoundingBoxHint(const GLC_StructReference* pRef, const GLC_BoundingBox& boundingBox)
+{
+    m_KnownBoundingBox.insert(pRef, boundingBox);
+    setDirty(pRef);
+}
+
+void GLC_ResidencyManager::update(GLC_Viewport* pView)
+{
+    Q_ASSERT(nullptr != pView);
+    ++m_FrameCount;
+
+    // The references are only listed again when the world has changed
+    const quint64 worldRevision= m_World.worldHandle()->revision();
+    const bool worldHasChanged= (0 == m_WorldRevision) || (worldRevision != m_WorldRevision);
+    if (worldHasChanged)
+    {
+        updateEntries();
+        m_WorldRevision= worldRevision;
+    }
+
+    const GLC_Matrix4x4 viewMatrix(pView->compositionMatrix());
+    const bool viewHasChanged= (viewMatrix != m_ViewMatrix) || (pView->viewVSize() != m_ViewHeight);
+    m_ViewMatrix= viewMatrix;
+    m_ViewHeight= pView->viewVSize();
+
+    // Forget references removed from the world or unloaded by someone else
+    QHash<GLC_StructReference*, ResidentRep>::iterator iResident= m_Resident.begin();
+    while (iResident != m_Resident.end())
+    {
+        if (!m_References.contains(iResident.key()) || !iResident.key()->representationIsLoaded())
+        {
+            m_ResidentMemory-= iResident.value().m_MemorySize;
+            setDirty(iResident.key());
+            iResident= m_Resident.erase(iResident);
+        }
+        else
+        {
+            ++iResident;
+        }
+    }
+
+    // Update visibility of resident representations and collect loading candidates
+    QList<QPair<double, GLC_StructReference*> > candidates;
+    const int entryCount= m_Entries.size();
+    for (int i= 0; i < entryCount; ++i)
+    {
+        Entry& entry= m_Entries[i];
+        if (viewHasChanged || entry.m_IsDirty)
+        {
+            entry.m_ProjectedSize= projectedSize(entry, pView);
+            entry.m_IsDirty= false;
+        }
+
+        const double size= entry.m_ProjectedSize;
+        GLC_StructReference* pRef= entry.m_pRef;
+        if (pRef->representationIsLoaded())
+        {
+            iResident= m_Resident.find(pRef);
+            if ((iResident != m_Resident.end()) && (size > 0.0))
+            {
+                iResident.value().m_LastVisibleFrame= m_FrameCount;
+            }
+        }
+        else if ((size >= m_MinimumPixelSize) && !m_LoadingReferences.contains(pRef))
+        {
+            candidates.append(qMakePair(size, pRef));
+        }
+    }
+
+    evict();
+
+    // Load the biggest representations first while the budget is not reached
+    // Loading in progress are counted in the budget
+    if ((m_ResidentMemory + m_PendingMemory) < m_MemoryBudget)
+    {
+        std::sort(candidates.begin(), candidates.end(), [](const QPair<double, GLC_StructReference*>& a, const QPair<double, GLC_StructReference*>& b)
+        {
+            return a.first > b.first;
+        });
+
+        const int count= candidates.size();
+        int i= 0;
+        while ((i < count) && (m_PendingLoad.size() < m_MaximumPendingLoad) && ((m_ResidentMemory + m_PendingMemory) < m_MemoryBudget))
+        {
+            startLoading(candidates.at(i).second);
+            ++i;
+        }
+    }
+}
+
+void GLC_ResidencyManager::clear()
+{
+    discardPendingLoad();
+
+    QHash<GLC_StructReference*, ResidentRep>::const_iterator iResident= m_Resident.constBegin();
+    while (iResident != m_Resident.constEnd())
+    {
+        GLC_StructReference* pRef= iResident.key();
+        if (m_References.contains(pRef) && pRef->representationIsLoaded())
+        {
+            pRef->unloadRepresentation();
+        }
+        ++iResident;
+    }
+    const bool residencyHasChanged= !m_Resident.isEmpty();
+    m_Resident.clear();
+    m_ResidentMemory= 0;
+
+    if (residencyHasChanged) emit residencyChanged();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private slots
+//////////////////////////////////////////////////////////////////////
+
+void GLC_ResidencyManager::loadingFinished()
+{
+    QFutureWatcher<GLC_3DRep>* pWatcher= static_cast<QFutureWatcher<GLC_3DRep>*>(sender());
+    Q_ASSERT(m_PendingLoad.contains(pWatcher));
+
+    GLC_StructReference* pRef= m_PendingLoad.take(pWatcher);
+    m_PendingMemory-= m_LoadingReferences.take(pRef);
+    GLC_3DRep loadedRep(pWatcher->result());
+    pWatcher->deleteLater();
+
+    if (m_References.contains(pRef) && !pRef->representationIsLoaded())
+    {
+        if (pRef->loadRepresentation(&loadedRep))
+        {
+            const GLC_3DRep* p3DRep= dynamic_cast<GLC_3DRep*>(pRef->representationHandle());
+            Q_ASSERT(nullptr != p3DRep);
+
+            ResidentRep resident;
+            resident.m_MemorySize= memorySize(*p3DRep);
+            resident.m_LastVisibleFrame= m_FrameCount;
+            m_Resident.insert(pRef, resident);
+            m_ResidentMemory+= resident.m_MemorySize;
+            m_KnownBoundingBox.insert(pRef, p3DRep->boundingBox());
+            m_KnownMemorySize.insert(pRef, resident.m_MemorySize);
+            setDirty(pRef);
+
+            emit residencyChanged();
+        }
+        else
+        {
+            emit loadingFailed(pRef->representationFileName());
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_ResidencyManager::updateEntries()
+{
+    const QList<GLC_StructReference*> references(m_World.references());
+    m_References= QSet<GLC_StructReference*>(references.constBegin(), references.constEnd());
+
+    m_Entries.clear();
+    m_EntryIndex.clear();
+    for (GLC_StructReference* pRef : references)
+    {
+        if (!pRef->hasRepresentation() || pRef->representationFileName().isEmpty()) continue;
+
+        Entry entry;
+        entry.m_pRef= pRef;
+        entry.m_Occurrences= pRef->listOfStructOccurrence();
+        entry.m_ProjectedSize= 0.0;
+        entry.m_IsDirty= true;
+        m_EntryIndex.insert(pRef, m_Entries.size());
+        m_Entries.append(entry);
+    }
+}
+
+double GLC_ResidencyManager::projectedSize(const Entry& entry, GLC_Viewport* pView) const
+{
+    double subject= 0.0;
+    const GLC_StructReference* pRef= entry.m_pRef;
+
+    GLC_BoundingBox localBox;
+    bool boxIsKnown= false;
+    if (pRef->representationIsLoaded())
+    {
+        const GLC_3DRep* p3DRep= dynamic_cast<const GLC_3DRep*>(pRef->representationHandle());
+        if ((nullptr != p3DRep) && !p3DRep->isEmpty())
+        {
+            localBox= p3DRep->boundingBox();
+            boxIsKnown= true;
+        }
+    }
+    else if (m_KnownBoundingBox.contains(pRef))
+    {
+        localBox= m_KnownBoundingBox.value(pRef);
+        boxIsKnown= true;
+    }
+
+    const GLC_Point3d eye(pView->cameraHandle()->eye());
+    const double viewTangent= pView->viewTangent();
+    const double viewSize= static_cast<double>(pView->viewVSize());
+
+    for (const GLC_StructOccurrence* pOcc : entry.m_Occurrences)
+    {
+        // Hidden occurrences don't need their representation
+        if (!pOcc->isVisible()) continue;
+
+        const GLC_Matrix4x4 matrix(pOcc->absoluteMatrix());
+        GLC_Point3d center;
+        double radius;
+        if (boxIsKnown)
+        {
+            double scaling= qMax(matrix.scalingX(), matrix.scalingY());
+            scaling= qMax(scaling, matrix.scalingZ());
+            center= matrix * localBox.center();
+            radius= localBox.boundingSphereRadius() * scaling;
+        }
+        else
+        {
+            center= matrix * GLC_Point3d();
+            radius= m_SizeHint / 2.0;
+        }
+
+        if (pView->frustum().localizeSphere(center, radius) != GLC_Frustum::OutFrustum)
+        {
+            double dist;
+            if (pView->useOrtho())
+            {
+                dist= pView->cameraHandle()->distEyeTarget();
+            }
+            else
+            {
+                dist= (center - eye).length();
+            }
+
+            double size= viewSize;
+            if (dist > radius)
+            {
+                size= qMin(viewSize, (2.0 * radius) / (dist * viewTangent) * viewSize);
+            }
+            subject= qMax(subject, size);
+        }
+    }
+
+    return subject;
+}
+
+void GLC_ResidencyManager::setDirty(const GLC_StructReference* pRef)
+{
+    const QHash<const GLC_StructReference*, int>::const_iterator iEntry= m_EntryIndex.constFind(pRef);
+    if (iEntry != m_EntryIndex.constEnd())
+    {
+        m_Entries[iEntry.value()].m_IsDirty= true;
+    }
+}
+
+qint64 GLC_ResidencyManager::estimatedMemorySize(const GLC_StructReference* pRef) const
+{
+    const QHash<const GLC_StructReference*, qint64>::const_iterator iSize= m_KnownMemorySize.constFind(pRef);
+    if (iSize != m_KnownMemorySize.constEnd())
+    {
+        return iSize.value();
+    }
+    else
+    {
+        // Never loaded, the file size is the best guess
+        return QFileInfo(pRef->representationFileName()).size();
+    }
+}
+
+void GLC_ResidencyManager::startLoading(GLC_StructReference* pRef)
+{
+    Q_ASSERT(!m_LoadingReferences.contains(pRef));
+
+    QFutureWatcher<GLC_3DRep>* pWatcher= new QFutureWatcher<GLC_3DRep>(this);
+    connect(pWatcher, SIGNAL(finished()), this, SLOT(loadingFinished()));
+    const qint64 memorySize= estimatedMemorySize(pRef);
+    m_PendingLoad.insert(pWatcher, pRef);
+    m_LoadingReferences.insert(pRef, memorySize);
+    m_PendingMemory+= memorySize;
+
+    pWatcher->setFuture(QtConcurrent::run(GLC_ResidencyManager::loadRepresentationFile, pRef->representationFileName()));
+}
+
+void GLC_ResidencyManager::evict()
+{
+    if (m_ResidentMemory <= m_MemoryBudget) return;
+
+    // Representations not visible in this frame, least recently visible first
+    QList<QPair<quint64, GLC_StructReference*> > candidates;
+    QHash<GLC_StructReference*, ResidentRep>::const_iterator iResident= m_Resident.constBegin();
+    while (iResident != m_Resident.constEnd())
+    {
+        if (iResident.value().m_LastVisibleFrame < m_FrameCount)
+        {
+            candidates.append(qMakePair(iResident.value().m_LastVisibleFrame, iResident.key()));
+        }
+        ++iResident;
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    const int count= candidates.size();
+    int i= 0;
+    while ((m_ResidentMemory > m_MemoryBudget) && (i < count))
+    {
+        GLC_StructReference* pRef= candidates.at(i).second;
+        pRef->unloadRepresentation();
+        m_ResidentMemory-= m_Resident.take(pRef).m_MemorySize;
+        ++i;
+    }
+
+    if (i > 0) emit residencyChanged();
+}
+
+void GLC_ResidencyManager::discardPendingLoad()
+{
+    // Running loading cannot be canceled, results are deleted with the watcher
+    QHash<QFutureWatcher<GLC_3DRep>*, GLC_StructReference*>::const_iterator iWatcher= m_PendingLoad.constBegin();
+    while (iWatcher != m_PendingLoad.constEnd())
+    {
+        QFutureWatcher<GLC_3DRep>* pWatcher= iWatcher.key();
+        disconnect(pWatcher, SIGNAL(finished()), this, SLOT(loadingFinished()));
+        pWatcher->setParent(nullptr);
+        connect(pWatcher, SIGNAL(finished()), pWatcher, SLOT(deleteLater()));
+        if (pWatcher->isFinished()) pWatcher->deleteLater();
+        ++iWatcher;
+    }
+    m_PendingLoad.clear();
+    m_LoadingReferences.clear();
+    m_PendingMemory= 0;
+}
+
+GLC_3DRep GLC_ResidencyManager::loadRepresentationFile(const QString& fileName)
+{
+    return GLC_Factory::instance()->create3DRepFromFile(fileName, true);
+}
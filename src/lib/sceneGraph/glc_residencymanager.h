@@ -0,0 +1,281 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_residencymanager.h interface for the GLC_ResidencyManager class.
+
+#ifndef GLC_RESIDENCYMANAGER_H_
+#define GLC_RESIDENCYMANAGER_H_
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QFutureWatcher>
+
+#include "glc_world.h"
+#include "../geometry/glc_3drep.h"
+#include "../glc_boundingbox.h"
+#include "../maths/glc_matrix4x4.h"
+
+#include "../glc_config.h"
+
+class GLC_Viewport;
+class GLC_StructReference;
+class GLC_StructOccurrence;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_ResidencyManager
+/*! \brief GLC_ResidencyManager : Load and unload world representations on demand*/
+
+/*! The residency manager decides which representations of a structure only world
+ *  must be loaded. On each call to update() :
+ *  - References are prioritized by the projected size in pixels of their visible occurrences,
+ *    hidden occurrences are ignored
+ *  - The most important references are loaded asynchronously on the global thread pool
+ *    with GLC_Factory::create3DRepFromFile (The GLC_BSRep cache is used if enabled)
+ *    while the resident memory and the estimated memory of pending loading fit in the budget
+ *  - Loaded representations are attached and their 3DViewInstances created on the thread of the manager
+ *  - Least recently visible representations are unloaded while the memory budget is exceeded
+ *
+ *  Projected sizes are only computed again for references which changed since the previous
+ *  update, unless the view or the world revision (GLC_WorldHandle::revision()) changed.
+ *
+ *  The manager must live in the GUI thread.
+ *  The bounding box of a representation is not known until it has been loaded once,
+ *  meanwhile the occurrence origin is used with the size hint.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_ResidencyManager : public QObject
+{
+    Q_OBJECT
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Construct a residency manager of the given world
+    explicit GLC_ResidencyManager(const GLC_World& world, QObject* pParent= nullptr);
+
+    virtual ~GLC_ResidencyManager();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the memory budget in bytes
+    qint64 memoryBudget() const
+    {return m_MemoryBudget;}
+
+    //! Return the estimated memory used by loaded representations in bytes
+    qint64 residentMemory() const
+    {return m_ResidentMemory;}
+
+    //! Return the maximum number of concurrent asynchronous loading
+    int maximumPendingLoad() const
+    {return m_MaximumPendingLoad;}
+
+    //! Return the minimum projected size in pixels of a representation to be loaded
+    double minimumPixelSize() const
+    {return m_MinimumPixelSize;}
+
+    //! Return the number of representations being loaded
+    int pendingLoadCount() const
+    {return m_PendingLoad.size();}
+
+    //! Return the estimated memory of the representations being loaded in bytes
+    qint64 pendingMemory() const
+    {return m_PendingMemory;}
+
+    //! Return the number of representations loaded by this manager
+    int residentCount() const
+    {return m_Resident.size();}
+
+    //! Return the estimated memory size of the given 3DRep in bytes
+    static qint64 memorySize(const GLC_3DRep& rep);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Set the world managed by this residency manager
+    /*! Pending loading are discarded*/
+    void setWorld(const GLC_World& world);
+
+    //! Set the memory budget in bytes
+    void setMemoryBudget(qint64 budget)
+    {m_MemoryBudget= budget;}
+
+    //! Set the maximum number of concurrent asynchronous loading
+    void setMaximumPendingLoad(int count)
+    {m_MaximumPendingLoad= qMax(1, count);}
+
+    //! Set the minimum projected size in pixels of a representation to be loaded
+    void setMinimumPixelSize(double size)
+    {m_MinimumPixelSize= size;}
+
+    //! Set the diameter used for representations which bounding box is unknown
+    void setSizeHint(double diameter)
+    {m_SizeHint= diameter;}
+
+    //! Set the bounding box of the representation of the given reference
+    /*! Usefull when the bounding box is known without loading geometries (GLC_BSRep header...)*/
+    void setBoundingBoxHint(const GLC_StructReference* pRef, const GLC_BoundingBox& boundingBox);
+
+    //! Update the residency of representations for the given viewport
+    /*! The frustum of the viewport must be up to date*/
+    void update(GLC_Viewport* pView);
+
+    //! Unload all representations loaded by this manager and discard pending loading
+    void clear();
+
+//@}
+
+signals:
+    //! Emitted when representations have been loaded or unloaded
+    void residencyChanged();
+
+    //! Emitted when the loading of the given representation file failed
+    void loadingFailed(const QString& fileName);
+
+//////////////////////////////////////////////////////////////////////
+// Private slots
+//////////////////////////////////////////////////////////////////////
+private slots:
+    //! An asynchronous loading is finished
+    void loadingFinished();
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! A reference of the world with a representation file
+    struct Entry
+    {
+        GLC_StructReference* m_pRef;
+        //! The occurrences of the reference
+        QList<GLC_StructOccurrence*> m_Occurrences;
+        //! The projected size of the last update
+        double m_ProjectedSize;
+        //! True if the projected size must be computed again
+        bool m_IsDirty;
+    };
+
+    //! Update the entries from the references of the world
+    void updateEntries();
+
+    //! Return the projected size in pixels of the given entry in the given view
+    /*! Return 0.0 if no visible occurrence of the reference is in the frustum*/
+    double projectedSize(const Entry& entry, GLC_Viewport* pView) const;
+
+    //! Set the entry of the given reference dirty
+    void setDirty(const GLC_StructReference* pRef);
+
+    //! Return the estimated memory size in bytes of the representation of the given reference
+    /*! The size measured at the last loading if any, otherwise the size of the representation file*/
+    qint64 estimatedMemorySize(const GLC_StructReference* pRef) const;
+
+    //! Start the asynchronous loading of the representation of the given reference
+    void startLoading(GLC_StructReference* pRef);
+
+    //! Unload least recently visible representations while the memory budget is exceeded
+    void evict();
+
+    //! Discard all pending loading
+    void discardPendingLoad();
+
+    //! Load the representation of the given file name (Called in a worker thread)
+    static GLC_3DRep loadRepresentationFile(const QString& fileName);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Resident representation properties
+    struct ResidentRep
+    {
+        qint64 m_MemorySize;
+        quint64 m_LastVisibleFrame;
+    };
+
+    //! The managed world
+    GLC_World m_World;
+
+    //! The set of references of the world at last update
+    QSet<GLC_StructReference*> m_References;
+
+    //! The references of the world with a representation file
+    QVector<Entry> m_Entries;
+
+    //! Index in m_Entries of the references
+    QHash<const GLC_StructReference*, int> m_EntryIndex;
+
+    //! The world revision of the entries, 0 if entries must be updated
+    quint64 m_WorldRevision;
+
+    //! The view composition matrix and height of the last update
+    GLC_Matrix4x4 m_ViewMatrix;
+    int m_ViewHeight;
+
+    //! Representations loaded by this manager
+    QHash<GLC_StructReference*, ResidentRep> m_Resident;
+
+    //! Asynchronous loading in progress
+    QHash<QFutureWatcher<GLC_3DRep>*, GLC_StructReference*> m_PendingLoad;
+
+    //! References being loaded with their estimated memory size
+    QHash<GLC_StructReference*, qint64> m_LoadingReferences;
+
+    //! Bounding box of representations which have been loaded at least once
+    QHash<const GLC_StructReference*, GLC_BoundingBox> m_KnownBoundingBox;
+
+    //! Memory size of representations which have been loaded at least once
+    QHash<const GLC_StructReference*, qint64> m_KnownMemorySize;
+
+    //! The memory budget in bytes
+    qint64 m_MemoryBudget;
+
+    //! The estimated resident memory in bytes
+    qint64 m_ResidentMemory;
+
+    //! The estimated memory of pending loading in bytes
+    qint64 m_PendingMemory;
+
+    //! The maximum number of concurrent loading
+    int m_MaximumPendingLoad;
+
+    //! The minimum projected size in pixels
+    double m_MinimumPixelSize;
+
+    //! The diameter used when a bounding box is unknown
+    double m_SizeHint;
+
+    //! Update counter
+    quint64 m_FrameCount;
+
+    Q_DISABLE_COPY(GLC_ResidencyManager)
+};
+
+#endif /* GLC_RESIDENCYMANAGER_H_ */
@@ -0,0 +1,896 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_sectionengine.cpp implementation of the GLC_SectionEngine class.
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <vector>
+
+#include <QMultiHash>
+#include <QPointF>
+#include <QSet>
+#include <QtConcurrent>
+
+#include "glc_sectionengine.h"
+#include "glc_3dviewcollection.h"
+#include "glc_3dviewinstance.h"
+#include "../geometry/glc_mesh.h"
+#include "../geometry/glc_polylines.h"
+#include "../shading/glc_material.h"
+#include "../3rdparty/clip2tri/clipper/clip_clipper.hpp"
+#include "../3rdparty/clip2tri/poly2tri/clip_poly2tri.h"
+#include "../glc_errorlog.h"
+
+namespace
+{
+    //! Half range of the clipper integer coordinates, the clipping polygon is twice larger
+    const double clipperRange= 2.0e8;
+
+    bool samePlane(const GLC_Plane& plane1, const GLC_Plane& plane2)
+    {
+        return std::equal(plane1.data(), plane1.data() + 4, plane2.data());
+    }
+
+    bool sameMatrix(const GLC_Matrix4x4& matrix1, const GLC_Matrix4x4& matrix2)
+    {
+        return std::equal(matrix1.getData(), matrix1.getData() + 16, matrix2.getData());
+    }
+
+    //! Return the point of the segment [p1, p2] at the given signed distances from a plane
+    GLC_Point3d interpolate(const GLC_Point3d& p1, const GLC_Point3d& p2, double d1, double d2)
+    {
+        const double t= d1 / (d1 - d2);
+        return GLC_Point3d(p1.x() + (p2.x() - p1.x()) * t, p1.y() + (p2.y() - p1.y()) * t, p1.z() + (p2.z() - p1.z()) * t);
+    }
+
+    //! Append the parts of the given contour on the positive side of the given plane to the given list
+    void clipContour(const GLC_SectionEngine::Contour& contour, const GLC_Plane& plane, QList<GLC_SectionEngine::Contour>* pContours)
+    {
+        const int size= contour.m_Points.size();
+        QVector<double> distances(size);
+        int outsideIndex= -1;
+        for (int i= 0; i < size; ++i)
+        {
+            distances[i]= plane.distanceToPoint(contour.m_Points.at(i));
+            if ((distances.at(i) < 0.0) && (outsideIndex < 0)) outsideIndex= i;
+        }
+
+        if (outsideIndex < 0)
+        {
+            pContours->append(contour);
+            return;
+        }
+
+        // A closed contour is walked from an outside point back to it
+        QVector<GLC_Point3d> points;
+        QVector<double> pointDistances;
+        if (contour.m_IsClosed)
+        {
+            for (int i= 0; i <= size; ++i)
+            {
+                const int index= (outsideIndex + i) % size;
+                points.append(contour.m_Points.at(index));
+                pointDistances.append(distances.at(index));
+            }
+        }
+        else
+        {
+            points= contour.m_Points;
+            pointDistances= distances;
+        }
+
+        GLC_SectionEngine::Contour piece;
+        piece.m_IsClosed= false;
+        const int count= points.size();
+        for (int i= 0; i < count; ++i)
+        {
+            const bool inside= pointDistances.at(i) >= 0.0;
+            if (inside) piece.m_Points.append(points.at(i));
+            if ((i + 1) < count)
+            {
+                const bool nextInside= pointDistances.at(i + 1) >= 0.0;
+                if (inside != nextInside)
+                {
+                    piece.m_Points.append(interpolate(points.at(i), points.at(i + 1), pointDistances.at(i), pointDistances.at(i + 1)));
+                    if (inside)
+                    {
+                        if (piece.m_Points.size() > 1) pContours->append(piece);
+                        piece.m_Points.clear();
+                    }
+                }
+            }
+        }
+        if (piece.m_Points.size() > 1) pContours->append(piece);
+    }
+
+    //! Clip the given convex polygon by the half plane a * x + b * y + c >= 0
+    QVector<QPointF> clipConvexPolygon(const QVector<QPointF>& polygon, double a, double b, double c)
+    {
+        QVector<QPointF> subject;
+        const int size= polygon.size();
+        for (int i= 0; i < size; ++i)
+        {
+            const QPointF& p1= polygon.at(i);
+            const QPointF& p2= polygon.at((i + 1) % size);
+            const double d1= a * p1.x() + b * p1.y() + c;
+            const double d2= a * p2.x() + b * p2.y() + c;
+            if (d1 >= 0.0) subject.append(p1);
+            if ((d1 >= 0.0) != (d2 >= 0.0))
+            {
+                const double t= d1 / (d1 - d2);
+                subject.append(p1 + (p2 - p1) * t);
+            }
+        }
+        return subject;
+    }
+}
+
+GLC_SectionEngine::BodySection::BodySection()
+    : m_InstanceId(0)
+    , m_BodyIndex(0)
+    , m_Color()
+    , m_Contours()
+    , m_CapTriangles()
+    , m_CapArea(0.0)
+{
+
+}
+
+GLC_SectionEngine::Statistics::Statistics()
+    : m_BodyCount(0)
+    , m_UpdatedBodyCount(0)
+    , m_VisitedTriangleCount(0)
+    , m_CutBodyCount(0)
+    , m_OpenContourCount(0)
+{
+
+}
+
+GLC_SectionEngine::GLC_SectionEngine()
+    : m_Planes()
+    , m_UpdatedPlanes()
+    , m_PlaneRemoved(false)
+    , m_BodyHash()
+    , m_Bodies()
+    , m_MeshTrees()
+    , m_Statistics()
+{
+
+}
+
+GLC_SectionEngine::~GLC_SectionEngine()
+{
+    clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+QList<GLC_SectionEngine::BodySection> GLC_SectionEngine::sections(int planeIndex) const
+{
+    QList<BodySection> subject;
+    const int bodyCount= m_Bodies.size();
+    for (int i= 0; i < bodyCount; ++i)
+    {
+        const Body* pBody= m_Bodies.at(i);
+        if (planeIndex >= pBody->m_Sections.size()) continue;
+        const BodySection& section= pBody->m_Sections.at(planeIndex);
+        if (!section.m_Contours.isEmpty() || !section.m_CapTriangles.isEmpty())
+        {
+            subject.append(section);
+        }
+    }
+
+    return subject;
+}
+
+double GLC_SectionEngine::capArea(int planeIndex) const
+{
+    double subject= 0.0;
+    const int bodyCount= m_Bodies.size();
+    for (int i= 0; i < bodyCount; ++i)
+    {
+        const Body* pBody= m_Bodies.at(i);
+        if (planeIndex < pBody->m_Sections.size())
+        {
+            subject+= pBody->m_Sections.at(planeIndex).m_CapArea;
+        }
+    }
+
+    return subject;
+}
+
+GLC_Mesh* GLC_SectionEngine::createCapMesh(int planeIndex) const
+{
+    const QList<BodySection> sectionList(sections(planeIndex));
+
+    // Caps are grouped by color
+    QList<QRgb> colors;
+    QHash<QRgb, IndexList> indexHash;
+    GLfloatVector positions;
+    GLfloatVector normals;
+    const GLC_Vector3d normal(-m_Planes.at(planeIndex).normal());
+    const int sectionCount= sectionList.size();
+    for (int i= 0; i < sectionCount; ++i)
+    {
+        const BodySection& section= sectionList.at(i);
+        const int pointCount= section.m_CapTriangles.size();
+        if (0 == pointCount) continue;
+
+        const QRgb color= section.m_Color.rgba();
+        if (!indexHash.contains(color)) colors.append(color);
+        IndexList& indexList= indexHash[color];
+        for (int j= 0; j < pointCount; ++j)
+        {
+            const GLC_Point3d& point= section.m_CapTriangles.at(j);
+            indexList.append(static_cast<GLuint>(positions.size() / 3));
+            positions << static_cast<GLfloat>(point.x()) << static_cast<GLfloat>(point.y()) << static_cast<GLfloat>(point.z());
+            normals << static_cast<GLfloat>(normal.x()) << static_cast<GLfloat>(normal.y()) << static_cast<GLfloat>(normal.z());
+        }
+    }
+
+    if (positions.isEmpty()) return nullptr;
+
+    GLC_Mesh* pSubject= new GLC_Mesh();
+    pSubject->addVertice(positions);
+    pSubject->addNormals(normals);
+    const int colorCount= colors.size();
+    for (int i= 0; i < colorCount; ++i)
+    {
+        const QRgb color= colors.at(i);
+        pSubject->addTriangles(new GLC_Material(QColor::fromRgba(color)), indexHash.value(color));
+    }
+    pSubject->finish();
+
+    return pSubject;
+}
+
+GLC_Polylines* GLC_SectionEngine::createContourPolylines(int planeIndex) const
+{
+    GLC_Polylines* pSubject= nullptr;
+    const QList<BodySection> sectionList(sections(planeIndex));
+    const int sectionCount= sectionList.size();
+    for (int i= 0; i < sectionCount; ++i)
+    {
+        const QList<Contour>& contours= sectionList.at(i).m_Contours;
+        const int contourCount= contours.size();
+        for (int j= 0; j < contourCount; ++j)
+        {
+            const Contour& contour= contours.at(j);
+            QList<GLC_Point3d> points(contour.m_Points);
+            if (contour.m_IsClosed) points.append(points.first());
+            if (nullptr == pSubject) pSubject= new GLC_Polylines();
+            pSubject->addPolyline(points);
+        }
+    }
+
+    return pSubject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+int GLC_SectionEngine::addPlane(const GLC_Plane& plane)
+{
+    m_Planes.append(plane.normalized());
+
+    return m_Planes.size() - 1;
+}
+
+void GLC_SectionEngine::setPlane(int index, const GLC_Plane& plane)
+{
+    Q_ASSERT((index >= 0) && (index < m_Planes.size()));
+    m_Planes[index]= plane.normalized();
+}
+
+void GLC_SectionEngine::removePlane(int index)
+{
+    Q_ASSERT((index >= 0) && (index < m_Planes.size()));
+    m_Planes.remove(index);
+    if (index < m_UpdatedPlanes.size()) m_UpdatedPlanes.remove(index);
+
+    const int bodyCount= m_Bodies.size();
+    for (int i= 0; i < bodyCount; ++i)
+    {
+        Body* pBody= m_Bodies.at(i);
+        if (index < pBody->m_Contours.size()) pBody->m_Contours.remove(index);
+        if (index < pBody->m_Sections.size()) pBody->m_Sections.remove(index);
+    }
+    m_PlaneRemoved= true;
+}
+
+void GLC_SectionEngine::removeAllPlanes()
+{
+    m_Planes.clear();
+    m_UpdatedPlanes.clear();
+
+    const int bodyCount= m_Bodies.size();
+    for (int i= 0; i < bodyCount; ++i)
+    {
+        Body* pBody= m_Bodies.at(i);
+        pBody->m_Contours.clear();
+        pBody->m_Sections.clear();
+    }
+    m_PlaneRemoved= false;
+}
+
+void GLC_SectionEngine::update(GLC_3DViewCollection* pCollection)
+{
+    Q_ASSERT(nullptr != pCollection);
+    m_Statistics= Statistics();
+
+    const int planeCount= m_Planes.size();
+    QVector<int> changedPlanes;
+    for (int i= 0; i < planeCount; ++i)
+    {
+        if ((i >= m_UpdatedPlanes.size()) || !samePlane(m_Planes.at(i), m_UpdatedPlanes.at(i)))
+        {
+            changedPlanes.append(i);
+        }
+    }
+    // Contours are clipped by the other planes
+    const bool clippingChanged= m_PlaneRemoved || !changedPlanes.isEmpty();
+
+    // Collect the bodies of the visible instances
+    QHash<quint64, Body*> previousBodies;
+    previousBodies.swap(m_BodyHash);
+    m_Bodies.clear();
+    QVector<const GLC_Mesh*> newMeshes;
+    QSet<GLC_uint> usedMeshes;
+    const bool showState= pCollection->showState();
+    const QList<GLC_3DViewInstance*> instances(pCollection->instancesHandle());
+    const int instanceCount= instances.size();
+    for (int i= 0; i < instanceCount; ++i)
+    {
+        GLC_3DViewInstance* pInstance= instances.at(i);
+        if (pInstance->isVisible() != showState) continue;
+
+        const int bodyCount= pInstance->numberOfBody();
+        for (int j= 0; j < bodyCount; ++j)
+        {
+            GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(pInstance->geomAt(j));
+            if ((nullptr == pMesh) || pMesh->isEmpty()) continue;
+
+            const GLC_uint meshId= pMesh->id();
+            if (!m_MeshTrees.contains(meshId) && !usedMeshes.contains(meshId))
+            {
+                newMeshes.append(pMesh);
+            }
+            usedMeshes.insert(meshId);
+
+            const quint64 key= bodyKey(pInstance->id(), j);
+            Body* pBody= previousBodies.take(key);
+            const bool bodyChanged= (nullptr == pBody) || (pBody->m_MeshId != meshId) || !sameMatrix(pBody->m_Matrix, pInstance->matrix());
+            if (nullptr == pBody)
+            {
+                pBody= new Body;
+                pBody->m_InstanceId= pInstance->id();
+                pBody->m_BodyIndex= j;
+            }
+            pBody->m_Contours.resize(planeCount);
+            pBody->m_DirtyPlanes.clear();
+            pBody->m_SectionsDirty= bodyChanged || (pBody->m_Sections.size() != planeCount);
+            pBody->m_VisitedTriangleCount= 0;
+
+            if (bodyChanged)
+            {
+                pBody->m_MeshId= meshId;
+                pBody->m_Matrix= pInstance->matrix();
+                pBody->m_BoundingBox= pMesh->boundingBox();
+                pBody->m_BoundingBox.transform(pBody->m_Matrix);
+                for (int k= 0; k < planeCount; ++k)
+                {
+                    pBody->m_Contours[k].clear();
+                    if (pBody->m_BoundingBox.intersect(m_Planes.at(k))) pBody->m_DirtyPlanes.append(k);
+                }
+            }
+            else
+            {
+                bool isCut= false;
+                for (int k= 0; k < planeCount; ++k)
+                {
+                    isCut= isCut || !pBody->m_Contours.at(k).isEmpty();
+                }
+                pBody->m_SectionsDirty= pBody->m_SectionsDirty || (clippingChanged && isCut);
+
+                // A body which doesn't cross a moved plane is not visited
+                const int changedCount= changedPlanes.size();
+                for (int k= 0; k < changedCount; ++k)
+                {
+                    const int planeIndex= changedPlanes.at(k);
+                    if (pBody->m_BoundingBox.intersect(m_Planes.at(planeIndex)))
+                    {
+                        pBody->m_DirtyPlanes.append(planeIndex);
+                    }
+                    else if (!pBody->m_Contours.at(planeIndex).isEmpty())
+                    {
+                        pBody->m_Contours[planeIndex].clear();
+                        pBody->m_SectionsDirty= true;
+                    }
+                }
+            }
+            pBody->m_SectionsDirty= pBody->m_SectionsDirty || !pBody->m_DirtyPlanes.isEmpty();
+
+            m_BodyHash.insert(key, pBody);
+            m_Bodies.append(pBody);
+        }
+    }
+    qDeleteAll(previousBodies);
+
+    // Trees of the meshes which are no longer used are removed
+    QHash<GLC_uint, MeshTree*>::iterator iTree= m_MeshTrees.begin();
+    while (iTree != m_MeshTrees.end())
+    {
+        if (usedMeshes.contains(iTree.key()))
+        {
+            ++iTree;
+        }
+        else
+        {
+            delete iTree.value();
+            iTree= m_MeshTrees.erase(iTree);
+        }
+    }
+
+    // Trees of the new meshes
+    if (!newMeshes.isEmpty())
+    {
+        const QList<MeshTree*> newTrees(QtConcurrent::blockingMapped<QList<MeshTree*> >(newMeshes, &GLC_SectionEngine::createMeshTree));
+        const int newMeshCount= newMeshes.size();
+        for (int i= 0; i < newMeshCount; ++i)
+        {
+            m_MeshTrees.insert(newMeshes.at(i)->id(), newTrees.at(i));
+        }
+    }
+
+    QVector<Body*> dirtyBodies;
+    const int bodyCount= m_Bodies.size();
+    for (int i= 0; i < bodyCount; ++i)
+    {
+        Body* pBody= m_Bodies.at(i);
+        pBody->m_pTree= m_MeshTrees.value(pBody->m_MeshId);
+        if (pBody->m_SectionsDirty) dirtyBodies.append(pBody);
+    }
+
+    if (dirtyBodies.size() > 1)
+    {
+        QtConcurrent::blockingMap(dirtyBodies, [this](Body* pBody)
+        {
+            updateBody(pBody);
+        });
+    }
+    else if (!dirtyBodies.isEmpty())
+    {
+        updateBody(dirtyBodies.first());
+    }
+
+    m_Statistics.m_BodyCount= bodyCount;
+    for (int i= 0; i < bodyCount; ++i)
+    {
+        const Body* pBody= m_Bodies.at(i);
+        if (!pBody->m_DirtyPlanes.isEmpty()) ++m_Statistics.m_UpdatedBodyCount;
+        m_Statistics.m_VisitedTriangleCount+= pBody->m_VisitedTriangleCount;
+
+        bool isCut= false;
+        for (int j= 0; j < planeCount; ++j)
+        {
+            const QList<Contour>& contours= pBody->m_Contours.at(j);
+            isCut= isCut || !contours.isEmpty();
+            const int contourCount= contours.size();
+            for (int k= 0; k < contourCount; ++k)
+            {
+                if (!contours.at(k).m_IsClosed) ++m_Statistics.m_OpenContourCount;
+            }
+        }
+        if (isCut) ++m_Statistics.m_CutBodyCount;
+    }
+
+    m_UpdatedPlanes= m_Planes;
+    m_PlaneRemoved= false;
+}
+
+void GLC_SectionEngine::clear()
+{
+    qDeleteAll(m_Bodies);
+    m_Bodies.clear();
+    m_BodyHash.clear();
+    qDeleteAll(m_MeshTrees);
+    m_MeshTrees.clear();
+    m_UpdatedPlanes.clear();
+    m_PlaneRemoved= false;
+    m_Statistics= Statistics();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+GLC_SectionEngine::MeshTree* GLC_SectionEngine::createMeshTree(const GLC_Mesh* pMesh)
+{
+    MeshTree* pSubject= new MeshTree;
+    pSubject->m_Bvh= GLC_MeshBvh(pMesh);
+    pSubject->m_Color= QColor(Qt::lightGray);
+
+    const QList<GLC_Material*> materials(pMesh->materialSet().values());
+    const int materialCount= materials.size();
+    for (int i= 0; i < materialCount; ++i)
+    {
+        if (pMesh->lodContainsMaterial(0, materials.at(i)->id()))
+        {
+            pSubject->m_Color= materials.at(i)->diffuseColor();
+            break;
+        }
+    }
+
+    return pSubject;
+}
+
+void GLC_SectionEngine::updateBody(Body* pBody) const
+{
+    const int dirtyCount= pBody->m_DirtyPlanes.size();
+    for (int i= 0; i < dirtyCount; ++i)
+    {
+        const int planeIndex= pBody->m_DirtyPlanes.at(i);
+        pBody->m_Contours[planeIndex]= cutBody(pBody, m_Planes.at(planeIndex));
+    }
+    buildSections(pBody);
+}
+
+QList<GLC_SectionEngine::Contour> GLC_SectionEngine::cutBody(Body* pBody, const GLC_Plane& plane) const
+{
+    QList<Contour> subject;
+    if ((nullptr == pBody->m_pTree) || pBody->m_pTree->m_Bvh.isEmpty()) return subject;
+    const GLC_MeshBvh& bvh= pBody->m_pTree->m_Bvh;
+
+    // The plane in the mesh coordinates
+    const double* pMatrix= pBody->m_Matrix.getData();
+    const double* pEq= plane.data();
+    const double a= pEq[0] * pMatrix[0] + pEq[1] * pMatrix[1] + pEq[2] * pMatrix[2];
+    const double b= pEq[0] * pMatrix[4] + pEq[1] * pMatrix[5] + pEq[2] * pMatrix[6];
+    const double c= pEq[0] * pMatrix[8] + pEq[1] * pMatrix[9] + pEq[2] * pMatrix[10];
+    const double d= pEq[0] * pMatrix[12] + pEq[1] * pMatrix[13] + pEq[2] * pMatrix[14] + pEq[3];
+
+    const GLfloat* pPositions= bvh.positions().constData();
+    const GLuint* pTriangles= bvh.triangles().constData();
+    QVector<Segment> segments;
+    QVector<int> stack;
+    stack.append(0);
+    while (!stack.isEmpty())
+    {
+        const GLC_MeshBvh::Node& node= bvh.nodes().at(stack.takeLast());
+        const double centerDistance= a * (node.m_Min[0] + node.m_Max[0]) * 0.5 + b * (node.m_Min[1] + node.m_Max[1]) * 0.5
+                + c * (node.m_Min[2] + node.m_Max[2]) * 0.5 + d;
+        const double radius= (qAbs(a) * (node.m_Max[0] - node.m_Min[0]) + qAbs(b) * (node.m_Max[1] - node.m_Min[1])
+                + qAbs(c) * (node.m_Max[2] - node.m_Min[2])) * 0.5;
+        if (((centerDistance - radius) >= 0.0) || ((centerDistance + radius) < 0.0)) continue;
+
+        if (0 == node.m_Count)
+        {
+            stack.append(node.m_First);
+            stack.append(node.m_First + 1);
+            continue;
+        }
+
+        pBody->m_VisitedTriangleCount+= node.m_Count;
+        const int end= node.m_First + node.m_Count;
+        for (int i= node.m_First; i < end; ++i)
+        {
+            GLuint index[3];
+            double distances[3];
+            bool positive[3];
+            for (int k= 0; k < 3; ++k)
+            {
+                index[k]= pTriangles[i * 3 + k];
+                const GLfloat* pVertex= pPositions + index[k] * 3;
+                distances[k]= a * pVertex[0] + b * pVertex[1] + c * pVertex[2] + d;
+                positive[k]= distances[k] >= 0.0;
+            }
+            if ((positive[0] == positive[1]) && (positive[1] == positive[2])) continue;
+
+            Segment segment;
+            int pointCount= 0;
+            for (int k= 0; k < 3; ++k)
+            {
+                const int next= (k + 1) % 3;
+                if (positive[k] == positive[next]) continue;
+
+                // The point of a shared edge is computed from its lower vertex for both triangles
+                const int first= (index[k] < index[next]) ? k : next;
+                const int second= (first == k) ? next : k;
+                const GLfloat* pFirst= pPositions + index[first] * 3;
+                const GLfloat* pSecond= pPositions + index[second] * 3;
+                segment.m_Keys[pointCount]= (static_cast<quint64>(index[first]) << 32) | index[second];
+                segment.m_Points[pointCount]= interpolate(GLC_Point3d(pFirst[0], pFirst[1], pFirst[2]), GLC_Point3d(pSecond[0], pSecond[1], pSecond[2])
+                                                          , distances[first], distances[second]);
+                ++pointCount;
+            }
+            segments.append(segment);
+        }
+    }
+
+    // Chain the segments by their shared edges
+    const int segmentCount= segments.size();
+    QMultiHash<quint64, int> edgeHash;
+    edgeHash.reserve(segmentCount * 2);
+    for (int i= 0; i < segmentCount; ++i)
+    {
+        edgeHash.insert(segments.at(i).m_Keys[0], i);
+        edgeHash.insert(segments.at(i).m_Keys[1], i);
+    }
+
+    QVector<bool> used(segmentCount, false);
+    auto nextSegment= [&](quint64 key, int current) -> int
+    {
+        QMultiHash<quint64, int>::const_iterator iEdge= edgeHash.constFind(key);
+        while ((iEdge != edgeHash.constEnd()) && (iEdge.key() == key))
+        {
+            if ((iEdge.value() != current) && !used.at(iEdge.value())) return iEdge.value();
+            ++iEdge;
+        }
+        return -1;
+    };
+
+    for (int i= 0; i < segmentCount; ++i)
+    {
+        if (used.at(i)) continue;
+        used[i]= true;
+        const Segment& start= segments.at(i);
+        QList<GLC_Point3d> points;
+        points << start.m_Points[0] << start.m_Points[1];
+
+        bool isClosed= false;
+        quint64 endKey= start.m_Keys[1];
+        int current= i;
+        int next;
+        while ((next= nextSegment(endKey, current)) >= 0)
+        {
+            used[next]= true;
+            const Segment& segment= segments.at(next);
+            const int side= (segment.m_Keys[0] == endKey) ? 1 : 0;
+            endKey= segment.m_Keys[side];
+            current= next;
+            if (endKey == start.m_Keys[0])
+            {
+                isClosed= true;
+                break;
+            }
+            points.append(segment.m_Points[side]);
+        }
+
+        if (!isClosed)
+        {
+            endKey= start.m_Keys[0];
+            current= i;
+            while ((next= nextSegment(endKey, current)) >= 0)
+            {
+                used[next]= true;
+                const Segment& segment= segments.at(next);
+                const int side= (segment.m_Keys[0] == endKey) ? 1 : 0;
+                endKey= segment.m_Keys[side];
+                current= next;
+                points.prepend(segment.m_Points[side]);
+            }
+        }
+
+        // Remove the points of degenerated segments and go to world coordinates
+        Contour contour;
+        contour.m_IsClosed= isClosed;
+        const int pointCount= points.size();
+        for (int j= 0; j < pointCount; ++j)
+        {
+            if (contour.m_Points.isEmpty() || (points.at(j) != points.at(j - 1)))
+            {
+                contour.m_Points.append(pBody->m_Matrix * points.at(j));
+            }
+        }
+        if (isClosed && (contour.m_Points.size() > 1) && (contour.m_Points.last() == contour.m_Points.first()))
+        {
+            contour.m_Points.removeLast();
+        }
+
+        if (contour.m_Points.size() > (isClosed ? 2 : 1))
+        {
+            subject.append(contour);
+        }
+    }
+
+    return subject;
+}
+
+void GLC_SectionEngine::buildSections(Body* pBody) const
+{
+    const int planeCount= m_Planes.size();
+    pBody->m_Sections.resize(planeCount);
+    const QColor color((nullptr != pBody->m_pTree) ? pBody->m_pTree->m_Color : QColor(Qt::lightGray));
+    for (int i= 0; i < planeCount; ++i)
+    {
+        BodySection section;
+        section.m_InstanceId= pBody->m_InstanceId;
+        section.m_BodyIndex= pBody->m_BodyIndex;
+        section.m_Color= color;
+
+        const QList<Contour>& contours= pBody->m_Contours.at(i);
+        if (contours.isEmpty())
+        {
+            pBody->m_Sections[i]= section;
+            continue;
+        }
+
+        // Contours clipped by the other planes
+        section.m_Contours= contours;
+        for (int j= 0; j < planeCount; ++j)
+        {
+            if (j == i) continue;
+            QList<Contour> clippedContours;
+            const int contourCount= section.m_Contours.size();
+            for (int k= 0; k < contourCount; ++k)
+            {
+                clipContour(section.m_Contours.at(k), m_Planes.at(j), &clippedContours);
+            }
+            section.m_Contours= clippedContours;
+        }
+
+        // Basis of the plane with u ^ v == n
+        const GLC_Plane& plane= m_Planes.at(i);
+        const GLC_Vector3d normal(plane.normal());
+        GLC_Vector3d axis(1.0, 0.0, 0.0);
+        if ((qAbs(normal.y()) < qAbs(normal.x())) && (qAbs(normal.y()) <= qAbs(normal.z()))) axis.setVect(0.0, 1.0, 0.0);
+        else if ((qAbs(normal.z()) < qAbs(normal.x())) && (qAbs(normal.z()) < qAbs(normal.y()))) axis.setVect(0.0, 0.0, 1.0);
+        const GLC_Vector3d u((normal ^ axis).normalize());
+        const GLC_Vector3d v(normal ^ u);
+        const GLC_Point3d origin(normal * (-plane.coefD()));
+
+        // Closed contours in plane coordinates
+        QVector<QVector<QPointF> > polygons;
+        double extent= 0.0;
+        const int contourCount= contours.size();
+        for (int j= 0; j < contourCount; ++j)
+        {
+            const Contour& contour= contours.at(j);
+            if (!contour.m_IsClosed) continue;
+            QVector<QPointF> polygon;
+            const int pointCount= contour.m_Points.size();
+            for (int k= 0; k < pointCount; ++k)
+            {
+                const GLC_Vector3d vector(contour.m_Points.at(k) - origin);
+                const QPointF point(vector * u, vector * v);
+                extent= qMax(extent, qMax(qAbs(point.x()), qAbs(point.y())));
+                polygon.append(point);
+            }
+            polygons.append(polygon);
+        }
+        if (polygons.isEmpty() || (extent <= 0.0))
+        {
+            pBody->m_Sections[i]= section;
+            continue;
+        }
+
+        // The other planes clip a square larger than the contours
+        const double size= extent * 2.0;
+        QVector<QPointF> clipPolygon;
+        clipPolygon << QPointF(-size, -size) << QPointF(size, -size) << QPointF(size, size) << QPointF(-size, size);
+        for (int j= 0; (j < planeCount) && !clipPolygon.isEmpty(); ++j)
+        {
+            if (j == i) continue;
+            const GLC_Plane& otherPlane= m_Planes.at(j);
+            const GLC_Vector3d otherNormal(otherPlane.normal());
+            clipPolygon= clipConvexPolygon(clipPolygon, otherNormal * u, otherNormal * v, otherPlane.distanceToPoint(origin));
+        }
+        if (clipPolygon.size() < 3)
+        {
+            pBody->m_Sections[i]= section;
+            continue;
+        }
+
+        const double scale= clipperRange / extent;
+        auto toPath= [scale](const QVector<QPointF>& polygon)
+        {
+            ClipperLibC2t::Path subject;
+            const int pointCount= polygon.size();
+            for (int k= 0; k < pointCount; ++k)
+            {
+                const QPointF& point= polygon.at(k);
+                subject.push_back(ClipperLibC2t::IntPoint(static_cast<ClipperLibC2t::cInt>(std::llround(point.x() * scale))
+                                                          , static_cast<ClipperLibC2t::cInt>(std::llround(point.y() * scale))));
+            }
+            return subject;
+        };
+
+        ClipperLibC2t::Paths subjectPaths;
+        const int polygonCount= polygons.size();
+        for (int j= 0; j < polygonCount; ++j)
+        {
+            subjectPaths.push_back(toPath(polygons.at(j)));
+        }
+
+        std::vector<p2tC2t::Point*> triangulationPoints;
+        try
+        {
+            ClipperLibC2t::Clipper clipper;
+            clipper.StrictlySimple(true);
+            clipper.AddPaths(subjectPaths, ClipperLibC2t::ptSubject, true);
+            clipper.AddPath(toPath(clipPolygon), ClipperLibC2t::ptClip, true);
+            ClipperLibC2t::PolyTree polyTree;
+            clipper.Execute(ClipperLibC2t::ctIntersection, polyTree, ClipperLibC2t::pftEvenOdd, ClipperLibC2t::pftEvenOdd);
+
+            // Each outer polygon is triangulated with its holes
+            for (ClipperLibC2t::PolyNode* pNode= polyTree.GetFirst(); nullptr != pNode; pNode= pNode->GetNext())
+            {
+                if (pNode->IsHole() || (pNode->Contour.size() < 3)) continue;
+
+                auto toPolyline= [&triangulationPoints](const ClipperLibC2t::Path& path)
+                {
+                    std::vector<p2tC2t::Point*> subject;
+                    for (size_t k= 0; k < path.size(); ++k)
+                    {
+                        subject.push_back(new p2tC2t::Point(static_cast<double>(path[k].X), static_cast<double>(path[k].Y)));
+                        triangulationPoints.push_back(subject.back());
+                    }
+                    return subject;
+                };
+
+                p2tC2t::CDT cdt(toPolyline(pNode->Contour));
+                for (size_t k= 0; k < pNode->Childs.size(); ++k)
+                {
+                    if (pNode->Childs[k]->Contour.size() > 2) cdt.AddHole(toPolyline(pNode->Childs[k]->Contour));
+                }
+                cdt.Triangulate();
+
+                const std::vector<p2tC2t::Triangle*> triangles(cdt.GetTriangles());
+                for (size_t k= 0; k < triangles.size(); ++k)
+                {
+                    QPointF points[3];
+                    for (int l= 0; l < 3; ++l)
+                    {
+                        const p2tC2t::Point* pPoint= triangles[k]->GetPoint(l);
+                        points[l]= QPointF(pPoint->x / scale, pPoint->y / scale);
+                    }
+                    const double doubleArea= (points[1].x() - points[0].x()) * (points[2].y() - points[0].y())
+                            - (points[2].x() - points[0].x()) * (points[1].y() - points[0].y());
+                    section.m_CapArea+= qAbs(doubleArea) * 0.5;
+
+                    // Clockwise in the plane so that the cap faces the removed side
+                    if (doubleArea > 0.0) std::swap(points[1], points[2]);
+                    for (int l= 0; l < 3; ++l)
+                    {
+                        section.m_CapTriangles.append(origin + u * points[l].x() + v * points[l].y());
+                    }
+                }
+            }
+        }
+        catch (std::exception& e)
+        {
+            section.m_CapTriangles.clear();
+            section.m_CapArea= 0.0;
+            GLC_ErrorLog::addError(QString("GLC_SectionEngine::buildSections : cap triangulation failed : ") + e.what());
+        }
+        for (size_t k= 0; k < triangulationPoints.size(); ++k)
+        {
+            delete triangulationPoints[k];
+        }
+
+        pBody->m_Sections[i]= section;
+    }
+}
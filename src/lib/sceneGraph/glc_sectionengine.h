@@ -0,0 +1,284 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_sectionengine.h interface for the GLC_SectionEngine class.
+
+#ifndef GLC_SECTIONENGINE_H_
+#define GLC_SECTIONENGINE_H_
+
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QColor>
+
+#include "../geometry/glc_meshbvh.h"
+#include "../maths/glc_plane.h"
+#include "../maths/glc_vector3d.h"
+#include "../maths/glc_matrix4x4.h"
+#include "../glc_boundingbox.h"
+#include "../glc_global.h"
+
+#include "../glc_config.h"
+
+class GLC_3DViewCollection;
+class GLC_Mesh;
+class GLC_Polylines;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_SectionEngine
+/*! \brief GLC_SectionEngine : Compute the sections of the bodies of a collection by cutting planes*/
+
+/*! The sections are computed on the CPU from the triangles of the meshes, they can be
+ *  measured, exported and displayed without clip planes support.
+ *
+ *  Like OpenGL clip planes, a plane keeps the side where its equation is positive.
+ *  The section of a body by a plane is made of contours in world coordinates and of
+ *  the triangles of the cap which closes the body on the plane. Contours and caps are clipped
+ *  by the other planes.
+ *
+ *  A triangle tree is built once by mesh, in the mesh coordinates, and shared by the instances
+ *  of the mesh. update() only revisits the bodies whose plane or position has changed and whose
+ *  bounding box crosses the plane, and only the triangles of the tree nodes crossing the plane.
+ *  When a plane is dragged, bodies which were not cut and are still not cut cost a bounding box test.
+ *
+ *  The bodies to update are processed by the global thread pool.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_SectionEngine
+{
+public:
+    //! A contour of a section
+    struct Contour
+    {
+        //! The points of the contour in world coordinates, the first point is not repeated
+        QVector<GLC_Point3d> m_Points;
+
+        //! True if the contour is closed
+        bool m_IsClosed;
+    };
+
+    //! The section of a body by a plane
+    struct BodySection
+    {
+        BodySection();
+
+        //! The id of the instance of the body
+        GLC_uint m_InstanceId;
+
+        //! The index of the body in its instance
+        int m_BodyIndex;
+
+        //! The color of the body material
+        QColor m_Color;
+
+        //! The contours of the section
+        QList<Contour> m_Contours;
+
+        //! The triangles of the cap in world coordinates, 3 points by triangle
+        /*! The triangles are oriented against the plane normal*/
+        QVector<GLC_Point3d> m_CapTriangles;
+
+        //! The area of the cap
+        double m_CapArea;
+    };
+
+    //! Statistics of an update
+    struct Statistics
+    {
+        Statistics();
+
+        //! Number of bodies of the collection
+        int m_BodyCount;
+
+        //! Number of bodies whose triangles have been visited
+        int m_UpdatedBodyCount;
+
+        //! Number of visited triangles
+        int m_VisitedTriangleCount;
+
+        //! Number of cut bodies
+        int m_CutBodyCount;
+
+        //! Number of open contours, an open contour comes from a mesh which is not closed
+        int m_OpenContourCount;
+    };
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    GLC_SectionEngine();
+    ~GLC_SectionEngine();
+private:
+    Q_DISABLE_COPY(GLC_SectionEngine)
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the number of planes
+    inline int planeCount() const
+    {return m_Planes.size();}
+
+    //! Return the plane of the given index
+    inline const GLC_Plane& plane(int index) const
+    {return m_Planes.at(index);}
+
+    //! Return the sections of the cut bodies by the plane of the given index, in collection order
+    QList<BodySection> sections(int planeIndex) const;
+
+    //! Return the total cap area of the plane of the given index
+    double capArea(int planeIndex) const;
+
+    //! Return a new mesh of the caps of the plane of the given index
+    /*! Each cap has a material of the color of its body. Return nullptr if there is no cap*/
+    GLC_Mesh* createCapMesh(int planeIndex) const;
+
+    //! Return new polylines of the contours of the plane of the given index
+    /*! Return nullptr if there is no contour*/
+    GLC_Polylines* createContourPolylines(int planeIndex) const;
+
+    //! Return the statistics of the last update
+    inline const Statistics& statistics() const
+    {return m_Statistics;}
+
+    //! Return the number of meshes which have a triangle tree
+    inline int meshTreeCount() const
+    {return m_MeshTrees.size();}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Add the given plane and return its index
+    int addPlane(const GLC_Plane& plane);
+
+    //! Set the plane of the given index, the sections are updated by the next update()
+    void setPlane(int index, const GLC_Plane& plane);
+
+    //! Remove the plane of the given index
+    void removePlane(int index);
+
+    //! Remove all planes
+    void removeAllPlanes();
+
+    //! Update the sections of the visible bodies of the given collection
+    void update(GLC_3DViewCollection* pCollection);
+
+    //! Remove the sections and the triangle trees
+    void clear();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Triangle tree of a mesh and color of its first material
+    struct MeshTree
+    {
+        GLC_MeshBvh m_Bvh;
+        QColor m_Color;
+    };
+
+    //! A cut segment of a triangle
+    struct Segment
+    {
+        //! Keys of the cut edges
+        quint64 m_Keys[2];
+        //! Points in the mesh coordinates
+        GLC_Point3d m_Points[2];
+    };
+
+    //! A body of the collection and its sections
+    struct Body
+    {
+        GLC_uint m_InstanceId;
+        int m_BodyIndex;
+        GLC_uint m_MeshId;
+        const MeshTree* m_pTree;
+        GLC_Matrix4x4 m_Matrix;
+        GLC_BoundingBox m_BoundingBox;
+
+        //! Contours of each plane before the clipping by the other planes
+        QVector<QList<Contour> > m_Contours;
+
+        //! Section of each plane
+        QVector<BodySection> m_Sections;
+
+        //! Planes whose contours must be computed by the current update
+        QVector<int> m_DirtyPlanes;
+
+        //! True if the sections must be built by the current update
+        bool m_SectionsDirty;
+
+        //! Visited triangles of the current update
+        int m_VisitedTriangleCount;
+    };
+
+    //! Return a new triangle tree of the given mesh
+    static MeshTree* createMeshTree(const GLC_Mesh* pMesh);
+
+    //! Compute the dirty contours and the sections of the given body
+    void updateBody(Body* pBody) const;
+
+    //! Return the contours of the given body cut by the given plane
+    QList<Contour> cutBody(Body* pBody, const GLC_Plane& plane) const;
+
+    //! Build the sections of the given body from its contours
+    void buildSections(Body* pBody) const;
+
+    //! Return the key of the given body
+    static inline quint64 bodyKey(GLC_uint instanceId, int bodyIndex)
+    {return (static_cast<quint64>(instanceId) << 32) | static_cast<quint32>(bodyIndex);}
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The cutting planes
+    QVector<GLC_Plane> m_Planes;
+
+    //! The planes of the last update
+    QVector<GLC_Plane> m_UpdatedPlanes;
+
+    //! True if a plane has been removed since the last update
+    bool m_PlaneRemoved;
+
+    //! The bodies of the last update
+    QHash<quint64, Body*> m_BodyHash;
+
+    //! The bodies of the last update in collection order
+    QVector<Body*> m_Bodies;
+
+    //! The triangle trees of the meshes
+    QHash<GLC_uint, MeshTree*> m_MeshTrees;
+
+    //! The statistics of the last update
+    Statistics m_Statistics;
+};
+
+#endif /* GLC_SECTIONENGINE_H_ */
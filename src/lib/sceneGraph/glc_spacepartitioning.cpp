@@ -45,6 +45,21 @@ GLC_SpacePartitioning::~GLC_SpacePartitioning()
 
 }
 
+void GLC_SpacePartitioning::insertInstance(GLC_3DViewInstance*)
+{
+    clear();
+}
+
+void GLC_SpacePartitioning::removeInstance(GLC_3DViewInstance*)
+{
+    clear();
+}
+
+void GLC_SpacePartitioning::moveInstance(GLC_3DViewInstance*)
+{
+    clear();
+}
+
 void GLC_SpacePartitioning::set3DViewCollection(GLC_3DViewCollection *pCollection)
 {
     Q_ASSERT(NULL != pCollection);
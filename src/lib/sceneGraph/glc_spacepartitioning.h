@@ -83,6 +83,18 @@ public:
 	//! Clear the space partionning
 	virtual void clear()= 0;
 
+	//! Insert the given instance added to the collection
+	/*! The default implementation clears the space partitioning, it is rebuilt on next update*/
+	virtual void insertInstance(GLC_3DViewInstance* pInstance);
+
+	//! Remove the given instance before it is removed from the collection
+	/*! The default implementation clears the space partitioning, it is rebuilt on next update*/
+	virtual void removeInstance(GLC_3DViewInstance* pInstance);
+
+	//! Update the given instance after its bounding box has changed
+	/*! The default implementation clears the space partitioning, it is rebuilt on next update*/
+	virtual void moveInstance(GLC_3DViewInstance* pInstance);
+
     //! Set the collection to use
     void set3DViewCollection(GLC_3DViewCollection* pCollection);
 
@@ -0,0 +1,284 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_staticbatch.cpp implementation of the GLC_StaticBatch class.
+
+#include <QVector>
+
+#include "glc_staticbatch.h"
+#include "glc_structoccurrence.h"
+#include "glc_worldhandle.h"
+#include "glc_3dviewcollection.h"
+#include "glc_3dviewinstance.h"
+#include "../geometry/glc_3drep.h"
+#include "../geometry/glc_mesh.h"
+#include "../shading/glc_material.h"
+
+namespace
+{
+    //! Merged mesh under construction
+    struct MergedMesh
+    {
+        GLC_Mesh* m_pMesh;
+        int m_VertexCount;
+        GLfloatVector m_Positions;
+        GLfloatVector m_Normals;
+        GLfloatVector m_Texels;
+        QHash<GLC_uint, GLC_uint> m_PrimitiveOccurrenceHash;
+    };
+}
+
+GLC_StaticBatch::GLC_StaticBatch(GLC_StructOccurrence* pOccurrence, int maxVertexCount)
+    : m_pOccurrence(pOccurrence)
+    , m_MaxVertexCount(qMax(3, maxVertexCount))
+    , m_InstanceId(0)
+    , m_BakedOccurrenceIds()
+    , m_PrimitiveOccurrenceHashList()
+{
+    Q_ASSERT(nullptr != m_pOccurrence);
+}
+
+GLC_StaticBatch::~GLC_StaticBatch()
+{
+    unflatten();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+GLC_uint GLC_StaticBatch::occurrenceId(int bodyIndex, GLC_uint primitiveId) const
+{
+    GLC_uint subject= 0;
+    if ((bodyIndex >= 0) && (bodyIndex < m_PrimitiveOccurrenceHashList.size()))
+    {
+        subject= m_PrimitiveOccurrenceHashList.at(bodyIndex).value(primitiveId, 0);
+    }
+
+    return subject;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Set Functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_StaticBatch::flatten()
+{
+    unflatten();
+
+    GLC_3DViewCollection* pCollection= collection();
+    if (nullptr == pCollection) return false;
+
+    const QList<GLC_StructOccurrence*> occurrenceList(QList<GLC_StructOccurrence*>() << m_pOccurrence << m_pOccurrence->subOccurrenceList());
+
+    // Merged meshes of each material, the last one is filled
+    QHash<GLC_Material*, QList<MergedMesh> > mergedMeshHash;
+    QList<GLC_Material*> materialOrder;
+
+    for (GLC_StructOccurrence* pOccurrence : occurrenceList)
+    {
+        if (!canBeBaked(pOccurrence)) continue;
+
+        const GLC_uint occurrenceId= pOccurrence->id();
+        GLC_3DViewInstance* pInstance= pCollection->instanceHandle(occurrenceId);
+        const GLC_Matrix4x4 matrix(pInstance->matrix());
+        // Normals are transformed by the inverse-transpose of the matrix :
+        // the columns of the inverse give the rows of the normal matrix
+        const GLC_Matrix4x4 inverseMatrix(matrix.inverted());
+        const GLC_Vector3d normalRowX(inverseMatrix.getXvector());
+        const GLC_Vector3d normalRowY(inverseMatrix.getYvector());
+        const GLC_Vector3d normalRowZ(inverseMatrix.getZvector());
+        // A mirroring matrix reverses the triangles orientation
+        const bool isMirrored= matrix.determinant() < 0.0;
+
+        const int bodyCount= pInstance->numberOfBody();
+        for (int i= 0; i < bodyCount; ++i)
+        {
+            GLC_Mesh* pSourceMesh= dynamic_cast<GLC_Mesh*>(pInstance->geomAt(i));
+            const GLfloatVector& positions= pSourceMesh->positionVector();
+            const GLfloatVector& normals= pSourceMesh->normalVector();
+            const GLfloatVector& texels= pSourceMesh->texelVector();
+            const int sourceVertexCount= positions.size() / 3;
+            // Checked by canBeBaked() : an occurrence is baked and hidden only if all its bodies are baked
+            Q_ASSERT((sourceVertexCount > 0) && (normals.size() == positions.size()));
+
+            const QList<GLC_Material*> materialList(pSourceMesh->materialSet().values());
+            for (GLC_Material* pMaterial : materialList)
+            {
+                const IndexList sourceIndex(pSourceMesh->equivalentTrianglesIndex(0, pMaterial->id()));
+                if (sourceIndex.isEmpty()) continue;
+
+                // Only the used vertices are copied
+                QVector<int> indexMap(sourceVertexCount, -1);
+                IndexList usedVertices;
+                for (GLuint index : sourceIndex)
+                {
+                    if (-1 == indexMap.at(index))
+                    {
+                        indexMap[index]= usedVertices.size();
+                        usedVertices.append(index);
+                    }
+                }
+                const int usedCount= usedVertices.size();
+
+                if (!mergedMeshHash.contains(pMaterial)) materialOrder.append(pMaterial);
+                QList<MergedMesh>& mergedMeshes= mergedMeshHash[pMaterial];
+                if (mergedMeshes.isEmpty() || ((mergedMeshes.last().m_VertexCount > 0) && ((mergedMeshes.last().m_VertexCount + usedCount) > m_MaxVertexCount)))
+                {
+                    MergedMesh mergedMesh;
+                    mergedMesh.m_pMesh= new GLC_Mesh;
+                    mergedMesh.m_pMesh->setName(m_pOccurrence->name() + "-Batch");
+                    mergedMesh.m_VertexCount= 0;
+                    mergedMeshes.append(mergedMesh);
+                }
+                MergedMesh& mergedMesh= mergedMeshes.last();
+                const bool useTexels= pMaterial->hasTexture();
+                const bool hasTexels= (texels.size() == (sourceVertexCount * 2));
+
+                for (int j= 0; j < usedCount; ++j)
+                {
+                    const GLuint index= usedVertices.at(j);
+                    const GLC_Point3d position(matrix * GLC_Point3d(positions.at(index * 3), positions.at(index * 3 + 1), positions.at(index * 3 + 2)));
+                    mergedMesh.m_Positions << static_cast<GLfloat>(position.x()) << static_cast<GLfloat>(position.y()) << static_cast<GLfloat>(position.z());
+
+                    const GLC_Vector3d sourceNormal(normals.at(index * 3), normals.at(index * 3 + 1), normals.at(index * 3 + 2));
+                    GLC_Vector3d normal(normalRowX * sourceNormal, normalRowY * sourceNormal, normalRowZ * sourceNormal);
+                    normal.normalize();
+                    mergedMesh.m_Normals << static_cast<GLfloat>(normal.x()) << static_cast<GLfloat>(normal.y()) << static_cast<GLfloat>(normal.z());
+
+                    if (useTexels)
+                    {
+                        if (hasTexels) mergedMesh.m_Texels << texels.at(index * 2) << texels.at(index * 2 + 1);
+                        else mergedMesh.m_Texels << 0.0f << 0.0f;
+                    }
+                }
+
+                IndexList targetIndex;
+                targetIndex.reserve(sourceIndex.size());
+                for (GLuint index : sourceIndex)
+                {
+                    targetIndex.append(static_cast<GLuint>(mergedMesh.m_VertexCount + indexMap.at(index)));
+                }
+                if (isMirrored)
+                {
+                    const int indexCount= targetIndex.size() - (targetIndex.size() % 3);
+                    for (int j= 0; j < indexCount; j+= 3)
+                    {
+                        targetIndex.swapItemsAt(j + 1, j + 2);
+                    }
+                }
+                mergedMesh.m_VertexCount+= usedCount;
+
+                const GLC_uint primitiveId= mergedMesh.m_pMesh->addTriangles(pMaterial, targetIndex);
+                mergedMesh.m_PrimitiveOccurrenceHash.insert(primitiveId, occurrenceId);
+            }
+        }
+
+        m_BakedOccurrenceIds.append(occurrenceId);
+    }
+
+    if (!m_BakedOccurrenceIds.isEmpty())
+    {
+        GLC_3DRep batchRep;
+        for (GLC_Material* pMaterial : materialOrder)
+        {
+            const QList<MergedMesh> mergedMeshes(mergedMeshHash.value(pMaterial));
+            for (const MergedMesh& mergedMesh : mergedMeshes)
+            {
+                mergedMesh.m_pMesh->addVertice(mergedMesh.m_Positions);
+                mergedMesh.m_pMesh->addNormals(mergedMesh.m_Normals);
+                if (!mergedMesh.m_Texels.isEmpty()) mergedMesh.m_pMesh->addTexels(mergedMesh.m_Texels);
+                mergedMesh.m_pMesh->finish();
+
+                batchRep.addGeom(mergedMesh.m_pMesh);
+                m_PrimitiveOccurrenceHashList.append(mergedMesh.m_PrimitiveOccurrenceHash);
+            }
+        }
+        batchRep.setName(m_pOccurrence->name() + "-Batch");
+
+        GLC_3DViewInstance* pBatchInstance= new GLC_3DViewInstance(batchRep);
+        m_InstanceId= pBatchInstance->id();
+        pCollection->add(pBatchInstance);
+
+        for (GLC_uint occurrenceId : m_BakedOccurrenceIds)
+        {
+            pCollection->setVisibility(occurrenceId, false);
+        }
+    }
+
+    return isFlattened();
+}
+
+void GLC_StaticBatch::unflatten()
+{
+    GLC_3DViewCollection* pCollection= collection();
+    if (isFlattened() && (nullptr != pCollection))
+    {
+        pCollection->remove(m_InstanceId);
+        for (GLC_uint occurrenceId : m_BakedOccurrenceIds)
+        {
+            if (pCollection->contains(occurrenceId))
+            {
+                pCollection->setVisibility(occurrenceId, true);
+            }
+        }
+    }
+
+    m_InstanceId= 0;
+    m_BakedOccurrenceIds.clear();
+    m_PrimitiveOccurrenceHashList.clear();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+GLC_3DViewCollection* GLC_StaticBatch::collection() const
+{
+    GLC_3DViewCollection* pCollection= nullptr;
+    if (nullptr != m_pOccurrence->worldHandle())
+    {
+        pCollection= m_pOccurrence->worldHandle()->collection();
+    }
+
+    return pCollection;
+}
+
+bool GLC_StaticBatch::canBeBaked(const GLC_StructOccurrence* pOccurrence) const
+{
+    GLC_3DViewCollection* pCollection= collection();
+    bool subject= pCollection->contains(pOccurrence->id());
+    if (subject)
+    {
+        GLC_3DViewInstance* pInstance= pCollection->instanceHandle(pOccurrence->id());
+        const int bodyCount= pInstance->numberOfBody();
+        subject= pInstance->isVisible() && (bodyCount > 0);
+        for (int i= 0; subject && (i < bodyCount); ++i)
+        {
+            GLC_Mesh* pMesh= dynamic_cast<GLC_Mesh*>(pInstance->geomAt(i));
+            subject= (nullptr != pMesh) && !pMesh->isEmpty() && !pMesh->ColorPearVertexIsAcivated();
+            // The client side data must be available
+            subject= subject && !pMesh->positionVector().isEmpty() && (pMesh->normalVector().size() == pMesh->positionVector().size());
+        }
+    }
+
+    return subject;
+}
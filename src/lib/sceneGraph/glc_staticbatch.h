@@ -0,0 +1,158 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_staticbatch.h interface for the GLC_StaticBatch class.
+
+#ifndef GLC_STATICBATCH_H_
+#define GLC_STATICBATCH_H_
+
+#include <QHash>
+#include <QList>
+
+#include "../glc_global.h"
+
+#include "../glc_config.h"
+
+class GLC_StructOccurrence;
+class GLC_3DViewCollection;
+class GLC_Mesh;
+class GLC_Material;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_StaticBatch
+/*! \brief GLC_StaticBatch : Flatten a rigid occurrence subtree into a few merged meshes*/
+
+/*! flatten() bakes the absolute matrices of the visible occurrences of the subtree
+ *  into merged GLC_Mesh, one or more per material depending on the vertex count limit.
+ *  The merged meshes are displayed by a single GLC_3DViewInstance added to the collection
+ *  of the world and the instances of the baked occurrences are hidden.
+ *
+ *  Each baked (occurrence, body, material) block is a primitive of a merged mesh,
+ *  occurrenceId() returns the source occurrence of the primitive returned by
+ *  GLC_Viewport::selectPrimitive() on the batch instance.
+ *
+ *  unflatten() removes the batch instance and shows the baked occurrences again.
+ *  Only the first LOD of meshes is baked. Meshes with color per vertex, without client side
+ *  normals and other geometries are not baked and the occurrences which use them keep their instance.
+ *  Normals are transformed by the inverse-transpose of the occurrence matrix and the triangles
+ *  of mirrored occurrences are reversed.
+ *  The subtree must not be edited while it is flattened.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_StaticBatch
+{
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Construct the batch of the given occurrence subtree
+    explicit GLC_StaticBatch(GLC_StructOccurrence* pOccurrence, int maxVertexCount= 65536);
+
+    //! Unflatten the subtree if it is flattened
+    ~GLC_StaticBatch();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the root occurrence of the subtree
+    inline GLC_StructOccurrence* occurrence() const
+    {return m_pOccurrence;}
+
+    //! Return the maximum number of vertices of a merged mesh
+    inline int maxVertexCount() const
+    {return m_MaxVertexCount;}
+
+    //! Return true if the subtree is flattened
+    inline bool isFlattened() const
+    {return 0 != m_InstanceId;}
+
+    //! Return the id of the batch instance, 0 if the subtree is not flattened
+    inline GLC_uint instanceId() const
+    {return m_InstanceId;}
+
+    //! Return the number of merged meshes
+    inline int bodyCount() const
+    {return m_PrimitiveOccurrenceHashList.size();}
+
+    //! Return the id of the baked occurrences
+    inline QList<GLC_uint> bakedOccurrenceIds() const
+    {return m_BakedOccurrenceIds;}
+
+    //! Return the source occurrence id of the given primitive of the given merged mesh, 0 if not found
+    GLC_uint occurrenceId(int bodyIndex, GLC_uint primitiveId) const;
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Set the maximum number of vertices of a merged mesh, used by the next flatten()
+    inline void setMaxVertexCount(int count)
+    {m_MaxVertexCount= qMax(3, count);}
+
+    //! Bake the subtree and replace its instances by the batch instance
+    /*! Return false if the subtree has nothing to bake.
+     *  Client side data of the meshes must be available or the OpenGL context current.*/
+    bool flatten();
+
+    //! Remove the batch instance and show the baked occurrences
+    void unflatten();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Return the collection of the subtree world, nullptr if the subtree doesn't belong to a world
+    GLC_3DViewCollection* collection() const;
+
+    //! Return true if all the bodies of the given occurrence can be baked
+    bool canBeBaked(const GLC_StructOccurrence* pOccurrence) const;
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The root occurrence of the subtree
+    GLC_StructOccurrence* m_pOccurrence;
+
+    //! The maximum number of vertices of a merged mesh
+    int m_MaxVertexCount;
+
+    //! The batch instance id
+    GLC_uint m_InstanceId;
+
+    //! The baked occurrences id
+    QList<GLC_uint> m_BakedOccurrenceIds;
+
+    //! Source occurrence of each primitive of each merged mesh
+    QList<QHash<GLC_uint, GLC_uint> > m_PrimitiveOccurrenceHashList;
+
+    Q_DISABLE_COPY(GLC_StaticBatch)
+};
+
+#endif /* GLC_STATICBATCH_H_ */
@@ -25,6 +25,7 @@
 #include "glc_structinstance.h"
 #include "glc_structreference.h"
 #include "glc_structoccurrence.h"
+#include "glc_worldhandle.h"
 
 // Default constructor
 GLC_StructInstance::GLC_StructInstance(GLC_StructReference* pStructReference)
@@ -156,6 +157,9 @@ void GLC_StructInstance::setReference(GLC_StructReference* pStructReference)
 	{
 		m_Name= pStructReference->name();
 	}
+
+	// Every occurrence of this instance now has the new reference
+	updateOccurrencesIndex();
 }
 
 // Destructor
@@ -189,3 +193,33 @@ void GLC_StructInstance::updateOccurrencesAbsoluteMatrix()
 		m_ListOfOccurrences.at(i)->updateChildrenAbsoluteMatrix();
 	}
 }
+
+void GLC_StructInstance::setName(const QString& name)
+{
+	m_Name= name;
+	updateOccurrencesIndex();
+}
+
+void GLC_StructInstance::setAttributes(const GLC_Attributes& attr)
+{
+	delete m_pAttributes;
+	m_pAttributes= new GLC_Attributes(attr);
+	updateOccurrencesIndex();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_StructInstance::updateOccurrencesIndex() const
+{
+	const int occurrenceCount= m_ListOfOccurrences.count();
+	for (int i= 0; i < occurrenceCount; ++i)
+	{
+		GLC_StructOccurrence* pOcc= m_ListOfOccurrences.at(i);
+		if (nullptr != pOcc->worldHandle())
+		{
+			pOcc->worldHandle()->updateOccurrenceIndex(pOcc);
+		}
+	}
+}
@@ -162,15 +162,12 @@ public:
 	}
 
 	//! Set the instance name
-	inline void setName(const QString& name)
-	{m_Name= name;}
+	/*! The lookup index of the worlds of the occurrences is updated*/
+	void setName(const QString& name);
 
 	//! Set the instance attributes
-	inline void setAttributes(const GLC_Attributes& attr)
-	{
-		delete m_pAttributes;
-		m_pAttributes= new GLC_Attributes(attr);
-	}
+	/*! The lookup index of the worlds of the occurrences is updated*/
+	void setAttributes(const GLC_Attributes& attr);
 
 	//! Update absolute matrix off children and all occurrences of this instance
 	void updateOccurrencesAbsoluteMatrix();
@@ -178,6 +175,13 @@ public:
 
 //@}
 
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Update the lookup index of the worlds of the occurrences of this instance
+	void updateOccurrencesIndex() const;
+
 //////////////////////////////////////////////////////////////////////
 // Private members
 //////////////////////////////////////////////////////////////////////
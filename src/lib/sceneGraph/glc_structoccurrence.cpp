@@ -680,10 +680,11 @@ GLC_StructOccurrence* GLC_StructOccurrence::updateAbsoluteMatrix()
 		m_AbsoluteMatrix= relativeMatrix;
 	}
 	// If the occurrence have a representation, update it.
-
+    if (nullptr != m_pWorldHandle) m_pWorldHandle->incrementRevision();
     if ((nullptr != m_pWorldHandle) && m_pWorldHandle->collection()->contains(m_Uid))
 	{
 		m_pWorldHandle->collection()->instanceHandle(m_Uid)->setMatrix(m_AbsoluteMatrix);
+		m_pWorldHandle->collection()->instanceMoved(m_Uid);
 	}
 	return this;
 }
@@ -711,6 +712,11 @@ void GLC_StructOccurrence::addChild(GLC_StructOccurrence* pChild)
 	{
 		pChild->setWorldHandle(m_pWorldHandle);
 	}
+    else
+    {
+        // The child parent has changed
+        m_pWorldHandle->updateOccurrenceIndex(pChild);
+    }
 
     if ((nullptr != m_pWorldHandle) && m_pWorldHandle->selectionSetHandle()->contains(this))
     {
@@ -737,6 +743,11 @@ void GLC_StructOccurrence::insertChild(int index, GLC_StructOccurrence* pChild)
 	{
 		pChild->setWorldHandle(m_pWorldHandle);
 	}
+    else
+    {
+        // The child parent has changed
+        m_pWorldHandle->updateOccurrenceIndex(pChild);
+    }
 
     if ((nullptr != m_pWorldHandle) && m_pWorldHandle->selectionSetHandle()->contains(this))
     {
@@ -782,7 +793,9 @@ bool GLC_StructOccurrence::removeChild(GLC_StructOccurrence* pChild)
 {
 	Q_ASSERT(pChild->m_pParent == this);
     pChild->m_pParent= nullptr;
+	// Remove the child and its children from the world and its lookup index
 	pChild->detach();
+    Q_ASSERT((nullptr == m_pWorldHandle) || !m_pWorldHandle->occurrenceIndex()->contains(pChild->id()));
 
 	return m_Childs.removeOne(pChild);
 }
@@ -939,6 +952,7 @@ unsigned int GLC_StructOccurrence::updateOccurrenceNumber(unsigned int n)
 void GLC_StructOccurrence::setVisibility(bool visibility)
 {
 	m_IsVisible= visibility;
+    if (nullptr != m_pWorldHandle) m_pWorldHandle->incrementRevision();
 	if (has3DViewInstance())
 	{
 		m_pWorldHandle->collection()->setVisibility(m_Uid, m_IsVisible);
@@ -1035,6 +1049,7 @@ void GLC_StructOccurrence::setReference(GLC_StructReference* pRef)
 		}
 	}
 
+	// The instance re-indexes all its occurrences
 	m_pStructInstance->setReference(pRef);
 }
 
@@ -226,7 +226,9 @@ public:
 public:
 
 	//! Set Occurrence instance Name
-	inline void setName(const QString name) {m_pStructInstance->setName(name);}
+	/*! The name is shared by all occurrences of the instance*/
+	inline void setName(const QString name)
+	{m_pStructInstance->setName(name);}
 
 	//! Update the absolute matrix
     GLC_StructOccurrence* updateAbsoluteMatrix();
@@ -24,6 +24,7 @@
 
 #include "glc_structreference.h"
 #include "glc_structoccurrence.h"
+#include "glc_worldhandle.h"
 
 // Default constructor
 GLC_StructReference::GLC_StructReference(const QString& name)
@@ -119,6 +120,21 @@ QSet<GLC_StructOccurrence*> GLC_StructReference::setOfStructOccurrence() const
 //////////////////////////////////////////////////////////////////////
 // Set Functions
 //////////////////////////////////////////////////////////////////////
+
+void GLC_StructReference::setName(const QString& name)
+{
+	m_Name= name;
+	// The children of the occurrences are indexed by reference name
+	updateOccurrencesIndex();
+}
+
+void GLC_StructReference::setAttributes(const GLC_Attributes& attr)
+{
+	delete m_pAttributes;
+	m_pAttributes= new GLC_Attributes(attr);
+	updateOccurrencesIndex();
+}
+
 // Set the reference representation
 void GLC_StructReference::setRepresentation(const GLC_3DRep& rep)
 {
@@ -233,6 +249,29 @@ bool GLC_StructReference::loadRepresentation()
 	else return false;
 }
 
+bool GLC_StructReference::loadRepresentation(GLC_3DRep* pLoadedRep)
+{
+    Q_ASSERT(nullptr != m_pRepresentation);
+    bool subject= false;
+    GLC_3DRep* p3DRep= dynamic_cast<GLC_3DRep*>(m_pRepresentation);
+    if ((nullptr != p3DRep) && !p3DRep->isLoaded() && !pLoadedRep->isEmpty())
+    {
+        p3DRep->take(pLoadedRep);
+
+        const QSet<GLC_StructOccurrence*> structOccurrenceSet(this->setOfStructOccurrence());
+        for (GLC_StructOccurrence* pOccurrence : structOccurrenceSet)
+        {
+            if (pOccurrence->useAutomatic3DViewInstanceCreation() && !pOccurrence->has3DViewInstance())
+            {
+                pOccurrence->create3DViewInstance();
+            }
+        }
+        subject= true;
+    }
+
+    return subject;
+}
+
 bool GLC_StructReference::unloadRepresentation()
 {
     Q_ASSERT(nullptr != m_pRepresentation);
@@ -279,3 +318,20 @@ QList<GLC_StructOccurrence*> GLC_StructReference::addChild(GLC_StructOccurrence*
 	return subject;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_StructReference::updateOccurrencesIndex() const
+{
+	const QList<GLC_StructOccurrence*> occurrences(listOfStructOccurrence());
+	const int occurrenceCount= occurrences.count();
+	for (int i= 0; i < occurrenceCount; ++i)
+	{
+		GLC_StructOccurrence* pOcc= occurrences.at(i);
+		if (nullptr != pOcc->worldHandle())
+		{
+			pOcc->worldHandle()->updateOccurrenceIndex(pOcc);
+		}
+	}
+}
@@ -186,18 +186,15 @@ public:
 	{m_SetOfInstance.remove(pInstance);}
 
 	//! Set the reference name
-	inline void setName(const QString& name)
-	{m_Name= name;}
+	/*! The lookup index of the worlds of the occurrences is updated*/
+	void setName(const QString& name);
 
 	//! Set the reference representation
 	void setRepresentation(const GLC_3DRep& rep);
 
 	//! Set the reference attributes
-	inline void setAttributes(const GLC_Attributes& attr)
-	{
-		delete m_pAttributes;
-		m_pAttributes= new GLC_Attributes(attr);
-	}
+	/*! The lookup index of the worlds of the occurrences is updated*/
+	void setAttributes(const GLC_Attributes& attr);
 
 	//! Set the representation name
 	void setRepresentationName(const QString& representationName);
@@ -206,6 +203,11 @@ public:
 	/*! The representation must exists*/
 	bool loadRepresentation();
 
+	//! Load the representation from the given already loaded 3DRep
+	/*! The geometries of the given 3DRep are taken by the representation of this reference
+	 *  The given 3DRep can be loaded in another thread (See GLC_ResidencyManager)*/
+	bool loadRepresentation(GLC_3DRep* pLoadedRep);
+
 	//! Unload the representation
 	/*! The representation must exists*/
 	bool unloadRepresentation();
@@ -217,6 +219,13 @@ public:
 
 //@}
 
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+	//! Update the lookup index of the worlds of the occurrences of this reference
+	void updateOccurrencesIndex() const;
+
 //////////////////////////////////////////////////////////////////////
 // Private members
 //////////////////////////////////////////////////////////////////////
@@ -154,6 +154,60 @@ void GLC_World::createSharpEdges(double precision, double angleThreshold)
     }
 }
 
+int GLC_World::mergeEqualMaterials()
+{
+    const int materialCount= static_cast<int>(numberOfMaterials());
+
+    // Kept materials of each hash code
+    QHash<uint, QList<GLC_Material*> > keptMaterialHash;
+
+    const QList<GLC_StructReference*> referenceList(m_pWorldHandle->references());
+    const int count= referenceList.count();
+    for (int i= 0; i < count; ++i)
+    {
+        GLC_StructReference* pRef= referenceList.at(i);
+        if (pRef->hasRepresentation())
+        {
+            GLC_3DRep* pRep= dynamic_cast<GLC_3DRep*>(pRef->representationHandle());
+            if (nullptr != pRep)
+            {
+                for (int j= 0; j < pRep->numberOfBody(); ++j)
+                {
+                    GLC_Geometry* pGeom= pRep->geomAt(j);
+                    const bool isMesh= (nullptr != dynamic_cast<GLC_Mesh*>(pGeom));
+                    const QList<GLC_Material*> materialList(pGeom->materialSet().values());
+                    for (GLC_Material* pMaterial : materialList)
+                    {
+                        QList<GLC_Material*>& keptMaterials= keptMaterialHash[pMaterial->hashCode()];
+                        GLC_Material* pKeptMaterial= nullptr;
+                        const int keptCount= keptMaterials.count();
+                        for (int k= 0; (k < keptCount) && (nullptr == pKeptMaterial); ++k)
+                        {
+                            if ((*keptMaterials.at(k)) == (*pMaterial)) pKeptMaterial= keptMaterials.at(k);
+                        }
+
+                        if (nullptr == pKeptMaterial)
+                        {
+                            keptMaterials.append(pMaterial);
+                        }
+                        else if (pKeptMaterial != pMaterial)
+                        {
+                            // Only meshes can merge the primitives of two materials
+                            if (isMesh || !pGeom->containsMaterial(pKeptMaterial->id()))
+                            {
+                                // The replaced material is deleted when it is no longer used
+                                pGeom->replaceMaterial(pMaterial->id(), pKeptMaterial);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return materialCount - static_cast<int>(numberOfMaterials());
+}
+
 void GLC_World::setUnitFactor(double factor)
 {
     GLC_Matrix4x4 scaleMatrix;
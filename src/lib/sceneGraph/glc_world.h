@@ -200,6 +200,10 @@ public:
     GLC_StructOccurrence* occurrenceFromPath(GLC_OccurencePath path) const
     {return m_pWorldHandle->occurrenceFromPath(path);}
 
+    //! Return the occurence of the given path, resolving the nodes whose index doesn't match by reference name
+    GLC_StructOccurrence* occurrenceFromPathOrReferenceName(const GLC_OccurencePath& path) const
+    {return m_pWorldHandle->occurrenceFromPathOrReferenceName(path);}
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -276,6 +280,12 @@ public:
     void createSharpEdges(double precision, double angleThreshold);
 
     void setUnitFactor(double factor);
+
+    //! Replace equal materials of this world bodies by a single material
+    /*! Materials are compared with GLC_Material::operator==, primitive groups of a mesh
+     *  which end up sharing the same material are merged.
+     *  Return the number of removed materials*/
+    int mergeEqualMaterials();
 //@}
 
 //////////////////////////////////////////////////////////////////////
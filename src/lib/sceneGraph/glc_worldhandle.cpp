@@ -33,9 +33,11 @@ GLC_WorldHandle::GLC_WorldHandle()
     , m_pRoot(new GLC_StructOccurrence())
     , m_Ref(1)
     , m_OccurrenceHash()
+    , m_OccurrenceIndex()
     , m_UpVector(glc::Z_AXIS)
     , m_SelectionSet(this)
     , m_DestructorMode(false)
+    , m_Revision(0)
 {
     m_pRoot->setWorldHandle(this);
 }
@@ -45,9 +47,11 @@ GLC_WorldHandle::GLC_WorldHandle(GLC_StructOccurrence *pOcc)
     , m_pRoot(pOcc)
     , m_Ref(1)
     , m_OccurrenceHash()
+    , m_OccurrenceIndex()
     , m_UpVector(glc::Z_AXIS)
     , m_SelectionSet(this)
     , m_DestructorMode(false)
+    , m_Revision(0)
 {
     Q_ASSERT(pOcc->isOrphan());
     pOcc->setWorldHandle(this);
@@ -58,9 +62,11 @@ GLC_WorldHandle::GLC_WorldHandle(const GLC_3DViewCollection& collection)
     , m_pRoot(new GLC_StructOccurrence())
     , m_Ref(1)
     , m_OccurrenceHash()
+    , m_OccurrenceIndex()
     , m_UpVector(glc::Z_AXIS)
     , m_SelectionSet(this)
     , m_DestructorMode(false)
+    , m_Revision(0)
 {
     m_pRoot->setWorldHandle(this);
     const QList<GLC_3DViewInstance*> instances(const_cast<GLC_3DViewCollection&>(collection).instancesHandle());
@@ -133,11 +139,98 @@ int GLC_WorldHandle::representationCount() const
 
 }
 
-GLC_StructOccurrence *GLC_WorldHandle::occurrenceFromPath(GLC_OccurencePath path) const
+GLC_StructOccurrence *GLC_WorldHandle::occurrenceFromPath(const GLC_OccurencePath& path) const
 {
     return m_pRoot->occurrenceFromPath(path);
 }
 
+GLC_StructOccurrence *GLC_WorldHandle::occurrenceFromPathOrReferenceName(const GLC_OccurencePath& path) const
+{
+    Q_ASSERT(!path.isEmpty());
+    GLC_StructOccurrence* pSubject= m_pRoot;
+
+    const int count= path.count();
+    int i= 0;
+    while ((nullptr != pSubject) && (i < count))
+    {
+        const QPair<QString, uint>& node= path.at(i);
+        const int index= static_cast<int>(node.second);
+        GLC_StructOccurrence* pChild= nullptr;
+        if ((index < pSubject->childCount()) && (pSubject->child(index)->structReference()->name() == node.first))
+        {
+            pChild= pSubject->child(index);
+        }
+        else
+        {
+            // Children order has changed, use the index
+            const QList<GLC_uint> childrenId(m_OccurrenceIndex.childrenIdFromReferenceName(pSubject->id(), node.first));
+            if (childrenId.count() == 1)
+            {
+                pChild= m_OccurrenceHash.value(childrenId.constFirst(), nullptr);
+            }
+            else if (childrenId.isEmpty())
+            {
+                // Occurrence not indexed, search the children
+                pChild= childFromReferenceName(pSubject, node.first);
+            }
+        }
+        pSubject= pChild;
+        ++i;
+    }
+
+    return pSubject;
+}
+
+GLC_StructOccurrence* GLC_WorldHandle::childFromReferenceName(const GLC_StructOccurrence* pParent, const QString& referenceName)
+{
+    GLC_StructOccurrence* pSubject= nullptr;
+    const int childCount= pParent->childCount();
+    for (int i= 0; i < childCount; ++i)
+    {
+        GLC_StructOccurrence* pChild= pParent->child(i);
+        if (pChild->structReference()->name() == referenceName)
+        {
+            // The child must be the only one with this reference name
+            if (nullptr != pSubject) return nullptr;
+            pSubject= pChild;
+        }
+    }
+
+    return pSubject;
+}
+
+QList<GLC_StructOccurrence*> GLC_WorldHandle::occurrencesFromNamePath(const QStringList& namePath) const
+{
+    QList<GLC_uint> currentLevel;
+    currentLevel.append(m_pRoot->id());
+
+    const int count= namePath.count();
+    for (int i= 0; (i < count) && !currentLevel.isEmpty(); ++i)
+    {
+        QList<GLC_uint> nextLevel;
+        for (GLC_uint parentId : currentLevel)
+        {
+            nextLevel.append(m_OccurrenceIndex.childrenIdFromReferenceName(parentId, namePath.at(i)));
+        }
+        currentLevel= nextLevel;
+    }
+
+    return occurrencesFromId(currentLevel);
+}
+
+QList<GLC_StructOccurrence*> GLC_WorldHandle::occurrencesFromId(const QList<GLC_uint>& idList) const
+{
+    QList<GLC_StructOccurrence*> subject;
+    subject.reserve(idList.count());
+    for (GLC_uint occId : idList)
+    {
+        GLC_StructOccurrence* pOcc= m_OccurrenceHash.value(occId, nullptr);
+        if (nullptr != pOcc) subject.append(pOcc);
+    }
+
+    return subject;
+}
+
 void GLC_WorldHandle::replaceRootOccurrence(GLC_StructOccurrence *pOcc)
 {
     Q_ASSERT(pOcc->isOrphan());
@@ -162,6 +255,8 @@ void GLC_WorldHandle::addOccurrence(GLC_StructOccurrence* pOccurrence, bool isSe
 {
     Q_ASSERT(!m_OccurrenceHash.contains(pOccurrence->id()));
     m_OccurrenceHash.insert(pOccurrence->id(), pOccurrence);
+    m_OccurrenceIndex.insert(pOccurrence);
+    ++m_Revision;
     GLC_StructReference* pRef= pOccurrence->structReference();
 	Q_ASSERT(NULL != pRef);
 
@@ -181,6 +276,8 @@ void GLC_WorldHandle::removeOccurrence(GLC_StructOccurrence* pOccurrence)
     m_SelectionSet.remove(pOccurrence);
     // Remove the occurrence from the main occurrence hash table
     m_OccurrenceHash.remove(pOccurrence->id());
+    if (!m_DestructorMode) m_OccurrenceIndex.remove(pOccurrence->id());
+    ++m_Revision;
 	// Remove instance representation from the collection
     m_Collection.remove(pOccurrence->id());
 
@@ -191,6 +288,12 @@ void GLC_WorldHandle::removeOccurrence(GLC_StructOccurrence* pOccurrence)
     }
 }
 
+void GLC_WorldHandle::updateOccurrenceIndex(GLC_StructOccurrence* pOccurrence)
+{
+    Q_ASSERT(m_OccurrenceHash.contains(pOccurrence->id()));
+    m_OccurrenceIndex.insert(pOccurrence);
+}
+
 void GLC_WorldHandle::select(GLC_uint occurrenceId)
 {
     Q_ASSERT(m_OccurrenceHash.contains(occurrenceId));
@@ -29,6 +29,7 @@
 #include "glc_3dviewcollection.h"
 #include "glc_structoccurrence.h"
 #include "glc_selectionset.h"
+#include "glc_occurrenceindex.h"
 
 #include "../glc_config.h"
 
@@ -99,6 +100,11 @@ public:
     int numberOfOccurrence() const
     {return m_OccurrenceHash.size();}
 
+    //! Return the revision of this world
+    /*! The revision changes when occurrences are added, removed, moved or their visibility changes*/
+    quint64 revision() const
+    {return m_Revision;}
+
 	//! Return the list of instance
 	QList<GLC_StructInstance*> instances() const;
 
@@ -123,8 +129,38 @@ public:
     GLC_SelectionSet selectionSet()
     {return m_SelectionSet;}
 
-    //! Return the occurence of the given path
-    GLC_StructOccurrence* occurrenceFromPath(GLC_OccurencePath path) const;
+    //! Return the occurence of the given path, nullptr if not found
+    /*! The child at each path index must have the reference name of the path*/
+    GLC_StructOccurrence* occurrenceFromPath(const GLC_OccurencePath& path) const;
+
+    //! Return the occurence of the given path, resolving the nodes whose index doesn't match by reference name
+    /*! Path names are reference names. If the child at the path index doesn't have the reference
+     *  name of the path, the only child with this reference name is used. If several children have
+     *  this reference name, the path is not found and nullptr is returned.
+     *  Use this function for paths stored before the children order of the structure changed*/
+    GLC_StructOccurrence* occurrenceFromPathOrReferenceName(const GLC_OccurencePath& path) const;
+
+    //! Return the occurrences matching the given path of reference names from root excluded
+    QList<GLC_StructOccurrence*> occurrencesFromNamePath(const QStringList& namePath) const;
+
+    //! Return the occurrence lookup index of this world
+    const GLC_OccurrenceIndex* occurrenceIndex() const
+    {return &m_OccurrenceIndex;}
+
+    //! Return the occurrences with the given name
+    QList<GLC_StructOccurrence*> occurrencesFromName(const QString& name, Qt::CaseSensitivity cs= Qt::CaseSensitive) const
+    {return occurrencesFromId(m_OccurrenceIndex.occurrencesIdFromName(name, cs));}
+
+    //! Return the occurrences which name starts with the given prefix (case insensitive)
+    QList<GLC_StructOccurrence*> occurrencesFromNamePrefix(const QString& prefix, int maxCount= -1) const
+    {return occurrencesFromId(m_OccurrenceIndex.occurrencesIdFromNamePrefix(prefix, maxCount));}
+
+    //! Return the occurrences which have the given attribute with the given value
+    QList<GLC_StructOccurrence*> occurrencesFromAttribute(const QString& attributeName, const QString& value) const
+    {return occurrencesFromId(m_OccurrenceIndex.occurrencesIdFromAttribute(attributeName, value));}
+
+    //! Return the occurrences of the given list of id
+    QList<GLC_StructOccurrence*> occurrencesFromId(const QList<GLC_uint>& idList) const;
 
 //@}
 
@@ -155,7 +191,18 @@ public:
 
     //! All Occurrence has been removed
     void removeAllOccurrences()
-    {m_OccurrenceHash.clear();}
+    {
+        m_OccurrenceHash.clear();
+        m_OccurrenceIndex.clear();
+    }
+
+    //! Increment the revision of this world
+    void incrementRevision()
+    {++m_Revision;}
+
+    //! Update the lookup index of the given occurrence
+    /*! Must be called when the name, the parent or the attributes of an occurrence change*/
+    void updateOccurrenceIndex(GLC_StructOccurrence* pOccurrence);
 
 	//! Set the world Up Vector
     void setUpVector(const GLC_Vector3d& vect)
@@ -197,6 +244,9 @@ public:
 private:
     void updateSelectedInstanceFromSelectionSet();
 
+    //! Return the only child of the given occurrence with the given reference name, nullptr if there is none or several
+    static GLC_StructOccurrence* childFromReferenceName(const GLC_StructOccurrence* pParent, const QString& referenceName);
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -215,6 +265,9 @@ private:
     //! The hash table containing struct occurrence
     QHash<GLC_uint, GLC_StructOccurrence*> m_OccurrenceHash;
 
+    //! The occurrence lookup index
+    GLC_OccurrenceIndex m_OccurrenceIndex;
+
 	//! This world Up Vector
 	GLC_Vector3d m_UpVector;
 
@@ -223,6 +276,9 @@ private:
 
     bool m_DestructorMode;
 
+    //! The revision of this world
+    quint64 m_Revision;
+
 private:
     Q_DISABLE_COPY(GLC_WorldHandle)
 };
@@ -25,14 +25,22 @@
 #include "glc_material.h"
 #include "../geometry/glc_geometry.h"
 #include "../glc_factory.h"
-#include "../glc_openglexception.h"
 #include "../maths/glc_geomtools.h"
+#include "../glc_renderprofiler.h"
+#include "../glc_renderstatecache.h"
 
 #include <QtDebug>
+#include <QAtomicInteger>
 
 // Class chunk id
 quint32 GLC_Material::m_ChunkId= 0xA703;
 
+// State revisions are shared by all materials, they can be created by concurrent loaders
+static QAtomicInteger<GLC_uint> glcMaterialStateRevision(0);
+
+// Value of the opacity key of a material executed without overwritten opacity
+static const GLfloat glcNoOverwrittenOpacity= -1.0f;
+
 //////////////////////////////////////////////////////////////////////
 // Constructor Destructor
 //////////////////////////////////////////////////////////////////////
@@ -46,9 +54,12 @@ GLC_Material::GLC_Material()
 , m_Shininess(50.0)		// By default shininess 50
 , m_WhereUsed()
 , m_OtherUsage()
+, m_WhereUsedMutex()
 , m_pTexture(nullptr)			// no texture
 , m_Opacity(1.0)
+, m_StateRevision(0)
 {
+	updateStateRevision();
 	//qDebug() << "GLC_Material::GLC_Material" << id();
 	// Diffuse Color
 	initDiffuseColor();
@@ -66,9 +77,12 @@ GLC_Material::GLC_Material(const QColor &diffuseColor)
 , m_Shininess(50.0)		// By default shininess 50
 , m_WhereUsed()
 , m_OtherUsage()
+, m_WhereUsedMutex()
 , m_pTexture(nullptr)			// no texture
 , m_Opacity(1.0)
+, m_StateRevision(0)
 {
+	updateStateRevision();
 	// Others
 	initOtherColor();
 }
@@ -83,9 +97,12 @@ GLC_Material::GLC_Material(const QString& name ,const GLfloat *pDiffuseColor)
 , m_Shininess(50.0)		// By default shininess 50
 , m_WhereUsed()
 , m_OtherUsage()
+, m_WhereUsedMutex()
 , m_pTexture(nullptr)			// no texture
 , m_Opacity(1.0)
+, m_StateRevision(0)
 {
+	updateStateRevision();
 	//qDebug() << "GLC_Material::GLC_Material" << id();
 	// Init Diffuse Color
     if (pDiffuseColor != nullptr)
@@ -111,9 +128,12 @@ GLC_Material::GLC_Material(GLC_Texture* pTexture, const QString& name)
 , m_Shininess(50.0)		// By default shininess 50
 , m_WhereUsed()
 , m_OtherUsage()
+, m_WhereUsedMutex()
 , m_pTexture(pTexture)			// init texture
 , m_Opacity(1.0)
+, m_StateRevision(0)
 {
+	updateStateRevision();
 	Q_ASSERT(NULL != m_pTexture);
 	//qDebug() << "GLC_Material::GLC_Material" << id();
 
@@ -136,9 +156,12 @@ GLC_Material::GLC_Material(const GLC_Material &InitMaterial)
 , m_Shininess(InitMaterial.m_Shininess)
 , m_WhereUsed()
 , m_OtherUsage()
+, m_WhereUsedMutex()
 , m_pTexture(nullptr)
 , m_Opacity(InitMaterial.m_Opacity)
+, m_StateRevision(0)
 {
+	updateStateRevision();
     if (nullptr != InitMaterial.m_pTexture)
 	{
 		m_pTexture= new GLC_Texture(*(InitMaterial.m_pTexture));
@@ -298,6 +321,7 @@ uint GLC_Material::hashCode() const
  	m_Shininess= pMat->m_Shininess;
  	// Transparency
  	m_Opacity= pMat->m_Opacity;
+	updateStateRevision();
 	// Update geometry which use this material
 	WhereUsed::const_iterator iGeom= m_WhereUsed.constBegin();
 	while (iGeom != m_WhereUsed.constEnd())
@@ -313,6 +337,7 @@ void GLC_Material::setAmbientColor(const QColor& ambientColor)
 {
 	m_AmbientColor= ambientColor;
 	m_AmbientColor.setAlphaF(m_Opacity);
+	updateStateRevision();
 }
 
 // Set Diffuse color
@@ -320,6 +345,7 @@ void GLC_Material::setDiffuseColor(const QColor& diffuseColor)
 {
 	m_DiffuseColor= diffuseColor;
 	m_DiffuseColor.setAlphaF(m_Opacity);
+	updateStateRevision();
 }
 
 // Set Specular color
@@ -327,6 +353,7 @@ void GLC_Material::setSpecularColor(const QColor& specularColor)
 {
 	m_SpecularColor= specularColor;
 	m_SpecularColor.setAlphaF(m_Opacity);
+	updateStateRevision();
 }
 
 // Set Emissive
@@ -334,6 +361,7 @@ void GLC_Material::setEmissiveColor(const QColor& lightEmission)
 {
 	m_EmissiveColor= lightEmission;
 	m_EmissiveColor.setAlphaF(m_Opacity);
+	updateStateRevision();
 }
 
 // Set Texture
@@ -343,6 +371,7 @@ void GLC_Material::setTexture(GLC_Texture* pTexture)
 
     delete m_pTexture;
     m_pTexture= pTexture;
+    updateStateRevision();
 }
 
 // remove Material Texture
@@ -352,13 +381,14 @@ void GLC_Material::removeTexture()
 	{
 		delete m_pTexture;
         m_pTexture= nullptr;
+		updateStateRevision();
 	}
 }
 
 // Add Geometry to where used hash table
 bool GLC_Material::addGLC_Geom(GLC_Geometry* pGeom)
 {
-	QMutexLocker mutexLocker(&m_Mutex);
+	QMutexLocker mutexLocker(&m_WhereUsedMutex);
 	//qDebug() << "GLC_Material::addGLC_Geom" << pGeom->id();
 	WhereUsed::iterator iGeom= m_WhereUsed.find(pGeom->id());
 
@@ -378,7 +408,7 @@ bool GLC_Material::addGLC_Geom(GLC_Geometry* pGeom)
 // Remove a geometry from the collection
 bool GLC_Material::delGLC_Geom(GLC_uint Key)
 {
-	QMutexLocker mutexLocker(&m_Mutex);
+	QMutexLocker mutexLocker(&m_WhereUsedMutex);
 
 	if (m_WhereUsed.contains(Key))
 	{	// Ok, ID exist
@@ -393,10 +423,24 @@ bool GLC_Material::delGLC_Geom(GLC_uint Key)
 	}
 
 }
+
+// Remove a geometry from the collection and return true if the material is unused
+bool GLC_Material::releaseGLC_Geom(GLC_uint Key)
+{
+	QMutexLocker mutexLocker(&m_WhereUsedMutex);
+
+	if (m_WhereUsed.remove(Key) == 0)
+	{
+		qDebug("GLC_Material::releaseGLC_Geom : Geometry not remove");
+	}
+
+	return m_WhereUsed.isEmpty() && m_OtherUsage.isEmpty();
+}
+
 // Add the id to the other used Set
 bool GLC_Material::addUsage(GLC_uint id)
 {
-	QMutexLocker mutexLocker(&m_Mutex);
+	QMutexLocker mutexLocker(&m_WhereUsedMutex);
 	if (!m_OtherUsage.contains(id))
 	{
 		m_OtherUsage << id;
@@ -412,7 +456,7 @@ bool GLC_Material::addUsage(GLC_uint id)
 // Remove the id to the other used Set
 bool GLC_Material::delUsage(GLC_uint id)
 {
-	QMutexLocker mutexLocker(&m_Mutex);
+	QMutexLocker mutexLocker(&m_WhereUsedMutex);
 	if (m_OtherUsage.contains(id))
 	{
 		m_OtherUsage.remove(id);
@@ -425,6 +469,18 @@ bool GLC_Material::delUsage(GLC_uint id)
 	}
 }
 
+// Remove the id to the other used Set and return true if the material is unused
+bool GLC_Material::releaseUsage(GLC_uint id)
+{
+	QMutexLocker mutexLocker(&m_WhereUsedMutex);
+	if (!m_OtherUsage.remove(id))
+	{
+		qDebug() << "GLC_Material::releaseUsage : id not removed " << m_Uid;
+	}
+
+	return m_WhereUsed.isEmpty() && m_OtherUsage.isEmpty();
+}
+
 
 // Set the material opacity
 void GLC_Material::setOpacity(const qreal alpha)
@@ -434,6 +490,7 @@ void GLC_Material::setOpacity(const qreal alpha)
 	m_DiffuseColor.setAlphaF(m_Opacity);
 	m_SpecularColor.setAlphaF(m_Opacity);
 	m_EmissiveColor.setAlphaF(m_Opacity);
+	updateStateRevision();
 	// Update geometry which use this material
 	WhereUsed::const_iterator iGeom= m_WhereUsed.constBegin();
 	while (iGeom != m_WhereUsed.constEnd())
@@ -463,6 +520,17 @@ void GLC_Material::glLoadTexture()
 // Execute OpenGL Material
 void GLC_Material::glExecute()
 {
+    GLC_RenderProfiler::ScopedTimer profilerTimer(GLC_RenderProfiler::MaterialStage);
+
+    GLC_RenderStateCache* pStateCache= GLC_RenderStateCache::current();
+    const bool useShader= GLC_State::glslUsed() && GLC_Shader::hasActiveShader();
+    QOpenGLShaderProgram* pProgram= useShader ? GLC_Shader::currentShaderHandle()->programShaderHandle() : nullptr;
+    const GLuint programId= useShader ? pProgram->programId() : 0;
+
+    // Nothing to do if this material is already the current one
+    if (pStateCache->materialIsCurrent(m_StateRevision, textureID(), programId, glcNoOverwrittenOpacity)) return;
+
+    GLC_RenderProfiler::addCount(GLC_RenderProfiler::MaterialChangeCounter);
 
     GLfloat pAmbientColor[4]= {(GLfloat)ambientColor().redF(),
                                 (GLfloat)ambientColor().greenF(),
@@ -484,35 +552,28 @@ void GLC_Material::glExecute()
                                 (GLfloat)emissiveColor().blueF(),
                                 (GLfloat)emissiveColor().alphaF()};
 
-	const bool textureIsEnable= glIsEnabled(GL_TEXTURE_2D);
     if (m_pTexture != nullptr)
 	{
-		if (!textureIsEnable) glEnable(GL_TEXTURE_2D);
-		m_pTexture->glcBindTexture();
-		if (GLC_State::glslUsed())
+		pStateCache->glcEnable(GL_TEXTURE_2D);
+		pStateCache->glcBindTexture(m_pTexture);
+		if (useShader)
 		{
-			if (GLC_Shader::hasActiveShader())
-			{
-				GLC_Shader::currentShaderHandle()->programShaderHandle()->setUniformValue("tex", GLint(0));
-				GLC_Shader::currentShaderHandle()->programShaderHandle()->setUniformValue("useTexture", true);
-			}
+			pStateCache->glcSetUniformValue(pProgram, "tex", 0);
+			pStateCache->glcSetUniformValue(pProgram, "useTexture", 1);
 		}
-
 	}
 	else
 	{
-
-		if (GLC_State::glslUsed() && GLC_Shader::hasActiveShader())
+		if (useShader)
 		{
-				if (!textureIsEnable) glEnable(GL_TEXTURE_2D);
-				GLC_Shader::currentShaderHandle()->programShaderHandle()->setUniformValue("tex", GLint(0));
-				GLC_Shader::currentShaderHandle()->programShaderHandle()->setUniformValue("useTexture", false);
+			pStateCache->glcEnable(GL_TEXTURE_2D);
+			pStateCache->glcSetUniformValue(pProgram, "tex", 0);
+			pStateCache->glcSetUniformValue(pProgram, "useTexture", 0);
 		}
 		else
 		{
-			if (textureIsEnable) glDisable(GL_TEXTURE_2D);
+			pStateCache->glcDisable(GL_TEXTURE_2D);
 		}
-
 	}
 
 	glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, pAmbientColor);
@@ -523,20 +584,27 @@ void GLC_Material::glExecute()
 
 	glColor4fv(pDiffuseColor);
 
+	pStateCache->setCurrentMaterial(m_StateRevision, textureID(), programId, glcNoOverwrittenOpacity);
 
 	// OpenGL Error handler
-	GLenum error= glGetError();
-	if (error != GL_NO_ERROR)
-	{
-		GLC_OpenGlException OpenGlException("GLC_Material::glExecute() ", error);
-		throw(OpenGlException);
-	}
-
+	GLC_RenderStateCache::glcCheckError("GLC_Material::glExecute() ");
 }
 
 // Execute OpenGL Material
 void GLC_Material::glExecute(float overwriteTransparency)
 {
+    GLC_RenderProfiler::ScopedTimer profilerTimer(GLC_RenderProfiler::MaterialStage);
+
+    GLC_RenderStateCache* pStateCache= GLC_RenderStateCache::current();
+    const bool useShader= GLC_State::glslUsed() && GLC_Shader::hasActiveShader();
+    QOpenGLShaderProgram* pProgram= useShader ? GLC_Shader::currentShaderHandle()->programShaderHandle() : nullptr;
+    const GLuint programId= useShader ? pProgram->programId() : 0;
+
+    // Nothing to do if this material is already the current one
+    if (pStateCache->materialIsCurrent(m_StateRevision, textureID(), programId, overwriteTransparency)) return;
+
+    GLC_RenderProfiler::addCount(GLC_RenderProfiler::MaterialChangeCounter);
+
     GLfloat pAmbientColor[4]= {(GLfloat)ambientColor().redF(),
                                 (GLfloat)ambientColor().greenF(),
                                 (GLfloat)ambientColor().blueF(),
@@ -557,31 +625,23 @@ void GLC_Material::glExecute(float overwriteTransparency)
                                 (GLfloat)emissiveColor().blueF(),
 								overwriteTransparency};
 
-	const bool textureIsEnable= glIsEnabled(GL_TEXTURE_2D);
-
     if (m_pTexture != nullptr)
 	{
-		if (!textureIsEnable) glEnable(GL_TEXTURE_2D);
-		m_pTexture->glcBindTexture();
-		if (GLC_State::glslUsed())
+		pStateCache->glcEnable(GL_TEXTURE_2D);
+		pStateCache->glcBindTexture(m_pTexture);
+		if (useShader)
 		{
-			if (GLC_Shader::hasActiveShader())
-			{
-				GLC_Shader::currentShaderHandle()->programShaderHandle()->setUniformValue("tex", GLint(0));
-				GLC_Shader::currentShaderHandle()->programShaderHandle()->setUniformValue("useTexture", true);
-			}
+			pStateCache->glcSetUniformValue(pProgram, "tex", 0);
+			pStateCache->glcSetUniformValue(pProgram, "useTexture", 1);
 		}
 	}
 	else
 	{
-		if (textureIsEnable) glDisable(GL_TEXTURE_2D);
-		if (GLC_State::glslUsed())
+		pStateCache->glcDisable(GL_TEXTURE_2D);
+		if (useShader)
 		{
-			if (GLC_Shader::hasActiveShader())
-			{
-				GLC_Shader::currentShaderHandle()->programShaderHandle()->setUniformValue("tex", GLint(0));
-				GLC_Shader::currentShaderHandle()->programShaderHandle()->setUniformValue("useTexture", false);
-			}
+			pStateCache->glcSetUniformValue(pProgram, "tex", 0);
+			pStateCache->glcSetUniformValue(pProgram, "useTexture", 0);
 		}
 	}
 
@@ -593,13 +653,10 @@ void GLC_Material::glExecute(float overwriteTransparency)
 
 	glColor4fv(pDiffuseColor);
 
+	pStateCache->setCurrentMaterial(m_StateRevision, textureID(), programId, overwriteTransparency);
+
 	// OpenGL Error handler
-	GLenum error= glGetError();
-	if (error != GL_NO_ERROR)
-	{
-		GLC_OpenGlException OpenGlException("GLC_Material::glExecute(float overwriteTransparency) ", error);
-		throw(OpenGlException);
-	}
+	GLC_RenderStateCache::glcCheckError("GLC_Material::glExecute(float overwriteTransparency) ");
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -625,6 +682,12 @@ void GLC_Material::initOtherColor(void)
 	m_EmissiveColor.setRgbF(0.0, 0.0, 0.0, 1.0);
 }
 
+// Give a new state revision to this material
+void GLC_Material::updateStateRevision()
+{
+	m_StateRevision= glcMaterialStateRevision.fetchAndAddRelaxed(1) + 1;
+}
+
 // Non Member methods
 // Non-member stream operator
 QDataStream &operator<<(QDataStream &stream, const GLC_Material &material)
@@ -31,6 +31,7 @@
 #include <QHash>
 #include <QColor>
 #include <QSet>
+#include <QMutex>
 
 #include "../glc_config.h"
 
@@ -142,6 +143,12 @@ public:
 	//! Return the material hash code
 	uint hashCode() const;
 
+	//! Return the state revision of this material
+	/*! The revision is unique across materials and changes each time
+	 *  a rendering property of this material is modified*/
+	inline GLC_uint stateRevision() const
+	{return m_StateRevision;}
+
 //@}
 
 //////////////////////////////////////////////////////////////////////
@@ -179,7 +186,7 @@ public:
 
 	//! Set Shininess
 	inline void setShininess(GLfloat Shininess)
-	{ m_Shininess= Shininess;}
+	{ m_Shininess= Shininess; updateStateRevision();}
 
 	//! Set Texture
 	void setTexture(GLC_Texture* pTexture);
@@ -195,6 +202,11 @@ public:
 	/*! This method is thread safe*/
 	bool delGLC_Geom(GLC_uint Key);
 
+	//! Remove Geometry from the "where used" hash table and return true if the material is now unused
+	/*! This method is thread safe : the removal and the usage test are done under the same lock,
+	 *  so only one of the geometries sharing this material can see it become unused*/
+	bool releaseGLC_Geom(GLC_uint Key);
+
 	//! Add the id to the other used Set
 	/*! This method is thread safe*/
 	bool addUsage(GLC_uint);
@@ -203,6 +215,10 @@ public:
 	/*! This method is thread safe*/
 	bool delUsage(GLC_uint);
 
+	//! Remove the id to the other used Set and return true if the material is now unused
+	/*! This method is thread safe, see releaseGLC_Geom()*/
+	bool releaseUsage(GLC_uint);
+
 	//! Set the material opacity
 	void setOpacity(const qreal);
 
@@ -235,6 +251,9 @@ private:
 	//! Init other color
 	void initOtherColor(void);
 
+	//! Give a new state revision to this material
+	void updateStateRevision();
+
 
 //////////////////////////////////////////////////////////////////////
 // Private Member
@@ -261,12 +280,18 @@ private:
 	//! Set of id of other objects that uses this material
 	QSet<GLC_uint> m_OtherUsage;
 
+	//! Where used and other usage mutex (Material can be shared by geometries of loader threads)
+	QMutex m_WhereUsedMutex;
+
 	//! Material's texture
 	GLC_Texture* m_pTexture;
 
 	//! Material opacity
 	qreal m_Opacity;
 
+	//! State revision used by the render state cache
+	GLC_uint m_StateRevision;
+
 	//! Class chunk id
 	static quint32 m_ChunkId;
 
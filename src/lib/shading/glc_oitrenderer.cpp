@@ -0,0 +1,227 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_oitrenderer.cpp implementation of the GLC_OitRenderer class.
+
+#include <QFile>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLShaderProgram>
+
+#include "glc_oitrenderer.h"
+#include "glc_shader.h"
+#include "../glc_exception.h"
+#include "../glc_state.h"
+#include "../glc_context.h"
+#include "../glc_contextmanager.h"
+
+#ifndef GL_DRAW_FRAMEBUFFER_BINDING
+#define GL_DRAW_FRAMEBUFFER_BINDING 0x8CA6
+#endif
+
+GLC_OitRenderer::GLC_OitRenderer()
+    : m_pAccumulationShader(nullptr)
+    , m_pCompositeProgram(nullptr)
+    , m_pFrameBuffer(nullptr)
+    , m_TargetFrameBufferId(0)
+    , m_Viewport()
+    , m_IsInitialized(false)
+    , m_InitializationFailed(false)
+    , m_IsAccumulating(false)
+{
+
+}
+
+GLC_OitRenderer::~GLC_OitRenderer()
+{
+    if (nullptr != m_pAccumulationShader)
+    {
+        m_pAccumulationShader->deleteShader();
+        delete m_pAccumulationShader;
+    }
+    delete m_pCompositeProgram;
+    delete m_pFrameBuffer;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_OitRenderer::isSupported()
+{
+#if defined(GLC_OPENGL_ES_2)
+    return false;
+#else
+    bool subject= GLC_State::glslUsed() && GLC_State::frameBufferBlitSupported() && !GLC_State::isInSelectionMode();
+    if (subject)
+    {
+        QOpenGLContext* pContext= QOpenGLContext::currentContext();
+        subject= (nullptr != pContext) && (pContext->format().majorVersion() >= 3);
+    }
+
+    return subject;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////
+// OpenGL Functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_OitRenderer::glBeginAccumulation()
+{
+    Q_ASSERT(!m_IsAccumulating);
+    if (!isSupported() || !glInitialize()) return false;
+
+    QOpenGLExtraFunctions* pFunctions= QOpenGLContext::currentContext()->extraFunctions();
+
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_TargetFrameBufferId);
+    glGetIntegerv(GL_VIEWPORT, m_Viewport);
+    const QSize size(m_Viewport[2], m_Viewport[3]);
+    if (size.isEmpty()) return false;
+
+    glUpdateFrameBuffer(size);
+
+    // Copy the depth of opaque primitives
+    pFunctions->glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(m_TargetFrameBufferId));
+    pFunctions->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_pFrameBuffer->handle());
+    pFunctions->glBlitFramebuffer(m_Viewport[0], m_Viewport[1], m_Viewport[0] + m_Viewport[2], m_Viewport[1] + m_Viewport[3]
+                                  , 0, 0, size.width(), size.height(), GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    pFunctions->glBindFramebuffer(GL_FRAMEBUFFER, m_pFrameBuffer->handle());
+    glViewport(0, 0, size.width(), size.height());
+
+    const GLenum drawBuffers[2]= {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    pFunctions->glDrawBuffers(2, drawBuffers);
+
+    // The alpha of the first target is the revealage
+    const GLfloat accumulationClear[4]= {0.0f, 0.0f, 0.0f, 1.0f};
+    const GLfloat weightClear[4]= {0.0f, 0.0f, 0.0f, 0.0f};
+    pFunctions->glClearBufferfv(GL_COLOR, 0, accumulationClear);
+    pFunctions->glClearBufferfv(GL_COLOR, 1, weightClear);
+
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    pFunctions->glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+
+    m_pAccumulationShader->use();
+    m_IsAccumulating= true;
+
+    return true;
+}
+
+void GLC_OitRenderer::glEndAccumulation()
+{
+    if (!m_IsAccumulating) return;
+    m_IsAccumulating= false;
+
+    GLC_Shader::unuse();
+
+    QOpenGLExtraFunctions* pFunctions= QOpenGLContext::currentContext()->extraFunctions();
+    pFunctions->glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(m_TargetFrameBufferId));
+    glViewport(m_Viewport[0], m_Viewport[1], m_Viewport[2], m_Viewport[3]);
+
+    const QVector<GLuint> textures(m_pFrameBuffer->textures());
+    pFunctions->glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, textures.at(1));
+    pFunctions->glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, textures.at(0));
+
+    glDisable(GL_DEPTH_TEST);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Full screen quad
+    const GLfloat quad[8]= {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+    pFunctions->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_pCompositeProgram->bind();
+    m_pCompositeProgram->setUniformValue("accumulation_tex", 0);
+    m_pCompositeProgram->setUniformValue("weight_tex", 1);
+    m_pCompositeProgram->enableAttributeArray("a_position");
+    m_pCompositeProgram->setAttributeArray("a_position", quad, 2);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    m_pCompositeProgram->disableAttributeArray("a_position");
+    m_pCompositeProgram->release();
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glEnable(GL_DEPTH_TEST);
+
+    // Textures, blending and program have been changed behind the cache
+    GLC_Context* pContext= GLC_ContextManager::instance()->currentContext();
+    if (nullptr != pContext) pContext->renderStateCache()->invalidate();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+bool GLC_OitRenderer::glInitialize()
+{
+    if (!m_IsInitialized && !m_InitializationFailed)
+    {
+        QFile vertexShader(":/GLC_lib_Shaders/oit_accumulation_vert");
+        QFile fragmentShader(":/GLC_lib_Shaders/oit_accumulation_frag");
+        Q_ASSERT(vertexShader.exists() && fragmentShader.exists());
+
+        try
+        {
+            m_pAccumulationShader= new GLC_Shader(vertexShader, fragmentShader);
+            m_pAccumulationShader->setName("OIT Accumulation");
+            m_pAccumulationShader->createAndCompileProgrammShader();
+        }
+        catch (GLC_Exception& e)
+        {
+            qWarning() << "GLC_OitRenderer::glInitialize " << e.what();
+            if (nullptr != m_pAccumulationShader)
+            {
+                m_pAccumulationShader->deleteShader();
+                delete m_pAccumulationShader;
+                m_pAccumulationShader= nullptr;
+            }
+            m_InitializationFailed= true;
+            return false;
+        }
+
+        m_pCompositeProgram= new QOpenGLShaderProgram;
+        const bool compositeIsLinked= m_pCompositeProgram->addShaderFromSourceFile(QOpenGLShader::Vertex, ":/GLC_lib_Shaders/oit_composite_vert")
+                && m_pCompositeProgram->addShaderFromSourceFile(QOpenGLShader::Fragment, ":/GLC_lib_Shaders/oit_composite_frag")
+                && m_pCompositeProgram->link();
+        if (!compositeIsLinked)
+        {
+            qWarning() << "GLC_OitRenderer::glInitialize " << m_pCompositeProgram->log();
+            m_InitializationFailed= true;
+        }
+
+        m_IsInitialized= !m_InitializationFailed;
+    }
+
+    return m_IsInitialized;
+}
+
+void GLC_OitRenderer::glUpdateFrameBuffer(const QSize& size)
+{
+    if ((nullptr == m_pFrameBuffer) || (m_pFrameBuffer->size() != size))
+    {
+        delete m_pFrameBuffer;
+
+        // The depth format must match the default frame buffer one to be blitted
+        m_pFrameBuffer= new QOpenGLFramebufferObject(size, QOpenGLFramebufferObject::CombinedDepthStencil, GL_TEXTURE_2D, GL_RGBA16F);
+        m_pFrameBuffer->addColorAttachment(size, GL_R16F);
+    }
+}
@@ -0,0 +1,133 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+//! \file glc_oitrenderer.h interface for the GLC_OitRenderer class.
+
+#ifndef GLC_OITRENDERER_H_
+#define GLC_OITRENDERER_H_
+
+#include <QSize>
+#include <QtOpenGL>
+
+#include "../glc_config.h"
+
+class GLC_Shader;
+class QOpenGLFramebufferObject;
+class QOpenGLShaderProgram;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_OitRenderer
+/*! \brief GLC_OitRenderer : Weighted blended order independent transparency*/
+
+/*! Transparent primitives are rendered between glBeginAccumulation() and
+ *  glEndAccumulation() in an offscreen frame buffer with two floating point targets :
+ *  - The sum of the weighted premultiplied colors and the product of (1 - alpha)
+ *  - The sum of the weights
+ *
+ *  The depth of the opaque primitives is copied from the current frame buffer,
+ *  then glEndAccumulation() composites the resolved transparent color over it.
+ *  The result doesn't depend on the rendering order, no sort is needed.
+ *
+ *  The accumulation uses the fixed pipeline state (lights, material, texture 0)
+ *  through a compatibility profile shader. Frame buffer blit and float render targets
+ *  are required, see isSupported(), there is one renderer by GLC_Context.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_OitRenderer
+{
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    GLC_OitRenderer();
+
+    //! The OpenGL context of the renderer must be current
+    ~GLC_OitRenderer();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return true if weighted blended transparency can be used with the current context
+    static bool isSupported();
+
+    //! Return true if the accumulation has begun
+    inline bool isAccumulating() const
+    {return m_IsAccumulating;}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name OpenGL Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Bind the accumulation frame buffer and shader
+    /*! Return false if the renderer cannot be used, nothing is bound in this case*/
+    bool glBeginAccumulation();
+
+    //! Release the accumulation shader and composite the transparent color in the previous frame buffer
+    void glEndAccumulation();
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Create the shaders, return false on failure
+    bool glInitialize();
+
+    //! Create the frame buffer if its size is not the given size
+    void glUpdateFrameBuffer(const QSize& size);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The accumulation shader
+    GLC_Shader* m_pAccumulationShader;
+
+    //! The composite shader
+    QOpenGLShaderProgram* m_pCompositeProgram;
+
+    //! The accumulation frame buffer
+    QOpenGLFramebufferObject* m_pFrameBuffer;
+
+    //! The frame buffer and viewport to composite into
+    GLint m_TargetFrameBufferId;
+    GLint m_Viewport[4];
+
+    //! True if the shaders are created
+    bool m_IsInitialized;
+
+    //! True if the creation of the shaders has failed
+    bool m_InitializationFailed;
+
+    //! True between glBeginAccumulation() and glEndAccumulation()
+    bool m_IsAccumulating;
+
+    Q_DISABLE_COPY(GLC_OitRenderer)
+};
+
+#endif /* GLC_OITRENDERER_H_ */
@@ -26,6 +26,7 @@
 
 #include "glc_selectionmaterial.h"
 #include "glc_material.h"
+#include "../glc_renderstatecache.h"
 
 
 QHash<QOpenGLContext*, GLC_Shader*> GLC_SelectionMaterial::m_SelectionShaderHash;
@@ -124,6 +125,8 @@ void GLC_SelectionMaterial::glExecute()
 		glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, pSpecularColor);
 		glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, pLightEmission);
 		glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, &shininess);
+
+		GLC_RenderStateCache::current()->invalidateMaterial();
 	}
 }
 
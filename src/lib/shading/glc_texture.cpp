@@ -26,11 +26,8 @@
 #include "glc_texture.h"
 #include "../glc_global.h"
 
-// Quazip library
-#include "../quazip/quazip.h"
-#include "../quazip/quazipfile.h"
-
 #include <QtDebug>
+#include <QFileInfo>
 
 // The default maximum texture size
 QSize GLC_Texture::m_MaxTextureSize(676, 676);
@@ -46,11 +43,10 @@ QHash<GLuint, int> GLC_Texture::m_TextureIdUsage;
 
 //! Default constructor
 GLC_Texture::GLC_Texture()
-    : m_pQOpenGLTexture(nullptr)
-    , m_FileName()
+    : m_FileName()
     , m_TextureImage()
-    , m_TextureSize()
-    , m_HasAlphaChannel(false)
+    , m_ImageDataFuture()
+    , m_pImageData(new GLC_TextureManager::ImageData())
     , m_Matrix()
     , m_BypassMaxSize(false)
 {
@@ -59,95 +55,63 @@ GLC_Texture::GLC_Texture()
 
 // Constructor with fileName
 GLC_Texture::GLC_Texture(const QString &Filename)
-    : m_pQOpenGLTexture(nullptr)
-    , m_FileName(Filename)
-    , m_TextureImage(loadFromFile(m_FileName))
-    , m_TextureSize()
-    , m_HasAlphaChannel(m_TextureImage.hasAlphaChannel())
+    : m_FileName(Filename)
+    , m_TextureImage()
+    , m_ImageDataFuture()
+    , m_pImageData()
     , m_Matrix()
     , m_BypassMaxSize(false)
 {
-//    if (m_TextureImage.isNull())
-//	{
-//		QString ErrorMess("GLC_Texture::GLC_Texture open image : ");
-//		ErrorMess.append(m_FileName).append(" Failed");
-//		qDebug() << ErrorMess;
-//		GLC_Exception e(ErrorMess);
-//		throw(e);
-//	}
-//    else
-//    {
-        m_TextureSize= m_TextureImage.size();
-//    }
+    requestImageData();
 }
+
 // Constructor with QFile
 GLC_Texture::GLC_Texture(const QFile &file)
-    : m_pQOpenGLTexture(nullptr)
-    , m_FileName(file.fileName())
+    : m_FileName(file.fileName())
     , m_TextureImage()
-    , m_TextureSize()
-    , m_HasAlphaChannel(m_TextureImage.hasAlphaChannel())
+    , m_ImageDataFuture()
+    , m_pImageData()
     , m_Matrix()
-    , m_BypassMaxSize()
+    , m_BypassMaxSize(false)
 {
+    // The image is read from the given device, which may not be reachable by its file name
     m_TextureImage.load(const_cast<QFile*>(&file), QFileInfo(m_FileName).suffix().toLocal8Bit());
-//    if (m_TextureImage.isNull())
-//	{
-//		QString ErrorMess("GLC_Texture::GLC_Texture open image : ");
-//		ErrorMess.append(m_FileName).append(" Failed");
-//		qDebug() << ErrorMess;
-//		GLC_Exception e(ErrorMess);
-//		throw(e);
-//	}
-//    else
-//    {
-        m_TextureSize= m_TextureImage.size();
-//    }
+    requestImageData();
 }
 
 // Constructor with QImage
 GLC_Texture::GLC_Texture(const QImage& image, const QString& fileName)
-    : m_pQOpenGLTexture(nullptr)
-    , m_FileName(fileName)
+    : m_FileName(fileName)
     , m_TextureImage(image)
-    , m_TextureSize(m_TextureImage.size())
-    , m_HasAlphaChannel(m_TextureImage.hasAlphaChannel())
+    , m_ImageDataFuture()
+    , m_pImageData()
     , m_Matrix()
     , m_BypassMaxSize(false)
 {
     Q_ASSERT(!m_TextureImage.isNull());
+    requestImageData();
 }
 
 GLC_Texture::GLC_Texture(const GLC_Texture &other)
-    : m_pQOpenGLTexture(nullptr)
-    , m_FileName(other.m_FileName)
+    : m_FileName(other.m_FileName)
     , m_TextureImage(other.m_TextureImage)
-    , m_TextureSize(other.m_TextureSize)
-    , m_HasAlphaChannel(m_TextureImage.hasAlphaChannel())
+    , m_ImageDataFuture(other.m_ImageDataFuture)
+    , m_pImageData(other.m_pImageData)
     , m_Matrix(other.m_Matrix)
     , m_BypassMaxSize(other.m_BypassMaxSize)
 {
-//    if (m_TextureImage.isNull())
-//	{
-//		QString ErrorMess("GLC_Texture::GLC_Texture open image : ");
-//		ErrorMess.append(m_FileName).append(" Failed");
-//		qDebug() << ErrorMess;
-//		GLC_Exception e(ErrorMess);
-//		throw(e);
-//	}
+
 }
 
 // Overload "=" operator
 GLC_Texture& GLC_Texture::operator=(const GLC_Texture& other)
 {
-    if (this->operator !=(other))
+    if (this != &other)
 	{
-        delete m_pQOpenGLTexture;
-        m_pQOpenGLTexture= nullptr;
         m_FileName= other.m_FileName;
         m_TextureImage= other.m_TextureImage;
-        m_TextureSize= other.m_TextureSize;
-        m_HasAlphaChannel= m_TextureImage.hasAlphaChannel();
+        m_ImageDataFuture= other.m_ImageDataFuture;
+        m_pImageData= other.m_pImageData;
         m_Matrix= other.m_Matrix;
         m_BypassMaxSize= other.m_BypassMaxSize;
 	}
@@ -157,15 +121,15 @@ GLC_Texture& GLC_Texture::operator=(const GLC_Texture& other)
 
 GLC_Texture::~GLC_Texture()
 {
-    delete m_pQOpenGLTexture;
+
 }
 
 GLuint GLC_Texture::textureId() const
 {
     GLuint subject= 0;
-    if (m_pQOpenGLTexture)
+    if (!m_pImageData.isNull() && (nullptr != m_pImageData->m_pTexture))
     {
-        subject= m_pQOpenGLTexture->textureId();
+        subject= m_pImageData->m_pTexture->textureId();
     }
 
     return subject;
@@ -194,12 +158,32 @@ bool GLC_Texture::operator==(const GLC_Texture& texture) const
 	}
 	else
 	{
-        result= (m_FileName == texture.m_FileName) && (m_TextureImage == texture.m_TextureImage);
+        // Images with the same content have the same key
+        result= (m_FileName == texture.m_FileName) && (imageData()->m_Key == texture.imageData()->m_Key);
         //result= result && (m_Matrix == texture.m_Matrix);
 	}
 	return result;
 }
 
+const QImage& GLC_Texture::imageOfTexture() const
+{
+    if (m_TextureImage.isNull() && !m_FileName.isEmpty())
+    {
+        m_TextureImage= loadFromFile(m_FileName);
+    }
+    if (m_TextureImage.isNull())
+    {
+        // Use the prepared image if the file is not available
+        const GLC_TextureManager::ImageDataPointer& pImageData= imageData();
+        if (!pImageData->m_Levels.isEmpty())
+        {
+            m_TextureImage= pImageData->m_Levels.first().flipped();
+        }
+    }
+
+    return m_TextureImage;
+}
+
 //////////////////////////////////////////////////////////////////////
 // Set Functions
 //////////////////////////////////////////////////////////////////////
@@ -218,98 +202,77 @@ void GLC_Texture::setMaxTextureSize(const QSize& size)
 	}
 }
 
+void GLC_Texture::setByPassMaxSize(bool value)
+{
+    if (value != m_BypassMaxSize)
+    {
+        m_BypassMaxSize= value;
+        if (!m_TextureImage.isNull() || !m_FileName.isEmpty())
+        {
+            requestImageData();
+        }
+    }
+}
+
 //////////////////////////////////////////////////////////////////////
 // Private OpenGL functions
 //////////////////////////////////////////////////////////////////////
 // Load the texture
 void GLC_Texture::glLoadTexture()
 {
-    if (nullptr == m_pQOpenGLTexture)
-	{
-		// Test image size
-        if (!m_BypassMaxSize && ((m_TextureImage.height() > m_MaxTextureSize.height())
-                                 || (m_TextureImage.width() > m_MaxTextureSize.width())))
-		{
-			QImage rescaledImage;
-            if(m_TextureImage.height() > m_TextureImage.width())
-			{
-                rescaledImage= m_TextureImage.scaledToHeight(m_MaxTextureSize.height(), Qt::SmoothTransformation);
-			}
-			else
-			{
-                rescaledImage= m_TextureImage.scaledToWidth(m_MaxTextureSize.width(), Qt::SmoothTransformation);
-			}
-            m_TextureImage= rescaledImage;
-            m_TextureSize= m_TextureImage.size();
-		}
-		else
-		{
-            m_TextureSize= m_TextureImage.size();
-		}
-        m_pQOpenGLTexture= new QOpenGLTexture(m_TextureImage.flipped());
-	}
+    GLC_TextureManager::instance()->glLoadTexture(imageData());
 }
 
 // Bind texture in 2D mode
 void GLC_Texture::glcBindTexture(void)
 {
-    if (nullptr == m_pQOpenGLTexture)
-	{
-		glLoadTexture();
-	}
-    m_pQOpenGLTexture->bind();
+    if (m_pImageData.isNull() && m_ImageDataFuture.isFinished())
+    {
+        m_pImageData= m_ImageDataFuture.result();
+    }
+    GLC_TextureManager* pTextureManager= GLC_TextureManager::instance();
+    pTextureManager->glBindTexture(m_pImageData);
+
+    // The image can be read again from the file
+    if (pTextureManager->clientImageReleaseIsEnabled() && !m_TextureImage.isNull() && !m_FileName.isEmpty()
+            && !m_pImageData.isNull() && m_pImageData->isComplete())
+    {
+        m_TextureImage= QImage();
+    }
 }
 
-QImage GLC_Texture::loadFromFile(const QString& fileName)
+//////////////////////////////////////////////////////////////////////
+// Private services functions
+//////////////////////////////////////////////////////////////////////
+
+QImage GLC_Texture::loadFromFile(const QString& fileName) const
 {
-	QImage resultImage;
-	if (glc::isArchiveString(fileName))
-	{
+	return GLC_TextureManager::loadImage(fileName);
+}
 
-		// Load the image from a zip archive
-		QuaZip* p3dxmlArchive= new QuaZip(glc::archiveFileName(fileName));
-		// Trying to load archive
-		if(!p3dxmlArchive->open(QuaZip::mdUnzip))
-		{
-		  delete p3dxmlArchive;
-		  return QImage();
-		}
-		else
-		{
-			// Set the file Name Codec
-			p3dxmlArchive->setFileNameCodec("IBM866");
-		}
-		QString imageFileName= glc::archiveEntryFileName(fileName);
-
-		// Create QuaZip File
-		QuaZipFile* p3dxmlFile= new QuaZipFile(p3dxmlArchive);
-
-		// Get the file of the 3dxml
-		if (!p3dxmlArchive->setCurrentFile(imageFileName, QuaZip::csInsensitive))
-		{
-			delete p3dxmlFile;
-			delete p3dxmlArchive;
-			return QImage();
-		}
-
-		// Open the file of the 3dxml
-		if(!p3dxmlFile->open(QIODevice::ReadOnly))
-	    {
-			delete p3dxmlFile;
-			delete p3dxmlArchive;
-			return QImage();
-	    }
-		resultImage.load(p3dxmlFile, QFileInfo(imageFileName).suffix().toLocal8Bit());
-		p3dxmlFile->close();
-		delete p3dxmlFile;
-		delete p3dxmlArchive;
-	}
-	else
-	{
-		resultImage.load(fileName);
-	}
+void GLC_Texture::requestImageData()
+{
+    GLC_TextureManager* pTextureManager= GLC_TextureManager::instance();
+    if (!m_TextureImage.isNull())
+    {
+        m_ImageDataFuture= pTextureManager->requestImageData(m_TextureImage, m_BypassMaxSize);
+    }
+    else
+    {
+        m_ImageDataFuture= pTextureManager->requestImageData(m_FileName, m_BypassMaxSize);
+    }
+    m_pImageData.clear();
+}
+
+const GLC_TextureManager::ImageDataPointer& GLC_Texture::imageData() const
+{
+    if (m_pImageData.isNull())
+    {
+        // Wait for the end of the preparation
+        m_pImageData= m_ImageDataFuture.result();
+    }
 
-	return resultImage;
+    return m_pImageData;
 }
 
 // Non-member stream operator
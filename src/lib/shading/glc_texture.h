@@ -27,9 +27,10 @@
 
 #include <QFile>
 #include <QtOpenGL>
-#include <QOpenGLTexture>
+#include <QFuture>
 
 #include "../maths/glc_matrix4x4.h"
+#include "glc_texturemanager.h"
 
 #include "../glc_config.h"
 
@@ -37,7 +38,11 @@
 //! \class GLC_Texture
 /*! \brief GLC_Texture : Image texture */
 
-/*! Image texture define a texture map in 2 D coordinate system*/
+/*! Image texture define a texture map in 2 D coordinate system
+ *  The image is prepared asynchronously by the GLC_TextureManager, textures with
+ *  the same content share the same OpenGL texture. Functions which need the prepared
+ *  image (size(), hasAlphaChannel(), operator==() with the same file name...) block the calling
+ *  thread until the end of its preparation, use isPrepared() to avoid waiting.*/
 //////////////////////////////////////////////////////////////////////
 
 
@@ -85,11 +90,18 @@ public:
 
 	//! Return true if the texture is loaded
     bool isLoaded() const
-    {return (m_pQOpenGLTexture != NULL);}
+    {return (textureId() != 0);}
+
+    //! Return true if the preparation of the image is finished
+    /*! When this function return false, size(), hasAlphaChannel() and operator==()
+     *  block until the end of the preparation*/
+    bool isPrepared() const
+    {return !m_pImageData.isNull() || m_ImageDataFuture.isFinished();}
 
 	//! Return the texture size
+    /*! Block until the end of the image preparation, see isPrepared()*/
     const QSize& size() const
-	{return m_TextureSize;}
+	{return imageData()->m_Size;}
 
 	//! Return the maximum texture size
     static QSize maxSize();
@@ -97,6 +109,8 @@ public:
     static QSize minSize();
 
 	//! Return true if texture are the same
+	/*! Textures with different file names are compared without waiting,
+	 *  otherwise block until the end of both image preparations, see isPrepared()*/
 	bool operator==(const GLC_Texture&) const;
 
     //! Return false if texture are the same
@@ -104,12 +118,13 @@ public:
     {return !this->operator ==(other);}
 
 	//! Return true if the texture has alpha channel
+    /*! Block until the end of the image preparation, see isPrepared()*/
     bool hasAlphaChannel() const
-	{ return m_HasAlphaChannel;}
+	{ return imageData()->m_HasAlphaChannel;}
 
 	//! Return the an image of the texture
-    const QImage& imageOfTexture() const
-    {return m_TextureImage;}
+    /*! The image is read from the file if it has not been given to the constructor*/
+    const QImage& imageOfTexture() const;
 
     const GLC_Matrix4x4& matrix() const
     {return m_Matrix;}
@@ -132,8 +147,8 @@ public:
     void setMatrix(const GLC_Matrix4x4& matrix)
     {m_Matrix= matrix;}
 
-    void setByPassMaxSize(bool value)
-    {m_BypassMaxSize= value;}
+    //! Set the texture size limit bypassed, the image is prepared again if the value changes
+    void setByPassMaxSize(bool value);
 
     void setFileName(const QString& value)
     {m_FileName= value;}
@@ -144,9 +159,10 @@ public:
 //@{
 //////////////////////////////////////////////////////////////////////
 public:
-	//! Load the texture
+	//! Load the texture, wait for the end of the image preparation
     void glLoadTexture();
 	//! Bind texture in 2D mode
+	/*! Bind a white texture while the image is being prepared*/
 	void glcBindTexture(void);
 
 
@@ -156,7 +172,13 @@ public:
 //////////////////////////////////////////////////////////////////////
 private:
 	//! Load the image of this texture from the given fileName and return resutling image
-	QImage loadFromFile(const QString& fileName);
+	QImage loadFromFile(const QString& fileName) const;
+
+	//! Request the preparation of the image of this texture
+	void requestImageData();
+
+	//! Return the prepared image of this texture, wait for the end of the preparation
+	const GLC_TextureManager::ImageDataPointer& imageData() const;
 
 //@}
 
@@ -165,20 +187,17 @@ private:
 //////////////////////////////////////////////////////////////////////
 
 private:
-	//! OpenGL Context
-    QOpenGLTexture *m_pQOpenGLTexture;
-
 	//! Texture Name
 	QString m_FileName;
 
 	//! QImage off the texture
-    QImage m_TextureImage;
+    mutable QImage m_TextureImage;
 
-	//! Size of the texture
-	QSize m_TextureSize;
+	//! The pending preparation of the image
+	QFuture<GLC_TextureManager::ImageDataPointer> m_ImageDataFuture;
 
-	//! Flag to know if the texture has alpha channel
-	bool m_HasAlphaChannel;
+	//! The prepared image shared by textures with the same content
+	mutable GLC_TextureManager::ImageDataPointer m_pImageData;
 
     GLC_Matrix4x4 m_Matrix;
 
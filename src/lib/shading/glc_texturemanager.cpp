@@ -0,0 +1,519 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_texturemanager.cpp implementation of the GLC_TextureManager class.
+
+#include <QtConcurrent>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QFile>
+#include <QPromise>
+
+#include "glc_texturemanager.h"
+#include "glc_texture.h"
+#include "../glc_global.h"
+#include "../glc_state.h"
+#include "../glc_cachemanager.h"
+#include "../glc_context.h"
+
+// Quazip library
+#include "../quazip/quazip.h"
+#include "../quazip/quazipfile.h"
+
+GLC_TextureManager* GLC_TextureManager::m_pTextureManager= nullptr;
+
+namespace
+{
+    //! Remove the expired weak pointers of the given hash table
+    template <typename Key, typename Value>
+    void removeExpired(QHash<Key, QWeakPointer<Value> >& hash)
+    {
+        typename QHash<Key, QWeakPointer<Value> >::iterator iEntry= hash.begin();
+        while (iEntry != hash.end())
+        {
+            if (iEntry.value().isNull()) iEntry= hash.erase(iEntry);
+            else ++iEntry;
+        }
+    }
+}
+
+GLC_TextureManager::ImageData::ImageData()
+    : m_Key()
+    , m_Size()
+    , m_HasAlphaChannel(false)
+    , m_Levels()
+    , m_LevelCount(0)
+    , m_pTexture(nullptr)
+    , m_UploadedLevelCount(0)
+{
+
+}
+
+GLC_TextureManager::ImageData::~ImageData()
+{
+    delete m_pTexture;
+}
+
+GLC_TextureManager::GLC_TextureManager()
+    : QObject()
+    , m_Mutex()
+    , m_ImageDataHash()
+    , m_FileImageDataHash()
+    , m_PendingFileHash()
+    , m_UploadQueue()
+    , m_pPlaceholderTexture(nullptr)
+    , m_UploadBudget(4.0)
+    , m_ImmediateUploadPixelCount(64 * 64)
+    , m_ClientImageReleaseIsEnabled(false)
+{
+    // Preparation notifications are queued to the GUI thread
+    QCoreApplication* pApplication= QCoreApplication::instance();
+    if ((nullptr != pApplication) && (thread() != pApplication->thread()))
+    {
+        moveToThread(pApplication->thread());
+    }
+}
+
+GLC_TextureManager::~GLC_TextureManager()
+{
+
+}
+
+//////////////////////////////////////////////////////////////////////
+// Get Functions
+//////////////////////////////////////////////////////////////////////
+
+GLC_TextureManager* GLC_TextureManager::instance()
+{
+    if (nullptr == m_pTextureManager)
+    {
+        m_pTextureManager= new GLC_TextureManager();
+    }
+    return m_pTextureManager;
+}
+
+QFuture<GLC_TextureManager::ImageDataPointer> GLC_TextureManager::requestImageData(const QString& fileName, bool byPassMaxSize)
+{
+    const QSize maxSize(byPassMaxSize ? QSize() : GLC_Texture::maxSize());
+    const QString requestKey(fileName + QLatin1Char('#') + QString::fromLatin1(sizeKey(maxSize)));
+
+    QMutexLocker locker(&m_Mutex);
+    QFuture<ImageDataPointer> subject;
+
+    QHash<QString, QFuture<ImageDataPointer> >::const_iterator iPending= m_PendingFileHash.constFind(requestKey);
+    if (iPending != m_PendingFileHash.constEnd())
+    {
+        subject= iPending.value();
+    }
+    else
+    {
+        const ImageDataPointer pImageData(m_FileImageDataHash.value(requestKey).toStrongRef());
+        if (!pImageData.isNull())
+        {
+            // Already prepared, return a finished future
+            QPromise<ImageDataPointer> promise;
+            subject= promise.future();
+            promise.start();
+            promise.addResult(pImageData);
+            promise.finish();
+        }
+        else
+        {
+            const GLC_CacheManager cacheManager(GLC_State::currentCacheManager());
+            subject= QtConcurrent::run(&GLC_TextureManager::prepareFile, this, fileName, maxSize, cacheManager, GLC_State::cacheIsUsed());
+            m_PendingFileHash.insert(requestKey, subject);
+
+            // The continuation locks the mutex
+            locker.unlock();
+            notifyWhenFinished(subject);
+        }
+    }
+
+    return subject;
+}
+
+QFuture<GLC_TextureManager::ImageDataPointer> GLC_TextureManager::requestImageData(const QImage& image, bool byPassMaxSize)
+{
+    const QSize maxSize(byPassMaxSize ? QSize() : GLC_Texture::maxSize());
+    const GLC_CacheManager cacheManager(GLC_State::currentCacheManager());
+
+    const QFuture<ImageDataPointer> subject(QtConcurrent::run(&GLC_TextureManager::prepareImage, this, image, maxSize, cacheManager, GLC_State::cacheIsUsed()));
+    notifyWhenFinished(subject);
+
+    return subject;
+}
+
+QImage GLC_TextureManager::loadImage(const QString& fileName)
+{
+    QByteArray format;
+    const QByteArray fileData(readFile(fileName, &format));
+
+    return QImage::fromData(fileData, format.isEmpty() ? nullptr : format.constData());
+}
+
+//////////////////////////////////////////////////////////////////////
+// OpenGL Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_TextureManager::glBindTexture(const ImageDataPointer& pImageData)
+{
+    if (!pImageData.isNull() && !pImageData->m_Key.isEmpty())
+    {
+        if (nullptr == pImageData->m_pTexture)
+        {
+            glCreateTexture(pImageData.data());
+            if (!pImageData->isComplete())
+            {
+                m_UploadQueue.append(pImageData);
+            }
+        }
+        pImageData->m_pTexture->bind();
+    }
+    else
+    {
+        if (nullptr == m_pPlaceholderTexture)
+        {
+            QImage whiteImage(1, 1, QImage::Format_RGBA8888);
+            whiteImage.fill(Qt::white);
+            m_pPlaceholderTexture= new QOpenGLTexture(whiteImage, QOpenGLTexture::DontGenerateMipMaps);
+        }
+        m_pPlaceholderTexture->bind();
+    }
+}
+
+void GLC_TextureManager::glLoadTexture(const ImageDataPointer& pImageData)
+{
+    Q_ASSERT(!pImageData.isNull());
+    if (!pImageData->m_Key.isEmpty())
+    {
+        if (nullptr == pImageData->m_pTexture)
+        {
+            glCreateTexture(pImageData.data());
+        }
+        while (!pImageData->isComplete())
+        {
+            glUploadNextLevel(pImageData.data());
+        }
+    }
+}
+
+void GLC_TextureManager::glProcessUploads()
+{
+    if (m_UploadQueue.isEmpty()) return;
+
+    const qint64 budget= static_cast<qint64>(m_UploadBudget * 1000000.0);
+    QElapsedTimer timer;
+    timer.start();
+
+    // At least one level is uploaded per frame
+    bool hasUploaded= false;
+    while (!m_UploadQueue.isEmpty() && (!hasUploaded || (budget <= 0) || (timer.nsecsElapsed() < budget)))
+    {
+        const ImageDataPointer pImageData(m_UploadQueue.first().toStrongRef());
+        if (!pImageData.isNull() && !pImageData->isComplete())
+        {
+            glUploadNextLevel(pImageData.data());
+            hasUploaded= true;
+        }
+        if (pImageData.isNull() || pImageData->isComplete())
+        {
+            m_UploadQueue.removeFirst();
+        }
+    }
+
+    if (hasUploaded)
+    {
+        // Uploads change the texture binding
+        GLC_Context::current()->renderStateCache()->invalidate();
+    }
+
+    if (!m_UploadQueue.isEmpty())
+    {
+        emit repaintNeeded();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private slots
+//////////////////////////////////////////////////////////////////////
+
+void GLC_TextureManager::preparationFinished()
+{
+    // Keep a weak reference on finished file preparations
+    {
+        QMutexLocker locker(&m_Mutex);
+        QHash<QString, QFuture<ImageDataPointer> >::iterator iPending= m_PendingFileHash.begin();
+        while (iPending != m_PendingFileHash.end())
+        {
+            if (iPending.value().isFinished())
+            {
+                m_FileImageDataHash.insert(iPending.key(), iPending.value().result());
+                iPending= m_PendingFileHash.erase(iPending);
+            }
+            else
+            {
+                ++iPending;
+            }
+        }
+
+        // Forget released images at the end of a loading
+        if (m_PendingFileHash.isEmpty())
+        {
+            removeExpired(m_ImageDataHash);
+            removeExpired(m_FileImageDataHash);
+        }
+    }
+
+    emit repaintNeeded();
+}
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+
+void GLC_TextureManager::notifyWhenFinished(QFuture<ImageDataPointer> future)
+{
+    // The continuation is called in the thread of the manager once the future is finished
+    future.then(this, [this](const ImageDataPointer&)
+    {
+        preparationFinished();
+    });
+}
+
+GLC_TextureManager::ImageDataPointer GLC_TextureManager::prepareFile(const QString& fileName, const QSize& maxSize, GLC_CacheManager cacheManager, bool useCache)
+{
+    QByteArray format;
+    const QByteArray fileData(readFile(fileName, &format));
+
+    ImageDataPointer subject;
+    if (!fileData.isEmpty())
+    {
+        const QByteArray contentKey(QCryptographicHash::hash(fileData, QCryptographicHash::Sha1).toHex() + sizeKey(maxSize));
+        subject= prepare(contentKey, QImage(), fileData, format, maxSize, cacheManager, useCache);
+    }
+    else
+    {
+        subject= ImageDataPointer(new ImageData());
+    }
+
+    return subject;
+}
+
+GLC_TextureManager::ImageDataPointer GLC_TextureManager::prepareImage(const QImage& image, const QSize& maxSize, GLC_CacheManager cacheManager, bool useCache)
+{
+    ImageDataPointer subject;
+    if (!image.isNull())
+    {
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        const QByteArray header(QByteArray::number(image.width()) + 'x' + QByteArray::number(image.height()) + 'x' + QByteArray::number(static_cast<int>(image.format())));
+        hash.addData(header);
+        hash.addData(QByteArrayView(reinterpret_cast<const char*>(image.constBits()), image.sizeInBytes()));
+        const QByteArray contentKey(hash.result().toHex() + sizeKey(maxSize));
+        subject= prepare(contentKey, image, QByteArray(), QByteArray(), maxSize, cacheManager, useCache);
+    }
+    else
+    {
+        subject= ImageDataPointer(new ImageData());
+    }
+
+    return subject;
+}
+
+GLC_TextureManager::ImageDataPointer GLC_TextureManager::prepare(const QByteArray& contentKey, const QImage& image, const QByteArray& fileData, const QByteArray& format
+                                                                 , const QSize& maxSize, GLC_CacheManager& cacheManager, bool useCache)
+{
+    ImageDataPointer subject;
+    {
+        QMutexLocker locker(&m_Mutex);
+        subject= m_ImageDataHash.value(contentKey).toStrongRef();
+    }
+
+    if (subject.isNull())
+    {
+        subject= ImageDataPointer(new ImageData());
+        const QString cacheKey(QString::fromLatin1(contentKey));
+        if (useCache)
+        {
+            subject->m_Levels= cacheManager.textureLevels(cacheKey, &(subject->m_HasAlphaChannel));
+        }
+        if (subject->m_Levels.isEmpty())
+        {
+            QImage sourceImage(image);
+            if (sourceImage.isNull())
+            {
+                sourceImage.loadFromData(fileData, format.isEmpty() ? nullptr : format.constData());
+            }
+            if (!sourceImage.isNull())
+            {
+                subject->m_HasAlphaChannel= sourceImage.hasAlphaChannel();
+                subject->m_Levels= mipmapLevels(sourceImage, maxSize);
+                if (useCache)
+                {
+                    cacheManager.addTextureToCache(cacheKey, subject->m_Levels, subject->m_HasAlphaChannel);
+                }
+            }
+        }
+
+        if (!subject->m_Levels.isEmpty())
+        {
+            subject->m_Key= contentKey;
+            subject->m_Size= subject->m_Levels.first().size();
+            subject->m_LevelCount= subject->m_Levels.size();
+
+            // The same content may have been prepared by another thread
+            QMutexLocker locker(&m_Mutex);
+            const ImageDataPointer pImageData(m_ImageDataHash.value(contentKey).toStrongRef());
+            if (!pImageData.isNull())
+            {
+                subject= pImageData;
+            }
+            else
+            {
+                m_ImageDataHash.insert(contentKey, subject);
+            }
+        }
+    }
+
+    return subject;
+}
+
+QByteArray GLC_TextureManager::readFile(const QString& fileName, QByteArray* pFormat)
+{
+    QByteArray subject;
+    if (glc::isArchiveString(fileName))
+    {
+        const QString imageFileName(glc::archiveEntryFileName(fileName));
+        *pFormat= QFileInfo(imageFileName).suffix().toLocal8Bit();
+
+        // Load the image from a zip archive
+        QuaZip archive(glc::archiveFileName(fileName));
+        if (archive.open(QuaZip::mdUnzip))
+        {
+            // Set the file Name Codec
+            archive.setFileNameCodec("IBM866");
+            if (archive.setCurrentFile(imageFileName, QuaZip::csInsensitive))
+            {
+                QuaZipFile archiveFile(&archive);
+                if (archiveFile.open(QIODevice::ReadOnly))
+                {
+                    subject= archiveFile.readAll();
+                    archiveFile.close();
+                }
+            }
+            archive.close();
+        }
+    }
+    else
+    {
+        *pFormat= QFileInfo(fileName).suffix().toLocal8Bit();
+        QFile file(fileName);
+        if (file.open(QIODevice::ReadOnly))
+        {
+            subject= file.readAll();
+        }
+    }
+
+    return subject;
+}
+
+QList<QImage> GLC_TextureManager::mipmapLevels(const QImage& image, const QSize& maxSize)
+{
+    QImage level(image);
+    if (maxSize.isValid() && ((level.height() > maxSize.height()) || (level.width() > maxSize.width())))
+    {
+        if (level.height() > level.width())
+        {
+            level= level.scaledToHeight(maxSize.height(), Qt::SmoothTransformation);
+        }
+        else
+        {
+            level= level.scaledToWidth(maxSize.width(), Qt::SmoothTransformation);
+        }
+    }
+
+    // Levels are filtered with premultiplied alpha and flipped for OpenGL
+    level= level.convertToFormat(level.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32).flipped();
+
+    QList<QImage> subject;
+    subject.append(level.convertToFormat(QImage::Format_RGBA8888));
+    while ((level.width() > 1) || (level.height() > 1))
+    {
+        level= level.scaled(qMax(1, level.width() / 2), qMax(1, level.height() / 2), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        subject.append(level.convertToFormat(QImage::Format_RGBA8888));
+    }
+
+    return subject;
+}
+
+QByteArray GLC_TextureManager::sizeKey(const QSize& maxSize)
+{
+    QByteArray subject("_full");
+    if (maxSize.isValid())
+    {
+        subject= '_' + QByteArray::number(maxSize.width()) + 'x' + QByteArray::number(maxSize.height());
+    }
+
+    return subject;
+}
+
+void GLC_TextureManager::glCreateTexture(ImageData* pImageData)
+{
+    Q_ASSERT(nullptr == pImageData->m_pTexture);
+    Q_ASSERT(pImageData->m_Levels.size() == pImageData->m_LevelCount);
+
+    QOpenGLTexture* pTexture= new QOpenGLTexture(QOpenGLTexture::Target2D);
+    pTexture->setFormat(QOpenGLTexture::RGBA8_UNorm);
+    pTexture->setSize(pImageData->m_Size.width(), pImageData->m_Size.height());
+    pTexture->setMipLevels(pImageData->m_LevelCount);
+    pTexture->allocateStorage(QOpenGLTexture::RGBA, QOpenGLTexture::UInt8);
+    pImageData->m_pTexture= pTexture;
+    pImageData->m_UploadedLevelCount= 0;
+
+    // Small levels are uploaded at once to have a usable texture
+    const bool useBudget= (m_UploadBudget > 0.0);
+    bool uploadNextLevel= true;
+    while (uploadNextLevel && !pImageData->isComplete())
+    {
+        glUploadNextLevel(pImageData);
+        if (useBudget && !pImageData->isComplete())
+        {
+            const QImage& nextLevel= pImageData->m_Levels.at(pImageData->m_LevelCount - pImageData->m_UploadedLevelCount - 1);
+            uploadNextLevel= ((nextLevel.width() * nextLevel.height()) <= m_ImmediateUploadPixelCount);
+        }
+    }
+}
+
+void GLC_TextureManager::glUploadNextLevel(ImageData* pImageData)
+{
+    Q_ASSERT(!pImageData->isComplete());
+    const int level= pImageData->m_LevelCount - pImageData->m_UploadedLevelCount - 1;
+    pImageData->m_pTexture->setData(level, QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, pImageData->m_Levels.at(level).constBits());
+    pImageData->m_pTexture->setMipBaseLevel(level);
+    ++(pImageData->m_UploadedLevelCount);
+
+    if (pImageData->isComplete() && m_ClientImageReleaseIsEnabled)
+    {
+        pImageData->m_Levels.clear();
+    }
+}
@@ -0,0 +1,263 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU Lesser General Public License as published by
+ the Free Software Foundation; either version 3 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+//! \file glc_texturemanager.h interface for the GLC_TextureManager class.
+
+#ifndef GLC_TEXTUREMANAGER_H_
+#define GLC_TEXTUREMANAGER_H_
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QImage>
+#include <QFuture>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QWeakPointer>
+#include <QOpenGLTexture>
+
+#include "../glc_config.h"
+
+class GLC_CacheManager;
+
+//////////////////////////////////////////////////////////////////////
+//! \class GLC_TextureManager
+/*! \brief GLC_TextureManager : Decode, share and upload texture images*/
+
+/*! The texture manager prepares the images of GLC_Texture on the global thread pool :
+ *  - The image is read and decoded, then rescaled to GLC_Texture::maxSize()
+ *  - The mipmap levels are generated once and stored in the GLC_CacheManager if the cache is used
+ *  - Images with the same content share the same levels and the same OpenGL texture,
+ *    the content is identified by the hash of the file or of the pixels and by the size limit
+ *
+ *  The OpenGL texture is created on the first bind with the smallest levels, the other levels
+ *  are uploaded from the smallest to the biggest by glProcessUploads() in the limit of the upload budget.
+ *  A texture which is not yet decoded is replaced by a white texture.
+ *
+ *  Client side levels can be released once the OpenGL texture is complete, see setClientImageReleaseEnabled().
+ *
+ *  The manager must be created in the GUI thread, repaintNeeded() is emitted when
+ *  a decoded image or a level upload is pending.*/
+//////////////////////////////////////////////////////////////////////
+class GLC_LIB_EXPORT GLC_TextureManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! Prepared image shared by textures with the same content
+    class ImageData
+    {
+    public:
+        ImageData();
+        ~ImageData();
+
+        //! Return true if the OpenGL texture has all its levels
+        inline bool isComplete() const
+        {return (nullptr != m_pTexture) && (m_UploadedLevelCount == m_LevelCount);}
+
+        //! The content key, empty if the image can't be loaded
+        QByteArray m_Key;
+
+        //! The size of the biggest level
+        QSize m_Size;
+
+        //! True if the source image has an alpha channel
+        bool m_HasAlphaChannel;
+
+        //! Mipmap levels in RGBA8888 vertically flipped, from the biggest to the smallest
+        QList<QImage> m_Levels;
+
+        //! The number of mipmap levels
+        int m_LevelCount;
+
+        //! The OpenGL texture
+        QOpenGLTexture* m_pTexture;
+
+        //! The number of uploaded levels, starting from the smallest
+        int m_UploadedLevelCount;
+
+    private:
+        Q_DISABLE_COPY(ImageData)
+    };
+    typedef QSharedPointer<ImageData> ImageDataPointer;
+
+//////////////////////////////////////////////////////////////////////
+/*! @name Constructor / Destructor */
+//@{
+//////////////////////////////////////////////////////////////////////
+private:
+    GLC_TextureManager();
+
+public:
+    virtual ~GLC_TextureManager();
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Get Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Return the unique instance of the texture manager
+    static GLC_TextureManager* instance();
+
+    //! Return the upload budget per frame in milliseconds
+    inline double uploadBudget() const
+    {return m_UploadBudget;}
+
+    //! Return true if client side levels are released after upload
+    inline bool clientImageReleaseIsEnabled() const
+    {return m_ClientImageReleaseIsEnabled;}
+
+    //! Return the number of textures waiting for level upload
+    inline int pendingUploadCount() const
+    {return m_UploadQueue.size();}
+
+    //! Return the image data of the given image file
+    /*! The image is prepared asynchronously, requests of the same file share the same result*/
+    QFuture<ImageDataPointer> requestImageData(const QString& fileName, bool byPassMaxSize);
+
+    //! Return the image data of the given image
+    /*! The image is prepared asynchronously*/
+    QFuture<ImageDataPointer> requestImageData(const QImage& image, bool byPassMaxSize);
+
+    //! Return the full size image of the given file name or archive string
+    static QImage loadImage(const QString& fileName);
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name Set Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Set the upload budget per frame in milliseconds (4 by default)
+    /*! With a budget lower or equal to 0, textures are completely uploaded on first bind*/
+    inline void setUploadBudget(double milliseconds)
+    {m_UploadBudget= milliseconds;}
+
+    //! Set client side levels release after upload enabled (Disabled by default)
+    /*! Released images are read again from their files by GLC_Texture::imageOfTexture()*/
+    inline void setClientImageReleaseEnabled(bool enabled)
+    {m_ClientImageReleaseIsEnabled= enabled;}
+
+//@}
+
+//////////////////////////////////////////////////////////////////////
+/*! \name OpenGL Functions*/
+//@{
+//////////////////////////////////////////////////////////////////////
+public:
+    //! Bind the texture of the given image data, create it if needed
+    /*! Bind a white texture if the image data is null or empty*/
+    void glBindTexture(const ImageDataPointer& pImageData);
+
+    //! Create the texture of the given image data and upload all its levels
+    void glLoadTexture(const ImageDataPointer& pImageData);
+
+    //! Upload pending levels in the limit of the upload budget
+    /*! Called once per frame by GLC_Viewport::glExecuteCam()*/
+    void glProcessUploads();
+
+//@}
+
+signals:
+    //! Emitted when a texture has been decoded or has levels to upload
+    void repaintNeeded();
+
+//////////////////////////////////////////////////////////////////////
+// Private slots
+//////////////////////////////////////////////////////////////////////
+private slots:
+    //! An asynchronous preparation is finished
+    void preparationFinished();
+
+//////////////////////////////////////////////////////////////////////
+// Private services Functions
+//////////////////////////////////////////////////////////////////////
+private:
+    //! Call preparationFinished() in the thread of the manager when the given future is finished
+    void notifyWhenFinished(QFuture<ImageDataPointer> future);
+
+    //! Prepare the image of the given file (Called in a worker thread)
+    ImageDataPointer prepareFile(const QString& fileName, const QSize& maxSize, GLC_CacheManager cacheManager, bool useCache);
+
+    //! Prepare the given image (Called in a worker thread)
+    ImageDataPointer prepareImage(const QImage& image, const QSize& maxSize, GLC_CacheManager cacheManager, bool useCache);
+
+    //! Return the image data of the given content key, decode the image if the content is unknown
+    /*! The image is decoded from the given image or from the given file data if the image is null*/
+    ImageDataPointer prepare(const QByteArray& contentKey, const QImage& image, const QByteArray& fileData, const QByteArray& format
+                             , const QSize& maxSize, GLC_CacheManager& cacheManager, bool useCache);
+
+    //! Return the content of the given file name or archive string and set its format
+    static QByteArray readFile(const QString& fileName, QByteArray* pFormat);
+
+    //! Return the mipmap levels of the given image limited to the given size
+    static QList<QImage> mipmapLevels(const QImage& image, const QSize& maxSize);
+
+    //! Return the suffix of content keys of the given size limit
+    static QByteArray sizeKey(const QSize& maxSize);
+
+    //! Create the OpenGL texture of the given image data
+    void glCreateTexture(ImageData* pImageData);
+
+    //! Upload the next level of the given image data
+    void glUploadNextLevel(ImageData* pImageData);
+
+//////////////////////////////////////////////////////////////////////
+// Private members
+//////////////////////////////////////////////////////////////////////
+private:
+    //! The unique instance
+    static GLC_TextureManager* m_pTextureManager;
+
+    //! Protect the hash tables below
+    QMutex m_Mutex;
+
+    //! Prepared images of each content key
+    QHash<QByteArray, QWeakPointer<ImageData> > m_ImageDataHash;
+
+    //! Prepared images of each file request
+    QHash<QString, QWeakPointer<ImageData> > m_FileImageDataHash;
+
+    //! Pending preparation of each file request
+    QHash<QString, QFuture<ImageDataPointer> > m_PendingFileHash;
+
+    //! Textures with levels to upload
+    QList<QWeakPointer<ImageData> > m_UploadQueue;
+
+    //! The texture used while an image is not available
+    QOpenGLTexture* m_pPlaceholderTexture;
+
+    //! The upload budget per frame in milliseconds
+    double m_UploadBudget;
+
+    //! Levels smaller than this number of pixels are uploaded without budget
+    int m_ImmediateUploadPixelCount;
+
+    //! Client side levels release flag
+    bool m_ClientImageReleaseIsEnabled;
+
+    Q_DISABLE_COPY(GLC_TextureManager)
+};
+
+#endif /* GLC_TEXTUREMANAGER_H_ */
@@ -0,0 +1,24 @@
+#version 120
+
+uniform bool        useTexture;
+uniform sampler2D   tex;
+
+varying vec2    v_textcoord;
+varying vec4    v_front_color;
+varying vec4    v_back_color;
+
+void main()
+{
+    vec4 color= gl_FrontFacing ? v_front_color : v_back_color;
+    if (useTexture)
+    {
+        color*= texture2D(tex, v_textcoord);
+    }
+
+    // Weight function of McGuire and Bavoil, near and opaque fragments weigh more
+    float a= color.a;
+    float w= clamp(pow(min(1.0, a * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+
+    gl_FragData[0]= vec4(color.rgb * a * w, a);
+    gl_FragData[1]= vec4(a * w);
+}
@@ -0,0 +1,63 @@
+#version 120
+
+// Fixed pipeline state sent by GLC_Context
+uniform bool    enable_lighting;
+uniform bool    light_model_two_sided;
+uniform bool    light_enable_state[8];
+uniform bool    enable_color_material;
+
+varying vec2    v_textcoord;
+varying vec4    v_front_color;
+varying vec4    v_back_color;
+
+vec4 do_lighting(vec3 n, vec3 p_eye, vec4 mat_ambient_color, vec4 mat_diffuse_color)
+{
+    vec4 vtx_color= gl_FrontMaterial.emission + (mat_ambient_color * gl_LightModel.ambient);
+    for (int i= 0; i < 8; ++i)
+    {
+        if (light_enable_state[i])
+        {
+            vec3 VPpli;
+            if (gl_LightSource[i].position.w != 0.0) VPpli= normalize(gl_LightSource[i].position.xyz - p_eye);
+            else VPpli= normalize(gl_LightSource[i].position.xyz);
+
+            float ndot1= max(0.0, dot(n, VPpli));
+            vtx_color+= (gl_LightSource[i].ambient * mat_ambient_color);
+            vtx_color+= (ndot1 * gl_LightSource[i].diffuse * mat_diffuse_color);
+            if (ndot1 > 0.0)
+            {
+                float ndoth= max(0.0, dot(n, normalize(VPpli + vec3(0.0, 0.0, 1.0))));
+                vtx_color+= (pow(ndoth, gl_FrontMaterial.shininess) * gl_FrontMaterial.specular * gl_LightSource[i].specular);
+            }
+        }
+    }
+
+    vtx_color.a= mat_diffuse_color.a;
+    return vtx_color;
+}
+
+void main()
+{
+    if (enable_lighting)
+    {
+        vec3 p_eye= vec3(gl_ModelViewMatrix * gl_Vertex);
+        vec3 n= normalize(gl_NormalMatrix * gl_Normal);
+
+        vec4 mat_ambient_color= enable_color_material ? gl_Color : gl_FrontMaterial.ambient;
+        vec4 mat_diffuse_color= enable_color_material ? gl_Color : gl_FrontMaterial.diffuse;
+        v_front_color= do_lighting(n, p_eye, mat_ambient_color, mat_diffuse_color);
+        v_back_color= v_front_color;
+        if (light_model_two_sided)
+        {
+            v_back_color= do_lighting(-n, p_eye, mat_ambient_color, mat_diffuse_color);
+        }
+    }
+    else
+    {
+        v_front_color= gl_Color;
+        v_back_color= gl_Color;
+    }
+
+    v_textcoord= (gl_TextureMatrix[0] * gl_MultiTexCoord0).xy;
+    gl_Position= ftransform();
+}
@@ -0,0 +1,18 @@
+#version 120
+
+uniform sampler2D   accumulation_tex;
+uniform sampler2D   weight_tex;
+
+varying vec2    v_textcoord;
+
+void main()
+{
+    vec4 accumulation= texture2D(accumulation_tex, v_textcoord);
+
+    // The alpha of the accumulation is the product of (1 - alpha)
+    float revealage= accumulation.a;
+    if (revealage >= 1.0) discard;
+
+    float weight= texture2D(weight_tex, v_textcoord).r;
+    gl_FragColor= vec4(accumulation.rgb / max(weight, 1e-5), 1.0 - revealage);
+}
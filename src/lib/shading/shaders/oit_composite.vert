@@ -0,0 +1,11 @@
+#version 120
+
+attribute vec2  a_position;
+
+varying vec2    v_textcoord;
+
+void main()
+{
+    v_textcoord= a_position * 0.5 + 0.5;
+    gl_Position= vec4(a_position, 0.0, 1.0);
+}
@@ -131,6 +131,8 @@ void GLC_ImagePlane::render(double screenRatio)
 	glDisable(GL_DEPTH_TEST);
 	glTexEnvf( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_DECAL);
 
+    // The background is not uploaded progressively
+    m_p3DViewInstance->geomAt(0)->glLoadTexture();
     m_p3DViewInstance->render();
 
 	glTexEnvf( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
@@ -108,8 +108,8 @@ void GLC_RepFlyMover::glDraw()
 	const double hRatio= static_cast<double>(m_pViewport->viewHSize()) / calibre;
 	const double vRatio= static_cast<double>(m_pViewport->viewVSize()) / calibre;
 
-	glDisable(GL_TEXTURE_2D);
     GLC_Context* pContext= GLC_ContextManager::instance()->currentContext();
+    pContext->renderStateCache()->glcDisable(GL_TEXTURE_2D);
 
     pContext->glcEnableLighting(false);
 	glDisable(GL_DEPTH_TEST);
@@ -31,6 +31,8 @@
 #include "../glc_factory.h"
 #include "../sceneGraph/glc_octree.h"
 #include "../glc_exception.h"
+#include "../glc_renderprofiler.h"
+#include "../shading/glc_texturemanager.h"
 
 #include "glc_inputeventinterpreter.h"
 #include "glc_defaulteventinterpreter.h"
@@ -69,6 +71,9 @@ GLC_ViewHandler::GLC_ViewHandler(QObject *pParent)
     m_pMoverController= new GLC_MoverController(GLC_Factory::instance()->createDefaultMoverController(repColor, m_pViewport));
 
     connect(m_pMoverController, SIGNAL(repaintNeeded()), this, SLOT(updateGL()));
+
+    // Textures are prepared and uploaded asynchronously
+    connect(GLC_TextureManager::instance(), SIGNAL(repaintNeeded()), this, SLOT(updateGL()));
 }
 
 GLC_ViewHandler::~GLC_ViewHandler()
@@ -282,10 +287,16 @@ void GLC_ViewHandler::renderBackGround()
 
 void GLC_ViewHandler::render()
 {
+    const bool profileFrame= !GLC_State::isInSelectionMode();
+    if (profileFrame) GLC_RenderProfiler::beginFrame();
+
     try
     {
         QOpenGLContext::currentContext()->functions()->glUseProgram(0);
 
+        // OpenGL state may have been modified outside GLC_lib since the last frame
+        GLC_Context::current()->renderStateCache()->invalidate();
+
         // Calculate camera depth of view
         m_pViewport->setDistMinAndMax(m_World.boundingBox());
         m_World.collection()->updateInstanceViewableState();
@@ -320,4 +331,6 @@ void GLC_ViewHandler::render()
     {
         qDebug() << e.what();
     }
+
+    if (profileFrame) GLC_RenderProfiler::endFrame();
 }
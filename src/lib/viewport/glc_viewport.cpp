@@ -30,6 +30,7 @@
 #include "../sceneGraph/glc_3dviewinstance.h"
 #include "../glc_factory.h"
 #include "../glc_context.h"
+#include "../shading/glc_texturemanager.h"
 
 #include <QtDebug>
 
@@ -190,10 +191,19 @@ void GLC_Viewport::initGl()
     glDepthMask(GL_TRUE);
 
     glEnable(GL_NORMALIZE);
+
+    GLC_Context::current()->renderStateCache()->invalidate();
 }
 
 void GLC_Viewport::glExecuteCam(const QImage& image, bool preserveRatio)
 {
+    // Begin of a frame for applications which do not render with GLC_ViewHandler :
+    // OpenGL state may have been modified outside GLC_lib since the last frame
+    GLC_Context::current()->renderStateCache()->invalidate();
+
+    // Progressive texture upload, once per frame
+    GLC_TextureManager::instance()->glProcessUploads();
+
     if (!image.isNull())
     {
         GLC_ImagePlane* pOldImagePlane= m_pImagePlane;
@@ -406,6 +416,21 @@ GLC_Point3d GLC_Viewport::fuzzyUnproject(int x, int y, double z) const
     return subject;
 }
 
+double GLC_Viewport::pixelSize(const GLC_Point3d& point) const
+{
+    // Same projection of the distance as the LOD and pixel culling
+    double dist= (point - m_pViewCam->eye()).length();
+    if (m_UseParallelProjection) dist= m_pViewCam->distEyeTarget();
+    const double cameraCover= dist * m_ViewTangent;
+
+    return (m_Height > 0) ? (cameraCover / m_Height) : cameraCover;
+}
+
+GLC_KdTree::Snap GLC_Viewport::snap(const GLC_Point3d& point, const GLC_KdTree& tree, int pixelTolerance) const
+{
+    return tree.snap(point, pixelSize(point) * qMax(0, pixelTolerance));
+}
+
 QList<GLC_Point3d> GLC_Viewport::unproject(const QList<int>& list, GLenum buffer)const
 {
     const int size= list.size();
@@ -555,7 +580,9 @@ GLC_uint GLC_Viewport::selectBody(GLC_3DViewInstance* pInstance, int x, int y, G
 	// Draw the scene
 	glDisable(GL_BLEND);
     pContext->glcEnableLighting(false);
-	glDisable(GL_TEXTURE_2D);
+    pContext->renderStateCache()->glcDisable(GL_TEXTURE_2D);
+    // Selection colors overwrite the current material
+    pContext->renderStateCache()->invalidateMaterial();
 
 	pInstance->renderForBodySelection();
 	GLC_State::setSelectionMode(false);
@@ -587,7 +614,9 @@ QPair<int, GLC_uint> GLC_Viewport::selectPrimitive(GLC_3DViewInstance* pInstance
 	// Draw the scene
 	glDisable(GL_BLEND);
     pContext->glcEnableLighting(false);
-	glDisable(GL_TEXTURE_2D);
+    pContext->renderStateCache()->glcDisable(GL_TEXTURE_2D);
+    // Selection colors overwrite the current material
+    pContext->renderStateCache()->invalidateMaterial();
 
 	pInstance->renderForBodySelection();
 
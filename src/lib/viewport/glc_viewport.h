@@ -34,6 +34,7 @@
 #include "glc_frustum.h"
 #include "../maths/glc_plane.h"
 #include "../sceneGraph/glc_3dviewcollection.h"
+#include "../geometry/glc_kdtree.h"
 
 #include "../glc_config.h"
 
@@ -180,6 +181,7 @@ public:
 	void initGl();
 
 	//! Load camera's transformation Matrix and display image if necessary
+	/*! Called once per frame, invalidate the render state cache of the current context*/
     void glExecuteCam(const QImage &image= QImage(), bool preserveRatio= true);
 
 	//! Update this viewport OpenGL projection matrix
@@ -210,6 +212,14 @@ public:
     //! Return the world 3d point of given Z from the given screen coordinate
     GLC_Point3d fuzzyUnproject(int x, int y, double z) const;
 
+    //! Return the size in world units of a pixel at the given world point
+    double pixelSize(const GLC_Point3d& point) const;
+
+    //! Snap the given world point, usually an unprojected pick, to the nearest vertex or edge of the given tree
+    /*! Vertices and edges are searched in pixelTolerance pixels around the point, vertices first.
+     *  The tree must be in world coordinates, built from an instance or with its absolute matrix*/
+    GLC_KdTree::Snap snap(const GLC_Point3d& point, const GLC_KdTree& tree, int pixelTolerance= 8) const;
+
 	//! Return the list af world 3d point form the givne list af screen coordinates
 	/*! The size of the given list must be a multiple of 2*/
     QList<GLC_Point3d> unproject(const QList<int>& list, GLenum buffer= GL_FRONT)const;
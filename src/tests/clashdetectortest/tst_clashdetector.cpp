@@ -0,0 +1,145 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+// Test of GLC_ClashDetector on overlapping, touching, contained and separated boxes,
+// and of the rebuild of the trees of modified meshes.
+
+#include <QtTest>
+
+#include <GLC_ClashDetector>
+#include <GLC_World>
+#include <GLC_StructOccurrence>
+#include <GLC_StructInstance>
+#include <GLC_StructReference>
+#include <GLC_3DRep>
+#include <GLC_Box>
+#include <GLC_Matrix4x4>
+
+class ClashDetectorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void detect_data();
+    void detect();
+    void rebuildModifiedTree();
+
+private:
+    //! Add a box of the given length centred on the given point to the given world and return it
+    static GLC_Box* addBox(GLC_World* pWorld, double length, double x, double y, double z);
+};
+
+void ClashDetectorTest::detect_data()
+{
+    // Second box position and length, the first box has a length of 2 and is centred on the origin
+    QTest::addColumn<double>("x");
+    QTest::addColumn<double>("length");
+    // Expected clash type, -1 if no clash is expected
+    QTest::addColumn<int>("type");
+    QTest::addColumn<bool>("hasTrianglePairs");
+
+    QTest::newRow("overlapping") << 1.5 << 2.0 << int(GLC_ClashDetector::Interference) << true;
+    QTest::newRow("touching") << 2.0 << 2.0 << int(GLC_ClashDetector::Contact) << false;
+    QTest::newRow("contained") << 0.2 << 0.5 << int(GLC_ClashDetector::Interference) << false;
+    QTest::newRow("clearance") << 2.5 << 2.0 << int(GLC_ClashDetector::Clearance) << false;
+    QTest::newRow("separated") << 5.0 << 2.0 << -1 << false;
+}
+
+void ClashDetectorTest::detect()
+{
+    QFETCH(double, x);
+    QFETCH(double, length);
+    QFETCH(int, type);
+    QFETCH(bool, hasTrianglePairs);
+
+    GLC_World world;
+    addBox(&world, 2.0, 0.0, 0.0, 0.0);
+    addBox(&world, length, x, 0.0, 0.0);
+
+    GLC_ClashDetector detector;
+    detector.setContactTolerance(0.01);
+    detector.setClearance(1.0);
+    detector.detect(world);
+
+    QCOMPARE(detector.statistics().m_BodyCount, 2);
+    if (type < 0)
+    {
+        QVERIFY(detector.clashes().isEmpty());
+        return;
+    }
+
+    QCOMPARE(detector.clashes().count(), 1);
+    const GLC_ClashDetector::Clash& clash= detector.clashes().first();
+    QCOMPARE(int(clash.m_Type), type);
+    QCOMPARE(clash.m_TrianglePairCount > 0, hasTrianglePairs);
+    QVERIFY(clash.m_OccurrenceId1 != clash.m_OccurrenceId2);
+
+    if (type == GLC_ClashDetector::Clearance)
+    {
+        QVERIFY(qAbs(clash.m_Distance - 0.5) < 1e-4);
+    }
+    else
+    {
+        QCOMPARE(clash.m_Distance, 0.0);
+    }
+}
+
+void ClashDetectorTest::rebuildModifiedTree()
+{
+    GLC_World world;
+    addBox(&world, 2.0, 0.0, 0.0, 0.0);
+    GLC_Box* pBox= addBox(&world, 2.0, 3.0, 0.0, 0.0);
+
+    GLC_ClashDetector detector;
+    detector.detect(world);
+    QCOMPARE(detector.statistics().m_BuiltTreeCount, 2);
+    QVERIFY(detector.clashes().isEmpty());
+
+    // The trees of unchanged meshes are kept
+    detector.detect(world);
+    QCOMPARE(detector.statistics().m_BuiltTreeCount, 0);
+
+    // The second box now reaches the first one
+    pBox->setLgX(4.0);
+    pBox->boundingBox();
+    detector.detect(world);
+    QCOMPARE(detector.statistics().m_BuiltTreeCount, 1);
+    QCOMPARE(detector.clashes().count(), 1);
+    QCOMPARE(detector.clashes().first().m_Type, GLC_ClashDetector::Interference);
+}
+
+GLC_Box* ClashDetectorTest::addBox(GLC_World* pWorld, double length, double x, double y, double z)
+{
+    GLC_Box* pBox= new GLC_Box(length, length, length);
+    // The mesh of the box is created with its bounding box
+    pBox->boundingBox();
+
+    GLC_StructInstance* pInstance= new GLC_StructInstance(new GLC_StructReference(new GLC_3DRep(pBox)));
+    pInstance->move(GLC_Matrix4x4(x, y, z));
+    pWorld->rootOccurrence()->addChild(pInstance);
+
+    return pBox;
+}
+
+QTEST_GUILESS_MAIN(ClashDetectorTest)
+
+#include "tst_clashdetector.moc"
@@ -0,0 +1,17 @@
+TARGET = depthsortertest
+TEMPLATE = app
+QT += core gui opengl testlib
+
+CONFIG += warn_on console testcase
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./Build
+MOC_DIR = ./Build
+UI_DIR = ./Build
+RCC_DIR = ./Build
+
+include(../../../glc_lib.pri)
+
+
+# Input
+SOURCES += tst_depthsorter.cpp
@@ -0,0 +1,109 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+// Test of the back to front sort of GLC_DepthSorter, including empty and single candidate updates.
+
+#include <QtTest>
+
+#include <GLC_DepthSorter>
+#include <GLC_3DViewInstance>
+#include <GLC_Box>
+#include <GLC_Matrix4x4>
+
+class DepthSorterTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sortNoCandidate();
+    void sortOneCandidate();
+    void sortBackToFront();
+
+private:
+    //! Sort the given instances with the identity view matrix
+    static void sort(GLC_DepthSorter* pSorter, const QList<GLC_3DViewInstance*>& instances);
+};
+
+void DepthSorterTest::sortNoCandidate()
+{
+    GLC_DepthSorter sorter;
+    sort(&sorter, QList<GLC_3DViewInstance*>());
+
+    QVERIFY(sorter.sortedInstances().isEmpty());
+    QCOMPARE(sorter.sortCount(), quint64(1));
+}
+
+void DepthSorterTest::sortOneCandidate()
+{
+    GLC_3DViewInstance instance(new GLC_Box(1.0, 1.0, 1.0));
+    instance.translate(0.0, 0.0, -4.0);
+
+    GLC_DepthSorter sorter;
+    sort(&sorter, QList<GLC_3DViewInstance*>() << &instance);
+
+    QCOMPARE(sorter.sortedInstances().size(), 1);
+    QCOMPARE(sorter.sortedInstances().first(), &instance);
+}
+
+void DepthSorterTest::sortBackToFront()
+{
+    const QList<double> depths= {5.0, -3.0, 1.0, -10.0, 0.0};
+    QList<GLC_3DViewInstance*> instances;
+    for (double depth : depths)
+    {
+        GLC_3DViewInstance* pInstance= new GLC_3DViewInstance(new GLC_Box(1.0, 1.0, 1.0));
+        pInstance->translate(0.0, 0.0, depth);
+        instances.append(pInstance);
+    }
+
+    GLC_DepthSorter sorter;
+    sort(&sorter, instances);
+
+    // The view looks toward -z : the farthest instance has the lowest z
+    const QVector<GLC_3DViewInstance*>& sortedInstances= sorter.sortedInstances();
+    QCOMPARE(sortedInstances.size(), instances.size());
+    QCOMPARE(sortedInstances.at(0), instances.at(3));
+    QCOMPARE(sortedInstances.at(1), instances.at(1));
+    QCOMPARE(sortedInstances.at(2), instances.at(4));
+    QCOMPARE(sortedInstances.at(3), instances.at(2));
+    QCOMPARE(sortedInstances.at(4), instances.at(0));
+
+    // Nothing has changed, the instances are not sorted again
+    sort(&sorter, instances);
+    QCOMPARE(sorter.sortCount(), quint64(1));
+
+    qDeleteAll(instances);
+}
+
+void DepthSorterTest::sort(GLC_DepthSorter* pSorter, const QList<GLC_3DViewInstance*>& instances)
+{
+    pSorter->beginUpdate(GLC_Matrix4x4());
+    for (GLC_3DViewInstance* pInstance : instances)
+    {
+        pSorter->addCandidate(pInstance);
+    }
+    pSorter->endUpdate();
+}
+
+QTEST_GUILESS_MAIN(DepthSorterTest)
+
+#include "tst_depthsorter.moc"
@@ -0,0 +1,217 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+// Concurrency test of the atomic id generators and of the material "where used" tables.
+// Each test runs a quick row and a long running row creating millions of objects in total.
+// The number of objects created per thread can be set with the GLC_TEST_OBJECT_COUNT environment variable.
+
+#include <QtTest>
+#include <QtConcurrent>
+#include <QSet>
+
+#include <GLC_Mesh>
+#include <GLC_Material>
+#include <GLC_Global>
+
+class IdGenerationTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void concurrentIdGeneration_data();
+    void concurrentIdGeneration();
+    void concurrentMeshAndMaterialCreation_data();
+    void concurrentMeshAndMaterialCreation();
+    void concurrentSharedMaterialRelease_data();
+    void concurrentSharedMaterialRelease();
+
+private:
+    //! Add the rows of object count per thread
+    void addObjectCountRows() const;
+
+    //! Return one index per worker thread
+    QList<int> threadIndexes() const;
+
+    //! Check that the given lists of ids do not contain any duplicate
+    static void checkUnique(const QList<QList<GLC_uint> >& idLists, int expectedCount);
+
+private:
+    int m_ThreadCount;
+};
+
+void IdGenerationTest::initTestCase()
+{
+    m_ThreadCount= qMax(4, QThread::idealThreadCount() * 2);
+    QThreadPool::globalInstance()->setMaxThreadCount(m_ThreadCount);
+}
+
+void IdGenerationTest::concurrentIdGeneration_data()
+{
+    addObjectCountRows();
+}
+
+void IdGenerationTest::concurrentIdGeneration()
+{
+    QFETCH(int, objectCount);
+    // Each generator has its own counter
+    const QList<GLC_uint (*)()> generators= {&glc::GLC_GenID, &glc::GLC_GenGeomID, &glc::GLC_GenUserID};
+    for (GLC_uint (*generator)() : generators)
+    {
+        const QList<QList<GLC_uint> > idLists= QtConcurrent::blockingMapped(threadIndexes(), [objectCount, generator](int)
+        {
+            QList<GLC_uint> subject;
+            subject.reserve(objectCount);
+            for (int i= 0; i < objectCount; ++i)
+            {
+                subject.append(generator());
+            }
+            return subject;
+        });
+
+        checkUnique(idLists, m_ThreadCount * objectCount);
+    }
+}
+
+void IdGenerationTest::concurrentMeshAndMaterialCreation_data()
+{
+    addObjectCountRows();
+}
+
+void IdGenerationTest::concurrentMeshAndMaterialCreation()
+{
+    typedef QPair<QList<GLC_uint>, QList<GLC_uint> > IdLists;
+
+    QFETCH(int, objectCount);
+    const QList<IdLists> idLists= QtConcurrent::blockingMapped(threadIndexes(), [objectCount](int)
+    {
+        IdLists subject;
+        subject.first.reserve(objectCount);
+        subject.second.reserve(objectCount);
+        for (int i= 0; i < objectCount; ++i)
+        {
+            GLC_Mesh* pMesh= new GLC_Mesh();
+            GLC_Material* pMaterial= new GLC_Material();
+            pMesh->addMaterial(pMaterial);
+            subject.first.append(pMesh->id());
+            subject.second.append(pMaterial->id());
+
+            // The mesh owns the material and deletes it
+            delete pMesh;
+        }
+        return subject;
+    });
+
+    QList<QList<GLC_uint> > meshIds;
+    QList<QList<GLC_uint> > materialIds;
+    for (const IdLists& lists : idLists)
+    {
+        meshIds.append(lists.first);
+        materialIds.append(lists.second);
+    }
+    checkUnique(meshIds, m_ThreadCount * objectCount);
+    checkUnique(materialIds, m_ThreadCount * objectCount);
+}
+
+void IdGenerationTest::concurrentSharedMaterialRelease_data()
+{
+    addObjectCountRows();
+}
+
+void IdGenerationTest::concurrentSharedMaterialRelease()
+{
+    GLC_Material* pSharedMaterial= new GLC_Material();
+    // Keep the material alive after the release of all meshes
+    const GLC_uint usageId= glc::GLC_GenID();
+    pSharedMaterial->addUsage(usageId);
+
+    // All meshes are alive at the same time, keep the memory reasonable
+    QFETCH(int, objectCount);
+    objectCount/= 10;
+    QList<QList<GLC_Mesh*> > meshLists= QtConcurrent::blockingMapped(threadIndexes(), [objectCount, pSharedMaterial](int)
+    {
+        QList<GLC_Mesh*> subject;
+        subject.reserve(objectCount);
+        for (int i= 0; i < objectCount; ++i)
+        {
+            GLC_Mesh* pMesh= new GLC_Mesh();
+            pMesh->addMaterial(pSharedMaterial);
+            subject.append(pMesh);
+        }
+        return subject;
+    });
+    QCOMPARE(pSharedMaterial->numberOfUsage(), m_ThreadCount * objectCount + 1);
+
+    QtConcurrent::blockingMap(meshLists, [](QList<GLC_Mesh*>& meshes)
+    {
+        qDeleteAll(meshes);
+        meshes.clear();
+    });
+    QCOMPARE(pSharedMaterial->numberOfUsage(), 1);
+
+    QVERIFY(pSharedMaterial->delUsage(usageId));
+    QVERIFY(pSharedMaterial->isUnused());
+    delete pSharedMaterial;
+}
+
+void IdGenerationTest::addObjectCountRows() const
+{
+    QTest::addColumn<int>("objectCount");
+
+    if (qEnvironmentVariableIsSet("GLC_TEST_OBJECT_COUNT"))
+    {
+        QTest::newRow("environment") << qEnvironmentVariableIntValue("GLC_TEST_OBJECT_COUNT");
+    }
+    else
+    {
+        // The long running row creates at least 4 millions objects whatever the number of threads
+        const int totalCount= 4000000;
+        QTest::newRow("quick") << 20000;
+        QTest::newRow("millions") << (totalCount + m_ThreadCount - 1) / m_ThreadCount;
+    }
+}
+
+QList<int> IdGenerationTest::threadIndexes() const
+{
+    QList<int> subject;
+    for (int i= 0; i < m_ThreadCount; ++i) subject.append(i);
+    return subject;
+}
+
+void IdGenerationTest::checkUnique(const QList<QList<GLC_uint> >& idLists, int expectedCount)
+{
+    QSet<GLC_uint> ids;
+    ids.reserve(expectedCount);
+    for (const QList<GLC_uint>& idList : idLists)
+    {
+        for (GLC_uint id : idList)
+        {
+            ids.insert(id);
+        }
+    }
+    QCOMPARE(ids.size(), expectedCount);
+    QVERIFY(!ids.contains(0));
+}
+
+QTEST_GUILESS_MAIN(IdGenerationTest)
+
+#include "tst_idgeneration.moc"
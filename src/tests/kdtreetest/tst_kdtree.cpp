@@ -0,0 +1,346 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+// Test of the GLC_KdTree queries against brute force on a random point cloud and on the edges of a box,
+// and of the snapping on a vertex and its fallback on an edge.
+
+#include <QtTest>
+#include <QRandomGenerator>
+
+#include <GLC_KdTree>
+#include <GLC_Box>
+#include <GLC_Matrix4x4>
+
+class KdTreeTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void nearest_data();
+    void nearest();
+    void kNearest_data();
+    void kNearest();
+    void inRadius();
+    void nearestEdgePoint();
+    void batchQueries();
+    void snap();
+
+private:
+    //! Return the given number of random points in the cube of the given half size
+    static QVector<GLC_Point3d> randomPoints(QRandomGenerator* pGenerator, int count, double halfSize);
+
+    //! Return all the points of the given tree not farther than maxDistance, sorted like the tree results
+    static QVector<GLC_KdTree::Neighbour> bruteForceNeighbours(const GLC_KdTree& tree, const GLC_Point3d& point, double maxDistance);
+
+    //! Return the nearest edge point of the given tree computed on all edges
+    static GLC_KdTree::EdgePoint bruteForceEdgePoint(const GLC_KdTree& tree, const GLC_Point3d& point);
+
+    //! Return true if the given neighbour lists are equal
+    static bool isEqual(const QVector<GLC_KdTree::Neighbour>& neighbours1, const QVector<GLC_KdTree::Neighbour>& neighbours2);
+
+private:
+    //! The tree of a random point cloud with duplicated points
+    GLC_KdTree m_CloudTree;
+
+    //! The tree of a moved box
+    GLC_KdTree m_BoxTree;
+
+    //! The query points, more than a chunk of the batch queries
+    QVector<GLC_Point3d> m_Queries;
+};
+
+void KdTreeTest::initTestCase()
+{
+    QRandomGenerator generator(20240917);
+
+    const QVector<GLC_Point3d> points(randomPoints(&generator, 5000, 10.0));
+    GLfloatVector positions;
+    for (const GLC_Point3d& point : points)
+    {
+        positions << static_cast<GLfloat>(point.x()) << static_cast<GLfloat>(point.y()) << static_cast<GLfloat>(point.z());
+    }
+    // Duplicated points give equal distances
+    positions << positions.mid(0, 300);
+    m_CloudTree= GLC_KdTree(positions);
+    QCOMPARE(m_CloudTree.pointCount(), 5100);
+    QCOMPARE(m_CloudTree.edgeCount(), 0);
+
+    GLC_Box box(2.0, 2.0, 2.0);
+    // The mesh of the box is created with its bounding box
+    box.boundingBox();
+    m_BoxTree= GLC_KdTree(&box, GLC_Matrix4x4(1.0, 2.0, 3.0));
+    QVERIFY(m_BoxTree.edgeCount() > 0);
+
+    m_Queries= randomPoints(&generator, 2000, 11.0);
+}
+
+void KdTreeTest::nearest_data()
+{
+    QTest::addColumn<double>("maxDistance");
+
+    QTest::newRow("unbounded") << std::numeric_limits<double>::max();
+    QTest::newRow("bounded") << 0.8;
+}
+
+void KdTreeTest::nearest()
+{
+    QFETCH(double, maxDistance);
+
+    for (const GLC_Point3d& query : m_Queries)
+    {
+        const QVector<GLC_KdTree::Neighbour> expected(bruteForceNeighbours(m_CloudTree, query, maxDistance));
+        const GLC_KdTree::Neighbour neighbour= m_CloudTree.nearest(query, maxDistance);
+        if (expected.isEmpty())
+        {
+            QCOMPARE(neighbour.m_Index, -1);
+        }
+        else
+        {
+            QCOMPARE(neighbour.m_Index, expected.first().m_Index);
+            QCOMPARE(neighbour.m_Distance, expected.first().m_Distance);
+        }
+    }
+}
+
+void KdTreeTest::kNearest_data()
+{
+    QTest::addColumn<int>("k");
+    QTest::addColumn<double>("maxDistance");
+
+    QTest::newRow("one") << 1 << std::numeric_limits<double>::max();
+    QTest::newRow("unbounded") << 12 << std::numeric_limits<double>::max();
+    QTest::newRow("bounded") << 12 << 1.5;
+    QTest::newRow("more than points") << 6000 << 2.0;
+}
+
+void KdTreeTest::kNearest()
+{
+    QFETCH(int, k);
+    QFETCH(double, maxDistance);
+
+    for (const GLC_Point3d& query : m_Queries)
+    {
+        const QVector<GLC_KdTree::Neighbour> expected(bruteForceNeighbours(m_CloudTree, query, maxDistance).mid(0, k));
+        QVERIFY(isEqual(m_CloudTree.kNearest(query, k, maxDistance), expected));
+    }
+}
+
+void KdTreeTest::inRadius()
+{
+    const double radius= 1.5;
+    for (const GLC_Point3d& query : m_Queries)
+    {
+        QVERIFY(isEqual(m_CloudTree.inRadius(query, radius), bruteForceNeighbours(m_CloudTree, query, radius)));
+    }
+}
+
+void KdTreeTest::nearestEdgePoint()
+{
+    QRandomGenerator generator(5);
+    const QVector<GLC_Point3d> queries(randomPoints(&generator, 2000, 3.0));
+    for (const GLC_Point3d& offset : queries)
+    {
+        // Around the moved box
+        const GLC_Point3d query(offset + GLC_Point3d(1.0, 2.0, 3.0));
+        const GLC_KdTree::EdgePoint expected= bruteForceEdgePoint(m_BoxTree, query);
+        const GLC_KdTree::EdgePoint edgePoint= m_BoxTree.nearestEdgePoint(query);
+        QCOMPARE(edgePoint.m_Edge, expected.m_Edge);
+        QCOMPARE(edgePoint.m_Distance, expected.m_Distance);
+        QVERIFY(edgePoint.m_Point == expected.m_Point);
+
+        // Not found if farther than the maximum distance
+        const GLC_KdTree::EdgePoint bounded= m_BoxTree.nearestEdgePoint(query, expected.m_Distance * 0.5);
+        QCOMPARE(bounded.m_Edge, (expected.m_Distance > 0.0) ? -1 : expected.m_Edge);
+    }
+}
+
+void KdTreeTest::batchQueries()
+{
+    const int k= 8;
+    const double radius= 1.5;
+    const QVector<GLC_KdTree::Neighbour> nearest(m_CloudTree.nearest(m_Queries));
+    const QVector<QVector<GLC_KdTree::Neighbour> > kNearest(m_CloudTree.kNearest(m_Queries, k));
+    const QVector<QVector<GLC_KdTree::Neighbour> > inRadius(m_CloudTree.inRadius(m_Queries, radius));
+
+    const int count= m_Queries.size();
+    QCOMPARE(nearest.size(), count);
+    QCOMPARE(kNearest.size(), count);
+    QCOMPARE(inRadius.size(), count);
+    for (int i= 0; i < count; ++i)
+    {
+        const QVector<GLC_KdTree::Neighbour> expected(bruteForceNeighbours(m_CloudTree, m_Queries.at(i), std::numeric_limits<double>::max()));
+        QCOMPARE(nearest.at(i).m_Index, expected.first().m_Index);
+        QVERIFY(isEqual(kNearest.at(i), expected.mid(0, k)));
+        QVERIFY(isEqual(inRadius.at(i), bruteForceNeighbours(m_CloudTree, m_Queries.at(i), radius)));
+    }
+}
+
+void KdTreeTest::snap()
+{
+    GLC_Box box(2.0, 2.0, 2.0);
+    box.boundingBox();
+    const GLC_KdTree tree(&box);
+    const double tolerance= 0.1;
+
+    // Near a corner
+    GLC_Point3d query(1.05, 1.02, 0.98);
+    GLC_KdTree::Snap snap= tree.snap(query, tolerance);
+    QCOMPARE(snap.m_Type, GLC_KdTree::VertexSnap);
+    QCOMPARE(snap.m_Index, tree.nearest(query).m_Index);
+    QVERIFY(snap.m_Point == GLC_Point3d(1.0, 1.0, 1.0));
+
+    // On an edge near a corner, the vertex is preferred
+    query.setVect(1.0, 0.95, 1.0);
+    snap= tree.snap(query, tolerance);
+    QCOMPARE(snap.m_Type, GLC_KdTree::VertexSnap);
+    QVERIFY(snap.m_Point == GLC_Point3d(1.0, 1.0, 1.0));
+
+    // Near the middle of an edge, no vertex in the tolerance
+    query.setVect(1.03, 0.2, 1.02);
+    snap= tree.snap(query, tolerance);
+    QCOMPARE(snap.m_Type, GLC_KdTree::EdgeSnap);
+    QCOMPARE(snap.m_Index, tree.nearestEdgePoint(query).m_Edge);
+    QVERIFY((snap.m_Point - GLC_Point3d(1.0, 0.2, 1.0)).length() < 1e-6);
+    for (int end= 0; end < 2; ++end)
+    {
+        const GLC_Point3d edgeEnd(tree.point(tree.edgePoint(snap.m_Index, end)));
+        QCOMPARE(edgeEnd.x(), 1.0);
+        QCOMPARE(edgeEnd.z(), 1.0);
+    }
+
+    // Far from the box
+    query.setVect(1.5, 0.2, 1.0);
+    snap= tree.snap(query, tolerance);
+    QCOMPARE(snap.m_Type, GLC_KdTree::NoSnap);
+    QCOMPARE(snap.m_Index, -1);
+    QVERIFY(snap.m_Point == query);
+}
+
+QVector<GLC_Point3d> KdTreeTest::randomPoints(QRandomGenerator* pGenerator, int count, double halfSize)
+{
+    QVector<GLC_Point3d> subject;
+    subject.reserve(count);
+    for (int i= 0; i < count; ++i)
+    {
+        const double x= pGenerator->bounded(2.0 * halfSize) - halfSize;
+        const double y= pGenerator->bounded(2.0 * halfSize) - halfSize;
+        const double z= pGenerator->bounded(2.0 * halfSize) - halfSize;
+        subject.append(GLC_Point3d(x, y, z));
+    }
+
+    return subject;
+}
+
+QVector<GLC_KdTree::Neighbour> KdTreeTest::bruteForceNeighbours(const GLC_KdTree& tree, const GLC_Point3d& point, double maxDistance)
+{
+    const double maxDistance2= (maxDistance > std::sqrt(std::numeric_limits<double>::max())) ? std::numeric_limits<double>::max() : maxDistance * maxDistance;
+
+    // Squared distances are computed like the tree to compare equal distances
+    QVector<GLC_KdTree::Neighbour> subject;
+    const int count= tree.pointCount();
+    for (int i= 0; i < count; ++i)
+    {
+        const GLC_Point3d other(tree.point(i));
+        const double dx= other.x() - point.x();
+        const double dy= other.y() - point.y();
+        const double dz= other.z() - point.z();
+        const double distance2= dx * dx + dy * dy + dz * dz;
+        if (distance2 <= maxDistance2)
+        {
+            subject.append(GLC_KdTree::Neighbour{i, distance2});
+        }
+    }
+    std::sort(subject.begin(), subject.end(), [](const GLC_KdTree::Neighbour& neighbour1, const GLC_KdTree::Neighbour& neighbour2)
+    {
+        return (neighbour1.m_Distance < neighbour2.m_Distance)
+                || ((neighbour1.m_Distance == neighbour2.m_Distance) && (neighbour1.m_Index < neighbour2.m_Index));
+    });
+    for (GLC_KdTree::Neighbour& neighbour : subject)
+    {
+        neighbour.m_Distance= std::sqrt(neighbour.m_Distance);
+    }
+
+    return subject;
+}
+
+GLC_KdTree::EdgePoint KdTreeTest::bruteForceEdgePoint(const GLC_KdTree& tree, const GLC_Point3d& point)
+{
+    GLC_KdTree::EdgePoint subject= {-1, point, 0.0};
+    double bestDistance2= std::numeric_limits<double>::max();
+    const double position[3]= {point.x(), point.y(), point.z()};
+    const int count= tree.edgeCount();
+    for (int edge= 0; edge < count; ++edge)
+    {
+        const GLC_Point3d start(tree.point(tree.edgePoint(edge, 0)));
+        const GLC_Point3d end(tree.point(tree.edgePoint(edge, 1)));
+        const double startPosition[3]= {start.x(), start.y(), start.z()};
+        const double endPosition[3]= {end.x(), end.y(), end.z()};
+
+        // Projection clamped on the segment, computed like the tree
+        double direction[3];
+        double length2= 0.0;
+        double projection= 0.0;
+        for (int axis= 0; axis < 3; ++axis)
+        {
+            direction[axis]= endPosition[axis] - startPosition[axis];
+            length2+= direction[axis] * direction[axis];
+            projection+= direction[axis] * (position[axis] - startPosition[axis]);
+        }
+        const double t= (length2 > 0.0) ? qBound(0.0, projection / length2, 1.0) : 0.0;
+        double closest[3];
+        double distance2= 0.0;
+        for (int axis= 0; axis < 3; ++axis)
+        {
+            closest[axis]= startPosition[axis] + t * direction[axis];
+            const double delta= closest[axis] - position[axis];
+            distance2+= delta * delta;
+        }
+
+        // Edges are visited by increasing index, the first one is kept on equal distances
+        if (distance2 < bestDistance2)
+        {
+            bestDistance2= distance2;
+            subject.m_Edge= edge;
+            subject.m_Point.setVect(closest[0], closest[1], closest[2]);
+        }
+    }
+    subject.m_Distance= std::sqrt(bestDistance2);
+
+    return subject;
+}
+
+bool KdTreeTest::isEqual(const QVector<GLC_KdTree::Neighbour>& neighbours1, const QVector<GLC_KdTree::Neighbour>& neighbours2)
+{
+    bool subject= (neighbours1.size() == neighbours2.size());
+    const int count= neighbours1.size();
+    for (int i= 0; subject && (i < count); ++i)
+    {
+        subject= (neighbours1.at(i).m_Index == neighbours2.at(i).m_Index) && (neighbours1.at(i).m_Distance == neighbours2.at(i).m_Distance);
+    }
+
+    return subject;
+}
+
+QTEST_GUILESS_MAIN(KdTreeTest)
+
+#include "tst_kdtree.moc"
@@ -0,0 +1,194 @@
+/****************************************************************************
+
+ This file is part of the GLC-lib library.
+ Copyright (C) 2005-2008 Laurent Ribon (laumaya@users.sourceforge.net)
+ http://glc-lib.sourceforge.net
+
+ GLC-lib is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any later version.
+
+ GLC-lib is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GLC-lib; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*****************************************************************************/
+
+// Test of GLC_SectionEngine on a box cut by a plane : contour and cap area.
+
+#include <QtTest>
+
+#include <GLC_SectionEngine>
+#include <GLC_World>
+#include <GLC_StructOccurrence>
+#include <GLC_StructInstance>
+#include <GLC_StructReference>
+#include <GLC_3DRep>
+#include <GLC_Box>
+#include <GLC_Plane>
+#include <GLC_Matrix4x4>
+
+class SectionEngineTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cutBox_data();
+    void cutBox();
+    void movePlane();
+
+private:
+    //! Add a box of the given length centred on the given point to the given world
+    static void addBox(GLC_World* pWorld, double length, const GLC_Point3d& center);
+
+    //! Return the perimeter of the given closed contour
+    static double perimeter(const GLC_SectionEngine::Contour& contour);
+
+    //! Return the area of the given closed contour of the given plane
+    static double area(const GLC_SectionEngine::Contour& contour, const GLC_Plane& plane);
+};
+
+void SectionEngineTest::cutBox_data()
+{
+    // The box has a length of 2
+    QTest::addColumn<GLC_Point3d>("center");
+    QTest::addColumn<GLC_Plane>("plane");
+    QTest::addColumn<double>("expectedArea");
+    QTest::addColumn<double>("expectedPerimeter");
+
+    const GLC_Point3d moved(3.0, 0.0, 0.0);
+    QTest::newRow("axis") << moved << GLC_Plane(GLC_Vector3d(0.0, 0.0, 1.0), GLC_Point3d(3.0, 0.0, 0.3)) << 4.0 << 8.0;
+    // Off center to avoid the vertical edges of the box in the plane
+    QTest::newRow("diagonal") << moved << GLC_Plane(GLC_Vector3d(1.0, 1.0, 0.0).normalize(), GLC_Point3d(3.2, 0.0, 0.0))
+                              << 3.6 * std::sqrt(2.0) << 3.6 * std::sqrt(2.0) + 4.0;
+    // The regular hexagon of the cube through its center
+    QTest::newRow("hexagon") << moved << GLC_Plane(GLC_Vector3d(1.0, 1.0, 1.0).normalize(), moved)
+                             << 3.0 * std::sqrt(3.0) << 6.0 * std::sqrt(2.0);
+    QTest::newRow("missed") << moved << GLC_Plane(GLC_Vector3d(0.0, 0.0, 1.0), GLC_Point3d(3.0, 0.0, 1.5)) << 0.0 << 0.0;
+}
+
+void SectionEngineTest::cutBox()
+{
+    QFETCH(GLC_Point3d, center);
+    QFETCH(GLC_Plane, plane);
+    QFETCH(double, expectedArea);
+    QFETCH(double, expectedPerimeter);
+
+    GLC_World world;
+    addBox(&world, 2.0, center);
+
+    GLC_SectionEngine engine;
+    const int planeIndex= engine.addPlane(plane);
+    engine.update(world.collection());
+    QCOMPARE(engine.statistics().m_BodyCount, 1);
+
+    const QList<GLC_SectionEngine::BodySection> sections(engine.sections(planeIndex));
+    if (expectedArea == 0.0)
+    {
+        QVERIFY(sections.isEmpty());
+        QCOMPARE(engine.statistics().m_CutBodyCount, 0);
+        QCOMPARE(engine.capArea(planeIndex), 0.0);
+        return;
+    }
+    QCOMPARE(engine.statistics().m_CutBodyCount, 1);
+    QCOMPARE(engine.statistics().m_OpenContourCount, 0);
+    QCOMPARE(sections.count(), 1);
+
+    // One closed contour on the plane and on the faces of the box
+    const GLC_SectionEngine::BodySection& section= sections.first();
+    QCOMPARE(section.m_Contours.count(), 1);
+    const GLC_SectionEngine::Contour& contour= section.m_Contours.first();
+    QVERIFY(contour.m_IsClosed);
+    QVERIFY(contour.m_Points.size() >= 3);
+    for (const GLC_Point3d& point : contour.m_Points)
+    {
+        QVERIFY(qAbs(plane.distanceToPoint(point)) < 1e-6);
+        const GLC_Vector3d local(point - center);
+        const double maxCoordinate= qMax(qAbs(local.x()), qMax(qAbs(local.y()), qAbs(local.z())));
+        QVERIFY(qAbs(maxCoordinate - 1.0) < 1e-6);
+    }
+    QVERIFY(qAbs(perimeter(contour) - expectedPerimeter) < 1e-6);
+    QVERIFY(qAbs(area(contour, plane) - expectedArea) < 1e-6);
+
+    // The cap triangles cover the contour and face the removed side
+    QVERIFY(qAbs(section.m_CapArea - expectedArea) < 1e-4);
+    QVERIFY(qAbs(engine.capArea(planeIndex) - expectedArea) < 1e-4);
+    QVERIFY(!section.m_CapTriangles.isEmpty());
+    QCOMPARE(section.m_CapTriangles.size() % 3, 0);
+    double triangleArea= 0.0;
+    for (int i= 0; i < section.m_CapTriangles.size(); i+= 3)
+    {
+        const GLC_Vector3d normal((section.m_CapTriangles.at(i + 1) - section.m_CapTriangles.at(i)) ^ (section.m_CapTriangles.at(i + 2) - section.m_CapTriangles.at(i)));
+        QVERIFY((normal * plane.normal()) <= 0.0);
+        triangleArea+= normal.length() * 0.5;
+    }
+    QVERIFY(qAbs(triangleArea - expectedArea) < 1e-4);
+}
+
+void SectionEngineTest::movePlane()
+{
+    GLC_World world;
+    addBox(&world, 2.0, GLC_Point3d());
+
+    GLC_SectionEngine engine;
+    const int planeIndex= engine.addPlane(GLC_Plane(GLC_Vector3d(0.0, 0.0, 1.0), GLC_Point3d(0.0, 0.0, 0.5)));
+    engine.update(world.collection());
+    QVERIFY(qAbs(engine.capArea(planeIndex) - 4.0) < 1e-4);
+
+    // The plane leaves the box
+    engine.setPlane(planeIndex, GLC_Plane(GLC_Vector3d(0.0, 0.0, 1.0), GLC_Point3d(0.0, 0.0, 2.0)));
+    engine.update(world.collection());
+    QVERIFY(engine.sections(planeIndex).isEmpty());
+    QCOMPARE(engine.capArea(planeIndex), 0.0);
+
+    // And comes back in
+    engine.setPlane(planeIndex, GLC_Plane(GLC_Vector3d(0.0, 0.0, 1.0), GLC_Point3d(0.0, 0.0, -0.5)));
+    engine.update(world.collection());
+    QCOMPARE(engine.sections(planeIndex).count(), 1);
+    QVERIFY(qAbs(engine.capArea(planeIndex) - 4.0) < 1e-4);
+}
+
+void SectionEngineTest::addBox(GLC_World* pWorld, double length, const GLC_Point3d& center)
+{
+    GLC_Box* pBox= new GLC_Box(length, length, length);
+    // The mesh of the box is created with its bounding box
+    pBox->boundingBox();
+
+    GLC_StructInstance* pInstance= new GLC_StructInstance(new GLC_StructReference(new GLC_3DRep(pBox)));
+    pInstance->move(GLC_Matrix4x4(center.x(), center.y(), center.z()));
+    pWorld->rootOccurrence()->addChild(pInstance);
+}
+
+double SectionEngineTest::perimeter(const GLC_SectionEngine::Contour& contour)
+{
+    double subject= 0.0;
+    const int count= contour.m_Points.size();
+    for (int i= 0; i < count; ++i)
+    {
+        subject+= (contour.m_Points.at((i + 1) % count) - contour.m_Points.at(i)).length();
+    }
+
+    return subject;
+}
+
+double SectionEngineTest::area(const GLC_SectionEngine::Contour& contour, const GLC_Plane& plane)
+{
+    GLC_Vector3d doubleArea;
+    const int count= contour.m_Points.size();
+    for (int i= 0; i < count; ++i)
+    {
+        doubleArea+= contour.m_Points.at(i) ^ contour.m_Points.at((i + 1) % count);
+    }
+
+    return qAbs(doubleArea * plane.normal()) * 0.5;
+}
+
+QTEST_GUILESS_MAIN(SectionEngineTest)
+
+#include "tst_sectionengine.moc"
@@ -0,0 +1,7 @@
+TEMPLATE = subdirs
+SUBDIRS += \
+    idgenerationtest \
+    depthsortertest \
+    clashdetectortest \
+    kdtreetest \
+    sectionenginetest